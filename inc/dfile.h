@@ -91,9 +91,10 @@ X.    DIRECTORY OPERATIONS
       1.  d_mkdir       (POSIX mkdir equivalent)
       2.  d_rmdir       (POSIX rmdir equivalent)
       3.  d_opendir     (POSIX opendir equivalent)
-      4.  d_readdir     (POSIX readdir equivalent)
-      5.  d_closedir    (POSIX closedir equivalent)
-      6.  d_rewinddir   (POSIX rewinddir equivalent)
+      4.  d_opendir_ex  (d_opendir with a caller-chosen allocator)
+      5.  d_readdir     (POSIX readdir equivalent)
+      6.  d_closedir    (POSIX closedir equivalent)
+      7.  d_rewinddir   (POSIX rewinddir equivalent)
 
 XI.   FILE OPERATIONS
       ----------------
@@ -122,6 +123,21 @@ XIV.  PIPE OPERATIONS
       ----------------
       1.  d_popen       (POSIX popen equivalent)
       2.  d_pclose      (POSIX pclose equivalent)
+
+XV.   BINARY I/O HELPERS
+      -------------------
+      1.  d_fread_all    (read a whole file into memory)
+      2.  d_fread_all_ex (d_fread_all with a caller-chosen allocator)
+      3.  d_fwrite_all   (write a buffer to a file)
+      4.  d_fappend_all  (append a buffer to a file)
+
+XVI.  GLOB PATTERNS
+      --------------
+      1.  d_glob_compile     (compile a glob pattern)
+      2.  d_glob_match       (match a path against a compiled glob)
+      3.  d_glob_set_new     (compile many globs into one set)
+      4.  d_glob_set_match   (match a path against every glob of a set)
+      5.  d_readdir_glob     (read directory entries matching a glob)
 */
 
 #ifndef DJINTERP_FILE_
@@ -303,6 +319,14 @@ struct d_dirent_t
 //   type: opaque directory handle.
 struct d_dir_t;
 
+// d_glob_pattern
+//   type: opaque compiled glob pattern.
+struct d_glob_pattern;
+
+// d_glob_set
+//   type: opaque set of compiled glob patterns.
+struct d_glob_set;
+
 
 // file type constants for d_dirent_t.d_type
 #ifndef DT_UNKNOWN
@@ -413,6 +437,10 @@ struct d_dir_t;
 #define D_LOCK_NB   4   // non-blocking
 #define D_LOCK_UN   8   // unlock
 
+// glob flags for d_glob_compile and d_glob_set_new
+#define D_GLOB_NOCASE   0x01u   // ASCII letters match either case
+#define D_GLOB_PERIOD   0x02u   // leading '.' of a name needs a literal '.'
+
 // seek origins
 #ifndef SEEK_SET
     #define SEEK_SET 0
@@ -514,6 +542,7 @@ int                d_mkdir(const char* _path, uint32_t _mode);
 int                d_mkdir_p(const char* _path, uint32_t _mode);
 int                d_rmdir(const char* _path);
 struct d_dir_t*    d_opendir(const char* _path);
+struct d_dir_t*    d_opendir_ex(const struct d_allocator* _allocator, const char* _path);
 struct d_dirent_t* d_readdir(struct d_dir_t* _dir);
 int                d_closedir(struct d_dir_t* _dir);
 void               d_rewinddir(struct d_dir_t* _dir);
@@ -550,9 +579,22 @@ int         d_pclose(FILE* _stream);
 
 // XV.  binary I/O helpers
 void*       d_fread_all(const char* _path, size_t* _size);
+void*       d_fread_all_ex(const struct d_allocator* _allocator, const char* _path, size_t* _size);
 int         d_fwrite_all(const char* _path, const void* _data, size_t _size);
 int         d_fappend_all(const char* _path, const void* _data, size_t _size);
 
+// XVI.  glob patterns
+struct d_glob_pattern* d_glob_compile(const char* _pattern, unsigned _flags);
+void                   d_glob_free(struct d_glob_pattern* _glob);
+int                    d_glob_match(const struct d_glob_pattern* _glob, const char* _path);
+int                    d_glob_match_n(const struct d_glob_pattern* _glob, const char* _path, size_t _length);
+struct d_glob_set*     d_glob_set_new(const char* const* _patterns, size_t _count, unsigned _flags);
+void                   d_glob_set_free(struct d_glob_set* _set);
+ssize_t                d_glob_set_match(const struct d_glob_set* _set, const char* _path);
+ssize_t                d_glob_set_match_n(const struct d_glob_set* _set, const char* _path, size_t _length);
+struct d_dirent_t*     d_readdir_glob(struct d_dir_t* _dir, const struct d_glob_pattern* _glob);
+struct d_dirent_t*     d_readdir_glob_set(struct d_dir_t* _dir, const struct d_glob_set* _set, size_t* _index);
+
 
 
 #endif	// DJINTERP_FILE_
\ No newline at end of file
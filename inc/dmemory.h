@@ -13,6 +13,7 @@
 #define DJINTERP_MEMORY_ 1
 
 #include <stddef.h> 	// for size_t
+#include <stdio.h>      // for FILE
 #include <stdlib.h>     // for malloc
 #include <string.h>     // for memcpy
 #include ".\djinterp.h"
@@ -45,6 +46,269 @@
     #define EOVERFLOW 75
 #endif
 
+// D_MEMORY_STREAM_THRESHOLD
+//   constant: fallback for d_memory_stream_threshold when the size of the
+// last-level cache cannot be detected.
+#ifndef D_MEMORY_STREAM_THRESHOLD
+    #define D_MEMORY_STREAM_THRESHOLD ((size_t)32 * 1024 * 1024)
+#endif
+
+// D_MEMORY_PARALLEL_SLICE_MIN
+//   constant: smallest number of bytes d_memcpy_parallel hands to a thread.
+// Copies shorter than twice this run on the calling thread, where starting a
+// thread would cost more than it saves.
+#ifndef D_MEMORY_PARALLEL_SLICE_MIN
+    #define D_MEMORY_PARALLEL_SLICE_MIN ((size_t)4 * 1024 * 1024)
+#endif
+
+// D_ARENA_DEFAULT_BLOCK_SIZE
+//   constant: size, in bytes, of the blocks chained by a d_arena created with
+// a block size of 0. Larger requests get a block of their own.
+#ifndef D_ARENA_DEFAULT_BLOCK_SIZE
+    #define D_ARENA_DEFAULT_BLOCK_SIZE ((size_t)64 * 1024)
+#endif
+
+// D_ARENA_DEFAULT_ALIGNMENT
+//   constant: alignment, in bytes, of the memory returned by d_arena_alloc;
+// enough for any fundamental type.
+#ifndef D_ARENA_DEFAULT_ALIGNMENT
+    #define D_ARENA_DEFAULT_ALIGNMENT ((size_t)16)
+#endif
+
+// D_POOL_MAGAZINE_SIZE
+//   constant: number of objects held by one magazine of a d_pool, and carved
+// from each chunk it allocates. Each thread caches up to two magazines, so a
+// thread moves objects to and from the shared depot at most once every
+// D_POOL_MAGAZINE_SIZE operations.
+#ifndef D_POOL_MAGAZINE_SIZE
+    #define D_POOL_MAGAZINE_SIZE 64
+#endif
+
+// D_POOL_DEFAULT_ALIGNMENT
+//   constant: alignment, in bytes, of the objects of a d_pool created with an
+// alignment of 0.
+#ifndef D_POOL_DEFAULT_ALIGNMENT
+    #define D_POOL_DEFAULT_ALIGNMENT ((size_t)16)
+#endif
+
+// D_ALLOCATOR_DEFAULT_ALIGNMENT
+//   constant: alignment, in bytes, of the memory returned by
+// d_allocator_alloc. It is the alignment malloc guarantees on every supported
+// platform, so the system allocator serves it with malloc itself.
+#ifndef D_ALLOCATOR_DEFAULT_ALIGNMENT
+    #define D_ALLOCATOR_DEFAULT_ALIGNMENT (2 * sizeof(void*))
+#endif
+
+// D_MEMORY_CACHE_LINE_SIZE
+//   constant: alignment, in bytes, of the buffers d_large_alloc returns below
+// D_MEMORY_LARGE_THRESHOLD, so that scans over them start on a cache line.
+#ifndef D_MEMORY_CACHE_LINE_SIZE
+    #define D_MEMORY_CACHE_LINE_SIZE ((size_t)64)
+#endif
+
+// D_MEMORY_HUGE_PAGE_SIZE
+//   constant: size, in bytes, of a transparent huge page. Mappings made with
+// D_MEMORY_LARGE_HUGE_PAGES are aligned to it, so the kernel can back every
+// whole huge page they span with one.
+#ifndef D_MEMORY_HUGE_PAGE_SIZE
+    #define D_MEMORY_HUGE_PAGE_SIZE ((size_t)2 * 1024 * 1024)
+#endif
+
+// D_MEMORY_LARGE_THRESHOLD
+//   constant: size, in bytes, from which d_large_alloc maps buffers directly
+// from the operating system instead of taking them from the heap. Both the
+// allocating and the releasing call must see the same value.
+#ifndef D_MEMORY_LARGE_THRESHOLD
+    #define D_MEMORY_LARGE_THRESHOLD ((size_t)1024 * 1024)
+#endif
+
+// D_MEMORY_LARGE_HUGE_PAGES
+//   flag: ask the kernel to back a mapped d_large_alloc buffer with
+// transparent huge pages (MADV_HUGEPAGE), cutting the TLB misses of scanning
+// it. Ignored where unsupported.
+#define D_MEMORY_LARGE_HUGE_PAGES 0x1u
+
+// D_MEMORY_LARGE_POPULATE
+//   flag: fault in every page of a mapped d_large_alloc buffer up front
+// (MAP_POPULATE), for buffers that are about to be written in full.
+#define D_MEMORY_LARGE_POPULATE 0x2u
+
+// D_MEMORY_STATS
+//   feature: when nonzero, the library accounts for its own heap use, per
+// module and per call site (see d_memory_stats_snapshot). Every translation
+// unit of the library must be built with the same value. Off by default, in
+// which case D_MEMORY_ALLOC and friends are plain malloc and free.
+#ifndef D_MEMORY_STATS
+    #define D_MEMORY_STATS 0
+#endif
+
+// D_MEMORY_STATS_MAX_SITES
+//   constant: number of call sites D_MEMORY_STATS can tell apart. Sites past
+// the limit are pooled into a single "(other)" site.
+#ifndef D_MEMORY_STATS_MAX_SITES
+    #define D_MEMORY_STATS_MAX_SITES 256
+#endif
+
+// D_MEMORY_STATS_SYNC_BYTES
+//   constant: net change, in bytes, in one thread's live memory for one site
+// after which the thread publishes it to the shared live counts that peaks
+// are sampled from. Smaller values sample peaks more closely.
+#ifndef D_MEMORY_STATS_SYNC_BYTES
+    #define D_MEMORY_STATS_SYNC_BYTES ((size_t)4 * 1024)
+#endif
+
+// d_arena
+//   struct: a bump allocator. Memory is carved in order out of a chain of
+// blocks and is never freed piece by piece; instead d_arena_reset, or
+// d_arena_rollback to a d_arena_marker, releases everything allocated since
+// in O(1), keeping the blocks for reuse. An arena is not thread-safe.
+struct d_arena;
+struct d_arena_block;
+
+// d_arena_marker
+//   struct: a savepoint in a d_arena, taken with d_arena_mark. Rolling back
+// to it releases everything allocated after it was taken; rolling back or
+// resetting to an earlier point invalidates it.
+struct d_arena_marker
+{
+    struct d_arena_block* block;   // block in use when the marker was taken
+    size_t                offset;  // bump offset within that block
+    size_t                used;    // bytes in use at the time
+};
+
+// d_pool
+//   struct: a thread-safe allocator of fixed-size objects. Each thread keeps
+// its freed objects in two private magazines and trades whole magazines with
+// a lock-free depot shared by all threads, so an object may be freed by a
+// different thread than the one that allocated it. Memory is returned to the
+// system only by d_pool_free.
+struct d_pool;
+
+// d_pool_stats
+//   struct: a snapshot of a d_pool's usage, filled in by d_pool_get_stats.
+// The calling thread's operations are always counted; another thread's are
+// published whenever it visits the depot (at least once per magazine), calls
+// d_pool_flush or exits, so they may lag by up to a magazine per thread.
+struct d_pool_stats
+{
+    size_t object_size;  // bytes per object, after rounding for alignment
+    size_t live;         // objects allocated and not yet released
+    size_t cached;       // free objects held in magazines or the depot
+    size_t high_water;   // most objects live at once, sampled per magazine
+    size_t total;        // objects carved from chunks; live + cached
+};
+
+// d_allocator
+//   struct: an allocator, as a table of functions sharing a context. The
+// `_ex` variants of allocating functions take one and route every allocation
+// they make through it; passing NULL selects d_allocator_default. Memory must
+// be returned to the allocator it came from, with the size it was requested
+// at. Only `allocate` is required: without `reallocate`, d_allocator_realloc
+// tries `try_expand` and then moves the memory, and without `deallocate`
+// memory is released in bulk by whatever owns the context (e.g. an arena).
+struct d_allocator
+{
+    void* (*allocate)(void* _context, size_t _size, size_t _alignment);
+    void* (*reallocate)(void* _context, void* _ptr, size_t _old_size, size_t _new_size);
+    bool  (*try_expand)(void* _context, void* _ptr, size_t _old_size, size_t _new_size);
+    void  (*deallocate)(void* _context, void* _ptr, size_t _size);
+    void*   context;     // passed as the first argument of every function
+};
+
+// d_memory_module
+//   enum: the library modules D_MEMORY_STATS accounts for separately.
+enum d_memory_module
+{
+    D_MEMORY_MODULE_MEMORY = 0,  // dmemory: arenas, pools, d_allocator_system
+    D_MEMORY_MODULE_STRING,      // dstring and string_fn
+    D_MEMORY_MODULE_FILE,        // dfile
+    D_MEMORY_MODULE_MUTEX,       // dmutex
+    D_MEMORY_MODULE_COUNT
+};
+
+// d_memory_stats_order
+//   enum: orders in which d_memory_stats_sort can arrange the call sites of
+// a snapshot, largest first.
+enum d_memory_stats_order
+{
+    D_MEMORY_STATS_BY_LIVE = 0,     // live bytes: leaks, resident memory
+    D_MEMORY_STATS_BY_BYTES,        // bytes allocated: heavy sites
+    D_MEMORY_STATS_BY_ALLOCATIONS   // allocations made: hot sites
+};
+
+// d_memory_stats_entry
+//   struct: the allocation counts of one call site, one module, or the whole
+// library. A reallocation counts as a free and an allocation. Memory handed
+// to the caller to free itself (see D_MEMORY_HANDOFF) counts as allocated but
+// never as live.
+struct d_memory_stats_entry
+{
+    const char*          file;         // source file of a site, else NULL
+    int                  line;         // source line of a site, else 0
+    enum d_memory_module module;       // module of a site or module entry
+    size_t               allocations;  // allocations made
+    size_t               frees;        // allocations freed
+    size_t               bytes;        // bytes allocated in total
+    size_t               live;         // bytes allocated and not yet freed
+    size_t               peak;         // most bytes live at once, sampled
+};
+
+// d_memory_stats
+//   struct: a snapshot of the library's heap use, taken with
+// d_memory_stats_snapshot. Counts are exact as of the snapshot; peaks are
+// sampled whenever a thread publishes its live count (see
+// D_MEMORY_STATS_SYNC_BYTES), so a short spike may be missed by up to that
+// many bytes per thread and site.
+struct d_memory_stats
+{
+    bool                         enabled;     // built with D_MEMORY_STATS
+    struct d_memory_stats_entry  total;       // the whole library
+    struct d_memory_stats_entry  modules[D_MEMORY_MODULE_COUNT];
+    size_t                       site_count;  // entries in `sites`
+    struct d_memory_stats_entry* sites;       // every site, by live bytes
+};
+
+// D_MEMORY_ALLOC, D_MEMORY_CALLOC, D_MEMORY_REALLOC, D_MEMORY_FREE
+//   macro: the library's malloc, calloc, realloc and free, accounted to the
+// given module and to the calling line when D_MEMORY_STATS is set. Memory
+// from these must be released with D_MEMORY_FREE, and D_MEMORY_FREE only
+// releases memory from these.
+// D_MEMORY_ALLOC_AT, D_MEMORY_CALLOC_AT, D_MEMORY_REALLOC_AT
+//   macro: as D_MEMORY_ALLOC, D_MEMORY_CALLOC and D_MEMORY_REALLOC, but
+// accounted to the given `file` and `line`. For internal helpers that
+// allocate on behalf of a public function and are passed its location.
+// D_MEMORY_HANDOFF
+//   macro: accounts for `size` bytes allocated with plain malloc and handed to
+// the caller, who releases them with free.
+#if D_MEMORY_STATS
+    #define D_MEMORY_ALLOC_AT(module, file, line, size)                     \
+        d_memory_stats_alloc((module), (file), (line), (size))
+    #define D_MEMORY_CALLOC_AT(module, file, line, count, size)             \
+        d_memory_stats_calloc((module), (file), (line), (count), (size))
+    #define D_MEMORY_REALLOC_AT(module, file, line, ptr, size)              \
+        d_memory_stats_realloc((module), (file), (line), (ptr), (size))
+    #define D_MEMORY_FREE(ptr)                                              \
+        d_memory_stats_free((ptr))
+    #define D_MEMORY_HANDOFF(module, size)                                  \
+        d_memory_stats_handoff((module), __FILE__, __LINE__, (size))
+#else
+    #define D_MEMORY_ALLOC_AT(module, file, line, size)                     \
+        ((void)(file), (void)(line), malloc((size)))
+    #define D_MEMORY_CALLOC_AT(module, file, line, count, size)             \
+        ((void)(file), (void)(line), calloc((count), (size)))
+    #define D_MEMORY_REALLOC_AT(module, file, line, ptr, size)              \
+        ((void)(file), (void)(line), realloc((ptr), (size)))
+    #define D_MEMORY_FREE(ptr)                    free((ptr))
+    #define D_MEMORY_HANDOFF(module, size)        ((void)0)
+#endif
+
+#define D_MEMORY_ALLOC(module, size)                                        \
+    D_MEMORY_ALLOC_AT(module, __FILE__, __LINE__, size)
+#define D_MEMORY_CALLOC(module, count, size)                                \
+    D_MEMORY_CALLOC_AT(module, __FILE__, __LINE__, count, size)
+#define D_MEMORY_REALLOC(module, ptr, size)                                 \
+    D_MEMORY_REALLOC_AT(module, __FILE__, __LINE__, ptr, size)
+
 
 void*   d_memcpy(void* _destination, const void* _source, size_t _count);
 int     d_memcpy_s(void* _destination, size_t _destSize, const void* _source, size_t _count);
@@ -52,5 +316,66 @@ void*   d_memdup_s(const void* _src, size_t _size);
 void*   d_memset(void* _ptr, int _value, size_t _amount);
 errno_t d_memset_s(void* _destination, rsize_t _destsz, int _ch, rsize_t _count);
 
+// large copies and fills
+void*   d_memcpy_stream(void* _destination, const void* _source, size_t _count);
+void*   d_memcpy_parallel(void* _destination, const void* _source, size_t _count, size_t _threads);
+size_t  d_memory_stream_threshold(void);
+void    d_memory_set_stream_threshold(size_t _bytes);
+
+// arena allocation
+struct d_arena*       d_arena_new(size_t _block_size);
+void                  d_arena_free(struct d_arena* _arena);
+void*                 d_arena_alloc(struct d_arena* _arena, size_t _size);
+void*                 d_arena_alloc_aligned(struct d_arena* _arena, size_t _size, size_t _alignment);
+void*                 d_arena_calloc(struct d_arena* _arena, size_t _count, size_t _size);
+void*                 d_arena_resize(struct d_arena* _arena, void* _ptr, size_t _old_size, size_t _new_size);
+void*                 d_arena_memdup(struct d_arena* _arena, const void* _src, size_t _size);
+struct d_arena_marker d_arena_mark(const struct d_arena* _arena);
+void                  d_arena_rollback(struct d_arena* _arena, struct d_arena_marker _marker);
+void                  d_arena_reset(struct d_arena* _arena);
+size_t                d_arena_used(const struct d_arena* _arena);
+
+// fixed-size object pools
+struct d_pool*        d_pool_new(size_t _object_size, size_t _alignment);
+void                  d_pool_free(struct d_pool* _pool);
+void*                 d_pool_alloc(struct d_pool* _pool);
+void                  d_pool_release(struct d_pool* _pool, void* _object);
+void                  d_pool_flush(struct d_pool* _pool);
+bool                  d_pool_get_stats(const struct d_pool* _pool, struct d_pool_stats* _stats);
+
+// aligned and large buffers
+void*                 d_aligned_alloc(size_t _size, size_t _alignment);
+void                  d_aligned_free(void* _ptr);
+void*                 d_large_alloc(size_t _size, unsigned int _flags);
+void*                 d_large_realloc(void* _ptr, size_t _old_size, size_t _new_size, unsigned int _flags);
+void                  d_large_free(void* _ptr, size_t _size);
+
+// pluggable allocators
+const struct d_allocator* d_allocator_system(void);
+const struct d_allocator* d_allocator_default(void);
+void                      d_allocator_set_default(const struct d_allocator* _allocator);
+void*                     d_allocator_alloc(const struct d_allocator* _allocator, size_t _size);
+void*                     d_allocator_alloc_aligned(const struct d_allocator* _allocator, size_t _size, size_t _alignment);
+void*                     d_allocator_realloc(const struct d_allocator* _allocator, void* _ptr, size_t _old_size, size_t _new_size);
+void                      d_allocator_free(const struct d_allocator* _allocator, void* _ptr, size_t _size);
+void*                     d_memdup_s_ex(const struct d_allocator* _allocator, const void* _src, size_t _size);
+const struct d_allocator* d_arena_allocator(struct d_arena* _arena);
+const struct d_allocator* d_pool_allocator(struct d_pool* _pool);
+const struct d_allocator* d_allocator_large(void);
+
+// allocation accounting
+struct d_memory_stats*    d_memory_stats_snapshot(void);
+void                      d_memory_stats_free_snapshot(struct d_memory_stats* _stats);
+void                      d_memory_stats_sort(struct d_memory_stats* _stats, enum d_memory_stats_order _order);
+int                       d_memory_stats_report(const struct d_memory_stats* _stats, FILE* _stream, size_t _max_sites);
+
+#if D_MEMORY_STATS
+void*                     d_memory_stats_alloc(enum d_memory_module _module, const char* _file, int _line, size_t _size);
+void*                     d_memory_stats_calloc(enum d_memory_module _module, const char* _file, int _line, size_t _count, size_t _size);
+void*                     d_memory_stats_realloc(enum d_memory_module _module, const char* _file, int _line, void* _ptr, size_t _size);
+void                      d_memory_stats_free(void* _ptr);
+void                      d_memory_stats_handoff(enum d_memory_module _module, const char* _file, int _line, size_t _size);
+#endif  // D_MEMORY_STATS
+
 
-#endif	// DJINTERP_MEMORY_
\ No newline at end of file
+#endif	// DJINTERP_MEMORY_
@@ -25,22 +25,238 @@
 #include <stdlib.h>
 #include <string.h>
 #include ".\djinterp.h"
+#include ".\datomic.h"
 #include ".\dmemory.h"
 
 
+// D_STRING_SSO_CAPACITY
+//   constant: size, in bytes, of the inline small-string buffer embedded in
+// every d_string (including space for the null terminator). Strings that fit
+// are stored inside the struct itself and require no second allocation.
+#ifndef D_STRING_SSO_CAPACITY
+    #define D_STRING_SSO_CAPACITY 24
+#endif
+
+// D_STRING_IS_INLINE
+//   macro: evaluates to true if the d_string's text currently lives in its
+// inline small-string buffer rather than in a separate heap allocation.
+#define D_STRING_IS_INLINE(str)  ((str)->text == (str)->sso)
+
+// D_STRING_FLAG_HASHED
+//   flag: set in a d_string's `flags` while its `hash` field holds the hash
+// of its current contents. Every mutating d_string_* function clears it.
+#define D_STRING_FLAG_HASHED 0x1u
+
+// D_STRING_FLAG_COUNTED
+//   flag: set in a d_string's `flags` while its `text` lives in a
+// reference-counted heap buffer, which copies of the string may share (see
+// D_STRING_SHARE_THRESHOLD).
+#define D_STRING_FLAG_COUNTED 0x2u
+
+// D_STRING_FLAG_ALLOCATOR
+//   flag: set in a d_string's `flags` when the struct was allocated from a
+// d_allocator other than the system allocator (see d_string_new_ex). Its
+// text lives inline or in memory from the same allocator, grows through it
+// and is never shared; d_string_free returns both to the allocator.
+#define D_STRING_FLAG_ALLOCATOR 0x4u
+
+// D_STRING_PAGE_SIZE
+//   constant: granularity, in bytes, used when rounding large heap buffers.
+// Rounding large buffers to whole pages lets the allocator satisfy growth by
+// extending the mapping in place instead of copying.
+#ifndef D_STRING_PAGE_SIZE
+    #define D_STRING_PAGE_SIZE 4096
+#endif
+
+// D_STRING_PAGE_THRESHOLD
+//   constant: capacity, in bytes, above which geometric growth policies round
+// the new capacity up to a multiple of D_STRING_PAGE_SIZE.
+#ifndef D_STRING_PAGE_THRESHOLD
+    #define D_STRING_PAGE_THRESHOLD (16 * D_STRING_PAGE_SIZE)
+#endif
+
+// D_STRING_SHARE_THRESHOLD
+//   constant: minimum length, in bytes, at which copying a heap-allocated
+// d_string (d_string_dup, d_string_new_copy, d_string_assign, d_string_copy_s)
+// shares its buffer instead of duplicating it. The first d_string_* call that
+// modifies either string then gives it a private copy. Shorter strings are
+// cheaper to copy outright. Define as 0 to disable sharing.
+#ifndef D_STRING_SHARE_THRESHOLD
+    #define D_STRING_SHARE_THRESHOLD 256
+#endif
+
+// D_STRING_BUILDER_CHUNK_SIZE
+//   constant: default payload size, in bytes, of each chunk a d_string_builder
+// allocates. Appends that do not fit are split across chunks, so the chunk
+// size bounds the memory wasted per chunk, not the size of an append.
+#ifndef D_STRING_BUILDER_CHUNK_SIZE
+    #define D_STRING_BUILDER_CHUNK_SIZE 4096
+#endif
+
+// D_STRING_INTERN_SHARDS
+//   constant: number of independently locked shards in a string intern
+// table. Must be a power of two.
+#ifndef D_STRING_INTERN_SHARDS
+    #define D_STRING_INTERN_SHARDS 64
+#endif
+
+// D_STRING_INTERN_BLOCK_SIZE
+//   constant: size, in bytes, of each arena block an intern table shard
+// carves interned strings from. Larger strings get a block of their own.
+#ifndef D_STRING_INTERN_BLOCK_SIZE
+    #define D_STRING_INTERN_BLOCK_SIZE 65536
+#endif
+
+// D_STRING_SORT_PARALLEL_THRESHOLD
+//   constant: minimum number of strings at which d_string_sort_parallel
+// starts additional threads. Smaller arrays sort faster on one thread.
+#ifndef D_STRING_SORT_PARALLEL_THRESHOLD
+    #define D_STRING_SORT_PARALLEL_THRESHOLD 65536
+#endif
+
+// D_STRING_DEFAULT_GROWTH
+//   constant: growth policy assigned to newly created d_strings.
+#ifndef D_STRING_DEFAULT_GROWTH
+    #define D_STRING_DEFAULT_GROWTH D_STRING_GROWTH_DOUBLE
+#endif
+
+
+// d_string_growth_policy
+//   enum: strategy used to pick a new capacity when a d_string must grow.
+// Explicit requests through `d_string_reserve` always allocate exactly the
+// requested capacity, regardless of policy.
+enum d_string_growth_policy
+{
+    D_STRING_GROWTH_DOUBLE = 0,  // double capacity (page-rounded when large)
+    D_STRING_GROWTH_HALF   = 1,  // grow capacity by 1.5x (page-rounded when large)
+    D_STRING_GROWTH_PAGE   = 2,  // grow by 1.5x, always rounded to whole pages
+    D_STRING_GROWTH_EXACT  = 3   // grow to exactly the required capacity
+};
+
+
 // d_string
 //   struct: a safe string type containing a textual value and its length.
-// The text is always null-terminated for compatibility with C string 
+// The text is always null-terminated for compatibility with C string
 // functions. Unlike text_buffer, d_string is intended for strings that may
 // occasionally be resized but do not undergo frequent modifications.
+//   Short strings are stored in the inline `sso` buffer; `text` always points
+// at the live buffer (inline or heap), so callers never need to distinguish
+// the two representations. Because `text` may point into the struct itself,
+// a d_string must not be copied or moved by value.
+//   Long strings copied with d_string_dup and friends share one buffer until
+// either is modified (copy-on-write), so code that writes through `text`
+// directly (rather than via d_string_* functions) must take the pointer from
+// d_string_data, which first gives the string a private buffer, and must call
+// d_string_hash_invalidate afterwards.
 struct d_string
 {
-    size_t size;        // length of string (excluding null terminator)
-    char*  text;        // null-terminated string data
-    size_t capacity;    // allocated capacity (including space for null)
+    size_t size;                        // length of string (excluding null terminator)
+    char*  text;                        // null-terminated string data
+    size_t capacity;                    // allocated capacity (including space for null)
+    enum d_string_growth_policy growth; // strategy used when the buffer must grow
+    unsigned int flags;                 // D_STRING_FLAG_* state bits
+    size_t hash;                        // cached hash (if D_STRING_FLAG_HASHED)
+    char   sso[D_STRING_SSO_CAPACITY];  // inline storage for short strings
+};
+
+// d_string_view
+//   struct: a non-owning, read-only window onto a run of characters, such as
+// part of a d_string or C string. A view never allocates and its text is not
+// necessarily null-terminated; it is only valid for as long as the storage it
+// refers to is neither freed nor modified. Views are small and passed by
+// value. An empty view may have a NULL `text`.
+struct d_string_view
+{
+    const char* text;  // first character of the view (not null-terminated)
+    size_t      size;  // number of characters in the view
+};
+
+// d_string_split_iter
+//   struct: state for lazily splitting text into views on a set of delimiter
+// characters. Like d_string_split, consecutive delimiters are collapsed and
+// empty tokens are never produced. The source is neither copied nor modified.
+struct d_string_split_iter
+{
+    const char*   cursor;      // next unexamined character
+    const char*   end;         // one past the last character of the source
+    unsigned char delims[32];  // bitset of delimiter characters
 };
 
 
+// d_string_builder_chunk
+//   struct: one segment of a d_string_builder's contents. Heap chunks store
+// their payload directly after this header.
+struct d_string_builder_chunk
+{
+    struct d_string_builder_chunk* next;
+    char*                          data;
+    size_t                         size;      // bytes in use
+    size_t                         capacity;  // bytes available at `data`
+};
+
+// d_string_builder
+//   struct: an append-only buffer for assembling large strings. Appends fill
+// a list of chunks, so nothing already written is ever moved or copied; the
+// result is copied exactly once, into a correctly sized d_string, by
+// d_string_builder_build, or streamed straight to a file descriptor by
+// d_string_builder_write. The `first` chunk may be backed by caller-supplied
+// storage (stack, static or arena memory), which is used before any chunk is
+// allocated. Like d_string, a builder must not be copied or moved by value.
+struct d_string_builder
+{
+    struct d_string_builder_chunk* tail;        // chunk currently appended to
+    size_t                         size;        // total bytes appended
+    size_t                         chunk_size;  // payload size of new chunks
+    struct d_string_builder_chunk  first;       // head; caller storage or empty
+};
+
+
+// d_string_intern_table
+//   struct: opaque, thread-safe table of interned strings. Interning returns
+// a canonical, immutable d_string per distinct content: two handles from the
+// same table are equal exactly when their pointers are. Handles stay valid
+// until the table is freed and must never be modified or freed directly.
+struct d_string_intern_table;
+
+// d_string_intern_stats
+//   struct: counters describing an intern table's contents and use.
+struct d_string_intern_stats
+{
+    size_t strings;         // distinct strings interned
+    size_t lookups;         // intern calls made
+    size_t hits;            // intern calls that added no new string
+    size_t bytes_interned;  // text bytes stored, excluding terminators
+    size_t bytes_reserved;  // arena and index bytes held by the table
+    size_t bytes_saved;     // bytes a separate d_string per hit would cost
+};
+
+// D_STRING_NORMALIZE_*
+//   flags: d_string_normalize options, combined with bitwise OR.
+#define D_STRING_NORMALIZE_TRIM     0x1u  // remove leading/trailing whitespace
+#define D_STRING_NORMALIZE_LOWER    0x2u  // map ASCII letters to lowercase
+#define D_STRING_NORMALIZE_UPPER    0x4u  // map ASCII letters to uppercase
+#define D_STRING_NORMALIZE_COLLAPSE 0x8u  // replace whitespace runs with ' '
+
+// D_STRING_MATCHER_IGNORE_CASE
+//   flag: d_string_matcher option; patterns match regardless of ASCII case.
+#define D_STRING_MATCHER_IGNORE_CASE 0x1u
+
+// d_string_matcher
+//   struct: opaque multi-pattern matcher compiled once from a set of
+// patterns, after which any number of texts can be searched for all of them
+// in a single pass. A matcher is immutable once built, so one instance may
+// be shared by concurrent searches.
+struct d_string_matcher;
+
+// d_string_match
+//   struct: one occurrence of a matcher pattern in a text.
+struct d_string_match
+{
+    size_t position;  // offset of the match in the text
+    size_t length;    // length of the match
+    size_t pattern;   // index of the pattern in the set given to the matcher
+};
+
 // creation functions
 struct d_string* d_string_new(void);
 struct d_string* d_string_new_with_capacity(size_t _capacity);
@@ -50,12 +266,24 @@ struct d_string* d_string_new_from_buffer(const char* _buffer, size_t _length);
 struct d_string* d_string_new_copy(const struct d_string* _other);
 struct d_string* d_string_new_fill(size_t _length, char _fill_char);
 struct d_string* d_string_new_formatted(const char* _format, ...);
+//   allocator-backed creation (see D_STRING_FLAG_ALLOCATOR)
+struct d_string* d_string_new_ex(const struct d_allocator* _allocator, size_t _capacity);
+struct d_string* d_string_new_from_cstr_ex(const struct d_allocator* _allocator, const char* _cstr);
+struct d_string* d_string_new_from_buffer_ex(const struct d_allocator* _allocator, const char* _buffer, size_t _length);
+struct d_string* d_string_new_copy_ex(const struct d_allocator* _allocator, const struct d_string* _other);
+struct d_string* d_string_arena_new(struct d_arena* _arena, size_t _capacity);
+struct d_string* d_string_arena_new_from_cstr(struct d_arena* _arena, const char* _cstr);
+struct d_string* d_string_arena_new_from_buffer(struct d_arena* _arena, const char* _buffer, size_t _length);
+struct d_string* d_string_arena_new_copy(struct d_arena* _arena, const struct d_string* _other);
 
 // capacity management functions
 bool       d_string_reserve(struct d_string* _str, size_t _capacity);
 bool       d_string_shrink_to_fit(struct d_string* _str);
 size_t     d_string_capacity(const struct d_string* _str);
 bool       d_string_resize(struct d_string* _str, size_t _new_size);
+bool       d_string_set_growth_policy(struct d_string* _str, enum d_string_growth_policy _policy);
+enum d_string_growth_policy d_string_get_growth_policy(const struct d_string* _str);
+bool       d_string_is_shared(const struct d_string* _str);
 
 // Access functions
 //   basic accessors
@@ -150,6 +378,7 @@ bool d_string_append_cstr(struct d_string* _str, const char* _cstr);
 bool d_string_append_buffer(struct d_string* _str, const char* _buffer, size_t _length);
 bool d_string_append_char(struct d_string* _str, char _c);
 bool d_string_append_formatted(struct d_string* _str, const char* _format, ...);
+bool d_string_append_vformatted(struct d_string* _str, const char* _format, va_list _args);
 // prepend
 bool d_string_prepend(struct d_string* _str, const struct d_string* _other);
 bool d_string_prepend_cstr(struct d_string* _str, const char* _cstr);
@@ -191,17 +420,62 @@ bool d_string_trim_chars(struct d_string* _str, const char* _chars);
 struct d_string* d_string_trimmed(const struct d_string* _str);
 struct d_string* d_string_trimmed_left(const struct d_string* _str);
 struct d_string* d_string_trimmed_right(const struct d_string* _str);
+//   fused trim, case mapping and whitespace collapse
+bool d_string_normalize(struct d_string* _str, unsigned _flags);
 
 // Tokenization functions (POSIX `strtok_r` equivalent)
 char*  d_string_tokenize(struct d_string* _str, const char* _delim, char** _saveptr);
 size_t d_string_split(const struct d_string* _str, const char* _delim, struct d_string*** _tokens);
 void   d_string_split_free(struct d_string** _tokens, size_t _count);
 
+// String view functions
+//   construction
+struct d_string_view d_string_view_make(const char* _text, size_t _size);
+struct d_string_view d_string_view_from_cstr(const char* _cstr);
+struct d_string_view d_string_view_of(const struct d_string* _str);
+struct d_string*     d_string_new_from_view(struct d_string_view _view);
+//   slicing and trimming
+struct d_string_view d_string_view_substr(struct d_string_view _view, d_index _start, size_t _length);
+struct d_string_view d_string_substr_view(const struct d_string* _str, d_index _start, size_t _length);
+struct d_string_view d_string_view_trimmed(struct d_string_view _view);
+struct d_string_view d_string_view_trimmed_left(struct d_string_view _view);
+struct d_string_view d_string_view_trimmed_right(struct d_string_view _view);
+struct d_string_view d_string_trimmed_view(const struct d_string* _str);
+struct d_string_view d_string_trimmed_left_view(const struct d_string* _str);
+struct d_string_view d_string_trimmed_right_view(const struct d_string* _str);
+//   search
+d_index              d_string_view_find(struct d_string_view _haystack, struct d_string_view _needle);
+d_index              d_string_view_find_cstr(struct d_string_view _haystack, const char* _needle);
+d_index              d_string_view_find_char(struct d_string_view _view, char _c);
+d_index              d_string_view_rfind(struct d_string_view _haystack, struct d_string_view _needle);
+//   comparison
+int                  d_string_view_cmp(struct d_string_view _v1, struct d_string_view _v2);
+int                  d_string_view_cmp_cstr(struct d_string_view _v1, const char* _s2);
+bool                 d_string_view_equals(struct d_string_view _v1, struct d_string_view _v2);
+bool                 d_string_view_equals_cstr(struct d_string_view _v1, const char* _s2);
+bool                 d_string_view_starts_with(struct d_string_view _view, struct d_string_view _prefix);
+bool                 d_string_view_ends_with(struct d_string_view _view, struct d_string_view _suffix);
+//   zero-copy splitting
+bool                 d_string_split_iter_init(struct d_string_split_iter* _iter, struct d_string_view _source, const char* _delim);
+bool                 d_string_split_iter_next(struct d_string_split_iter* _iter, struct d_string_view* _token);
+size_t               d_string_split_view(const struct d_string* _str, const char* _delim, struct d_string_view** _tokens);
+
 // Join functions
 struct d_string* d_string_join(const struct d_string* const* _strings, size_t _count, const char* _delimiter);
 struct d_string* d_string_join_cstr(const char* const* _strings, size_t _count, const char* _delimiter);
 struct d_string* d_string_concat(size_t _count, ...);
 
+// Sorting functions
+bool   d_string_sort(struct d_string** _strings, size_t _count);
+bool   d_string_sort_parallel(struct d_string** _strings, size_t _count, size_t _threads);
+size_t d_string_unique(struct d_string** _strings, size_t _count);
+
+// Edit distance functions (Levenshtein)
+size_t d_string_distance(const struct d_string* _a, const struct d_string* _b);
+size_t d_string_distance_bounded(const struct d_string* _a, const struct d_string* _b, size_t _max);
+size_t d_string_view_distance(struct d_string_view _a, struct d_string_view _b, size_t _max);
+size_t d_string_distance_batch(const struct d_string* _query, const struct d_string* const* _candidates, size_t _count, size_t _max, size_t* _distances);
+
 // Utility functions
 //   validation
 bool   d_string_is_valid(const struct d_string* _str);
@@ -210,11 +484,31 @@ bool   d_string_is_numeric(const struct d_string* _str);
 bool   d_string_is_alpha(const struct d_string* _str);
 bool   d_string_is_alnum(const struct d_string* _str);
 bool   d_string_is_whitespace(const struct d_string* _str);
+bool   d_string_is_valid_utf8(const struct d_string* _str);
 //   counting
 size_t d_string_count_char(const struct d_string* _str, char _c);
 size_t d_string_count_substr(const struct d_string* _str, const char* _substr);
+ssize_t d_string_utf8_length(const struct d_string* _str);
 //   hash
-size_t d_string_hash(const struct d_string* _str);
+size_t   d_string_hash(const struct d_string* _str);
+size_t   d_string_hash_cached(struct d_string* _str);
+void     d_string_hash_invalidate(struct d_string* _str);
+uint64_t d_string_hash_bytes(const void* _data, size_t _size);
+size_t   d_string_view_hash(struct d_string_view _view);
+bool     d_string_hash_set_seed(uint64_t _seed);
+
+// Numeric conversion functions (locale-independent `strtoll`/`strtod`)
+//   parsing
+int  d_string_to_int64(const struct d_string* _str, int64_t* _value);
+int  d_string_to_uint64(const struct d_string* _str, uint64_t* _value);
+int  d_string_to_double(const struct d_string* _str, double* _value);
+int  d_string_view_to_int64(struct d_string_view _view, int64_t* _value);
+int  d_string_view_to_uint64(struct d_string_view _view, uint64_t* _value);
+int  d_string_view_to_double(struct d_string_view _view, double* _value);
+//   formatting
+bool d_string_append_int(struct d_string* _str, int64_t _value);
+bool d_string_append_uint(struct d_string* _str, uint64_t _value);
+bool d_string_append_double(struct d_string* _str, double _value);
 
 // Thread-safe error string (POSIX `strerror_r` equivalent)
 struct d_string* d_string_error(int _errnum);
@@ -229,5 +523,51 @@ int d_string_sprintf(struct d_string* _str, const char* _format, ...);
 void             d_string_free(struct d_string* _str);
 void             d_string_free_contents(struct d_string* _str);
 
+// String interning functions
+struct d_string_intern_table* d_string_intern_table_new(void);
+void                          d_string_intern_table_free(struct d_string_intern_table* _table);
+const struct d_string*        d_string_intern_buffer(struct d_string_intern_table* _table, const char* _buffer, size_t _length);
+const struct d_string*        d_string_intern_cstr(struct d_string_intern_table* _table, const char* _cstr);
+const struct d_string*        d_string_intern_string(struct d_string_intern_table* _table, const struct d_string* _str);
+const struct d_string*        d_string_intern_view(struct d_string_intern_table* _table, struct d_string_view _view);
+const struct d_string*        d_string_intern_find(struct d_string_intern_table* _table, const char* _buffer, size_t _length);
+size_t                        d_string_intern_count(struct d_string_intern_table* _table);
+bool                          d_string_intern_stats(struct d_string_intern_table* _table, struct d_string_intern_stats* _stats);
+
+// Multi-pattern matching functions
+struct d_string_matcher* d_string_matcher_new(const char* const* _patterns, size_t _count, unsigned _flags);
+struct d_string_matcher* d_string_matcher_new_views(const struct d_string_view* _patterns, size_t _count, unsigned _flags);
+void                     d_string_matcher_free(struct d_string_matcher* _matcher);
+size_t                   d_string_matcher_pattern_count(const struct d_string_matcher* _matcher);
+bool                     d_string_matcher_contains(const struct d_string_matcher* _matcher, struct d_string_view _text);
+bool                     d_string_matcher_find_first(const struct d_string_matcher* _matcher, struct d_string_view _text, struct d_string_match* _match);
+size_t                   d_string_matcher_find_all(const struct d_string_matcher* _matcher, struct d_string_view _text, struct d_string_match** _matches);
+bool                     d_string_matcher_replace(const struct d_string_matcher* _matcher, struct d_string* _str, const struct d_string_view* _replacements);
+bool                     d_string_replace_all_map(struct d_string* _str, const char* const* _old, const char* const* _new, size_t _count);
+
+// String builder functions
+//   lifetime
+struct d_string_builder* d_string_builder_new(size_t _chunk_size);
+bool                     d_string_builder_init(struct d_string_builder* _sb, size_t _chunk_size, void* _buffer, size_t _buffer_size);
+void                     d_string_builder_clear(struct d_string_builder* _sb);
+void                     d_string_builder_free(struct d_string_builder* _sb);
+void                     d_string_builder_free_contents(struct d_string_builder* _sb);
+//   appending
+bool                     d_string_builder_append_buffer(struct d_string_builder* _sb, const char* _buffer, size_t _length);
+bool                     d_string_builder_append_cstr(struct d_string_builder* _sb, const char* _cstr);
+bool                     d_string_builder_append_char(struct d_string_builder* _sb, char _c);
+bool                     d_string_builder_append_string(struct d_string_builder* _sb, const struct d_string* _str);
+bool                     d_string_builder_append_view(struct d_string_builder* _sb, struct d_string_view _view);
+bool                     d_string_builder_append_int(struct d_string_builder* _sb, int64_t _value);
+bool                     d_string_builder_append_uint(struct d_string_builder* _sb, uint64_t _value);
+bool                     d_string_builder_append_double(struct d_string_builder* _sb, double _value);
+bool                     d_string_builder_append_formatted(struct d_string_builder* _sb, const char* _format, ...);
+bool                     d_string_builder_append_vformatted(struct d_string_builder* _sb, const char* _format, va_list _args);
+//   output
+size_t                   d_string_builder_size(const struct d_string_builder* _sb);
+struct d_string*         d_string_builder_build(const struct d_string_builder* _sb);
+struct d_string*         d_string_builder_build_ex(const struct d_allocator* _allocator, const struct d_string_builder* _sb);
+ssize_t                  d_string_builder_write(const struct d_string_builder* _sb, int _fd);
+
 
 #endif  // DJINTERP_STRING_
@@ -10,10 +10,12 @@
 *   - operating systems using a block/flag classification system
 *   - build configuration (Debug/Release)
 *   - platform characteristics (endianness, bit width)
+*   - run-time CPU features (SSE2 to AVX-512, NEON, SVE) for kernel dispatch
 *
 *   The header creates a unified D_ENV_* macro interface enabling portable code
 * that adapts to different platforms, compilers, and architectures. All
-* detection is performed at compile-time with zero runtime overhead.
+* detection is performed at compile-time with zero runtime overhead, except
+* for the CPU feature probe, which runs once on first use.
 *
 *   CONFIGURATION SYSTEM:
 *   This header supports custom environment simulation via D_CFG_ENV_CUSTOM:
@@ -2308,5 +2310,100 @@
     
 #endif  // D_DEBUG_
 
+// =============================================================================
+// X.   RUNTIME CPU FEATURES
+// =============================================================================
+// Section VII-K reports which instruction sets the compiler targets; this
+// section reports which ones the CPU running the program supports. The probe
+// (cpuid/xgetbv on x86, getauxval(AT_HWCAP) on Linux ARM) runs once, on first
+// use, and is cached. Modules compile several versions of a kernel and use
+// d_env_cpu_features to pick the best one at run time, typically by resolving
+// a table of function pointers once.
+//   Setting the D_ENV_CPU_OVERRIDE_VAR environment variable to a tier name
+// ("scalar", "sse2", "sse4.2", "avx2", "avx512", "neon", "sve") limits the
+// reported features to that tier, so each tier's kernels can be benchmarked
+// on one machine. It cannot enable features the CPU lacks.
+//   d_env_cpu_cache_size reports the size of the last-level cache, for
+// thresholds that depend on whether data fits in cache.
+
+#include <stddef.h>
+#include <stdint.h>
+
+// D_ENV_CPU_FEATURE_*
+//   flags: instruction set extensions reported by d_env_cpu_features. The AVX
+// and AVX-512 flags are only set if the operating system saves their
+// registers.
+#define D_ENV_CPU_FEATURE_SSE2      0x00000001u
+#define D_ENV_CPU_FEATURE_SSE3      0x00000002u
+#define D_ENV_CPU_FEATURE_SSSE3     0x00000004u
+#define D_ENV_CPU_FEATURE_SSE41     0x00000008u
+#define D_ENV_CPU_FEATURE_SSE42     0x00000010u
+#define D_ENV_CPU_FEATURE_POPCNT    0x00000020u
+#define D_ENV_CPU_FEATURE_AVX       0x00000040u
+#define D_ENV_CPU_FEATURE_AVX2      0x00000080u
+#define D_ENV_CPU_FEATURE_BMI1      0x00000100u
+#define D_ENV_CPU_FEATURE_BMI2      0x00000200u
+#define D_ENV_CPU_FEATURE_FMA       0x00000400u
+#define D_ENV_CPU_FEATURE_AVX512F   0x00000800u
+#define D_ENV_CPU_FEATURE_AVX512BW  0x00001000u
+#define D_ENV_CPU_FEATURE_AVX512VL  0x00002000u
+#define D_ENV_CPU_FEATURE_NEON      0x00010000u
+#define D_ENV_CPU_FEATURE_CRC32     0x00020000u
+#define D_ENV_CPU_FEATURE_SVE       0x00040000u
+#define D_ENV_CPU_FEATURE_SVE2      0x00080000u
+
+// D_ENV_CPU_TIER_*
+//   constant: kernel tiers, from least to most capable. Each tier implies
+// the features of the tiers below it on the same architecture (see
+// d_env_cpu_tier_features).
+#define D_ENV_CPU_TIER_SCALAR       0
+#define D_ENV_CPU_TIER_SSE2         1
+#define D_ENV_CPU_TIER_SSE42        2
+#define D_ENV_CPU_TIER_AVX2         3
+#define D_ENV_CPU_TIER_AVX512       4
+#define D_ENV_CPU_TIER_NEON         5
+#define D_ENV_CPU_TIER_SVE          6
+#define D_ENV_CPU_TIER_COUNT        7
+
+// D_ENV_CPU_OVERRIDE_VAR
+//   constant: name of the environment variable that caps the reported
+// features at a tier.
+#define D_ENV_CPU_OVERRIDE_VAR      "DJINTERP_CPU"
+
+// D_ENV_CPU_DISPATCH_X86
+//   feature: 1 if single functions can be compiled for a newer x86
+// instruction set than the rest of their file (GCC/Clang `target`
+// attribute), so kernels for several tiers can ship in one binary and be
+// selected at run time; 0 otherwise.
+// D_ENV_CPU_TARGET_*
+//   macro: function attributes compiling a kernel for a tier; empty when
+// D_ENV_CPU_DISPATCH_X86 is 0.
+#if ( (defined(__GNUC__) || defined(__clang__)) &&                   \
+      (defined(__x86_64__) || defined(__i386__)) )
+    #define D_ENV_CPU_DISPATCH_X86  1
+    #define D_ENV_CPU_TARGET_SSE42  __attribute__((target("sse4.2,popcnt")))
+    #define D_ENV_CPU_TARGET_AVX2   __attribute__((target("avx2")))
+    #define D_ENV_CPU_TARGET_AVX512 \
+        __attribute__((target("avx512f,avx512bw,avx512vl,avx2")))
+#else
+    #define D_ENV_CPU_DISPATCH_X86  0
+    #define D_ENV_CPU_TARGET_SSE42
+    #define D_ENV_CPU_TARGET_AVX2
+    #define D_ENV_CPU_TARGET_AVX512
+#endif
+
+// D_ENV_CPU_HAS
+//   macro: evaluates to nonzero if the running CPU supports every feature in
+// `features` (a combination of D_ENV_CPU_FEATURE_* flags).
+#define D_ENV_CPU_HAS(features)                                            \
+    ((d_env_cpu_features() & (features)) == (features))
+
+uint32_t    d_env_cpu_features(void);
+uint32_t    d_env_cpu_features_detected(void);
+int         d_env_cpu_tier(void);
+uint32_t    d_env_cpu_tier_features(int _tier);
+const char* d_env_cpu_tier_name(int _tier);
+size_t      d_env_cpu_cache_size(void);
+
 
 #endif  // DJINTERP_ENVIRONMENT_
@@ -22,7 +22,8 @@ struct d_dir_t
 #else
     DIR* handle;
 #endif
-    struct d_dirent_t entry;
+    struct d_dirent_t         entry;
+    const struct d_allocator* allocator;  // source of this structure
 };
 
 
@@ -30,6 +31,61 @@ struct d_dir_t
 //   constant: buffer size for file copy operations.
 #define D_INTERNAL_FILE_COPY_BUF_SIZE 65536
 
+// D_INTERNAL_FILE_COPY_BUF_ALIGNMENT
+//   constant: alignment of the file copy buffer; a page, so stdio's reads and
+// writes land on whole pages.
+#define D_INTERNAL_FILE_COPY_BUF_ALIGNMENT 4096
+
+
+// D_INTERNAL_GLOB_STACK_WORDS
+//   constant: number of 64-bit state words a glob match keeps on the stack;
+// larger automata (more than 64 * D_INTERNAL_GLOB_STACK_WORDS states)
+// allocate their state vector per call.
+#define D_INTERNAL_GLOB_STACK_WORDS 32
+
+// d_internal_glob_nfa
+//   struct: a glob compiled to a bit-parallel automaton, one bit per state.
+// State j of a pattern means "j tokens matched"; a token consumes one byte,
+// `*` and `**` become self-loops on the state they occur at. Input bytes are
+// mapped to classes of identical behaviour so the tables hold one column per
+// class instead of 256. Every row of a table has `words` 64-bit words.
+struct d_internal_glob_nfa
+{
+    uint64_t*      shift;       // [class]: states entered by a byte
+    uint64_t*      loop;        // [class]: states a byte keeps active
+    uint64_t*      skip;        // states of `**/` that also enter the next
+    uint64_t*      start;       // initial states
+    uint64_t*      accept;      // final states
+    size_t         words;
+    unsigned       flags;
+    unsigned short lead_dot;    // class of '.' at the start of a name
+    unsigned short classes[256];
+};
+
+// d_glob_pattern
+//   struct: a compiled glob. Literal runs at either end of the pattern are
+// compared directly and only the middle of a path runs through the automaton.
+struct d_glob_pattern
+{
+    struct d_internal_glob_nfa nfa;
+    char*                      literal;  // prefix bytes, then suffix bytes
+    size_t                     prefix;   // length of the literal prefix
+    size_t                     suffix;   // length of the literal suffix
+    size_t                     tokens;   // number of tokens
+    size_t                     shortest; // shortest matching path length
+    int                        pure;     // pattern has no wildcards at all
+};
+
+// d_glob_set
+//   struct: several globs compiled into one automaton, so a path is matched
+// against all of them in a single pass.
+struct d_glob_set
+{
+    struct d_internal_glob_nfa nfa;
+    size_t*                    finals;   // final state of each pattern
+    size_t                     count;
+};
+
 
 ///////////////////////////////////////////////////////////////////////////////
 ///             III.  SECURE FILE OPENING                                   ///
@@ -1790,7 +1846,8 @@ d_rmdir
 
 /*
 d_opendir
-  Open directory for reading.
+  Open directory for reading. The handle is allocated from
+d_allocator_default.
 
 Parameter(s):
   _path: path to directory.
@@ -1802,6 +1859,28 @@ d_opendir
 (
     const char* _path
 )
+{
+    return d_opendir_ex(NULL, _path);
+}
+
+
+/*
+d_opendir_ex
+  Open directory for reading, allocating the handle from `_allocator`;
+d_closedir returns it there.
+
+Parameter(s):
+  _allocator: the allocator, or NULL for d_allocator_default.
+  _path:      path to directory.
+Return:
+  Directory handle on success, NULL on failure.
+*/
+struct d_dir_t*
+d_opendir_ex
+(
+    const struct d_allocator* _allocator,
+    const char*               _path
+)
 {
     struct d_dir_t* dir;
 
@@ -1813,7 +1892,12 @@ d_opendir
         return NULL;
     }
 
-    dir = malloc(sizeof(struct d_dir_t));
+    if (!_allocator)
+    {
+        _allocator = d_allocator_default();
+    }
+
+    dir = d_allocator_alloc(_allocator, sizeof(struct d_dir_t));
     if (!dir)
     {
         errno = ENOMEM;
@@ -1822,6 +1906,7 @@ d_opendir
     }
 
     d_memset(dir, 0, sizeof(struct d_dir_t));
+    dir->allocator = _allocator;
 
 #if defined(D_FILE_PLATFORM_WINDOWS)
     {
@@ -1831,7 +1916,7 @@ d_opendir
         len = strlen(_path);
         if (len >= D_FILE_PATH_MAX - 3)
         {
-            free(dir);
+            d_allocator_free(_allocator, dir, sizeof(struct d_dir_t));
             errno = ENAMETOOLONG;
 
             return NULL;
@@ -1852,7 +1937,7 @@ d_opendir
         dir->handle = FindFirstFileA(search_path, &dir->find_data);
         if (dir->handle == INVALID_HANDLE_VALUE)
         {
-            free(dir);
+            d_allocator_free(_allocator, dir, sizeof(struct d_dir_t));
 
             return NULL;
         }
@@ -1864,7 +1949,7 @@ d_opendir
     dir->handle = opendir(_path);
     if (!dir->handle)
     {
-        free(dir);
+        d_allocator_free(_allocator, dir, sizeof(struct d_dir_t));
 
         return NULL;
     }
@@ -1995,7 +2080,7 @@ d_closedir
     result = closedir(_dir->handle);
 #endif
 
-    free(_dir);
+    d_allocator_free(_dir->allocator, _dir, sizeof(struct d_dir_t));
 
     return result;
 }
@@ -2206,11 +2291,12 @@ d_copy_file
 
     return 0;
 #else
-    FILE*  src_file;
-    FILE*  dst_file;
-    char*  buffer;
-    size_t bytes_read;
-    int    result;
+    const struct d_allocator* allocator;
+    FILE*                     src_file;
+    FILE*                     dst_file;
+    char*                     buffer;
+    size_t                    bytes_read;
+    int                       result;
 
     // portable implementation
     src_file = d_fopen(_src, "rb");
@@ -2227,7 +2313,17 @@ d_copy_file
         return -1;
     }
 
-    buffer = malloc(D_INTERNAL_FILE_COPY_BUF_SIZE);
+    allocator = d_allocator_default();
+    buffer    = d_allocator_alloc_aligned(allocator,
+                                          D_INTERNAL_FILE_COPY_BUF_SIZE,
+                                          D_INTERNAL_FILE_COPY_BUF_ALIGNMENT);
+
+    // allocators that cannot align that strictly still serve a plain buffer
+    if (!buffer)
+    {
+        buffer = d_allocator_alloc(allocator, D_INTERNAL_FILE_COPY_BUF_SIZE);
+    }
+
     if (!buffer)
     {
         fclose(src_file);
@@ -2254,7 +2350,7 @@ d_copy_file
         result = -1;
     }
 
-    free(buffer);
+    d_allocator_free(allocator, buffer, D_INTERNAL_FILE_COPY_BUF_SIZE);
     fclose(src_file);
     fclose(dst_file);
 
@@ -2399,6 +2495,11 @@ d_realpath
             return NULL;
         }
 
+        if (!_resolved)
+        {
+            D_MEMORY_HANDOFF(D_MEMORY_MODULE_FILE, D_FILE_PATH_MAX);
+        }
+
         return result;
     }
 #elif D_FILE_HAS_REALPATH
@@ -2434,6 +2535,11 @@ d_realpath
             return NULL;
         }
 
+        if (!_resolved)
+        {
+            D_MEMORY_HANDOFF(D_MEMORY_MODULE_FILE, D_FILE_PATH_MAX);
+        }
+
         return result;
     }
 #endif
@@ -3183,6 +3289,74 @@ d_pclose
 ///             XV.   BINARY I/O HELPERS                                    ///
 ///////////////////////////////////////////////////////////////////////////////
 
+/*
+d_internal_file_caller_allocate
+  The `allocate` function of d_internal_file_caller_allocator. Buffers are
+aligned to D_MEMORY_CACHE_LINE_SIZE where posix_memalign can do so and still
+be released with free.
+*/
+static void*
+d_internal_file_caller_allocate
+(
+    void*  _context,
+    size_t _size,
+    size_t _alignment
+)
+{
+    void* memory;
+
+    (void)_context;
+    (void)_alignment;
+
+#if D_ENV_C_HAS_POSIX_MEMALIGN
+    if (posix_memalign(&memory, D_MEMORY_CACHE_LINE_SIZE, _size) != 0)
+    {
+        memory = NULL;
+    }
+#else
+    memory = malloc(_size);
+#endif
+
+    if (memory != NULL)
+    {
+        D_MEMORY_HANDOFF(D_MEMORY_MODULE_FILE, _size);
+    }
+
+    return memory;
+}
+
+/*
+d_internal_file_caller_deallocate
+  The `deallocate` function of d_internal_file_caller_allocator.
+*/
+static void
+d_internal_file_caller_deallocate
+(
+    void*  _context,
+    void*  _ptr,
+    size_t _size
+)
+{
+    (void)_context;
+    (void)_size;
+
+    free(_ptr);
+
+    return;
+}
+
+// allocator of buffers the caller releases with free; unlike
+// d_allocator_system, it accounts for them as handed off (see
+// D_MEMORY_HANDOFF)
+static const struct d_allocator d_internal_file_caller_allocator =
+{
+    d_internal_file_caller_allocate,
+    NULL,
+    NULL,
+    d_internal_file_caller_deallocate,
+    NULL
+};
+
 /*
 d_fread_all
   Read entire file into memory.
@@ -3200,6 +3374,34 @@ d_fread_all
     const char* _path, 
     size_t*     _size
 )
+{
+    // the caller releases the buffer with free
+    return d_fread_all_ex(&d_internal_file_caller_allocator, _path, _size);
+}
+
+
+/*
+d_fread_all_ex
+  Read entire file into memory allocated from `_allocator`.
+
+Parameter(s):
+  _allocator: the allocator, or NULL for d_allocator_default.
+  _path:      path to file.
+  _size:      pointer to receive the number of bytes read (may be NULL).
+Return:
+  Pointer to allocated buffer containing file contents, or NULL on failure.
+  The buffer is one byte longer than the file, for a null terminator; the
+  caller must release it with d_allocator_free(_allocator, buffer, size + 1).
+  Pass d_allocator_large to map large files' images directly, page-aligned
+  and backed by huge pages where available.
+*/
+void*
+d_fread_all_ex
+(
+    const struct d_allocator* _allocator,
+    const char*               _path,
+    size_t*                   _size
+)
 {
     FILE*   file;
     int64_t file_size;
@@ -3212,6 +3414,11 @@ d_fread_all
         return NULL;
     }
 
+    if (!_allocator)
+    {
+        _allocator = d_allocator_default();
+    }
+
     if (_size)
     {
         *_size = 0;
@@ -3231,7 +3438,8 @@ d_fread_all
         return NULL;
     }
 
-    buffer = malloc((size_t)file_size + 1);  // +1 for null terminator
+    // +1 for null terminator
+    buffer = d_allocator_alloc(_allocator, (size_t)file_size + 1);
     if (!buffer)
     {
         fclose(file);
@@ -3245,7 +3453,7 @@ d_fread_all
 
     if (bytes_read != (size_t)file_size)
     {
-        free(buffer);
+        d_allocator_free(_allocator, buffer, (size_t)file_size + 1);
 
         return NULL;
     }
@@ -3366,4 +3574,1367 @@ d_fappend_all
     fclose(file);
 
     return 0;
-}
\ No newline at end of file
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+///             XVI.  GLOB PATTERNS                                         ///
+///////////////////////////////////////////////////////////////////////////////
+
+// D_INTERNAL_GLOB_LOOP_*
+//   constant: self-loop a state carries: none, any byte but a separator
+// (`*`), or any byte at all (`**` as a whole path component).
+#define D_INTERNAL_GLOB_LOOP_NONE 0
+#define D_INTERNAL_GLOB_LOOP_NAME 1
+#define D_INTERNAL_GLOB_LOOP_ANY  2
+
+// d_internal_glob_token
+//   struct: one byte-consuming pattern token; `set` is the 256-bit set of
+// bytes it accepts and `literal` the byte it stands for, or -1 for `?` and
+// bracket expressions.
+struct d_internal_glob_token
+{
+    uint64_t set[4];
+    int      literal;
+};
+
+// d_internal_glob_parsed
+//   struct: a pattern split into tokens, with the loop kind of each of its
+// `count + 1` states and whether a state is a `**/` whose '/' may be skipped.
+struct d_internal_glob_parsed
+{
+    struct d_internal_glob_token* tokens;
+    unsigned char*                loops;
+    unsigned char*                skips;
+    size_t                        count;
+};
+
+
+/*
+d_internal_glob_is_sep
+  Returns nonzero if _c is a path separator ('/', and '\' on Windows).
+*/
+static int
+d_internal_glob_is_sep
+(
+    unsigned char _c
+)
+{
+    return ( (_c == (unsigned char)D_FILE_PATH_SEP) ||
+             (_c == (unsigned char)D_FILE_PATH_SEP_ALT) );
+}
+
+
+/*
+d_internal_glob_add
+  Adds byte _c to token set _set, in both cases if _flags has D_GLOB_NOCASE.
+*/
+static void
+d_internal_glob_add
+(
+    uint64_t*     _set,
+    unsigned char _c,
+    unsigned      _flags
+)
+{
+    _set[_c >> 6] |= (uint64_t)1 << (_c & 63);
+
+    if ( (_flags & D_GLOB_NOCASE) &&
+         (_c >= 'A') && (_c <= 'Z') )
+    {
+        _c = (unsigned char)(_c + ('a' - 'A'));
+        _set[_c >> 6] |= (uint64_t)1 << (_c & 63);
+    }
+    else if ( (_flags & D_GLOB_NOCASE) &&
+              (_c >= 'a') && (_c <= 'z') )
+    {
+        _c = (unsigned char)(_c - ('a' - 'A'));
+        _set[_c >> 6] |= (uint64_t)1 << (_c & 63);
+    }
+}
+
+
+/*
+d_internal_glob_has
+  Returns nonzero if byte _c is in token set _set.
+*/
+static int
+d_internal_glob_has
+(
+    const uint64_t* _set,
+    unsigned char   _c
+)
+{
+    return (int)((_set[_c >> 6] >> (_c & 63)) & 1);
+}
+
+
+/*
+d_internal_glob_bracket
+  Parses the bracket expression starting at _pattern[_i] ('['). Supports
+ranges ("a-z"), negation ("[!...]" or "[^...]"), a leading ']' taken
+literally and '\' escapes. Bracket expressions never match a separator.
+
+Parameter(s):
+  _pattern: pattern text.
+  _i:       index of the opening '['.
+  _flags:   D_GLOB_* flags.
+  _set:     receives the accepted bytes.
+Return:
+  Index just past the closing ']', or 0 if the bracket is unterminated (the
+'[' is then an ordinary character).
+*/
+static size_t
+d_internal_glob_bracket
+(
+    const char* _pattern,
+    size_t      _i,
+    unsigned    _flags,
+    uint64_t*   _set
+)
+{
+    unsigned char lo;
+    unsigned char hi;
+    unsigned      c;
+    int           negate;
+    int           first;
+
+    _i++;
+    negate = ( (_pattern[_i] == '!') ||
+               (_pattern[_i] == '^') );
+
+    if (negate)
+    {
+        _i++;
+    }
+
+    first = 1;
+
+    while ( (_pattern[_i] != '\0') &&
+            ( (_pattern[_i] != ']') || (first) ) )
+    {
+        if ( (_pattern[_i] == '\\') &&
+             (_pattern[_i + 1] != '\0') )
+        {
+            _i++;
+        }
+
+        lo = (unsigned char)_pattern[_i];
+        hi = lo;
+        _i++;
+
+        if ( (_pattern[_i] == '-') &&
+             (_pattern[_i + 1] != '\0') &&
+             (_pattern[_i + 1] != ']') )
+        {
+            _i++;
+
+            if ( (_pattern[_i] == '\\') &&
+                 (_pattern[_i + 1] != '\0') )
+            {
+                _i++;
+            }
+
+            hi = (unsigned char)_pattern[_i];
+            _i++;
+        }
+
+        for (c = lo; c <= hi; c++)
+        {
+            d_internal_glob_add(_set, (unsigned char)c, _flags);
+        }
+
+        first = 0;
+    }
+
+    if (_pattern[_i] != ']')
+    {
+        memset(_set, 0, 4 * sizeof(uint64_t));
+
+        return 0;
+    }
+
+    if (negate)
+    {
+        for (c = 0; c < 4; c++)
+        {
+            _set[c] = ~_set[c];
+        }
+    }
+
+    for (c = 0; c < 256; c++)
+    {
+        if (d_internal_glob_is_sep((unsigned char)c))
+        {
+            _set[c >> 6] &= ~((uint64_t)1 << (c & 63));
+        }
+    }
+
+    return _i + 1;
+}
+
+
+/*
+d_internal_glob_parse
+  Splits a pattern into byte-consuming tokens and records, for each state
+between them, the self-loop left by `*` or `**`. A `**` forming a whole
+path component matches across separators; followed by '/', its state may
+also skip the '/', so that it can match no component at all. Consecutive
+`**` components are merged. Any other run of stars is a single `*`.
+
+Parameter(s):
+  _pattern: null-terminated pattern.
+  _flags:   D_GLOB_* flags.
+  _out:     receives the tokens; its arrays must hold strlen(_pattern) + 1
+            entries.
+Return:
+  none
+*/
+static void
+d_internal_glob_parse
+(
+    const char*                    _pattern,
+    unsigned                       _flags,
+    struct d_internal_glob_parsed* _out
+)
+{
+    struct d_internal_glob_token* token;
+    size_t                        i;
+    size_t                        run;
+    size_t                        next;
+    size_t                        state;
+    unsigned                      c;
+    int                           component;
+
+    state = 0;
+    i     = 0;
+
+    _out->loops[0] = D_INTERNAL_GLOB_LOOP_NONE;
+    _out->skips[0] = 0;
+
+    while (_pattern[i] != '\0')
+    {
+        if (_pattern[i] == '*')
+        {
+            run = 0;
+
+            while (_pattern[i + run] == '*')
+            {
+                run++;
+            }
+
+            component = ( (run >= 2) &&
+                          ( (i == 0) || (_pattern[i - 1] == '/') ) &&
+                          ( (_pattern[i + run] == '\0') ||
+                            (_pattern[i + run] == '/') ) );
+
+            if (!component)
+            {
+                if (_out->loops[state] == D_INTERNAL_GLOB_LOOP_NONE)
+                {
+                    _out->loops[state] = D_INTERNAL_GLOB_LOOP_NAME;
+                }
+
+                i += run;
+
+                continue;
+            }
+
+            i += run;
+
+            // "**/**/" is the same as "**/"; a trailing "**" is kept, since
+            // the skip before it already lets it match no component
+            if ( (_pattern[i] == '/') &&
+                 ( (_out->loops[state] == D_INTERNAL_GLOB_LOOP_ANY) ||
+                   ( (state > 0) &&
+                     (_out->skips[state - 1]) ) ) )
+            {
+                i += (_pattern[i] == '/');
+
+                continue;
+            }
+
+            _out->loops[state] = D_INTERNAL_GLOB_LOOP_ANY;
+
+            if (_pattern[i] == '\0')
+            {
+                continue;
+            }
+
+            _out->skips[state] = 1;
+        }
+
+        token = &_out->tokens[state];
+        memset(token->set, 0, sizeof(token->set));
+        token->literal = -1;
+        next           = 0;
+
+        if (_pattern[i] == '?')
+        {
+            for (c = 0; c < 256; c++)
+            {
+                if (!d_internal_glob_is_sep((unsigned char)c))
+                {
+                    token->set[c >> 6] |= (uint64_t)1 << (c & 63);
+                }
+            }
+
+            next = i + 1;
+        }
+        else if (_pattern[i] == '[')
+        {
+            next = d_internal_glob_bracket(_pattern, i, _flags, token->set);
+        }
+
+        if (next == 0)
+        {
+            if ( (_pattern[i] == '\\') &&
+                 (_pattern[i + 1] != '\0') )
+            {
+                i++;
+            }
+
+            token->literal = (unsigned char)_pattern[i];
+
+            // a '/' in the pattern matches every separator
+            if (_pattern[i] == '/')
+            {
+                d_internal_glob_add(token->set,
+                                    (unsigned char)D_FILE_PATH_SEP,
+                                    0);
+                d_internal_glob_add(token->set,
+                                    (unsigned char)D_FILE_PATH_SEP_ALT,
+                                    0);
+            }
+
+            d_internal_glob_add(token->set, (unsigned char)_pattern[i], _flags);
+            next = i + 1;
+        }
+
+        i = next;
+        state++;
+        _out->loops[state] = D_INTERNAL_GLOB_LOOP_NONE;
+        _out->skips[state] = 0;
+    }
+
+    _out->count = state;
+}
+
+
+/*
+d_internal_glob_build
+  Compiles parsed patterns into one automaton, the states of pattern k
+following those of pattern k - 1. Since no token leads into a pattern's
+first state, patterns cannot leak into one another. Bytes with identical
+table columns share a class.
+
+Parameter(s):
+  _parsed: parsed patterns.
+  _count:  number of patterns.
+  _flags:  D_GLOB_* flags.
+  _nfa:    automaton to fill in.
+Return:
+  0 on success, -1 if memory allocation failed.
+*/
+static int
+d_internal_glob_build
+(
+    const struct d_internal_glob_parsed* _parsed,
+    size_t                               _count,
+    unsigned                             _flags,
+    struct d_internal_glob_nfa*          _nfa
+)
+{
+    uint64_t* columns;
+    uint64_t* column;
+    uint64_t* table;
+    size_t    states;
+    size_t    words;
+    size_t    width;
+    size_t    base;
+    size_t    classes;
+    size_t    p;
+    size_t    j;
+    size_t    s;
+    unsigned  c;
+    unsigned  k;
+    int       lead;
+
+    states = 0;
+
+    for (p = 0; p < _count; p++)
+    {
+        states += _parsed[p].count + 1;
+    }
+
+    words = (states + 63) / 64;
+    width = 2 * words;
+
+    // one scratch column per byte, plus the leading-period column
+    columns = D_MEMORY_CALLOC(D_MEMORY_MODULE_FILE, 257 * width, sizeof(uint64_t));
+
+    if (!columns)
+    {
+        return -1;
+    }
+
+    for (c = 0; c < 257; c++)
+    {
+        column = columns + (c * width);
+        lead   = (c == 256);
+        base   = 0;
+
+        for (p = 0; p < _count; p++)
+        {
+            for (j = 0; j < _parsed[p].count; j++)
+            {
+                // with D_GLOB_PERIOD a leading '.' needs a literal '.'
+                // that is not preceded by a star ("*.c" skips ".c")
+                if ( (lead)
+                     ? ( (_parsed[p].tokens[j].literal == '.') &&
+                         (_parsed[p].loops[j] == D_INTERNAL_GLOB_LOOP_NONE) )
+                     : d_internal_glob_has(_parsed[p].tokens[j].set,
+                                           (unsigned char)c) )
+                {
+                    s = base + j + 1;
+                    column[s / 64] |= (uint64_t)1 << (s % 64);
+                }
+            }
+
+            for (j = 0; (!lead) && (j <= _parsed[p].count); j++)
+            {
+                if ( (_parsed[p].loops[j] == D_INTERNAL_GLOB_LOOP_ANY) ||
+                     ( (_parsed[p].loops[j] == D_INTERNAL_GLOB_LOOP_NAME) &&
+                       (!d_internal_glob_is_sep((unsigned char)c)) ) )
+                {
+                    s = base + j;
+                    column[words + (s / 64)] |= (uint64_t)1 << (s % 64);
+                }
+            }
+
+            base += _parsed[p].count + 1;
+        }
+    }
+
+    // number the distinct columns; class k's column moves to slot k
+    classes = 0;
+
+    for (c = 0; c < 257; c++)
+    {
+        column = columns + (c * width);
+
+        for (k = 0; k < classes; k++)
+        {
+            if (memcmp(columns + (k * width),
+                       column,
+                       width * sizeof(uint64_t)) == 0)
+            {
+                break;
+            }
+        }
+
+        if (k == classes)
+        {
+            memmove(columns + (k * width), column, width * sizeof(uint64_t));
+            classes++;
+        }
+
+        if (c < 256)
+        {
+            _nfa->classes[c] = (unsigned short)k;
+        }
+        else
+        {
+            _nfa->lead_dot = (unsigned short)k;
+        }
+    }
+
+    table = D_MEMORY_CALLOC(D_MEMORY_MODULE_FILE,
+                            (classes * width) + (3 * words),
+                            sizeof(uint64_t));
+
+    if (!table)
+    {
+        D_MEMORY_FREE(columns);
+
+        return -1;
+    }
+
+    _nfa->shift  = table;
+    _nfa->loop   = table + (classes * words);
+    _nfa->skip   = table + (classes * width);
+    _nfa->start  = _nfa->skip + words;
+    _nfa->accept = _nfa->start + words;
+    _nfa->words  = words;
+    _nfa->flags  = _flags;
+
+    for (k = 0; k < classes; k++)
+    {
+        memcpy(_nfa->shift + (k * words),
+               columns + (k * width),
+               words * sizeof(uint64_t));
+        memcpy(_nfa->loop + (k * words),
+               columns + (k * width) + words,
+               words * sizeof(uint64_t));
+    }
+
+    D_MEMORY_FREE(columns);
+
+    base = 0;
+
+    for (p = 0; p < _count; p++)
+    {
+        for (j = 0; j <= _parsed[p].count; j++)
+        {
+            if (_parsed[p].skips[j])
+            {
+                s = base + j;
+                _nfa->skip[s / 64] |= (uint64_t)1 << (s % 64);
+            }
+        }
+
+        s = base;
+        _nfa->start[s / 64] |= (uint64_t)1 << (s % 64);
+
+        // a leading "**/" may match nothing at all
+        if (_parsed[p].skips[0])
+        {
+            s = base + 1;
+            _nfa->start[s / 64] |= (uint64_t)1 << (s % 64);
+        }
+
+        s = base + _parsed[p].count;
+        _nfa->accept[s / 64] |= (uint64_t)1 << (s % 64);
+
+        base += _parsed[p].count + 1;
+    }
+
+    return 0;
+}
+
+
+/*
+d_internal_glob_run
+  Runs an automaton over _path[0.._length) from the states in _state,
+leaving the final states there. Each byte costs a few word operations per
+64 states, whatever the pattern, so matching is linear in the path length
+and never backtracks.
+
+Parameter(s):
+  _nfa:    automaton.
+  _path:   bytes to consume.
+  _length: number of bytes.
+  _lead:   nonzero if _path[0] starts a path component.
+  _state:  state vector of _nfa->words words.
+Return:
+  Nonzero if any state is still active.
+*/
+static int
+d_internal_glob_run
+(
+    const struct d_internal_glob_nfa* _nfa,
+    const unsigned char*              _path,
+    size_t                            _length,
+    int                               _lead,
+    uint64_t*                         _state
+)
+{
+    const uint64_t* shift;
+    const uint64_t* loop;
+    uint64_t        d;
+    uint64_t        moved;
+    uint64_t        next;
+    uint64_t        carry;
+    uint64_t        skip_carry;
+    uint64_t        live;
+    size_t          words;
+    size_t          cls;
+    size_t          i;
+    size_t          w;
+    int             period;
+
+    words  = _nfa->words;
+    period = (_nfa->flags & D_GLOB_PERIOD) != 0;
+
+    // up to 64 states fit in one word: no carries between words
+    if (words == 1)
+    {
+        d = _state[0];
+
+        for (i = 0; (i < _length) && (d); i++)
+        {
+            cls = ( (period) && (_lead) && (_path[i] == '.') )
+                  ? _nfa->lead_dot
+                  : _nfa->classes[_path[i]];
+            _lead = d_internal_glob_is_sep(_path[i]);
+            moved = (d << 1) & _nfa->shift[cls];
+            d     = moved | (d & _nfa->loop[cls]) |
+                    ((moved & _nfa->skip[0]) << 1);
+        }
+
+        _state[0] = d;
+
+        return (d != 0);
+    }
+
+    live = 1;
+
+    for (i = 0; (i < _length) && (live); i++)
+    {
+        cls = ( (period) && (_lead) && (_path[i] == '.') )
+              ? _nfa->lead_dot
+              : _nfa->classes[_path[i]];
+        _lead = d_internal_glob_is_sep(_path[i]);
+        shift = _nfa->shift + (cls * words);
+        loop  = _nfa->loop + (cls * words);
+
+        carry      = 0;
+        skip_carry = 0;
+        live       = 0;
+
+        for (w = 0; w < words; w++)
+        {
+            d          = _state[w];
+            moved      = ((d << 1) | carry) & shift[w];
+            carry      = d >> 63;
+            next       = moved | (d & loop[w]) |
+                         ((moved & _nfa->skip[w]) << 1) | skip_carry;
+            skip_carry = (moved & _nfa->skip[w]) >> 63;
+            _state[w]  = next;
+            live      |= next;
+        }
+    }
+
+    return (live != 0);
+}
+
+
+/*
+d_internal_glob_alloc_state
+  Returns a state vector for _nfa: _stack if it is large enough, else a new
+allocation the caller must free.
+*/
+static uint64_t*
+d_internal_glob_alloc_state
+(
+    const struct d_internal_glob_nfa* _nfa,
+    uint64_t*                         _stack
+)
+{
+    if (_nfa->words <= D_INTERNAL_GLOB_STACK_WORDS)
+    {
+        return _stack;
+    }
+
+    return D_MEMORY_ALLOC(D_MEMORY_MODULE_FILE,
+                          _nfa->words * sizeof(uint64_t));
+}
+
+
+/*
+d_internal_glob_parse_all
+  Parses _count patterns into _parsed, allocating each pattern's token and
+state arrays in one block. On failure the blocks already allocated are
+freed.
+
+Return:
+  0 on success, -1 if memory allocation failed.
+*/
+static int
+d_internal_glob_parse_all
+(
+    const char* const*             _patterns,
+    size_t                         _count,
+    unsigned                       _flags,
+    struct d_internal_glob_parsed* _parsed
+)
+{
+    size_t length;
+    size_t p;
+    char*  block;
+
+    for (p = 0; p < _count; p++)
+    {
+        length = strlen(_patterns[p]) + 1;
+        block  = D_MEMORY_ALLOC(D_MEMORY_MODULE_FILE,
+                                length * (sizeof(struct d_internal_glob_token) + 2));
+
+        if (!block)
+        {
+            while (p > 0)
+            {
+                D_MEMORY_FREE(_parsed[--p].tokens);
+            }
+
+            return -1;
+        }
+
+        _parsed[p].tokens = (struct d_internal_glob_token*)block;
+        _parsed[p].loops  = (unsigned char*)(block +
+                            (length * sizeof(struct d_internal_glob_token)));
+        _parsed[p].skips  = _parsed[p].loops + length;
+
+        d_internal_glob_parse(_patterns[p], _flags, &_parsed[p]);
+    }
+
+    return 0;
+}
+
+
+/*
+d_glob_compile
+  Compiles a glob pattern for repeated matching against paths or names.
+Supported syntax:
+  `*`       any run of bytes within one path component
+  `**`      when it forms a whole path component, any number of
+            components, including none; a component of three or more
+            stars ("***") acts as `**`. A trailing "/**" still needs the
+            separator, so "src/**" matches "src/" and everything below
+            it but not "src" itself, and neither "a/**" nor "**/a/**"
+            matches "a" (as in .gitignore)
+  `?`       any one byte but a separator
+  `[...]`   one byte from a set: "[abc]", ranges "[a-z]", negated "[!a-z]"
+            or "[^a-z]"; never matches a separator
+  `\`       takes the next byte literally
+Separators are written '/' in patterns and match '/' (and '\' on Windows)
+in paths. Matching runs a bit-parallel automaton in time linear in the
+path length, so patterns with many stars cannot cause exponential
+backtracking. Literal text at the start and end of the pattern ("src/",
+".c") is compared directly before the automaton runs.
+
+Parameter(s):
+  _pattern: null-terminated glob pattern.
+  _flags:   0, or a combination of D_GLOB_NOCASE (ASCII letters match
+            either case) and D_GLOB_PERIOD (a '.' starting a component is
+            only matched by a '.' starting a pattern component, hiding
+            dot-files from wildcards).
+Return:
+  A compiled pattern to release with d_glob_free, or NULL with errno set to
+EINVAL if _pattern was NULL or ENOMEM if memory allocation failed.
+*/
+struct d_glob_pattern*
+d_glob_compile
+(
+    const char* _pattern,
+    unsigned    _flags
+)
+{
+    struct d_glob_pattern*        glob;
+    struct d_internal_glob_parsed parsed;
+    size_t                        prefix;
+    size_t                        suffix;
+    size_t                        j;
+    int                           wild;
+
+    // parameter validation
+    if (!_pattern)
+    {
+        errno = EINVAL;
+
+        return NULL;
+    }
+
+    glob = D_MEMORY_CALLOC(D_MEMORY_MODULE_FILE, 1, sizeof(struct d_glob_pattern));
+
+    if ( (!glob) ||
+         (d_internal_glob_parse_all(&_pattern, 1, _flags, &parsed) != 0) )
+    {
+        D_MEMORY_FREE(glob);
+        errno = ENOMEM;
+
+        return NULL;
+    }
+
+    // literal runs usable as fast paths (compared bytewise, so not NOCASE)
+    prefix = 0;
+    suffix = 0;
+
+    if (!(_flags & D_GLOB_NOCASE))
+    {
+        while ( (prefix < parsed.count) &&
+                (parsed.loops[prefix] == D_INTERNAL_GLOB_LOOP_NONE) &&
+                (parsed.tokens[prefix].literal >= 0) &&
+                (parsed.tokens[prefix].literal != '/') )
+        {
+            prefix++;
+        }
+
+        // a '.' may need the automaton to tell if it starts a name
+        while ( (suffix < parsed.count - prefix) &&
+                (parsed.loops[parsed.count - suffix] ==
+                     D_INTERNAL_GLOB_LOOP_NONE) &&
+                (!parsed.skips[parsed.count - suffix]) &&
+                (parsed.tokens[parsed.count - suffix - 1].literal >= 0) &&
+                (parsed.tokens[parsed.count - suffix - 1].literal != '/') &&
+                ( (!(_flags & D_GLOB_PERIOD)) ||
+                  (parsed.tokens[parsed.count - suffix - 1].literal != '.') ) )
+        {
+            suffix++;
+        }
+    }
+
+    wild           = 0;
+    glob->shortest = parsed.count;
+
+    for (j = 0; j <= parsed.count; j++)
+    {
+        wild           |= (parsed.loops[j] != D_INTERNAL_GLOB_LOOP_NONE);
+        glob->shortest -= parsed.skips[j];
+    }
+
+    glob->tokens  = parsed.count;
+    glob->prefix  = prefix;
+    glob->suffix  = suffix;
+    glob->pure    = ( (!wild) && (prefix == parsed.count) );
+    glob->literal = D_MEMORY_ALLOC(D_MEMORY_MODULE_FILE, prefix + suffix + 1);
+
+    if ( (!glob->literal) ||
+         (d_internal_glob_build(&parsed, 1, _flags, &glob->nfa) != 0) )
+    {
+        D_MEMORY_FREE(parsed.tokens);
+        D_MEMORY_FREE(glob->literal);
+        D_MEMORY_FREE(glob);
+        errno = ENOMEM;
+
+        return NULL;
+    }
+
+    for (j = 0; j < prefix; j++)
+    {
+        glob->literal[j] = (char)parsed.tokens[j].literal;
+    }
+
+    for (j = 0; j < suffix; j++)
+    {
+        glob->literal[prefix + j] =
+            (char)parsed.tokens[parsed.count - suffix + j].literal;
+    }
+
+    D_MEMORY_FREE(parsed.tokens);
+
+    return glob;
+}
+
+
+/*
+d_glob_free
+  Releases a pattern compiled by d_glob_compile.
+
+Parameter(s):
+  _glob: compiled pattern; may be NULL.
+Return:
+  none
+*/
+void
+d_glob_free
+(
+    struct d_glob_pattern* _glob
+)
+{
+    if (!_glob)
+    {
+        return;
+    }
+
+    D_MEMORY_FREE(_glob->nfa.shift);
+    D_MEMORY_FREE(_glob->literal);
+    D_MEMORY_FREE(_glob);
+}
+
+
+/*
+d_glob_match_n
+  Tests whether the first _length bytes of _path match a compiled pattern.
+The whole path must match. Useful for d_string text or path slices that
+are not null-terminated.
+
+Parameter(s):
+  _glob:   compiled pattern.
+  _path:   path or name to test.
+  _length: number of bytes of _path to test.
+Return:
+  1 if the path matches, 0 if it does not, or -1 if a parameter was NULL
+(errno EINVAL) or memory allocation failed (errno ENOMEM).
+*/
+int
+d_glob_match_n
+(
+    const struct d_glob_pattern* _glob,
+    const char*                  _path,
+    size_t                       _length
+)
+{
+    const unsigned char* path;
+    uint64_t             stack[D_INTERNAL_GLOB_STACK_WORDS];
+    uint64_t*            state;
+    size_t               middle;
+    size_t               s;
+    int                  result;
+
+    // parameter validation
+    if ( (!_glob) ||
+         ( (!_path) && (_length > 0) ) )
+    {
+        errno = EINVAL;
+
+        return -1;
+    }
+
+    path = (const unsigned char*)_path;
+
+    // every token but a skipped '/' consumes exactly one byte
+    if ( (_length < _glob->shortest) ||
+         ( (_glob->pure) && (_length != _glob->tokens) ) )
+    {
+        return 0;
+    }
+
+    if ( (memcmp(path, _glob->literal, _glob->prefix) != 0) ||
+         (memcmp(path + _length - _glob->suffix,
+                 _glob->literal + _glob->prefix,
+                 _glob->suffix) != 0) )
+    {
+        return 0;
+    }
+
+    if (_glob->pure)
+    {
+        return 1;
+    }
+
+    state = d_internal_glob_alloc_state(&_glob->nfa, stack);
+
+    if (!state)
+    {
+        errno = ENOMEM;
+
+        return -1;
+    }
+
+    // start just after the literal prefix, as if it had been consumed
+    memset(state, 0, _glob->nfa.words * sizeof(uint64_t));
+    s = _glob->prefix;
+    state[s / 64] |= (uint64_t)1 << (s % 64);
+
+    if ((_glob->nfa.skip[s / 64] >> (s % 64)) & 1)
+    {
+        s++;
+        state[s / 64] |= (uint64_t)1 << (s % 64);
+    }
+
+    // the suffix is literal, so it must start from its own first state
+    middle = _length - _glob->prefix - _glob->suffix;
+    s      = _glob->tokens - _glob->suffix;
+    result = d_internal_glob_run(&_glob->nfa,
+                                 path + _glob->prefix,
+                                 middle,
+                                 (_glob->prefix == 0) ||
+                                 d_internal_glob_is_sep(path[_glob->prefix - 1]),
+                                 state) &&
+             ((state[s / 64] >> (s % 64)) & 1);
+
+    if (state != stack)
+    {
+        D_MEMORY_FREE(state);
+    }
+
+    return result;
+}
+
+
+/*
+d_glob_match
+  Tests whether a null-terminated path or name matches a compiled pattern
+(see d_glob_match_n).
+
+Parameter(s):
+  _glob: compiled pattern.
+  _path: null-terminated path or name to test.
+Return:
+  1 if the path matches, 0 if it does not, or -1 on error.
+*/
+int
+d_glob_match
+(
+    const struct d_glob_pattern* _glob,
+    const char*                  _path
+)
+{
+    // parameter validation
+    if (!_path)
+    {
+        errno = EINVAL;
+
+        return -1;
+    }
+
+    return d_glob_match_n(_glob, _path, strlen(_path));
+}
+
+
+/*
+d_glob_set_new
+  Compiles several glob patterns (same syntax as d_glob_compile) into one
+set, so that a path is tested against all of them in a single pass over
+its bytes instead of once per pattern.
+
+Parameter(s):
+  _patterns: array of null-terminated glob patterns.
+  _count:    number of patterns.
+  _flags:    D_GLOB_* flags applied to every pattern.
+Return:
+  A compiled set to release with d_glob_set_free, or NULL with errno set to
+EINVAL if _patterns or one of its entries was NULL, or ENOMEM if memory
+allocation failed.
+*/
+struct d_glob_set*
+d_glob_set_new
+(
+    const char* const* _patterns,
+    size_t             _count,
+    unsigned           _flags
+)
+{
+    struct d_glob_set*             set;
+    struct d_internal_glob_parsed* parsed;
+    size_t                         base;
+    size_t                         p;
+
+    // parameter validation
+    if ( (!_patterns) &&
+         (_count > 0) )
+    {
+        errno = EINVAL;
+
+        return NULL;
+    }
+
+    for (p = 0; p < _count; p++)
+    {
+        if (!_patterns[p])
+        {
+            errno = EINVAL;
+
+            return NULL;
+        }
+    }
+
+    set    = D_MEMORY_CALLOC(D_MEMORY_MODULE_FILE, 1, sizeof(struct d_glob_set));
+    parsed = D_MEMORY_ALLOC(D_MEMORY_MODULE_FILE,
+                            (_count + 1) * sizeof(struct d_internal_glob_parsed));
+
+    if ( (!set) ||
+         (!parsed) )
+    {
+        D_MEMORY_FREE(set);
+        D_MEMORY_FREE(parsed);
+        errno = ENOMEM;
+
+        return NULL;
+    }
+
+    set->count  = _count;
+    set->finals = D_MEMORY_ALLOC(D_MEMORY_MODULE_FILE,
+                                 (_count + 1) * sizeof(size_t));
+
+    if ( (!set->finals) ||
+         (d_internal_glob_parse_all(_patterns, _count, _flags, parsed) != 0) )
+    {
+        D_MEMORY_FREE(set->finals);
+        D_MEMORY_FREE(set);
+        D_MEMORY_FREE(parsed);
+        errno = ENOMEM;
+
+        return NULL;
+    }
+
+    base = 0;
+
+    for (p = 0; p < _count; p++)
+    {
+        base           += parsed[p].count;
+        set->finals[p]  = base;
+        base++;
+    }
+
+    if (d_internal_glob_build(parsed, _count, _flags, &set->nfa) != 0)
+    {
+        D_MEMORY_FREE(set->finals);
+        D_MEMORY_FREE(set);
+        set = NULL;
+        errno = ENOMEM;
+    }
+
+    for (p = 0; p < _count; p++)
+    {
+        D_MEMORY_FREE(parsed[p].tokens);
+    }
+
+    D_MEMORY_FREE(parsed);
+
+    return set;
+}
+
+
+/*
+d_glob_set_free
+  Releases a set compiled by d_glob_set_new.
+
+Parameter(s):
+  _set: compiled set; may be NULL.
+Return:
+  none
+*/
+void
+d_glob_set_free
+(
+    struct d_glob_set* _set
+)
+{
+    if (!_set)
+    {
+        return;
+    }
+
+    D_MEMORY_FREE(_set->nfa.shift);
+    D_MEMORY_FREE(_set->finals);
+    D_MEMORY_FREE(_set);
+}
+
+
+/*
+d_glob_set_match_n
+  Tests the first _length bytes of _path against every pattern of a set at
+once.
+
+Parameter(s):
+  _set:    compiled set.
+  _path:   path or name to test.
+  _length: number of bytes of _path to test.
+Return:
+  The index of the first pattern (in the order given to d_glob_set_new)
+that matches, -1 if none does, or -1 with errno set to EINVAL if a
+parameter was NULL or ENOMEM if memory allocation failed.
+*/
+ssize_t
+d_glob_set_match_n
+(
+    const struct d_glob_set* _set,
+    const char*              _path,
+    size_t                   _length
+)
+{
+    uint64_t  stack[D_INTERNAL_GLOB_STACK_WORDS];
+    uint64_t* state;
+    uint64_t  hits;
+    size_t    bit;
+    size_t    lo;
+    size_t    hi;
+    size_t    mid;
+    size_t    w;
+    ssize_t   result;
+
+    // parameter validation
+    if ( (!_set) ||
+         ( (!_path) && (_length > 0) ) )
+    {
+        errno = EINVAL;
+
+        return -1;
+    }
+
+    if (_set->count == 0)
+    {
+        return -1;
+    }
+
+    state = d_internal_glob_alloc_state(&_set->nfa, stack);
+
+    if (!state)
+    {
+        errno = ENOMEM;
+
+        return -1;
+    }
+
+    memcpy(state, _set->nfa.start, _set->nfa.words * sizeof(uint64_t));
+
+    result = -1;
+
+    if (d_internal_glob_run(&_set->nfa,
+                            (const unsigned char*)_path,
+                            _length,
+                            1,
+                            state))
+    {
+        for (w = 0; w < _set->nfa.words; w++)
+        {
+            hits = state[w] & _set->nfa.accept[w];
+
+            if (hits)
+            {
+                bit = w * 64;
+
+                while (!(hits & 1))
+                {
+                    hits >>= 1;
+                    bit++;
+                }
+
+                // the pattern whose final state is the first at or after bit
+                lo = 0;
+                hi = _set->count - 1;
+
+                while (lo < hi)
+                {
+                    mid = lo + ((hi - lo) / 2);
+
+                    if (_set->finals[mid] < bit)
+                    {
+                        lo = mid + 1;
+                    }
+                    else
+                    {
+                        hi = mid;
+                    }
+                }
+
+                result = (ssize_t)lo;
+
+                break;
+            }
+        }
+    }
+
+    if (state != stack)
+    {
+        D_MEMORY_FREE(state);
+    }
+
+    return result;
+}
+
+
+/*
+d_glob_set_match
+  Tests a null-terminated path against every pattern of a set at once (see
+d_glob_set_match_n).
+
+Parameter(s):
+  _set:  compiled set.
+  _path: null-terminated path or name to test.
+Return:
+  The index of the first matching pattern, or -1 if none matches or on
+error.
+*/
+ssize_t
+d_glob_set_match
+(
+    const struct d_glob_set* _set,
+    const char*              _path
+)
+{
+    // parameter validation
+    if (!_path)
+    {
+        errno = EINVAL;
+
+        return -1;
+    }
+
+    return d_glob_set_match_n(_set, _path, strlen(_path));
+}
+
+
+/*
+d_readdir_glob
+  Reads the next directory entry whose name matches a compiled pattern,
+skipping the others. Only the entry name is matched, not its full path.
+Combine with D_GLOB_PERIOD to skip "." and ".." and hidden files.
+
+Parameter(s):
+  _dir:  directory handle.
+  _glob: compiled pattern.
+Return:
+  Pointer to the next matching entry, or NULL at the end of the directory or
+on error.
+*/
+struct d_dirent_t*
+d_readdir_glob
+(
+    struct d_dir_t*              _dir,
+    const struct d_glob_pattern* _glob
+)
+{
+    struct d_dirent_t* entry;
+
+    // parameter validation
+    if ( (!_dir) ||
+         (!_glob) )
+    {
+        errno = EINVAL;
+
+        return NULL;
+    }
+
+    while ((entry = d_readdir(_dir)) != NULL)
+    {
+        if (d_glob_match(_glob, entry->d_name) == 1)
+        {
+            return entry;
+        }
+    }
+
+    return NULL;
+}
+
+
+/*
+d_readdir_glob_set
+  Reads the next directory entry whose name matches any pattern of a set.
+
+Parameter(s):
+  _dir:   directory handle.
+  _set:   compiled set.
+  _index: receives the index of the first matching pattern; may be NULL.
+Return:
+  Pointer to the next matching entry, or NULL at the end of the directory or
+on error.
+*/
+struct d_dirent_t*
+d_readdir_glob_set
+(
+    struct d_dir_t*          _dir,
+    const struct d_glob_set* _set,
+    size_t*                  _index
+)
+{
+    struct d_dirent_t* entry;
+    ssize_t            index;
+
+    // parameter validation
+    if ( (!_dir) ||
+         (!_set) )
+    {
+        errno = EINVAL;
+
+        return NULL;
+    }
+
+    while ((entry = d_readdir(_dir)) != NULL)
+    {
+        index = d_glob_set_match(_set, entry->d_name);
+
+        if (index >= 0)
+        {
+            if (_index)
+            {
+                *_index = (size_t)index;
+            }
+
+            return entry;
+        }
+    }
+
+    return NULL;
+}
@@ -8,6 +8,7 @@
 * author(s): Samuel 'teer' Neal-Blim                          date: 2025.02.06
 ******************************************************************************/
 #include "..\inc\dmutex.h"
+#include "..\inc\dmemory.h"
 
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -540,7 +541,7 @@ d_pthread_wrapper
     d_pthread_wrapper_arg_t* wrapper = (d_pthread_wrapper_arg_t*)_arg;
     d_thread_func_t func = wrapper->func;
     void* arg = wrapper->arg;
-    free(wrapper);
+    D_MEMORY_FREE(wrapper);
     return func(arg);
 }
 
@@ -553,7 +554,8 @@ d_thread_create
 )
 {
     d_pthread_wrapper_arg_t* wrapper = 
-        (d_pthread_wrapper_arg_t*)malloc(sizeof(d_pthread_wrapper_arg_t));
+        (d_pthread_wrapper_arg_t*)D_MEMORY_ALLOC(D_MEMORY_MODULE_MUTEX,
+                                                 sizeof(d_pthread_wrapper_arg_t));
     if (wrapper == NULL)
         return D_MUTEX_NOMEM;
     
@@ -563,7 +565,7 @@ d_thread_create
     int result = pthread_create(_thread, NULL, d_pthread_wrapper, wrapper);
     if (result != 0)
     {
-        free(wrapper);
+        D_MEMORY_FREE(wrapper);
         return D_MUTEX_ERROR;
     }
     return D_MUTEX_SUCCESS;
@@ -661,7 +663,7 @@ d_win_thread_wrapper
     d_win_thread_wrapper_arg_t* wrapper = (d_win_thread_wrapper_arg_t*)_arg;
     d_thread_func_t func = wrapper->func;
     void* arg = wrapper->arg;
-    free(wrapper);
+    D_MEMORY_FREE(wrapper);
     
     void* result = func(arg);
     return (unsigned int)(uintptr_t)result;
@@ -676,7 +678,8 @@ d_thread_create
 )
 {
     d_win_thread_wrapper_arg_t* wrapper = 
-        (d_win_thread_wrapper_arg_t*)malloc(sizeof(d_win_thread_wrapper_arg_t));
+        (d_win_thread_wrapper_arg_t*)D_MEMORY_ALLOC(D_MEMORY_MODULE_MUTEX,
+                                                    sizeof(d_win_thread_wrapper_arg_t));
     if (wrapper == NULL)
         return D_MUTEX_NOMEM;
     
@@ -688,7 +691,7 @@ d_thread_create
     
     if (_thread->handle == NULL)
     {
-        free(wrapper);
+        D_MEMORY_FREE(wrapper);
         return D_MUTEX_ERROR;
     }
     return D_MUTEX_SUCCESS;
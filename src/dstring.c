@@ -9,5163 +9,18402 @@
 ******************************************************************************/
 
 #include "..\inc\dstring.h"
+#include "..\inc\dfile.h"
+#include "..\inc\dmutex.h"
 #include "..\inc\string_fn.h"
+#include <float.h>
+#include <limits.h>
+#include <math.h>
 #include <stdio.h>
+#include <time.h>
+#include <wchar.h>
+
+#if defined(__AVX2__)
+    #include <immintrin.h>
+#elif ( defined(__SSE2__) || defined(_M_X64) ||                   \
+        (defined(_M_IX86_FP) && (_M_IX86_FP >= 2)) )
+    #include <emmintrin.h>
+#elif ( defined(__ARM_NEON) || defined(__ARM_NEON__) )
+    #include <arm_neon.h>
+#endif
+
+#if ( !defined(__AVX2__)                          &&             \
+      (defined(__x86_64__) || defined(__i386__))   &&             \
+      (defined(__GNUC__) || defined(__clang__)) )
+    // AVX2 kernels built for run-time dispatch
+    #include <immintrin.h>
+#endif
+
+#if defined(_MSC_VER)
+    #include <intrin.h>
+#endif
 
 
 /******************************************************************************
 * Internal Helper Functions
 ******************************************************************************/
 
+// d_string_internal_shared
+//   struct: header of every heap text buffer allocated for a d_string; the
+// text follows it directly. Copies of a long string share one buffer, which
+// the last d_string to release it frees.
+struct d_string_internal_shared
+{
+    d_atomic_size_t refs;  // number of d_strings using the buffer
+};
+
+// D_STRING_INTERNAL_SHARED
+//   macro: the header of the counted buffer holding `text`.
+#define D_STRING_INTERNAL_SHARED(text)  \
+    (((struct d_string_internal_shared*)(void*)(text)) - 1)
+
+// D_STRING_INTERNAL_SITE
+//   macro: the `_file, _line` arguments taken by the helpers below that
+// allocate on behalf of a public function, so that D_MEMORY_STATS charges
+// the allocation to the line in that function rather than to the helper.
+#define D_STRING_INTERNAL_SITE  __FILE__, __LINE__
+
+// d_string_internal_allocated
+//   struct: the allocation made for an allocator-backed d_string (see
+// D_STRING_FLAG_ALLOCATOR), which records the allocator its text comes from.
+struct d_string_internal_allocated
+{
+    const struct d_allocator* allocator; // source of the struct and its text
+    struct d_string           string;    // the d_string handed to the caller
+};
+
+// D_STRING_INTERNAL_ALLOCATOR
+//   macro: the allocator an allocator-backed d_string was allocated from.
+#define D_STRING_INTERNAL_ALLOCATOR(str)                                    \
+    (((struct d_string_internal_allocated*)(void*)((char*)(str) -           \
+        offsetof(struct d_string_internal_allocated, string)))->allocator)
+
 /*
-d_string_internal_grow
-  Ensures the d_string has at least the required capacity, growing if needed.
+d_string_internal_buffer_new
+  Allocates a counted text buffer of `_capacity` bytes with one reference.
+Returns a pointer to its text, or NULL if allocation fails.
 */
-static bool
-d_string_internal_grow
+static char*
+d_string_internal_buffer_new
 (
-    struct d_string* _str,
-    size_t           _required
+    size_t      _capacity,
+    const char* _file,
+    int         _line
 )
 {
-    size_t new_capacity;
-    char*  new_text;
-
-    if (_str == NULL)
-    {
-        return false;
-    }
+    struct d_string_internal_shared* shared;
 
-    // check if we already have enough capacity
-    if (_str->capacity >= _required)
+    if (_capacity > (SIZE_MAX - sizeof(struct d_string_internal_shared)))
     {
-        return true;
+        return NULL;
     }
 
-    // calculate new capacity using growth factor
-    new_capacity = _str->capacity;
+    shared = (struct d_string_internal_shared*)D_MEMORY_ALLOC_AT(
+                 D_MEMORY_MODULE_STRING,
+                 _file,
+                 _line,
+                 sizeof(struct d_string_internal_shared) + _capacity);
 
-    if (new_capacity == 0)
+    if (shared == NULL)
     {
-        new_capacity = 16;
+        return NULL;
     }
 
-    while (new_capacity < _required)
-    {
-        new_capacity *= 2;
-    }
+    d_atomic_init_size(&shared->refs, 1);
 
-    // allocate new buffer
-    new_text = (char*)malloc(new_capacity);
+    return (char*)(shared + 1);
+}
 
-    if (new_text == NULL)
-    {
-        return false;
-    }
+/*
+d_string_internal_buffer_resize
+  Resizes the counted text buffer holding `_text`, which must have no other
+reference, to `_capacity` bytes. Returns a pointer to the (possibly moved)
+text, or NULL if reallocation fails, in which case `_text` is untouched.
+*/
+static char*
+d_string_internal_buffer_resize
+(
+    char*       _text,
+    size_t      _capacity,
+    const char* _file,
+    int         _line
+)
+{
+    struct d_string_internal_shared* shared;
 
-    // copy existing content if present
-    if ( (_str->text != NULL) && 
-         (_str->size > 0) )
-    {
-        d_memcpy(new_text, _str->text, _str->size + 1);
-    }
-    else
+    if (_capacity > (SIZE_MAX - sizeof(struct d_string_internal_shared)))
     {
-        new_text[0] = '\0';
+        return NULL;
     }
 
-    // free old buffer and update
-    free(_str->text);
-    _str->text     = new_text;
-    _str->capacity = new_capacity;
+    shared = (struct d_string_internal_shared*)D_MEMORY_REALLOC_AT(
+                 D_MEMORY_MODULE_STRING,
+                 _file,
+                 _line,
+                 D_STRING_INTERNAL_SHARED(_text),
+                 sizeof(struct d_string_internal_shared) + _capacity);
 
-    return true;
+    return (shared != NULL) ? (char*)(shared + 1) : NULL;
 }
 
-/******************************************************************************
-* Creation and Destruction Functions
-******************************************************************************/
-
 /*
-d_string_new
-  Creates an empty d_string with default capacity.
-
-Parameter(s):
-  (none)
-Return:
-  A pointer value corresponding to either:
-  - newly allocated d_string, if successful, or
-  - NULL, if memory allocation failed.
+d_string_internal_is_counted
+  Returns true if the d_string's text lives in a counted heap buffer.
 */
-struct d_string*
-d_string_new
+static D_INLINE bool
+d_string_internal_is_counted
 (
-    void
+    const struct d_string* _str
 )
 {
-    return d_string_new_with_capacity(16);
+    return ( (_str->flags & D_STRING_FLAG_COUNTED) &&
+             (_str->text != NULL)                  &&
+             (!D_STRING_IS_INLINE(_str)) );
 }
 
 /*
-d_string_new_with_capacity
-  Creates an empty d_string with specified initial capacity.
+d_string_internal_is_shared
+  Returns true if another d_string currently shares this d_string's buffer.
+The acquire load pairs with the release in `d_string_internal_release`, so a
+string that finds itself the only owner sees every access made through the
+references that have since been dropped.
+*/
+static D_INLINE bool
+d_string_internal_is_shared
+(
+    const struct d_string* _str
+)
+{
+    return ( d_string_internal_is_counted(_str) &&
+             (d_atomic_load_size_explicit(
+                  &D_STRING_INTERNAL_SHARED(_str->text)->refs,
+                  D_MEMORY_ORDER_ACQUIRE) > 1) );
+}
 
-Parameter(s):
-  _capacity: initial capacity in bytes (including space for null terminator).
-Return:
-  A pointer value corresponding to either:
-  - newly allocated d_string, if successful, or
-  - NULL, if memory allocation failed.
+/*
+d_string_internal_release
+  Releases the d_string's text buffer if it was heap-allocated, freeing it
+once no other d_string shares it. Inline buffers are part of the struct and
+are left untouched; buffers of allocator-backed strings return to their
+allocator.
 */
-struct d_string*
-d_string_new_with_capacity
+static void
+d_string_internal_release
 (
-    size_t _capacity
+    struct d_string* _str
 )
 {
-    struct d_string* str;
+    struct d_string_internal_shared* shared;
 
-    // ensure minimum capacity of 1 for null terminator
-    if (_capacity == 0)
+    if ( (_str->text == NULL) ||
+         (D_STRING_IS_INLINE(_str)) )
     {
-        _capacity = 1;
+        return;
     }
 
-    str = (struct d_string*)malloc(sizeof(struct d_string));
-
-    if (str == NULL)
+    if (_str->flags & D_STRING_FLAG_ALLOCATOR)
     {
-        return NULL;
-    }
+        d_allocator_free(D_STRING_INTERNAL_ALLOCATOR(_str),
+                         _str->text,
+                         _str->capacity);
 
-    str->text = (char*)malloc(_capacity);
+        return;
+    }
 
-    if (str->text == NULL)
+    if (!(_str->flags & D_STRING_FLAG_COUNTED))
     {
-        free(str);
+        free(_str->text);
 
-        return NULL;
+        return;
     }
 
-    str->text[0] = '\0';
-    str->size    = 0;
+    shared = D_STRING_INTERNAL_SHARED(_str->text);
 
-    str->capacity = _capacity;
-#endif
+    if (d_atomic_fetch_sub_size_explicit(&shared->refs,
+                                         1,
+                                         D_MEMORY_ORDER_ACQ_REL) == 1)
+    {
+        D_MEMORY_FREE(shared);
+    }
 
-    return str;
+    return;
 }
 
 /*
-d_string_new_from_cstr
-  Creates a d_string from a null-terminated C string.
-
-Parameter(s):
-  _cstr: null-terminated source string to copy.
-Return:
-  A pointer value corresponding to either:
-  - newly allocated d_string containing copy of _cstr, if successful, or
-  - NULL, if _cstr was NULL or memory allocation failed.
+d_string_internal_init
+  Initializes a d_string header to an empty string in inline mode.
 */
-struct d_string*
-d_string_new_from_cstr
+static void
+d_string_internal_init
 (
-    const char* _cstr
+    struct d_string* _str
 )
 {
-    size_t           len;
-    size_t           capacity;
-    struct d_string* str;
-
-    if (_cstr == NULL)
-    {
-        return NULL;
-    }
+    _str->sso[0]   = '\0';
+    _str->text     = _str->sso;
+    _str->size     = 0;
+    _str->capacity = D_STRING_SSO_CAPACITY;
+    _str->flags    = 0;
+    _str->hash     = 0;
 
-    len      = strlen(_cstr);
-    capacity = len + 1;
+    return;
+}
 
-    str = d_string_new_with_capacity(capacity);
+/*
+d_string_internal_can_share
+  Returns true if copies of `_str` should share its buffer rather than
+duplicate it (see D_STRING_SHARE_THRESHOLD).
+*/
+static D_INLINE bool
+d_string_internal_can_share
+(
+    const struct d_string* _str
+)
+{
+    return ( (D_STRING_SHARE_THRESHOLD != 0)          &&
+             (_str->size >= D_STRING_SHARE_THRESHOLD) &&
+             d_string_internal_is_counted(_str) );
+}
 
-    if (str == NULL)
-    {
-        return NULL;
-    }
+/*
+d_string_internal_share
+  Makes `_dst`, whose own buffer must already have been released, refer to
+`_src`'s counted buffer. The cached hash is carried over, since the contents
+are identical. Taking a reference needs no ordering of its own: `_src`
+already holds one, so the buffer cannot be freed meanwhile.
+*/
+static void
+d_string_internal_share
+(
+    struct d_string*       _dst,
+    const struct d_string* _src
+)
+{
+    d_atomic_fetch_add_size_explicit(&D_STRING_INTERNAL_SHARED(_src->text)->refs,
+                                     1,
+                                     D_MEMORY_ORDER_RELAXED);
 
-    d_memcpy(str->text, _cstr, len + 1);
-    str->size = len;
+    _dst->text     = _src->text;
+    _dst->size     = _src->size;
+    _dst->capacity = _src->capacity;
+    _dst->flags    = D_STRING_FLAG_COUNTED |
+                     (_src->flags & D_STRING_FLAG_HASHED);
+    _dst->hash     = _src->hash;
 
-    return str;
+    return;
 }
 
 /*
-d_string_new_from_cstr_n
-  Creates a d_string from at most n characters of a C string.
-
-Parameter(s):
-  _cstr:   source string to copy from.
-  _length: maximum number of characters to copy.
-Return:
-  A pointer value corresponding to either:
-  - newly allocated d_string, if successful, or
-  - NULL, if _cstr was NULL or memory allocation failed.
+d_string_internal_unshare
+  Gives a d_string whose buffer is shared a private copy of it, of the same
+capacity, and drops its reference to the shared one. Returns false, leaving
+the string unchanged, if the copy cannot be allocated.
 */
-struct d_string*
-d_string_new_from_cstr_n
+static bool
+d_string_internal_unshare
 (
-    const char* _cstr,
-    size_t      _length
+    struct d_string* _str,
+    const char*      _file,
+    int              _line
 )
 {
-    size_t           actual_len;
-    size_t           capacity;
-    struct d_string* str;
-
-    if (_cstr == NULL)
-    {
-        return NULL;
-    }
+    char* text;
 
-    actual_len = d_strnlen(_cstr, _length);
-    capacity   = actual_len + 1;
-
-    str = d_string_new_with_capacity(capacity);
+    text = d_string_internal_buffer_new(_str->capacity, _file, _line);
 
-    if (str == NULL)
+    if (text == NULL)
     {
-        return NULL;
+        return false;
     }
 
-    d_memcpy(str->text, _cstr, actual_len);
-    str->text[actual_len] = '\0';
-    str->size             = actual_len;
+    d_memcpy(text, _str->text, _str->size + 1);
+    d_string_internal_release(_str);
+    _str->text = text;
 
-    return str;
+    return true;
 }
 
 /*
-d_string_new_from_buffer
-  Creates a d_string from a buffer of specified length (not necessarily 
-null-terminated).
-
-Parameter(s):
-  _buffer: source buffer to copy from.
-  _length: number of bytes to copy.
-Return:
-  A pointer value corresponding to either:
-  - newly allocated d_string, if successful, or
-  - NULL, if _buffer was NULL or memory allocation failed.
+d_string_internal_modified
+  Records that a d_string's contents are about to change: discards any cached
+hash and, if the text buffer is shared with other d_strings, first gives this
+one a private copy. Returns false only if that copy cannot be allocated, in
+which case the string must not be written. Safe to call with NULL.
 */
-struct d_string*
-d_string_new_from_buffer
+static D_INLINE bool
+d_string_internal_modified
 (
-    const char* _buffer,
-    size_t      _length
+    struct d_string* _str,
+    const char*      _file,
+    int              _line
 )
 {
-    size_t           capacity;
-    struct d_string* str;
-
-    if (_buffer == NULL)
-    {
-        return NULL;
-    }
-
-    capacity = _length + 1;
-    str      = d_string_new_with_capacity(capacity);
-
-    if (str == NULL)
+    if (_str == NULL)
     {
-        return NULL;
+        return true;
     }
 
-    d_memcpy(str->text, _buffer, _length);
-    str->text[_length] = '\0';
-    str->size          = _length;
+    _str->flags &= ~D_STRING_FLAG_HASHED;
 
-    return str;
+    return ( (!d_string_internal_is_shared(_str)) ||
+             d_string_internal_unshare(_str, _file, _line) );
 }
 
 /*
-d_string_new_copy
-  Creates a deep copy of an existing d_string.
-
-Parameter(s):
-  _other: d_string to copy.
-Return:
-  A pointer value corresponding to either:
-  - newly allocated d_string copy, if successful, or
-  - NULL, if _other was NULL or memory allocation failed.
+d_string_internal_free_header
+  Frees the struct of a d_string, but not its text, returning it to the
+allocator it came from.
 */
-struct d_string*
-d_string_new_copy
+static void
+d_string_internal_free_header
 (
-    const struct d_string* _other
+    struct d_string* _str
 )
 {
-    if (_other == NULL)
+    if (_str->flags & D_STRING_FLAG_ALLOCATOR)
     {
-        return NULL;
+        d_allocator_free(D_STRING_INTERNAL_ALLOCATOR(_str),
+                         (char*)_str -
+                             offsetof(struct d_string_internal_allocated, string),
+                         sizeof(struct d_string_internal_allocated));
+
+        return;
     }
 
-    return d_string_new_from_buffer(_other->text, _other->size);
+    D_MEMORY_FREE(_str);
+
+    return;
 }
 
 /*
-d_string_new_fill
-  Creates a d_string filled with a repeated character.
-
-Parameter(s):
-  _length:    number of times to repeat the character.
-  _fill_char: character to fill with.
-Return:
-  A pointer value corresponding to either:
-  - newly allocated d_string, if successful, or
-  - NULL, if memory allocation failed.
+d_string_internal_allocator_grow
+  Gives an allocator-backed d_string a text buffer of `_capacity` bytes from
+its allocator, resizing its current buffer through d_allocator_realloc (so an
+arena extends its most recent allocation in place). Returns false if the
+allocator fails, leaving the string unchanged.
 */
-struct d_string*
-d_string_new_fill
+static bool
+d_string_internal_allocator_grow
 (
-    size_t _length,
-    char   _fill_char
+    struct d_string* _str,
+    size_t           _capacity
 )
 {
-    struct d_string* str;
+    const struct d_allocator* allocator;
+    char*                     new_text;
 
-    str = d_string_new_with_capacity(_length + 1);
+    allocator = D_STRING_INTERNAL_ALLOCATOR(_str);
 
-    if (str == NULL)
+    if ( (_str->text == NULL) ||
+         (D_STRING_IS_INLINE(_str)) )
     {
-        return NULL;
+        new_text = (char*)d_allocator_alloc_aligned(allocator, _capacity, 1);
+
+        if (new_text == NULL)
+        {
+            return false;
+        }
+
+        if (_str->text != NULL)
+        {
+            d_memcpy(new_text, _str->text, _str->size + 1);
+        }
+        else
+        {
+            new_text[0] = '\0';
+            _str->size  = 0;
+        }
     }
+    else
+    {
+        new_text = (char*)d_allocator_realloc(allocator,
+                                              _str->text,
+                                              _str->capacity,
+                                              _capacity);
 
-    d_memset(str->text, _fill_char, _length);
-    str->text[_length] = '\0';
-    str->size          = _length;
+        if (new_text == NULL)
+        {
+            return false;
+        }
+    }
 
-    return str;
+    _str->text     = new_text;
+    _str->capacity = _capacity;
+
+    return true;
 }
 
 /*
-d_string_new_formatted
-  Creates a d_string using printf-style formatting.
-
-Parameter(s):
-  _format: printf-style format string.
-  ...:     format arguments.
-Return:
-  A pointer value corresponding to either:
-  - newly allocated d_string, if successful, or
-  - NULL, if _format was NULL or memory allocation failed.
+d_string_internal_take
+  Moves the contents of `_src` into `_dst`, releasing `_dst`'s previous buffer
+and freeing the `_src` header. Inline contents are copied, since they cannot
+outlive the struct that holds them; so are buffers that would cross between
+allocators, i.e. whenever either string is allocator-backed. Returns false
+only if such a copy cannot be allocated, in which case `_src` is freed and
+`_dst` is left unchanged.
 */
-struct d_string*
-d_string_new_formatted
+static bool
+d_string_internal_take
 (
-    const char* _format, 
-    ...
+    struct d_string* _dst,
+    struct d_string* _src,
+    const char*      _file,
+    int              _line
 )
 {
-    va_list          args;
-    va_list          args_copy;
-    int              len;
-    struct d_string* str;
+    char* text;
 
-    if (_format == NULL)
+    if ( ((_dst->flags | _src->flags) & D_STRING_FLAG_ALLOCATOR) &&
+         (!D_STRING_IS_INLINE(_src)) )
     {
-        return NULL;
-    }
+        if (_dst->flags & D_STRING_FLAG_ALLOCATOR)
+        {
+            if ( ( (_dst->text == NULL) ||
+                   (_dst->capacity <= _src->size) ) &&
+                 (!d_string_internal_allocator_grow(_dst, _src->size + 1)) )
+            {
+                d_string_free(_src);
 
-    va_start(args, _format);
-    va_copy(args_copy, args);
+                return false;
+            }
+        }
+        else
+        {
+            text = d_string_internal_buffer_new(_src->size + 1, _file, _line);
 
-    // determine required length
-    len = vsnprintf(NULL, 0, _format, args);
-    va_end(args);
+            if (text == NULL)
+            {
+                d_string_free(_src);
 
-    if (len < 0)
-    {
-        va_end(args_copy);
+                return false;
+            }
 
-        return NULL;
+            d_string_internal_release(_dst);
+            _dst->text     = text;
+            _dst->capacity = _src->size + 1;
+            _dst->flags   |= D_STRING_FLAG_COUNTED;
+        }
+
+        d_memcpy(_dst->text, _src->text, _src->size + 1);
+        _dst->size = _src->size;
+        d_string_free(_src);
+
+        return true;
     }
 
-    str = d_string_new_with_capacity((size_t)len + 1);
+    d_string_internal_release(_dst);
 
-    if (str == NULL)
+    if (D_STRING_IS_INLINE(_src))
     {
-        va_end(args_copy);
-
-        return NULL;
+        d_memcpy(_dst->sso, _src->sso, _src->size + 1);
+        _dst->text     = _dst->sso;
+        _dst->capacity = D_STRING_SSO_CAPACITY;
+    }
+    else
+    {
+        _dst->text     = _src->text;
+        _dst->capacity = _src->capacity;
     }
 
-    vsnprintf(str->text, (size_t)len + 1, _format, args_copy);
-    va_end(args_copy);
-
-    str->size = (size_t)len;
+    _dst->flags = (_dst->flags & ~D_STRING_FLAG_COUNTED) |
+                  (_src->flags & D_STRING_FLAG_COUNTED);
+    _dst->size  = _src->size;
+    d_string_internal_free_header(_src);
 
-    return str;
+    return true;
 }
 
 /*
-d_string_free
-  Frees a d_string and its contents.
-
-Parameter(s):
-  _str: d_string to free.
-Return:
-  (none)
+d_string_internal_new_heap
+  Creates an empty d_string on the heap, with a counted text buffer if
+`_capacity` does not fit inline. Backs every constructor whose allocator
+resolves to d_allocator_system.
 */
-void
-d_string_free
+static struct d_string*
+d_string_internal_new_heap
 (
-    struct d_string* _str
+    size_t      _capacity,
+    const char* _file,
+    int         _line
 )
 {
-    if (_str == NULL)
+    struct d_string* str;
+
+    // ensure minimum capacity of 1 for null terminator
+    if (_capacity == 0)
     {
-        return;
+        _capacity = 1;
     }
 
-    if (_str->text != NULL)
+    str = (struct d_string*)D_MEMORY_ALLOC_AT(D_MEMORY_MODULE_STRING,
+                                              _file,
+                                              _line,
+                                              sizeof(struct d_string));
+
+    if (str == NULL)
     {
-        free(_str->text);
+        return NULL;
     }
 
-    free(_str);
+    d_string_internal_init(str);
+    str->growth = D_STRING_DEFAULT_GROWTH;
 
-    return;
+    // only strings that cannot fit inline need a separate buffer
+    if (_capacity > D_STRING_SSO_CAPACITY)
+    {
+        str->text = d_string_internal_buffer_new(_capacity, _file, _line);
+
+        if (str->text == NULL)
+        {
+            D_MEMORY_FREE(str);
+
+            return NULL;
+        }
+
+        str->text[0]  = '\0';
+        str->capacity = _capacity;
+        str->flags    = D_STRING_FLAG_COUNTED;
+    }
+
+    return str;
 }
 
 /*
-d_string_free_contents
-  Frees the text buffer of a d_string but not the struct itself.
-
-Parameter(s):
-  _str: d_string whose contents to free.
-Return:
-  (none)
+d_string_internal_next_capacity
+  Computes the capacity a d_string should grow to in order to hold at least
+`_required` bytes under the given growth policy. Returns `_required` itself if
+the geometric step would overflow.
 */
-void
-d_string_free_contents
+static size_t
+d_string_internal_next_capacity
 (
-    struct d_string* _str
+    size_t                      _current,
+    size_t                      _required,
+    enum d_string_growth_policy _policy
 )
 {
-    if (_str == NULL)
-    {
-        return;
-    }
+    size_t new_capacity;
+    size_t step;
 
-    if (_str->text != NULL)
+    if (_policy == D_STRING_GROWTH_EXACT)
     {
-        free(_str->text);
-        _str->text = NULL;
+        return _required;
     }
 
-    _str->size = 0;
+    new_capacity = (_current < 16) ? 16 : _current;
 
-    _str->capacity = 0;
-#endif
+    while (new_capacity < _required)
+    {
+        step = (_policy == D_STRING_GROWTH_DOUBLE) ? new_capacity
+                                                    : (new_capacity / 2);
 
-    return;
-}
+        if (new_capacity > (SIZE_MAX - step))
+        {
+            return _required;
+        }
 
+        new_capacity += step;
+    }
 
-/******************************************************************************
-* Capacity Management Functions
-******************************************************************************/
+    // round large (or page-policy) buffers up to whole pages
+    if ( (_policy == D_STRING_GROWTH_PAGE) ||
+         (new_capacity >= D_STRING_PAGE_THRESHOLD) )
+    {
+        step = (new_capacity + (D_STRING_PAGE_SIZE - 1)) &
+               ~((size_t)D_STRING_PAGE_SIZE - 1);
 
+        if (step >= new_capacity)
+        {
+            new_capacity = step;
+        }
+    }
 
-/*
-d_string_reserve
-  Ensures the d_string has at least the specified capacity.
+    return new_capacity;
+}
 
-Parameter(s):
-  _str:      d_string to modify.
-  _capacity: minimum capacity to reserve.
-Return:
-  A boolean value corresponding to either:
-  - true, if capacity was reserved successfully, or
-  - false, if _str was NULL or allocation failed.
+/*
+d_string_internal_grow_policy
+  Ensures the d_string has at least the required capacity, growing with the
+given policy if needed. Heap buffers owned by this d_string alone are extended
+with `realloc`, so the allocator can grow the block in place instead of
+copying it; a shared buffer is left to its other owners and the contents move
+to a fresh one. Strings that still fit in the inline buffer are never moved to
+the heap, and allocator-backed strings never leave their allocator.
 */
-bool
-d_string_reserve
+static bool
+d_string_internal_grow_policy
 (
-    struct d_string* _str,
-    size_t           _capacity
+    struct d_string*            _str,
+    size_t                      _required,
+    enum d_string_growth_policy _policy,
+    const char*                 _file,
+    int                         _line
 )
 {
+    size_t       new_capacity;
+    char*        new_text;
+    unsigned int flags;
+
     if (_str == NULL)
     {
         return false;
     }
 
-    return d_string_internal_grow(_str, _capacity);
-}
+    // check if we already have enough capacity
+    if (_str->capacity >= _required)
+    {
+        return true;
+    }
 
-/*
-d_string_shrink_to_fit
-  Reduces capacity to match the current size.
+    // a released string (see d_string_free_contents) can return to inline
+    // storage if the request fits
+    if ( (_str->text == NULL) &&
+         (_required <= D_STRING_SSO_CAPACITY) )
+    {
+        flags = _str->flags & D_STRING_FLAG_ALLOCATOR;
+        d_string_internal_init(_str);
+        _str->flags = flags;
 
-Parameter(s):
-  _str: d_string to shrink.
-Return:
-  A boolean value corresponding to either:
-  - true, if shrinking was successful, or
-  - false, if _str was NULL or reallocation failed.
-*/
-bool
-d_string_shrink_to_fit
-(
-    struct d_string* _str
-)
-{
-    size_t new_capacity;
-    char*  new_text;
+        return true;
+    }
 
-    if (_str == NULL)
+    new_capacity = d_string_internal_next_capacity(_str->capacity,
+                                                   _required,
+                                                   _policy);
+
+    // allocator-backed strings grow through their allocator
+    if (_str->flags & D_STRING_FLAG_ALLOCATOR)
     {
-        return false;
+        return d_string_internal_allocator_grow(_str, new_capacity);
     }
 
-    new_capacity = _str->size + 1;
-
-    // don't shrink if already at minimum
-    if (_str->capacity <= new_capacity)
+    // unshared heap buffers can be extended in place
+    if ( d_string_internal_is_counted(_str) &&
+         (!d_string_internal_is_shared(_str)) )
     {
+        new_text = d_string_internal_buffer_resize(_str->text,
+                                                   new_capacity,
+                                                   _file,
+                                                   _line);
+
+        if (new_text == NULL)
+        {
+            return false;
+        }
+
+        _str->text     = new_text;
+        _str->capacity = new_capacity;
+
         return true;
     }
 
-    new_text = (char*)malloc(new_capacity);
+    // inline, released or shared strings move to a fresh heap buffer
+    new_text = d_string_internal_buffer_new(new_capacity, _file, _line);
 
     if (new_text == NULL)
     {
         return false;
     }
 
-    d_memcpy(new_text, _str->text, new_capacity);
-    free(_str->text);
+    if (_str->text != NULL)
+    {
+        d_memcpy(new_text, _str->text, _str->size + 1);
+        d_string_internal_release(_str);
+    }
+    else
+    {
+        new_text[0] = '\0';
+        _str->size  = 0;
+    }
 
     _str->text     = new_text;
     _str->capacity = new_capacity;
+    _str->flags   |= D_STRING_FLAG_COUNTED;
 
     return true;
 }
 
 /*
-d_string_capacity
-  Returns the current capacity of a d_string.
-
-Parameter(s):
-  _str: d_string to query.
-Return:
-  The capacity of the string, or 0 if _str is NULL.
+d_string_internal_grow
+  Ensures the d_string has at least the required capacity, growing according
+to the string's own growth policy if needed.
 */
-size_t
-d_string_capacity
+static bool
+d_string_internal_grow
 (
-    const struct d_string* _str
+    struct d_string* _str,
+    size_t           _required,
+    const char*      _file,
+    int              _line
 )
 {
     if (_str == NULL)
     {
-        return 0;
+        return false;
     }
 
-    return _str->capacity;
+    return d_string_internal_grow_policy(_str,
+                                         _required,
+                                         _str->growth,
+                                         _file,
+                                         _line);
 }
 
+/******************************************************************************
+* Internal Search Engine
+******************************************************************************/
 
-/*
-d_string_resize
-  Resizes the string to the specified size.
+// D_STRING_SEARCH_BLOCK
+//   constant: number of candidate positions the rare-byte-pair filter
+// examines per step; each step yields a 64-bit mask with one bit per
+// position.
+#define D_STRING_SEARCH_BLOCK 64
+
+// D_STRING_SEARCH_VERIFY_RATIO, D_STRING_SEARCH_VERIFY_SLACK
+//   constant: the candidate filter may compare up to VERIFY_RATIO needle
+// bytes per haystack byte scanned, plus VERIFY_SLACK, while verifying false
+// positives; past that the search falls back to the Two-Way algorithm. This
+// bounds the filter's worst case on pathological inputs (e.g. "abab...abb"
+// in "abab...ab") to linear time.
+#ifndef D_STRING_SEARCH_VERIFY_RATIO
+    #define D_STRING_SEARCH_VERIFY_RATIO 4
+#endif
+#define D_STRING_SEARCH_VERIFY_SLACK 1024
+
+// D_STRING_INTERNAL_AT
+//   macro: reads byte `i` of a needle of length `nn`, either forwards or (if
+// `rev` is true) from the end. Lets the Two-Way preprocessing serve both
+// forward and reverse searches without copying the needle.
+#define D_STRING_INTERNAL_AT(n, nn, i, rev)  \
+    ((rev) ? (n)[(nn) - 1 - (i)] : (n)[(i)])
+
+// d_string_internal_twoway
+//   struct: preprocessed state for a Two-Way (Crochemore-Perrin) search. The
+// byteset and shift table add a Horspool-style skip on the window's last byte.
+struct d_string_internal_twoway
+{
+    size_t        ms;           // end of the left half of the factorization
+    size_t        period;       // shift after a right-half match
+    size_t        mem0;         // prefix known to match after that shift
+    size_t        shift[256];   // last position (+1) of each byte in needle
+    unsigned char byteset[32];  // bitset of bytes present in needle
+};
 
-Parameter(s):
-  _str:      d_string to resize.
-  _new_size: new size for the string.
-Return:
-  A boolean value corresponding to either:
-  - true, if resize was successful, or
-  - false, if _str was NULL or allocation failed.
+/*
+d_string_internal_ctz64
+  Returns the number of trailing zero bits in a non-zero 64-bit value.
 */
-bool
-d_string_resize
+static D_INLINE unsigned
+d_string_internal_ctz64
 (
-    struct d_string* _str,
-    size_t           _new_size
+    uint64_t _x
 )
 {
-    if (_str == NULL)
-    {
-        return false;
-    }
+#if defined(__GNUC__) || defined(__clang__)
+    return (unsigned)__builtin_ctzll(_x);
+#elif defined(_MSC_VER) && (defined(_M_X64) || defined(_M_ARM64))
+    unsigned long index;
 
-    // grow if needed
-    if (!d_string_internal_grow(_str, _new_size + 1))
-    {
-        return false;
-    }
+    _BitScanForward64(&index, _x);
 
-    // if growing, fill with nulls
-    if (_new_size > _str->size)
+    return (unsigned)index;
+#else
+    unsigned count;
+
+    count = 0;
+
+    while ((_x & 1) == 0)
     {
-        d_memset(_str->text + _str->size, '\0', _new_size - _str->size);
+        _x >>= 1;
+        count++;
     }
 
-    _str->size             = _new_size;
-    _str->text[_new_size]  = '\0';
-
-    return true;
+    return count;
+#endif
 }
 
-
-/******************************************************************************
-* Access Functions
-******************************************************************************/
-
 /*
-d_string_length
-  Returns the length of the string (excluding null terminator).
-
-Parameter(s):
-  _str: d_string to query.
-Return:
-  The length of the string, or 0 if _str is NULL.
+d_string_internal_max_suffix
+  Computes the maximal suffix of a needle under the byte ordering selected by
+`_greater`, returning its start position minus one (SIZE_MAX for the whole
+needle) and storing its period in `_period`.
 */
-size_t
-d_string_length
+static size_t
+d_string_internal_max_suffix
 (
-    const struct d_string* _str
+    const unsigned char* _n,
+    size_t               _nn,
+    bool                 _reverse,
+    bool                 _greater,
+    size_t*              _period
 )
 {
-    if (_str == NULL)
+    size_t        ip;
+    size_t        jp;
+    size_t        k;
+    size_t        p;
+    unsigned char a;
+    unsigned char b;
+
+    ip = SIZE_MAX;
+    jp = 0;
+    k  = 1;
+    p  = 1;
+
+    while ((jp + k) < _nn)
     {
-        return 0;
+        a = D_STRING_INTERNAL_AT(_n, _nn, ip + k, _reverse);
+        b = D_STRING_INTERNAL_AT(_n, _nn, jp + k, _reverse);
+
+        if (a == b)
+        {
+            if (k == p)
+            {
+                jp += p;
+                k   = 1;
+            }
+            else
+            {
+                k++;
+            }
+        }
+        else if ((a > b) == _greater)
+        {
+            jp += k;
+            k   = 1;
+            p   = jp - ip;
+        }
+        else
+        {
+            ip = jp++;
+            k  = 1;
+            p  = 1;
+        }
     }
 
-    return _str->size;
+    *_period = p;
+
+    return ip;
 }
 
 /*
-d_string_size
-  Alias for d_string_length.
-
-Parameter(s):
-  _str: d_string to query.
-Return:
-  The size of the string, or 0 if _str is NULL.
+d_string_internal_twoway_prepare
+  Computes the critical factorization, period and skip table of a needle for
+a forward search, or for a reverse search if `_reverse` is true.
 */
-size_t
-d_string_size
+static void
+d_string_internal_twoway_prepare
 (
-    const struct d_string* _str
+    const unsigned char*             _n,
+    size_t                           _nn,
+    bool                             _reverse,
+    struct d_string_internal_twoway* _tw
 )
 {
-    return d_string_length(_str);
+    size_t        i;
+    size_t        ms;
+    size_t        ms_alt;
+    size_t        p;
+    size_t        p_alt;
+    unsigned char c;
+
+    d_memset(_tw->byteset, 0, sizeof(_tw->byteset));
+
+    for (i = 0; i < _nn; i++)
+    {
+        c = D_STRING_INTERNAL_AT(_n, _nn, i, _reverse);
+
+        _tw->byteset[c >> 3] |= (unsigned char)(1u << (c & 7));
+        _tw->shift[c]         = i + 1;
+    }
+
+    // the critical factorization is the later of the two maximal suffixes
+    ms     = d_string_internal_max_suffix(_n, _nn, _reverse, true, &p);
+    ms_alt = d_string_internal_max_suffix(_n, _nn, _reverse, false, &p_alt);
+
+    if ((ms_alt + 1) > (ms + 1))
+    {
+        ms = ms_alt;
+        p  = p_alt;
+    }
+
+    // a needle is periodic if its left half repeats at distance p
+    for (i = 0; i < (ms + 1); i++)
+    {
+        if (D_STRING_INTERNAL_AT(_n, _nn, i, _reverse) !=
+            D_STRING_INTERNAL_AT(_n, _nn, i + p, _reverse))
+        {
+            break;
+        }
+    }
+
+    _tw->ms = ms;
+
+    if (i < (ms + 1))
+    {
+        _tw->mem0   = 0;
+        _tw->period = ( (ms > (_nn - ms - 1)) ? ms : (_nn - ms - 1) ) + 1;
+    }
+    else
+    {
+        _tw->mem0   = _nn - p;
+        _tw->period = p;
+    }
+
+    return;
 }
 
 /*
-d_string_cstr
-  Returns a const pointer to the null-terminated string data.
-
-Parameter(s):
-  _str: d_string to access.
-Return:
-  A pointer value corresponding to either:
-  - const pointer to the string data, or
-  - NULL, if _str is NULL.
+d_string_internal_twoway_find
+  Forward Two-Way search over a haystack of known length. Runs in O(n + m)
+time regardless of input and never reads past `_h + _hn`.
 */
-const char*
-d_string_cstr
+static const char*
+d_string_internal_twoway_find
 (
-    const struct d_string* _str
+    const unsigned char*                   _h,
+    size_t                                 _hn,
+    const unsigned char*                   _n,
+    size_t                                 _nn,
+    const struct d_string_internal_twoway* _tw
 )
 {
-    if (_str == NULL)
+    const unsigned char* w;
+    size_t               pos;
+    size_t               mem;
+    size_t               k;
+    unsigned char        c;
+
+    pos = 0;
+    mem = 0;
+
+    while ((_hn - pos) >= _nn)
     {
-        return NULL;
+        w = _h + pos;
+        c = w[_nn - 1];
+
+        // skip on the window's last byte
+        if (_tw->byteset[c >> 3] & (1u << (c & 7)))
+        {
+            k = _nn - _tw->shift[c];
+
+            if (k)
+            {
+                pos += (k < mem) ? mem : k;
+                mem  = 0;
+
+                continue;
+            }
+        }
+        else
+        {
+            pos += _nn;
+            mem  = 0;
+
+            continue;
+        }
+
+        // compare the right half
+        k = ((_tw->ms + 1) > mem) ? (_tw->ms + 1) : mem;
+
+        while ( (k < _nn) &&
+                (_n[k] == w[k]) )
+        {
+            k++;
+        }
+
+        if (k < _nn)
+        {
+            pos += k - _tw->ms;
+            mem  = 0;
+
+            continue;
+        }
+
+        // compare the left half
+        k = _tw->ms + 1;
+
+        while ( (k > mem) &&
+                (_n[k - 1] == w[k - 1]) )
+        {
+            k--;
+        }
+
+        if (k <= mem)
+        {
+            return (const char*)w;
+        }
+
+        pos += _tw->period;
+        mem  = _tw->mem0;
     }
 
-    return _str->text;
+    return NULL;
 }
 
 /*
-d_string_data
-  Returns a mutable pointer to the string data.
-
-Parameter(s):
-  _str: d_string to access.
-Return:
-  A pointer value corresponding to either:
-  - pointer to the string data, or
-  - NULL, if _str is NULL.
+d_string_internal_twoway_rfind
+  Reverse Two-Way search: the forward algorithm applied to the reversed
+haystack and needle, addressed in place. Returns the last occurrence.
 */
-char*
-d_string_data
+static const char*
+d_string_internal_twoway_rfind
 (
-    struct d_string* _str
+    const unsigned char*                   _h,
+    size_t                                 _hn,
+    const unsigned char*                   _n,
+    size_t                                 _nn,
+    const struct d_string_internal_twoway* _tw
 )
 {
-    if (_str == NULL)
+    const unsigned char* end;
+    const unsigned char* last;
+    size_t               pos;
+    size_t               mem;
+    size_t               k;
+    unsigned char        c;
+
+    pos  = 0;
+    mem  = 0;
+    last = _n + _nn - 1;
+
+    while ((_hn - pos) >= _nn)
     {
-        return NULL;
+        // the window is read backwards from `end`
+        end = _h + _hn - pos - 1;
+        c   = *(end - (_nn - 1));
+
+        if (_tw->byteset[c >> 3] & (1u << (c & 7)))
+        {
+            k = _nn - _tw->shift[c];
+
+            if (k)
+            {
+                pos += (k < mem) ? mem : k;
+                mem  = 0;
+
+                continue;
+            }
+        }
+        else
+        {
+            pos += _nn;
+            mem  = 0;
+
+            continue;
+        }
+
+        k = ((_tw->ms + 1) > mem) ? (_tw->ms + 1) : mem;
+
+        while ( (k < _nn) &&
+                (*(last - k) == *(end - k)) )
+        {
+            k++;
+        }
+
+        if (k < _nn)
+        {
+            pos += k - _tw->ms;
+            mem  = 0;
+
+            continue;
+        }
+
+        k = _tw->ms + 1;
+
+        while ( (k > mem) &&
+                (*(last - (k - 1)) == *(end - (k - 1))) )
+        {
+            k--;
+        }
+
+        if (k <= mem)
+        {
+            return (const char*)(end - (_nn - 1));
+        }
+
+        pos += _tw->period;
+        mem  = _tw->mem0;
     }
 
-    return _str->text;
+    return NULL;
 }
 
-/*
-d_string_is_empty
-  Checks if the string is empty.
+// d_string_internal_byte_rank
+//   global: rough frequency rank of each byte value in typical text and
+// binary data, from 0 (rarest) to 255 (the space). The search filter keys
+// on the two needle bytes with the lowest rank, so that its candidates are
+// as few as possible.
+static const unsigned char d_string_internal_byte_rank[256] =
+{
+    // 0x00 - 0x0F: NUL, tab, LF, CR
+    200,  40,  40,  40,  40,  40,  40,  40,
+     40, 190, 216,  40,  40, 150,  40,  40,
+    // 0x10 - 0x1F: other control bytes
+     40,  40,  40,  40,  40,  40,  40,  40,
+     40,  40,  40,  40,  40,  40,  40,  40,
+    // 0x20 - 0x2F: space and punctuation
+    255, 146, 182, 150, 140, 140, 146, 172,
+    176, 176, 160, 150, 200, 186, 202, 184,
+    // 0x30 - 0x3F: digits and punctuation
+    194, 190, 188, 186, 184, 182, 180, 178,
+    176, 174, 180, 172, 160, 178, 160, 144,
+    // 0x40 - 0x4F: @ and upper case
+    138, 173, 156, 164, 165, 175, 161, 159,
+    167, 171, 152, 154, 166, 162, 170, 172,
+    // 0x50 - 0x5F: upper case and punctuation
+    160, 151, 168, 169, 174, 163, 155, 158,
+    153, 157, 150, 156, 138, 156, 126, 188,
+    // 0x60 - 0x6F: ` and lower case
+    124, 243, 204, 222, 224, 250, 214, 210,
+    230, 238, 176, 196, 226, 218, 236, 240,
+    // 0x70 - 0x7F: lower case and punctuation, DEL
+    212, 170, 232, 234, 245, 220, 198, 208,
+    180, 206, 168, 158, 136, 158, 130,  40,
+    // 0x80 - 0x8F: UTF-8 continuation bytes
+    110, 110, 110, 110, 110, 110, 110, 110,
+    110, 110, 110, 110, 110, 110, 110, 110,
+    // 0x90 - 0x9F: UTF-8 continuation bytes
+    110, 110, 110, 110, 110, 110, 110, 110,
+    110, 110, 110, 110, 110, 110, 110, 110,
+    // 0xA0 - 0xAF: UTF-8 continuation bytes
+    110, 110, 110, 110, 110, 110, 110, 110,
+    110, 110, 110, 110, 110, 110, 110, 110,
+    // 0xB0 - 0xBF: UTF-8 continuation bytes
+    110, 110, 110, 110, 110, 110, 110, 110,
+    110, 110, 110, 110, 110, 110, 110, 110,
+    // 0xC0 - 0xCF: UTF-8 lead bytes (0xC0 and 0xC1 are never used)
+     60,  60, 100, 100, 100, 100, 100, 100,
+    100, 100, 100, 100, 100, 100, 100, 100,
+    // 0xD0 - 0xDF: UTF-8 lead bytes
+    100, 100, 100, 100, 100, 100, 100, 100,
+    100, 100, 100, 100, 100, 100, 100, 100,
+    // 0xE0 - 0xEF: UTF-8 lead bytes
+    100, 100, 100, 100, 100, 100, 100, 100,
+    100, 100, 100, 100, 100, 100, 100, 100,
+    // 0xF0 - 0xFF: UTF-8 lead bytes to 0xF4, then bytes UTF-8 never uses
+    100, 100, 100, 100, 100,  60,  60,  60,
+     60,  60,  60,  60,  60,  60,  60, 120
+};
 
-Parameter(s):
-  _str: d_string to check.
-Return:
-  A boolean value corresponding to either:
-  - true, if _str is NULL or empty, or
-  - false, if _str contains characters.
+/*
+d_string_internal_span
+  Returns the distance between positions `_a` and `_b`.
 */
-bool
-d_string_is_empty
+static D_INLINE size_t
+d_string_internal_span
 (
-    const struct d_string* _str
+    size_t _a,
+    size_t _b
 )
 {
-    return ( (_str == NULL) || 
-             (_str->size == 0) );
+    return (_a > _b) ? (_a - _b) : (_b - _a);
 }
 
 /*
-d_string_char_at
-  Returns the character at the specified index.
-
-Parameter(s):
-  _str:   d_string to access.
-  _index: index of character (negative indices count from end).
-Return:
-  The character at the index, or '\0' if index is invalid.
+d_string_internal_search_pair
+  Picks the two needle positions the search filter compares: the one holding
+the rarest byte, and the one holding the rarest different byte (or, if every
+byte is the same, the first and last positions). `_nn` must be at least 2.
 */
-char
-d_string_char_at
+static void
+d_string_internal_search_pair
 (
-    const struct d_string* _str,
-    d_index                _index
+    const unsigned char* _n,
+    size_t               _nn,
+    size_t*              _first,
+    size_t*              _second
 )
 {
-    size_t pos;
+    size_t i;
+    size_t first;
+    size_t second;
 
-    if (_str == NULL)
+    first = 0;
+
+    for (i = 1; i < _nn; i++)
     {
-        return '\0';
+        if (d_string_internal_byte_rank[_n[i]] <
+            d_string_internal_byte_rank[_n[first]])
+        {
+            first = i;
+        }
     }
 
-    if (!d_index_convert_safe(_index, _str->size, &pos))
+    second = SIZE_MAX;
+
+    // among equally rare bytes, prefer the one nearest `first`, so that both
+    // loads of a filter step tend to hit the same cache lines
+    for (i = 0; i < _nn; i++)
     {
-        return '\0';
+        if (_n[i] == _n[first])
+        {
+            continue;
+        }
+
+        if ( (second == SIZE_MAX) ||
+             (d_string_internal_byte_rank[_n[i]] <
+              d_string_internal_byte_rank[_n[second]]) ||
+             ( (d_string_internal_byte_rank[_n[i]] ==
+                d_string_internal_byte_rank[_n[second]]) &&
+               (d_string_internal_span(i, first) <
+                d_string_internal_span(second, first)) ) )
+        {
+            second = i;
+        }
     }
 
-    return _str->text[pos];
+    if (second == SIZE_MAX)
+    {
+        first  = 0;
+        second = _nn - 1;
+    }
+
+    *_first  = first;
+    *_second = second;
+
+    return;
 }
 
-/*
-d_string_set_char
-  Sets the character at the specified index.
+/******************************************************************************
+* Internal Formatting Engine
+******************************************************************************/
 
-Parameter(s):
-  _str:   d_string to modify.
-  _index: index of character (negative indices count from end).
-  _c:     character to set.
-Return:
-  A boolean value corresponding to either:
-  - true, if character was set successfully, or
-  - false, if _str was NULL or index was invalid.
+// D_STRING_FMT_*
+//   flags: printf conversion flags recorded by the formatting engine.
+#define D_STRING_FMT_MINUS  0x01u   // '-': left-justify
+#define D_STRING_FMT_ZERO   0x02u   // '0': pad with zeros
+#define D_STRING_FMT_PLUS   0x04u   // '+': always print a sign
+#define D_STRING_FMT_SPACE  0x08u   // ' ': space in place of a '+' sign
+#define D_STRING_FMT_HASH   0x10u   // '#': alternate form
+#define D_STRING_FMT_GROUP  0x20u   // '\'': locale digit grouping
+
+// d_string_internal_spec
+//   struct: one parsed printf conversion specification. `length` encodes the
+// length modifier: 'H' for hh, 'q' for ll, otherwise the modifier itself.
+struct d_string_internal_spec
+{
+    unsigned flags;
+    int      width;      // -1 if absent
+    int      precision;  // -1 if absent
+    char     length;     // 0 if absent
+    char     conv;
+};
+
+// d_string_internal_digits
+//   constant: the decimal digit pairs "00" through "99", letting integers be
+// converted two digits per division.
+static const char d_string_internal_digits[201] =
+    "00010203040506070809101112131415161718192021222324252627282930313233343536373839"
+    "40414243444546474849505152535455565758596061626364656667686970717273747576777879"
+    "8081828384858687888990919293949596979899";
+
+/*
+d_string_internal_put
+  Appends `_n` bytes to a d_string being formatted, growing it if needed.
+The terminator is written only once formatting finishes.
 */
-bool
-d_string_set_char
+static bool
+d_string_internal_put
 (
     struct d_string* _str,
-    d_index          _index,
-    char             _c
+    const char*      _src,
+    size_t           _n
 )
 {
-    size_t pos;
-
-    if (_str == NULL)
-    {
-        return false;
-    }
-
-    if (!d_index_convert_safe(_index, _str->size, &pos))
+    if ( (_n > (SIZE_MAX - _str->size - 1)) ||
+         (!d_string_internal_grow(_str,
+                                  _str->size + _n + 1,
+                                  D_STRING_INTERNAL_SITE)) )
     {
         return false;
     }
 
-    _str->text[pos] = _c;
+    d_memcpy(_str->text + _str->size, _src, _n);
+    _str->size += _n;
 
     return true;
 }
 
 /*
-d_string_front
-  Returns the first character of the string.
-
-Parameter(s):
-  _str: d_string to access.
-Return:
-  The first character, or '\0' if string is empty or NULL.
+d_string_internal_pad
+  Appends `_n` copies of `_c` to a d_string being formatted.
 */
-char
-d_string_front
+static bool
+d_string_internal_pad
 (
-    const struct d_string* _str
+    struct d_string* _str,
+    char             _c,
+    size_t           _n
 )
 {
-    if ( (_str == NULL) || 
-         (_str->size == 0) )
+    if (_n == 0)
     {
-        return '\0';
+        return true;
     }
 
-    return _str->text[0];
+    if ( (_n > (SIZE_MAX - _str->size - 1)) ||
+         (!d_string_internal_grow(_str,
+                                  _str->size + _n + 1,
+                                  D_STRING_INTERNAL_SITE)) )
+    {
+        return false;
+    }
+
+    d_memset(_str->text + _str->size, _c, _n);
+    _str->size += _n;
+
+    return true;
 }
 
 /*
-d_string_back
-  Returns the last character of the string.
-
-Parameter(s):
-  _str: d_string to access.
-Return:
-  The last character, or '\0' if string is empty or NULL.
+d_string_internal_utoa
+  Writes the digits of `_value` in base 10 or 16 backwards, ending just
+before `_end`, and returns a pointer to the first digit.
 */
-char
-d_string_back
+static char*
+d_string_internal_utoa
 (
-    const struct d_string* _str
+    uintmax_t _value,
+    char*     _end,
+    unsigned  _base,
+    bool      _upper
 )
 {
-    if ( (_str == NULL) || 
-         (_str->size == 0) )
+    const char* hex;
+    unsigned    pair;
+
+    if (_base == 16)
     {
-        return '\0';
-    }
+        hex = _upper ? "0123456789ABCDEF" : "0123456789abcdef";
 
-    return _str->text[_str->size - 1];
-}
+        do
+        {
+            *--_end  = hex[_value & 0xF];
+            _value >>= 4;
+        } while (_value != 0);
 
+        return _end;
+    }
 
-/******************************************************************************
-* Safe Copy Functions
-******************************************************************************/
+    if (_base == 8)
+    {
+        do
+        {
+            *--_end  = (char)('0' + (_value & 7));
+            _value >>= 3;
+        } while (_value != 0);
 
-/*
-d_string_copy_s
-  Safe copy from d_string to d_string.
+        return _end;
+    }
 
-Parameter(s):
-  _dest: destination d_string.
-  _src:  source d_string.
-Return:
-  An integer value corresponding to either:
-  - 0, if copy was successful, or
-  - EINVAL, if either parameter was NULL.
-*/
-int
-d_string_copy_s
-(
-    struct d_string* restrict       _dest,
-    const struct d_string* restrict _src
-)
-{
-    if ( (_dest == NULL) || 
-         (_src == NULL) )
+    while (_value >= 100)
     {
-        return EINVAL;
+        pair    = (unsigned)(_value % 100) * 2;
+        _value /= 100;
+        *--_end = d_string_internal_digits[pair + 1];
+        *--_end = d_string_internal_digits[pair];
     }
 
-    if (!d_string_internal_grow(_dest, _src->size + 1))
+    if (_value >= 10)
     {
-        return ERANGE;
+        pair    = (unsigned)_value * 2;
+        *--_end = d_string_internal_digits[pair + 1];
+        *--_end = d_string_internal_digits[pair];
+    }
+    else
+    {
+        *--_end = (char)('0' + _value);
     }
 
-    d_memcpy(_dest->text, _src->text, _src->size + 1);
-    _dest->size = _src->size;
-
-    return 0;
+    return _end;
 }
 
 /*
-d_string_copy_cstr_s
-  Safe copy from C string to d_string.
-
-Parameter(s):
-  _dest: destination d_string.
-  _src:  source C string.
-Return:
-  An integer value corresponding to either:
-  - 0, if copy was successful, or
-  - EINVAL, if either parameter was NULL.
+d_string_internal_emit_padded
+  Appends a field: optional sign or prefix, then body, justified to the
+spec's width. Zero padding goes between the prefix and the body.
 */
-int
-d_string_copy_cstr_s
+static bool
+d_string_internal_emit_padded
 (
-    struct d_string* restrict _dest,
-    const char* restrict      _src
+    struct d_string*                     _str,
+    const struct d_string_internal_spec* _spec,
+    const char*                          _prefix,
+    size_t                               _prefix_len,
+    const char*                          _body,
+    size_t                               _body_len,
+    bool                                 _zero_ok
 )
 {
     size_t len;
+    size_t fill;
 
-    if ( (_dest == NULL) || 
-         (_src == NULL) )
+    len  = _prefix_len + _body_len;
+    fill = ( (_spec->width > 0) &&
+             ((size_t)_spec->width > len) ) ? ((size_t)_spec->width - len)
+                                            : 0;
+
+    if (_spec->flags & D_STRING_FMT_MINUS)
     {
-        return EINVAL;
+        return ( d_string_internal_put(_str, _prefix, _prefix_len) &&
+                 d_string_internal_put(_str, _body, _body_len) &&
+                 d_string_internal_pad(_str, ' ', fill) );
     }
 
-    len = strlen(_src);
-
-    if (!d_string_internal_grow(_dest, len + 1))
+    if ( _zero_ok &&
+         (_spec->flags & D_STRING_FMT_ZERO) )
     {
-        return ERANGE;
+        return ( d_string_internal_put(_str, _prefix, _prefix_len) &&
+                 d_string_internal_pad(_str, '0', fill) &&
+                 d_string_internal_put(_str, _body, _body_len) );
     }
 
-    d_memcpy(_dest->text, _src, len + 1);
-    _dest->size = len;
-
-    return 0;
+    return ( d_string_internal_pad(_str, ' ', fill) &&
+             d_string_internal_put(_str, _prefix, _prefix_len) &&
+             d_string_internal_put(_str, _body, _body_len) );
 }
 
 /*
-d_string_ncopy_s
-  Safe bounded copy from d_string to d_string.
-
-Parameter(s):
-  _dest:  destination d_string.
-  _src:   source d_string.
-  _count: maximum number of characters to copy.
-Return:
-  An integer value corresponding to either:
-  - 0, if copy was successful, or
-  - EINVAL, if either parameter was NULL.
+d_string_internal_snprintf
+  Appends one conversion formatted by vsnprintf, directly into the spare
+capacity; only if that overflows is the string grown and the conversion
+formatted again.
 */
-int
-d_string_ncopy_s
+static bool
+d_string_internal_snprintf
 (
-    struct d_string* restrict       _dest,
-    const struct d_string* restrict _src,
-    size_t                          _count
+    struct d_string* _str,
+    const char*      _format,
+    ...
 )
 {
-    size_t copy_len;
+    va_list args;
+    va_list args_copy;
+    size_t  avail;
+    int     len;
 
-    if ( (_dest == NULL) || 
-         (_src == NULL) )
+    avail = _str->capacity - _str->size;
+
+    va_start(args, _format);
+    va_copy(args_copy, args);
+    len = vsnprintf(_str->text + _str->size, avail, _format, args);
+    va_end(args);
+
+    if ( (len >= 0) &&
+         ((size_t)len >= avail) )
     {
-        return EINVAL;
+        if (d_string_internal_grow(_str,
+                                   _str->size + (size_t)len + 1,
+                                   D_STRING_INTERNAL_SITE))
+        {
+            vsnprintf(_str->text + _str->size,
+                      (size_t)len + 1,
+                      _format,
+                      args_copy);
+        }
+        else
+        {
+            len = -1;
+        }
     }
 
-    copy_len = (_count < _src->size) ? _count : _src->size;
+    va_end(args_copy);
 
-    if (!d_string_internal_grow(_dest, copy_len + 1))
+    if (len < 0)
     {
-        return ERANGE;
+        return false;
     }
 
-    d_memcpy(_dest->text, _src->text, copy_len);
-    _dest->text[copy_len] = '\0';
-    _dest->size           = copy_len;
+    _str->size += (size_t)len;
 
-    return 0;
+    return true;
 }
 
 /*
-d_string_ncopy_cstr_s
-  Safe bounded copy from C string to d_string.
-
-Parameter(s):
-  _dest:  destination d_string.
-  _src:   source C string.
-  _count: maximum number of characters to copy.
-Return:
-  An integer value corresponding to either:
-  - 0, if copy was successful, or
-  - EINVAL, if either parameter was NULL.
+d_string_internal_parse_spec
+  Parses the conversion specification following a '%' at `_p`, fetching any
+'*' width or precision from `_args`. Returns a pointer past the conversion
+character, or NULL if the specification uses positional arguments or is not
+one this engine understands.
 */
-int
-d_string_ncopy_cstr_s
+static const char*
+d_string_internal_parse_spec
 (
-    struct d_string* restrict _dest,
-    const char* restrict      _src,
-    size_t                    _count
+    const char*                    _p,
+    struct d_string_internal_spec* _spec,
+    va_list*                       _args
 )
 {
-    size_t copy_len;
+    int value;
 
-    if ( (_dest == NULL) || 
-         (_src == NULL) )
+    _spec->flags     = 0;
+    _spec->width     = -1;
+    _spec->precision = -1;
+    _spec->length    = 0;
+
+    // flags
+    for (;; _p++)
     {
-        return EINVAL;
-    }
+        switch (*_p)
+        {
+            case '-':  _spec->flags |= D_STRING_FMT_MINUS; continue;
+            case '0':  _spec->flags |= D_STRING_FMT_ZERO;  continue;
+            case '+':  _spec->flags |= D_STRING_FMT_PLUS;  continue;
+            case ' ':  _spec->flags |= D_STRING_FMT_SPACE; continue;
+            case '#':  _spec->flags |= D_STRING_FMT_HASH;  continue;
+            case '\'': _spec->flags |= D_STRING_FMT_GROUP; continue;
+            default:   break;
+        }
 
-    copy_len = d_strnlen(_src, _count);
+        break;
+    }
 
-    if (!d_string_internal_grow(_dest, copy_len + 1))
+    // width
+    if (*_p == '*')
     {
-        return ERANGE;
+        value = va_arg(*_args, int);
+        _p++;
+
+        if (value < 0)
+        {
+            _spec->flags |= D_STRING_FMT_MINUS;
+            value         = (value == INT_MIN) ? INT_MAX : -value;
+        }
+
+        _spec->width = value;
     }
+    else if ( (*_p >= '1') &&
+              (*_p <= '9') )
+    {
+        value = 0;
 
-    d_memcpy(_dest->text, _src, copy_len);
-    _dest->text[copy_len] = '\0';
-    _dest->size           = copy_len;
+        while ( (*_p >= '0') &&
+                (*_p <= '9') )
+        {
+            if (value > ((INT_MAX - 9) / 10))
+            {
+                return NULL;
+            }
 
-    return 0;
-}
+            value = (value * 10) + (*_p++ - '0');
+        }
 
-/*
-d_string_to_buffer_s
-  Safe copy from d_string to char buffer.
+        // "%1$d": positional arguments cannot be consumed in order
+        if (*_p == '$')
+        {
+            return NULL;
+        }
 
-Parameter(s):
-  _dest:      destination buffer.
-  _dest_size: size of destination buffer.
-  _src:       source d_string.
-Return:
-  An integer value corresponding to either:
-  - 0, if copy was successful, or
-  - EINVAL, if _dest or _src was NULL, or
-  - ERANGE, if destination buffer is too small.
-*/
-int
-d_string_to_buffer_s
-(
-    char* restrict                  _dest,
-    size_t                          _dest_size,
-    const struct d_string* restrict _src
-)
-{
-    if ( (_dest == NULL) || 
-         (_src == NULL) )
-    {
-        return EINVAL;
+        _spec->width = value;
     }
 
-    if (_dest_size == 0)
+    // precision
+    if (*_p == '.')
     {
-        return ERANGE;
+        _p++;
+
+        if (*_p == '*')
+        {
+            value = va_arg(*_args, int);
+            _p++;
+
+            _spec->precision = (value < 0) ? -1 : value;
+        }
+        else
+        {
+            value = 0;
+
+            while ( (*_p >= '0') &&
+                    (*_p <= '9') )
+            {
+                if (value > ((INT_MAX - 9) / 10))
+                {
+                    return NULL;
+                }
+
+                value = (value * 10) + (*_p++ - '0');
+            }
+
+            _spec->precision = value;
+        }
     }
 
-    if (_src->size >= _dest_size)
+    // length modifier
+    switch (*_p)
     {
-        _dest[0] = '\0';
-
-        return ERANGE;
+        case 'h':
+            _spec->length = (_p[1] == 'h') ? 'H' : 'h';
+            _p           += (_p[1] == 'h') ? 2 : 1;
+            break;
+        case 'l':
+            _spec->length = (_p[1] == 'l') ? 'q' : 'l';
+            _p           += (_p[1] == 'l') ? 2 : 1;
+            break;
+        case 'j':
+        case 'z':
+        case 't':
+        case 'L':
+            _spec->length = *_p++;
+            break;
+        default:
+            break;
     }
 
-    d_memcpy(_dest, _src->text, _src->size + 1);
+    _spec->conv = *_p;
 
-    return 0;
+    switch (_spec->conv)
+    {
+        case 'd': case 'i': case 'u': case 'o': case 'x': case 'X':
+        case 'c': case 's': case 'p': case 'n': case '%':
+        case 'f': case 'F': case 'e': case 'E': case 'g': case 'G':
+        case 'a': case 'A':
+            return _p + 1;
+        default:
+            return NULL;
+    }
 }
 
-
-/******************************************************************************
-* Concatenation Functions
-******************************************************************************/
-
 /*
-d_string_cat_s
-  Safe concatenation of d_string to d_string.
-
-Parameter(s):
-  _dest: destination d_string.
-  _src:  source d_string to append.
-Return:
-  An integer value corresponding to either:
-  - 0, if concatenation was successful, or
-  - EINVAL, if either parameter was NULL.
+d_string_internal_fetch_signed
+  Fetches a signed integer argument of the spec's length from `_args`.
 */
-int
-d_string_cat_s
+static intmax_t
+d_string_internal_fetch_signed
 (
-    struct d_string* restrict       _dest,
-    const struct d_string* restrict _src
+    const struct d_string_internal_spec* _spec,
+    va_list*                             _args
 )
 {
-    size_t new_size;
-
-    if ( (_dest == NULL) || 
-         (_src == NULL) )
+    switch (_spec->length)
     {
-        return EINVAL;
+        case 'H': return (signed char)va_arg(*_args, int);
+        case 'h': return (short)va_arg(*_args, int);
+        case 'l': return va_arg(*_args, long);
+        case 'q': return va_arg(*_args, long long);
+        case 'j': return va_arg(*_args, intmax_t);
+        case 'z': return va_arg(*_args, ssize_t);
+        case 't': return va_arg(*_args, ptrdiff_t);
+        default:  return va_arg(*_args, int);
     }
+}
 
-    new_size = _dest->size + _src->size;
-
-    if (!d_string_internal_grow(_dest, new_size + 1))
+/*
+d_string_internal_fetch_unsigned
+  Fetches an unsigned integer argument of the spec's length from `_args`.
+*/
+static uintmax_t
+d_string_internal_fetch_unsigned
+(
+    const struct d_string_internal_spec* _spec,
+    va_list*                             _args
+)
+{
+    switch (_spec->length)
     {
-        return ERANGE;
+        case 'H': return (unsigned char)va_arg(*_args, unsigned int);
+        case 'h': return (unsigned short)va_arg(*_args, unsigned int);
+        case 'l': return va_arg(*_args, unsigned long);
+        case 'q': return va_arg(*_args, unsigned long long);
+        case 'j': return va_arg(*_args, uintmax_t);
+        case 'z': return va_arg(*_args, size_t);
+        case 't': return (size_t)va_arg(*_args, ptrdiff_t);
+        default:  return va_arg(*_args, unsigned int);
     }
-
-    d_memcpy(_dest->text + _dest->size, _src->text, _src->size + 1);
-    _dest->size = new_size;
-
-    return 0;
 }
 
 /*
-d_string_cat_cstr_s
-  Safe concatenation of C string to d_string.
-
-Parameter(s):
-  _dest: destination d_string.
-  _src:  source C string to append.
-Return:
-  An integer value corresponding to either:
-  - 0, if concatenation was successful, or
-  - EINVAL, if either parameter was NULL.
+d_string_internal_spec_format
+  Rebuilds a single-conversion format string for `_spec` into `_buf`, with
+any '*' width or precision already resolved to a number.
 */
-int
-d_string_cat_cstr_s
+static void
+d_string_internal_spec_format
 (
-    struct d_string* restrict _dest,
-    const char* restrict      _src
+    const struct d_string_internal_spec* _spec,
+    char*                                _buf
 )
 {
-    size_t src_len;
-    size_t new_size;
+    char* p;
 
-    if ( (_dest == NULL) || 
-         (_src == NULL) )
+    p    = _buf;
+    *p++ = '%';
+
+    if (_spec->flags & D_STRING_FMT_MINUS) *p++ = '-';
+    if (_spec->flags & D_STRING_FMT_ZERO)  *p++ = '0';
+    if (_spec->flags & D_STRING_FMT_PLUS)  *p++ = '+';
+    if (_spec->flags & D_STRING_FMT_SPACE) *p++ = ' ';
+    if (_spec->flags & D_STRING_FMT_HASH)  *p++ = '#';
+    if (_spec->flags & D_STRING_FMT_GROUP) *p++ = '\'';
+
+    if (_spec->width >= 0)
     {
-        return EINVAL;
+        p += sprintf(p, "%d", _spec->width);
     }
 
-    src_len  = strlen(_src);
-    new_size = _dest->size + src_len;
+    if (_spec->precision >= 0)
+    {
+        p += sprintf(p, ".%d", _spec->precision);
+    }
 
-    if (!d_string_internal_grow(_dest, new_size + 1))
+    switch (_spec->length)
     {
-        return ERANGE;
+        case 'H': *p++ = 'h'; *p++ = 'h'; break;
+        case 'q': *p++ = 'l'; *p++ = 'l'; break;
+        case 0:   break;
+        default:  *p++ = _spec->length; break;
     }
 
-    d_memcpy(_dest->text + _dest->size, _src, src_len + 1);
-    _dest->size = new_size;
+    *p++ = _spec->conv;
+    *p   = '\0';
 
-    return 0;
+    return;
 }
 
 /*
-d_string_ncat_s
-  Safe bounded concatenation of d_string to d_string.
-
-Parameter(s):
-  _dest:  destination d_string.
-  _src:   source d_string to append.
-  _count: maximum number of characters to append.
-Return:
-  An integer value corresponding to either:
-  - 0, if concatenation was successful, or
-  - EINVAL, if either parameter was NULL.
+d_string_internal_emit_libc
+  Formats one conversion through vsnprintf. Used for conversions, and
+flag combinations, that the engine does not render itself.
 */
-int
-d_string_ncat_s
+static bool
+d_string_internal_emit_libc
 (
-    struct d_string* restrict       _dest,
-    const struct d_string* restrict _src,
-    size_t                          _count
+    struct d_string*                     _str,
+    const struct d_string_internal_spec* _spec,
+    va_list*                             _args
 )
 {
-    size_t append_len;
-    size_t new_size;
+    char format[48];
 
-    if ( (_dest == NULL) || 
-         (_src == NULL) )
+    d_string_internal_spec_format(_spec, format);
+
+    switch (_spec->conv)
     {
-        return EINVAL;
-    }
+        case 'd':
+        case 'i':
+            switch (_spec->length)
+            {
+                case 'l': return d_string_internal_snprintf(_str, format, va_arg(*_args, long));
+                case 'q': return d_string_internal_snprintf(_str, format, va_arg(*_args, long long));
+                case 'j': return d_string_internal_snprintf(_str, format, va_arg(*_args, intmax_t));
+                case 'z': return d_string_internal_snprintf(_str, format, va_arg(*_args, ssize_t));
+                case 't': return d_string_internal_snprintf(_str, format, va_arg(*_args, ptrdiff_t));
+                default:  return d_string_internal_snprintf(_str, format, va_arg(*_args, int));
+            }
+        case 'u':
+        case 'o':
+        case 'x':
+        case 'X':
+            switch (_spec->length)
+            {
+                case 'l': return d_string_internal_snprintf(_str, format, va_arg(*_args, unsigned long));
+                case 'q': return d_string_internal_snprintf(_str, format, va_arg(*_args, unsigned long long));
+                case 'j': return d_string_internal_snprintf(_str, format, va_arg(*_args, uintmax_t));
+                case 'z': return d_string_internal_snprintf(_str, format, va_arg(*_args, size_t));
+                case 't': return d_string_internal_snprintf(_str, format, va_arg(*_args, ptrdiff_t));
+                default:  return d_string_internal_snprintf(_str, format, va_arg(*_args, unsigned int));
+            }
+        case 'c':
+            if (_spec->length == 'l')
+            {
+                return d_string_internal_snprintf(_str, format, va_arg(*_args, wint_t));
+            }
 
-    append_len = (_count < _src->size) ? _count : _src->size;
-    new_size   = _dest->size + append_len;
+            return d_string_internal_snprintf(_str, format, va_arg(*_args, int));
+        case 's':
+            if (_spec->length == 'l')
+            {
+                return d_string_internal_snprintf(_str, format, va_arg(*_args, const wchar_t*));
+            }
 
-    if (!d_string_internal_grow(_dest, new_size + 1))
-    {
-        return ERANGE;
+            return d_string_internal_snprintf(_str, format, va_arg(*_args, const char*));
+        case 'p':
+            return d_string_internal_snprintf(_str, format, va_arg(*_args, void*));
+        default:
+            // floating point
+            if (_spec->length == 'L')
+            {
+                return d_string_internal_snprintf(_str, format, va_arg(*_args, long double));
+            }
+
+            return d_string_internal_snprintf(_str, format, va_arg(*_args, double));
     }
+}
 
-    d_memcpy(_dest->text + _dest->size, _src->text, append_len);
-    _dest->size            = new_size;
-    _dest->text[new_size]  = '\0';
+/*
+d_string_internal_store_count
+  Handles %n: stores the number of characters formatted so far.
+*/
+static void
+d_string_internal_store_count
+(
+    const struct d_string_internal_spec* _spec,
+    va_list*                             _args,
+    size_t                               _count
+)
+{
+    switch (_spec->length)
+    {
+        case 'H': *va_arg(*_args, signed char*) = (signed char)_count; break;
+        case 'h': *va_arg(*_args, short*)       = (short)_count;       break;
+        case 'l': *va_arg(*_args, long*)        = (long)_count;        break;
+        case 'q': *va_arg(*_args, long long*)   = (long long)_count;   break;
+        case 'j': *va_arg(*_args, intmax_t*)    = (intmax_t)_count;    break;
+        case 'z': *va_arg(*_args, ssize_t*)     = (ssize_t)_count;     break;
+        case 't': *va_arg(*_args, ptrdiff_t*)   = (ptrdiff_t)_count;   break;
+        default:  *va_arg(*_args, int*)         = (int)_count;         break;
+    }
 
-    return 0;
+    return;
 }
 
 /*
-d_string_ncat_cstr_s
-  Safe bounded concatenation of C string to d_string.
+d_string_internal_emit
+  Appends one parsed conversion. Integers (%d %i %u %o %x %X), strings (%s),
+characters (%c) and %% are rendered directly, without libc's locale-aware
+machinery; other conversions and flag combinations go through vsnprintf.
+*/
+static bool
+d_string_internal_emit
+(
+    struct d_string*                     _str,
+    const struct d_string_internal_spec* _spec,
+    va_list*                             _args,
+    size_t                               _start
+)
+{
+    char        digits[3 * sizeof(uintmax_t)];
+    char*       end;
+    char*       body;
+    const char* s;
+    char        sign;
+    intmax_t    sv;
+    uintmax_t   uv;
+    size_t      n;
+
+    end = digits + sizeof(digits);
+
+    switch (_spec->conv)
+    {
+        case 'd':
+        case 'i':
+            if ( (_spec->precision >= 0) ||
+                 (_spec->flags & (D_STRING_FMT_PLUS  |
+                                  D_STRING_FMT_SPACE |
+                                  D_STRING_FMT_GROUP)) )
+            {
+                return d_string_internal_emit_libc(_str, _spec, _args);
+            }
 
-Parameter(s):
-  _dest:  destination d_string.
-  _src:   source C string to append.
-  _count: maximum number of characters to append.
-Return:
-  An integer value corresponding to either:
-  - 0, if concatenation was successful, or
-  - EINVAL, if either parameter was NULL.
+            sv   = d_string_internal_fetch_signed(_spec, _args);
+            sign = '-';
+            uv   = (sv < 0) ? ((uintmax_t)0 - (uintmax_t)sv) : (uintmax_t)sv;
+            body = d_string_internal_utoa(uv, end, 10, false);
+
+            return d_string_internal_emit_padded(_str,
+                                                 _spec,
+                                                 &sign,
+                                                 (sv < 0) ? 1 : 0,
+                                                 body,
+                                                 (size_t)(end - body),
+                                                 true);
+
+        case 'u':
+        case 'o':
+        case 'x':
+        case 'X':
+            if ( (_spec->precision >= 0) ||
+                 (_spec->flags & (D_STRING_FMT_HASH | D_STRING_FMT_GROUP)) )
+            {
+                return d_string_internal_emit_libc(_str, _spec, _args);
+            }
+
+            uv   = d_string_internal_fetch_unsigned(_spec, _args);
+            body = d_string_internal_utoa(uv,
+                                          end,
+                                          (_spec->conv == 'u') ? 10u :
+                                          (_spec->conv == 'o') ? 8u : 16u,
+                                          (_spec->conv == 'X'));
+
+            return d_string_internal_emit_padded(_str,
+                                                 _spec,
+                                                 NULL,
+                                                 0,
+                                                 body,
+                                                 (size_t)(end - body),
+                                                 true);
+
+        case 's':
+            if (_spec->length == 'l')
+            {
+                return d_string_internal_emit_libc(_str, _spec, _args);
+            }
+
+            s = va_arg(*_args, const char*);
+
+            if (s == NULL)
+            {
+                s = "(null)";
+            }
+
+            n = (_spec->precision >= 0) ? d_strnlen(s, (size_t)_spec->precision)
+                                        : strlen(s);
+
+            // fast path: no padding
+            if (_spec->width <= 0)
+            {
+                return d_string_internal_put(_str, s, n);
+            }
+
+            return d_string_internal_emit_padded(_str,
+                                                 _spec,
+                                                 NULL,
+                                                 0,
+                                                 s,
+                                                 n,
+                                                 false);
+
+        case 'c':
+            if (_spec->length == 'l')
+            {
+                return d_string_internal_emit_libc(_str, _spec, _args);
+            }
+
+            digits[0] = (char)va_arg(*_args, int);
+
+            return d_string_internal_emit_padded(_str,
+                                                 _spec,
+                                                 NULL,
+                                                 0,
+                                                 digits,
+                                                 1,
+                                                 false);
+
+        case '%':
+            return d_string_internal_put(_str, "%", 1);
+
+        case 'n':
+            d_string_internal_store_count(_spec, _args, _str->size - _start);
+
+            return true;
+
+        default:
+            return d_string_internal_emit_libc(_str, _spec, _args);
+    }
+}
+
+/*
+d_string_internal_vformat
+  Appends printf-style formatted text to a d_string in a single pass,
+writing directly into its spare capacity and growing only when the output
+actually overflows it. Formats the engine cannot process in order (such as
+positional arguments) are handed to vsnprintf whole. On failure the string
+is restored to its original contents.
+  Returns the number of characters appended, or -1 on error.
 */
-int
-d_string_ncat_cstr_s
+static int
+d_string_internal_vformat
 (
-    struct d_string* restrict _dest,
-    const char* restrict      _src,
-    size_t                    _count
+    struct d_string* _str,
+    const char*      _format,
+    va_list          _args
 )
 {
-    size_t append_len;
-    size_t new_size;
+    struct d_string_internal_spec spec;
+    va_list                       args;
+    va_list                       restart;
+    const char*                   p;
+    const char*                   next;
+    size_t                        start;
+    int                           len;
 
-    if ( (_dest == NULL) || 
-         (_src == NULL) )
+    start = _str->size;
+    p     = _format;
+
+    va_copy(args, _args);
+    va_copy(restart, _args);
+
+    while (*p != '\0')
     {
-        return EINVAL;
+        // copy the literal run up to the next conversion
+        next = strchr(p, '%');
+
+        if (next == NULL)
+        {
+            next = p + strlen(p);
+        }
+
+        if ( (next != p) &&
+             (!d_string_internal_put(_str, p, (size_t)(next - p))) )
+        {
+            goto fail;
+        }
+
+        if (*next == '\0')
+        {
+            break;
+        }
+
+        p = d_string_internal_parse_spec(next + 1, &spec, &args);
+
+        if (p == NULL)
+        {
+            goto whole;
+        }
+
+        if (!d_string_internal_emit(_str, &spec, &args, start))
+        {
+            goto fail;
+        }
     }
 
-    append_len = d_strnlen(_src, _count);
-    new_size   = _dest->size + append_len;
+    va_end(args);
+    va_end(restart);
 
-    if (!d_string_internal_grow(_dest, new_size + 1))
+    if ((_str->size - start) > (size_t)INT_MAX)
     {
-        return ERANGE;
+        _str->size = start;
+        _str->text[start] = '\0';
+
+        return -1;
     }
 
-    d_memcpy(_dest->text + _dest->size, _src, append_len);
-    _dest->size            = new_size;
-    _dest->text[new_size]  = '\0';
+    _str->text[_str->size] = '\0';
 
-    return 0;
+    return (int)(_str->size - start);
+
+whole:
+    // restart from the beginning with libc's own two-pass formatting
+    va_end(args);
+    _str->size = start;
+    va_copy(args, restart);
+
+    len = vsnprintf(NULL, 0, _format, args);
+    va_end(args);
+
+    if ( (len >= 0) &&
+         (d_string_internal_grow(_str,
+                                 start + (size_t)len + 1,
+                                 D_STRING_INTERNAL_SITE)) )
+    {
+        vsnprintf(_str->text + start, (size_t)len + 1, _format, restart);
+        va_end(restart);
+
+        _str->size = start + (size_t)len;
+
+        return len;
+    }
+
+    va_end(restart);
+    _str->text[start] = '\0';
+
+    return -1;
+
+fail:
+    va_end(args);
+    va_end(restart);
+
+    _str->size = start;
+
+    if (_str->text != NULL)
+    {
+        _str->text[start] = '\0';
+    }
+
+    return -1;
 }
 
 
 /******************************************************************************
-* Duplication Functions
+* Internal Classification Engine
 ******************************************************************************/
 
-/*
-d_string_dup
-  Duplicate a d_string.
+// D_STRING_CLASS_*
+//   constant: compile-time selection of the vector kernels behind the
+// character-class predicates, `d_string_count_char`, UTF-8 validation, the
+// in-place transformations (case mapping, byte replacement, trimming,
+// reversal and `d_string_normalize`) and the substring search filter.
+// D_STRING_CLASS_AVX2_DISPATCH is set for GCC/Clang x86 builds that do not
+// target AVX2 themselves; AVX2 kernels are then compiled alongside the
+// baseline ones and chosen at run time when the CPU supports them (see
+// "Internal Kernel Dispatch").
+#if defined(__AVX2__)
+    #define D_STRING_CLASS_AVX2          1
+#elif ( defined(__SSE2__) || defined(_M_X64) ||                   \
+        (defined(_M_IX86_FP) && (_M_IX86_FP >= 2)) )
+    #define D_STRING_CLASS_SSE2          1
+#elif ( defined(__ARM_NEON) || defined(__ARM_NEON__) )
+    #define D_STRING_CLASS_NEON          1
+#endif
 
-Parameter(s):
-  _str: d_string to duplicate.
-Return:
-  A pointer value corresponding to either:
-  - newly allocated copy, if successful, or
-  - NULL, if _str was NULL or allocation failed.
+#if ( defined(D_STRING_CLASS_SSE2) &&                             \
+      D_ENV_CPU_DISPATCH_X86 )
+    #define D_STRING_CLASS_AVX2_DISPATCH 1
+    #define D_STRING_CLASS_AVX2_FN       D_ENV_CPU_TARGET_AVX2
+#else
+    #define D_STRING_CLASS_AVX2_FN
+#endif
+
+// D_STRING_INTERNAL_CLASS_*
+//   flags: ASCII character classes tested by the classification kernels.
+// Classes follow the "C" locale; bytes >= 0x80 belong to none of them.
+#define D_STRING_INTERNAL_CLASS_DIGIT 0x01u   // '0'-'9'
+#define D_STRING_INTERNAL_CLASS_ALPHA 0x02u   // 'A'-'Z', 'a'-'z'
+#define D_STRING_INTERNAL_CLASS_SPACE 0x04u   // ' ', '\t', '\n', '\v', '\f', '\r'
+#define D_STRING_INTERNAL_CLASS_ALNUM \
+    (D_STRING_INTERNAL_CLASS_DIGIT | D_STRING_INTERNAL_CLASS_ALPHA)
+
+/*
+d_string_internal_class_byte
+  Returns true if byte `_c` belongs to any of the classes in `_cls`.
 */
-struct d_string*
-d_string_dup
+static D_INLINE bool
+d_string_internal_class_byte
 (
-    const struct d_string* _str
+    unsigned char _c,
+    unsigned      _cls
 )
 {
-    return d_string_new_copy(_str);
+    return ( ( (_cls & D_STRING_INTERNAL_CLASS_DIGIT) &&
+               ((unsigned)(_c - '0') < 10u) ) ||
+             ( (_cls & D_STRING_INTERNAL_CLASS_ALPHA) &&
+               ((unsigned)((_c | 0x20u) - 'a') < 26u) ) ||
+             ( (_cls & D_STRING_INTERNAL_CLASS_SPACE) &&
+               ( (_c == ' ') ||
+                 ((unsigned)(_c - '\t') < 5u) ) ) );
 }
 
 /*
-d_string_ndup
-  Duplicate at most n characters of a d_string.
-
-Parameter(s):
-  _str: d_string to duplicate.
-  _n:   maximum number of characters to copy.
-Return:
-  A pointer value corresponding to either:
-  - newly allocated copy, if successful, or
-  - NULL, if _str was NULL or allocation failed.
+d_string_internal_all_class_scalar
+  Returns true if every byte of `_p[0.._n)` belongs to a class in `_cls`.
 */
-struct d_string*
-d_string_ndup
+static bool
+d_string_internal_all_class_scalar
 (
-    const struct d_string* _str,
-    size_t                 _n
+    const unsigned char* _p,
+    size_t               _n,
+    unsigned             _cls
 )
 {
-    size_t copy_len;
+    size_t i;
 
-    if (_str == NULL)
+    for (i = 0; i < _n; i++)
     {
-        return NULL;
+        if (!d_string_internal_class_byte(_p[i], _cls))
+        {
+            return false;
+        }
     }
 
-    copy_len = (_n < _str->size) ? _n : _str->size;
-
-    return d_string_new_from_buffer(_str->text, copy_len);
+    return true;
 }
 
 /*
-d_string_substr
-  Extract substring from d_string.
-
-Parameter(s):
-  _str:    source d_string.
-  _start:  starting index (negative counts from end).
-  _length: number of characters to extract.
-Return:
-  A pointer value corresponding to either:
-  - newly allocated substring, if successful, or
-  - NULL, if _str was NULL or index was invalid.
+d_string_internal_count_scalar
+  Counts the bytes `b` of `_p[0.._n)` for which `(b & _mask) == _value`.
 */
-struct d_string*
-d_string_substr
+static size_t
+d_string_internal_count_scalar
 (
-    const struct d_string* _str,
-    d_index                _start,
-    size_t                 _length
+    const unsigned char* _p,
+    size_t               _n,
+    unsigned char        _mask,
+    unsigned char        _value
 )
 {
-    size_t start_pos;
-    size_t actual_len;
+    size_t count;
+    size_t i;
 
-    if (_str == NULL)
+    count = 0;
+
+    for (i = 0; i < _n; i++)
     {
-        return NULL;
+        count += ((_p[i] & _mask) == _value);
     }
 
-    if (!d_index_convert_safe(_start, _str->size, &start_pos))
-    {
-        return NULL;
-    }
+    return count;
+}
 
-    // clamp length to available characters
-    actual_len = _length;
+/*
+d_string_internal_ascii_scalar
+  Returns true if no byte of `_p[0.._n)` has its high bit set, testing eight
+bytes per step.
+*/
+static bool
+d_string_internal_ascii_scalar
+(
+    const unsigned char* _p,
+    size_t               _n
+)
+{
+    uint64_t word;
+    uint64_t acc;
+    size_t   i;
 
-    if (start_pos + actual_len > _str->size)
+    acc = 0;
+
+    for (i = 0; (i + 8) <= _n; i += 8)
     {
-        actual_len = _str->size - start_pos;
+        memcpy(&word, _p + i, sizeof(word));
+        acc |= word;
     }
 
-    return d_string_new_from_buffer(_str->text + start_pos, actual_len);
-}
-
+    for (; i < _n; i++)
+    {
+        acc |= _p[i];
+    }
 
-/******************************************************************************
-* Comparison Functions
-******************************************************************************/
+    return ((acc & 0x8080808080808080ULL) == 0);
+}
 
 /*
-d_string_cmp
-  Compare two d_strings.
-
-Parameter(s):
-  _s1: first d_string.
-  _s2: second d_string.
-Return:
-  An integer value indicating relationship:
-  - negative if _s1 < _s2,
-  - zero if _s1 == _s2, or
-  - positive if _s1 > _s2.
+d_string_internal_utf8_scalar
+  Validates `_p[0.._n)` as UTF-8 following the well-formed byte sequences of
+the Unicode Standard (Table 3-7): no overlong forms, no surrogates, nothing
+above U+10FFFF, and no truncated sequences. Runs of ASCII are skipped eight
+bytes at a time.
 */
-int
-d_string_cmp
+static bool
+d_string_internal_utf8_scalar
 (
-    const struct d_string* _s1,
-    const struct d_string* _s2
+    const unsigned char* _p,
+    size_t               _n
 )
 {
-    size_t min_len;
-    int    result;
+    uint64_t      word;
+    size_t        i;
+    unsigned char c;
+    unsigned char lo;
+    unsigned char hi;
 
-    if ( (_s1 == NULL) && 
-         (_s2 == NULL) )
-    {
-        return 0;
-    }
+    i = 0;
 
-    if (_s1 == NULL)
+    while (i < _n)
     {
-        return -1;
-    }
+        while ((i + 8) <= _n)
+        {
+            memcpy(&word, _p + i, sizeof(word));
 
-    if (_s2 == NULL)
-    {
-        return 1;
-    }
+            if (word & 0x8080808080808080ULL)
+            {
+                break;
+            }
 
-    min_len = (_s1->size < _s2->size) ? _s1->size : _s2->size;
-    result  = memcmp(_s1->text, _s2->text, min_len);
+            i += 8;
+        }
 
-    if (result != 0)
-    {
-        return result;
-    }
+        if (i >= _n)
+        {
+            break;
+        }
 
-    // strings equal up to min_len, compare lengths
-    if (_s1->size < _s2->size)
-    {
-        return -1;
-    }
+        c = _p[i];
 
-    if (_s1->size > _s2->size)
-    {
-        return 1;
+        if (c < 0x80)
+        {
+            i++;
+
+            continue;
+        }
+
+        // 2-byte sequence: C2..DF 80..BF
+        if ( (c >= 0xC2) &&
+             (c <= 0xDF) )
+        {
+            if ( ((_n - i) < 2) ||
+                 ((_p[i + 1] & 0xC0) != 0x80) )
+            {
+                return false;
+            }
+
+            i += 2;
+
+            continue;
+        }
+
+        lo = 0x80;
+        hi = 0xBF;
+
+        // 3-byte sequence: E0 A0..BF, ED 80..9F, else E1..EF 80..BF
+        if ( (c >= 0xE0) &&
+             (c <= 0xEF) )
+        {
+            lo = (c == 0xE0) ? 0xA0 : lo;
+            hi = (c == 0xED) ? 0x9F : hi;
+
+            if ( ((_n - i) < 3)     ||
+                 (_p[i + 1] < lo)   ||
+                 (_p[i + 1] > hi)   ||
+                 ((_p[i + 2] & 0xC0) != 0x80) )
+            {
+                return false;
+            }
+
+            i += 3;
+
+            continue;
+        }
+
+        // 4-byte sequence: F0 90..BF, F4 80..8F, else F1..F3 80..BF
+        if ( (c >= 0xF0) &&
+             (c <= 0xF4) )
+        {
+            lo = (c == 0xF0) ? 0x90 : lo;
+            hi = (c == 0xF4) ? 0x8F : hi;
+
+            if ( ((_n - i) < 4)                 ||
+                 (_p[i + 1] < lo)               ||
+                 (_p[i + 1] > hi)               ||
+                 ((_p[i + 2] & 0xC0) != 0x80)   ||
+                 ((_p[i + 3] & 0xC0) != 0x80) )
+            {
+                return false;
+            }
+
+            i += 4;
+
+            continue;
+        }
+
+        // stray continuation byte, C0/C1, or F5..FF
+        return false;
     }
 
-    return 0;
+    return true;
 }
 
-/*
-d_string_cmp_cstr
-  Compare d_string to C string.
+// D_STRING_INTERNAL_UTF8_*
+//   flags: error classes of the vectorized UTF-8 validator (Keiser & Lemire,
+// "Validating UTF-8 In Less Than One Instruction Per Byte"). Each byte pair
+// is looked up by the high and low nibble of its first byte and the high
+// nibble of its second; the pair is invalid iff all three lookups share a bit.
+#define D_STRING_INTERNAL_UTF8_TOO_SHORT    (1u << 0)
+#define D_STRING_INTERNAL_UTF8_TOO_LONG     (1u << 1)
+#define D_STRING_INTERNAL_UTF8_OVERLONG_3   (1u << 2)
+#define D_STRING_INTERNAL_UTF8_TOO_LARGE    (1u << 3)
+#define D_STRING_INTERNAL_UTF8_SURROGATE    (1u << 4)
+#define D_STRING_INTERNAL_UTF8_OVERLONG_2   (1u << 5)
+#define D_STRING_INTERNAL_UTF8_TOO_LARGE_2  (1u << 6)
+#define D_STRING_INTERNAL_UTF8_OVERLONG_4   (1u << 6)
+#define D_STRING_INTERNAL_UTF8_TWO_CONTS    (1u << 7)
+#define D_STRING_INTERNAL_UTF8_CARRY                                  \
+    ( D_STRING_INTERNAL_UTF8_TOO_SHORT |                              \
+      D_STRING_INTERNAL_UTF8_TOO_LONG  |                              \
+      D_STRING_INTERNAL_UTF8_TWO_CONTS )
+
+// d_string_internal_utf8_tables
+//   constant: the three nibble lookup tables of the vectorized validator:
+// first byte high nibble, first byte low nibble, second byte high nibble.
+static const unsigned char d_string_internal_utf8_tables[3][16] =
+{
+    {
+        // 0xxx: ASCII first byte
+        D_STRING_INTERNAL_UTF8_TOO_LONG,
+        D_STRING_INTERNAL_UTF8_TOO_LONG,
+        D_STRING_INTERNAL_UTF8_TOO_LONG,
+        D_STRING_INTERNAL_UTF8_TOO_LONG,
+        D_STRING_INTERNAL_UTF8_TOO_LONG,
+        D_STRING_INTERNAL_UTF8_TOO_LONG,
+        D_STRING_INTERNAL_UTF8_TOO_LONG,
+        D_STRING_INTERNAL_UTF8_TOO_LONG,
+        // 10xx: continuation first byte
+        D_STRING_INTERNAL_UTF8_TWO_CONTS,
+        D_STRING_INTERNAL_UTF8_TWO_CONTS,
+        D_STRING_INTERNAL_UTF8_TWO_CONTS,
+        D_STRING_INTERNAL_UTF8_TWO_CONTS,
+        // 1100: two-byte lead, C0/C1 overlong
+        D_STRING_INTERNAL_UTF8_TOO_SHORT | D_STRING_INTERNAL_UTF8_OVERLONG_2,
+        // 1101: two-byte lead
+        D_STRING_INTERNAL_UTF8_TOO_SHORT,
+        // 1110: three-byte lead
+        D_STRING_INTERNAL_UTF8_TOO_SHORT  |
+        D_STRING_INTERNAL_UTF8_OVERLONG_3 |
+        D_STRING_INTERNAL_UTF8_SURROGATE,
+        // 1111: four-byte lead
+        D_STRING_INTERNAL_UTF8_TOO_SHORT   |
+        D_STRING_INTERNAL_UTF8_TOO_LARGE   |
+        D_STRING_INTERNAL_UTF8_TOO_LARGE_2 |
+        D_STRING_INTERNAL_UTF8_OVERLONG_4
+    },
+    {
+        // xxxx0000
+        D_STRING_INTERNAL_UTF8_CARRY      |
+        D_STRING_INTERNAL_UTF8_OVERLONG_3 |
+        D_STRING_INTERNAL_UTF8_OVERLONG_2 |
+        D_STRING_INTERNAL_UTF8_OVERLONG_4,
+        // xxxx0001
+        D_STRING_INTERNAL_UTF8_CARRY | D_STRING_INTERNAL_UTF8_OVERLONG_2,
+        // xxxx001x
+        D_STRING_INTERNAL_UTF8_CARRY,
+        D_STRING_INTERNAL_UTF8_CARRY,
+        // xxxx0100
+        D_STRING_INTERNAL_UTF8_CARRY | D_STRING_INTERNAL_UTF8_TOO_LARGE,
+        // xxxx0101 .. xxxx1100
+        D_STRING_INTERNAL_UTF8_CARRY     |
+        D_STRING_INTERNAL_UTF8_TOO_LARGE |
+        D_STRING_INTERNAL_UTF8_TOO_LARGE_2,
+        D_STRING_INTERNAL_UTF8_CARRY     |
+        D_STRING_INTERNAL_UTF8_TOO_LARGE |
+        D_STRING_INTERNAL_UTF8_TOO_LARGE_2,
+        D_STRING_INTERNAL_UTF8_CARRY     |
+        D_STRING_INTERNAL_UTF8_TOO_LARGE |
+        D_STRING_INTERNAL_UTF8_TOO_LARGE_2,
+        D_STRING_INTERNAL_UTF8_CARRY     |
+        D_STRING_INTERNAL_UTF8_TOO_LARGE |
+        D_STRING_INTERNAL_UTF8_TOO_LARGE_2,
+        D_STRING_INTERNAL_UTF8_CARRY     |
+        D_STRING_INTERNAL_UTF8_TOO_LARGE |
+        D_STRING_INTERNAL_UTF8_TOO_LARGE_2,
+        D_STRING_INTERNAL_UTF8_CARRY     |
+        D_STRING_INTERNAL_UTF8_TOO_LARGE |
+        D_STRING_INTERNAL_UTF8_TOO_LARGE_2,
+        D_STRING_INTERNAL_UTF8_CARRY     |
+        D_STRING_INTERNAL_UTF8_TOO_LARGE |
+        D_STRING_INTERNAL_UTF8_TOO_LARGE_2,
+        D_STRING_INTERNAL_UTF8_CARRY     |
+        D_STRING_INTERNAL_UTF8_TOO_LARGE |
+        D_STRING_INTERNAL_UTF8_TOO_LARGE_2,
+        // xxxx1101: ED, surrogates
+        D_STRING_INTERNAL_UTF8_CARRY       |
+        D_STRING_INTERNAL_UTF8_TOO_LARGE   |
+        D_STRING_INTERNAL_UTF8_TOO_LARGE_2 |
+        D_STRING_INTERNAL_UTF8_SURROGATE,
+        // xxxx111x
+        D_STRING_INTERNAL_UTF8_CARRY     |
+        D_STRING_INTERNAL_UTF8_TOO_LARGE |
+        D_STRING_INTERNAL_UTF8_TOO_LARGE_2,
+        D_STRING_INTERNAL_UTF8_CARRY     |
+        D_STRING_INTERNAL_UTF8_TOO_LARGE |
+        D_STRING_INTERNAL_UTF8_TOO_LARGE_2
+    },
+    {
+        // 0xxx: ASCII second byte
+        D_STRING_INTERNAL_UTF8_TOO_SHORT,
+        D_STRING_INTERNAL_UTF8_TOO_SHORT,
+        D_STRING_INTERNAL_UTF8_TOO_SHORT,
+        D_STRING_INTERNAL_UTF8_TOO_SHORT,
+        D_STRING_INTERNAL_UTF8_TOO_SHORT,
+        D_STRING_INTERNAL_UTF8_TOO_SHORT,
+        D_STRING_INTERNAL_UTF8_TOO_SHORT,
+        D_STRING_INTERNAL_UTF8_TOO_SHORT,
+        // 1000: continuation 80..8F
+        D_STRING_INTERNAL_UTF8_TOO_LONG    |
+        D_STRING_INTERNAL_UTF8_OVERLONG_2  |
+        D_STRING_INTERNAL_UTF8_TWO_CONTS   |
+        D_STRING_INTERNAL_UTF8_OVERLONG_3  |
+        D_STRING_INTERNAL_UTF8_TOO_LARGE_2 |
+        D_STRING_INTERNAL_UTF8_OVERLONG_4,
+        // 1001: continuation 90..9F
+        D_STRING_INTERNAL_UTF8_TOO_LONG   |
+        D_STRING_INTERNAL_UTF8_OVERLONG_2 |
+        D_STRING_INTERNAL_UTF8_TWO_CONTS  |
+        D_STRING_INTERNAL_UTF8_OVERLONG_3 |
+        D_STRING_INTERNAL_UTF8_TOO_LARGE,
+        // 101x: continuation A0..BF
+        D_STRING_INTERNAL_UTF8_TOO_LONG   |
+        D_STRING_INTERNAL_UTF8_OVERLONG_2 |
+        D_STRING_INTERNAL_UTF8_TWO_CONTS  |
+        D_STRING_INTERNAL_UTF8_SURROGATE  |
+        D_STRING_INTERNAL_UTF8_TOO_LARGE,
+        D_STRING_INTERNAL_UTF8_TOO_LONG   |
+        D_STRING_INTERNAL_UTF8_OVERLONG_2 |
+        D_STRING_INTERNAL_UTF8_TWO_CONTS  |
+        D_STRING_INTERNAL_UTF8_SURROGATE  |
+        D_STRING_INTERNAL_UTF8_TOO_LARGE,
+        // 11xx: lead second byte
+        D_STRING_INTERNAL_UTF8_TOO_SHORT,
+        D_STRING_INTERNAL_UTF8_TOO_SHORT,
+        D_STRING_INTERNAL_UTF8_TOO_SHORT,
+        D_STRING_INTERNAL_UTF8_TOO_SHORT
+    }
+};
+
+#if ( defined(D_STRING_CLASS_AVX2) ||                             \
+      defined(D_STRING_CLASS_AVX2_DISPATCH) )
 
-Parameter(s):
-  _s1: d_string.
-  _s2: C string.
-Return:
-  An integer value indicating relationship.
+/*
+d_string_internal_class_mask_avx2
+  Returns 0xFF in each lane of `_v` whose byte belongs to an enabled class;
+`_en_*` hold 0xFF in every lane for enabled classes and zero otherwise.
 */
-int
-d_string_cmp_cstr
+D_STRING_CLASS_AVX2_FN static D_INLINE __m256i
+d_string_internal_class_mask_avx2
 (
-    const struct d_string* _s1,
-    const char*            _s2
+    __m256i _v,
+    __m256i _en_digit,
+    __m256i _en_alpha,
+    __m256i _en_space
 )
 {
-    if ( (_s1 == NULL) && 
-         (_s2 == NULL) )
-    {
-        return 0;
-    }
-
-    if (_s1 == NULL)
-    {
-        return -1;
-    }
-
-    if (_s2 == NULL)
-    {
-        return 1;
-    }
-
-    return strcmp(_s1->text, _s2);
+    const __m256i zero = _mm256_setzero_si256();
+    __m256i       digit;
+    __m256i       alpha;
+    __m256i       space;
+
+    digit = _mm256_cmpeq_epi8(zero, _mm256_subs_epu8(
+                _mm256_sub_epi8(_v, _mm256_set1_epi8('0')),
+                _mm256_set1_epi8(9)));
+    alpha = _mm256_cmpeq_epi8(zero, _mm256_subs_epu8(
+                _mm256_sub_epi8(_mm256_or_si256(_v, _mm256_set1_epi8(0x20)),
+                                _mm256_set1_epi8('a')),
+                _mm256_set1_epi8(25)));
+    space = _mm256_or_si256(
+                _mm256_cmpeq_epi8(_v, _mm256_set1_epi8(' ')),
+                _mm256_cmpeq_epi8(zero, _mm256_subs_epu8(
+                    _mm256_sub_epi8(_v, _mm256_set1_epi8('\t')),
+                    _mm256_set1_epi8(4))));
+
+    return _mm256_or_si256(_mm256_and_si256(digit, _en_digit),
+                           _mm256_or_si256(_mm256_and_si256(alpha, _en_alpha),
+                                           _mm256_and_si256(space, _en_space)));
 }
 
 /*
-d_string_ncmp
-  Compare at most n characters of two d_strings.
-
-Parameter(s):
-  _s1: first d_string.
-  _s2: second d_string.
-  _n:  maximum characters to compare.
-Return:
-  An integer value indicating relationship.
+d_string_internal_all_class_avx2
+  AVX2 kernel for `d_string_internal_all_class`; 64 bytes per step, with
+the tail covered by one overlapping final load.
 */
-int
-d_string_ncmp
+D_STRING_CLASS_AVX2_FN static bool
+d_string_internal_all_class_avx2
 (
-    const struct d_string* _s1,
-    const struct d_string* _s2,
-    size_t                 _n
+    const unsigned char* _p,
+    size_t               _n,
+    unsigned             _cls
 )
 {
-    size_t len1;
-    size_t len2;
-    size_t min_len;
-    int    result;
+    __m256i en_digit;
+    __m256i en_alpha;
+    __m256i en_space;
+    __m256i ok;
+    size_t  i;
 
-    if (_n == 0)
+    if (_n < 32)
     {
-        return 0;
+        return d_string_internal_all_class_scalar(_p, _n, _cls);
     }
 
-    if ( (_s1 == NULL) && 
-         (_s2 == NULL) )
+    en_digit = _mm256_set1_epi8((_cls & D_STRING_INTERNAL_CLASS_DIGIT) ? -1 : 0);
+    en_alpha = _mm256_set1_epi8((_cls & D_STRING_INTERNAL_CLASS_ALPHA) ? -1 : 0);
+    en_space = _mm256_set1_epi8((_cls & D_STRING_INTERNAL_CLASS_SPACE) ? -1 : 0);
+
+    for (i = 0; (i + 64) <= _n; i += 64)
     {
-        return 0;
+        ok = _mm256_and_si256(
+            d_string_internal_class_mask_avx2(
+                _mm256_loadu_si256((const __m256i*)(_p + i)),
+                en_digit, en_alpha, en_space),
+            d_string_internal_class_mask_avx2(
+                _mm256_loadu_si256((const __m256i*)(_p + i + 32)),
+                en_digit, en_alpha, en_space));
+
+        if (_mm256_movemask_epi8(ok) != -1)
+        {
+            return false;
+        }
     }
 
-    if (_s1 == NULL)
+    for (; (i + 32) <= _n; i += 32)
     {
-        return -1;
+        ok = d_string_internal_class_mask_avx2(
+                _mm256_loadu_si256((const __m256i*)(_p + i)),
+                en_digit, en_alpha, en_space);
+
+        if (_mm256_movemask_epi8(ok) != -1)
+        {
+            return false;
+        }
     }
 
-    if (_s2 == NULL)
+    if (i < _n)
     {
-        return 1;
+        ok = d_string_internal_class_mask_avx2(
+                _mm256_loadu_si256((const __m256i*)(_p + _n - 32)),
+                en_digit, en_alpha, en_space);
+
+        return (_mm256_movemask_epi8(ok) == -1);
     }
 
-    len1    = (_n < _s1->size) ? _n : _s1->size;
-    len2    = (_n < _s2->size) ? _n : _s2->size;
-    min_len = (len1 < len2) ? len1 : len2;
+    return true;
+}
 
-    result = memcmp(_s1->text, _s2->text, min_len);
+/*
+d_string_internal_count_avx2
+  AVX2 kernel for `d_string_internal_count`. Matches are accumulated in
+byte lanes for up to 255 blocks before being widened with a sum of absolute
+differences.
+*/
+D_STRING_CLASS_AVX2_FN static size_t
+d_string_internal_count_avx2
+(
+    const unsigned char* _p,
+    size_t               _n,
+    unsigned char        _mask,
+    unsigned char        _value
+)
+{
+    const __m256i mask  = _mm256_set1_epi8((char)_mask);
+    const __m256i value = _mm256_set1_epi8((char)_value);
+    __m256i       acc;
+    uint64_t      lanes[4];
+    size_t        blocks;
+    size_t        count;
+    size_t        i;
 
-    if (result != 0)
-    {
-        return result;
-    }
+    count = 0;
+    i     = 0;
 
-    if (len1 < len2)
+    while ((_n - i) >= 32)
     {
-        return -1;
-    }
+        blocks = (_n - i) / 32;
+        blocks = (blocks > 255) ? 255 : blocks;
+        acc    = _mm256_setzero_si256();
 
-    if (len1 > len2)
-    {
-        return 1;
+        for (; blocks != 0; blocks--, i += 32)
+        {
+            acc = _mm256_sub_epi8(acc, _mm256_cmpeq_epi8(value,
+                      _mm256_and_si256(mask,
+                          _mm256_loadu_si256((const __m256i*)(_p + i)))));
+        }
+
+        _mm256_storeu_si256((__m256i*)lanes,
+                            _mm256_sad_epu8(acc, _mm256_setzero_si256()));
+        count += (size_t)(lanes[0] + lanes[1] + lanes[2] + lanes[3]);
     }
 
-    return 0;
+    return count + d_string_internal_count_scalar(_p + i, _n - i, _mask, _value);
 }
 
 /*
-d_string_ncmp_cstr
-  Compare at most n characters of d_string to C string.
-
-Parameter(s):
-  _s1: d_string.
-  _s2: C string.
-  _n:  maximum characters to compare.
-Return:
-  An integer value indicating relationship.
+d_string_internal_ascii_avx2
+  AVX2 kernel for `d_string_internal_is_ascii`.
 */
-int
-d_string_ncmp_cstr
+D_STRING_CLASS_AVX2_FN static bool
+d_string_internal_ascii_avx2
 (
-    const struct d_string* _s1,
-    const char*            _s2,
-    size_t                 _n
+    const unsigned char* _p,
+    size_t               _n
 )
 {
-    if (_n == 0)
-    {
-        return 0;
-    }
+    __m256i acc;
+    size_t  i;
 
-    if ( (_s1 == NULL) && 
-         (_s2 == NULL) )
+    if (_n < 32)
     {
-        return 0;
+        return d_string_internal_ascii_scalar(_p, _n);
     }
 
-    if (_s1 == NULL)
+    acc = _mm256_loadu_si256((const __m256i*)(_p + _n - 32));
+
+    for (i = 0; (i + 128) <= _n; i += 128)
     {
-        return -1;
+        acc = _mm256_or_si256(acc, _mm256_or_si256(
+            _mm256_or_si256(_mm256_loadu_si256((const __m256i*)(_p + i)),
+                            _mm256_loadu_si256((const __m256i*)(_p + i + 32))),
+            _mm256_or_si256(_mm256_loadu_si256((const __m256i*)(_p + i + 64)),
+                            _mm256_loadu_si256((const __m256i*)(_p + i + 96)))));
+
+        if (_mm256_movemask_epi8(acc) != 0)
+        {
+            return false;
+        }
     }
 
-    if (_s2 == NULL)
+    for (; (i + 32) <= _n; i += 32)
     {
-        return 1;
+        acc = _mm256_or_si256(acc,
+                              _mm256_loadu_si256((const __m256i*)(_p + i)));
     }
 
-    return strncmp(_s1->text, _s2, _n);
+    return (_mm256_movemask_epi8(acc) == 0);
 }
 
 /*
-d_string_casecmp
-  Case-insensitive comparison of two d_strings.
+d_string_internal_utf8_block_avx2
+  Accumulates into `_error` the errors of one 32-byte block `_in`, given the
+preceding block `_prev`.
+*/
+D_STRING_CLASS_AVX2_FN static D_INLINE __m256i
+d_string_internal_utf8_block_avx2
+(
+    __m256i        _in,
+    __m256i        _prev,
+    const __m256i* _tables,
+    __m256i        _error
+)
+{
+    const __m256i low_nibble = _mm256_set1_epi8(0x0F);
+    __m256i       carried;
+    __m256i       prev1;
+    __m256i       prev2;
+    __m256i       prev3;
+    __m256i       special;
+    __m256i       must23;
+
+    // the preceding 1, 2 and 3 bytes of every lane, across the lane boundary
+    carried = _mm256_permute2x128_si256(_prev, _in, 0x21);
+    prev1   = _mm256_alignr_epi8(_in, carried, 15);
+    prev2   = _mm256_alignr_epi8(_in, carried, 14);
+    prev3   = _mm256_alignr_epi8(_in, carried, 13);
+
+    special = _mm256_and_si256(
+        _mm256_and_si256(
+            _mm256_shuffle_epi8(_tables[0], _mm256_and_si256(
+                _mm256_srli_epi16(prev1, 4), low_nibble)),
+            _mm256_shuffle_epi8(_tables[1], _mm256_and_si256(
+                prev1, low_nibble))),
+        _mm256_shuffle_epi8(_tables[2], _mm256_and_si256(
+            _mm256_srli_epi16(_in, 4), low_nibble)));
+
+    // third and fourth bytes of a sequence must be continuations; the
+    // lookups flag those as TWO_CONTS, which these cancel out
+    must23 = _mm256_and_si256(
+        _mm256_or_si256(
+            _mm256_subs_epu8(prev2, _mm256_set1_epi8((char)(0xE0 - 0x80))),
+            _mm256_subs_epu8(prev3, _mm256_set1_epi8((char)(0xF0 - 0x80)))),
+        _mm256_set1_epi8((char)0x80));
+
+    return _mm256_or_si256(_error, _mm256_xor_si256(must23, special));
+}
 
-Parameter(s):
-  _s1: first d_string.
-  _s2: second d_string.
-Return:
-  An integer value indicating relationship.
+/*
+d_string_internal_utf8_avx2
+  AVX2 kernel for `d_string_internal_utf8_valid`. ASCII blocks only check
+that the previous block did not end mid-sequence; the final partial block is
+zero-padded. Inputs shorter than one block go to the scalar validator.
 */
-int
-d_string_casecmp
+D_STRING_CLASS_AVX2_FN static bool
+d_string_internal_utf8_avx2
 (
-    const struct d_string* _s1,
-    const struct d_string* _s2
+    const unsigned char* _p,
+    size_t               _n
 )
 {
-    if ( (_s1 == NULL) && 
-         (_s2 == NULL) )
-    {
-        return 0;
-    }
+    __m256i       tables[3];
+    __m256i       incomplete_max;
+    __m256i       in;
+    __m256i       prev;
+    __m256i       incomplete;
+    __m256i       error;
+    unsigned char tail[32];
+    size_t        i;
+    int           t;
 
-    if (_s1 == NULL)
+    if (_n < 32)
     {
-        return -1;
+        return d_string_internal_utf8_scalar(_p, _n);
     }
 
-    if (_s2 == NULL)
+    for (t = 0; t < 3; t++)
     {
-        return 1;
+        tables[t] = _mm256_broadcastsi128_si256(_mm_loadu_si128(
+            (const __m128i*)d_string_internal_utf8_tables[t]));
     }
 
-    return d_strcasecmp(_s1->text, _s2->text);
+    // a block ending in a lead byte whose sequence runs past it
+    incomplete_max = _mm256_setr_epi8(
+        -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+        -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+        (char)(0xF0 - 1), (char)(0xE0 - 1), (char)(0xC0 - 1));
+
+    prev       = _mm256_setzero_si256();
+    incomplete = _mm256_setzero_si256();
+    error      = _mm256_setzero_si256();
+
+    for (i = 0; i < _n; i += 32)
+    {
+        if ((_n - i) >= 32)
+        {
+            in = _mm256_loadu_si256((const __m256i*)(_p + i));
+        }
+        else
+        {
+            d_memset(tail, 0, sizeof(tail));
+            d_memcpy(tail, _p + i, _n - i);
+            in = _mm256_loadu_si256((const __m256i*)tail);
+        }
+
+        if (_mm256_movemask_epi8(in) == 0)
+        {
+            error = _mm256_or_si256(error, incomplete);
+        }
+        else
+        {
+            error      = d_string_internal_utf8_block_avx2(in,
+                                                           prev,
+                                                           tables,
+                                                           error);
+            incomplete = _mm256_subs_epu8(in, incomplete_max);
+        }
+
+        prev = in;
+
+        if ( ((i & 1023) == 0) &&
+             (!_mm256_testz_si256(error, error)) )
+        {
+            return false;
+        }
+    }
+
+    error = _mm256_or_si256(error, incomplete);
+
+    return (_mm256_testz_si256(error, error) != 0);
 }
 
+#endif  // D_STRING_CLASS_AVX2 || D_STRING_CLASS_AVX2_DISPATCH
+
+#if defined(D_STRING_CLASS_SSE2)
+
 /*
-d_string_casecmp_cstr
-  Case-insensitive comparison of d_string to C string.
+d_string_internal_class_mask_sse2
+  SSE2 counterpart of `d_string_internal_class_mask_avx2`.
+*/
+static D_INLINE __m128i
+d_string_internal_class_mask_sse2
+(
+    __m128i _v,
+    __m128i _en_digit,
+    __m128i _en_alpha,
+    __m128i _en_space
+)
+{
+    const __m128i zero = _mm_setzero_si128();
+    __m128i       digit;
+    __m128i       alpha;
+    __m128i       space;
+
+    digit = _mm_cmpeq_epi8(zero, _mm_subs_epu8(
+                _mm_sub_epi8(_v, _mm_set1_epi8('0')),
+                _mm_set1_epi8(9)));
+    alpha = _mm_cmpeq_epi8(zero, _mm_subs_epu8(
+                _mm_sub_epi8(_mm_or_si128(_v, _mm_set1_epi8(0x20)),
+                             _mm_set1_epi8('a')),
+                _mm_set1_epi8(25)));
+    space = _mm_or_si128(
+                _mm_cmpeq_epi8(_v, _mm_set1_epi8(' ')),
+                _mm_cmpeq_epi8(zero, _mm_subs_epu8(
+                    _mm_sub_epi8(_v, _mm_set1_epi8('\t')),
+                    _mm_set1_epi8(4))));
+
+    return _mm_or_si128(_mm_and_si128(digit, _en_digit),
+                        _mm_or_si128(_mm_and_si128(alpha, _en_alpha),
+                                     _mm_and_si128(space, _en_space)));
+}
 
-Parameter(s):
-  _s1: d_string.
-  _s2: C string.
-Return:
-  An integer value indicating relationship.
+/*
+d_string_internal_all_class_sse2
+  SSE2 kernel for `d_string_internal_all_class`; 32 bytes per step, with
+the tail covered by overlapping final loads.
 */
-int
-d_string_casecmp_cstr
+static bool
+d_string_internal_all_class_sse2
 (
-    const struct d_string* _s1,
-    const char*            _s2
+    const unsigned char* _p,
+    size_t               _n,
+    unsigned             _cls
 )
 {
-    if ( (_s1 == NULL) && 
-         (_s2 == NULL) )
+    __m128i en_digit;
+    __m128i en_alpha;
+    __m128i en_space;
+    __m128i ok;
+    size_t  i;
+
+    if (_n < 16)
     {
-        return 0;
+        return d_string_internal_all_class_scalar(_p, _n, _cls);
     }
 
-    if (_s1 == NULL)
+    en_digit = _mm_set1_epi8((_cls & D_STRING_INTERNAL_CLASS_DIGIT) ? -1 : 0);
+    en_alpha = _mm_set1_epi8((_cls & D_STRING_INTERNAL_CLASS_ALPHA) ? -1 : 0);
+    en_space = _mm_set1_epi8((_cls & D_STRING_INTERNAL_CLASS_SPACE) ? -1 : 0);
+
+    for (i = 0; (i + 32) <= _n; i += 32)
     {
-        return -1;
+        ok = _mm_and_si128(
+            d_string_internal_class_mask_sse2(
+                _mm_loadu_si128((const __m128i*)(_p + i)),
+                en_digit, en_alpha, en_space),
+            d_string_internal_class_mask_sse2(
+                _mm_loadu_si128((const __m128i*)(_p + i + 16)),
+                en_digit, en_alpha, en_space));
+
+        if (_mm_movemask_epi8(ok) != 0xFFFF)
+        {
+            return false;
+        }
     }
 
-    if (_s2 == NULL)
+    if ((_n - i) >= 16)
     {
-        return 1;
+        ok = d_string_internal_class_mask_sse2(
+                _mm_loadu_si128((const __m128i*)(_p + i)),
+                en_digit, en_alpha, en_space);
+
+        if (_mm_movemask_epi8(ok) != 0xFFFF)
+        {
+            return false;
+        }
     }
 
-    return d_strcasecmp(_s1->text, _s2);
+    if (i < _n)
+    {
+        ok = d_string_internal_class_mask_sse2(
+                _mm_loadu_si128((const __m128i*)(_p + _n - 16)),
+                en_digit, en_alpha, en_space);
+
+        return (_mm_movemask_epi8(ok) == 0xFFFF);
+    }
+
+    return true;
 }
 
 /*
-d_string_ncasecmp
-  Case-insensitive comparison of at most n characters.
-
-Parameter(s):
-  _s1: first d_string.
-  _s2: second d_string.
-  _n:  maximum characters to compare.
-Return:
-  An integer value indicating relationship.
+d_string_internal_count_sse2
+  SSE2 counterpart of `d_string_internal_count_avx2`.
 */
-int
-d_string_ncasecmp
+static size_t
+d_string_internal_count_sse2
 (
-    const struct d_string* _s1,
-    const struct d_string* _s2,
-    size_t                 _n
+    const unsigned char* _p,
+    size_t               _n,
+    unsigned char        _mask,
+    unsigned char        _value
 )
 {
-    if (_n == 0)
-    {
-        return 0;
-    }
+    const __m128i mask  = _mm_set1_epi8((char)_mask);
+    const __m128i value = _mm_set1_epi8((char)_value);
+    __m128i       acc;
+    uint64_t      lanes[2];
+    size_t        blocks;
+    size_t        count;
+    size_t        i;
 
-    if ( (_s1 == NULL) && 
-         (_s2 == NULL) )
-    {
-        return 0;
-    }
+    count = 0;
+    i     = 0;
 
-    if (_s1 == NULL)
+    while ((_n - i) >= 16)
     {
-        return -1;
-    }
+        blocks = (_n - i) / 16;
+        blocks = (blocks > 255) ? 255 : blocks;
+        acc    = _mm_setzero_si128();
 
-    if (_s2 == NULL)
-    {
-        return 1;
+        for (; blocks != 0; blocks--, i += 16)
+        {
+            acc = _mm_sub_epi8(acc, _mm_cmpeq_epi8(value,
+                      _mm_and_si128(mask,
+                          _mm_loadu_si128((const __m128i*)(_p + i)))));
+        }
+
+        _mm_storeu_si128((__m128i*)lanes,
+                         _mm_sad_epu8(acc, _mm_setzero_si128()));
+        count += (size_t)(lanes[0] + lanes[1]);
     }
 
-    return d_strncasecmp(_s1->text, _s2->text, _n);
+    return count + d_string_internal_count_scalar(_p + i, _n - i, _mask, _value);
 }
 
 /*
-d_string_ncasecmp_cstr
-  Case-insensitive comparison of at most n characters to C string.
-
-Parameter(s):
-  _s1: d_string.
-  _s2: C string.
-  _n:  maximum characters to compare.
-Return:
-  An integer value indicating relationship.
+d_string_internal_ascii_sse2
+  SSE2 kernel for `d_string_internal_is_ascii`.
 */
-int
-d_string_ncasecmp_cstr
+static bool
+d_string_internal_ascii_sse2
 (
-    const struct d_string* _s1,
-    const char*            _s2,
-    size_t                 _n
+    const unsigned char* _p,
+    size_t               _n
 )
 {
-    if (_n == 0)
-    {
-        return 0;
-    }
+    __m128i acc;
+    size_t  i;
 
-    if ( (_s1 == NULL) && 
-         (_s2 == NULL) )
+    if (_n < 16)
     {
-        return 0;
+        return d_string_internal_ascii_scalar(_p, _n);
     }
 
-    if (_s1 == NULL)
+    acc = _mm_loadu_si128((const __m128i*)(_p + _n - 16));
+
+    for (i = 0; (i + 64) <= _n; i += 64)
     {
-        return -1;
+        acc = _mm_or_si128(acc, _mm_or_si128(
+            _mm_or_si128(_mm_loadu_si128((const __m128i*)(_p + i)),
+                         _mm_loadu_si128((const __m128i*)(_p + i + 16))),
+            _mm_or_si128(_mm_loadu_si128((const __m128i*)(_p + i + 32)),
+                         _mm_loadu_si128((const __m128i*)(_p + i + 48)))));
+
+        if (_mm_movemask_epi8(acc) != 0)
+        {
+            return false;
+        }
     }
 
-    if (_s2 == NULL)
+    for (; (i + 16) <= _n; i += 16)
     {
-        return 1;
+        acc = _mm_or_si128(acc, _mm_loadu_si128((const __m128i*)(_p + i)));
     }
 
-    return d_strncasecmp(_s1->text, _s2, _n);
+    return (_mm_movemask_epi8(acc) == 0);
 }
 
-/*
-d_string_equals
-  Check if two d_strings are equal.
+#elif defined(D_STRING_CLASS_NEON)
 
-Parameter(s):
-  _s1: first d_string.
-  _s2: second d_string.
-Return:
-  A boolean value: true if equal, false otherwise.
+/*
+d_string_internal_any_neon
+  Returns true if any lane of `_v` is non-zero.
 */
-bool
-d_string_equals
+static D_INLINE bool
+d_string_internal_any_neon
 (
-    const struct d_string* _s1,
-    const struct d_string* _s2
+    uint8x16_t _v
 )
 {
-    return (d_string_cmp(_s1, _s2) == 0);
+    // narrow each lane to a nibble, giving one 64-bit word to test
+    return (vget_lane_u64(vreinterpret_u64_u8(vshrn_n_u16(
+                vreinterpretq_u16_u8(_v), 4)), 0) != 0);
 }
 
 /*
-d_string_equals_cstr
-  Check if d_string equals C string.
-
-Parameter(s):
-  _s1: d_string.
-  _s2: C string.
-Return:
-  A boolean value: true if equal, false otherwise.
+d_string_internal_class_mask_neon
+  NEON counterpart of `d_string_internal_class_mask_avx2`.
 */
-bool
-d_string_equals_cstr
+static D_INLINE uint8x16_t
+d_string_internal_class_mask_neon
 (
-    const struct d_string* _s1,
-    const char*            _s2
+    uint8x16_t _v,
+    uint8x16_t _en_digit,
+    uint8x16_t _en_alpha,
+    uint8x16_t _en_space
 )
 {
-    return (d_string_cmp_cstr(_s1, _s2) == 0);
+    const uint8x16_t zero = vdupq_n_u8(0);
+    uint8x16_t       digit;
+    uint8x16_t       alpha;
+    uint8x16_t       space;
+
+    digit = vceqq_u8(zero, vqsubq_u8(vsubq_u8(_v, vdupq_n_u8('0')),
+                                     vdupq_n_u8(9)));
+    alpha = vceqq_u8(zero, vqsubq_u8(vsubq_u8(vorrq_u8(_v, vdupq_n_u8(0x20)),
+                                              vdupq_n_u8('a')),
+                                     vdupq_n_u8(25)));
+    space = vorrq_u8(vceqq_u8(_v, vdupq_n_u8(' ')),
+                     vceqq_u8(zero, vqsubq_u8(vsubq_u8(_v, vdupq_n_u8('\t')),
+                                              vdupq_n_u8(4))));
+
+    return vorrq_u8(vandq_u8(digit, _en_digit),
+                    vorrq_u8(vandq_u8(alpha, _en_alpha),
+                             vandq_u8(space, _en_space)));
 }
 
 /*
-d_string_equals_ignore_case
-  Check if two d_strings are equal ignoring case.
-
-Parameter(s):
-  _s1: first d_string.
-  _s2: second d_string.
-Return:
-  A boolean value: true if equal ignoring case, false otherwise.
+d_string_internal_all_class_neon
+  NEON kernel for `d_string_internal_all_class`; 16 bytes per step, with
+the tail covered by one overlapping final load.
 */
-bool
-d_string_equals_ignore_case
+static bool
+d_string_internal_all_class_neon
 (
-    const struct d_string* _s1,
-    const struct d_string* _s2
+    const unsigned char* _p,
+    size_t               _n,
+    unsigned             _cls
 )
 {
-    return (d_string_casecmp(_s1, _s2) == 0);
-}
+    uint8x16_t en_digit;
+    uint8x16_t en_alpha;
+    uint8x16_t en_space;
+    size_t     i;
 
-/*
-d_string_equals_cstr_ignore_case
-  Check if d_string equals C string ignoring case.
+    if (_n < 16)
+    {
+        return d_string_internal_all_class_scalar(_p, _n, _cls);
+    }
 
-Parameter(s):
-  _s1: d_string.
-  _s2: C string.
-Return:
-  A boolean value: true if equal ignoring case, false otherwise.
-*/
-bool
-d_string_equals_cstr_ignore_case
-(
-    const struct d_string* _s1,
-    const char*            _s2
-)
-{
-    return (d_string_casecmp_cstr(_s1, _s2) == 0);
-}
+    en_digit = vdupq_n_u8((_cls & D_STRING_INTERNAL_CLASS_DIGIT) ? 0xFF : 0);
+    en_alpha = vdupq_n_u8((_cls & D_STRING_INTERNAL_CLASS_ALPHA) ? 0xFF : 0);
+    en_space = vdupq_n_u8((_cls & D_STRING_INTERNAL_CLASS_SPACE) ? 0xFF : 0);
 
+    for (i = 0; (i + 16) <= _n; i += 16)
+    {
+        if (d_string_internal_any_neon(vmvnq_u8(
+                d_string_internal_class_mask_neon(vld1q_u8(_p + i),
+                                                  en_digit,
+                                                  en_alpha,
+                                                  en_space))))
+        {
+            return false;
+        }
+    }
 
+    return ( (i == _n) ||
+             (!d_string_internal_any_neon(vmvnq_u8(
+                 d_string_internal_class_mask_neon(vld1q_u8(_p + _n - 16),
+                                                   en_digit,
+                                                   en_alpha,
+                                                   en_space)))) );
+}
 
-d_string_find_char
+/*
+d_string_internal_count_neon
+  NEON counterpart of `d_string_internal_count_avx2`.
+*/
+static size_t
+d_string_internal_count_neon
 (
-    const struct d_string* _str,
-    char                   _c
+    const unsigned char* _p,
+    size_t               _n,
+    unsigned char        _mask,
+    unsigned char        _value
 )
 {
-    const char* p;
+    const uint8x16_t mask  = vdupq_n_u8(_mask);
+    const uint8x16_t value = vdupq_n_u8(_value);
+    uint8x16_t       acc;
+    uint64x2_t       sum;
+    size_t           blocks;
+    size_t           count;
+    size_t           i;
 
-    if ( (_str == NULL) || 
-         (_str->text == NULL) )
+    count = 0;
+    i     = 0;
+
+    while ((_n - i) >= 16)
     {
-        return -1;
-    }
+        blocks = (_n - i) / 16;
+        blocks = (blocks > 255) ? 255 : blocks;
+        acc    = vdupq_n_u8(0);
 
-    p = strchr(_str->text, _c);
+        for (; blocks != 0; blocks--, i += 16)
+        {
+            acc = vsubq_u8(acc, vceqq_u8(value,
+                                         vandq_u8(mask, vld1q_u8(_p + i))));
+        }
 
-    if (p == NULL)
-    {
-        return -1;
+        sum    = vpaddlq_u32(vpaddlq_u16(vpaddlq_u8(acc)));
+        count += (size_t)(vgetq_lane_u64(sum, 0) + vgetq_lane_u64(sum, 1));
     }
 
-    return (ssize_t)(p - _str->text);
+    return count + d_string_internal_count_scalar(_p + i, _n - i, _mask, _value);
 }
 
 /*
-d_string_find_char_from
-  Find first occurrence of character starting from index.
-
-Parameter(s):
-  _str:   d_string to search.
-  _c:     character to find.
-  _start: starting index.
-Return:
-  Index of character, or -1 if not found.
+d_string_internal_ascii_neon
+  NEON kernel for `d_string_internal_is_ascii`.
 */
-ssize_t
-d_string_find_char_from
+static bool
+d_string_internal_ascii_neon
 (
-    const struct d_string* _str,
-    char                   _c,
-    d_index                _start
+    const unsigned char* _p,
+    size_t               _n
 )
 {
-    size_t      start_pos;
-    const char* p;
+    uint8x16_t acc;
+    size_t     i;
 
-    if ( (_str == NULL) || 
-         (_str->text == NULL) )
+    if (_n < 16)
     {
-        return -1;
+        return d_string_internal_ascii_scalar(_p, _n);
     }
 
-    if (!d_index_convert_safe(_start, _str->size, &start_pos))
+    acc = vld1q_u8(_p + _n - 16);
+
+    for (i = 0; (i + 64) <= _n; i += 64)
     {
-        return -1;
-    }
+        acc = vorrq_u8(acc, vorrq_u8(
+            vorrq_u8(vld1q_u8(_p + i),      vld1q_u8(_p + i + 16)),
+            vorrq_u8(vld1q_u8(_p + i + 32), vld1q_u8(_p + i + 48))));
 
-    p = strchr(_str->text + start_pos, _c);
+        if (d_string_internal_any_neon(vshrq_n_u8(acc, 7)))
+        {
+            return false;
+        }
+    }
 
-    if (p == NULL)
+    for (; (i + 16) <= _n; i += 16)
     {
-        return -1;
+        acc = vorrq_u8(acc, vld1q_u8(_p + i));
     }
 
-    return (ssize_t)(p - _str->text);
+    return !d_string_internal_any_neon(vshrq_n_u8(acc, 7));
 }
 
-/*
-d_string_rfind_char
-  Find last occurrence of character in d_string.
+#if defined(__aarch64__) || defined(_M_ARM64)
 
-Parameter(s):
-  _str: d_string to search.
-  _c:   character to find.
-Return:
-  Index of character, or -1 if not found.
+/*
+d_string_internal_utf8_neon
+  AArch64 NEON counterpart of `d_string_internal_utf8_avx2`, 16 bytes per
+step.
 */
-ssize_t
-d_string_rfind_char
+static bool
+d_string_internal_utf8_neon
 (
-    const struct d_string* _str,
-    char                   _c
+    const unsigned char* _p,
+    size_t               _n
 )
 {
-    const char* p;
+    static const unsigned char incomplete_bytes[16] =
+    {
+        0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+        0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xF0 - 1, 0xE0 - 1, 0xC0 - 1
+    };
+    const uint8x16_t table0 = vld1q_u8(d_string_internal_utf8_tables[0]);
+    const uint8x16_t table1 = vld1q_u8(d_string_internal_utf8_tables[1]);
+    const uint8x16_t table2 = vld1q_u8(d_string_internal_utf8_tables[2]);
+    const uint8x16_t incomplete_max = vld1q_u8(incomplete_bytes);
+    uint8x16_t       in;
+    uint8x16_t       prev;
+    uint8x16_t       prev1;
+    uint8x16_t       incomplete;
+    uint8x16_t       error;
+    uint8x16_t       special;
+    uint8x16_t       must23;
+    unsigned char    tail[16];
+    size_t           i;
 
-    if ( (_str == NULL) || 
-         (_str->text == NULL) )
+    if (_n < 16)
     {
-        return -1;
+        return d_string_internal_utf8_scalar(_p, _n);
     }
 
-    p = strrchr(_str->text, _c);
+    prev       = vdupq_n_u8(0);
+    incomplete = vdupq_n_u8(0);
+    error      = vdupq_n_u8(0);
 
-    if (p == NULL)
+    for (i = 0; i < _n; i += 16)
     {
-        return -1;
+        if ((_n - i) >= 16)
+        {
+            in = vld1q_u8(_p + i);
+        }
+        else
+        {
+            d_memset(tail, 0, sizeof(tail));
+            d_memcpy(tail, _p + i, _n - i);
+            in = vld1q_u8(tail);
+        }
+
+        if (vmaxvq_u8(in) < 0x80)
+        {
+            error = vorrq_u8(error, incomplete);
+        }
+        else
+        {
+            prev1   = vextq_u8(prev, in, 15);
+            special = vandq_u8(
+                vandq_u8(vqtbl1q_u8(table0, vshrq_n_u8(prev1, 4)),
+                         vqtbl1q_u8(table1, vandq_u8(prev1, vdupq_n_u8(0x0F)))),
+                vqtbl1q_u8(table2, vshrq_n_u8(in, 4)));
+            must23  = vandq_u8(
+                vorrq_u8(vqsubq_u8(vextq_u8(prev, in, 14),
+                                   vdupq_n_u8(0xE0 - 0x80)),
+                         vqsubq_u8(vextq_u8(prev, in, 13),
+                                   vdupq_n_u8(0xF0 - 0x80))),
+                vdupq_n_u8(0x80));
+            error      = vorrq_u8(error, veorq_u8(must23, special));
+            incomplete = vqsubq_u8(in, incomplete_max);
+        }
+
+        prev = in;
     }
 
-    return (ssize_t)(p - _str->text);
+    return (vmaxvq_u8(vorrq_u8(error, incomplete)) == 0);
 }
 
-/*
-d_string_chr
-  Find character in d_string, returning pointer.
+#endif  // __aarch64__ || _M_ARM64
 
-Parameter(s):
-  _str: d_string to search.
-  _c:   character to find.
-Return:
-  Pointer to character, or NULL if not found.
+#endif  // D_STRING_CLASS_SSE2 / D_STRING_CLASS_NEON
+
+
+/******************************************************************************
+* Internal Transformation Engine
+******************************************************************************/
+
+// D_STRING_INTERNAL_FOLD_*
+//   constant: ASCII case mapping applied while copying by the transformation
+// kernels. Like the character classes, mapping follows the "C" locale; bytes
+// >= 0x80 are never changed.
+#define D_STRING_INTERNAL_FOLD_NONE  0u
+#define D_STRING_INTERNAL_FOLD_LOWER 1u   // 'A'-'Z' to 'a'-'z'
+#define D_STRING_INTERNAL_FOLD_UPPER 2u   // 'a'-'z' to 'A'-'Z'
+
+/*
+d_string_internal_fold_byte
+  Applies case mapping `_fold` to a single byte.
 */
-char*
-d_string_chr
+static D_INLINE unsigned char
+d_string_internal_fold_byte
 (
-    const struct d_string* _str,
-    int                    _c
+    unsigned char _c,
+    unsigned      _fold
 )
 {
-    if ( (_str == NULL) || 
-         (_str->text == NULL) )
+    if (_fold == D_STRING_INTERNAL_FOLD_LOWER)
     {
-        return NULL;
+        return ((unsigned)(_c - 'A') < 26u) ? (unsigned char)(_c | 0x20u)
+                                            : _c;
+    }
+
+    if (_fold == D_STRING_INTERNAL_FOLD_UPPER)
+    {
+        return ((unsigned)(_c - 'a') < 26u) ? (unsigned char)(_c & ~0x20u)
+                                            : _c;
     }
 
-    return strchr(_str->text, _c);
+    return _c;
 }
 
 /*
-d_string_rchr
-  Find last occurrence of character, returning pointer.
-
-Parameter(s):
-  _str: d_string to search.
-  _c:   character to find.
-Return:
-  Pointer to character, or NULL if not found.
+d_string_internal_fold_word
+  Applies case mapping `_fold` to the eight bytes packed in `_w`. Each
+byte's low seven bits are offset so that the high bit records whether it
+lies at or above the first letter and above the last; bytes that already
+had the high bit set are excluded.
 */
-char*
-d_string_rchr
+static D_INLINE uint64_t
+d_string_internal_fold_word
 (
-    const struct d_string* _str,
-    int                    _c
+    uint64_t _w,
+    unsigned _fold
 )
 {
-    if ( (_str == NULL) || 
-         (_str->text == NULL) )
-    {
-        return NULL;
-    }
-
-    return strrchr(_str->text, _c);
+    const uint64_t ones = 0x0101010101010101ULL;
+    uint64_t       first;
+    uint64_t       last;
+    uint64_t       low;
+    uint64_t       letters;
+
+    first   = (_fold == D_STRING_INTERNAL_FOLD_LOWER) ? 'A' : 'a';
+    last    = first + 25;
+    low     = _w & (0x7F * ones);
+    letters = (low + ((0x80 - first) * ones)) &
+              ~(low + ((0x7F - last) * ones)) &
+              ~_w & (0x80 * ones);
+
+    return _w ^ (letters >> 2);
 }
 
 /*
-d_string_chrnul
-  Find character or return pointer to null terminator.
-
-Parameter(s):
-  _str: d_string to search.
-  _c:   character to find.
-Return:
-  Pointer to character or null terminator, NULL only if _str is NULL.
+d_string_internal_bswap64
+  Reverses the byte order of `_x`.
 */
-char*
-d_string_chrnul
+static D_INLINE uint64_t
+d_string_internal_bswap64
 (
-    const struct d_string* _str,
-    int                    _c
+    uint64_t _x
 )
 {
-    if ( (_str == NULL) || 
-         (_str->text == NULL) )
-    {
-        return NULL;
-    }
-
-    return d_strchrnul(_str->text, _c);
+#if defined(__GNUC__) || defined(__clang__)
+    return __builtin_bswap64(_x);
+#elif defined(_MSC_VER)
+    return _byteswap_uint64(_x);
+#else
+    _x = ((_x & 0x00FF00FF00FF00FFULL) << 8)  |
+         ((_x >> 8)  & 0x00FF00FF00FF00FFULL);
+    _x = ((_x & 0x0000FFFF0000FFFFULL) << 16) |
+         ((_x >> 16) & 0x0000FFFF0000FFFFULL);
+
+    return (_x << 32) | (_x >> 32);
+#endif
 }
 
-
-/******************************************************************************
-* Search Functions - Substring Search
-******************************************************************************/
-
 /*
-d_string_find
-  Find first occurrence of substring in d_string.
-
-Parameter(s):
-  _haystack: d_string to search in.
-  _needle:   d_string to search for.
-Return:
-  Index of substring, or -1 if not found.
+d_string_internal_case_copy_scalar
+  Copies `_src[0.._n)` to `_dst` applying case mapping `_fold`, eight bytes
+per step. `_dst` may equal `_src` or precede it.
 */
-ssize_t
-d_string_find
+static void
+d_string_internal_case_copy_scalar
 (
-    const struct d_string* _haystack,
-    const struct d_string* _needle
+    unsigned char*       _dst,
+    const unsigned char* _src,
+    size_t               _n,
+    unsigned             _fold
 )
 {
-    const char* p;
+    uint64_t word;
+    size_t   i;
 
-    if ( (_haystack == NULL) || 
-         (_needle == NULL) )
+    for (i = 0; (i + 8) <= _n; i += 8)
     {
-        return -1;
+        memcpy(&word, _src + i, sizeof(word));
+        word = d_string_internal_fold_word(word, _fold);
+        memcpy(_dst + i, &word, sizeof(word));
     }
 
-    if (_needle->size == 0)
+    for (; i < _n; i++)
     {
-        return 0;
+        _dst[i] = d_string_internal_fold_byte(_src[i], _fold);
     }
 
-    p = strstr(_haystack->text, _needle->text);
+    return;
+}
+
+/*
+d_string_internal_replace_byte_scalar
+  Replaces every `_old` byte of `_p[0.._n)` with `_new`.
+*/
+static void
+d_string_internal_replace_byte_scalar
+(
+    unsigned char* _p,
+    size_t         _n,
+    unsigned char  _old,
+    unsigned char  _new
+)
+{
+    size_t i;
 
-    if (p == NULL)
+    for (i = 0; i < _n; i++)
     {
-        return -1;
+        if (_p[i] == _old)
+        {
+            _p[i] = _new;
+        }
     }
 
-    return (ssize_t)(p - _haystack->text);
+    return;
 }
 
 /*
-d_string_find_cstr
-  Find first occurrence of C string in d_string.
-
-Parameter(s):
-  _haystack: d_string to search in.
-  _needle:   C string to search for.
-Return:
-  Index of substring, or -1 if not found.
+d_string_internal_trim_start_scalar
+  Returns the index of the first non-whitespace byte of `_p[0.._n)`, or `_n`
+if there is none.
 */
-ssize_t
-d_string_find_cstr
+static size_t
+d_string_internal_trim_start_scalar
 (
-    const struct d_string* _haystack,
-    const char*            _needle
+    const unsigned char* _p,
+    size_t               _n
 )
 {
-    const char* p;
-
-    if ( (_haystack == NULL) || 
-         (_needle == NULL) )
-    {
-        return -1;
-    }
+    size_t i;
 
-    if (*_needle == '\0')
+    for (i = 0;
+         (i < _n) &&
+         d_string_internal_class_byte(_p[i], D_STRING_INTERNAL_CLASS_SPACE);
+         i++)
     {
-        return 0;
     }
 
-    p = strstr(_haystack->text, _needle);
+    return i;
+}
 
-    if (p == NULL)
+/*
+d_string_internal_trim_end_scalar
+  Returns one past the index of the last non-whitespace byte of `_p[0.._n)`,
+or 0 if there is none.
+*/
+static size_t
+d_string_internal_trim_end_scalar
+(
+    const unsigned char* _p,
+    size_t               _n
+)
+{
+    while ( (_n > 0) &&
+            d_string_internal_class_byte(_p[_n - 1],
+                                         D_STRING_INTERNAL_CLASS_SPACE) )
     {
-        return -1;
+        _n--;
     }
 
-    return (ssize_t)(p - _haystack->text);
+    return _n;
 }
 
 /*
-d_string_find_from
-  Find substring starting from index.
-
-Parameter(s):
-  _haystack: d_string to search in.
-  _needle:   d_string to search for.
-  _start:    starting index.
-Return:
-  Index of substring, or -1 if not found.
+d_string_internal_reverse_scalar
+  Reverses `_p[0.._n)` in place, swapping eight-byte words from both ends
+while at least two remain.
 */
-ssize_t
-d_string_find_from
+static void
+d_string_internal_reverse_scalar
 (
-    const struct d_string* _haystack,
-    const struct d_string* _needle,
-    d_index                _start
+    unsigned char* _p,
+    size_t         _n
 )
 {
-    size_t      start_pos;
-    const char* p;
+    uint64_t      head;
+    uint64_t      tail;
+    unsigned char c;
+    size_t        i;
+    size_t        j;
 
-    if ( (_haystack == NULL) || 
-         (_needle == NULL) )
-    {
-        return -1;
-    }
+    i = 0;
+    j = _n;
 
-    if (!d_index_convert_safe(_start, _haystack->size, &start_pos))
+    while ((j - i) >= 16)
     {
-        return -1;
+        memcpy(&head, _p + i, sizeof(head));
+        memcpy(&tail, _p + j - 8, sizeof(tail));
+        head = d_string_internal_bswap64(head);
+        tail = d_string_internal_bswap64(tail);
+        memcpy(_p + i, &tail, sizeof(tail));
+        memcpy(_p + j - 8, &head, sizeof(head));
+        i += 8;
+        j -= 8;
     }
 
-    p = strstr(_haystack->text + start_pos, _needle->text);
-
-    if (p == NULL)
+    while ((j - i) >= 2)
     {
-        return -1;
+        j--;
+        c     = _p[i];
+        _p[i] = _p[j];
+        _p[j] = c;
+        i++;
     }
 
-    return (ssize_t)(p - _haystack->text);
+    return;
 }
 
 /*
-d_string_find_cstr_from
-  Find C string starting from index.
-
-Parameter(s):
-  _haystack: d_string to search in.
-  _needle:   C string to search for.
-  _start:    starting index.
-Return:
-  Index of substring, or -1 if not found.
+d_string_internal_collapse_run
+  Copies `_src[0.._n)` to `_dst` applying case mapping `_fold` and replacing
+each whitespace run with one space. `_space` carries whether the byte before
+`_src` was whitespace and is updated for the next call. Returns the number of
+bytes written; `_dst` may equal `_src` or precede it.
 */
-ssize_t
-d_string_find_cstr_from
+static size_t
+d_string_internal_collapse_run
 (
-    const struct d_string* _haystack,
-    const char*            _needle,
-    d_index                _start
+    unsigned char*       _dst,
+    const unsigned char* _src,
+    size_t               _n,
+    unsigned             _fold,
+    bool*                _space
 )
 {
-    size_t      start_pos;
-    const char* p;
+    unsigned char c;
+    bool          space;
+    bool          prev;
+    size_t        i;
+    size_t        w;
 
-    if ( (_haystack == NULL) || 
-         (_needle == NULL) )
-    {
-        return -1;
-    }
+    prev = *_space;
+    w    = 0;
 
-    if (!d_index_convert_safe(_start, _haystack->size, &start_pos))
+    // every byte is stored, but the write position only advances past a
+    // space that does not follow another, keeping the loop branch-free
+    for (i = 0; i < _n; i++)
     {
-        return -1;
+        c       = _src[i];
+        space   = ( (c == ' ') || ((unsigned)(c - '\t') < 5u) );
+        _dst[w] = space ? (unsigned char)' '
+                        : d_string_internal_fold_byte(c, _fold);
+        w      += (size_t)!(space && prev);
+        prev    = space;
     }
 
-    p = strstr(_haystack->text + start_pos, _needle);
+    *_space = prev;
 
-    if (p == NULL)
-    {
-        return -1;
-    }
-
-    return (ssize_t)(p - _haystack->text);
+    return w;
 }
 
 /*
-d_string_rfind
-  Find last occurrence of substring.
-
-Parameter(s):
-  _haystack: d_string to search in.
-  _needle:   d_string to search for.
-Return:
-  Index of last occurrence, or -1 if not found.
+d_string_internal_collapse_scalar
+  Scalar kernel for `d_string_internal_collapse`.
 */
-ssize_t
-d_string_rfind
+static size_t
+d_string_internal_collapse_scalar
 (
-    const struct d_string* _haystack,
-    const struct d_string* _needle
+    unsigned char*       _dst,
+    const unsigned char* _src,
+    size_t               _n,
+    unsigned             _fold
 )
 {
-    ssize_t     last_pos;
-    const char* p;
-    const char* search_start;
+    bool space;
 
-    if ( (_haystack == NULL) || 
-         (_needle == NULL) )
-    {
-        return -1;
-    }
+    space = false;
 
-    if (_needle->size == 0)
-    {
-        return (ssize_t)_haystack->size;
-    }
+    return d_string_internal_collapse_run(_dst, _src, _n, _fold, &space);
+}
 
-    if (_needle->size > _haystack->size)
-    {
-        return -1;
-    }
+#if ( defined(D_STRING_CLASS_AVX2) ||                             \
+      defined(D_STRING_CLASS_AVX2_DISPATCH) )
 
-    last_pos     = -1;
-    search_start = _haystack->text;
+/*
+d_string_internal_space_avx2
+  Returns a lane mask of the whitespace bytes of `_v`.
+*/
+D_STRING_CLASS_AVX2_FN static D_INLINE __m256i
+d_string_internal_space_avx2
+(
+    __m256i _v
+)
+{
+    return _mm256_or_si256(
+               _mm256_cmpeq_epi8(_v, _mm256_set1_epi8(' ')),
+               _mm256_cmpeq_epi8(_mm256_setzero_si256(), _mm256_subs_epu8(
+                   _mm256_sub_epi8(_v, _mm256_set1_epi8('\t')),
+                   _mm256_set1_epi8(4))));
+}
 
-    while ((p = strstr(search_start, _needle->text)) != NULL)
-    {
-        last_pos     = (ssize_t)(p - _haystack->text);
-        search_start = p + 1;
-    }
+/*
+d_string_internal_fold_avx2
+  Applies case mapping to `_v`; `_first` holds the first letter of the
+range to map and `_flip` holds 0x20, or zero for no mapping.
+*/
+D_STRING_CLASS_AVX2_FN static D_INLINE __m256i
+d_string_internal_fold_avx2
+(
+    __m256i _v,
+    __m256i _first,
+    __m256i _flip
+)
+{
+    __m256i letters;
+
+    letters = _mm256_cmpeq_epi8(_mm256_setzero_si256(), _mm256_subs_epu8(
+                  _mm256_sub_epi8(_v, _first),
+                  _mm256_set1_epi8(25)));
 
-    return last_pos;
+    return _mm256_xor_si256(_v, _mm256_and_si256(letters, _flip));
 }
 
 /*
-d_string_rfind_cstr
-  Find last occurrence of C string.
-
-Parameter(s):
-  _haystack: d_string to search in.
-  _needle:   C string to search for.
-Return:
-  Index of last occurrence, or -1 if not found.
+d_string_internal_case_copy_avx2
+  AVX2 kernel for `d_string_internal_case_copy`, 32 bytes per step.
 */
-ssize_t
-d_string_rfind_cstr
+D_STRING_CLASS_AVX2_FN static void
+d_string_internal_case_copy_avx2
 (
-    const struct d_string* _haystack,
-    const char*            _needle
+    unsigned char*       _dst,
+    const unsigned char* _src,
+    size_t               _n,
+    unsigned             _fold
 )
 {
-    ssize_t     last_pos;
-    const char* p;
-    const char* search_start;
-
-    if ( (_haystack == NULL) || 
-         (_needle == NULL) )
-    {
-        return -1;
-    }
+    const __m256i first = _mm256_set1_epi8(
+        (_fold == D_STRING_INTERNAL_FOLD_LOWER) ? 'A' : 'a');
+    const __m256i flip  = _mm256_set1_epi8(0x20);
+    size_t        i;
 
-    if (*_needle == '\0')
+    for (i = 0; (i + 32) <= _n; i += 32)
     {
-        return (ssize_t)_haystack->size;
+        _mm256_storeu_si256((__m256i*)(_dst + i),
+            d_string_internal_fold_avx2(
+                _mm256_loadu_si256((const __m256i*)(_src + i)),
+                first,
+                flip));
     }
 
-    last_pos     = -1;
-    search_start = _haystack->text;
-
-    while ((p = strstr(search_start, _needle)) != NULL)
-    {
-        last_pos     = (ssize_t)(p - _haystack->text);
-        search_start = p + 1;
-    }
+    d_string_internal_case_copy_scalar(_dst + i, _src + i, _n - i, _fold);
 
-    return last_pos;
+    return;
 }
 
 /*
-d_string_str
-  Find substring, returning pointer (strstr equivalent).
-
-Parameter(s):
-  _haystack: d_string to search in.
-  _needle:   C string to search for.
-Return:
-  Pointer to substring, or NULL if not found.
+d_string_internal_replace_byte_avx2
+  AVX2 kernel for `d_string_internal_replace_byte`; blocks without a match
+are left untouched so that their cache lines stay clean.
 */
-char*
-d_string_str
+D_STRING_CLASS_AVX2_FN static void
+d_string_internal_replace_byte_avx2
 (
-    const struct d_string* _haystack,
-    const char*            _needle
+    unsigned char* _p,
+    size_t         _n,
+    unsigned char  _old,
+    unsigned char  _new
 )
 {
-    if ( (_haystack == NULL) || 
-         (_needle == NULL) )
+    const __m256i old_v = _mm256_set1_epi8((char)_old);
+    const __m256i new_v = _mm256_set1_epi8((char)_new);
+    __m256i       v;
+    __m256i       hit;
+    size_t        i;
+
+    for (i = 0; (i + 32) <= _n; i += 32)
     {
-        return NULL;
+        v   = _mm256_loadu_si256((const __m256i*)(_p + i));
+        hit = _mm256_cmpeq_epi8(v, old_v);
+
+        if (_mm256_movemask_epi8(hit) != 0)
+        {
+            _mm256_storeu_si256((__m256i*)(_p + i),
+                                _mm256_blendv_epi8(v, new_v, hit));
+        }
     }
 
-    return strstr(_haystack->text, _needle);
+    d_string_internal_replace_byte_scalar(_p + i, _n - i, _old, _new);
+
+    return;
 }
 
 /*
-d_string_casefind
-  Case-insensitive find substring.
-
-Parameter(s):
-  _haystack: d_string to search in.
-  _needle:   d_string to search for.
-Return:
-  Index of substring, or -1 if not found.
+d_string_internal_trim_start_avx2
+  AVX2 kernel for `d_string_internal_trim_start`.
 */
-ssize_t
-d_string_casefind
+D_STRING_CLASS_AVX2_FN static size_t
+d_string_internal_trim_start_avx2
 (
-    const struct d_string* _haystack,
-    const struct d_string* _needle
+    const unsigned char* _p,
+    size_t               _n
 )
 {
-    char* p;
+    uint32_t mask;
+    size_t   i;
 
-    if ( (_haystack == NULL) || 
-         (_needle == NULL) )
+    for (i = 0; (i + 32) <= _n; i += 32)
     {
-        return -1;
+        mask = ~(uint32_t)_mm256_movemask_epi8(d_string_internal_space_avx2(
+                   _mm256_loadu_si256((const __m256i*)(_p + i))));
+
+        if (mask != 0)
+        {
+            return i + d_string_internal_ctz64(mask);
+        }
     }
 
-    p = d_strcasestr(_haystack->text, _needle->text);
+    return i + d_string_internal_trim_start_scalar(_p + i, _n - i);
+}
 
-    if (p == NULL)
+/*
+d_string_internal_trim_end_avx2
+  AVX2 kernel for `d_string_internal_trim_end`.
+*/
+D_STRING_CLASS_AVX2_FN static size_t
+d_string_internal_trim_end_avx2
+(
+    const unsigned char* _p,
+    size_t               _n
+)
+{
+    while ( (_n >= 32) &&
+            (_mm256_movemask_epi8(d_string_internal_space_avx2(
+                 _mm256_loadu_si256((const __m256i*)(_p + _n - 32)))) == -1) )
     {
-        return -1;
+        _n -= 32;
     }
 
-    return (ssize_t)(p - _haystack->text);
+    return d_string_internal_trim_end_scalar(_p, _n);
 }
 
 /*
-d_string_casefind_cstr
-  Case-insensitive find C string.
-
-Parameter(s):
-  _haystack: d_string to search in.
-  _needle:   C string to search for.
-Return:
-  Index of substring, or -1 if not found.
+d_string_internal_reverse_avx2
+  AVX2 kernel for `d_string_internal_reverse`; swaps byte-reversed 32-byte
+blocks from both ends.
 */
-ssize_t
-d_string_casefind_cstr
+D_STRING_CLASS_AVX2_FN static void
+d_string_internal_reverse_avx2
 (
-    const struct d_string* _haystack,
-    const char*            _needle
+    unsigned char* _p,
+    size_t         _n
 )
 {
-    char* p;
-
-    if ( (_haystack == NULL) || 
-         (_needle == NULL) )
-    {
-        return -1;
-    }
+    const __m256i order = _mm256_setr_epi8(
+        15, 14, 13, 12, 11, 10, 9, 8, 7, 6, 5, 4, 3, 2, 1, 0,
+        15, 14, 13, 12, 11, 10, 9, 8, 7, 6, 5, 4, 3, 2, 1, 0);
+    __m256i       head;
+    __m256i       tail;
+    size_t        i;
+    size_t        j;
 
-    p = d_strcasestr(_haystack->text, _needle);
+    i = 0;
+    j = _n;
 
-    if (p == NULL)
+    while ((j - i) >= 64)
     {
-        return -1;
+        head = _mm256_loadu_si256((const __m256i*)(_p + i));
+        tail = _mm256_loadu_si256((const __m256i*)(_p + j - 32));
+        head = _mm256_permute4x64_epi64(_mm256_shuffle_epi8(head, order), 0x4E);
+        tail = _mm256_permute4x64_epi64(_mm256_shuffle_epi8(tail, order), 0x4E);
+        _mm256_storeu_si256((__m256i*)(_p + i), tail);
+        _mm256_storeu_si256((__m256i*)(_p + j - 32), head);
+        i += 32;
+        j -= 32;
     }
 
-    return (ssize_t)(p - _haystack->text);
+    d_string_internal_reverse_scalar(_p + i, j - i);
+
+    return;
 }
 
 /*
-d_string_casestr
-  Case-insensitive substring search returning pointer.
-
-Parameter(s):
-  _haystack: d_string to search in.
-  _needle:   C string to search for.
-Return:
-  Pointer to substring, or NULL if not found.
+d_string_internal_collapse_avx2
+  AVX2 kernel for `d_string_internal_collapse`. A block whose only
+whitespace is isolated ' ' bytes is already collapsed, so it is case-mapped
+and stored whole; other blocks go through the scalar loop.
 */
-char*
-d_string_casestr
+D_STRING_CLASS_AVX2_FN static size_t
+d_string_internal_collapse_avx2
 (
-    const struct d_string* _haystack,
-    const char*            _needle
+    unsigned char*       _dst,
+    const unsigned char* _src,
+    size_t               _n,
+    unsigned             _fold
 )
 {
-    if ( (_haystack == NULL) || 
-         (_needle == NULL) )
-    {
-        return NULL;
+    const __m256i first = _mm256_set1_epi8(
+        (_fold == D_STRING_INTERNAL_FOLD_LOWER) ? 'A' : 'a');
+    const __m256i flip  = _mm256_set1_epi8(
+        (_fold == D_STRING_INTERNAL_FOLD_NONE) ? 0 : 0x20);
+    __m256i       v;
+    uint32_t      space;
+    uint32_t      blank;
+    bool          prev;
+    size_t        i;
+    size_t        w;
+
+    prev = false;
+    w    = 0;
+
+    for (i = 0; (i + 32) <= _n; i += 32)
+    {
+        v     = _mm256_loadu_si256((const __m256i*)(_src + i));
+        space = (uint32_t)_mm256_movemask_epi8(d_string_internal_space_avx2(v));
+        blank = (uint32_t)_mm256_movemask_epi8(
+                    _mm256_cmpeq_epi8(v, _mm256_set1_epi8(' ')));
+
+        if ( (space == blank) &&
+             ((space & ((space << 1) | (uint32_t)prev)) == 0) )
+        {
+            _mm256_storeu_si256((__m256i*)(_dst + w),
+                                d_string_internal_fold_avx2(v, first, flip));
+            w   += 32;
+            prev = ((space >> 31) != 0);
+        }
+        else
+        {
+            w += d_string_internal_collapse_run(_dst + w,
+                                                _src + i,
+                                                32,
+                                                _fold,
+                                                &prev);
+        }
     }
 
-    return d_strcasestr(_haystack->text, _needle);
+    return w + d_string_internal_collapse_run(_dst + w,
+                                              _src + i,
+                                              _n - i,
+                                              _fold,
+                                              &prev);
 }
 
+#endif  // D_STRING_CLASS_AVX2 || D_STRING_CLASS_AVX2_DISPATCH
 
-/******************************************************************************
-* Search Functions - Containment Checks
-******************************************************************************/
+#if defined(D_STRING_CLASS_SSE2)
 
 /*
-d_string_contains
-  Check if d_string contains substring.
-
-Parameter(s):
-  _str:    d_string to search in.
-  _substr: d_string to search for.
-Return:
-  true if _substr is found in _str, false otherwise.
+d_string_internal_space_sse2
+  SSE2 counterpart of `d_string_internal_space_avx2`.
 */
-bool
-d_string_contains
+static D_INLINE __m128i
+d_string_internal_space_sse2
 (
-    const struct d_string* _str,
-    const struct d_string* _substr
+    __m128i _v
 )
 {
-    return (d_string_find(_str, _substr) >= 0);
+    return _mm_or_si128(
+               _mm_cmpeq_epi8(_v, _mm_set1_epi8(' ')),
+               _mm_cmpeq_epi8(_mm_setzero_si128(), _mm_subs_epu8(
+                   _mm_sub_epi8(_v, _mm_set1_epi8('\t')),
+                   _mm_set1_epi8(4))));
 }
 
 /*
-d_string_contains_cstr
-  Check if d_string contains C string.
-
-Parameter(s):
-  _str:    d_string to search in.
-  _substr: C string to search for.
-Return:
-  true if _substr is found in _str, false otherwise.
+d_string_internal_fold_sse2
+  SSE2 counterpart of `d_string_internal_fold_avx2`.
 */
-bool
-d_string_contains_cstr
+static D_INLINE __m128i
+d_string_internal_fold_sse2
 (
-    const struct d_string* _str,
-    const char*            _substr
+    __m128i _v,
+    __m128i _first,
+    __m128i _flip
 )
 {
-    return (d_string_find_cstr(_str, _substr) >= 0);
+    __m128i letters;
+
+    letters = _mm_cmpeq_epi8(_mm_setzero_si128(), _mm_subs_epu8(
+                  _mm_sub_epi8(_v, _first),
+                  _mm_set1_epi8(25)));
+
+    return _mm_xor_si128(_v, _mm_and_si128(letters, _flip));
 }
 
 /*
-d_string_contains_char
-  Check if d_string contains character.
-
-Parameter(s):
-  _str: d_string to search in.
-  _c:   character to search for.
-Return:
-  true if _c is found in _str, false otherwise.
+d_string_internal_reverse16_sse2
+  Reverses the sixteen bytes of `_v` using only SSE2 shuffles: bytes are
+swapped within 16-bit lanes, then the lanes are reversed.
 */
-bool
-d_string_contains_char
+static D_INLINE __m128i
+d_string_internal_reverse16_sse2
 (
-    const struct d_string* _str,
-    char                   _c
+    __m128i _v
 )
 {
-    return (d_string_find_char(_str, _c) >= 0);
+    _v = _mm_or_si128(_mm_slli_epi16(_v, 8), _mm_srli_epi16(_v, 8));
+    _v = _mm_shufflelo_epi16(_v, _MM_SHUFFLE(0, 1, 2, 3));
+    _v = _mm_shufflehi_epi16(_v, _MM_SHUFFLE(0, 1, 2, 3));
+
+    return _mm_shuffle_epi32(_v, _MM_SHUFFLE(1, 0, 3, 2));
 }
 
 /*
-d_string_starts_with
-  Check if d_string starts with prefix.
-
-Parameter(s):
-  _str:    d_string to check.
-  _prefix: d_string prefix.
-Return:
-  true if _str starts with _prefix, false otherwise.
+d_string_internal_case_copy_sse2
+  SSE2 kernel for `d_string_internal_case_copy`, 16 bytes per step.
 */
-bool
-d_string_starts_with
+static void
+d_string_internal_case_copy_sse2
 (
-    const struct d_string* _str,
-    const struct d_string* _prefix
+    unsigned char*       _dst,
+    const unsigned char* _src,
+    size_t               _n,
+    unsigned             _fold
 )
 {
-    if ( (_str == NULL) || 
-         (_prefix == NULL) )
-    {
-        return false;
-    }
+    const __m128i first = _mm_set1_epi8(
+        (_fold == D_STRING_INTERNAL_FOLD_LOWER) ? 'A' : 'a');
+    const __m128i flip  = _mm_set1_epi8(0x20);
+    size_t        i;
 
-    if (_prefix->size > _str->size)
+    for (i = 0; (i + 16) <= _n; i += 16)
     {
-        return false;
+        _mm_storeu_si128((__m128i*)(_dst + i),
+            d_string_internal_fold_sse2(
+                _mm_loadu_si128((const __m128i*)(_src + i)),
+                first,
+                flip));
     }
 
-    return (memcmp(_str->text, _prefix->text, _prefix->size) == 0);
+    d_string_internal_case_copy_scalar(_dst + i, _src + i, _n - i, _fold);
+
+    return;
 }
 
 /*
-d_string_starts_with_cstr
-  Check if d_string starts with C string prefix.
-
-Parameter(s):
-  _str:    d_string to check.
-  _prefix: C string prefix.
-Return:
-  true if _str starts with _prefix, false otherwise.
+d_string_internal_replace_byte_sse2
+  SSE2 counterpart of `d_string_internal_replace_byte_avx2`.
 */
-bool
-d_string_starts_with_cstr
+static void
+d_string_internal_replace_byte_sse2
 (
-    const struct d_string* _str,
-    const char*            _prefix
+    unsigned char* _p,
+    size_t         _n,
+    unsigned char  _old,
+    unsigned char  _new
 )
 {
-    size_t prefix_len;
+    const __m128i old_v = _mm_set1_epi8((char)_old);
+    const __m128i new_v = _mm_set1_epi8((char)_new);
+    __m128i       v;
+    __m128i       hit;
+    size_t        i;
 
-    if ( (_str == NULL) || 
-         (_prefix == NULL) )
+    for (i = 0; (i + 16) <= _n; i += 16)
     {
-        return false;
-    }
-
-    prefix_len = strlen(_prefix);
+        v   = _mm_loadu_si128((const __m128i*)(_p + i));
+        hit = _mm_cmpeq_epi8(v, old_v);
 
-    if (prefix_len > _str->size)
-    {
-        return false;
+        if (_mm_movemask_epi8(hit) != 0)
+        {
+            _mm_storeu_si128((__m128i*)(_p + i),
+                             _mm_or_si128(_mm_andnot_si128(hit, v),
+                                          _mm_and_si128(hit, new_v)));
+        }
     }
 
-    return (memcmp(_str->text, _prefix, prefix_len) == 0);
+    d_string_internal_replace_byte_scalar(_p + i, _n - i, _old, _new);
+
+    return;
 }
 
 /*
-d_string_ends_with
-  Check if d_string ends with suffix.
-
-Parameter(s):
-  _str:    d_string to check.
-  _suffix: d_string suffix.
-Return:
-  true if _str ends with _suffix, false otherwise.
+d_string_internal_trim_start_sse2
+  SSE2 kernel for `d_string_internal_trim_start`.
 */
-bool
-d_string_ends_with
+static size_t
+d_string_internal_trim_start_sse2
 (
-    const struct d_string* _str,
-    const struct d_string* _suffix
+    const unsigned char* _p,
+    size_t               _n
 )
 {
-    size_t offset;
+    uint32_t mask;
+    size_t   i;
 
-    if ( (_str == NULL) || 
-         (_suffix == NULL) )
+    for (i = 0; (i + 16) <= _n; i += 16)
     {
-        return false;
-    }
+        mask = 0xFFFFu & ~(uint32_t)_mm_movemask_epi8(
+                   d_string_internal_space_sse2(
+                       _mm_loadu_si128((const __m128i*)(_p + i))));
 
-    if (_suffix->size > _str->size)
-    {
-        return false;
+        if (mask != 0)
+        {
+            return i + d_string_internal_ctz64(mask);
+        }
     }
 
-    offset = _str->size - _suffix->size;
-
-    return (memcmp(_str->text + offset, _suffix->text, _suffix->size) == 0);
+    return i + d_string_internal_trim_start_scalar(_p + i, _n - i);
 }
 
 /*
-d_string_ends_with_cstr
-  Check if d_string ends with C string suffix.
-
-Parameter(s):
-  _str:    d_string to check.
-  _suffix: C string suffix.
-Return:
-  true if _str ends with _suffix, false otherwise.
+d_string_internal_trim_end_sse2
+  SSE2 kernel for `d_string_internal_trim_end`.
 */
-bool
-d_string_ends_with_cstr
+static size_t
+d_string_internal_trim_end_sse2
 (
-    const struct d_string* _str,
-    const char*            _suffix
+    const unsigned char* _p,
+    size_t               _n
 )
 {
-    size_t suffix_len;
-    size_t offset;
-
-    if ( (_str == NULL) || 
-         (_suffix == NULL) )
+    while ( (_n >= 16) &&
+            (_mm_movemask_epi8(d_string_internal_space_sse2(
+                 _mm_loadu_si128((const __m128i*)(_p + _n - 16)))) == 0xFFFF) )
     {
-        return false;
+        _n -= 16;
     }
 
-    suffix_len = strlen(_suffix);
+    return d_string_internal_trim_end_scalar(_p, _n);
+}
 
-    if (suffix_len > _str->size)
-    {
-        return false;
+/*
+d_string_internal_reverse_sse2
+  SSE2 kernel for `d_string_internal_reverse`.
+*/
+static void
+d_string_internal_reverse_sse2
+(
+    unsigned char* _p,
+    size_t         _n
+)
+{
+    __m128i head;
+    __m128i tail;
+    size_t  i;
+    size_t  j;
+
+    i = 0;
+    j = _n;
+
+    while ((j - i) >= 32)
+    {
+        head = _mm_loadu_si128((const __m128i*)(_p + i));
+        tail = _mm_loadu_si128((const __m128i*)(_p + j - 16));
+        _mm_storeu_si128((__m128i*)(_p + i),
+                         d_string_internal_reverse16_sse2(tail));
+        _mm_storeu_si128((__m128i*)(_p + j - 16),
+                         d_string_internal_reverse16_sse2(head));
+        i += 16;
+        j -= 16;
     }
 
-    offset = _str->size - suffix_len;
+    d_string_internal_reverse_scalar(_p + i, j - i);
 
-    return (memcmp(_str->text + offset, _suffix, suffix_len) == 0);
+    return;
 }
 
 /*
-d_string_spn
-  Get length of initial segment containing only characters in accept.
+d_string_internal_collapse_sse2
+  SSE2 counterpart of `d_string_internal_collapse_avx2`.
+*/
+static size_t
+d_string_internal_collapse_sse2
+(
+    unsigned char*       _dst,
+    const unsigned char* _src,
+    size_t               _n,
+    unsigned             _fold
+)
+{
+    const __m128i first = _mm_set1_epi8(
+        (_fold == D_STRING_INTERNAL_FOLD_LOWER) ? 'A' : 'a');
+    const __m128i flip  = _mm_set1_epi8(
+        (_fold == D_STRING_INTERNAL_FOLD_NONE) ? 0 : 0x20);
+    __m128i       v;
+    uint32_t      space;
+    uint32_t      blank;
+    bool          prev;
+    size_t        i;
+    size_t        w;
+
+    prev = false;
+    w    = 0;
+
+    for (i = 0; (i + 16) <= _n; i += 16)
+    {
+        v     = _mm_loadu_si128((const __m128i*)(_src + i));
+        space = (uint32_t)_mm_movemask_epi8(d_string_internal_space_sse2(v));
+        blank = (uint32_t)_mm_movemask_epi8(
+                    _mm_cmpeq_epi8(v, _mm_set1_epi8(' ')));
+
+        if ( (space == blank) &&
+             ((space & ((space << 1) | (uint32_t)prev)) == 0) )
+        {
+            _mm_storeu_si128((__m128i*)(_dst + w),
+                             d_string_internal_fold_sse2(v, first, flip));
+            w   += 16;
+            prev = ((space >> 15) != 0);
+        }
+        else
+        {
+            w += d_string_internal_collapse_run(_dst + w,
+                                                _src + i,
+                                                16,
+                                                _fold,
+                                                &prev);
+        }
+    }
 
-Parameter(s):
-  _str:    d_string to scan.
-  _accept: string of accepted characters.
-Return:
-  Length of initial segment.
+    return w + d_string_internal_collapse_run(_dst + w,
+                                              _src + i,
+                                              _n - i,
+                                              _fold,
+                                              &prev);
+}
+
+#elif defined(D_STRING_CLASS_NEON)
+
+/*
+d_string_internal_space_neon
+  NEON counterpart of `d_string_internal_space_avx2`.
 */
-size_t
-d_string_spn
+static D_INLINE uint8x16_t
+d_string_internal_space_neon
 (
-    const struct d_string* _str,
-    const char*            _accept
+    uint8x16_t _v
 )
 {
-    if ( (_str == NULL) || 
-         (_accept == NULL) )
+    return vorrq_u8(vceqq_u8(_v, vdupq_n_u8(' ')),
+                    vcleq_u8(vsubq_u8(_v, vdupq_n_u8('\t')), vdupq_n_u8(4)));
+}
+
+/*
+d_string_internal_fold_neon
+  NEON counterpart of `d_string_internal_fold_avx2`.
+*/
+static D_INLINE uint8x16_t
+d_string_internal_fold_neon
+(
+    uint8x16_t _v,
+    uint8x16_t _first,
+    uint8x16_t _flip
+)
+{
+    return veorq_u8(_v, vandq_u8(vcleq_u8(vsubq_u8(_v, _first),
+                                          vdupq_n_u8(25)),
+                                 _flip));
+}
+
+/*
+d_string_internal_case_copy_neon
+  NEON kernel for `d_string_internal_case_copy`, 16 bytes per step.
+*/
+static void
+d_string_internal_case_copy_neon
+(
+    unsigned char*       _dst,
+    const unsigned char* _src,
+    size_t               _n,
+    unsigned             _fold
+)
+{
+    const uint8x16_t first = vdupq_n_u8(
+        (_fold == D_STRING_INTERNAL_FOLD_LOWER) ? 'A' : 'a');
+    const uint8x16_t flip  = vdupq_n_u8(0x20);
+    size_t           i;
+
+    for (i = 0; (i + 16) <= _n; i += 16)
     {
-        return 0;
+        vst1q_u8(_dst + i,
+                 d_string_internal_fold_neon(vld1q_u8(_src + i), first, flip));
     }
 
-    return strspn(_str->text, _accept);
+    d_string_internal_case_copy_scalar(_dst + i, _src + i, _n - i, _fold);
+
+    return;
 }
 
 /*
-d_string_cspn
-  Get length of initial segment not containing characters in reject.
+d_string_internal_replace_byte_neon
+  NEON counterpart of `d_string_internal_replace_byte_avx2`.
+*/
+static void
+d_string_internal_replace_byte_neon
+(
+    unsigned char* _p,
+    size_t         _n,
+    unsigned char  _old,
+    unsigned char  _new
+)
+{
+    const uint8x16_t old_v = vdupq_n_u8(_old);
+    const uint8x16_t new_v = vdupq_n_u8(_new);
+    uint8x16_t       v;
+    uint8x16_t       hit;
+    size_t           i;
 
-Parameter(s):
-  _str:    d_string to scan.
-  _reject: string of rejected characters.
-Return:
-  Length of initial segment.
+    for (i = 0; (i + 16) <= _n; i += 16)
+    {
+        v   = vld1q_u8(_p + i);
+        hit = vceqq_u8(v, old_v);
+
+        if (d_string_internal_any_neon(hit))
+        {
+            vst1q_u8(_p + i, vbslq_u8(hit, new_v, v));
+        }
+    }
+
+    d_string_internal_replace_byte_scalar(_p + i, _n - i, _old, _new);
+
+    return;
+}
+
+/*
+d_string_internal_trim_start_neon
+  NEON kernel for `d_string_internal_trim_start`; whole whitespace blocks
+are skipped and the scalar loop locates the boundary.
 */
-size_t
-d_string_cspn
+static size_t
+d_string_internal_trim_start_neon
 (
-    const struct d_string* _str,
-    const char*            _reject
+    const unsigned char* _p,
+    size_t               _n
 )
 {
-    if ( (_str == NULL) || 
-         (_reject == NULL) )
+    size_t i;
+
+    for (i = 0;
+         ((i + 16) <= _n) &&
+         !d_string_internal_any_neon(vmvnq_u8(
+             d_string_internal_space_neon(vld1q_u8(_p + i))));
+         i += 16)
     {
-        return 0;
     }
 
-    return strcspn(_str->text, _reject);
+    return i + d_string_internal_trim_start_scalar(_p + i, _n - i);
 }
 
 /*
-d_string_pbrk
-  Find first occurrence of any character from accept string.
+d_string_internal_trim_end_neon
+  NEON kernel for `d_string_internal_trim_end`.
+*/
+static size_t
+d_string_internal_trim_end_neon
+(
+    const unsigned char* _p,
+    size_t               _n
+)
+{
+    while ( (_n >= 16) &&
+            !d_string_internal_any_neon(vmvnq_u8(
+                d_string_internal_space_neon(vld1q_u8(_p + _n - 16)))) )
+    {
+        _n -= 16;
+    }
 
-Parameter(s):
-  _str:    d_string to search.
-  _accept: string of characters to find.
-Return:
-  Pointer to first matching character, or NULL if none found.
+    return d_string_internal_trim_end_scalar(_p, _n);
+}
+
+/*
+d_string_internal_reverse_neon
+  NEON kernel for `d_string_internal_reverse`.
 */
-char*
-d_string_pbrk
+static void
+d_string_internal_reverse_neon
 (
-    const struct d_string* _str,
-    const char*            _accept
+    unsigned char* _p,
+    size_t         _n
 )
 {
-    if ( (_str == NULL) || 
-         (_accept == NULL) )
+    uint8x16_t head;
+    uint8x16_t tail;
+    size_t     i;
+    size_t     j;
+
+    i = 0;
+    j = _n;
+
+    while ((j - i) >= 32)
     {
-        return NULL;
+        head = vrev64q_u8(vld1q_u8(_p + i));
+        tail = vrev64q_u8(vld1q_u8(_p + j - 16));
+        vst1q_u8(_p + i, vextq_u8(tail, tail, 8));
+        vst1q_u8(_p + j - 16, vextq_u8(head, head, 8));
+        i += 16;
+        j -= 16;
     }
 
-    return strpbrk(_str->text, _accept);
+    d_string_internal_reverse_scalar(_p + i, j - i);
+
+    return;
+}
+
+/*
+d_string_internal_collapse_neon
+  NEON counterpart of `d_string_internal_collapse_avx2`. Whitespace that
+follows whitespace is found by shifting the block's whitespace mask by one
+lane, carrying in the state of the previous block.
+*/
+static size_t
+d_string_internal_collapse_neon
+(
+    unsigned char*       _dst,
+    const unsigned char* _src,
+    size_t               _n,
+    unsigned             _fold
+)
+{
+    const uint8x16_t first = vdupq_n_u8(
+        (_fold == D_STRING_INTERNAL_FOLD_LOWER) ? 'A' : 'a');
+    const uint8x16_t flip  = vdupq_n_u8(
+        (_fold == D_STRING_INTERNAL_FOLD_NONE) ? 0 : 0x20);
+    uint8x16_t       v;
+    uint8x16_t       space;
+    uint8x16_t       bad;
+    bool             prev;
+    size_t           i;
+    size_t           w;
+
+    prev = false;
+    w    = 0;
+
+    for (i = 0; (i + 16) <= _n; i += 16)
+    {
+        v     = vld1q_u8(_src + i);
+        space = d_string_internal_space_neon(v);
+        bad   = vorrq_u8(
+                    vbicq_u8(space, vceqq_u8(v, vdupq_n_u8(' '))),
+                    vandq_u8(space, vextq_u8(vdupq_n_u8(prev ? 0xFF : 0),
+                                             space,
+                                             15)));
+
+        if (!d_string_internal_any_neon(bad))
+        {
+            vst1q_u8(_dst + w, d_string_internal_fold_neon(v, first, flip));
+            w   += 16;
+            prev = (vgetq_lane_u8(space, 15) != 0);
+        }
+        else
+        {
+            w += d_string_internal_collapse_run(_dst + w,
+                                                _src + i,
+                                                16,
+                                                _fold,
+                                                &prev);
+        }
+    }
+
+    return w + d_string_internal_collapse_run(_dst + w,
+                                              _src + i,
+                                              _n - i,
+                                              _fold,
+                                              &prev);
 }
 
+#endif  // D_STRING_CLASS_SSE2 / D_STRING_CLASS_NEON
 
 /******************************************************************************
-* Modification Functions - Assignment
+* Internal Search Kernels
 ******************************************************************************/
 
 /*
-d_string_assign
-  Assign content from another d_string.
+d_string_internal_pair_scan_scalar
+  Scans positions `[0, _count)`, a block of D_STRING_SEARCH_BLOCK at a time,
+for the first `i` with `_a[i] == _ca` and `_b[i] == _cb`. Returns the offset
+of the block holding it and stores in `_mask` one bit per matching position
+of that block. If no block matches, stores 0 and returns the first position
+not scanned; fewer than D_STRING_SEARCH_BLOCK positions are left after it.
+*/
+static size_t
+d_string_internal_pair_scan_scalar
+(
+    const unsigned char* _a,
+    const unsigned char* _b,
+    size_t               _count,
+    unsigned char        _ca,
+    unsigned char        _cb,
+    uint64_t*            _mask
+)
+{
+    const unsigned char* p;
+    size_t               i;
+    size_t               end;
+    size_t               block;
+    uint64_t             mask;
 
-Parameter(s):
-  _str:   d_string to modify.
-  _other: source d_string.
-Return:
-  true if successful, false otherwise.
+    i   = 0;
+    end = _count - (_count % D_STRING_SEARCH_BLOCK);
+
+    while (i < end)
+    {
+        p = (const unsigned char*)memchr(_a + i, _ca, end - i);
+
+        if (p == NULL)
+        {
+            break;
+        }
+
+        i = (size_t)(p - _a);
+
+        if (_b[i] == _cb)
+        {
+            block = i - (i % D_STRING_SEARCH_BLOCK);
+            mask  = 0;
+
+            for (; i < (block + D_STRING_SEARCH_BLOCK); i++)
+            {
+                if ( (_a[i] == _ca) &&
+                     (_b[i] == _cb) )
+                {
+                    mask |= (uint64_t)1 << (i - block);
+                }
+            }
+
+            *_mask = mask;
+
+            return block;
+        }
+
+        i++;
+    }
+
+    *_mask = 0;
+
+    return end;
+}
+
+#if ( defined(D_STRING_CLASS_AVX2) ||                             \
+      defined(D_STRING_CLASS_AVX2_DISPATCH) )
+
+/*
+d_string_internal_pair_block_avx2
+  Returns true if any of the D_STRING_SEARCH_BLOCK positions has `_va` at
+`_a` and `_vb` at `_b`, storing one bit per such position in `_mask`.
 */
-bool
-d_string_assign
+D_STRING_CLASS_AVX2_FN static D_INLINE bool
+d_string_internal_pair_block_avx2
 (
-    struct d_string*       _str,
-    const struct d_string* _other
+    const unsigned char* _a,
+    const unsigned char* _b,
+    __m256i              _va,
+    __m256i              _vb,
+    uint64_t*            _mask
 )
 {
-    if ( (_str == NULL) || 
-         (_other == NULL) )
+    __m256i lo;
+    __m256i hi;
+    __m256i any;
+
+    // `_va` holds the rarer byte: skip the loads from `_b` while it is absent
+    lo  = _mm256_cmpeq_epi8(_va, _mm256_loadu_si256((const __m256i*)_a));
+    hi  = _mm256_cmpeq_epi8(_va, _mm256_loadu_si256((const __m256i*)(_a + 32)));
+    any = _mm256_or_si256(lo, hi);
+
+    if (_mm256_testz_si256(any, any))
+    {
+        return false;
+    }
+
+    lo  = _mm256_and_si256(lo,
+        _mm256_cmpeq_epi8(_vb, _mm256_loadu_si256((const __m256i*)_b)));
+    hi  = _mm256_and_si256(hi,
+        _mm256_cmpeq_epi8(_vb, _mm256_loadu_si256((const __m256i*)(_b + 32))));
+    any = _mm256_or_si256(lo, hi);
+
+    if (_mm256_testz_si256(any, any))
+    {
+        return false;
+    }
+
+    *_mask = (uint64_t)(uint32_t)_mm256_movemask_epi8(lo)
+           | ((uint64_t)(uint32_t)_mm256_movemask_epi8(hi) << 32);
+
+    return true;
+}
+
+/*
+d_string_internal_pair_scan_avx2
+  AVX2 version of d_string_internal_pair_scan_scalar.
+*/
+D_STRING_CLASS_AVX2_FN static size_t
+d_string_internal_pair_scan_avx2
+(
+    const unsigned char* _a,
+    const unsigned char* _b,
+    size_t               _count,
+    unsigned char        _ca,
+    unsigned char        _cb,
+    uint64_t*            _mask
+)
+{
+    const __m256i va = _mm256_set1_epi8((char)_ca);
+    const __m256i vb = _mm256_set1_epi8((char)_cb);
+    size_t        i;
+
+    i = 0;
+
+    // after the first block, realign so that only the loads from `_b` can
+    // straddle cache lines; the overlap was just found to hold no match
+    if (_count >= D_STRING_SEARCH_BLOCK)
+    {
+        if (d_string_internal_pair_block_avx2(_a, _b, va, vb, _mask))
+        {
+            return 0;
+        }
+
+        i = D_STRING_SEARCH_BLOCK -
+            ((uintptr_t)_a % D_STRING_SEARCH_BLOCK);
+    }
+
+    for (; (i + D_STRING_SEARCH_BLOCK) <= _count; i += D_STRING_SEARCH_BLOCK)
+    {
+        if (d_string_internal_pair_block_avx2(_a + i, _b + i, va, vb, _mask))
+        {
+            return i;
+        }
+    }
+
+    *_mask = 0;
+
+    return i;
+}
+
+#endif  // D_STRING_CLASS_AVX2 || D_STRING_CLASS_AVX2_DISPATCH
+
+#if defined(D_STRING_CLASS_SSE2)
+
+/*
+d_string_internal_byte_mask_sse2
+  Returns 0xFF in each of the 16 lanes at which `_p` holds `_v`.
+*/
+static D_INLINE __m128i
+d_string_internal_byte_mask_sse2
+(
+    const unsigned char* _p,
+    __m128i              _v
+)
+{
+    return _mm_cmpeq_epi8(_v, _mm_loadu_si128((const __m128i*)_p));
+}
+
+/*
+d_string_internal_pair_block_sse2
+  SSE2 version of d_string_internal_pair_block_avx2.
+*/
+static D_INLINE bool
+d_string_internal_pair_block_sse2
+(
+    const unsigned char* _a,
+    const unsigned char* _b,
+    __m128i              _va,
+    __m128i              _vb,
+    uint64_t*            _mask
+)
+{
+    __m128i m0;
+    __m128i m1;
+    __m128i m2;
+    __m128i m3;
+
+    // skip the loads from `_b` while the rarer byte is absent
+    m0 = d_string_internal_byte_mask_sse2(_a,      _va);
+    m1 = d_string_internal_byte_mask_sse2(_a + 16, _va);
+    m2 = d_string_internal_byte_mask_sse2(_a + 32, _va);
+    m3 = d_string_internal_byte_mask_sse2(_a + 48, _va);
+
+    if (_mm_movemask_epi8(_mm_or_si128(_mm_or_si128(m0, m1),
+                                       _mm_or_si128(m2, m3))) == 0)
     {
         return false;
     }
 
-    return (d_string_copy_s(_str, _other) == 0);
+    m0 = _mm_and_si128(m0, d_string_internal_byte_mask_sse2(_b,      _vb));
+    m1 = _mm_and_si128(m1, d_string_internal_byte_mask_sse2(_b + 16, _vb));
+    m2 = _mm_and_si128(m2, d_string_internal_byte_mask_sse2(_b + 32, _vb));
+    m3 = _mm_and_si128(m3, d_string_internal_byte_mask_sse2(_b + 48, _vb));
+
+    if (_mm_movemask_epi8(_mm_or_si128(_mm_or_si128(m0, m1),
+                                       _mm_or_si128(m2, m3))) == 0)
+    {
+        return false;
+    }
+
+    *_mask = (uint64_t)(uint32_t)_mm_movemask_epi8(m0)
+           | ((uint64_t)(uint32_t)_mm_movemask_epi8(m1) << 16)
+           | ((uint64_t)(uint32_t)_mm_movemask_epi8(m2) << 32)
+           | ((uint64_t)(uint32_t)_mm_movemask_epi8(m3) << 48);
+
+    return true;
+}
+
+/*
+d_string_internal_pair_scan_sse2
+  SSE2 version of d_string_internal_pair_scan_scalar.
+*/
+static size_t
+d_string_internal_pair_scan_sse2
+(
+    const unsigned char* _a,
+    const unsigned char* _b,
+    size_t               _count,
+    unsigned char        _ca,
+    unsigned char        _cb,
+    uint64_t*            _mask
+)
+{
+    const __m128i va = _mm_set1_epi8((char)_ca);
+    const __m128i vb = _mm_set1_epi8((char)_cb);
+    size_t        i;
+
+    i = 0;
+
+    // realign after the first block, as in the AVX2 version
+    if (_count >= D_STRING_SEARCH_BLOCK)
+    {
+        if (d_string_internal_pair_block_sse2(_a, _b, va, vb, _mask))
+        {
+            return 0;
+        }
+
+        i = D_STRING_SEARCH_BLOCK -
+            ((uintptr_t)_a % D_STRING_SEARCH_BLOCK);
+    }
+
+    for (; (i + D_STRING_SEARCH_BLOCK) <= _count; i += D_STRING_SEARCH_BLOCK)
+    {
+        if (d_string_internal_pair_block_sse2(_a + i, _b + i, va, vb, _mask))
+        {
+            return i;
+        }
+    }
+
+    *_mask = 0;
+
+    return i;
+}
+
+#elif defined(D_STRING_CLASS_NEON)
+
+/*
+d_string_internal_pair_bits_neon
+  Returns a 16-bit mask with one bit per 0x00/0xFF lane of `_m`.
+*/
+static D_INLINE uint64_t
+d_string_internal_pair_bits_neon
+(
+    uint8x16_t _m
+)
+{
+    uint64_t nibbles;
+    uint64_t bits;
+
+    // narrow each lane to a nibble, then keep one bit per nibble
+    nibbles = vget_lane_u64(vreinterpret_u64_u8(vshrn_n_u16(
+                  vreinterpretq_u16_u8(_m), 4)), 0) & 0x8888888888888888ULL;
+    bits    = 0;
+
+    while (nibbles != 0)
+    {
+        bits    |= (uint64_t)1 << (d_string_internal_ctz64(nibbles) >> 2);
+        nibbles &= (nibbles - 1);
+    }
+
+    return bits;
+}
+
+/*
+d_string_internal_pair_block_neon
+  NEON version of d_string_internal_pair_block_avx2.
+*/
+static D_INLINE bool
+d_string_internal_pair_block_neon
+(
+    const unsigned char* _a,
+    const unsigned char* _b,
+    uint8x16_t           _va,
+    uint8x16_t           _vb,
+    uint64_t*            _mask
+)
+{
+    uint8x16_t m0;
+    uint8x16_t m1;
+    uint8x16_t m2;
+    uint8x16_t m3;
+    uint64x2_t any;
+
+    // skip the loads from `_b` while the rarer byte is absent
+    m0  = vceqq_u8(_va, vld1q_u8(_a));
+    m1  = vceqq_u8(_va, vld1q_u8(_a + 16));
+    m2  = vceqq_u8(_va, vld1q_u8(_a + 32));
+    m3  = vceqq_u8(_va, vld1q_u8(_a + 48));
+    any = vreinterpretq_u64_u8(vorrq_u8(vorrq_u8(m0, m1), vorrq_u8(m2, m3)));
+
+    if ((vgetq_lane_u64(any, 0) | vgetq_lane_u64(any, 1)) == 0)
+    {
+        return false;
+    }
+
+    m0  = vandq_u8(m0, vceqq_u8(_vb, vld1q_u8(_b)));
+    m1  = vandq_u8(m1, vceqq_u8(_vb, vld1q_u8(_b + 16)));
+    m2  = vandq_u8(m2, vceqq_u8(_vb, vld1q_u8(_b + 32)));
+    m3  = vandq_u8(m3, vceqq_u8(_vb, vld1q_u8(_b + 48)));
+    any = vreinterpretq_u64_u8(vorrq_u8(vorrq_u8(m0, m1), vorrq_u8(m2, m3)));
+
+    if ((vgetq_lane_u64(any, 0) | vgetq_lane_u64(any, 1)) == 0)
+    {
+        return false;
+    }
+
+    *_mask = d_string_internal_pair_bits_neon(m0)
+           | (d_string_internal_pair_bits_neon(m1) << 16)
+           | (d_string_internal_pair_bits_neon(m2) << 32)
+           | (d_string_internal_pair_bits_neon(m3) << 48);
+
+    return true;
+}
+
+/*
+d_string_internal_pair_scan_neon
+  NEON version of d_string_internal_pair_scan_scalar.
+*/
+static size_t
+d_string_internal_pair_scan_neon
+(
+    const unsigned char* _a,
+    const unsigned char* _b,
+    size_t               _count,
+    unsigned char        _ca,
+    unsigned char        _cb,
+    uint64_t*            _mask
+)
+{
+    const uint8x16_t va = vdupq_n_u8(_ca);
+    const uint8x16_t vb = vdupq_n_u8(_cb);
+    size_t           i;
+
+    for (i = 0;
+         (i + D_STRING_SEARCH_BLOCK) <= _count;
+         i += D_STRING_SEARCH_BLOCK)
+    {
+        if (d_string_internal_pair_block_neon(_a + i, _b + i, va, vb, _mask))
+        {
+            return i;
+        }
+    }
+
+    *_mask = 0;
+
+    return i;
+}
+
+#endif  // D_STRING_CLASS_SSE2 / D_STRING_CLASS_NEON
+
+/******************************************************************************
+* Internal Kernel Dispatch
+******************************************************************************/
+
+// d_string_internal_kernels
+//   struct: one implementation of each vectorized kernel. A table exists for
+// every tier compiled in: scalar always, SSE2 or NEON as the build baseline,
+// and AVX2 when targeted or dispatched. The first call through
+// `d_string_internal_kernels_get` picks the best table the CPU supports, as
+// reported by `d_env_cpu_features` (so the DJINTERP_CPU override applies),
+// and later calls reuse it.
+struct d_string_internal_kernels
+{
+    bool   (*all_class)(const unsigned char*, size_t, unsigned);
+    size_t (*count)(const unsigned char*, size_t, unsigned char, unsigned char);
+    bool   (*ascii)(const unsigned char*, size_t);
+    bool   (*utf8)(const unsigned char*, size_t);
+    void   (*case_copy)(unsigned char*, const unsigned char*, size_t, unsigned);
+    void   (*replace_byte)(unsigned char*, size_t, unsigned char, unsigned char);
+    size_t (*trim_start)(const unsigned char*, size_t);
+    size_t (*trim_end)(const unsigned char*, size_t);
+    void   (*reverse)(unsigned char*, size_t);
+    size_t (*collapse)(unsigned char*, const unsigned char*, size_t, unsigned);
+    size_t (*pair_scan)(const unsigned char*, const unsigned char*, size_t,
+                        unsigned char, unsigned char, uint64_t*);
+};
+
+static const struct d_string_internal_kernels
+d_string_internal_kernels_scalar =
+{
+    d_string_internal_all_class_scalar,
+    d_string_internal_count_scalar,
+    d_string_internal_ascii_scalar,
+    d_string_internal_utf8_scalar,
+    d_string_internal_case_copy_scalar,
+    d_string_internal_replace_byte_scalar,
+    d_string_internal_trim_start_scalar,
+    d_string_internal_trim_end_scalar,
+    d_string_internal_reverse_scalar,
+    d_string_internal_collapse_scalar,
+    d_string_internal_pair_scan_scalar
+};
+
+#if ( defined(D_STRING_CLASS_AVX2) ||                             \
+      defined(D_STRING_CLASS_AVX2_DISPATCH) )
+
+static const struct d_string_internal_kernels
+d_string_internal_kernels_avx2 =
+{
+    d_string_internal_all_class_avx2,
+    d_string_internal_count_avx2,
+    d_string_internal_ascii_avx2,
+    d_string_internal_utf8_avx2,
+    d_string_internal_case_copy_avx2,
+    d_string_internal_replace_byte_avx2,
+    d_string_internal_trim_start_avx2,
+    d_string_internal_trim_end_avx2,
+    d_string_internal_reverse_avx2,
+    d_string_internal_collapse_avx2,
+    d_string_internal_pair_scan_avx2
+};
+
+#endif  // D_STRING_CLASS_AVX2 || D_STRING_CLASS_AVX2_DISPATCH
+
+#if defined(D_STRING_CLASS_SSE2)
+
+static const struct d_string_internal_kernels
+d_string_internal_kernels_sse2 =
+{
+    d_string_internal_all_class_sse2,
+    d_string_internal_count_sse2,
+    d_string_internal_ascii_sse2,
+    d_string_internal_utf8_scalar,    // validation needs a byte shuffle
+    d_string_internal_case_copy_sse2,
+    d_string_internal_replace_byte_sse2,
+    d_string_internal_trim_start_sse2,
+    d_string_internal_trim_end_sse2,
+    d_string_internal_reverse_sse2,
+    d_string_internal_collapse_sse2,
+    d_string_internal_pair_scan_sse2
+};
+
+#elif defined(D_STRING_CLASS_NEON)
+
+static const struct d_string_internal_kernels
+d_string_internal_kernels_neon =
+{
+    d_string_internal_all_class_neon,
+    d_string_internal_count_neon,
+    d_string_internal_ascii_neon,
+#if defined(__aarch64__) || defined(_M_ARM64)
+    d_string_internal_utf8_neon,
+#else
+    d_string_internal_utf8_scalar,    // validation needs vqtbl1q_u8
+#endif
+    d_string_internal_case_copy_neon,
+    d_string_internal_replace_byte_neon,
+    d_string_internal_trim_start_neon,
+    d_string_internal_trim_end_neon,
+    d_string_internal_reverse_neon,
+    d_string_internal_collapse_neon,
+    d_string_internal_pair_scan_neon
+};
+
+#endif  // D_STRING_CLASS_SSE2 / D_STRING_CLASS_NEON
+
+// the resolved table; concurrent first calls store the same pointer
+static const struct d_string_internal_kernels* volatile
+d_string_internal_kernels_active = NULL;
+
+/*
+d_string_internal_kernels_get
+  Returns the kernel table for the running CPU, resolving it on first use.
+*/
+static D_INLINE const struct d_string_internal_kernels*
+d_string_internal_kernels_get
+(
+    void
+)
+{
+    const struct d_string_internal_kernels* kernels;
+    uint32_t                                features;
+
+    kernels = d_string_internal_kernels_active;
+
+    if (kernels != NULL)
+    {
+        return kernels;
+    }
+
+    features = d_env_cpu_features();
+    kernels  = &d_string_internal_kernels_scalar;
+
+#if defined(D_STRING_CLASS_SSE2)
+    if (features & D_ENV_CPU_FEATURE_SSE2)
+    {
+        kernels = &d_string_internal_kernels_sse2;
+    }
+#elif defined(D_STRING_CLASS_NEON)
+    if (features & D_ENV_CPU_FEATURE_NEON)
+    {
+        kernels = &d_string_internal_kernels_neon;
+    }
+#endif
+
+#if ( defined(D_STRING_CLASS_AVX2) ||                             \
+      defined(D_STRING_CLASS_AVX2_DISPATCH) )
+    if (features & D_ENV_CPU_FEATURE_AVX2)
+    {
+        kernels = &d_string_internal_kernels_avx2;
+    }
+#endif
+
+    d_string_internal_kernels_active = kernels;
+
+    return kernels;
+}
+
+/*
+d_string_internal_all_class
+  Returns true if every byte of `_p[0.._n)` belongs to a class in `_cls`,
+using the widest kernel available.
+*/
+static bool
+d_string_internal_all_class
+(
+    const unsigned char* _p,
+    size_t               _n,
+    unsigned             _cls
+)
+{
+    return d_string_internal_kernels_get()->all_class(_p, _n, _cls);
+}
+
+/*
+d_string_internal_count
+  Counts the bytes `b` of `_p[0.._n)` for which `(b & _mask) == _value`,
+using the widest kernel available.
+*/
+static size_t
+d_string_internal_count
+(
+    const unsigned char* _p,
+    size_t               _n,
+    unsigned char        _mask,
+    unsigned char        _value
+)
+{
+    return d_string_internal_kernels_get()->count(_p, _n, _mask, _value);
+}
+
+/*
+d_string_internal_is_ascii
+  Returns true if `_p[0.._n)` contains only 7-bit bytes, using the widest
+kernel available.
+*/
+static bool
+d_string_internal_is_ascii
+(
+    const unsigned char* _p,
+    size_t               _n
+)
+{
+    return d_string_internal_kernels_get()->ascii(_p, _n);
+}
+
+/*
+d_string_internal_utf8_valid
+  Returns true if `_p[0.._n)` is well-formed UTF-8, using the vectorized
+validator where a byte-shuffle instruction is available (AVX2, AArch64 NEON)
+and the scalar one otherwise.
+*/
+static bool
+d_string_internal_utf8_valid
+(
+    const unsigned char* _p,
+    size_t               _n
+)
+{
+    return d_string_internal_kernels_get()->utf8(_p, _n);
+}
+
+/*
+d_string_internal_case_copy
+  Copies `_src[0.._n)` to `_dst` applying case mapping `_fold`, using the
+widest kernel available. `_dst` may equal `_src` or precede it.
+*/
+static void
+d_string_internal_case_copy
+(
+    unsigned char*       _dst,
+    const unsigned char* _src,
+    size_t               _n,
+    unsigned             _fold
+)
+{
+    if (_fold == D_STRING_INTERNAL_FOLD_NONE)
+    {
+        if (_dst != _src)
+        {
+            memmove(_dst, _src, _n);
+        }
+
+        return;
+    }
+
+    d_string_internal_kernels_get()->case_copy(_dst, _src, _n, _fold);
+
+    return;
+}
+
+/*
+d_string_internal_replace_byte
+  Replaces every `_old` byte of `_p[0.._n)` with `_new`, using the widest
+kernel available.
+*/
+static void
+d_string_internal_replace_byte
+(
+    unsigned char* _p,
+    size_t         _n,
+    unsigned char  _old,
+    unsigned char  _new
+)
+{
+    d_string_internal_kernels_get()->replace_byte(_p, _n, _old, _new);
+
+    return;
+}
+
+/*
+d_string_internal_trim_start
+  Returns the index of the first non-whitespace byte of `_p[0.._n)`, or `_n`
+if there is none. The first byte is tested directly, since most strings do
+not start with whitespace.
+*/
+static size_t
+d_string_internal_trim_start
+(
+    const unsigned char* _p,
+    size_t               _n
+)
+{
+    if ( (_n == 0) ||
+         !d_string_internal_class_byte(_p[0], D_STRING_INTERNAL_CLASS_SPACE) )
+    {
+        return 0;
+    }
+
+    return d_string_internal_kernels_get()->trim_start(_p, _n);
+}
+
+/*
+d_string_internal_trim_end
+  Returns one past the index of the last non-whitespace byte of `_p[0.._n)`,
+or 0 if there is none. The last byte is tested directly, since most strings
+do not end with whitespace.
+*/
+static size_t
+d_string_internal_trim_end
+(
+    const unsigned char* _p,
+    size_t               _n
+)
+{
+    if ( (_n == 0) ||
+         !d_string_internal_class_byte(_p[_n - 1],
+                                       D_STRING_INTERNAL_CLASS_SPACE) )
+    {
+        return _n;
+    }
+
+    return d_string_internal_kernels_get()->trim_end(_p, _n);
+}
+
+/*
+d_string_internal_reverse
+  Reverses `_p[0.._n)` in place, using the widest kernel available.
+*/
+static void
+d_string_internal_reverse
+(
+    unsigned char* _p,
+    size_t         _n
+)
+{
+    d_string_internal_kernels_get()->reverse(_p, _n);
+
+    return;
+}
+
+/*
+d_string_internal_collapse
+  Copies `_src[0.._n)` to `_dst` applying case mapping `_fold` and replacing
+each whitespace run with one space, using the widest kernel available.
+Returns the number of bytes written; `_dst` may equal `_src` or precede it.
+*/
+static size_t
+d_string_internal_collapse
+(
+    unsigned char*       _dst,
+    const unsigned char* _src,
+    size_t               _n,
+    unsigned             _fold
+)
+{
+    if (_n < 16)
+    {
+        return d_string_internal_collapse_scalar(_dst, _src, _n, _fold);
+    }
+
+    return d_string_internal_kernels_get()->collapse(_dst, _src, _n, _fold);
+}
+
+/******************************************************************************
+* Internal Search Entry Points
+******************************************************************************/
+
+/*
+d_string_internal_search_filter
+  Scans for candidate positions at which the needle's two rarest bytes (see
+d_string_internal_search_pair) both match, and verifies each: an 8-byte
+needle prefix rejects most of them without a call to memcmp. Stops with
+`*_pos` set to the first unexamined position once the remaining candidates
+no longer fill a block, or once verification work exceeds the linear budget.
+*/
+static const char*
+d_string_internal_search_filter
+(
+    const unsigned char* _h,
+    size_t               _hn,
+    const unsigned char* _n,
+    size_t               _nn,
+    size_t*              _pos
+)
+{
+    const struct d_string_internal_kernels* kernels;
+    size_t                                  i;
+    size_t                                  limit;
+    size_t                                  work;
+    size_t                                  first;
+    size_t                                  second;
+    size_t                                  candidate;
+    uint64_t                                mask;
+    uint64_t                                head;
+    uint64_t                                word;
+
+    kernels = d_string_internal_kernels_get();
+
+    d_string_internal_search_pair(_n, _nn, &first, &second);
+
+    head = 0;
+
+    if (_nn >= sizeof(head))
+    {
+        memcpy(&head, _n, sizeof(head));
+    }
+
+    i     = 0;
+    work  = 0;
+    limit = _hn - _nn + 1;  // number of candidate start positions
+
+    for (;;)
+    {
+        i += kernels->pair_scan(_h + i + first,
+                                _h + i + second,
+                                limit - i,
+                                _n[first],
+                                _n[second],
+                                &mask);
+
+        if (mask == 0)
+        {
+            break;
+        }
+
+        for (; mask != 0; mask &= (mask - 1))
+        {
+            candidate = i + d_string_internal_ctz64(mask);
+
+            if (_nn >= sizeof(word))
+            {
+                memcpy(&word, _h + candidate, sizeof(word));
+
+                if (word != head)
+                {
+                    work += sizeof(word);
+
+                    continue;
+                }
+            }
+
+            if (memcmp(_h + candidate, _n, _nn) == 0)
+            {
+                return (const char*)(_h + candidate);
+            }
+
+            work += _nn;
+        }
+
+        i += D_STRING_SEARCH_BLOCK;
+
+        // too many false positives; let Two-Way take over
+        if (work > ((i * D_STRING_SEARCH_VERIFY_RATIO) +
+                    D_STRING_SEARCH_VERIFY_SLACK))
+        {
+            break;
+        }
+    }
+
+    *_pos = i;
+
+    return NULL;
+}
+
+/*
+d_string_internal_search
+  Finds the first occurrence of `_needle` (of length `_nn`) within `_h` (of
+length `_hn`). Binary-safe: embedded null bytes are ordinary data, and nothing
+past `_h + _hn` is read. Worst-case linear time.
+*/
+static const char*
+d_string_internal_search
+(
+    const char* _h,
+    size_t      _hn,
+    const char* _needle,
+    size_t      _nn
+)
+{
+    struct d_string_internal_twoway tw;
+    const unsigned char*            h;
+    const unsigned char*            n;
+    const char*                     found;
+    size_t                          pos;
+
+    if (_nn == 0)
+    {
+        return _h;
+    }
+
+    if ( (_h == NULL) ||
+         (_nn > _hn) )
+    {
+        return NULL;
+    }
+
+    if (_nn == 1)
+    {
+        return (const char*)memchr(_h, (unsigned char)_needle[0], _hn);
+    }
+
+    h     = (const unsigned char*)_h;
+    n     = (const unsigned char*)_needle;
+    pos   = 0;
+    found = d_string_internal_search_filter(h, _hn, n, _nn, &pos);
+
+    if ( (found != NULL) ||
+         ((_hn - pos) < _nn) )
+    {
+        return found;
+    }
+
+    d_string_internal_twoway_prepare(n, _nn, false, &tw);
+
+    return d_string_internal_twoway_find(h + pos, _hn - pos, n, _nn, &tw);
+}
+
+/*
+d_string_internal_rsearch
+  Finds the last occurrence of `_needle` (of length `_nn`) within `_h` (of
+length `_hn`). Binary-safe and worst-case linear time.
+*/
+static const char*
+d_string_internal_rsearch
+(
+    const char* _h,
+    size_t      _hn,
+    const char* _needle,
+    size_t      _nn
+)
+{
+    struct d_string_internal_twoway tw;
+    size_t                          i;
+
+    if (_nn == 0)
+    {
+        return (_h != NULL) ? (_h + _hn) : NULL;
+    }
+
+    if ( (_h == NULL) ||
+         (_nn > _hn) )
+    {
+        return NULL;
+    }
+
+    if (_nn == 1)
+    {
+        for (i = _hn; i > 0; i--)
+        {
+            if (_h[i - 1] == _needle[0])
+            {
+                return _h + (i - 1);
+            }
+        }
+
+        return NULL;
+    }
+
+    d_string_internal_twoway_prepare((const unsigned char*)_needle,
+                                     _nn,
+                                     true,
+                                     &tw);
+
+    return d_string_internal_twoway_rfind((const unsigned char*)_h,
+                                          _hn,
+                                          (const unsigned char*)_needle,
+                                          _nn,
+                                          &tw);
+}
+
+
+/******************************************************************************
+* Creation and Destruction Functions
+******************************************************************************/
+
+/*
+d_string_new
+  Creates an empty d_string with default capacity.
+
+Parameter(s):
+  (none)
+Return:
+  A pointer value corresponding to either:
+  - newly allocated d_string, if successful, or
+  - NULL, if memory allocation failed.
+*/
+struct d_string*
+d_string_new
+(
+    void
+)
+{
+    return d_string_new_with_capacity(16);
+}
+
+/*
+d_string_new_with_capacity
+  Creates an empty d_string with specified initial capacity, allocated from
+d_allocator_default (see d_string_new_ex).
+
+Parameter(s):
+  _capacity: initial capacity in bytes (including space for null terminator).
+Return:
+  A pointer value corresponding to either:
+  - newly allocated d_string, if successful, or
+  - NULL, if memory allocation failed.
+*/
+struct d_string*
+d_string_new_with_capacity
+(
+    size_t _capacity
+)
+{
+    const struct d_allocator* allocator;
+
+    // the system allocator keeps the heap path free of indirect calls
+    allocator = d_allocator_default();
+
+    if (allocator != d_allocator_system())
+    {
+        return d_string_new_ex(allocator, _capacity);
+    }
+
+    return d_string_internal_new_heap(_capacity, D_STRING_INTERNAL_SITE);
+}
+
+/*
+d_string_new_from_cstr
+  Creates a d_string from a null-terminated C string.
+
+Parameter(s):
+  _cstr: null-terminated source string to copy.
+Return:
+  A pointer value corresponding to either:
+  - newly allocated d_string containing copy of _cstr, if successful, or
+  - NULL, if _cstr was NULL or memory allocation failed.
+*/
+struct d_string*
+d_string_new_from_cstr
+(
+    const char* _cstr
+)
+{
+    size_t           len;
+    size_t           capacity;
+    struct d_string* str;
+
+    if (_cstr == NULL)
+    {
+        return NULL;
+    }
+
+    len      = strlen(_cstr);
+    capacity = len + 1;
+
+    str = d_string_new_with_capacity(capacity);
+
+    if (str == NULL)
+    {
+        return NULL;
+    }
+
+    d_memcpy(str->text, _cstr, len + 1);
+    str->size = len;
+
+    return str;
+}
+
+/*
+d_string_new_from_cstr_n
+  Creates a d_string from at most n characters of a C string.
+
+Parameter(s):
+  _cstr:   source string to copy from.
+  _length: maximum number of characters to copy.
+Return:
+  A pointer value corresponding to either:
+  - newly allocated d_string, if successful, or
+  - NULL, if _cstr was NULL or memory allocation failed.
+*/
+struct d_string*
+d_string_new_from_cstr_n
+(
+    const char* _cstr,
+    size_t      _length
+)
+{
+    size_t           actual_len;
+    size_t           capacity;
+    struct d_string* str;
+
+    if (_cstr == NULL)
+    {
+        return NULL;
+    }
+
+    actual_len = d_strnlen(_cstr, _length);
+    capacity   = actual_len + 1;
+
+    str = d_string_new_with_capacity(capacity);
+
+    if (str == NULL)
+    {
+        return NULL;
+    }
+
+    d_memcpy(str->text, _cstr, actual_len);
+    str->text[actual_len] = '\0';
+    str->size             = actual_len;
+
+    return str;
+}
+
+/*
+d_string_new_from_buffer
+  Creates a d_string from a buffer of specified length (not necessarily 
+null-terminated).
+
+Parameter(s):
+  _buffer: source buffer to copy from.
+  _length: number of bytes to copy.
+Return:
+  A pointer value corresponding to either:
+  - newly allocated d_string, if successful, or
+  - NULL, if _buffer was NULL or memory allocation failed.
+*/
+struct d_string*
+d_string_new_from_buffer
+(
+    const char* _buffer,
+    size_t      _length
+)
+{
+    return d_string_new_from_buffer_ex(NULL, _buffer, _length);
+}
+
+/*
+d_string_new_copy
+  Creates a copy of an existing d_string. Copies of strings at least
+D_STRING_SHARE_THRESHOLD bytes long share the original's buffer until either
+is modified; shorter strings are copied outright.
+
+Parameter(s):
+  _other: d_string to copy.
+Return:
+  A pointer value corresponding to either:
+  - newly allocated d_string copy, if successful, or
+  - NULL, if _other was NULL or memory allocation failed.
+*/
+struct d_string*
+d_string_new_copy
+(
+    const struct d_string* _other
+)
+{
+    return d_string_new_copy_ex(NULL, _other);
+}
+
+/*
+d_string_new_fill
+  Creates a d_string filled with a repeated character.
+
+Parameter(s):
+  _length:    number of times to repeat the character.
+  _fill_char: character to fill with.
+Return:
+  A pointer value corresponding to either:
+  - newly allocated d_string, if successful, or
+  - NULL, if memory allocation failed.
+*/
+struct d_string*
+d_string_new_fill
+(
+    size_t _length,
+    char   _fill_char
+)
+{
+    struct d_string* str;
+
+    str = d_string_new_with_capacity(_length + 1);
+
+    if (str == NULL)
+    {
+        return NULL;
+    }
+
+    d_memset(str->text, _fill_char, _length);
+    str->text[_length] = '\0';
+    str->size          = _length;
+
+    return str;
+}
+
+/*
+d_string_new_formatted
+  Creates a d_string using printf-style formatting.
+
+Parameter(s):
+  _format: printf-style format string.
+  ...:     format arguments.
+Return:
+  A pointer value corresponding to either:
+  - newly allocated d_string, if successful, or
+  - NULL, if _format was NULL or memory allocation failed.
+*/
+struct d_string*
+d_string_new_formatted
+(
+    const char* _format, 
+    ...
+)
+{
+    va_list          args;
+    struct d_string* str;
+
+    if (_format == NULL)
+    {
+        return NULL;
+    }
+
+    va_start(args, _format);
+    str = d_string_vprintf(_format, args);
+    va_end(args);
+
+    return str;
+}
+
+/*
+d_string_new_ex
+  Creates an empty d_string with at least the specified capacity, allocating
+the struct and its text from `_allocator`. With the system allocator this is
+d_string_new_with_capacity; with any other, the string is allocator-backed
+(see D_STRING_FLAG_ALLOCATOR): its text grows through the same allocator and
+is never shared, and d_string_free returns both to it.
+
+Parameter(s):
+  _allocator: the allocator, or NULL for d_allocator_default.
+  _capacity:  initial capacity (including space for the null terminator).
+Return:
+  A pointer value corresponding to either:
+  - the new d_string, if successful, or
+  - NULL, if the allocator failed.
+*/
+struct d_string*
+d_string_new_ex
+(
+    const struct d_allocator* _allocator,
+    size_t                    _capacity
+)
+{
+    struct d_string_internal_allocated* header;
+    struct d_string*                    str;
+
+    if (_allocator == NULL)
+    {
+        _allocator = d_allocator_default();
+    }
+
+    if (_allocator == d_allocator_system())
+    {
+        return d_string_internal_new_heap(_capacity, D_STRING_INTERNAL_SITE);
+    }
+
+    header = (struct d_string_internal_allocated*)d_allocator_alloc(
+                 _allocator,
+                 sizeof(struct d_string_internal_allocated));
+
+    if (header == NULL)
+    {
+        return NULL;
+    }
+
+    header->allocator = _allocator;
+    str               = &header->string;
+
+    d_string_internal_init(str);
+    str->growth = D_STRING_DEFAULT_GROWTH;
+    str->flags  = D_STRING_FLAG_ALLOCATOR;
+
+    // only strings that cannot fit inline need a separate buffer
+    if ( (_capacity > D_STRING_SSO_CAPACITY) &&
+         (!d_string_internal_allocator_grow(str, _capacity)) )
+    {
+        d_allocator_free(_allocator,
+                         header,
+                         sizeof(struct d_string_internal_allocated));
+
+        return NULL;
+    }
+
+    return str;
+}
+
+/*
+d_string_new_from_cstr_ex
+  Creates a d_string from a null-terminated C string, allocated from
+`_allocator` (see d_string_new_ex).
+
+Parameter(s):
+  _allocator: the allocator, or NULL for d_allocator_default.
+  _cstr:      source C string.
+Return:
+  A pointer value corresponding to either:
+  - the new d_string, if successful, or
+  - NULL, if _cstr was NULL or the allocator failed.
+*/
+struct d_string*
+d_string_new_from_cstr_ex
+(
+    const struct d_allocator* _allocator,
+    const char*               _cstr
+)
+{
+    if (_cstr == NULL)
+    {
+        return NULL;
+    }
+
+    return d_string_new_from_buffer_ex(_allocator, _cstr, strlen(_cstr));
+}
+
+/*
+d_string_new_from_buffer_ex
+  Creates a d_string from a buffer of specified length, which need not be
+null-terminated, allocated from `_allocator` (see d_string_new_ex).
+
+Parameter(s):
+  _allocator: the allocator, or NULL for d_allocator_default.
+  _buffer:    source buffer to copy from.
+  _length:    number of bytes to copy.
+Return:
+  A pointer value corresponding to either:
+  - the new d_string, if successful, or
+  - NULL, if _buffer was NULL or the allocator failed.
+*/
+struct d_string*
+d_string_new_from_buffer_ex
+(
+    const struct d_allocator* _allocator,
+    const char*               _buffer,
+    size_t                    _length
+)
+{
+    struct d_string* str;
+
+    if ( (_buffer == NULL) ||
+         (_length == SIZE_MAX) )
+    {
+        return NULL;
+    }
+
+    str = d_string_new_ex(_allocator, _length + 1);
+
+    if (str == NULL)
+    {
+        return NULL;
+    }
+
+    d_memcpy(str->text, _buffer, _length);
+    str->text[_length] = '\0';
+    str->size          = _length;
+
+    return str;
+}
+
+/*
+d_string_new_copy_ex
+  Creates a copy of an existing d_string, allocated from `_allocator` (see
+d_string_new_ex). Only heap copies may share the original's buffer (see
+d_string_new_copy).
+
+Parameter(s):
+  _allocator: the allocator, or NULL for d_allocator_default.
+  _other:     d_string to copy.
+Return:
+  A pointer value corresponding to either:
+  - the new d_string, if successful, or
+  - NULL, if _other was NULL or the allocator failed.
+*/
+struct d_string*
+d_string_new_copy_ex
+(
+    const struct d_allocator* _allocator,
+    const struct d_string*    _other
+)
+{
+    struct d_string* str;
+
+    if (_other == NULL)
+    {
+        return NULL;
+    }
+
+    if (_allocator == NULL)
+    {
+        _allocator = d_allocator_default();
+    }
+
+    if ( (_allocator != d_allocator_system()) ||
+         (!d_string_internal_can_share(_other)) )
+    {
+        return d_string_new_from_buffer_ex(_allocator,
+                                           _other->text,
+                                           _other->size);
+    }
+
+    str = (struct d_string*)D_MEMORY_ALLOC(D_MEMORY_MODULE_STRING,
+                                           sizeof(struct d_string));
+
+    if (str == NULL)
+    {
+        return NULL;
+    }
+
+    str->growth = D_STRING_DEFAULT_GROWTH;
+    d_string_internal_share(str, _other);
+
+    return str;
+}
+
+/*
+d_string_arena_new
+  Creates an empty d_string in an arena with at least the specified capacity;
+d_string_new_ex with d_arena_allocator. The struct and its text come from
+`_arena` and grow within it, so a whole parse or request can build strings
+freely and release them all with d_arena_reset or d_arena_free; d_string_free
+on such a string does nothing. The string must not outlive the arena or be
+used after the arena is rolled back past it.
+
+Parameter(s):
+  _arena:    the arena to allocate from.
+  _capacity: initial capacity (including space for the null terminator).
+Return:
+  A pointer value corresponding to either:
+  - the new d_string, if successful, or
+  - NULL, if _arena was NULL or the arena could not allocate.
+*/
+struct d_string*
+d_string_arena_new
+(
+    struct d_arena* _arena,
+    size_t          _capacity
+)
+{
+    if (_arena == NULL)
+    {
+        return NULL;
+    }
+
+    return d_string_new_ex(d_arena_allocator(_arena), _capacity);
+}
+
+/*
+d_string_arena_new_from_cstr
+  Creates a d_string in an arena from a null-terminated C string (see
+d_string_arena_new).
+
+Parameter(s):
+  _arena: the arena to allocate from.
+  _cstr:  source C string.
+Return:
+  A pointer value corresponding to either:
+  - the new d_string, if successful, or
+  - NULL, if _arena or _cstr was NULL or the arena could not allocate.
+*/
+struct d_string*
+d_string_arena_new_from_cstr
+(
+    struct d_arena* _arena,
+    const char*     _cstr
+)
+{
+    if (_arena == NULL)
+    {
+        return NULL;
+    }
+
+    return d_string_new_from_cstr_ex(d_arena_allocator(_arena), _cstr);
+}
+
+/*
+d_string_arena_new_from_buffer
+  Creates a d_string in an arena from a buffer of specified length, which
+need not be null-terminated (see d_string_arena_new).
+
+Parameter(s):
+  _arena:  the arena to allocate from.
+  _buffer: source buffer to copy from.
+  _length: number of bytes to copy.
+Return:
+  A pointer value corresponding to either:
+  - the new d_string, if successful, or
+  - NULL, if _arena or _buffer was NULL or the arena could not allocate.
+*/
+struct d_string*
+d_string_arena_new_from_buffer
+(
+    struct d_arena* _arena,
+    const char*     _buffer,
+    size_t          _length
+)
+{
+    if (_arena == NULL)
+    {
+        return NULL;
+    }
+
+    return d_string_new_from_buffer_ex(d_arena_allocator(_arena),
+                                       _buffer,
+                                       _length);
+}
+
+/*
+d_string_arena_new_copy
+  Creates a copy of an existing d_string in an arena (see
+d_string_arena_new). The copy never shares the original's buffer.
+
+Parameter(s):
+  _arena: the arena to allocate from.
+  _other: d_string to copy.
+Return:
+  A pointer value corresponding to either:
+  - the new d_string, if successful, or
+  - NULL, if _arena or _other was NULL or the arena could not allocate.
+*/
+struct d_string*
+d_string_arena_new_copy
+(
+    struct d_arena*        _arena,
+    const struct d_string* _other
+)
+{
+    if (_arena == NULL)
+    {
+        return NULL;
+    }
+
+    return d_string_new_copy_ex(d_arena_allocator(_arena), _other);
+}
+
+/*
+d_string_free
+  Frees a d_string and its contents. Allocator-backed strings (see
+D_STRING_FLAG_ALLOCATOR) are returned to their allocator, so for an arena
+this does nothing; the arena releases them.
+
+Parameter(s):
+  _str: d_string to free.
+Return:
+  (none)
+*/
+void
+d_string_free
+(
+    struct d_string* _str
+)
+{
+    if (_str == NULL)
+    {
+        return;
+    }
+
+    d_string_internal_release(_str);
+    d_string_internal_free_header(_str);
+
+    return;
+}
+
+/*
+d_string_free_contents
+  Frees the text buffer of a d_string but not the struct itself.
+
+Parameter(s):
+  _str: d_string whose contents to free.
+Return:
+  (none)
+*/
+void
+d_string_free_contents
+(
+    struct d_string* _str
+)
+{
+    if (_str == NULL)
+    {
+        return;
+    }
+
+    // a shared buffer only loses this reference; other owners keep it
+    d_string_internal_release(_str);
+
+    _str->text     = NULL;
+    _str->size     = 0;
+    _str->capacity = 0;
+    _str->flags   &= ~(D_STRING_FLAG_HASHED | D_STRING_FLAG_COUNTED);
+
+    return;
+}
+
+
+/******************************************************************************
+* Capacity Management Functions
+******************************************************************************/
+
+
+/*
+d_string_reserve
+  Ensures the d_string has at least the specified capacity.
+
+Parameter(s):
+  _str:      d_string to modify.
+  _capacity: minimum capacity to reserve.
+Return:
+  A boolean value corresponding to either:
+  - true, if capacity was reserved successfully, or
+  - false, if _str was NULL or allocation failed.
+*/
+bool
+d_string_reserve
+(
+    struct d_string* _str,
+    size_t           _capacity
+)
+{
+    if (_str == NULL)
+    {
+        return false;
+    }
+
+    // an explicit reservation states the final size; don't over-allocate
+    return d_string_internal_grow_policy(_str,
+                                         _capacity,
+                                         D_STRING_GROWTH_EXACT,
+                                         D_STRING_INTERNAL_SITE);
+}
+
+/*
+d_string_shrink_to_fit
+  Reduces capacity to match the current size. A buffer shared with other
+d_strings (see d_string_is_shared) is not resized unless the contents fit
+back in the inline buffer.
+
+Parameter(s):
+  _str: d_string to shrink.
+Return:
+  A boolean value corresponding to either:
+  - true, if shrinking was successful, or
+  - false, if _str was NULL or reallocation failed.
+*/
+bool
+d_string_shrink_to_fit
+(
+    struct d_string* _str
+)
+{
+    size_t new_capacity;
+    char*  new_text;
+
+    if (_str == NULL)
+    {
+        return false;
+    }
+
+    new_capacity = _str->size + 1;
+
+    // don't shrink if already at minimum
+    if ( (_str->text == NULL)          ||
+         (D_STRING_IS_INLINE(_str))    ||
+         (_str->capacity <= new_capacity) )
+    {
+        return true;
+    }
+
+    // move short contents back into the inline buffer
+    if (new_capacity <= D_STRING_SSO_CAPACITY)
+    {
+        d_memcpy(_str->sso, _str->text, new_capacity);
+        d_string_internal_release(_str);
+
+        _str->text     = _str->sso;
+        _str->capacity = D_STRING_SSO_CAPACITY;
+        _str->flags   &= ~D_STRING_FLAG_COUNTED;
+
+        return true;
+    }
+
+    // resizing a shared buffer would take it from under its other owners
+    if (d_string_internal_is_shared(_str))
+    {
+        return true;
+    }
+
+    // an allocator-backed buffer is resized by its allocator (an arena
+    // returns space only if it is its most recent allocation)
+    if (_str->flags & D_STRING_FLAG_ALLOCATOR)
+    {
+        new_text = (char*)d_allocator_realloc(D_STRING_INTERNAL_ALLOCATOR(_str),
+                                              _str->text,
+                                              _str->capacity,
+                                              new_capacity);
+    }
+    else
+    {
+        new_text = d_string_internal_buffer_resize(_str->text,
+                                                   new_capacity,
+                                                   D_STRING_INTERNAL_SITE);
+    }
+
+    if (new_text == NULL)
+    {
+        return false;
+    }
+
+    _str->text     = new_text;
+    _str->capacity = new_capacity;
+
+    return true;
+}
+
+/*
+d_string_capacity
+  Returns the current capacity of a d_string.
+
+Parameter(s):
+  _str: d_string to query.
+Return:
+  The capacity of the string, or 0 if _str is NULL.
+*/
+size_t
+d_string_capacity
+(
+    const struct d_string* _str
+)
+{
+    if (_str == NULL)
+    {
+        return 0;
+    }
+
+    return _str->capacity;
+}
+
+/*
+d_string_set_growth_policy
+  Sets the strategy used to pick a new capacity whenever the d_string must
+grow to accommodate more text. Existing capacity is left unchanged.
+
+Parameter(s):
+  _str:    d_string to modify.
+  _policy: growth policy to use for subsequent growth.
+Return:
+  A boolean value corresponding to either:
+  - true, if the policy was set, or
+  - false, if _str was NULL or _policy is not a valid policy.
+*/
+bool
+d_string_set_growth_policy
+(
+    struct d_string*            _str,
+    enum d_string_growth_policy _policy
+)
+{
+    if ( (_str == NULL) ||
+         (_policy < D_STRING_GROWTH_DOUBLE) ||
+         (_policy > D_STRING_GROWTH_EXACT) )
+    {
+        return false;
+    }
+
+    _str->growth = _policy;
+
+    return true;
+}
+
+/*
+d_string_get_growth_policy
+  Returns the growth policy currently used by a d_string.
+
+Parameter(s):
+  _str: d_string to query.
+Return:
+  The string's growth policy, or D_STRING_DEFAULT_GROWTH if _str is NULL.
+*/
+enum d_string_growth_policy
+d_string_get_growth_policy
+(
+    const struct d_string* _str
+)
+{
+    if (_str == NULL)
+    {
+        return D_STRING_DEFAULT_GROWTH;
+    }
+
+    return _str->growth;
+}
+
+/*
+d_string_is_shared
+  Reports whether a d_string currently shares its text buffer with another
+d_string (see d_string_new_copy). The answer may change as soon as another
+thread releases or takes a copy; it is meant for diagnostics and tests.
+
+Parameter(s):
+  _str: d_string to query.
+Return:
+  true if another d_string shares the buffer, false otherwise or if _str is
+NULL.
+*/
+bool
+d_string_is_shared
+(
+    const struct d_string* _str
+)
+{
+    return ( (_str != NULL) &&
+             d_string_internal_is_shared(_str) );
+}
+
+
+/*
+d_string_resize
+  Resizes the string to the specified size.
+
+Parameter(s):
+  _str:      d_string to resize.
+  _new_size: new size for the string.
+Return:
+  A boolean value corresponding to either:
+  - true, if resize was successful, or
+  - false, if _str was NULL or allocation failed.
+*/
+bool
+d_string_resize
+(
+    struct d_string* _str,
+    size_t           _new_size
+)
+{
+    if (!d_string_internal_modified(_str, D_STRING_INTERNAL_SITE))
+    {
+        return false;
+    }
+
+    if (_str == NULL)
+    {
+        return false;
+    }
+
+    // grow if needed
+    if (!d_string_internal_grow(_str, _new_size + 1, D_STRING_INTERNAL_SITE))
+    {
+        return false;
+    }
+
+    // if growing, fill with nulls
+    if (_new_size > _str->size)
+    {
+        d_memset(_str->text + _str->size, '\0', _new_size - _str->size);
+    }
+
+    _str->size             = _new_size;
+    _str->text[_new_size]  = '\0';
+
+    return true;
+}
+
+
+/******************************************************************************
+* Access Functions
+******************************************************************************/
+
+/*
+d_string_length
+  Returns the length of the string (excluding null terminator).
+
+Parameter(s):
+  _str: d_string to query.
+Return:
+  The length of the string, or 0 if _str is NULL.
+*/
+size_t
+d_string_length
+(
+    const struct d_string* _str
+)
+{
+    if (_str == NULL)
+    {
+        return 0;
+    }
+
+    return _str->size;
+}
+
+/*
+d_string_size
+  Alias for d_string_length.
+
+Parameter(s):
+  _str: d_string to query.
+Return:
+  The size of the string, or 0 if _str is NULL.
+*/
+size_t
+d_string_size
+(
+    const struct d_string* _str
+)
+{
+    return d_string_length(_str);
+}
+
+/*
+d_string_cstr
+  Returns a const pointer to the null-terminated string data.
+
+Parameter(s):
+  _str: d_string to access.
+Return:
+  A pointer value corresponding to either:
+  - const pointer to the string data, or
+  - NULL, if _str is NULL.
+*/
+const char*
+d_string_cstr
+(
+    const struct d_string* _str
+)
+{
+    if (_str == NULL)
+    {
+        return NULL;
+    }
+
+    return _str->text;
+}
+
+/*
+d_string_data
+  Returns a mutable pointer to the string data. A buffer shared with other
+d_strings is first copied, so writes through the pointer affect only `_str`.
+
+Parameter(s):
+  _str: d_string to access.
+Return:
+  A pointer value corresponding to either:
+  - pointer to the string data, or
+  - NULL, if _str is NULL or its shared buffer could not be copied.
+*/
+char*
+d_string_data
+(
+    struct d_string* _str
+)
+{
+    if (!d_string_internal_modified(_str, D_STRING_INTERNAL_SITE))
+    {
+        return NULL;
+    }
+
+    if (_str == NULL)
+    {
+        return NULL;
+    }
+
+    return _str->text;
+}
+
+/*
+d_string_is_empty
+  Checks if the string is empty.
+
+Parameter(s):
+  _str: d_string to check.
+Return:
+  A boolean value corresponding to either:
+  - true, if _str is NULL or empty, or
+  - false, if _str contains characters.
+*/
+bool
+d_string_is_empty
+(
+    const struct d_string* _str
+)
+{
+    return ( (_str == NULL) || 
+             (_str->size == 0) );
+}
+
+/*
+d_string_char_at
+  Returns the character at the specified index.
+
+Parameter(s):
+  _str:   d_string to access.
+  _index: index of character (negative indices count from end).
+Return:
+  The character at the index, or '\0' if index is invalid.
+*/
+char
+d_string_char_at
+(
+    const struct d_string* _str,
+    d_index                _index
+)
+{
+    size_t pos;
+
+    if (_str == NULL)
+    {
+        return '\0';
+    }
+
+    if (!d_index_convert_safe(_index, _str->size, &pos))
+    {
+        return '\0';
+    }
+
+    return _str->text[pos];
+}
+
+/*
+d_string_set_char
+  Sets the character at the specified index.
+
+Parameter(s):
+  _str:   d_string to modify.
+  _index: index of character (negative indices count from end).
+  _c:     character to set.
+Return:
+  A boolean value corresponding to either:
+  - true, if character was set successfully, or
+  - false, if _str was NULL or index was invalid.
+*/
+bool
+d_string_set_char
+(
+    struct d_string* _str,
+    d_index          _index,
+    char             _c
+)
+{
+    size_t pos;
+
+    if (!d_string_internal_modified(_str, D_STRING_INTERNAL_SITE))
+    {
+        return false;
+    }
+
+    if (_str == NULL)
+    {
+        return false;
+    }
+
+    if (!d_index_convert_safe(_index, _str->size, &pos))
+    {
+        return false;
+    }
+
+    _str->text[pos] = _c;
+
+    return true;
+}
+
+/*
+d_string_front
+  Returns the first character of the string.
+
+Parameter(s):
+  _str: d_string to access.
+Return:
+  The first character, or '\0' if string is empty or NULL.
+*/
+char
+d_string_front
+(
+    const struct d_string* _str
+)
+{
+    if ( (_str == NULL) || 
+         (_str->size == 0) )
+    {
+        return '\0';
+    }
+
+    return _str->text[0];
+}
+
+/*
+d_string_back
+  Returns the last character of the string.
+
+Parameter(s):
+  _str: d_string to access.
+Return:
+  The last character, or '\0' if string is empty or NULL.
+*/
+char
+d_string_back
+(
+    const struct d_string* _str
+)
+{
+    if ( (_str == NULL) || 
+         (_str->size == 0) )
+    {
+        return '\0';
+    }
+
+    return _str->text[_str->size - 1];
+}
+
+
+/******************************************************************************
+* Safe Copy Functions
+******************************************************************************/
+
+/*
+d_string_copy_s
+  Safe copy from d_string to d_string. A source at least
+D_STRING_SHARE_THRESHOLD bytes long is not copied: `_dest` releases its own
+buffer and shares the source's until either is modified.
+
+Parameter(s):
+  _dest: destination d_string.
+  _src:  source d_string.
+Return:
+  An integer value corresponding to either:
+  - 0, if copy was successful,
+  - EINVAL, if either parameter was NULL,
+  - ENOMEM, if `_dest` shared its buffer and could not be given its own, or
+  - ERANGE, if `_dest` could not grow to hold the copy.
+*/
+int
+d_string_copy_s
+(
+    struct d_string* restrict       _dest,
+    const struct d_string* restrict _src
+)
+{
+    if ( (_dest == NULL) || 
+         (_src == NULL) )
+    {
+        return EINVAL;
+    }
+
+    // an allocator-backed string cannot hold a reference to a heap buffer
+    if ( d_string_internal_can_share(_src) &&
+         (!(_dest->flags & D_STRING_FLAG_ALLOCATOR)) )
+    {
+        // already sharing the source's buffer
+        if (_dest->text == _src->text)
+        {
+            return 0;
+        }
+
+        d_string_internal_release(_dest);
+        d_string_internal_share(_dest, _src);
+
+        return 0;
+    }
+
+    if (!d_string_internal_modified(_dest, D_STRING_INTERNAL_SITE))
+    {
+        return ENOMEM;
+    }
+
+    if (!d_string_internal_grow(_dest, _src->size + 1, D_STRING_INTERNAL_SITE))
+    {
+        return ERANGE;
+    }
+
+    d_memcpy(_dest->text, _src->text, _src->size + 1);
+    _dest->size = _src->size;
+
+    return 0;
+}
+
+/*
+d_string_copy_cstr_s
+  Safe copy from C string to d_string.
+
+Parameter(s):
+  _dest: destination d_string.
+  _src:  source C string.
+Return:
+  An integer value corresponding to either:
+  - 0, if copy was successful, or
+  - EINVAL, if either parameter was NULL.
+*/
+int
+d_string_copy_cstr_s
+(
+    struct d_string* restrict _dest,
+    const char* restrict      _src
+)
+{
+    size_t len;
+
+    if (!d_string_internal_modified(_dest, D_STRING_INTERNAL_SITE))
+    {
+        return ENOMEM;
+    }
+
+    if ( (_dest == NULL) || 
+         (_src == NULL) )
+    {
+        return EINVAL;
+    }
+
+    len = strlen(_src);
+
+    if (!d_string_internal_grow(_dest, len + 1, D_STRING_INTERNAL_SITE))
+    {
+        return ERANGE;
+    }
+
+    d_memcpy(_dest->text, _src, len + 1);
+    _dest->size = len;
+
+    return 0;
+}
+
+/*
+d_string_ncopy_s
+  Safe bounded copy from d_string to d_string.
+
+Parameter(s):
+  _dest:  destination d_string.
+  _src:   source d_string.
+  _count: maximum number of characters to copy.
+Return:
+  An integer value corresponding to either:
+  - 0, if copy was successful, or
+  - EINVAL, if either parameter was NULL.
+*/
+int
+d_string_ncopy_s
+(
+    struct d_string* restrict       _dest,
+    const struct d_string* restrict _src,
+    size_t                          _count
+)
+{
+    size_t copy_len;
+
+    if (!d_string_internal_modified(_dest, D_STRING_INTERNAL_SITE))
+    {
+        return ENOMEM;
+    }
+
+    if ( (_dest == NULL) || 
+         (_src == NULL) )
+    {
+        return EINVAL;
+    }
+
+    copy_len = (_count < _src->size) ? _count : _src->size;
+
+    if (!d_string_internal_grow(_dest, copy_len + 1, D_STRING_INTERNAL_SITE))
+    {
+        return ERANGE;
+    }
+
+    d_memcpy(_dest->text, _src->text, copy_len);
+    _dest->text[copy_len] = '\0';
+    _dest->size           = copy_len;
+
+    return 0;
+}
+
+/*
+d_string_ncopy_cstr_s
+  Safe bounded copy from C string to d_string.
+
+Parameter(s):
+  _dest:  destination d_string.
+  _src:   source C string.
+  _count: maximum number of characters to copy.
+Return:
+  An integer value corresponding to either:
+  - 0, if copy was successful, or
+  - EINVAL, if either parameter was NULL.
+*/
+int
+d_string_ncopy_cstr_s
+(
+    struct d_string* restrict _dest,
+    const char* restrict      _src,
+    size_t                    _count
+)
+{
+    size_t copy_len;
+
+    if (!d_string_internal_modified(_dest, D_STRING_INTERNAL_SITE))
+    {
+        return ENOMEM;
+    }
+
+    if ( (_dest == NULL) || 
+         (_src == NULL) )
+    {
+        return EINVAL;
+    }
+
+    copy_len = d_strnlen(_src, _count);
+
+    if (!d_string_internal_grow(_dest, copy_len + 1, D_STRING_INTERNAL_SITE))
+    {
+        return ERANGE;
+    }
+
+    d_memcpy(_dest->text, _src, copy_len);
+    _dest->text[copy_len] = '\0';
+    _dest->size           = copy_len;
+
+    return 0;
+}
+
+/*
+d_string_to_buffer_s
+  Safe copy from d_string to char buffer.
+
+Parameter(s):
+  _dest:      destination buffer.
+  _dest_size: size of destination buffer.
+  _src:       source d_string.
+Return:
+  An integer value corresponding to either:
+  - 0, if copy was successful, or
+  - EINVAL, if _dest or _src was NULL, or
+  - ERANGE, if destination buffer is too small.
+*/
+int
+d_string_to_buffer_s
+(
+    char* restrict                  _dest,
+    size_t                          _dest_size,
+    const struct d_string* restrict _src
+)
+{
+    if ( (_dest == NULL) || 
+         (_src == NULL) )
+    {
+        return EINVAL;
+    }
+
+    if (_dest_size == 0)
+    {
+        return ERANGE;
+    }
+
+    if (_src->size >= _dest_size)
+    {
+        _dest[0] = '\0';
+
+        return ERANGE;
+    }
+
+    d_memcpy(_dest, _src->text, _src->size + 1);
+
+    return 0;
+}
+
+
+/******************************************************************************
+* Concatenation Functions
+******************************************************************************/
+
+/*
+d_string_cat_s
+  Safe concatenation of d_string to d_string.
+
+Parameter(s):
+  _dest: destination d_string.
+  _src:  source d_string to append.
+Return:
+  An integer value corresponding to either:
+  - 0, if concatenation was successful, or
+  - EINVAL, if either parameter was NULL.
+*/
+int
+d_string_cat_s
+(
+    struct d_string* restrict       _dest,
+    const struct d_string* restrict _src
+)
+{
+    size_t new_size;
+
+    if (!d_string_internal_modified(_dest, D_STRING_INTERNAL_SITE))
+    {
+        return ENOMEM;
+    }
+
+    if ( (_dest == NULL) || 
+         (_src == NULL) )
+    {
+        return EINVAL;
+    }
+
+    new_size = _dest->size + _src->size;
+
+    if (!d_string_internal_grow(_dest, new_size + 1, D_STRING_INTERNAL_SITE))
+    {
+        return ERANGE;
+    }
+
+    d_memcpy(_dest->text + _dest->size, _src->text, _src->size + 1);
+    _dest->size = new_size;
+
+    return 0;
+}
+
+/*
+d_string_cat_cstr_s
+  Safe concatenation of C string to d_string.
+
+Parameter(s):
+  _dest: destination d_string.
+  _src:  source C string to append.
+Return:
+  An integer value corresponding to either:
+  - 0, if concatenation was successful, or
+  - EINVAL, if either parameter was NULL.
+*/
+int
+d_string_cat_cstr_s
+(
+    struct d_string* restrict _dest,
+    const char* restrict      _src
+)
+{
+    size_t src_len;
+    size_t new_size;
+
+    if (!d_string_internal_modified(_dest, D_STRING_INTERNAL_SITE))
+    {
+        return ENOMEM;
+    }
+
+    if ( (_dest == NULL) || 
+         (_src == NULL) )
+    {
+        return EINVAL;
+    }
+
+    src_len  = strlen(_src);
+    new_size = _dest->size + src_len;
+
+    if (!d_string_internal_grow(_dest, new_size + 1, D_STRING_INTERNAL_SITE))
+    {
+        return ERANGE;
+    }
+
+    d_memcpy(_dest->text + _dest->size, _src, src_len + 1);
+    _dest->size = new_size;
+
+    return 0;
+}
+
+/*
+d_string_ncat_s
+  Safe bounded concatenation of d_string to d_string.
+
+Parameter(s):
+  _dest:  destination d_string.
+  _src:   source d_string to append.
+  _count: maximum number of characters to append.
+Return:
+  An integer value corresponding to either:
+  - 0, if concatenation was successful, or
+  - EINVAL, if either parameter was NULL.
+*/
+int
+d_string_ncat_s
+(
+    struct d_string* restrict       _dest,
+    const struct d_string* restrict _src,
+    size_t                          _count
+)
+{
+    size_t append_len;
+    size_t new_size;
+
+    if (!d_string_internal_modified(_dest, D_STRING_INTERNAL_SITE))
+    {
+        return ENOMEM;
+    }
+
+    if ( (_dest == NULL) || 
+         (_src == NULL) )
+    {
+        return EINVAL;
+    }
+
+    append_len = (_count < _src->size) ? _count : _src->size;
+    new_size   = _dest->size + append_len;
+
+    if (!d_string_internal_grow(_dest, new_size + 1, D_STRING_INTERNAL_SITE))
+    {
+        return ERANGE;
+    }
+
+    d_memcpy(_dest->text + _dest->size, _src->text, append_len);
+    _dest->size            = new_size;
+    _dest->text[new_size]  = '\0';
+
+    return 0;
+}
+
+/*
+d_string_ncat_cstr_s
+  Safe bounded concatenation of C string to d_string.
+
+Parameter(s):
+  _dest:  destination d_string.
+  _src:   source C string to append.
+  _count: maximum number of characters to append.
+Return:
+  An integer value corresponding to either:
+  - 0, if concatenation was successful, or
+  - EINVAL, if either parameter was NULL.
+*/
+int
+d_string_ncat_cstr_s
+(
+    struct d_string* restrict _dest,
+    const char* restrict      _src,
+    size_t                    _count
+)
+{
+    size_t append_len;
+    size_t new_size;
+
+    if (!d_string_internal_modified(_dest, D_STRING_INTERNAL_SITE))
+    {
+        return ENOMEM;
+    }
+
+    if ( (_dest == NULL) || 
+         (_src == NULL) )
+    {
+        return EINVAL;
+    }
+
+    append_len = d_strnlen(_src, _count);
+    new_size   = _dest->size + append_len;
+
+    if (!d_string_internal_grow(_dest, new_size + 1, D_STRING_INTERNAL_SITE))
+    {
+        return ERANGE;
+    }
+
+    d_memcpy(_dest->text + _dest->size, _src, append_len);
+    _dest->size            = new_size;
+    _dest->text[new_size]  = '\0';
+
+    return 0;
+}
+
+
+/******************************************************************************
+* Duplication Functions
+******************************************************************************/
+
+/*
+d_string_dup
+  Duplicate a d_string.
+
+Parameter(s):
+  _str: d_string to duplicate.
+Return:
+  A pointer value corresponding to either:
+  - newly allocated copy, if successful, or
+  - NULL, if _str was NULL or allocation failed.
+*/
+struct d_string*
+d_string_dup
+(
+    const struct d_string* _str
+)
+{
+    return d_string_new_copy(_str);
+}
+
+/*
+d_string_ndup
+  Duplicate at most n characters of a d_string.
+
+Parameter(s):
+  _str: d_string to duplicate.
+  _n:   maximum number of characters to copy.
+Return:
+  A pointer value corresponding to either:
+  - newly allocated copy, if successful, or
+  - NULL, if _str was NULL or allocation failed.
+*/
+struct d_string*
+d_string_ndup
+(
+    const struct d_string* _str,
+    size_t                 _n
+)
+{
+    size_t copy_len;
+
+    if (_str == NULL)
+    {
+        return NULL;
+    }
+
+    copy_len = (_n < _str->size) ? _n : _str->size;
+
+    return d_string_new_from_buffer(_str->text, copy_len);
+}
+
+/*
+d_string_substr
+  Extract substring from d_string.
+
+Parameter(s):
+  _str:    source d_string.
+  _start:  starting index (negative counts from end).
+  _length: number of characters to extract.
+Return:
+  A pointer value corresponding to either:
+  - newly allocated substring, if successful, or
+  - NULL, if _str was NULL or index was invalid.
+*/
+struct d_string*
+d_string_substr
+(
+    const struct d_string* _str,
+    d_index                _start,
+    size_t                 _length
+)
+{
+    size_t start_pos;
+    size_t actual_len;
+
+    if (_str == NULL)
+    {
+        return NULL;
+    }
+
+    if (!d_index_convert_safe(_start, _str->size, &start_pos))
+    {
+        return NULL;
+    }
+
+    // clamp length to available characters
+    actual_len = _length;
+
+    if (start_pos + actual_len > _str->size)
+    {
+        actual_len = _str->size - start_pos;
+    }
+
+    return d_string_new_from_buffer(_str->text + start_pos, actual_len);
+}
+
+
+/******************************************************************************
+* Comparison Functions
+******************************************************************************/
+
+/*
+d_string_cmp
+  Compare two d_strings.
+
+Parameter(s):
+  _s1: first d_string.
+  _s2: second d_string.
+Return:
+  An integer value indicating relationship:
+  - negative if _s1 < _s2,
+  - zero if _s1 == _s2, or
+  - positive if _s1 > _s2.
+*/
+int
+d_string_cmp
+(
+    const struct d_string* _s1,
+    const struct d_string* _s2
+)
+{
+    size_t min_len;
+    int    result;
+
+    if ( (_s1 == NULL) && 
+         (_s2 == NULL) )
+    {
+        return 0;
+    }
+
+    if (_s1 == NULL)
+    {
+        return -1;
+    }
+
+    if (_s2 == NULL)
+    {
+        return 1;
+    }
+
+    min_len = (_s1->size < _s2->size) ? _s1->size : _s2->size;
+    result  = memcmp(_s1->text, _s2->text, min_len);
+
+    if (result != 0)
+    {
+        return result;
+    }
+
+    // strings equal up to min_len, compare lengths
+    if (_s1->size < _s2->size)
+    {
+        return -1;
+    }
+
+    if (_s1->size > _s2->size)
+    {
+        return 1;
+    }
+
+    return 0;
+}
+
+/*
+d_string_cmp_cstr
+  Compare d_string to C string.
+
+Parameter(s):
+  _s1: d_string.
+  _s2: C string.
+Return:
+  An integer value indicating relationship.
+*/
+int
+d_string_cmp_cstr
+(
+    const struct d_string* _s1,
+    const char*            _s2
+)
+{
+    if ( (_s1 == NULL) && 
+         (_s2 == NULL) )
+    {
+        return 0;
+    }
+
+    if (_s1 == NULL)
+    {
+        return -1;
+    }
+
+    if (_s2 == NULL)
+    {
+        return 1;
+    }
+
+    return strcmp(_s1->text, _s2);
+}
+
+/*
+d_string_ncmp
+  Compare at most n characters of two d_strings.
+
+Parameter(s):
+  _s1: first d_string.
+  _s2: second d_string.
+  _n:  maximum characters to compare.
+Return:
+  An integer value indicating relationship.
+*/
+int
+d_string_ncmp
+(
+    const struct d_string* _s1,
+    const struct d_string* _s2,
+    size_t                 _n
+)
+{
+    size_t len1;
+    size_t len2;
+    size_t min_len;
+    int    result;
+
+    if (_n == 0)
+    {
+        return 0;
+    }
+
+    if ( (_s1 == NULL) && 
+         (_s2 == NULL) )
+    {
+        return 0;
+    }
+
+    if (_s1 == NULL)
+    {
+        return -1;
+    }
+
+    if (_s2 == NULL)
+    {
+        return 1;
+    }
+
+    len1    = (_n < _s1->size) ? _n : _s1->size;
+    len2    = (_n < _s2->size) ? _n : _s2->size;
+    min_len = (len1 < len2) ? len1 : len2;
+
+    result = memcmp(_s1->text, _s2->text, min_len);
+
+    if (result != 0)
+    {
+        return result;
+    }
+
+    if (len1 < len2)
+    {
+        return -1;
+    }
+
+    if (len1 > len2)
+    {
+        return 1;
+    }
+
+    return 0;
+}
+
+/*
+d_string_ncmp_cstr
+  Compare at most n characters of d_string to C string.
+
+Parameter(s):
+  _s1: d_string.
+  _s2: C string.
+  _n:  maximum characters to compare.
+Return:
+  An integer value indicating relationship.
+*/
+int
+d_string_ncmp_cstr
+(
+    const struct d_string* _s1,
+    const char*            _s2,
+    size_t                 _n
+)
+{
+    if (_n == 0)
+    {
+        return 0;
+    }
+
+    if ( (_s1 == NULL) && 
+         (_s2 == NULL) )
+    {
+        return 0;
+    }
+
+    if (_s1 == NULL)
+    {
+        return -1;
+    }
+
+    if (_s2 == NULL)
+    {
+        return 1;
+    }
+
+    return strncmp(_s1->text, _s2, _n);
+}
+
+/*
+d_string_casecmp
+  Case-insensitive comparison of two d_strings.
+
+Parameter(s):
+  _s1: first d_string.
+  _s2: second d_string.
+Return:
+  An integer value indicating relationship.
+*/
+int
+d_string_casecmp
+(
+    const struct d_string* _s1,
+    const struct d_string* _s2
+)
+{
+    if ( (_s1 == NULL) && 
+         (_s2 == NULL) )
+    {
+        return 0;
+    }
+
+    if (_s1 == NULL)
+    {
+        return -1;
+    }
+
+    if (_s2 == NULL)
+    {
+        return 1;
+    }
+
+    return d_strcasecmp(_s1->text, _s2->text);
+}
+
+/*
+d_string_casecmp_cstr
+  Case-insensitive comparison of d_string to C string.
+
+Parameter(s):
+  _s1: d_string.
+  _s2: C string.
+Return:
+  An integer value indicating relationship.
+*/
+int
+d_string_casecmp_cstr
+(
+    const struct d_string* _s1,
+    const char*            _s2
+)
+{
+    if ( (_s1 == NULL) && 
+         (_s2 == NULL) )
+    {
+        return 0;
+    }
+
+    if (_s1 == NULL)
+    {
+        return -1;
+    }
+
+    if (_s2 == NULL)
+    {
+        return 1;
+    }
+
+    return d_strcasecmp(_s1->text, _s2);
+}
+
+/*
+d_string_ncasecmp
+  Case-insensitive comparison of at most n characters.
+
+Parameter(s):
+  _s1: first d_string.
+  _s2: second d_string.
+  _n:  maximum characters to compare.
+Return:
+  An integer value indicating relationship.
+*/
+int
+d_string_ncasecmp
+(
+    const struct d_string* _s1,
+    const struct d_string* _s2,
+    size_t                 _n
+)
+{
+    if (_n == 0)
+    {
+        return 0;
+    }
+
+    if ( (_s1 == NULL) && 
+         (_s2 == NULL) )
+    {
+        return 0;
+    }
+
+    if (_s1 == NULL)
+    {
+        return -1;
+    }
+
+    if (_s2 == NULL)
+    {
+        return 1;
+    }
+
+    return d_strncasecmp(_s1->text, _s2->text, _n);
+}
+
+/*
+d_string_ncasecmp_cstr
+  Case-insensitive comparison of at most n characters to C string.
+
+Parameter(s):
+  _s1: d_string.
+  _s2: C string.
+  _n:  maximum characters to compare.
+Return:
+  An integer value indicating relationship.
+*/
+int
+d_string_ncasecmp_cstr
+(
+    const struct d_string* _s1,
+    const char*            _s2,
+    size_t                 _n
+)
+{
+    if (_n == 0)
+    {
+        return 0;
+    }
+
+    if ( (_s1 == NULL) && 
+         (_s2 == NULL) )
+    {
+        return 0;
+    }
+
+    if (_s1 == NULL)
+    {
+        return -1;
+    }
+
+    if (_s2 == NULL)
+    {
+        return 1;
+    }
+
+    return d_strncasecmp(_s1->text, _s2, _n);
+}
+
+/*
+d_string_equals
+  Check if two d_strings are equal.
+
+Parameter(s):
+  _s1: first d_string.
+  _s2: second d_string.
+Return:
+  A boolean value: true if equal, false otherwise.
+*/
+bool
+d_string_equals
+(
+    const struct d_string* _s1,
+    const struct d_string* _s2
+)
+{
+    return (d_string_cmp(_s1, _s2) == 0);
+}
+
+/*
+d_string_equals_cstr
+  Check if d_string equals C string.
+
+Parameter(s):
+  _s1: d_string.
+  _s2: C string.
+Return:
+  A boolean value: true if equal, false otherwise.
+*/
+bool
+d_string_equals_cstr
+(
+    const struct d_string* _s1,
+    const char*            _s2
+)
+{
+    return (d_string_cmp_cstr(_s1, _s2) == 0);
+}
+
+/*
+d_string_equals_ignore_case
+  Check if two d_strings are equal ignoring case.
+
+Parameter(s):
+  _s1: first d_string.
+  _s2: second d_string.
+Return:
+  A boolean value: true if equal ignoring case, false otherwise.
+*/
+bool
+d_string_equals_ignore_case
+(
+    const struct d_string* _s1,
+    const struct d_string* _s2
+)
+{
+    return (d_string_casecmp(_s1, _s2) == 0);
+}
+
+/*
+d_string_equals_cstr_ignore_case
+  Check if d_string equals C string ignoring case.
+
+Parameter(s):
+  _s1: d_string.
+  _s2: C string.
+Return:
+  A boolean value: true if equal ignoring case, false otherwise.
+*/
+bool
+d_string_equals_cstr_ignore_case
+(
+    const struct d_string* _s1,
+    const char*            _s2
+)
+{
+    return (d_string_casecmp_cstr(_s1, _s2) == 0);
+}
+
+
+/******************************************************************************
+* Search Functions - Character Search
+******************************************************************************/
+
+/*
+d_string_find_char
+  Find first occurrence of character in d_string.
+
+Parameter(s):
+  _str: d_string to search.
+  _c:   character to find.
+Return:
+  Index of character, or -1 if not found.
+*/
+ssize_t
+d_string_find_char
+(
+    const struct d_string* _str,
+    char                   _c
+)
+{
+    const char* p;
+
+    if ( (_str == NULL) || 
+         (_str->text == NULL) )
+    {
+        return -1;
+    }
+
+    p = (const char*)memchr(_str->text, (unsigned char)_c, _str->size);
+
+    if (p == NULL)
+    {
+        return -1;
+    }
+
+    return (ssize_t)(p - _str->text);
+}
+
+/*
+d_string_find_char_from
+  Find first occurrence of character starting from index.
+
+Parameter(s):
+  _str:   d_string to search.
+  _c:     character to find.
+  _start: starting index.
+Return:
+  Index of character, or -1 if not found.
+*/
+ssize_t
+d_string_find_char_from
+(
+    const struct d_string* _str,
+    char                   _c,
+    d_index                _start
+)
+{
+    size_t      start_pos;
+    const char* p;
+
+    if ( (_str == NULL) || 
+         (_str->text == NULL) )
+    {
+        return -1;
+    }
+
+    if (!d_index_convert_safe(_start, _str->size, &start_pos))
+    {
+        return -1;
+    }
+
+    p = (const char*)memchr(_str->text + start_pos,
+                            (unsigned char)_c,
+                            _str->size - start_pos);
+
+    if (p == NULL)
+    {
+        return -1;
+    }
+
+    return (ssize_t)(p - _str->text);
+}
+
+/*
+d_string_rfind_char
+  Find last occurrence of character in d_string.
+
+Parameter(s):
+  _str: d_string to search.
+  _c:   character to find.
+Return:
+  Index of character, or -1 if not found.
+*/
+ssize_t
+d_string_rfind_char
+(
+    const struct d_string* _str,
+    char                   _c
+)
+{
+    const char* p;
+
+    if ( (_str == NULL) || 
+         (_str->text == NULL) )
+    {
+        return -1;
+    }
+
+    p = d_string_internal_rsearch(_str->text, _str->size, &_c, 1);
+
+    if (p == NULL)
+    {
+        return -1;
+    }
+
+    return (ssize_t)(p - _str->text);
+}
+
+/*
+d_string_chr
+  Find character in d_string, returning pointer.
+
+Parameter(s):
+  _str: d_string to search.
+  _c:   character to find.
+Return:
+  Pointer to character, or NULL if not found.
+*/
+char*
+d_string_chr
+(
+    const struct d_string* _str,
+    int                    _c
+)
+{
+    if ( (_str == NULL) || 
+         (_str->text == NULL) )
+    {
+        return NULL;
+    }
+
+    // the terminator is searchable, as with strchr
+    return (char*)memchr(_str->text, (unsigned char)_c, _str->size + 1);
+}
+
+/*
+d_string_rchr
+  Find last occurrence of character, returning pointer.
+
+Parameter(s):
+  _str: d_string to search.
+  _c:   character to find.
+Return:
+  Pointer to character, or NULL if not found.
+*/
+char*
+d_string_rchr
+(
+    const struct d_string* _str,
+    int                    _c
+)
+{
+    char c;
+
+    if ( (_str == NULL) || 
+         (_str->text == NULL) )
+    {
+        return NULL;
+    }
+
+    c = (char)_c;
+
+    return (char*)d_string_internal_rsearch(_str->text,
+                                            _str->size + 1,
+                                            &c,
+                                            1);
+}
+
+/*
+d_string_chrnul
+  Find character or return pointer to null terminator.
+
+Parameter(s):
+  _str: d_string to search.
+  _c:   character to find.
+Return:
+  Pointer to character or null terminator, NULL only if _str is NULL.
+*/
+char*
+d_string_chrnul
+(
+    const struct d_string* _str,
+    int                    _c
+)
+{
+    if ( (_str == NULL) || 
+         (_str->text == NULL) )
+    {
+        return NULL;
+    }
+
+    return d_strchrnul(_str->text, _c);
+}
+
+
+/******************************************************************************
+* Search Functions - Substring Search
+******************************************************************************/
+
+/*
+d_string_find
+  Find first occurrence of substring in d_string.
+
+Parameter(s):
+  _haystack: d_string to search in.
+  _needle:   d_string to search for.
+Return:
+  Index of substring, or -1 if not found.
+*/
+ssize_t
+d_string_find
+(
+    const struct d_string* _haystack,
+    const struct d_string* _needle
+)
+{
+    const char* p;
+
+    if ( (_haystack == NULL) || 
+         (_needle == NULL) )
+    {
+        return -1;
+    }
+
+    if (_needle->size == 0)
+    {
+        return 0;
+    }
+
+    p = d_string_internal_search(_haystack->text,
+                                 _haystack->size,
+                                 _needle->text,
+                                 _needle->size);
+
+    if (p == NULL)
+    {
+        return -1;
+    }
+
+    return (ssize_t)(p - _haystack->text);
+}
+
+/*
+d_string_find_cstr
+  Find first occurrence of C string in d_string.
+
+Parameter(s):
+  _haystack: d_string to search in.
+  _needle:   C string to search for.
+Return:
+  Index of substring, or -1 if not found.
+*/
+ssize_t
+d_string_find_cstr
+(
+    const struct d_string* _haystack,
+    const char*            _needle
+)
+{
+    const char* p;
+
+    if ( (_haystack == NULL) || 
+         (_needle == NULL) )
+    {
+        return -1;
+    }
+
+    if (*_needle == '\0')
+    {
+        return 0;
+    }
+
+    p = d_string_internal_search(_haystack->text,
+                                 _haystack->size,
+                                 _needle,
+                                 strlen(_needle));
+
+    if (p == NULL)
+    {
+        return -1;
+    }
+
+    return (ssize_t)(p - _haystack->text);
+}
+
+/*
+d_string_find_from
+  Find substring starting from index.
+
+Parameter(s):
+  _haystack: d_string to search in.
+  _needle:   d_string to search for.
+  _start:    starting index.
+Return:
+  Index of substring, or -1 if not found.
+*/
+ssize_t
+d_string_find_from
+(
+    const struct d_string* _haystack,
+    const struct d_string* _needle,
+    d_index                _start
+)
+{
+    size_t      start_pos;
+    const char* p;
+
+    if ( (_haystack == NULL) || 
+         (_needle == NULL) )
+    {
+        return -1;
+    }
+
+    if (!d_index_convert_safe(_start, _haystack->size, &start_pos))
+    {
+        return -1;
+    }
+
+    p = d_string_internal_search(_haystack->text + start_pos,
+                                 _haystack->size - start_pos,
+                                 _needle->text,
+                                 _needle->size);
+
+    if (p == NULL)
+    {
+        return -1;
+    }
+
+    return (ssize_t)(p - _haystack->text);
+}
+
+/*
+d_string_find_cstr_from
+  Find C string starting from index.
+
+Parameter(s):
+  _haystack: d_string to search in.
+  _needle:   C string to search for.
+  _start:    starting index.
+Return:
+  Index of substring, or -1 if not found.
+*/
+ssize_t
+d_string_find_cstr_from
+(
+    const struct d_string* _haystack,
+    const char*            _needle,
+    d_index                _start
+)
+{
+    size_t      start_pos;
+    const char* p;
+
+    if ( (_haystack == NULL) || 
+         (_needle == NULL) )
+    {
+        return -1;
+    }
+
+    if (!d_index_convert_safe(_start, _haystack->size, &start_pos))
+    {
+        return -1;
+    }
+
+    p = d_string_internal_search(_haystack->text + start_pos,
+                                 _haystack->size - start_pos,
+                                 _needle,
+                                 strlen(_needle));
+
+    if (p == NULL)
+    {
+        return -1;
+    }
+
+    return (ssize_t)(p - _haystack->text);
+}
+
+/*
+d_string_rfind
+  Find last occurrence of substring.
+
+Parameter(s):
+  _haystack: d_string to search in.
+  _needle:   d_string to search for.
+Return:
+  Index of last occurrence, or -1 if not found.
+*/
+ssize_t
+d_string_rfind
+(
+    const struct d_string* _haystack,
+    const struct d_string* _needle
+)
+{
+    const char* p;
+
+    if ( (_haystack == NULL) || 
+         (_needle == NULL) )
+    {
+        return -1;
+    }
+
+    if (_needle->size == 0)
+    {
+        return (ssize_t)_haystack->size;
+    }
+
+    p = d_string_internal_rsearch(_haystack->text,
+                                  _haystack->size,
+                                  _needle->text,
+                                  _needle->size);
+
+    if (p == NULL)
+    {
+        return -1;
+    }
+
+    return (ssize_t)(p - _haystack->text);
+}
+
+/*
+d_string_rfind_cstr
+  Find last occurrence of C string.
+
+Parameter(s):
+  _haystack: d_string to search in.
+  _needle:   C string to search for.
+Return:
+  Index of last occurrence, or -1 if not found.
+*/
+ssize_t
+d_string_rfind_cstr
+(
+    const struct d_string* _haystack,
+    const char*            _needle
+)
+{
+    const char* p;
+
+    if ( (_haystack == NULL) || 
+         (_needle == NULL) )
+    {
+        return -1;
+    }
+
+    if (*_needle == '\0')
+    {
+        return (ssize_t)_haystack->size;
+    }
+
+    p = d_string_internal_rsearch(_haystack->text,
+                                  _haystack->size,
+                                  _needle,
+                                  strlen(_needle));
+
+    if (p == NULL)
+    {
+        return -1;
+    }
+
+    return (ssize_t)(p - _haystack->text);
+}
+
+/*
+d_string_str
+  Find substring, returning pointer (strstr equivalent).
+
+Parameter(s):
+  _haystack: d_string to search in.
+  _needle:   C string to search for.
+Return:
+  Pointer to substring, or NULL if not found.
+*/
+char*
+d_string_str
+(
+    const struct d_string* _haystack,
+    const char*            _needle
+)
+{
+    if ( (_haystack == NULL) || 
+         (_needle == NULL) )
+    {
+        return NULL;
+    }
+
+    return (char*)d_string_internal_search(_haystack->text,
+                                           _haystack->size,
+                                           _needle,
+                                           strlen(_needle));
+}
+
+/*
+d_string_casefind
+  Case-insensitive find substring. Binary-safe and worst-case linear time.
+
+Parameter(s):
+  _haystack: d_string to search in.
+  _needle:   d_string to search for.
+Return:
+  Index of substring, or -1 if not found.
+*/
+ssize_t
+d_string_casefind
+(
+    const struct d_string* _haystack,
+    const struct d_string* _needle
+)
+{
+    char* p;
+
+    if ( (_haystack == NULL) || 
+         (_needle == NULL) )
+    {
+        return -1;
+    }
+
+    p = (char*)d_memcasemem(_haystack->text,
+                            _haystack->size,
+                            _needle->text,
+                            _needle->size);
+
+    if (p == NULL)
+    {
+        return -1;
+    }
+
+    return (ssize_t)(p - _haystack->text);
+}
+
+/*
+d_string_casefind_cstr
+  Case-insensitive find C string.
+
+Parameter(s):
+  _haystack: d_string to search in.
+  _needle:   C string to search for.
+Return:
+  Index of substring, or -1 if not found.
+*/
+ssize_t
+d_string_casefind_cstr
+(
+    const struct d_string* _haystack,
+    const char*            _needle
+)
+{
+    char* p;
+
+    if ( (_haystack == NULL) || 
+         (_needle == NULL) )
+    {
+        return -1;
+    }
+
+    p = (char*)d_memcasemem(_haystack->text,
+                            _haystack->size,
+                            _needle,
+                            strlen(_needle));
+
+    if (p == NULL)
+    {
+        return -1;
+    }
+
+    return (ssize_t)(p - _haystack->text);
+}
+
+/*
+d_string_casestr
+  Case-insensitive substring search returning pointer.
+
+Parameter(s):
+  _haystack: d_string to search in.
+  _needle:   C string to search for.
+Return:
+  Pointer to substring, or NULL if not found.
+*/
+char*
+d_string_casestr
+(
+    const struct d_string* _haystack,
+    const char*            _needle
+)
+{
+    if ( (_haystack == NULL) || 
+         (_needle == NULL) )
+    {
+        return NULL;
+    }
+
+    return (char*)d_memcasemem(_haystack->text,
+                               _haystack->size,
+                               _needle,
+                               strlen(_needle));
+}
+
+
+/******************************************************************************
+* Search Functions - Containment Checks
+******************************************************************************/
+
+/*
+d_string_contains
+  Check if d_string contains substring.
+
+Parameter(s):
+  _str:    d_string to search in.
+  _substr: d_string to search for.
+Return:
+  true if _substr is found in _str, false otherwise.
+*/
+bool
+d_string_contains
+(
+    const struct d_string* _str,
+    const struct d_string* _substr
+)
+{
+    return (d_string_find(_str, _substr) >= 0);
+}
+
+/*
+d_string_contains_cstr
+  Check if d_string contains C string.
+
+Parameter(s):
+  _str:    d_string to search in.
+  _substr: C string to search for.
+Return:
+  true if _substr is found in _str, false otherwise.
+*/
+bool
+d_string_contains_cstr
+(
+    const struct d_string* _str,
+    const char*            _substr
+)
+{
+    return (d_string_find_cstr(_str, _substr) >= 0);
+}
+
+/*
+d_string_contains_char
+  Check if d_string contains character.
+
+Parameter(s):
+  _str: d_string to search in.
+  _c:   character to search for.
+Return:
+  true if _c is found in _str, false otherwise.
+*/
+bool
+d_string_contains_char
+(
+    const struct d_string* _str,
+    char                   _c
+)
+{
+    return (d_string_find_char(_str, _c) >= 0);
+}
+
+/*
+d_string_starts_with
+  Check if d_string starts with prefix.
+
+Parameter(s):
+  _str:    d_string to check.
+  _prefix: d_string prefix.
+Return:
+  true if _str starts with _prefix, false otherwise.
+*/
+bool
+d_string_starts_with
+(
+    const struct d_string* _str,
+    const struct d_string* _prefix
+)
+{
+    if ( (_str == NULL) || 
+         (_prefix == NULL) )
+    {
+        return false;
+    }
+
+    if (_prefix->size > _str->size)
+    {
+        return false;
+    }
+
+    return (memcmp(_str->text, _prefix->text, _prefix->size) == 0);
+}
+
+/*
+d_string_starts_with_cstr
+  Check if d_string starts with C string prefix.
+
+Parameter(s):
+  _str:    d_string to check.
+  _prefix: C string prefix.
+Return:
+  true if _str starts with _prefix, false otherwise.
+*/
+bool
+d_string_starts_with_cstr
+(
+    const struct d_string* _str,
+    const char*            _prefix
+)
+{
+    size_t prefix_len;
+
+    if ( (_str == NULL) || 
+         (_prefix == NULL) )
+    {
+        return false;
+    }
+
+    prefix_len = strlen(_prefix);
+
+    if (prefix_len > _str->size)
+    {
+        return false;
+    }
+
+    return (memcmp(_str->text, _prefix, prefix_len) == 0);
+}
+
+/*
+d_string_ends_with
+  Check if d_string ends with suffix.
+
+Parameter(s):
+  _str:    d_string to check.
+  _suffix: d_string suffix.
+Return:
+  true if _str ends with _suffix, false otherwise.
+*/
+bool
+d_string_ends_with
+(
+    const struct d_string* _str,
+    const struct d_string* _suffix
+)
+{
+    size_t offset;
+
+    if ( (_str == NULL) || 
+         (_suffix == NULL) )
+    {
+        return false;
+    }
+
+    if (_suffix->size > _str->size)
+    {
+        return false;
+    }
+
+    offset = _str->size - _suffix->size;
+
+    return (memcmp(_str->text + offset, _suffix->text, _suffix->size) == 0);
+}
+
+/*
+d_string_ends_with_cstr
+  Check if d_string ends with C string suffix.
+
+Parameter(s):
+  _str:    d_string to check.
+  _suffix: C string suffix.
+Return:
+  true if _str ends with _suffix, false otherwise.
+*/
+bool
+d_string_ends_with_cstr
+(
+    const struct d_string* _str,
+    const char*            _suffix
+)
+{
+    size_t suffix_len;
+    size_t offset;
+
+    if ( (_str == NULL) || 
+         (_suffix == NULL) )
+    {
+        return false;
+    }
+
+    suffix_len = strlen(_suffix);
+
+    if (suffix_len > _str->size)
+    {
+        return false;
+    }
+
+    offset = _str->size - suffix_len;
+
+    return (memcmp(_str->text + offset, _suffix, suffix_len) == 0);
+}
+
+/*
+d_string_spn
+  Get length of initial segment containing only characters in accept.
+
+Parameter(s):
+  _str:    d_string to scan.
+  _accept: string of accepted characters.
+Return:
+  Length of initial segment.
+*/
+size_t
+d_string_spn
+(
+    const struct d_string* _str,
+    const char*            _accept
+)
+{
+    if ( (_str == NULL) || 
+         (_accept == NULL) )
+    {
+        return 0;
+    }
+
+    return strspn(_str->text, _accept);
+}
+
+/*
+d_string_cspn
+  Get length of initial segment not containing characters in reject.
+
+Parameter(s):
+  _str:    d_string to scan.
+  _reject: string of rejected characters.
+Return:
+  Length of initial segment.
+*/
+size_t
+d_string_cspn
+(
+    const struct d_string* _str,
+    const char*            _reject
+)
+{
+    if ( (_str == NULL) || 
+         (_reject == NULL) )
+    {
+        return 0;
+    }
+
+    return strcspn(_str->text, _reject);
+}
+
+/*
+d_string_pbrk
+  Find first occurrence of any character from accept string.
+
+Parameter(s):
+  _str:    d_string to search.
+  _accept: string of characters to find.
+Return:
+  Pointer to first matching character, or NULL if none found.
+*/
+char*
+d_string_pbrk
+(
+    const struct d_string* _str,
+    const char*            _accept
+)
+{
+    if ( (_str == NULL) || 
+         (_accept == NULL) )
+    {
+        return NULL;
+    }
+
+    return strpbrk(_str->text, _accept);
+}
+
+
+/******************************************************************************
+* Modification Functions - Assignment
+******************************************************************************/
+
+/*
+d_string_assign
+  Assign content from another d_string.
+
+Parameter(s):
+  _str:   d_string to modify.
+  _other: source d_string.
+Return:
+  true if successful, false otherwise.
+*/
+bool
+d_string_assign
+(
+    struct d_string*       _str,
+    const struct d_string* _other
+)
+{
+    if ( (_str == NULL) || 
+         (_other == NULL) )
+    {
+        return false;
+    }
+
+    return (d_string_copy_s(_str, _other) == 0);
+}
+
+/*
+d_string_assign_cstr
+  Assign content from C string.
+
+Parameter(s):
+  _str:  d_string to modify.
+  _cstr: source C string.
+Return:
+  true if successful, false otherwise.
+*/
+bool
+d_string_assign_cstr
+(
+    struct d_string* _str,
+    const char*      _cstr
+)
+{
+    if (!d_string_internal_modified(_str, D_STRING_INTERNAL_SITE))
+    {
+        return false;
+    }
+
+    if ( (_str == NULL) || 
+         (_cstr == NULL) )
+    {
+        return false;
+    }
+
+    return (d_string_copy_cstr_s(_str, _cstr) == 0);
+}
+
+/*
+d_string_assign_buffer
+  Assign content from buffer.
+
+Parameter(s):
+  _str:    d_string to modify.
+  _buffer: source buffer.
+  _length: number of bytes to copy.
+Return:
+  true if successful, false otherwise.
+*/
+bool
+d_string_assign_buffer
+(
+    struct d_string* _str,
+    const char*      _buffer,
+    size_t           _length
+)
+{
+    if (!d_string_internal_modified(_str, D_STRING_INTERNAL_SITE))
+    {
+        return false;
+    }
+
+    if ( (_str == NULL) || 
+         (_buffer == NULL) )
+    {
+        return false;
+    }
+
+    if (!d_string_internal_grow(_str, _length + 1, D_STRING_INTERNAL_SITE))
+    {
+        return false;
+    }
+
+    d_memcpy(_str->text, _buffer, _length);
+    _str->text[_length] = '\0';
+    _str->size          = _length;
+
+    return true;
+}
+
+/*
+d_string_assign_char
+  Assign repeated character.
+
+Parameter(s):
+  _str:   d_string to modify.
+  _count: number of times to repeat.
+  _c:     character to assign.
+Return:
+  true if successful, false otherwise.
+*/
+bool
+d_string_assign_char
+(
+    struct d_string* _str,
+    size_t           _count,
+    char             _c
+)
+{
+    if (!d_string_internal_modified(_str, D_STRING_INTERNAL_SITE))
+    {
+        return false;
+    }
+
+    if (_str == NULL)
+    {
+        return false;
+    }
+
+    if (!d_string_internal_grow(_str, _count + 1, D_STRING_INTERNAL_SITE))
+    {
+        return false;
+    }
+
+    d_memset(_str->text, _c, _count);
+    _str->text[_count] = '\0';
+    _str->size         = _count;
+
+    return true;
+}
+
+
+/******************************************************************************
+* Modification Functions - Append
+******************************************************************************/
+
+/*
+d_string_append
+  Append another d_string.
+
+Parameter(s):
+  _str:   d_string to modify.
+  _other: d_string to append.
+Return:
+  true if successful, false otherwise.
+*/
+bool
+d_string_append
+(
+    struct d_string*       _str,
+    const struct d_string* _other
+)
+{
+    if (!d_string_internal_modified(_str, D_STRING_INTERNAL_SITE))
+    {
+        return false;
+    }
+
+    if ( (_str == NULL) || 
+         (_other == NULL) )
+    {
+        return false;
+    }
+
+    return (d_string_cat_s(_str, _other) == 0);
+}
+
+/*
+d_string_append_cstr
+  Append C string.
+
+Parameter(s):
+  _str:  d_string to modify.
+  _cstr: C string to append.
+Return:
+  true if successful, false otherwise.
+*/
+bool
+d_string_append_cstr
+(
+    struct d_string* _str,
+    const char*      _cstr
+)
+{
+    if (!d_string_internal_modified(_str, D_STRING_INTERNAL_SITE))
+    {
+        return false;
+    }
+
+    if ( (_str == NULL) || 
+         (_cstr == NULL) )
+    {
+        return false;
+    }
+
+    return (d_string_cat_cstr_s(_str, _cstr) == 0);
+}
+
+/*
+d_string_append_buffer
+  Append buffer of specified length.
+
+Parameter(s):
+  _str:    d_string to modify.
+  _buffer: buffer to append.
+  _length: number of bytes to append.
+Return:
+  true if successful, false otherwise.
+*/
+bool
+d_string_append_buffer
+(
+    struct d_string* _str,
+    const char*      _buffer,
+    size_t           _length
+)
+{
+    size_t new_size;
+
+    if (!d_string_internal_modified(_str, D_STRING_INTERNAL_SITE))
+    {
+        return false;
+    }
+
+    if ( (_str == NULL) || 
+         (_buffer == NULL) )
+    {
+        return false;
+    }
+
+    new_size = _str->size + _length;
+
+    if (!d_string_internal_grow(_str, new_size + 1, D_STRING_INTERNAL_SITE))
+    {
+        return false;
+    }
+
+    d_memcpy(_str->text + _str->size, _buffer, _length);
+    _str->text[new_size] = '\0';
+    _str->size           = new_size;
+
+    return true;
+}
+
+/*
+d_string_append_char
+  Append single character.
+
+Parameter(s):
+  _str: d_string to modify.
+  _c:   character to append.
+Return:
+  true if successful, false otherwise.
+*/
+bool
+d_string_append_char
+(
+    struct d_string* _str,
+    char             _c
+)
+{
+    size_t new_size;
+
+    if (!d_string_internal_modified(_str, D_STRING_INTERNAL_SITE))
+    {
+        return false;
+    }
+
+    if (_str == NULL)
+    {
+        return false;
+    }
+
+    new_size = _str->size + 1;
+
+    if (!d_string_internal_grow(_str, new_size + 1, D_STRING_INTERNAL_SITE))
+    {
+        return false;
+    }
+
+    _str->text[_str->size] = _c;
+    _str->text[new_size]   = '\0';
+    _str->size             = new_size;
+
+    return true;
+}
+
+/*
+d_string_append_formatted
+  Append printf-style formatted text.
+
+Parameter(s):
+  _str:    d_string to modify.
+  _format: format string.
+  ...:     format arguments.
+Return:
+  true if successful, false otherwise.
+*/
+bool
+d_string_append_formatted
+(
+    struct d_string* _str,
+    const char*      _format,
+    ...
+)
+{
+    va_list args;
+    bool    result;
+
+    va_start(args, _format);
+    result = d_string_append_vformatted(_str, _format, args);
+    va_end(args);
+
+    return result;
+}
+
+/*
+d_string_append_vformatted
+  Append printf-style formatted text with va_list. The text is formatted
+directly into the string's spare capacity, which is only grown if the output
+overflows it.
+
+Parameter(s):
+  _str:    d_string to modify.
+  _format: format string.
+  _args:   va_list of arguments.
+Return:
+  true if successful, false otherwise; on failure `_str` is unchanged.
+*/
+bool
+d_string_append_vformatted
+(
+    struct d_string* _str,
+    const char*      _format,
+    va_list          _args
+)
+{
+    if (!d_string_internal_modified(_str, D_STRING_INTERNAL_SITE))
+    {
+        return false;
+    }
+
+    if ( (_str == NULL) || 
+         (_format == NULL) )
+    {
+        return false;
+    }
+
+    return (d_string_internal_vformat(_str, _format, _args) >= 0);
+}
+
+
+/******************************************************************************
+* Modification Functions - Prepend
+******************************************************************************/
+
+/*
+d_string_prepend
+  Prepend another d_string.
+
+Parameter(s):
+  _str:   d_string to modify.
+  _other: d_string to prepend.
+Return:
+  true if successful, false otherwise.
+*/
+bool
+d_string_prepend
+(
+    struct d_string*       _str,
+    const struct d_string* _other
+)
+{
+    size_t new_size;
+
+    if (!d_string_internal_modified(_str, D_STRING_INTERNAL_SITE))
+    {
+        return false;
+    }
+
+    if ( (_str == NULL) || 
+         (_other == NULL) )
+    {
+        return false;
+    }
+
+    new_size = _str->size + _other->size;
+
+    if (!d_string_internal_grow(_str, new_size + 1, D_STRING_INTERNAL_SITE))
+    {
+        return false;
+    }
+
+    // shift existing content
+    memmove(_str->text + _other->size, _str->text, _str->size + 1);
+
+    // copy prepend content
+    d_memcpy(_str->text, _other->text, _other->size);
+    _str->size = new_size;
+
+    return true;
+}
+
+/*
+d_string_prepend_cstr
+  Prepend C string.
+
+Parameter(s):
+  _str:  d_string to modify.
+  _cstr: C string to prepend.
+Return:
+  true if successful, false otherwise.
+*/
+bool
+d_string_prepend_cstr
+(
+    struct d_string* _str,
+    const char*      _cstr
+)
+{
+    size_t cstr_len;
+    size_t new_size;
+
+    if (!d_string_internal_modified(_str, D_STRING_INTERNAL_SITE))
+    {
+        return false;
+    }
+
+    if ( (_str == NULL) || 
+         (_cstr == NULL) )
+    {
+        return false;
+    }
+
+    cstr_len = strlen(_cstr);
+    new_size = _str->size + cstr_len;
+
+    if (!d_string_internal_grow(_str, new_size + 1, D_STRING_INTERNAL_SITE))
+    {
+        return false;
+    }
+
+    memmove(_str->text + cstr_len, _str->text, _str->size + 1);
+    d_memcpy(_str->text, _cstr, cstr_len);
+    _str->size = new_size;
+
+    return true;
+}
+
+/*
+d_string_prepend_char
+  Prepend single character.
+
+Parameter(s):
+  _str: d_string to modify.
+  _c:   character to prepend.
+Return:
+  true if successful, false otherwise.
+*/
+bool
+d_string_prepend_char
+(
+    struct d_string* _str,
+    char             _c
+)
+{
+    size_t new_size;
+
+    if (!d_string_internal_modified(_str, D_STRING_INTERNAL_SITE))
+    {
+        return false;
+    }
+
+    if (_str == NULL)
+    {
+        return false;
+    }
+
+    new_size = _str->size + 1;
+
+    if (!d_string_internal_grow(_str, new_size + 1, D_STRING_INTERNAL_SITE))
+    {
+        return false;
+    }
+
+    memmove(_str->text + 1, _str->text, _str->size + 1);
+    _str->text[0] = _c;
+    _str->size    = new_size;
+
+    return true;
+}
+
+
+/******************************************************************************
+* Modification Functions - Insert
+******************************************************************************/
+
+/*
+d_string_insert
+  Insert d_string at index.
+
+Parameter(s):
+  _str:   d_string to modify.
+  _index: insertion point.
+  _other: d_string to insert.
+Return:
+  true if successful, false otherwise.
+*/
+bool
+d_string_insert
+(
+    struct d_string*       _str,
+    d_index                _index,
+    const struct d_string* _other
+)
+{
+    size_t pos;
+    size_t new_size;
+
+    if (!d_string_internal_modified(_str, D_STRING_INTERNAL_SITE))
+    {
+        return false;
+    }
+
+    if ( (_str == NULL) || 
+         (_other == NULL) )
+    {
+        return false;
+    }
+
+    // special case: insert at end
+    if (_index == (d_index)_str->size)
+    {
+        return d_string_append(_str, _other);
+    }
+
+    if (!d_index_convert_safe(_index, _str->size, &pos))
+    {
+        return false;
+    }
+
+    new_size = _str->size + _other->size;
+
+    if (!d_string_internal_grow(_str, new_size + 1, D_STRING_INTERNAL_SITE))
+    {
+        return false;
+    }
+
+    // shift content after insertion point
+    memmove(_str->text + pos + _other->size,
+            _str->text + pos,
+            _str->size - pos + 1);
+
+    // insert new content
+    d_memcpy(_str->text + pos, _other->text, _other->size);
+    _str->size = new_size;
+
+    return true;
+}
+
+/*
+d_string_insert_cstr
+  Insert C string at index.
+
+Parameter(s):
+  _str:   d_string to modify.
+  _index: insertion point.
+  _cstr:  C string to insert.
+Return:
+  true if successful, false otherwise.
+*/
+bool
+d_string_insert_cstr
+(
+    struct d_string* _str,
+    d_index          _index,
+    const char*      _cstr
+)
+{
+    size_t pos;
+    size_t cstr_len;
+    size_t new_size;
+
+    if (!d_string_internal_modified(_str, D_STRING_INTERNAL_SITE))
+    {
+        return false;
+    }
+
+    if ( (_str == NULL) || 
+         (_cstr == NULL) )
+    {
+        return false;
+    }
+
+    // special case: insert at end
+    if (_index == (d_index)_str->size)
+    {
+        return d_string_append_cstr(_str, _cstr);
+    }
+
+    if (!d_index_convert_safe(_index, _str->size, &pos))
+    {
+        return false;
+    }
+
+    cstr_len = strlen(_cstr);
+    new_size = _str->size + cstr_len;
+
+    if (!d_string_internal_grow(_str, new_size + 1, D_STRING_INTERNAL_SITE))
+    {
+        return false;
+    }
+
+    memmove(_str->text + pos + cstr_len,
+            _str->text + pos,
+            _str->size - pos + 1);
+
+    d_memcpy(_str->text + pos, _cstr, cstr_len);
+    _str->size = new_size;
+
+    return true;
+}
+
+/*
+d_string_insert_char
+  Insert character at index.
+
+Parameter(s):
+  _str:   d_string to modify.
+  _index: insertion point.
+  _c:     character to insert.
+Return:
+  true if successful, false otherwise.
+*/
+bool
+d_string_insert_char
+(
+    struct d_string* _str,
+    d_index          _index,
+    char             _c
+)
+{
+    size_t pos;
+    size_t new_size;
+
+    if (!d_string_internal_modified(_str, D_STRING_INTERNAL_SITE))
+    {
+        return false;
+    }
+
+    if (_str == NULL)
+    {
+        return false;
+    }
+
+    // special case: insert at end
+    if (_index == (d_index)_str->size)
+    {
+        return d_string_append_char(_str, _c);
+    }
+
+    if (!d_index_convert_safe(_index, _str->size, &pos))
+    {
+        return false;
+    }
+
+    new_size = _str->size + 1;
+
+    if (!d_string_internal_grow(_str, new_size + 1, D_STRING_INTERNAL_SITE))
+    {
+        return false;
+    }
+
+    memmove(_str->text + pos + 1,
+            _str->text + pos,
+            _str->size - pos + 1);
+
+    _str->text[pos] = _c;
+    _str->size      = new_size;
+
+    return true;
+}
+
+
+/******************************************************************************
+* Modification Functions - Erase and Clear
+******************************************************************************/
+
+/*
+d_string_erase
+  Erase characters from string.
+
+Parameter(s):
+  _str:   d_string to modify.
+  _index: starting index.
+  _count: number of characters to erase.
+Return:
+  true if successful, false otherwise.
+*/
+bool
+d_string_erase
+(
+    struct d_string* _str,
+    d_index          _index,
+    size_t           _count
+)
+{
+    size_t pos;
+    size_t actual_count;
+
+    if (!d_string_internal_modified(_str, D_STRING_INTERNAL_SITE))
+    {
+        return false;
+    }
+
+    if (_str == NULL)
+    {
+        return false;
+    }
+
+    if (!d_index_convert_safe(_index, _str->size, &pos))
+    {
+        return false;
+    }
+
+    // clamp count to available characters
+    actual_count = _count;
+
+    if (pos + actual_count > _str->size)
+    {
+        actual_count = _str->size - pos;
+    }
+
+    // shift remaining content
+    memmove(_str->text + pos,
+            _str->text + pos + actual_count,
+            _str->size - pos - actual_count + 1);
+
+    _str->size -= actual_count;
+
+    return true;
+}
+
+/*
+d_string_erase_char
+  Erase single character at index.
+
+Parameter(s):
+  _str:   d_string to modify.
+  _index: index of character to erase.
+Return:
+  true if successful, false otherwise.
+*/
+bool
+d_string_erase_char
+(
+    struct d_string* _str,
+    d_index          _index
+)
+{
+    return d_string_erase(_str, _index, 1);
+}
+
+/*
+d_string_clear
+  Clear string contents (set to empty).
+
+Parameter(s):
+  _str: d_string to clear.
+Return:
+  (none)
+*/
+void
+d_string_clear
+(
+    struct d_string* _str
+)
+{
+    if (_str == NULL)
+    {
+        return;
+    }
+
+    // a shared buffer is simply let go rather than copied only to be emptied
+    if (d_string_internal_is_shared(_str))
+    {
+        d_string_internal_release(_str);
+        d_string_internal_init(_str);
+
+        return;
+    }
+
+    _str->flags &= ~D_STRING_FLAG_HASHED;
+
+    if (_str->text != NULL)
+    {
+        _str->text[0] = '\0';
+    }
+
+    _str->size = 0;
+
+    return;
+}
+
+
+/******************************************************************************
+* Modification Functions - Replace
+******************************************************************************/
+
+/*
+d_string_replace
+  Replace portion of string with d_string.
+
+Parameter(s):
+  _str:         d_string to modify.
+  _index:       starting index of replacement.
+  _count:       number of characters to replace.
+  _replacement: d_string to insert.
+Return:
+  true if successful, false otherwise.
+*/
+bool
+d_string_replace
+(
+    struct d_string*       _str,
+    d_index                _index,
+    size_t                 _count,
+    const struct d_string* _replacement
+)
+{
+    size_t pos;
+    size_t actual_count;
+    size_t new_size;
+
+    if (!d_string_internal_modified(_str, D_STRING_INTERNAL_SITE))
+    {
+        return false;
+    }
+
+    if ( (_str == NULL) || 
+         (_replacement == NULL) )
+    {
+        return false;
+    }
+
+    if (!d_index_convert_safe(_index, _str->size, &pos))
+    {
+        return false;
+    }
+
+    // clamp count
+    actual_count = _count;
+
+    if (pos + actual_count > _str->size)
+    {
+        actual_count = _str->size - pos;
+    }
+
+    new_size = _str->size - actual_count + _replacement->size;
+
+    if (!d_string_internal_grow(_str, new_size + 1, D_STRING_INTERNAL_SITE))
+    {
+        return false;
+    }
+
+    // shift content after replacement region
+    memmove(_str->text + pos + _replacement->size,
+            _str->text + pos + actual_count,
+            _str->size - pos - actual_count + 1);
+
+    // copy replacement
+    d_memcpy(_str->text + pos, _replacement->text, _replacement->size);
+    _str->size = new_size;
+
+    return true;
+}
+
+/*
+d_string_replace_cstr
+  Replace portion of string with C string.
+
+Parameter(s):
+  _str:         d_string to modify.
+  _index:       starting index of replacement.
+  _count:       number of characters to replace.
+  _replacement: C string to insert.
+Return:
+  true if successful, false otherwise.
+*/
+bool
+d_string_replace_cstr
+(
+    struct d_string* _str,
+    d_index          _index,
+    size_t           _count,
+    const char*      _replacement
+)
+{
+    size_t pos;
+    size_t actual_count;
+    size_t rep_len;
+    size_t new_size;
+
+    if (!d_string_internal_modified(_str, D_STRING_INTERNAL_SITE))
+    {
+        return false;
+    }
+
+    if ( (_str == NULL) || 
+         (_replacement == NULL) )
+    {
+        return false;
+    }
+
+    if (!d_index_convert_safe(_index, _str->size, &pos))
+    {
+        return false;
+    }
+
+    actual_count = _count;
+
+    if (pos + actual_count > _str->size)
+    {
+        actual_count = _str->size - pos;
+    }
+
+    rep_len  = strlen(_replacement);
+    new_size = _str->size - actual_count + rep_len;
+
+    if (!d_string_internal_grow(_str, new_size + 1, D_STRING_INTERNAL_SITE))
+    {
+        return false;
+    }
+
+    memmove(_str->text + pos + rep_len,
+            _str->text + pos + actual_count,
+            _str->size - pos - actual_count + 1);
+
+    d_memcpy(_str->text + pos, _replacement, rep_len);
+    _str->size = new_size;
+
+    return true;
+}
+
+/*
+d_string_internal_replace_all
+  Replaces every non-overlapping occurrence of `_old` (of length `_old_len`)
+with `_new` (of length `_new_len`). Binary-safe: both patterns and the string
+may contain embedded null bytes.
+*/
+static bool
+d_string_internal_replace_all
+(
+    struct d_string* _str,
+    const char*      _old,
+    size_t           _old_len,
+    const char*      _new,
+    size_t           _new_len,
+    const char*      _file,
+    int              _line
+)
+{
+    size_t           count;
+    size_t           new_size;
+    size_t           before_len;
+    const char*      search;
+    const char*      found;
+    const char*      end;
+    char*            write_ptr;
+    struct d_string* result;
+
+    if (_str->text == NULL)
+    {
+        return true;
+    }
+
+    end = _str->text + _str->size;
+
+    // count occurrences
+    count  = 0;
+    search = _str->text;
+
+    while ((found = d_string_internal_search(search,
+                                             (size_t)(end - search),
+                                             _old,
+                                             _old_len)) != NULL)
+    {
+        count++;
+        search = found + _old_len;
+    }
+
+    // if no occurrences, nothing to do
+    if (count == 0)
+    {
+        return true;
+    }
+
+    // calculate new size
+    new_size = _str->size + (count * _new_len) - (count * _old_len);
+
+    // create temporary result
+    result = d_string_new_with_capacity(new_size + 1);
+
+    if (result == NULL)
+    {
+        return false;
+    }
+
+    // build result
+    search    = _str->text;
+    write_ptr = result->text;
+
+    while ((found = d_string_internal_search(search,
+                                             (size_t)(end - search),
+                                             _old,
+                                             _old_len)) != NULL)
+    {
+        // copy text before match
+        before_len = (size_t)(found - search);
+
+        d_memcpy(write_ptr, search, before_len);
+        write_ptr += before_len;
+
+        // copy replacement
+        d_memcpy(write_ptr, _new, _new_len);
+        write_ptr += _new_len;
+
+        search = found + _old_len;
+    }
+
+    // copy remaining text, including the null terminator
+    d_memcpy(write_ptr, search, (size_t)(end - search) + 1);
+    result->size = new_size;
+
+    // swap contents (frees the result struct, but not its text)
+    return d_string_internal_take(_str, result, _file, _line);
+}
+
+/*
+d_string_replace_all
+  Replace all occurrences of substring.
+
+Parameter(s):
+  _str: d_string to modify.
+  _old: d_string to find and replace.
+  _new: d_string replacement.
+Return:
+  true if successful, false otherwise.
+*/
+bool
+d_string_replace_all
+(
+    struct d_string*       _str,
+    const struct d_string* _old,
+    const struct d_string* _new
+)
+{
+    if (!d_string_internal_modified(_str, D_STRING_INTERNAL_SITE))
+    {
+        return false;
+    }
+
+    if ( (_str == NULL) || 
+         (_old == NULL) || 
+         (_new == NULL) ||
+         (_old->size == 0) )
+    {
+        return false;
+    }
+
+    return d_string_internal_replace_all(_str,
+                                         _old->text,
+                                         _old->size,
+                                         _new->text,
+                                         _new->size,
+                                         D_STRING_INTERNAL_SITE);
+}
+
+/*
+d_string_replace_all_cstr
+  Replace all occurrences of C string.
+
+Parameter(s):
+  _str: d_string to modify.
+  _old: C string to find and replace.
+  _new: C string replacement.
+Return:
+  true if successful, false otherwise.
+*/
+bool
+d_string_replace_all_cstr
+(
+    struct d_string* _str,
+    const char*      _old,
+    const char*      _new
+)
+{
+    size_t old_len;
+
+    if (!d_string_internal_modified(_str, D_STRING_INTERNAL_SITE))
+    {
+        return false;
+    }
+
+    if ( (_str == NULL) || 
+         (_old == NULL) || 
+         (_new == NULL) )
+    {
+        return false;
+    }
+
+    old_len = strlen(_old);
+
+    if (old_len == 0)
+    {
+        return false;
+    }
+
+    return d_string_internal_replace_all(_str,
+                                         _old,
+                                         old_len,
+                                         _new,
+                                         strlen(_new),
+                                         D_STRING_INTERNAL_SITE);
+}
+
+/*
+d_string_replace_char
+  Replace all occurrences of a character.
+
+Parameter(s):
+  _str:      d_string to modify.
+  _old_char: character to replace.
+  _new_char: replacement character.
+Return:
+  true if successful, false otherwise.
+*/
+bool
+d_string_replace_char
+(
+    struct d_string* _str,
+    char             _old_char,
+    char             _new_char
+)
+{
+    if (!d_string_internal_modified(_str, D_STRING_INTERNAL_SITE))
+    {
+        return false;
+    }
+
+    if (_str == NULL)
+    {
+        return false;
+    }
+
+    d_string_internal_replace_byte((unsigned char*)_str->text,
+                                   _str->size,
+                                   (unsigned char)_old_char,
+                                   (unsigned char)_new_char);
+
+    return true;
+}
+
+
+/******************************************************************************
+* Case Conversion Functions
+******************************************************************************/
+
+/*
+d_string_to_lower
+  Convert string to lowercase in-place. Only the ASCII letters 'A'-'Z' are
+mapped ("C" locale); every other byte is left as is.
+
+Parameter(s):
+  _str: d_string to convert.
+Return:
+  true if successful, false if _str is NULL.
+*/
+bool
+d_string_to_lower
+(
+    struct d_string* _str
+)
+{
+    if (!d_string_internal_modified(_str, D_STRING_INTERNAL_SITE))
+    {
+        return false;
+    }
+
+    if ( (_str == NULL) || 
+         (_str->text == NULL) )
+    {
+        return false;
+    }
+
+    d_string_internal_case_copy((unsigned char*)_str->text,
+                                (const unsigned char*)_str->text,
+                                _str->size,
+                                D_STRING_INTERNAL_FOLD_LOWER);
+
+    return true;
+}
+
+/*
+d_string_to_upper
+  Convert string to uppercase in-place. Only the ASCII letters 'a'-'z' are
+mapped ("C" locale); every other byte is left as is.
+
+Parameter(s):
+  _str: d_string to convert.
+Return:
+  true if successful, false if _str is NULL.
+*/
+bool
+d_string_to_upper
+(
+    struct d_string* _str
+)
+{
+    if (!d_string_internal_modified(_str, D_STRING_INTERNAL_SITE))
+    {
+        return false;
+    }
+
+    if ( (_str == NULL) || 
+         (_str->text == NULL) )
+    {
+        return false;
+    }
+
+    d_string_internal_case_copy((unsigned char*)_str->text,
+                                (const unsigned char*)_str->text,
+                                _str->size,
+                                D_STRING_INTERNAL_FOLD_UPPER);
+
+    return true;
+}
+
+/*
+d_string_lower
+  Return new lowercase copy of string.
+
+Parameter(s):
+  _str: d_string to copy and convert.
+Return:
+  New lowercase d_string, or NULL if _str is NULL or allocation fails.
+*/
+struct d_string*
+d_string_lower
+(
+    const struct d_string* _str
+)
+{
+    struct d_string* result;
+
+    if (_str == NULL)
+    {
+        return NULL;
+    }
+
+    result = d_string_new_copy(_str);
+
+    if (result == NULL)
+    {
+        return NULL;
+    }
+
+    d_string_to_lower(result);
+
+    return result;
+}
+
+/*
+d_string_upper
+  Return new uppercase copy of string.
+
+Parameter(s):
+  _str: d_string to copy and convert.
+Return:
+  New uppercase d_string, or NULL if _str is NULL or allocation fails.
+*/
+struct d_string*
+d_string_upper
+(
+    const struct d_string* _str
+)
+{
+    struct d_string* result;
+
+    if (_str == NULL)
+    {
+        return NULL;
+    }
+
+    result = d_string_new_copy(_str);
+
+    if (result == NULL)
+    {
+        return NULL;
+    }
+
+    d_string_to_upper(result);
+
+    return result;
+}
+
+
+/******************************************************************************
+* Reversal Functions
+******************************************************************************/
+
+/*
+d_string_reverse
+  Reverse string in-place.
+
+Parameter(s):
+  _str: d_string to reverse.
+Return:
+  true if successful, false if _str is NULL.
+*/
+bool
+d_string_reverse
+(
+    struct d_string* _str
+)
+{
+    if (!d_string_internal_modified(_str, D_STRING_INTERNAL_SITE))
+    {
+        return false;
+    }
+
+    if ( (_str == NULL) || 
+         (_str->text == NULL) )
+    {
+        return false;
+    }
+
+    d_string_internal_reverse((unsigned char*)_str->text, _str->size);
+
+    return true;
+}
+
+/*
+d_string_reversed
+  Return new reversed copy of string.
+
+Parameter(s):
+  _str: d_string to copy and reverse.
+Return:
+  New reversed d_string, or NULL if _str is NULL or allocation fails.
+*/
+struct d_string*
+d_string_reversed
+(
+    const struct d_string* _str
+)
+{
+    struct d_string* result;
+
+    if (_str == NULL)
+    {
+        return NULL;
+    }
+
+    result = d_string_new_copy(_str);
+
+    if (result == NULL)
+    {
+        return NULL;
+    }
+
+    d_string_reverse(result);
+
+    return result;
+}
+
+
+/******************************************************************************
+* Trimming Functions
+******************************************************************************/
+
+/*
+d_string_trim
+  Trim whitespace from both ends of string in-place.
+
+Parameter(s):
+  _str: d_string to trim.
+Return:
+  true if successful, false if _str is NULL.
+*/
+bool
+d_string_trim
+(
+    struct d_string* _str
+)
+{
+    size_t start;
+    size_t end;
+    size_t new_size;
+
+    if (!d_string_internal_modified(_str, D_STRING_INTERNAL_SITE))
+    {
+        return false;
+    }
+
+    if (_str == NULL)
+    {
+        return false;
+    }
+
+    if (_str->size == 0)
+    {
+        return true;
+    }
+
+    // find first non-whitespace
+    start = d_string_internal_trim_start((const unsigned char*)_str->text,
+                                         _str->size);
+
+    // all whitespace
+    if (start == _str->size)
+    {
+        _str->text[0] = '\0';
+        _str->size    = 0;
+
+        return true;
+    }
+
+    // find end of last non-whitespace
+    end = d_string_internal_trim_end((const unsigned char*)_str->text,
+                                     _str->size);
+
+    new_size = end - start;
+
+    // shift content if needed
+    if (start > 0)
+    {
+        memmove(_str->text, _str->text + start, new_size);
+    }
+
+    _str->text[new_size] = '\0';
+    _str->size           = new_size;
+
+    return true;
+}
+
+/*
+d_string_trim_left
+  Trim whitespace from left side of string in-place.
+
+Parameter(s):
+  _str: d_string to trim.
+Return:
+  true if successful, false if _str is NULL.
+*/
+bool
+d_string_trim_left
+(
+    struct d_string* _str
+)
+{
+    size_t start;
+    size_t new_size;
+
+    if (!d_string_internal_modified(_str, D_STRING_INTERNAL_SITE))
+    {
+        return false;
+    }
+
+    if (_str == NULL)
+    {
+        return false;
+    }
+
+    if (_str->size == 0)
+    {
+        return true;
+    }
+
+    start = d_string_internal_trim_start((const unsigned char*)_str->text,
+                                         _str->size);
+
+    if (start == _str->size)
+    {
+        _str->text[0] = '\0';
+        _str->size    = 0;
+
+        return true;
+    }
+
+    if (start > 0)
+    {
+        new_size = _str->size - start;
+        memmove(_str->text, _str->text + start, new_size + 1);
+        _str->size = new_size;
+    }
+
+    return true;
+}
+
+/*
+d_string_trim_right
+  Trim whitespace from right side of string in-place.
+
+Parameter(s):
+  _str: d_string to trim.
+Return:
+  true if successful, false if _str is NULL.
+*/
+bool
+d_string_trim_right
+(
+    struct d_string* _str
+)
+{
+    size_t end;
+
+    if (!d_string_internal_modified(_str, D_STRING_INTERNAL_SITE))
+    {
+        return false;
+    }
+
+    if (_str == NULL)
+    {
+        return false;
+    }
+
+    if (_str->size == 0)
+    {
+        return true;
+    }
+
+    end = d_string_internal_trim_end((const unsigned char*)_str->text,
+                                     _str->size);
+
+    _str->text[end] = '\0';
+    _str->size      = end;
+
+    return true;
+}
+
+/*
+d_string_trim_chars
+  Trim specified characters from both ends.
+
+Parameter(s):
+  _str:   d_string to trim.
+  _chars: characters to trim.
+Return:
+  true if successful, false if parameters are NULL.
+*/
+bool
+d_string_trim_chars
+(
+    struct d_string* _str,
+    const char*      _chars
+)
+{
+    size_t start;
+    size_t end;
+    size_t new_size;
+
+    if (!d_string_internal_modified(_str, D_STRING_INTERNAL_SITE))
+    {
+        return false;
+    }
+
+    if ( (_str == NULL) || 
+         (_chars == NULL) )
+    {
+        return false;
+    }
+
+    if (_str->size == 0)
+    {
+        return true;
+    }
+
+    // find first character not in _chars
+    start = 0;
+
+    while ( (start < _str->size) && 
+            (strchr(_chars, _str->text[start]) != NULL) )
+    {
+        start++;
+    }
+
+    if (start == _str->size)
+    {
+        _str->text[0] = '\0';
+        _str->size    = 0;
+
+        return true;
+    }
+
+    // find last character not in _chars
+    end = _str->size - 1;
+
+    while ( (end > start) && 
+            (strchr(_chars, _str->text[end]) != NULL) )
+    {
+        end--;
+    }
+
+    new_size = end - start + 1;
+
+    if (start > 0)
+    {
+        memmove(_str->text, _str->text + start, new_size);
+    }
+
+    _str->text[new_size] = '\0';
+    _str->size           = new_size;
+
+    return true;
+}
+
+/*
+d_string_trimmed
+  Return new trimmed copy of string.
+
+Parameter(s):
+  _str: d_string to copy and trim.
+Return:
+  New trimmed d_string, or NULL if _str is NULL or allocation fails.
+*/
+struct d_string*
+d_string_trimmed
+(
+    const struct d_string* _str
+)
+{
+    struct d_string* result;
+
+    if (_str == NULL)
+    {
+        return NULL;
+    }
+
+    result = d_string_new_copy(_str);
+
+    if (result == NULL)
+    {
+        return NULL;
+    }
+
+    d_string_trim(result);
+
+    return result;
+}
+
+/*
+d_string_trimmed_left
+  Return new left-trimmed copy of string.
+
+Parameter(s):
+  _str: d_string to copy and trim.
+Return:
+  New trimmed d_string, or NULL if _str is NULL or allocation fails.
+*/
+struct d_string*
+d_string_trimmed_left
+(
+    const struct d_string* _str
+)
+{
+    struct d_string* result;
+
+    if (_str == NULL)
+    {
+        return NULL;
+    }
+
+    result = d_string_new_copy(_str);
+
+    if (result == NULL)
+    {
+        return NULL;
+    }
+
+    d_string_trim_left(result);
+
+    return result;
+}
+
+/*
+d_string_trimmed_right
+  Return new right-trimmed copy of string.
+
+Parameter(s):
+  _str: d_string to copy and trim.
+Return:
+  New trimmed d_string, or NULL if _str is NULL or allocation fails.
+*/
+struct d_string*
+d_string_trimmed_right
+(
+    const struct d_string* _str
+)
+{
+    struct d_string* result;
+
+    if (_str == NULL)
+    {
+        return NULL;
+    }
+
+    result = d_string_new_copy(_str);
+
+    if (result == NULL)
+    {
+        return NULL;
+    }
+
+    d_string_trim_right(result);
+
+    return result;
+}
+
+/*
+d_string_normalize
+  Trims, case-maps and collapses whitespace in-place, as selected by
+`_flags`, in a single pass over the string. Whitespace and letters are those
+of the "C" locale; D_STRING_NORMALIZE_COLLAPSE replaces each run of
+whitespace with one ' '.
+
+Parameter(s):
+  _str:   d_string to normalize.
+  _flags: bitwise OR of D_STRING_NORMALIZE_* options.
+Return:
+  true if successful, false if _str is NULL or both D_STRING_NORMALIZE_LOWER
+and D_STRING_NORMALIZE_UPPER are given.
+*/
+bool
+d_string_normalize
+(
+    struct d_string* _str,
+    unsigned         _flags
+)
+{
+    unsigned char* text;
+    unsigned       fold;
+    size_t         start;
+    size_t         end;
+    size_t         new_size;
+
+    if ( (_str == NULL) ||
+         ( (_flags & D_STRING_NORMALIZE_LOWER) &&
+           (_flags & D_STRING_NORMALIZE_UPPER) ) )
+    {
+        return false;
+    }
+
+    if (!d_string_internal_modified(_str, D_STRING_INTERNAL_SITE))
+    {
+        return false;
+    }
+
+    if (_str->size == 0)
+    {
+        return true;
+    }
+
+    text  = (unsigned char*)_str->text;
+    start = 0;
+    end   = _str->size;
+
+    if (_flags & D_STRING_NORMALIZE_TRIM)
+    {
+        start = d_string_internal_trim_start(text, end);
+        end   = start + d_string_internal_trim_end(text + start, end - start);
+    }
+
+    fold = (_flags & D_STRING_NORMALIZE_LOWER) ? D_STRING_INTERNAL_FOLD_LOWER :
+           (_flags & D_STRING_NORMALIZE_UPPER) ? D_STRING_INTERNAL_FOLD_UPPER :
+                                                 D_STRING_INTERNAL_FOLD_NONE;
+
+    // shift the kept range to the front while mapping it
+    if (_flags & D_STRING_NORMALIZE_COLLAPSE)
+    {
+        new_size = d_string_internal_collapse(text,
+                                              text + start,
+                                              end - start,
+                                              fold);
+    }
+    else
+    {
+        new_size = end - start;
+        d_string_internal_case_copy(text, text + start, new_size, fold);
+    }
+
+    text[new_size] = '\0';
+    _str->size     = new_size;
+
+    return true;
+}
+
+
+/******************************************************************************
+* Tokenization Functions
+******************************************************************************/
+
+/*
+d_string_tokenize
+  Thread-safe string tokenization.
+
+Parameter(s):
+  _str:     d_string to tokenize (NULL to continue).
+  _delim:   delimiter characters.
+  _saveptr: save state pointer.
+Return:
+  Pointer to next token, or NULL if no more tokens.
+*/
+char*
+d_string_tokenize
+(
+    struct d_string* _str,
+    const char*      _delim,
+    char**           _saveptr
+)
+{
+    char* start;
+
+    if (!d_string_internal_modified(_str, D_STRING_INTERNAL_SITE))
+    {
+        return NULL;
+    }
+
+    if ( (_delim == NULL) || 
+         (_saveptr == NULL) )
+    {
+        return NULL;
+    }
+
+    if (_str != NULL)
+    {
+        start = _str->text;
+    }
+    else
+    {
+        start = NULL;
+    }
+
+    return d_strtok_r(start, _delim, _saveptr);
+}
+
+/*
+d_string_split
+  Split string into array of d_strings. The source is scanned in place (see
+d_string_split_iter), so only the tokens themselves are allocated.
+
+Parameter(s):
+  _str:    d_string to split.
+  _delim:  delimiter characters.
+  _tokens: output array of d_strings (caller must free with d_string_split_free).
+Return:
+  Number of tokens, or 0 on error.
+*/
+size_t
+d_string_split
+(
+    const struct d_string*  _str,
+    const char*             _delim,
+    struct d_string***      _tokens
+)
+{
+    struct d_string_split_iter iter;
+    struct d_string_view       token;
+    size_t                     count;
+    size_t                     capacity;
+    struct d_string**          result;
+    struct d_string**          new_result;
+
+    if ( (_str == NULL) || 
+         (_delim == NULL) || 
+         (_tokens == NULL) )
+    {
+        return 0;
+    }
+
+    *_tokens = NULL;
+
+    // initial allocation
+    capacity = 8;
+    result   = (struct d_string**)D_MEMORY_ALLOC(D_MEMORY_MODULE_STRING,
+                                                 capacity * sizeof(struct d_string*));
+
+    if (result == NULL)
+    {
+        return 0;
+    }
+
+    count = 0;
+    d_string_split_iter_init(&iter, d_string_view_of(_str), _delim);
+
+    while (d_string_split_iter_next(&iter, &token))
+    {
+        // grow array if needed
+        if (count >= capacity)
+        {
+            capacity  *= 2;
+            new_result = (struct d_string**)D_MEMORY_REALLOC(
+                             D_MEMORY_MODULE_STRING,
+                             result,
+                             capacity * sizeof(struct d_string*));
+
+            if (new_result == NULL)
+            {
+                // cleanup on failure
+                d_string_split_free(result, count);
+
+                return 0;
+            }
+
+            result = new_result;
+        }
+
+        // create d_string for token
+        result[count] = d_string_new_from_view(token);
+
+        if (result[count] == NULL)
+        {
+            d_string_split_free(result, count);
+
+            return 0;
+        }
+
+        count++;
+    }
+
+    *_tokens = result;
+
+    return count;
+}
+
+/*
+d_string_split_free
+  Free array of d_strings from d_string_split.
+
+Parameter(s):
+  _tokens: array of d_strings.
+  _count:  number of tokens in array.
+Return:
+  (none)
+*/
+void
+d_string_split_free
+(
+    struct d_string** _tokens,
+    size_t            _count
+)
+{
+    size_t i;
+
+    if (_tokens == NULL)
+    {
+        return;
+    }
+
+    for (i = 0; i < _count; i++)
+    {
+        d_string_free(_tokens[i]);
+    }
+
+    D_MEMORY_FREE(_tokens);
+
+    return;
+}
+
+
+/******************************************************************************
+* String View Functions
+******************************************************************************/
+
+/*
+d_string_view_make
+  Creates a view of `_size` characters starting at `_text`.
+
+Parameter(s):
+  _text: first character of the view; may be NULL only if _size is 0.
+  _size: number of characters in the view.
+Return:
+  A d_string_view referring to the given characters, or an empty view if
+_text is NULL.
+*/
+struct d_string_view
+d_string_view_make
+(
+    const char* _text,
+    size_t      _size
+)
+{
+    struct d_string_view view;
+
+    view.text = _text;
+    view.size = (_text != NULL) ? _size : 0;
+
+    return view;
+}
+
+/*
+d_string_view_from_cstr
+  Creates a view of a null-terminated C string (excluding the terminator).
+
+Parameter(s):
+  _cstr: C string to view.
+Return:
+  A d_string_view of _cstr, or an empty view if _cstr is NULL.
+*/
+struct d_string_view
+d_string_view_from_cstr
+(
+    const char* _cstr
+)
+{
+    return d_string_view_make(_cstr,
+                              (_cstr != NULL) ? strlen(_cstr) : 0);
+}
+
+/*
+d_string_view_of
+  Creates a view of a d_string's entire contents. The view is invalidated by
+any operation that modifies or frees the d_string.
+
+Parameter(s):
+  _str: d_string to view.
+Return:
+  A d_string_view of _str, or an empty view if _str is NULL.
+*/
+struct d_string_view
+d_string_view_of
+(
+    const struct d_string* _str
+)
+{
+    if (_str == NULL)
+    {
+        return d_string_view_make(NULL, 0);
+    }
+
+    return d_string_view_make(_str->text, _str->size);
+}
+
+/*
+d_string_new_from_view
+  Creates a new d_string holding a copy of a view's characters.
+
+Parameter(s):
+  _view: view to copy.
+Return:
+  A pointer value corresponding to either:
+  - newly allocated d_string, if successful, or
+  - NULL, if memory allocation failed.
+*/
+struct d_string*
+d_string_new_from_view
+(
+    struct d_string_view _view
+)
+{
+    if (_view.text == NULL)
+    {
+        return d_string_new();
+    }
+
+    return d_string_new_from_buffer(_view.text, _view.size);
+}
+
+/*
+d_string_view_substr
+  Returns a view of part of another view, without copying.
+
+Parameter(s):
+  _view:   view to slice.
+  _start:  starting index (negative counts from end).
+  _length: number of characters; clamped to the end of _view.
+Return:
+  A d_string_view of the requested range, or an empty view if _start is not
+a valid index into _view.
+*/
+struct d_string_view
+d_string_view_substr
+(
+    struct d_string_view _view,
+    d_index              _start,
+    size_t               _length
+)
+{
+    size_t start_pos;
+
+    if ( (_view.text == NULL) ||
+         (!d_index_convert_safe(_start, _view.size, &start_pos)) )
+    {
+        return d_string_view_make(NULL, 0);
+    }
+
+    // clamp length to available characters
+    if (_length > (_view.size - start_pos))
+    {
+        _length = _view.size - start_pos;
+    }
+
+    return d_string_view_make(_view.text + start_pos, _length);
+}
+
+/*
+d_string_substr_view
+  Zero-copy counterpart of d_string_substr: returns a view of part of a
+d_string.
+
+Parameter(s):
+  _str:    source d_string.
+  _start:  starting index (negative counts from end).
+  _length: number of characters; clamped to the end of _str.
+Return:
+  A d_string_view of the requested range, or an empty view if _str is NULL
+or _start is not a valid index.
+*/
+struct d_string_view
+d_string_substr_view
+(
+    const struct d_string* _str,
+    d_index                _start,
+    size_t                 _length
+)
+{
+    return d_string_view_substr(d_string_view_of(_str), _start, _length);
+}
+
+/*
+d_string_view_trimmed_left
+  Returns a view with leading whitespace removed.
+
+Parameter(s):
+  _view: view to trim.
+Return:
+  A d_string_view of _view without leading whitespace.
+*/
+struct d_string_view
+d_string_view_trimmed_left
+(
+    struct d_string_view _view
+)
+{
+    size_t start;
+
+    if (_view.text == NULL)
+    {
+        return _view;
+    }
+
+    start       = d_string_internal_trim_start((const unsigned char*)_view.text,
+                                               _view.size);
+    _view.text += start;
+    _view.size -= start;
+
+    return _view;
+}
+
+/*
+d_string_view_trimmed_right
+  Returns a view with trailing whitespace removed.
+
+Parameter(s):
+  _view: view to trim.
+Return:
+  A d_string_view of _view without trailing whitespace.
+*/
+struct d_string_view
+d_string_view_trimmed_right
+(
+    struct d_string_view _view
+)
+{
+    if (_view.text == NULL)
+    {
+        return _view;
+    }
+
+    _view.size = d_string_internal_trim_end((const unsigned char*)_view.text,
+                                            _view.size);
+
+    return _view;
+}
+
+/*
+d_string_view_trimmed
+  Returns a view with leading and trailing whitespace removed.
+
+Parameter(s):
+  _view: view to trim.
+Return:
+  A d_string_view of _view without surrounding whitespace.
+*/
+struct d_string_view
+d_string_view_trimmed
+(
+    struct d_string_view _view
+)
+{
+    return d_string_view_trimmed_right(d_string_view_trimmed_left(_view));
+}
+
+/*
+d_string_trimmed_view
+  Zero-copy counterpart of d_string_trimmed.
+
+Parameter(s):
+  _str: d_string to view.
+Return:
+  A d_string_view of _str without surrounding whitespace, or an empty view
+if _str is NULL.
+*/
+struct d_string_view
+d_string_trimmed_view
+(
+    const struct d_string* _str
+)
+{
+    return d_string_view_trimmed(d_string_view_of(_str));
+}
+
+/*
+d_string_trimmed_left_view
+  Zero-copy counterpart of d_string_trimmed_left.
+
+Parameter(s):
+  _str: d_string to view.
+Return:
+  A d_string_view of _str without leading whitespace, or an empty view if
+_str is NULL.
+*/
+struct d_string_view
+d_string_trimmed_left_view
+(
+    const struct d_string* _str
+)
+{
+    return d_string_view_trimmed_left(d_string_view_of(_str));
+}
+
+/*
+d_string_trimmed_right_view
+  Zero-copy counterpart of d_string_trimmed_right.
+
+Parameter(s):
+  _str: d_string to view.
+Return:
+  A d_string_view of _str without trailing whitespace, or an empty view if
+_str is NULL.
+*/
+struct d_string_view
+d_string_trimmed_right_view
+(
+    const struct d_string* _str
+)
+{
+    return d_string_view_trimmed_right(d_string_view_of(_str));
+}
+
+/*
+d_string_view_find
+  Find first occurrence of one view within another. Binary-safe.
+
+Parameter(s):
+  _haystack: view to search in.
+  _needle:   view to search for.
+Return:
+  Index of the first occurrence, 0 if _needle is empty, or -1 if not found.
+*/
+ssize_t
+d_string_view_find
+(
+    struct d_string_view _haystack,
+    struct d_string_view _needle
+)
+{
+    const char* p;
+
+    if (_needle.size == 0)
+    {
+        return 0;
+    }
+
+    p = d_string_internal_search(_haystack.text,
+                                 _haystack.size,
+                                 _needle.text,
+                                 _needle.size);
+
+    if (p == NULL)
+    {
+        return -1;
+    }
+
+    return (ssize_t)(p - _haystack.text);
+}
+
+/*
+d_string_view_find_cstr
+  Find first occurrence of a C string within a view.
+
+Parameter(s):
+  _haystack: view to search in.
+  _needle:   C string to search for.
+Return:
+  Index of the first occurrence, 0 if _needle is empty, or -1 if not found
+or _needle is NULL.
+*/
+ssize_t
+d_string_view_find_cstr
+(
+    struct d_string_view _haystack,
+    const char*          _needle
+)
+{
+    if (_needle == NULL)
+    {
+        return -1;
+    }
+
+    return d_string_view_find(_haystack, d_string_view_from_cstr(_needle));
+}
+
+/*
+d_string_view_find_char
+  Find first occurrence of a character within a view.
+
+Parameter(s):
+  _view: view to search.
+  _c:    character to find.
+Return:
+  Index of character, or -1 if not found.
+*/
+ssize_t
+d_string_view_find_char
+(
+    struct d_string_view _view,
+    char                 _c
+)
+{
+    const char* p;
+
+    if (_view.size == 0)
+    {
+        return -1;
+    }
+
+    p = (const char*)memchr(_view.text, (unsigned char)_c, _view.size);
+
+    if (p == NULL)
+    {
+        return -1;
+    }
+
+    return (ssize_t)(p - _view.text);
+}
+
+/*
+d_string_view_rfind
+  Find last occurrence of one view within another. Binary-safe.
+
+Parameter(s):
+  _haystack: view to search in.
+  _needle:   view to search for.
+Return:
+  Index of the last occurrence, _haystack.size if _needle is empty, or -1 if
+not found.
+*/
+ssize_t
+d_string_view_rfind
+(
+    struct d_string_view _haystack,
+    struct d_string_view _needle
+)
+{
+    const char* p;
+
+    if (_needle.size == 0)
+    {
+        return (ssize_t)_haystack.size;
+    }
+
+    p = d_string_internal_rsearch(_haystack.text,
+                                  _haystack.size,
+                                  _needle.text,
+                                  _needle.size);
+
+    if (p == NULL)
+    {
+        return -1;
+    }
+
+    return (ssize_t)(p - _haystack.text);
+}
+
+/*
+d_string_view_cmp
+  Lexicographically compares two views byte by byte; a view that is a prefix
+of the other compares less.
+
+Parameter(s):
+  _v1: first view.
+  _v2: second view.
+Return:
+  An integer less than, equal to, or greater than zero if _v1 is found to be
+less than, equal to, or greater than _v2.
+*/
+int
+d_string_view_cmp
+(
+    struct d_string_view _v1,
+    struct d_string_view _v2
+)
+{
+    size_t min_size;
+    int    result;
+
+    min_size = (_v1.size < _v2.size) ? _v1.size : _v2.size;
+
+    if (min_size > 0)
+    {
+        result = memcmp(_v1.text, _v2.text, min_size);
+
+        if (result != 0)
+        {
+            return result;
+        }
+    }
+
+    if (_v1.size == _v2.size)
+    {
+        return 0;
+    }
+
+    return (_v1.size < _v2.size) ? -1 : 1;
+}
+
+/*
+d_string_view_cmp_cstr
+  Lexicographically compares a view with a C string.
+
+Parameter(s):
+  _v1: view.
+  _s2: C string; NULL is treated as empty.
+Return:
+  An integer less than, equal to, or greater than zero if _v1 is found to be
+less than, equal to, or greater than _s2.
+*/
+int
+d_string_view_cmp_cstr
+(
+    struct d_string_view _v1,
+    const char*          _s2
+)
+{
+    return d_string_view_cmp(_v1, d_string_view_from_cstr(_s2));
+}
+
+/*
+d_string_view_equals
+  Check if two views hold the same characters.
+
+Parameter(s):
+  _v1: first view.
+  _v2: second view.
+Return:
+  A boolean value: true if equal, false otherwise.
+*/
+bool
+d_string_view_equals
+(
+    struct d_string_view _v1,
+    struct d_string_view _v2
+)
+{
+    return ( (_v1.size == _v2.size) &&
+             ( (_v1.size == 0) ||
+               (memcmp(_v1.text, _v2.text, _v1.size) == 0) ) );
+}
+
+/*
+d_string_view_equals_cstr
+  Check if a view holds the same characters as a C string.
+
+Parameter(s):
+  _v1: view.
+  _s2: C string.
+Return:
+  A boolean value: true if equal, false otherwise (including if _s2 is NULL).
+*/
+bool
+d_string_view_equals_cstr
+(
+    struct d_string_view _v1,
+    const char*          _s2
+)
+{
+    if (_s2 == NULL)
+    {
+        return false;
+    }
+
+    return d_string_view_equals(_v1, d_string_view_from_cstr(_s2));
+}
+
+/*
+d_string_view_starts_with
+  Check if a view begins with another.
+
+Parameter(s):
+  _view:   view to check.
+  _prefix: prefix view.
+Return:
+  A boolean value: true if _view starts with _prefix, false otherwise.
+*/
+bool
+d_string_view_starts_with
+(
+    struct d_string_view _view,
+    struct d_string_view _prefix
+)
+{
+    if (_prefix.size > _view.size)
+    {
+        return false;
+    }
+
+    return ( (_prefix.size == 0) ||
+             (memcmp(_view.text, _prefix.text, _prefix.size) == 0) );
+}
+
+/*
+d_string_view_ends_with
+  Check if a view ends with another.
+
+Parameter(s):
+  _view:   view to check.
+  _suffix: suffix view.
+Return:
+  A boolean value: true if _view ends with _suffix, false otherwise.
+*/
+bool
+d_string_view_ends_with
+(
+    struct d_string_view _view,
+    struct d_string_view _suffix
+)
+{
+    if (_suffix.size > _view.size)
+    {
+        return false;
+    }
+
+    return ( (_suffix.size == 0) ||
+             (memcmp(_view.text + (_view.size - _suffix.size),
+                     _suffix.text,
+                     _suffix.size) == 0) );
+}
+
+/*
+d_string_split_iter_init
+  Prepares an iterator that lazily splits `_source` on any of the characters
+in `_delim`. The source must remain valid and unmodified while iterating.
+
+Parameter(s):
+  _iter:   iterator to initialize.
+  _source: view of the text to split.
+  _delim:  null-terminated set of delimiter characters.
+Return:
+  A boolean value corresponding to either:
+  - true, if the iterator was initialized, or
+  - false, if _iter or _delim was NULL.
+*/
+bool
+d_string_split_iter_init
+(
+    struct d_string_split_iter* _iter,
+    struct d_string_view        _source,
+    const char*                 _delim
+)
+{
+    const unsigned char* d;
+
+    if ( (_iter == NULL) ||
+         (_delim == NULL) )
+    {
+        return false;
+    }
+
+    d_memset(_iter->delims, 0, sizeof(_iter->delims));
+
+    for (d = (const unsigned char*)_delim; *d != '\0'; d++)
+    {
+        _iter->delims[*d >> 3] |= (unsigned char)(1u << (*d & 7));
+    }
+
+    _iter->cursor = _source.text;
+    _iter->end    = _source.text + _source.size;
+
+    return true;
+}
+
+/*
+d_string_split_iter_next
+  Advances a split iterator to the next non-empty token.
+
+Parameter(s):
+  _iter:  iterator initialized with d_string_split_iter_init.
+  _token: receives a view of the next token.
+Return:
+  A boolean value corresponding to either:
+  - true, if a token was produced, or
+  - false, if there are no more tokens or an argument was NULL.
+*/
+bool
+d_string_split_iter_next
+(
+    struct d_string_split_iter* _iter,
+    struct d_string_view*       _token
+)
+{
+    const char*   start;
+    unsigned char c;
+
+    if ( (_iter == NULL) ||
+         (_token == NULL) ||
+         (_iter->cursor == NULL) )
+    {
+        return false;
+    }
+
+    // skip leading delimiters
+    while (_iter->cursor < _iter->end)
+    {
+        c = (unsigned char)*_iter->cursor;
+
+        if (!(_iter->delims[c >> 3] & (1u << (c & 7))))
+        {
+            break;
+        }
+
+        _iter->cursor++;
+    }
+
+    if (_iter->cursor >= _iter->end)
+    {
+        return false;
+    }
+
+    // consume the token
+    start = _iter->cursor;
+
+    while (_iter->cursor < _iter->end)
+    {
+        c = (unsigned char)*_iter->cursor;
+
+        if (_iter->delims[c >> 3] & (1u << (c & 7)))
+        {
+            break;
+        }
+
+        _iter->cursor++;
+    }
+
+    *_token = d_string_view_make(start, (size_t)(_iter->cursor - start));
+
+    return true;
+}
+
+/*
+d_string_split_view
+  Zero-copy counterpart of d_string_split: splits a d_string into views
+using a single allocation for the whole token array.
+
+Parameter(s):
+  _str:    d_string to split; must outlive the returned views.
+  _delim:  delimiter characters.
+  _tokens: output array of views (caller must release with free).
+Return:
+  Number of tokens, or 0 on error or if there are no tokens (in which case
+*_tokens is NULL).
+*/
+size_t
+d_string_split_view
+(
+    const struct d_string* _str,
+    const char*            _delim,
+    struct d_string_view** _tokens
+)
+{
+    struct d_string_split_iter iter;
+    struct d_string_view       token;
+    struct d_string_view*      result;
+    size_t                     count;
+    size_t                     i;
+
+    if ( (_str == NULL) ||
+         (_delim == NULL) ||
+         (_tokens == NULL) )
+    {
+        return 0;
+    }
+
+    *_tokens = NULL;
+
+    // first pass counts, so the array is allocated exactly once
+    count = 0;
+    d_string_split_iter_init(&iter, d_string_view_of(_str), _delim);
+
+    while (d_string_split_iter_next(&iter, &token))
+    {
+        count++;
+    }
+
+    if (count == 0)
+    {
+        return 0;
+    }
+
+    result = (struct d_string_view*)malloc(count * sizeof(struct d_string_view));
+
+    if (result == NULL)
+    {
+        return 0;
+    }
+
+    D_MEMORY_HANDOFF(D_MEMORY_MODULE_STRING, count * sizeof(struct d_string_view));
+
+    i = 0;
+    d_string_split_iter_init(&iter, d_string_view_of(_str), _delim);
+
+    while ( (i < count) &&
+            (d_string_split_iter_next(&iter, &result[i])) )
+    {
+        i++;
+    }
+
+    *_tokens = result;
+
+    return count;
+}
+
+
+/******************************************************************************
+* Join Functions
+******************************************************************************/
+
+/*
+d_string_join
+  Join array of d_strings with delimiter.
+
+Parameter(s):
+  _strings:   array of d_string pointers.
+  _count:     number of strings in array.
+  _delimiter: delimiter to insert between strings.
+Return:
+  New d_string with joined content, or NULL on error.
+*/
+struct d_string*
+d_string_join
+(
+    const struct d_string* const* _strings,
+    size_t                        _count,
+    const char*                   _delimiter
+)
+{
+    size_t           total_len;
+    size_t           delim_len;
+    size_t           i;
+    struct d_string* result;
+
+    if ( (_strings == NULL) || 
+         (_count == 0) )
+    {
+        return d_string_new();
+    }
+
+    delim_len = (_delimiter != NULL) ? strlen(_delimiter) : 0;
+
+    // calculate total length
+    total_len = 0;
+
+    for (i = 0; i < _count; i++)
+    {
+        if (_strings[i] != NULL)
+        {
+            total_len += _strings[i]->size;
+        }
+
+        if (i < _count - 1)
+        {
+            total_len += delim_len;
+        }
+    }
+
+    result = d_string_new_with_capacity(total_len + 1);
+
+    if (result == NULL)
+    {
+        return NULL;
+    }
+
+    // build result
+    for (i = 0; i < _count; i++)
+    {
+        if (_strings[i] != NULL)
+        {
+            d_string_append(result, _strings[i]);
+        }
+
+        if ( (i < _count - 1) && 
+             (delim_len > 0) )
+        {
+            d_string_append_cstr(result, _delimiter);
+        }
+    }
+
+    return result;
+}
+
+/*
+d_string_join_cstr
+  Join array of C strings with delimiter.
+
+Parameter(s):
+  _strings:   array of C string pointers.
+  _count:     number of strings in array.
+  _delimiter: delimiter to insert between strings.
+Return:
+  New d_string with joined content, or NULL on error.
+*/
+struct d_string*
+d_string_join_cstr
+(
+    const char* const* _strings,
+    size_t             _count,
+    const char*        _delimiter
+)
+{
+    size_t           total_len;
+    size_t           delim_len;
+    size_t           i;
+    struct d_string* result;
+
+    if ( (_strings == NULL) || 
+         (_count == 0) )
+    {
+        return d_string_new();
+    }
+
+    delim_len = (_delimiter != NULL) ? strlen(_delimiter) : 0;
+
+    // calculate total length
+    total_len = 0;
+
+    for (i = 0; i < _count; i++)
+    {
+        if (_strings[i] != NULL)
+        {
+            total_len += strlen(_strings[i]);
+        }
+
+        if (i < _count - 1)
+        {
+            total_len += delim_len;
+        }
+    }
+
+    result = d_string_new_with_capacity(total_len + 1);
+
+    if (result == NULL)
+    {
+        return NULL;
+    }
+
+    for (i = 0; i < _count; i++)
+    {
+        if (_strings[i] != NULL)
+        {
+            d_string_append_cstr(result, _strings[i]);
+        }
+
+        if ( (i < _count - 1) && 
+             (delim_len > 0) )
+        {
+            d_string_append_cstr(result, _delimiter);
+        }
+    }
+
+    return result;
+}
+
+/*
+d_string_concat
+  Concatenate multiple d_strings into one.
+
+Parameter(s):
+  _count: number of d_strings to concatenate.
+  ...:    d_string pointers to concatenate.
+Return:
+  New d_string with concatenated content, or NULL on error.
+*/
+struct d_string*
+d_string_concat
+(
+    size_t _count, 
+    ...
+)
+{
+    va_list                args;
+    size_t                 total_len;
+    size_t                 i;
+    const struct d_string* str;
+    struct d_string*       result;
+
+    if (_count == 0)
+    {
+        return d_string_new();
+    }
+
+    // first pass: calculate total length
+    va_start(args, _count);
+    total_len = 0;
+
+    for (i = 0; i < _count; i++)
+    {
+        str = va_arg(args, const struct d_string*);
+
+        if (str != NULL)
+        {
+            total_len += str->size;
+        }
+    }
+
+    va_end(args);
+
+    result = d_string_new_with_capacity(total_len + 1);
+
+    if (result == NULL)
+    {
+        return NULL;
+    }
+
+    // second pass: concatenate
+    va_start(args, _count);
+
+    for (i = 0; i < _count; i++)
+    {
+        str = va_arg(args, const struct d_string*);
+
+        if (str != NULL)
+        {
+            d_string_append(result, str);
+        }
+    }
+
+    va_end(args);
+
+    return result;
+}
+
+
+/******************************************************************************
+* Sorting Functions
+******************************************************************************/
+
+// D_STRING_INTERNAL_SORT_SMALL
+//   constant: ranges of at most this many strings are finished by insertion
+// sort instead of being partitioned further.
+#define D_STRING_INTERNAL_SORT_SMALL 16
+
+// D_STRING_INTERNAL_SORT_STEP
+//   constant: number of string bytes a sort key covers; the key's low byte
+// holds the remaining length instead.
+#define D_STRING_INTERNAL_SORT_STEP 7
+
+// D_STRING_INTERNAL_SORT_TASK_MIN
+//   constant: smallest range d_string_sort_parallel hands to another thread;
+// shorter ranges are sorted by the thread that produced them.
+#define D_STRING_INTERNAL_SORT_TASK_MIN 8192
+
+// D_STRING_INTERNAL_SORT_MAX_THREADS
+//   constant: upper bound on the threads d_string_sort_parallel starts.
+#define D_STRING_INTERNAL_SORT_MAX_THREADS 64
+
+// d_string_internal_sort_item
+//   struct: a string with its sort key at the current depth. The key holds
+// the next seven bytes of the string big-endian and zero-padded, above the
+// number of bytes left capped at 8, so comparing keys as integers orders the
+// strings exactly as d_string_cmp does over those bytes. Equal keys whose low
+// byte is below 8 mean equal strings; otherwise the strings differ, if at
+// all, past the seven bytes. Sorting these 16-byte items instead of pointers
+// keeps almost every comparison inside the array.
+struct d_string_internal_sort_item
+{
+    uint64_t         key;
+    struct d_string* str;
+};
+
+// d_string_internal_sort_task
+//   struct: a range of items waiting for a sorting thread. `fresh` is false
+// when the items' keys must first be loaded at `depth`.
+struct d_string_internal_sort_task
+{
+    struct d_string_internal_sort_item* items;
+    size_t                              count;
+    size_t                              depth;
+    bool                                fresh;
+};
+
+// d_string_internal_sort_pool
+//   struct: shared state of a parallel sort. Threads pop tasks from the stack
+// and push the large ranges they split off; `pending` counts tasks queued or
+// running, so the sort is done when the stack is empty and `pending` is 0.
+struct d_string_internal_sort_pool
+{
+    d_mutex_t                           lock;
+    d_cond_t                            wake;
+    struct d_string_internal_sort_task* tasks;
+    size_t                              top;
+    size_t                              capacity;
+    size_t                              pending;
+};
+
+// d_string_internal_sort_slice
+//   struct: a slice of items whose keys one thread loads at depth 0.
+struct d_string_internal_sort_slice
+{
+    struct d_string_internal_sort_item* items;
+    size_t                              count;
+};
+
+/*
+d_string_internal_sort_key
+  Returns the sort key of `_str` at byte offset `_depth`, which must not
+exceed its size.
+*/
+static D_INLINE uint64_t
+d_string_internal_sort_key
+(
+    const struct d_string* _str,
+    size_t                 _depth
+)
+{
+    uint64_t key;
+    size_t   rest;
+
+    rest = _str->size - _depth;
+    key  = 0;
+
+    memcpy(&key, _str->text + _depth, (rest < 8) ? rest : 8);
+
+#if D_ENV_ARCH_IS_LITTLE_ENDIAN
+    key = d_string_internal_bswap64(key);
+#endif
+
+    return (key & ~(uint64_t)0xFF) | ((rest < 8) ? rest : 8);
+}
+
+/*
+d_string_internal_sort_load
+  Loads the sort keys of `_items[0.._count)` at byte offset `_depth`.
+*/
+static void
+d_string_internal_sort_load
+(
+    struct d_string_internal_sort_item* _items,
+    size_t                              _count,
+    size_t                              _depth
+)
+{
+    size_t i;
+
+    for (i = 0; i < _count; i++)
+    {
+        _items[i].key = d_string_internal_sort_key(_items[i].str, _depth);
+    }
+}
+
+/*
+d_string_internal_sort_less
+  Returns true if `_a` orders before `_b`, given keys loaded at `_depth`.
+Only equal keys of strings that both continue past the key look at the text.
+*/
+static D_INLINE bool
+d_string_internal_sort_less
+(
+    const struct d_string_internal_sort_item* _a,
+    const struct d_string_internal_sort_item* _b,
+    size_t                                    _depth
+)
+{
+    size_t a_rest;
+    size_t b_rest;
+    int    result;
+
+    if (_a->key != _b->key)
+    {
+        return (_a->key < _b->key);
+    }
+
+    if ((_a->key & 0xFF) < 8)
+    {
+        return false;
+    }
+
+    _depth += D_STRING_INTERNAL_SORT_STEP;
+    a_rest  = _a->str->size - _depth;
+    b_rest  = _b->str->size - _depth;
+    result  = memcmp(_a->str->text + _depth,
+                     _b->str->text + _depth,
+                     (a_rest < b_rest) ? a_rest : b_rest);
+
+    return (result < 0) ||
+           ( (result == 0) && (a_rest < b_rest) );
+}
+
+/*
+d_string_internal_sort_median
+  Returns the median of three keys.
+*/
+static D_INLINE uint64_t
+d_string_internal_sort_median
+(
+    uint64_t _a,
+    uint64_t _b,
+    uint64_t _c
+)
+{
+    if (_a < _b)
+    {
+        return (_b < _c) ? _b : ((_a < _c) ? _c : _a);
+    }
+
+    return (_a < _c) ? _a : ((_b < _c) ? _c : _b);
+}
+
+/*
+d_string_internal_sort_pivot
+  Picks a partitioning key: the median of three keys, or for large ranges
+the median of three such medians (Tukey's ninther).
+*/
+static uint64_t
+d_string_internal_sort_pivot
+(
+    const struct d_string_internal_sort_item* _items,
+    size_t                                    _count
+)
+{
+    size_t step;
+    size_t mid;
+    size_t last;
+
+    mid  = _count / 2;
+    last = _count - 1;
+
+    if (_count < 128)
+    {
+        return d_string_internal_sort_median(_items[0].key,
+                                             _items[mid].key,
+                                             _items[last].key);
+    }
+
+    step = _count / 8;
+
+    return d_string_internal_sort_median(
+        d_string_internal_sort_median(_items[0].key,
+                                      _items[step].key,
+                                      _items[2 * step].key),
+        d_string_internal_sort_median(_items[mid - step].key,
+                                      _items[mid].key,
+                                      _items[mid + step].key),
+        d_string_internal_sort_median(_items[last - 2 * step].key,
+                                      _items[last - step].key,
+                                      _items[last].key));
+}
+
+/*
+d_string_internal_sort_insertion
+  Sorts a short range of items with keys loaded at `_depth`.
+*/
+static void
+d_string_internal_sort_insertion
+(
+    struct d_string_internal_sort_item* _items,
+    size_t                              _count,
+    size_t                              _depth
+)
+{
+    struct d_string_internal_sort_item item;
+    size_t                             i;
+    size_t                             j;
+
+    for (i = 1; i < _count; i++)
+    {
+        item = _items[i];
+        j    = i;
+
+        while ( (j > 0) &&
+                (d_string_internal_sort_less(&item, &_items[j - 1], _depth)) )
+        {
+            _items[j] = _items[j - 1];
+            j--;
+        }
+
+        _items[j] = item;
+    }
+}
+
+/*
+d_string_internal_sort_push
+  Queues a range for another thread of `_pool`. Returns false if the range is
+too short to be worth handing off or the queue is full, in which case the
+caller sorts it itself.
+*/
+static bool
+d_string_internal_sort_push
+(
+    struct d_string_internal_sort_pool* _pool,
+    struct d_string_internal_sort_item* _items,
+    size_t                              _count,
+    size_t                              _depth,
+    bool                                _fresh
+)
+{
+    bool pushed;
+
+    if ( (_pool == NULL) ||
+         (_count < D_STRING_INTERNAL_SORT_TASK_MIN) )
+    {
+        return false;
+    }
+
+    d_mutex_lock(&_pool->lock);
+
+    pushed = (_pool->top < _pool->capacity);
+
+    if (pushed)
+    {
+        _pool->tasks[_pool->top].items = _items;
+        _pool->tasks[_pool->top].count = _count;
+        _pool->tasks[_pool->top].depth = _depth;
+        _pool->tasks[_pool->top].fresh = _fresh;
+        _pool->top++;
+        _pool->pending++;
+        d_cond_signal(&_pool->wake);
+    }
+
+    d_mutex_unlock(&_pool->lock);
+
+    return pushed;
+}
+
+/*
+d_string_internal_sort_range
+  Sorts `_items[0.._count)`, whose keys are loaded at `_depth`, by multikey
+quicksort: a three-way partition on the key splits the range into smaller,
+equal and larger keys. The smaller and larger parts are sorted at the same
+depth; the equal part, if its strings continue past the key, is reloaded
+seven bytes deeper. The largest part is handled by the loop and the others
+by recursion, which bounds the recursion depth by log2(_count). With a
+`_pool`, large parts are queued for other threads instead.
+*/
+static void
+d_string_internal_sort_range
+(
+    struct d_string_internal_sort_item* _items,
+    size_t                              _count,
+    size_t                              _depth,
+    struct d_string_internal_sort_pool* _pool
+)
+{
+    struct d_string_internal_sort_item  swap;
+    struct d_string_internal_sort_item* parts[3];
+    size_t                              counts[3];
+    size_t                              depths[3];
+    uint64_t                            pivot;
+    uint64_t                            key;
+    size_t                              lt;
+    size_t                              gt;
+    size_t                              i;
+    size_t                              largest;
+
+    while (_count > D_STRING_INTERNAL_SORT_SMALL)
+    {
+        pivot = d_string_internal_sort_pivot(_items, _count);
+        lt    = 0;
+        gt    = _count;
+        i     = 0;
+
+        // Dijkstra's three-way partition: [0, lt) < pivot, [lt, i) == pivot,
+        // [gt, _count) > pivot
+        while (i < gt)
+        {
+            key = _items[i].key;
+
+            if (key < pivot)
+            {
+                swap          = _items[lt];
+                _items[lt++]  = _items[i];
+                _items[i++]   = swap;
+            }
+            else if (key > pivot)
+            {
+                swap          = _items[--gt];
+                _items[gt]    = _items[i];
+                _items[i]     = swap;
+            }
+            else
+            {
+                i++;
+            }
+        }
+
+        parts[0]  = _items;
+        counts[0] = lt;
+        depths[0] = _depth;
+        parts[1]  = _items + lt;
+        counts[1] = ((pivot & 0xFF) < 8) ? 0 : (gt - lt);
+        depths[1] = _depth + D_STRING_INTERNAL_SORT_STEP;
+        parts[2]  = _items + gt;
+        counts[2] = _count - gt;
+        depths[2] = _depth;
+
+        // equal strings need no further work
+        if (counts[1] == 1)
+        {
+            counts[1] = 0;
+        }
+
+        largest = (counts[0] >= counts[2]) ? 0 : 2;
+        largest = (counts[1] > counts[largest]) ? 1 : largest;
+
+        for (i = 0; i < 3; i++)
+        {
+            if ( (i == largest) ||
+                 (counts[i] == 0) ||
+                 (d_string_internal_sort_push(_pool,
+                                              parts[i],
+                                              counts[i],
+                                              depths[i],
+                                              (i != 1))) )
+            {
+                continue;
+            }
+
+            if (i == 1)
+            {
+                d_string_internal_sort_load(parts[i], counts[i], depths[i]);
+            }
+
+            d_string_internal_sort_range(parts[i],
+                                         counts[i],
+                                         depths[i],
+                                         _pool);
+        }
+
+        if (largest == 1)
+        {
+            d_string_internal_sort_load(parts[1], counts[1], depths[1]);
+        }
+
+        _items = parts[largest];
+        _count = counts[largest];
+        _depth = depths[largest];
+    }
+
+    d_string_internal_sort_insertion(_items, _count, _depth);
+}
+
+/*
+d_string_internal_sort_worker
+  Thread body of a parallel sort: sorts queued ranges until none are left
+and no running range can produce more.
+*/
+static d_thread_result_t
+d_string_internal_sort_worker
+(
+    void* _arg
+)
+{
+    struct d_string_internal_sort_pool* pool;
+    struct d_string_internal_sort_task  task;
+
+    pool = (struct d_string_internal_sort_pool*)_arg;
+
+    d_mutex_lock(&pool->lock);
+
+    for (;;)
+    {
+        while ( (pool->top == 0) &&
+                (pool->pending != 0) )
+        {
+            d_cond_wait(&pool->wake, &pool->lock);
+        }
+
+        if (pool->top == 0)
+        {
+            break;
+        }
+
+        task = pool->tasks[--pool->top];
+
+        d_mutex_unlock(&pool->lock);
+
+        if (!task.fresh)
+        {
+            d_string_internal_sort_load(task.items, task.count, task.depth);
+        }
+
+        d_string_internal_sort_range(task.items, task.count, task.depth, pool);
+
+        d_mutex_lock(&pool->lock);
+
+        if (--pool->pending == 0)
+        {
+            d_cond_broadcast(&pool->wake);
+        }
+    }
+
+    d_mutex_unlock(&pool->lock);
+
+    return D_THREAD_SUCCESS;
+}
+
+/*
+d_string_internal_sort_load_worker
+  Thread body that loads the depth-0 keys of one slice.
+*/
+static d_thread_result_t
+d_string_internal_sort_load_worker
+(
+    void* _arg
+)
+{
+    struct d_string_internal_sort_slice* slice;
+
+    slice = (struct d_string_internal_sort_slice*)_arg;
+
+    d_string_internal_sort_load(slice->items, slice->count, 0);
+
+    return D_THREAD_SUCCESS;
+}
+
+/*
+d_string_internal_sort
+  Sorts `_strings` with up to `_threads` threads. NULL entries are moved to
+the front, matching d_string_cmp; the rest are copied with their keys into a
+scratch array, sorted, and written back. Returns false, leaving `_strings`
+unchanged, if the scratch array cannot be allocated.
+*/
+static bool
+d_string_internal_sort
+(
+    struct d_string** _strings,
+    size_t            _count,
+    size_t            _threads
+)
+{
+    struct d_string_internal_sort_item* items;
+    struct d_string_internal_sort_pool  pool;
+    struct d_string_internal_sort_slice slices[D_STRING_INTERNAL_SORT_MAX_THREADS];
+    d_thread_t                          threads[D_STRING_INTERNAL_SORT_MAX_THREADS];
+    bool                                started[D_STRING_INTERNAL_SORT_MAX_THREADS];
+    size_t                              count;
+    size_t                              nulls;
+    size_t                              per;
+    size_t                              i;
+
+    if (_strings == NULL)
+    {
+        return (_count == 0);
+    }
+
+    if (_count < 2)
+    {
+        return true;
+    }
+
+    items = D_MEMORY_ALLOC(D_MEMORY_MODULE_STRING, _count * sizeof(*items));
+
+    if (items == NULL)
+    {
+        return false;
+    }
+
+    count = 0;
+
+    for (i = 0; i < _count; i++)
+    {
+        if (_strings[i] != NULL)
+        {
+            items[count++].str = _strings[i];
+        }
+    }
+
+    nulls = _count - count;
+
+    if ( (_threads > 1) &&
+         (count >= D_STRING_SORT_PARALLEL_THRESHOLD) &&
+         (d_mutex_init(&pool.lock) == D_MUTEX_SUCCESS) )
+    {
+        if (d_cond_init(&pool.wake) != D_MUTEX_SUCCESS)
+        {
+            d_mutex_destroy(&pool.lock);
+            _threads = 1;
+        }
+    }
+    else
+    {
+        _threads = 1;
+    }
+
+    if (_threads > 1)
+    {
+        if (_threads > D_STRING_INTERNAL_SORT_MAX_THREADS)
+        {
+            _threads = D_STRING_INTERNAL_SORT_MAX_THREADS;
+        }
+
+        // ranges on the stack are disjoint and at least TASK_MIN long
+        pool.capacity = (count / D_STRING_INTERNAL_SORT_TASK_MIN) + 1;
+        pool.tasks    = D_MEMORY_ALLOC(D_MEMORY_MODULE_STRING,
+                                       pool.capacity * sizeof(*pool.tasks));
+        pool.top      = 0;
+        pool.pending  = 1;
+
+        if (pool.tasks == NULL)
+        {
+            d_cond_destroy(&pool.wake);
+            d_mutex_destroy(&pool.lock);
+            _threads = 1;
+        }
+    }
+
+    if (_threads > 1)
+    {
+        // loading the first keys touches every string; split it evenly
+        per = (count + _threads - 1) / _threads;
+
+        for (i = 0; i < _threads; i++)
+        {
+            slices[i].items = items + (i * per);
+            slices[i].count = (i * per < count) ? count - (i * per) : 0;
+            slices[i].count = (slices[i].count < per) ? slices[i].count : per;
+            started[i]      = (i > 0) &&
+                              (d_thread_create(&threads[i],
+                                               d_string_internal_sort_load_worker,
+                                               &slices[i]) == D_MUTEX_SUCCESS);
+
+            if (!started[i])
+            {
+                d_string_internal_sort_load(slices[i].items, slices[i].count, 0);
+            }
+        }
+
+        for (i = 1; i < _threads; i++)
+        {
+            if (started[i])
+            {
+                d_thread_join(threads[i], NULL);
+            }
+        }
+
+        pool.tasks[0].items = items;
+        pool.tasks[0].count = count;
+        pool.tasks[0].depth = 0;
+        pool.tasks[0].fresh = true;
+        pool.top            = 1;
+
+        for (i = 1; i < _threads; i++)
+        {
+            started[i] = (d_thread_create(&threads[i],
+                                          d_string_internal_sort_worker,
+                                          &pool) == D_MUTEX_SUCCESS);
+        }
+
+        d_string_internal_sort_worker(&pool);
+
+        for (i = 1; i < _threads; i++)
+        {
+            if (started[i])
+            {
+                d_thread_join(threads[i], NULL);
+            }
+        }
+
+        D_MEMORY_FREE(pool.tasks);
+        d_cond_destroy(&pool.wake);
+        d_mutex_destroy(&pool.lock);
+    }
+    else
+    {
+        d_string_internal_sort_load(items, count, 0);
+        d_string_internal_sort_range(items, count, 0, NULL);
+    }
+
+    for (i = 0; i < nulls; i++)
+    {
+        _strings[i] = NULL;
+    }
+
+    for (i = 0; i < count; i++)
+    {
+        _strings[nulls + i] = items[i].str;
+    }
+
+    D_MEMORY_FREE(items);
+
+    return true;
+}
+
+/*
+d_string_sort
+  Sorts an array of d_strings into d_string_cmp order: bytewise, a prefix
+before the longer string, NULL entries first. This is a multikey quicksort
+over seven-byte keys cached beside each pointer, so most comparisons never
+touch the strings themselves. The sort is not stable; equal strings may be
+reordered.
+
+Parameter(s):
+  _strings: array of d_string pointers to sort in place.
+  _count:   number of entries in `_strings`.
+Return:
+  true if successful, false if `_strings` was NULL with a nonzero `_count`
+or the scratch array (16 bytes per string) could not be allocated, in which
+case the array is unchanged.
+*/
+bool
+d_string_sort
+(
+    struct d_string** _strings,
+    size_t            _count
+)
+{
+    return d_string_internal_sort(_strings, _count, 1);
+}
+
+/*
+d_string_sort_parallel
+  Sorts an array of d_strings like d_string_sort, using up to `_threads`
+threads. Ranges produced by partitioning are handed to idle threads, so the
+work stays balanced even when many strings share a prefix. Arrays shorter
+than D_STRING_SORT_PARALLEL_THRESHOLD are sorted on the calling thread. If
+a thread cannot be started the sort proceeds with fewer.
+
+Parameter(s):
+  _strings: array of d_string pointers to sort in place.
+  _count:   number of entries in `_strings`.
+  _threads: maximum number of threads, including the caller; 0 uses the
+            hardware concurrency.
+Return:
+  true if successful, false if `_strings` was NULL with a nonzero `_count`
+or memory allocation failed, in which case the array is unchanged.
+*/
+bool
+d_string_sort_parallel
+(
+    struct d_string** _strings,
+    size_t            _count,
+    size_t            _threads
+)
+{
+    int hardware;
+
+    if (_threads == 0)
+    {
+        hardware = d_thread_hardware_concurrency();
+        _threads = (hardware > 0) ? (size_t)hardware : 1;
+    }
+
+    return d_string_internal_sort(_strings, _count, _threads);
+}
+
+/*
+d_string_unique
+  Removes adjacent duplicates from an array of d_strings, normally one sorted
+by d_string_sort, like C++ `std::unique`. The first string of each run of
+equal strings is kept, in order, at the front of the array. No string is
+freed: the duplicates are moved, in unspecified order, to the entries past
+the returned count, so the caller can still free every string.
+
+Parameter(s):
+  _strings: array of d_string pointers to deduplicate in place.
+  _count:   number of entries in `_strings`.
+Return:
+  The number of distinct strings kept at the front of `_strings`, or 0 if
+`_strings` was NULL.
+*/
+size_t
+d_string_unique
+(
+    struct d_string** _strings,
+    size_t            _count
+)
+{
+    struct d_string* last;
+    struct d_string* str;
+    size_t           kept;
+    size_t           i;
+
+    if ( (_strings == NULL) ||
+         (_count == 0) )
+    {
+        return 0;
+    }
+
+    kept = 1;
+
+    for (i = 1; i < _count; i++)
+    {
+        last = _strings[kept - 1];
+        str  = _strings[i];
+
+        if ( (last == str) ||
+             ( (last != NULL) &&
+               (str != NULL) &&
+               (last->size == str->size) &&
+               (memcmp(last->text, str->text, str->size) == 0) ) )
+        {
+            continue;
+        }
+
+        _strings[i]      = _strings[kept];
+        _strings[kept++] = str;
+    }
+
+    return kept;
+}
+
+
+/******************************************************************************
+* Edit Distance Functions
+******************************************************************************/
+
+// D_STRING_DISTANCE_*
+//   constant: compile-time selection of the batch edit distance kernel, which
+// scores one query against several candidates at once, one candidate per
+// 64-bit vector lane. With D_STRING_CLASS_AVX2_DISPATCH the AVX2 kernel is
+// chosen at run time when the CPU supports it.
+#if ( defined(D_STRING_CLASS_AVX2) ||                             \
+      defined(D_STRING_CLASS_AVX2_DISPATCH) )
+    #define D_STRING_DISTANCE_LANES 4
+#elif defined(D_STRING_CLASS_SSE2)
+    #define D_STRING_DISTANCE_LANES 2
+#else
+    #define D_STRING_DISTANCE_LANES 1
+#endif
+
+/*
+d_string_internal_distance_word
+  Returns the Levenshtein distance between a pattern of `_m` bytes (1 to 64)
+and `_text[0.._n)`, where `_peq[c]` has bit i set if pattern byte i is `c`.
+This is Myers' bit-vector algorithm in Hyyro's formulation: each text byte
+advances a whole column of the DP table with a dozen word operations, the
+column being held as vertical +1/-1 deltas in `pv`/`mv`. Returns `_max + 1`
+as soon as the remaining text can no longer bring the distance within
+`_max` (Ukkonen's cut-off).
+*/
+static size_t
+d_string_internal_distance_word
+(
+    const uint64_t*      _peq,
+    size_t               _m,
+    const unsigned char* _text,
+    size_t               _n,
+    size_t               _max
+)
+{
+    uint64_t pv;
+    uint64_t mv;
+    uint64_t eq;
+    uint64_t xv;
+    uint64_t xh;
+    uint64_t ph;
+    uint64_t mh;
+    uint64_t last;
+    size_t   score;
+    size_t   rest;
+    size_t   j;
+
+    pv    = ~(uint64_t)0;
+    mv    = 0;
+    last  = (uint64_t)1 << (_m - 1);
+    score = _m;
+
+    for (j = 0; j < _n; j++)
+    {
+        eq = _peq[_text[j]];
+        xv = eq | mv;
+        xh = (((eq & pv) + pv) ^ pv) | eq;
+        ph = mv | ~(xh | pv);
+        mh = pv & xh;
+
+        score += ((ph & last) != 0);
+        score -= ((mh & last) != 0);
+
+        // the top row of the table grows by one per column
+        ph = (ph << 1) | 1;
+        mh = mh << 1;
+        pv = mh | ~(xv | ph);
+        mv = ph & xv;
+
+        // each remaining text byte can lower the distance by at most one
+        rest = _n - j - 1;
+
+        if ( (score > rest) &&
+             (score - rest > _max) )
+        {
+            return _max + 1;
+        }
+    }
+
+    return score;
+}
+
+/*
+d_string_internal_distance_blocks
+  Returns the Levenshtein distance between a pattern of `_m` bytes (more than
+64) and `_text[0.._n)`, running the bit-vector algorithm over 64-row blocks
+that pass a horizontal delta (-1, 0 or +1) down to the next block (Hyyro's
+blocked variant). Returns `_max + 1` once the distance must exceed `_max`,
+or SIZE_MAX if memory allocation failed.
+*/
+static size_t
+d_string_internal_distance_blocks
+(
+    const unsigned char* _pattern,
+    size_t               _m,
+    const unsigned char* _text,
+    size_t               _n,
+    size_t               _max
+)
+{
+    uint64_t* peq;
+    uint64_t* pv;
+    uint64_t* mv;
+    uint64_t  eq;
+    uint64_t  xv;
+    uint64_t  xh;
+    uint64_t  ph;
+    uint64_t  mh;
+    uint64_t  high;
+    uint64_t  pos;
+    uint64_t  neg;
+    size_t    blocks;
+    size_t    score;
+    size_t    rest;
+    size_t    b;
+    size_t    i;
+    size_t    j;
+    int       carry;
+
+    blocks = (_m + 63) / 64;
+    peq    = D_MEMORY_CALLOC(D_MEMORY_MODULE_STRING, blocks * 258, sizeof(uint64_t));
+
+    if (peq == NULL)
+    {
+        return SIZE_MAX;
+    }
+
+    // layout: 256 match masks per block, then the pv and mv vectors
+    pv = peq + (blocks * 256);
+    mv = pv + blocks;
+
+    for (i = 0; i < _m; i++)
+    {
+        peq[((i / 64) * 256) + _pattern[i]] |= (uint64_t)1 << (i % 64);
+    }
+
+    for (b = 0; b < blocks; b++)
+    {
+        pv[b] = ~(uint64_t)0;
+    }
+
+    score = _m;
+
+    for (j = 0; j < _n; j++)
+    {
+        carry = 1;
+
+        for (b = 0; b < blocks; b++)
+        {
+            high = (b + 1 < blocks) ? ((uint64_t)1 << 63)
+                                    : ((uint64_t)1 << ((_m - 1) % 64));
+            pos  = (carry > 0);
+            neg  = (carry < 0);
+            eq   = peq[(b * 256) + _text[j]];
+            xv   = eq | mv[b];
+            eq  |= neg;
+            xh   = (((eq & pv[b]) + pv[b]) ^ pv[b]) | eq;
+            ph   = mv[b] | ~(xh | pv[b]);
+            mh   = pv[b] & xh;
+
+            // delta of this block's bottom row, passed to the next block
+            carry = ((ph & high) != 0) - ((mh & high) != 0);
+
+            ph    = (ph << 1) | pos;
+            mh    = (mh << 1) | neg;
+            pv[b] = mh | ~(xv | ph);
+            mv[b] = ph & xv;
+        }
+
+        if (carry > 0)
+        {
+            score++;
+        }
+        else if (carry < 0)
+        {
+            score--;
+        }
+
+        rest = _n - j - 1;
+
+        if ( (score > rest) &&
+             (score - rest > _max) )
+        {
+            score = _max + 1;
+
+            break;
+        }
+    }
+
+    D_MEMORY_FREE(peq);
+
+    return score;
+}
+
+/*
+d_string_internal_distance
+  Returns the Levenshtein distance between `_a[0.._na)` and `_b[0.._nb)`, or
+`_max + 1` if it exceeds `_max`, or SIZE_MAX if memory allocation failed.
+The common prefix and suffix are stripped first, and the shorter string
+becomes the bit-vector pattern.
+*/
+static size_t
+d_string_internal_distance
+(
+    const unsigned char* _a,
+    size_t               _na,
+    const unsigned char* _b,
+    size_t               _nb,
+    size_t               _max
+)
+{
+    const unsigned char* swap_text;
+    uint64_t             peq[256];
+    size_t               swap_size;
+    size_t               result;
+    size_t               i;
+
+    while ( (_na > 0) &&
+            (_nb > 0) &&
+            (*_a == *_b) )
+    {
+        _a++;
+        _b++;
+        _na--;
+        _nb--;
+    }
+
+    while ( (_na > 0) &&
+            (_nb > 0) &&
+            (_a[_na - 1] == _b[_nb - 1]) )
+    {
+        _na--;
+        _nb--;
+    }
+
+    if (_na > _nb)
+    {
+        swap_text = _a;
+        _a        = _b;
+        _b        = swap_text;
+        swap_size = _na;
+        _na       = _nb;
+        _nb       = swap_size;
+    }
+
+    // the distance is at least the difference in length
+    if (_nb - _na > _max)
+    {
+        return _max + 1;
+    }
+
+    if (_na == 0)
+    {
+        return _nb;
+    }
+
+    if (_na > 64)
+    {
+        return d_string_internal_distance_blocks(_a, _na, _b, _nb, _max);
+    }
+
+    // clear only the entries the scan will read, not all 256
+    for (i = 0; i < _nb; i++)
+    {
+        peq[_b[i]] = 0;
+    }
+
+    for (i = 0; i < _na; i++)
+    {
+        peq[_a[i]] = 0;
+    }
+
+    for (i = 0; i < _na; i++)
+    {
+        peq[_a[i]] |= (uint64_t)1 << i;
+    }
+
+    result = d_string_internal_distance_word(peq, _na, _b, _nb, _max);
+
+    return (result > _max) ? _max + 1 : result;
+}
+
+#if ( defined(D_STRING_CLASS_AVX2) ||                             \
+      defined(D_STRING_CLASS_AVX2_DISPATCH) )
+
+/*
+d_string_internal_distance_x4_avx2
+  Scores a pattern of `_m` bytes (1 to 64, match masks in `_peq`) against
+four texts at once, one per 64-bit lane, storing the distances in
+`_scores`. Lanes whose text has ended stop accumulating their score.
+*/
+D_STRING_CLASS_AVX2_FN static void
+d_string_internal_distance_x4_avx2
+(
+    const uint64_t*             _peq,
+    size_t                      _m,
+    const unsigned char* const* _texts,
+    const size_t*               _lengths,
+    size_t*                     _scores
+)
+{
+    __m256i pv;
+    __m256i mv;
+    __m256i eq;
+    __m256i xv;
+    __m256i xh;
+    __m256i ph;
+    __m256i mh;
+    __m256i live;
+    __m256i score;
+    __m256i one;
+    __m256i ones;
+    __m128i shift;
+    int64_t lanes[4];
+    size_t  longest;
+    size_t  j;
+    size_t  k;
+
+    longest = 0;
+
+    for (k = 0; k < 4; k++)
+    {
+        longest = (_lengths[k] > longest) ? _lengths[k] : longest;
+    }
+
+    pv    = _mm256_set1_epi64x(-1);
+    mv    = _mm256_setzero_si256();
+    one   = _mm256_set1_epi64x(1);
+    ones  = _mm256_set1_epi64x(-1);
+    score = _mm256_set1_epi64x((int64_t)_m);
+    shift = _mm_cvtsi32_si128((int)(_m - 1));
+
+    for (j = 0; j < longest; j++)
+    {
+        eq   = _mm256_set_epi64x(
+                   (j < _lengths[3]) ? (int64_t)_peq[_texts[3][j]] : 0,
+                   (j < _lengths[2]) ? (int64_t)_peq[_texts[2][j]] : 0,
+                   (j < _lengths[1]) ? (int64_t)_peq[_texts[1][j]] : 0,
+                   (j < _lengths[0]) ? (int64_t)_peq[_texts[0][j]] : 0);
+        live = _mm256_set_epi64x(-(int64_t)(j < _lengths[3]),
+                                 -(int64_t)(j < _lengths[2]),
+                                 -(int64_t)(j < _lengths[1]),
+                                 -(int64_t)(j < _lengths[0]));
+
+        xv = _mm256_or_si256(eq, mv);
+        xh = _mm256_or_si256(
+                 _mm256_xor_si256(
+                     _mm256_add_epi64(_mm256_and_si256(eq, pv), pv),
+                     pv),
+                 eq);
+        ph = _mm256_or_si256(mv,
+                             _mm256_andnot_si256(_mm256_or_si256(xh, pv),
+                                                 ones));
+        mh = _mm256_and_si256(pv, xh);
+
+        score = _mm256_add_epi64(
+                    score,
+                    _mm256_and_si256(
+                        live,
+                        _mm256_sub_epi64(
+                            _mm256_and_si256(_mm256_srl_epi64(ph, shift),
+                                             one),
+                            _mm256_and_si256(_mm256_srl_epi64(mh, shift),
+                                             one))));
+
+        ph = _mm256_or_si256(_mm256_slli_epi64(ph, 1), one);
+        mh = _mm256_slli_epi64(mh, 1);
+        pv = _mm256_or_si256(mh,
+                             _mm256_andnot_si256(_mm256_or_si256(xv, ph),
+                                                 ones));
+        mv = _mm256_and_si256(ph, xv);
+    }
+
+    _mm256_storeu_si256((__m256i*)lanes, score);
+
+    for (k = 0; k < 4; k++)
+    {
+        _scores[k] = (size_t)lanes[k];
+    }
+}
+
+#endif  // D_STRING_CLASS_AVX2 || D_STRING_CLASS_AVX2_DISPATCH
+
+#if defined(D_STRING_CLASS_SSE2)
+
+/*
+d_string_internal_distance_x2_sse2
+  Scores a pattern of `_m` bytes (1 to 64, match masks in `_peq`) against
+two texts at once, one per 64-bit lane (see
+d_string_internal_distance_x4_avx2).
+*/
+static void
+d_string_internal_distance_x2_sse2
+(
+    const uint64_t*             _peq,
+    size_t                      _m,
+    const unsigned char* const* _texts,
+    const size_t*               _lengths,
+    size_t*                     _scores
+)
+{
+    __m128i pv;
+    __m128i mv;
+    __m128i eq;
+    __m128i xv;
+    __m128i xh;
+    __m128i ph;
+    __m128i mh;
+    __m128i live;
+    __m128i score;
+    __m128i one;
+    __m128i ones;
+    __m128i shift;
+    int64_t lanes[2];
+    size_t  longest;
+    size_t  j;
+
+    longest = (_lengths[0] > _lengths[1]) ? _lengths[0] : _lengths[1];
+
+    pv    = _mm_set1_epi64x(-1);
+    mv    = _mm_setzero_si128();
+    one   = _mm_set1_epi64x(1);
+    ones  = _mm_set1_epi64x(-1);
+    score = _mm_set1_epi64x((int64_t)_m);
+    shift = _mm_cvtsi32_si128((int)(_m - 1));
+
+    for (j = 0; j < longest; j++)
+    {
+        eq   = _mm_set_epi64x(
+                   (j < _lengths[1]) ? (int64_t)_peq[_texts[1][j]] : 0,
+                   (j < _lengths[0]) ? (int64_t)_peq[_texts[0][j]] : 0);
+        live = _mm_set_epi64x(-(int64_t)(j < _lengths[1]),
+                              -(int64_t)(j < _lengths[0]));
+
+        xv = _mm_or_si128(eq, mv);
+        xh = _mm_or_si128(
+                 _mm_xor_si128(_mm_add_epi64(_mm_and_si128(eq, pv), pv), pv),
+                 eq);
+        ph = _mm_or_si128(mv,
+                          _mm_andnot_si128(_mm_or_si128(xh, pv), ones));
+        mh = _mm_and_si128(pv, xh);
+
+        score = _mm_add_epi64(
+                    score,
+                    _mm_and_si128(
+                        live,
+                        _mm_sub_epi64(
+                            _mm_and_si128(_mm_srl_epi64(ph, shift), one),
+                            _mm_and_si128(_mm_srl_epi64(mh, shift), one))));
+
+        ph = _mm_or_si128(_mm_slli_epi64(ph, 1), one);
+        mh = _mm_slli_epi64(mh, 1);
+        pv = _mm_or_si128(mh,
+                          _mm_andnot_si128(_mm_or_si128(xv, ph), ones));
+        mv = _mm_and_si128(ph, xv);
+    }
+
+    _mm_storeu_si128((__m128i*)lanes, score);
+
+    _scores[0] = (size_t)lanes[0];
+    _scores[1] = (size_t)lanes[1];
+}
+
+#endif  // D_STRING_CLASS_SSE2
+
+/*
+d_string_internal_distance_lanes
+  Scores a pattern of `_m` bytes (1 to 64, match masks in `_peq`) against
+`_count` texts (at most D_STRING_DISTANCE_LANES; unused slots have length
+0), using the widest lane kernel available. Only the scalar kernel stops
+early at `_max`.
+*/
+static void
+d_string_internal_distance_lanes
+(
+    const uint64_t*             _peq,
+    size_t                      _m,
+    const unsigned char* const* _texts,
+    const size_t*               _lengths,
+    size_t                      _count,
+    size_t                      _max,
+    size_t*                     _scores
+)
+{
+    uint32_t features;
+    size_t   k;
+
+    features = d_env_cpu_features();
+
+#if defined(D_STRING_CLASS_AVX2)
+    if (features & D_ENV_CPU_FEATURE_AVX2)
+#elif defined(D_STRING_CLASS_AVX2_DISPATCH)
+    // two texts fit the baseline SSE2 kernel
+    if ( (_count > 2) &&
+         (features & D_ENV_CPU_FEATURE_AVX2) )
+#endif
+#if ( defined(D_STRING_CLASS_AVX2) ||                             \
+      defined(D_STRING_CLASS_AVX2_DISPATCH) )
+    {
+        d_string_internal_distance_x4_avx2(_peq, _m, _texts, _lengths, _scores);
+
+        return;
+    }
+#endif
+
+#if defined(D_STRING_CLASS_SSE2)
+    if (features & D_ENV_CPU_FEATURE_SSE2)
+    {
+        for (k = 0; k < _count; k += 2)
+        {
+            d_string_internal_distance_x2_sse2(_peq,
+                                               _m,
+                                               _texts + k,
+                                               _lengths + k,
+                                               _scores + k);
+        }
+
+        return;
+    }
+#endif
+
+    for (k = 0; k < _count; k++)
+    {
+        _scores[k] = d_string_internal_distance_word(_peq,
+                                                     _m,
+                                                     _texts[k],
+                                                     _lengths[k],
+                                                     _max);
+    }
+
+    return;
+}
+
+/*
+d_string_internal_distance_group
+  Scores a group of `_count` batch candidates, padding the unused lanes with
+empty texts, and stores each result, capped at `_max + 1`, in
+`_distances[_slots[k]]`. Returns the number within `_max`.
+*/
+static size_t
+d_string_internal_distance_group
+(
+    const uint64_t*       _peq,
+    size_t                _m,
+    const unsigned char** _texts,
+    size_t*               _lengths,
+    const size_t*         _slots,
+    size_t                _count,
+    size_t                _max,
+    size_t*               _distances
+)
+{
+    size_t scores[D_STRING_DISTANCE_LANES];
+    size_t matched;
+    size_t k;
+
+    for (k = _count; k < D_STRING_DISTANCE_LANES; k++)
+    {
+        _texts[k]   = _texts[0];
+        _lengths[k] = 0;
+    }
+
+    d_string_internal_distance_lanes(_peq,
+                                     _m,
+                                     _texts,
+                                     _lengths,
+                                     _count,
+                                     _max,
+                                     scores);
+
+    matched = 0;
+
+    for (k = 0; k < _count; k++)
+    {
+        _distances[_slots[k]] = (scores[k] > _max) ? _max + 1 : scores[k];
+        matched              += (scores[k] <= _max);
+    }
+
+    return matched;
+}
+
+/*
+d_string_view_distance
+  Computes the Levenshtein (edit) distance between two views: the fewest
+single-byte insertions, deletions and substitutions turning one into the
+other. Strings of up to 64 bytes (after removing any common prefix and
+suffix) are compared with a few word operations per byte, using Myers'
+bit-parallel algorithm; longer ones use a 64-row block per word. With a
+finite `_max` the computation stops as soon as the distance is known to
+exceed it, which makes rejecting dissimilar strings cheap. Distances are
+measured in bytes, not UTF-8 code points.
+
+Parameter(s):
+  _a:   first view.
+  _b:   second view.
+  _max: largest distance of interest, or SIZE_MAX for no limit.
+Return:
+  The edit distance if it is at most `_max`, `_max + 1` if it is larger, or
+SIZE_MAX if memory allocation failed (only possible when both strings are
+longer than 64 bytes).
+*/
+size_t
+d_string_view_distance
+(
+    struct d_string_view _a,
+    struct d_string_view _b,
+    size_t               _max
+)
+{
+    return d_string_internal_distance((const unsigned char*)_a.text,
+                                      _a.size,
+                                      (const unsigned char*)_b.text,
+                                      _b.size,
+                                      _max);
+}
+
+/*
+d_string_distance
+  Computes the Levenshtein (edit) distance between two d_strings (see
+d_string_view_distance). A NULL d_string is treated as empty.
+
+Parameter(s):
+  _a: first d_string.
+  _b: second d_string.
+Return:
+  The edit distance, or SIZE_MAX if memory allocation failed.
+*/
+size_t
+d_string_distance
+(
+    const struct d_string* _a,
+    const struct d_string* _b
+)
+{
+    return d_string_view_distance(d_string_view_of(_a),
+                                  d_string_view_of(_b),
+                                  SIZE_MAX);
+}
+
+/*
+d_string_distance_bounded
+  Computes the Levenshtein distance between two d_strings, giving up as soon
+as it is known to exceed `_max` (see d_string_view_distance). This is the
+call to use for "is it within k edits" tests. A NULL d_string is treated as
+empty.
+
+Parameter(s):
+  _a:   first d_string.
+  _b:   second d_string.
+  _max: largest distance of interest.
+Return:
+  The edit distance if it is at most `_max`, `_max + 1` if it is larger, or
+SIZE_MAX if memory allocation failed.
+*/
+size_t
+d_string_distance_bounded
+(
+    const struct d_string* _a,
+    const struct d_string* _b,
+    size_t                 _max
+)
+{
+    return d_string_view_distance(d_string_view_of(_a),
+                                  d_string_view_of(_b),
+                                  _max);
+}
+
+/*
+d_string_distance_batch
+  Computes the Levenshtein distance from one query to each of an array of
+candidates, e.g. to find "did you mean" suggestions in a dictionary. The
+query's match table is built once. Candidates whose length alone puts them
+more than `_max` edits away are rejected without being scanned; for queries
+of up to 64 bytes the rest are scored several at a time, one per vector
+lane. NULL candidates are treated as empty.
+
+Parameter(s):
+  _query:      d_string to compare against every candidate.
+  _candidates: array of candidate d_strings.
+  _count:      number of candidates.
+  _max:        largest distance of interest, or SIZE_MAX for no limit.
+  _distances:  receives `_count` results: each candidate's distance, or
+               `_max + 1` if it is larger than `_max`.
+Return:
+  The number of candidates within `_max` edits of the query, or SIZE_MAX if
+`_candidates` or `_distances` was NULL with a nonzero `_count`, or memory
+allocation failed.
+*/
+size_t
+d_string_distance_batch
+(
+    const struct d_string*        _query,
+    const struct d_string* const* _candidates,
+    size_t                        _count,
+    size_t                        _max,
+    size_t*                       _distances
+)
+{
+    const unsigned char* texts[D_STRING_DISTANCE_LANES];
+    const unsigned char* query;
+    uint64_t             peq[256];
+    size_t               lengths[D_STRING_DISTANCE_LANES];
+    size_t               slots[D_STRING_DISTANCE_LANES];
+    size_t               m;
+    size_t               size;
+    size_t               matched;
+    size_t               pending;
+    size_t               gap;
+    size_t               i;
+
+    if (_count == 0)
+    {
+        return 0;
+    }
+
+    if ( (_candidates == NULL) ||
+         (_distances == NULL) )
+    {
+        return SIZE_MAX;
+    }
+
+    query   = (_query != NULL) ? (const unsigned char*)_query->text : NULL;
+    m       = (_query != NULL) ? _query->size : 0;
+    matched = 0;
+
+    // long queries gain nothing from lanes; compare them one by one
+    if (m > 64)
+    {
+        for (i = 0; i < _count; i++)
+        {
+            _distances[i] = d_string_internal_distance(
+                query,
+                m,
+                (_candidates[i] != NULL)
+                    ? (const unsigned char*)_candidates[i]->text
+                    : NULL,
+                (_candidates[i] != NULL) ? _candidates[i]->size : 0,
+                _max);
+
+            if (_distances[i] == SIZE_MAX)
+            {
+                return SIZE_MAX;
+            }
+
+            matched += (_distances[i] <= _max);
+        }
+
+        return matched;
+    }
+
+    memset(peq, 0, sizeof(peq));
+
+    for (i = 0; i < m; i++)
+    {
+        peq[query[i]] |= (uint64_t)1 << i;
+    }
+
+    pending = 0;
+
+    for (i = 0; i < _count; i++)
+    {
+        size = (_candidates[i] != NULL) ? _candidates[i]->size : 0;
+        gap  = (size > m) ? (size - m) : (m - size);
+
+        if (gap > _max)
+        {
+            _distances[i] = _max + 1;
+
+            continue;
+        }
+
+        if ( (m == 0) ||
+             (size == 0) )
+        {
+            _distances[i] = gap;
+            matched++;
+
+            continue;
+        }
+
+        texts[pending]   = (const unsigned char*)_candidates[i]->text;
+        lengths[pending] = size;
+        slots[pending]   = i;
+        pending++;
+
+        if (pending == D_STRING_DISTANCE_LANES)
+        {
+            matched += d_string_internal_distance_group(peq,
+                                                        m,
+                                                        texts,
+                                                        lengths,
+                                                        slots,
+                                                        pending,
+                                                        _max,
+                                                        _distances);
+            pending  = 0;
+        }
+    }
+
+    if (pending > 0)
+    {
+        matched += d_string_internal_distance_group(peq,
+                                                    m,
+                                                    texts,
+                                                    lengths,
+                                                    slots,
+                                                    pending,
+                                                    _max,
+                                                    _distances);
+    }
+
+    return matched;
+}
+
+
+/******************************************************************************
+* Validation Functions
+******************************************************************************/
+
+/*
+d_string_is_valid
+  Check if d_string structure is valid.
+
+Parameter(s):
+  _str: d_string to check.
+Return:
+  true if valid, false otherwise.
+*/
+bool
+d_string_is_valid
+(
+    const struct d_string* _str
+)
+{
+    if (_str == NULL)
+    {
+        return false;
+    }
+
+    if (_str->text == NULL)
+    {
+        return false;
+    }
+
+    // verify null termination at reported size
+    if (_str->text[_str->size] != '\0')
+    {
+        return false;
+    }
+
+    return true;
+}
+
+/*
+d_string_is_ascii
+  Check if string contains only ASCII characters.
+
+Parameter(s):
+  _str: d_string to check.
+Return:
+  true if all ASCII, false otherwise.
+*/
+bool
+d_string_is_ascii
+(
+    const struct d_string* _str
+)
+{
+    if ( (_str == NULL) || 
+         (_str->text == NULL) )
+    {
+        return false;
+    }
+
+    return d_string_internal_is_ascii((const unsigned char*)_str->text,
+                                      _str->size);
+}
+
+/*
+d_string_is_numeric
+  Check if string contains only numeric characters.
+Characters are classified as in the "C" locale, independent of the
+current locale.
+
+Parameter(s):
+  _str: d_string to check.
+Return:
+  true if all numeric, false otherwise.
+*/
+bool
+d_string_is_numeric
+(
+    const struct d_string* _str
+)
+{
+    if ( (_str == NULL) || 
+         (_str->text == NULL) || 
+         (_str->size == 0) )
+    {
+        return false;
+    }
+
+    return d_string_internal_all_class((const unsigned char*)_str->text,
+                                       _str->size,
+                                       D_STRING_INTERNAL_CLASS_DIGIT);
+}
+
+/*
+d_string_is_alpha
+  Check if string contains only alphabetic characters.
+Characters are classified as in the "C" locale, independent of the
+current locale.
+
+Parameter(s):
+  _str: d_string to check.
+Return:
+  true if all alphabetic, false otherwise.
+*/
+bool
+d_string_is_alpha
+(
+    const struct d_string* _str
+)
+{
+    if ( (_str == NULL) || 
+         (_str->text == NULL) || 
+         (_str->size == 0) )
+    {
+        return false;
+    }
+
+    return d_string_internal_all_class((const unsigned char*)_str->text,
+                                       _str->size,
+                                       D_STRING_INTERNAL_CLASS_ALPHA);
+}
+
+/*
+d_string_is_alnum
+  Check if string contains only alphanumeric characters.
+Characters are classified as in the "C" locale, independent of the
+current locale.
+
+Parameter(s):
+  _str: d_string to check.
+Return:
+  true if all alphanumeric, false otherwise.
+*/
+bool
+d_string_is_alnum
+(
+    const struct d_string* _str
+)
+{
+    if ( (_str == NULL) || 
+         (_str->text == NULL) || 
+         (_str->size == 0) )
+    {
+        return false;
+    }
+
+    return d_string_internal_all_class((const unsigned char*)_str->text,
+                                       _str->size,
+                                       D_STRING_INTERNAL_CLASS_ALNUM);
+}
+
+/*
+d_string_is_whitespace
+  Check if string contains only whitespace characters.
+Characters are classified as in the "C" locale, independent of the
+current locale.
+
+Parameter(s):
+  _str: d_string to check.
+Return:
+  true if all whitespace, false otherwise.
+*/
+bool
+d_string_is_whitespace
+(
+    const struct d_string* _str
+)
+{
+    if ( (_str == NULL) || 
+         (_str->text == NULL) || 
+         (_str->size == 0) )
+    {
+        return false;
+    }
+
+    return d_string_internal_all_class((const unsigned char*)_str->text,
+                                       _str->size,
+                                       D_STRING_INTERNAL_CLASS_SPACE);
+}
+
+/*
+d_string_is_valid_utf8
+  Check if string is well-formed UTF-8: no overlong encodings, surrogates,
+code points above U+10FFFF, stray continuation bytes or truncated sequences.
+Suitable for validating untrusted input before processing it.
+
+Parameter(s):
+  _str: d_string to check.
+Return:
+  true if valid UTF-8 (including the empty string), false otherwise.
+*/
+bool
+d_string_is_valid_utf8
+(
+    const struct d_string* _str
+)
+{
+    if ( (_str == NULL) || 
+         (_str->text == NULL) )
+    {
+        return false;
+    }
+
+    return d_string_internal_utf8_valid((const unsigned char*)_str->text,
+                                        _str->size);
+}
+
+
+/******************************************************************************
+* Counting Functions
+******************************************************************************/
+
+/*
+d_string_count_char
+  Count occurrences of character in string.
+
+Parameter(s):
+  _str: d_string to search.
+  _c:   character to count.
+Return:
+  Number of occurrences.
+*/
+size_t
+d_string_count_char
+(
+    const struct d_string* _str,
+    char                   _c
+)
+{
+    if ( (_str == NULL) || 
+         (_str->text == NULL) )
+    {
+        return 0;
+    }
+
+    return d_string_internal_count((const unsigned char*)_str->text,
+                                   _str->size,
+                                   0xFF,
+                                   (unsigned char)_c);
+}
+
+/*
+d_string_utf8_length
+  Count the code points in a UTF-8 string, validating it first.
+
+Parameter(s):
+  _str: d_string to measure.
+Return:
+  Number of code points, or -1 if `_str` is NULL or not valid UTF-8.
+*/
+ssize_t
+d_string_utf8_length
+(
+    const struct d_string* _str
+)
+{
+    if ( (_str == NULL)       || 
+         (_str->text == NULL) ||
+         (!d_string_internal_utf8_valid((const unsigned char*)_str->text,
+                                        _str->size)) )
+    {
+        return -1;
+    }
+
+    // every code point has exactly one byte that is not a continuation
+    return (ssize_t)(_str->size -
+                     d_string_internal_count((const unsigned char*)_str->text,
+                                             _str->size,
+                                             0xC0,
+                                             0x80));
+}
+
+/*
+d_string_count_substr
+  Count occurrences of substring in string.
+
+Parameter(s):
+  _str:    d_string to search.
+  _substr: substring to count.
+Return:
+  Number of occurrences.
+*/
+size_t
+d_string_count_substr
+(
+    const struct d_string* _str,
+    const char*            _substr
+)
+{
+    size_t      count;
+    size_t      substr_len;
+    const char* search;
+    const char* found;
+    const char* end;
+
+    if ( (_str == NULL) || 
+         (_str->text == NULL) ||
+         (_substr == NULL) )
+    {
+        return 0;
+    }
+
+    substr_len = strlen(_substr);
+
+    if (substr_len == 0)
+    {
+        return 0;
+    }
+
+    count  = 0;
+    search = _str->text;
+    end    = _str->text + _str->size;
+
+    while ((found = d_string_internal_search(search,
+                                             (size_t)(end - search),
+                                             _substr,
+                                             substr_len)) != NULL)
+    {
+        count++;
+        search = found + substr_len;
+    }
+
+    return count;
+}
+
+
+/******************************************************************************
+* Hash Function
+******************************************************************************/
+
+// D_STRING_HASH_P0 .. D_STRING_HASH_P3
+//   constant: odd 64-bit multipliers with balanced bit patterns used to mix
+// input words (wyhash-style).
+#define D_STRING_HASH_P0 0x2d358dccaa6c78a5ULL
+#define D_STRING_HASH_P1 0x8bb84b93962eacc9ULL
+#define D_STRING_HASH_P2 0x4b33a62ed433d4a3ULL
+#define D_STRING_HASH_P3 0x4d5a2da51de1aa47ULL
+
+// d_string_hash_seed
+//   global: per-process hash seed; 0 until first use (see
+// d_string_internal_hash_seed).
+static d_atomic_ullong d_string_hash_seed;
+
+/*
+d_string_internal_mum
+  Full 64x64 -> 128-bit multiply, returning the low half in `*_a` and the
+high half in `*_b`.
+*/
+static D_INLINE void
+d_string_internal_mum
+(
+    uint64_t* _a,
+    uint64_t* _b
+)
+{
+#if defined(__SIZEOF_INT128__)
+    __uint128_t r;
+
+    r   = (__uint128_t)*_a * *_b;
+    *_a = (uint64_t)r;
+    *_b = (uint64_t)(r >> 64);
+#elif defined(_MSC_VER) && defined(_M_X64)
+    *_a = _umul128(*_a, *_b, _b);
+#else
+    uint64_t ha;
+    uint64_t hb;
+    uint64_t la;
+    uint64_t lb;
+    uint64_t rh;
+    uint64_t rm0;
+    uint64_t rm1;
+    uint64_t rl;
+    uint64_t t;
+    uint64_t lo;
+
+    ha  = *_a >> 32;
+    hb  = *_b >> 32;
+    la  = (uint32_t)*_a;
+    lb  = (uint32_t)*_b;
+    rh  = ha * hb;
+    rm0 = ha * lb;
+    rm1 = hb * la;
+    rl  = la * lb;
+    t   = rl + (rm0 << 32);
+    lo  = t + (rm1 << 32);
+
+    *_a = lo;
+    *_b = rh + (rm0 >> 32) + (rm1 >> 32) + (t < rl) + (lo < t);
+#endif
+
+    return;
+}
+
+/*
+d_string_internal_mix
+  Multiplies two words and folds the 128-bit product to 64 bits.
+*/
+static D_INLINE uint64_t
+d_string_internal_mix
+(
+    uint64_t _a,
+    uint64_t _b
+)
+{
+    d_string_internal_mum(&_a, &_b);
+
+    return _a ^ _b;
+}
+
+/*
+d_string_internal_read64
+  Reads 8 (possibly unaligned) bytes as a native-endian word.
+*/
+static D_INLINE uint64_t
+d_string_internal_read64
+(
+    const unsigned char* _p
+)
+{
+    uint64_t v;
+
+    memcpy(&v, _p, sizeof(v));
+
+    return v;
+}
+
+/*
+d_string_internal_read32
+  Reads 4 (possibly unaligned) bytes as a native-endian word.
+*/
+static D_INLINE uint64_t
+d_string_internal_read32
+(
+    const unsigned char* _p
+)
+{
+    uint32_t v;
+
+    memcpy(&v, _p, sizeof(v));
+
+    return v;
+}
+
+/*
+d_string_internal_hash_seed
+  Returns the per-process hash seed, establishing it on first use. The seed
+mixes the addresses of static, stack and code objects (randomized by ASLR)
+with the current time, so hash values differ between runs and cannot be
+precomputed for hash-flooding. The first thread to publish a seed wins;
+every thread observes the same value.
+*/
+static uint64_t
+d_string_internal_hash_seed
+(
+    void
+)
+{
+    unsigned long long seed;
+    unsigned long long expected;
+    int                local;
+
+    seed = d_atomic_load_ullong_explicit(&d_string_hash_seed,
+                                         D_MEMORY_ORDER_ACQUIRE);
+
+    if (seed != 0)
+    {
+        return seed;
+    }
+
+    seed = d_string_internal_mix(
+               (uint64_t)(uintptr_t)&d_string_hash_seed ^ D_STRING_HASH_P0,
+               (uint64_t)(uintptr_t)&local ^ D_STRING_HASH_P1);
+    seed = d_string_internal_mix(
+               seed ^ (uint64_t)time(NULL),
+               (uint64_t)clock() ^ (uint64_t)(uintptr_t)&d_string_hash ^
+               D_STRING_HASH_P2);
+    seed |= 1;  // 0 is reserved for "not yet seeded"
+
+    expected = 0;
+
+    if (!d_atomic_compare_exchange_strong_ullong(&d_string_hash_seed,
+                                                 &expected,
+                                                 seed))
+    {
+        // another thread published first
+        return expected;
+    }
+
+    return seed;
+}
+
+/*
+d_string_hash_bytes
+  Hashes an arbitrary byte range with a fast, seeded 64-bit hash in the
+wyhash family. Inputs are consumed 16 bytes per step, and 48 bytes per step
+(in three independent lanes) for long inputs. The seed is random per process,
+so hash values must not be persisted or compared across processes.
+
+Parameter(s):
+  _data: bytes to hash; may be NULL only if _size is 0.
+  _size: number of bytes to hash.
+Return:
+  64-bit hash value.
+*/
+uint64_t
+d_string_hash_bytes
+(
+    const void* _data,
+    size_t      _size
+)
+{
+    const unsigned char* p;
+    uint64_t             seed;
+    uint64_t             see1;
+    uint64_t             see2;
+    uint64_t             a;
+    uint64_t             b;
+    size_t               i;
+
+    p    = (const unsigned char*)_data;
+    seed = d_string_internal_hash_seed();
+    seed ^= d_string_internal_mix(seed ^ D_STRING_HASH_P0, D_STRING_HASH_P1);
+
+    if (_size <= 16)
+    {
+        if (_size >= 4)
+        {
+            a = (d_string_internal_read32(p) << 32) |
+                d_string_internal_read32(p + ((_size >> 3) << 2));
+            b = (d_string_internal_read32(p + _size - 4) << 32) |
+                d_string_internal_read32(p + _size - 4 - ((_size >> 3) << 2));
+        }
+        else if (_size > 0)
+        {
+            a = ((uint64_t)p[0] << 16) |
+                ((uint64_t)p[_size >> 1] << 8) |
+                p[_size - 1];
+            b = 0;
+        }
+        else
+        {
+            a = 0;
+            b = 0;
+        }
+    }
+    else
+    {
+        i = _size;
+
+        // three independent lanes keep the multipliers busy
+        if (i >= 48)
+        {
+            see1 = seed;
+            see2 = seed;
+
+            do
+            {
+                seed = d_string_internal_mix(
+                           d_string_internal_read64(p) ^ D_STRING_HASH_P1,
+                           d_string_internal_read64(p + 8) ^ seed);
+                see1 = d_string_internal_mix(
+                           d_string_internal_read64(p + 16) ^ D_STRING_HASH_P2,
+                           d_string_internal_read64(p + 24) ^ see1);
+                see2 = d_string_internal_mix(
+                           d_string_internal_read64(p + 32) ^ D_STRING_HASH_P3,
+                           d_string_internal_read64(p + 40) ^ see2);
+                p   += 48;
+                i   -= 48;
+            } while (i >= 48);
+
+            seed ^= see1 ^ see2;
+        }
+
+        while (i > 16)
+        {
+            seed = d_string_internal_mix(
+                       d_string_internal_read64(p) ^ D_STRING_HASH_P1,
+                       d_string_internal_read64(p + 8) ^ seed);
+            p   += 16;
+            i   -= 16;
+        }
+
+        // the final 16 bytes (overlapping earlier input if need be)
+        a = d_string_internal_read64(p + i - 16);
+        b = d_string_internal_read64(p + i - 8);
+    }
+
+    a ^= D_STRING_HASH_P1;
+    b ^= seed;
+    d_string_internal_mum(&a, &b);
+
+    return d_string_internal_mix(a ^ D_STRING_HASH_P0 ^ (uint64_t)_size,
+                                 b ^ D_STRING_HASH_P1);
+}
+
+/*
+d_string_hash
+  Calculate hash value for string (see d_string_hash_bytes). If the string
+carries a valid cached hash (see d_string_hash_cached), it is returned
+without rehashing.
+
+Parameter(s):
+  _str: d_string to hash.
+Return:
+  Hash value, or 0 if _str is NULL.
+*/
+size_t
+d_string_hash
+(
+    const struct d_string* _str
+)
+{
+    if ( (_str == NULL) || 
+         (_str->text == NULL) )
+    {
+        return 0;
+    }
+
+    if (_str->flags & D_STRING_FLAG_HASHED)
+    {
+        return _str->hash;
+    }
+
+    return (size_t)d_string_hash_bytes(_str->text, _str->size);
+}
+
+/*
+d_string_hash_cached
+  Calculate hash value for string, storing it in the string so that later
+calls to d_string_hash and d_string_hash_cached return it without rehashing.
+The cache is cleared by every d_string_* function that modifies the string.
+
+Parameter(s):
+  _str: d_string to hash.
+Return:
+  Hash value, or 0 if _str is NULL.
+*/
+size_t
+d_string_hash_cached
+(
+    struct d_string* _str
+)
+{
+    if ( (_str == NULL) || 
+         (_str->text == NULL) )
+    {
+        return 0;
+    }
+
+    if (!(_str->flags & D_STRING_FLAG_HASHED))
+    {
+        _str->hash   = (size_t)d_string_hash_bytes(_str->text, _str->size);
+        _str->flags |= D_STRING_FLAG_HASHED;
+    }
+
+    return _str->hash;
+}
+
+/*
+d_string_hash_invalidate
+  Discards a string's cached hash. Only needed after writing to the string's
+text directly; d_string_* functions invalidate the cache themselves.
+
+Parameter(s):
+  _str: d_string whose cached hash to discard.
+Return:
+  (none)
+*/
+void
+d_string_hash_invalidate
+(
+    struct d_string* _str
+)
+{
+    if (_str != NULL)
+    {
+        _str->flags &= ~D_STRING_FLAG_HASHED;
+    }
+
+    return;
+}
+
+/*
+d_string_view_hash
+  Calculate hash value for a view. Equal to d_string_hash of a d_string
+holding the same characters.
+
+Parameter(s):
+  _view: view to hash.
+Return:
+  Hash value.
+*/
+size_t
+d_string_view_hash
+(
+    struct d_string_view _view
+)
+{
+    return (size_t)d_string_hash_bytes(_view.text, _view.size);
+}
+
+/*
+d_string_hash_set_seed
+  Sets the per-process hash seed, e.g. from a CSPRNG or to a fixed value for
+reproducible runs. Only possible before the first hash is computed, since
+changing the seed afterwards would invalidate every hash already in use.
+
+Parameter(s):
+  _seed: seed value; 0 is remapped to a fixed non-zero value.
+Return:
+  A boolean value corresponding to either:
+  - true, if the seed was installed, or
+  - false, if a seed was already established.
+*/
+bool
+d_string_hash_set_seed
+(
+    uint64_t _seed
+)
+{
+    unsigned long long expected;
+
+    if (_seed == 0)
+    {
+        _seed = D_STRING_HASH_P3;
+    }
+
+    expected = 0;
+
+    return d_atomic_compare_exchange_strong_ullong(&d_string_hash_seed,
+                                                   &expected,
+                                                   (unsigned long long)_seed);
+}
+
+
+/******************************************************************************
+* Internal Numeric Conversion Engine
+******************************************************************************/
+
+// D_STRING_INTERNAL_DTOA_MAX
+//   constant: size of a buffer large enough for any double written by
+// d_string_internal_dtoa ("-1.2345678901234567e-308" and the like).
+#define D_STRING_INTERNAL_DTOA_MAX 32
+
+// D_STRING_INTERNAL_DEC_DIGITS
+//   constant: number of significant digits the exact (slow) double parser
+// keeps. Any input that decides a rounding needs at most 768; further
+// digits only record whether something nonzero was dropped.
+#define D_STRING_INTERNAL_DEC_DIGITS 800
+
+// D_STRING_INTERNAL_DEC_SHIFT
+//   constant: largest binary shift the decimal can apply in one pass without
+// overflowing its 64-bit carry.
+#define D_STRING_INTERNAL_DEC_SHIFT 60
+
+// d_string_internal_decimal
+//   struct: exact decimal value 0.d[0]d[1]...d[nd-1] x 10^dp, each d[i] a
+// digit value 0-9. Used to round inputs the fast path cannot handle.
+struct d_string_internal_decimal
+{
+    uint8_t d[D_STRING_INTERNAL_DEC_DIGITS];
+    int     nd;     // number of digits in d
+    int     dp;     // position of the decimal point
+    bool    trunc;  // nonzero digits were dropped past d[nd - 1]
+};
+
+// d_string_internal_pow10
+//   constant: the powers of ten exactly representable as doubles.
+static const double d_string_internal_pow10[23] =
+{
+    1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,
+    1e8,  1e9,  1e10, 1e11, 1e12, 1e13, 1e14, 1e15,
+    1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+};
+
+// d_string_internal_pow5_inv
+//   constant: floor(2^(bitlength(5^i) - 1 + 125) / 5^i) + 1 for i = 0..341,
+// as { low, high } 64-bit halves. Scales binary exponents >= 0 in
+// d_string_internal_shortest (Ryu).
+static const uint64_t d_string_internal_pow5_inv[342][2] =
+{
+    { 0x0000000000000001u, 0x2000000000000000u }, { 0x999999999999999au, 0x1999999999999999u },
+    { 0x47ae147ae147ae15u, 0x147ae147ae147ae1u }, { 0x6c8b4395810624deu, 0x10624dd2f1a9fbe7u },
+    { 0x7a786c226809d496u, 0x1a36e2eb1c432ca5u }, { 0x61f9f01b866e43abu, 0x14f8b588e368f084u },
+    { 0xb4c7f34938583622u, 0x10c6f7a0b5ed8d36u }, { 0x87a6520ec08d236au, 0x1ad7f29abcaf4857u },
+    { 0x9fb841a566d74f88u, 0x15798ee2308c39dfu }, { 0xe62d01511f12a607u, 0x112e0be826d694b2u },
+    { 0xd6ae6881cb5109a4u, 0x1b7cdfd9d7bdbab7u }, { 0xdef1ed34a2a73aeau, 0x15fd7fe17964955fu },
+    { 0x7f27f0f6e885c8bbu, 0x119799812dea1119u }, { 0x650cb4be40d60df8u, 0x1c25c268497681c2u },
+    { 0xea70909833de7193u, 0x16849b86a12b9b01u }, { 0x21f3a6e0297ec143u, 0x1203af9ee756159bu },
+    { 0x6985d7cd0f313537u, 0x1cd2b297d889bc2bu }, { 0x2137dfd73f5a90f9u, 0x170ef54646d49689u },
+    { 0xe75fe645cc4873fau, 0x12725dd1d243aba0u }, { 0xa5663d3c7a0d865du, 0x1d83c94fb6d2ac34u },
+    { 0x511e976394d79eb1u, 0x179ca10c9242235du }, { 0xda7edf82dd794bc1u, 0x12e3b40a0e9b4f7du },
+    { 0x2a6498d1625bac68u, 0x1e392010175ee596u }, { 0xeeb6e0a781e2f053u, 0x182db34012b25144u },
+    { 0x58924d52ce4f26a9u, 0x1357c299a88ea76au }, { 0x27507bb7b07ea441u, 0x1ef2d0f5da7dd8aau },
+    { 0x52a6c95fc0655034u, 0x18c240c4aecb13bbu }, { 0x0eebd44c99eaa690u, 0x13ce9a36f23c0fc9u },
+    { 0xb17953adc3110a80u, 0x1fb0f6be50601941u }, { 0xc12ddc8b02740867u, 0x195a5efea6b34767u },
+    { 0x3424b06f3529a052u, 0x14484bfeebc29f86u }, { 0x901d59f290ee19dbu, 0x1039d66589687f9eu },
+    { 0x4cfbc31db4b0295fu, 0x19f623d5a8a73297u }, { 0x3d9635b15d59bab2u, 0x14c4e977ba1f5bacu },
+    { 0x97ab5e277de16228u, 0x109d8792fb4c4956u }, { 0xf2abc9d8c9689d0du, 0x1a95a5b7f87a0ef0u },
+    { 0x5bbca17a3aba173eu, 0x154484932d2e725au }, { 0xafca1ac82efb45cbu, 0x11039d428a8b8eaeu },
+    { 0xb2dcf7a6b1920945u, 0x1b38fb9daa78e44au }, { 0xf57d92ebc141a104u, 0x15c72fb1552d836eu },
+    { 0xc46475896767b403u, 0x116c262777579c58u }, { 0x6d6d88dbd8a5ecd2u, 0x1be03d0bf225c6f4u },
+    { 0x8abe071646eb23dbu, 0x164cfda3281e38c3u }, { 0x6efe6c11d255b649u, 0x11d7314f534b609cu },
+    { 0xb197134fb6ef8a0eu, 0x1c8b821885456760u }, { 0x27ac0f72f8bfa1a5u, 0x16d601ad376ab91au },
+    { 0xb95672c260994e1eu, 0x1244ce242c5560e1u }, { 0xf5571e03cdc21695u, 0x1d3ae36d13bbce35u },
+    { 0x2aac18030b01ababu, 0x17624f8a762fd82bu }, { 0xbbbce0026f348956u, 0x12b50c6ec4f31355u },
+    { 0x92c7ccd0b1eda889u, 0x1dee7a4ad4b81eefu }, { 0xdbd30a408e57ba07u, 0x17f1fb6f10934bf2u },
+    { 0x7ca8d50071dfc806u, 0x1327fc58da0f6ff5u }, { 0xfaa7bb33e9660cd6u, 0x1ea6608e29b24cbbu },
+    { 0x9552fc298784d711u, 0x18851a0b548ea3c9u }, { 0xaaa8c9bad2d0ac0eu, 0x139dae6f76d88307u },
+    { 0xdddadc5e1e1aace3u, 0x1f62b0b257c0d1a5u }, { 0x7e48b04b4b488a4fu, 0x191bc08eac9a4151u },
+    { 0xcb6d59d5d5d3a1d9u, 0x141633a556e1cddau }, { 0x3c577b1177dc817bu, 0x1011c2eaabe7d7e2u },
+    { 0xc6f25e825960cf2au, 0x19b604aaaca62636u }, { 0x6bf518684780a5bbu, 0x14919d5556eb51c5u },
+    { 0x232a79ed06008496u, 0x10747ddddf22a7d1u }, { 0xd1dd8fe1a3340756u, 0x1a53fc9631d10c81u },
+    { 0xa7e4731ae8f66c45u, 0x150ffd44f4a73d34u }, { 0x531d28e253f8569eu, 0x10d9976a5d52975du },
+    { 0xeb61db03b98d5762u, 0x1af5bf109550f22eu }, { 0xbc4e48cfc7a445e8u, 0x159165a6ddda5b58u },
+    { 0x6371d3d96c836b20u, 0x11411e1f17e1e2adu }, { 0x9f1c8628ad9f11cdu, 0x1b9b6364f3030448u },
+    { 0xe5b06b53be18db0bu, 0x1615e91d8f359d06u }, { 0xeaf3890fcb4715a2u, 0x11ab20e472914a6bu },
+    { 0x44b8db4c7871bc37u, 0x1c45016d841baa46u }, { 0x03c715d6c6c1635fu, 0x169d9abe03495505u },
+    { 0x3638de456bcde919u, 0x1217aefe69077737u }, { 0x56c163a2461641c1u, 0x1cf2b1970e725858u },
+    { 0xdf011c81d1ab67ceu, 0x17288e1271f51379u }, { 0x7f3416ce4155eca5u, 0x1286d80ec190dc61u },
+    { 0x6520247d3556476eu, 0x1da48ce468e7c702u }, { 0xea801d30f7783925u, 0x17b6d71d20b96c01u },
+    { 0xbb99b0f3f92cfa84u, 0x12f8ac174d612334u }, { 0x5f5c4e532847f739u, 0x1e5aacf215683854u },
+    { 0x7f7d0b75b9d32c2eu, 0x18488a5b44536043u }, { 0x9930d5f7c7dc2358u, 0x136d3b7c36a919cfu },
+    { 0x8eb4898c72f9d226u, 0x1f152bf9f10e8fb2u }, { 0x722a07a38f2e41b8u, 0x18ddbcc7f40ba628u },
+    { 0xc1bb394fa5be9afau, 0x13e497065cd61e86u }, { 0x9c5ec2190930f7f6u, 0x1fd424d6faf030d7u },
+    { 0x49e56814075a5ff8u, 0x197683df2f268d79u }, { 0x6e51201005e1e660u, 0x145ecfe5bf520ac7u },
+    { 0xf1da800cd181851au, 0x104bd984990e6f05u }, { 0x4fc400148268d4f5u, 0x1a12f5a0f4e3e4d6u },
+    { 0xd96999aa01ed772bu, 0x14dbf7b3f71cb711u }, { 0xadee1488018ac5bcu, 0x10aff95cc5b09274u },
+    { 0x497ceda668de092cu, 0x1ab328946f80ea54u }, { 0x3aca57b853e4d424u, 0x155c2076bf9a5510u },
+    { 0x623b7960431d7683u, 0x1116805effaeaa73u }, { 0x9d2bf566d1c8bd9eu, 0x1b5733cb32b110b8u },
+    { 0x7dbcc452416d647fu, 0x15df5ca28ef40d60u }, { 0xcafd69db678ab6ccu, 0x117f7d4ed8c33de6u },
+    { 0xab2f0fc572778adfu, 0x1bff2ee48e052fd7u }, { 0x88f273045b92d580u, 0x1665bf1d3e6a8cacu },
+    { 0xd3f528d049424466u, 0x11eaff4a98553d56u }, { 0xb988414d4203a0a3u, 0x1cab3210f3bb9557u },
+    { 0x6139cdd76802e6e9u, 0x16ef5b40c2fc7779u }, { 0xe761717920025254u, 0x125915cd68c9f92du },
+    { 0xa568b58e999d5086u, 0x1d5b561574765b7cu }, { 0x5120913ee14aa6d2u, 0x177c44ddf6c515fdu },
+    { 0xa74d40ff1aa21f0eu, 0x12c9d0b1923744cau }, { 0x0baece64f769cb4au, 0x1e0fb44f50586e11u },
+    { 0x3c8bd850c5ee3c3bu, 0x180c903f7379f1a7u }, { 0xca0979da37f1c9c9u, 0x133d4032c2c7f485u },
+    { 0xa9a8c2f6bfe942dbu, 0x1ec866b79e0cba6fu }, { 0x2153cf2bccba9be3u, 0x18a0522c7e709526u },
+    { 0x1aa9728970954982u, 0x13b374f06526ddb8u }, { 0xf775840f1a88759du, 0x1f8587e7083e2f8cu },
+    { 0x5f9136727ba05e17u, 0x19379fec0698260au }, { 0x1940f85b9619e4dfu, 0x142c7ff0054684d5u },
+    { 0xe100c6afab47ea4cu, 0x1023998cd1053710u }, { 0xce67a44c453fdd47u, 0x19d28f47b4d524e7u },
+    { 0xd852e9d69dccb106u, 0x14a8729fc3ddb71fu }, { 0x79dbee454b0a2738u, 0x1086c219697e2c19u },
+    { 0x295fe3a211a9d859u, 0x1a71368f0f30468fu }, { 0xbab31c81a7bb137au, 0x15275ed8d8f36ba5u },
+    { 0x6228e39aec95a92fu, 0x10ec4be0ad8f8951u }, { 0x9d0e38f7e0ef7517u, 0x1b13ac9aaf4c0ee8u },
+    { 0xb0d82d931a592a79u, 0x15a956e225d67253u }, { 0x8d79be0f4847552eu, 0x11544581b7dec1dcu },
+    { 0x158f967eda0bbb7cu, 0x1bba08cf8c979c94u }, { 0x77a611ff14d62f97u, 0x162e6d72d6dfb076u },
+    { 0xf951a7ff43de8c79u, 0x11bebdf578b2f391u }, { 0xc21c3ffed2fdad8eu, 0x1c6463225ab7ec1cu },
+    { 0x01b0333242648ad8u, 0x16b6b5b5155ff017u }, { 0x0159c28e9b83a246u, 0x122bc490dde659acu },
+    { 0xcef604175f3903a3u, 0x1d12d41afca3c2acu }, { 0x725e69ac4c2d9c83u, 0x17424348ca1c9bbdu },
+    { 0xf5185489d68ae39cu, 0x129b69070816e2fdu }, { 0xee8d540fbdab05c6u, 0x1dc574d80cf16b2fu },
+    { 0xbed77672fe226b05u, 0x17d12a4670c1228cu }, { 0xff12c528cb4ebc04u, 0x130dbb6b8d674ed6u },
+    { 0xcb513b74787df9a0u, 0x1e7c5f127bd87e24u }, { 0x090dc929f9fe614du, 0x18637f41fcad31b7u },
+    { 0xa0d7d42194cb810au, 0x1382cc34ca2427c5u }, { 0x67bfb9cf5478ce77u, 0x1f37ad21436d0c6fu },
+    { 0x1fcc94a5dd2d71f9u, 0x18f9574dcf8a7059u }, { 0x7fd6dd517dbdf4c7u, 0x13faac3e3fa1f37au },
+    { 0xffbe2ee8c92fee0bu, 0x1ff779fd329cb8c3u }, { 0x6631bf20a0f324d6u, 0x1992c7fdc216fa36u },
+    { 0xb827cc1a1a5c1d78u, 0x14756ccb01abfb5eu }, { 0x935309ae7b7ce460u, 0x105df0a267bcc918u },
+    { 0x1eeb42b0c594a099u, 0x1a2fe76a3f9474f4u }, { 0xe58902270476e6e1u, 0x14f31f8832dd2a5cu },
+    { 0xb7a0ce859d2bebe7u, 0x10c27fa028b0eeb0u }, { 0x59014a6f61dfdfd8u, 0x1ad0cc33744e4ab4u },
+    { 0xe0cdd525e7e64cadu, 0x1573d68f903ea229u }, { 0x4d7177518651d6f1u, 0x11297872d9cbb4eeu },
+    { 0x7be8bee8d6e957e8u, 0x1b758d848fac54b0u }, { 0xfcba3253df211320u, 0x15f7a46a0c89dd59u },
+    { 0x63c8284318e74280u, 0x1192e9ee706e4aaeu }, { 0x060d0d3827d86a66u, 0x1c1e43171a4a1117u },
+    { 0x6b3da42cecad21ebu, 0x167e9c127b6e7412u }, { 0x88fe1cf0bd574e56u, 0x11fee341fc585cdbu },
+    { 0x419694b462254a23u, 0x1ccb0536608d615fu }, { 0x67abaa29e81dd4e9u, 0x1708d0f84d3de77fu },
+    { 0xb95621bb2017dd87u, 0x126d73f9d764b932u }, { 0xc223692b668c95a5u, 0x1d7becc2f23ac1eau },
+    { 0xce82ba891ed6de1du, 0x179657025b6234bbu }, { 0xa53562074bdf1818u, 0x12deac01e2b4f6fcu },
+    { 0x3b889cd87964f359u, 0x1e3113363787f194u }, { 0xfc6d4a46c783f5e1u, 0x18274291c6065adcu },
+    { 0x30576e9f06032b1au, 0x13529ba7d19eaf17u }, { 0x1a257dcb3cd1de90u, 0x1eea92a61c311825u },
+    { 0x481dfe3c30a7e540u, 0x18bba884e35a79b7u }, { 0xd34b31c9c0865100u, 0x13c9539d82aec7c5u },
+    { 0x5211e942cda3b4cdu, 0x1fa885c8d117a609u }, { 0x74db21023e1c90a4u, 0x19539e3a40dfb807u },
+    { 0xf715b401cb4a0d50u, 0x1442e4fb67196005u }, { 0xf8de299b09080aa7u, 0x103583fc527ab337u },
+    { 0x8e304291a80cddd7u, 0x19ef3993b72ab859u }, { 0x3e8d020e200a4b13u, 0x14bf6142f8eef9e1u },
+    { 0x653d9b3e80083c0fu, 0x10991a9bfa58c7e7u }, { 0x6ec8f864000d2ce4u, 0x1a8e90f9908e0ca5u },
+    { 0x8bd3f9e999a423eau, 0x153eda614071a3b7u }, { 0x3ca994bae1501cbbu, 0x10ff151a99f482f9u },
+    { 0xc775bac49bb3612bu, 0x1b31bb5dc320d18eu }, { 0xd2c4956a16291a89u, 0x15c162b168e70e0bu },
+    { 0xdbd0778811ba7ba1u, 0x11678227871f3e6fu }, { 0x2c80bf401c5d929bu, 0x1bd8d03f3e9863e6u },
+    { 0xbd33cc3349e47549u, 0x16470cff6546b651u }, { 0xca8fd68f6e505dd4u, 0x11d270cc51055ea7u },
+    { 0x4419574be3b3c953u, 0x1c83e7ad4e6efdd9u }, { 0x0347790982f63aa9u, 0x16cfec8aa52597e1u },
+    { 0xcf6c60d468c4fbbau, 0x123ff06eea847980u }, { 0xe57a34870e07f92au, 0x1d331a4b10d3f59au },
+    { 0x512e906c0b399422u, 0x175c1508da432ae2u }, { 0xda8ba6bcd5c7a9b5u, 0x12b010d3e1cf5581u },
+    { 0x90df712e22d90f87u, 0x1de6815302e5559cu }, { 0xda4c5a8b4f140c6cu, 0x17eb9aa8cf1dde16u },
+    { 0xaea37ba2a5a9a38au, 0x1322e220a5b17e78u }, { 0x7dd25f6aa2a905a9u, 0x1e9e369aa2b59727u },
+    { 0x97db7f888220d154u, 0x187e92154ef7ac1fu }, { 0x797c6606ce80a777u, 0x139874ddd8c6234cu },
+    { 0x8f2d700ae4010bf1u, 0x1f5a549627a36badu }, { 0x0c2459a25000d65au, 0x191510781fb5efbeu },
+    { 0x701d1481d99a4515u, 0x1410d9f9b2f7f2feu }, { 0xc017439b147b6a77u, 0x100d7b2e28c65bfeu },
+    { 0xccf205c4ed9243f2u, 0x19af2b7d0e0a2ccau }, { 0x0a5b37d0be0e9cc2u, 0x148c22ca71a1bd6fu },
+    { 0x0848f973cb3ee3ceu, 0x10701bd527b4978cu }, { 0xda0e5bec78649fb0u, 0x1a4cf9550c5425acu },
+    { 0x7b3eaff060507fc0u, 0x150a6110d6a9b7bdu }, { 0x95cbbff380406633u, 0x10d51a73deee2c97u },
+    { 0xefac665266cd7052u, 0x1aee90b964b04758u }, { 0x2623850eb8a459dbu, 0x158ba6fab6f36c47u },
+    { 0x1e82d0d893b6ae49u, 0x113c85955f29236cu }, { 0xfd9e1af41f8ab075u, 0x1b9408eefea838acu },
+    { 0x97b1af29b2d559f7u, 0x16100725988693bdu }, { 0xac8e25baf5777b2cu, 0x11a66c1e139edc97u },
+    { 0x7a7d092b2258c513u, 0x1c3d79c9b8fe2dbfu }, { 0x61fda0ef4ead6a76u, 0x169794a160cb57ccu },
+    { 0xe7fe1a590bbdeec5u, 0x1212dd4de7091309u }, { 0xa6635d5b45fcb13au, 0x1ceafbafd80e84dcu },
+    { 0x851c4aaf6b308dc8u, 0x172262f3133ed0b0u }, { 0xd0e36ef2bc26d7d4u, 0x1281e8c275cbda26u },
+    { 0xb49f17eac6a48c86u, 0x1d9ca79d894629d7u }, { 0x2a18dfef0550706bu, 0x17b08617a104ee46u },
+    { 0x54e0b3259dd9f389u, 0x12f39e794d9d8b6bu }, { 0x87cdeb6f62f65274u, 0x1e5297287c2f4578u },
+    { 0xd30b22bf825ea85du, 0x18421286c9bf6ac6u }, { 0x0f3c1bcc684bb9e4u, 0x13680ed23aff889fu },
+    { 0x18602c7a4079296du, 0x1f0ce4839198da98u }, { 0x46b356c833942124u, 0x18d71d360e13e213u },
+    { 0x388f78a029434db6u, 0x13df4a91a4dcb4dcu }, { 0x5a7f2766a86baf8au, 0x1fcbaa82a1612160u },
+    { 0x153285ebb9efbfa2u, 0x196fbb9bb44db44du }, { 0xaa8ed189618c994eu, 0x145962e2f6a4903du },
+    { 0xeed8a7a11ad6e10cu, 0x1047824f2bb6d9cau }, { 0x7e27729b5e249b45u, 0x1a0c03b1df8af611u },
+    { 0xfe85f549181d4904u, 0x14d6695b193bf80du }, { 0xcb9e5dd4134aa0d0u, 0x10ab877c142ff9a4u },
+    { 0xdf63c9535211014du, 0x1aac0bf9b9e65c3au }, { 0x191ca10f74da6771u, 0x15566ffafb1eb02fu },
+    { 0xadb080d92a4852c1u, 0x1111f32f2f4bc025u }, { 0x15e7348eaa0d5134u, 0x1b4feb7eb212cd09u },
+    { 0xab1f5d3eee710dc4u, 0x15d98932280f0a6du }, { 0xbc1917658b8da49du, 0x117ad428200c0857u },
+    { 0x2cf4f23c127c3a94u, 0x1bf7b9d9cce00d59u }, { 0xf0c3f4fcdb969543u, 0x165fc7e170b33de0u },
+    { 0x5a365d9716121103u, 0x11e6398126f5cb1au }, { 0x9056fc24f01ce804u, 0x1ca38f350b22de90u },
+    { 0xd9df301d8ce3ecd0u, 0x16e93f5da2824ba6u }, { 0xe17f59b13d8323dau, 0x125432b14ecea2ebu },
+    { 0x68cbc2b52f38395cu, 0x1d53844ee47dd179u }, { 0x53d6355dbf602de3u, 0x177603725064a794u },
+    { 0xa9782ab165e68b1cu, 0x12c4cf8ea6b6ec76u }, { 0x0f26aab56fd744fau, 0x1e07b27dd78b13f1u },
+    { 0x3f52222abfdf6a62u, 0x18062864ac6f4327u }, { 0x65db4e88997f884eu, 0x1338205089f29c1fu },
+    { 0x6fc54a7428cc0d4au, 0x1ec033b40fea9365u }, { 0x596aa1f68709a43bu, 0x1899c2f673220f84u },
+    { 0xadeee7f86c07b696u, 0x13ae3591f5b4d936u }, { 0x497e3ff3e00c5756u, 0x1f7d228322baf524u },
+    { 0xd464fff64cd6ac45u, 0x1930e868e89590e9u }, { 0x4383fff83d7889d1u, 0x14272053ed4473eeu },
+    { 0xcf9cccc69793a174u, 0x101f4d0ff1038ff1u }, { 0x7f6147a425b90252u, 0x19cbae7fe805b31cu },
+    { 0xcc4dd2e9b7c7350fu, 0x14a2f1ffecd15c16u }, { 0x3d0b0f215fd290d9u, 0x10825b3323dab012u },
+    { 0x61ab4b689950e7c1u, 0x1a6a2b85062ab350u }, { 0x4e22a2ba1440b967u, 0x1521bc6a6b555c40u },
+    { 0x0b4ee894dd009453u, 0x10e7c9eebc4449cdu }, { 0x1217da87c800ed51u, 0x1b0c764ac6d3a948u },
+    { 0xdb46486ca000bddau, 0x15a391d56bdc876cu }, { 0x490506bd4ccd64afu, 0x114fa7ddefe39f8au },
+    { 0xa8080ac87ae23ab1u, 0x1bb2a62fe638ff43u }, { 0x5339a239fbe82ef4u, 0x162884f31e93ff69u },
+    { 0x75c7b4fb2fecf25du, 0x11ba03f5b20fff87u }, { 0x22d92191e647ea2eu, 0x1c5cd322b67fff3fu },
+    { 0xb57a8141850654f2u, 0x16b0a8e891ffff65u }, { 0xc4620101373843f5u, 0x1226ed86db3332b7u },
+    { 0x3a366801f1f39feeu, 0x1d0b15a491eb8459u }, { 0xfb5eb99b27f6198bu, 0x173c115074bc69e0u },
+    { 0x2f7efae2865e7ad6u, 0x129674405d6387e7u }, { 0xe597f7d0d6fd9156u, 0x1dbd86cd6238d971u },
+    { 0x8479930d78cadaabu, 0x17cad23de82d7ac1u }, { 0xd06142712d6f1556u, 0x1308a831868ac89au },
+    { 0x4d686a4eaf182222u, 0x1e74404f3daada91u }, { 0xa453883ef279b4e8u, 0x185d003f6488aedau },
+    { 0xe9dc6cff28615d87u, 0x137d99cc506d58aeu }, { 0xa960ae650d6895a4u, 0x1f2f5c7a1a488de4u },
+    { 0xbab3beb73ded4483u, 0x18f2b061aea07183u }, { 0x2ef6322c318a9d36u, 0x13f559e7bee6c136u },
+    { 0xe4bd1d13827761f0u, 0x1feef63f97d79b89u }, { 0x83ca7da9352c4e5au, 0x198bf832dfdfafa1u },
+    { 0x9ca1fe20f756a515u, 0x146ff9c24cb2f2e7u }, { 0x4a1b31b3f9121daau, 0x1059949b708f28b9u },
+    { 0x435eb5ecc1b695ddu, 0x1a28edc580e50df5u }, { 0x35e55e57015ede4au, 0x14ed8b04671da4c4u },
+    { 0xc4b77eac0118b1d5u, 0x10be08d0527e1d69u }, { 0xa12597799b5ab622u, 0x1ac9a7b3b7302f0fu },
+    { 0x4db7ac6149155e81u, 0x156e1fc2f8f358d9u }, { 0xd7c6238107444b9bu, 0x1124e63593f5e0adu },
+    { 0x593d059b3ed3ac2bu, 0x1b6e3d2286563449u }, { 0xe0fd9e15cbdc89bcu, 0x15f1ca820511c36du },
+    { 0xb3fe18116fe3a163u, 0x118e3b9b37416924u }, { 0x866359b57fd29bd1u, 0x1c16c5c525357507u },
+    { 0xd1e91491330ee30eu, 0x16789e3750f790d2u }, { 0x74ba76da8f3f1c0bu, 0x11fa182c40c60d75u },
+    { 0xedf72490e531c678u, 0x1cc359e067a348bbu }, { 0x8b2c1d40b75b052du, 0x1702ae4d1fb5d3c9u },
+    { 0x6f567dcd5f7c0424u, 0x12688b70e62b0fd4u }, { 0x7ef0c94898c66d06u, 0x1d74124e3d11b2edu },
+    { 0x98c0a106e09ebd9fu, 0x17900ea4fda7c257u }, { 0x470080d24d4bcae6u, 0x12d9a550caec9b79u },
+    { 0xd800ce1d487944a2u, 0x1e29088144adc58eu }, { 0x1333d8176d2dd082u, 0x1820d39a9d57d13fu },
+    { 0xa8f646792424a6ceu, 0x134d76154aaca765u }, { 0x74bd3d8ea03aa47du, 0x1ee25688777aa56fu },
+    { 0x5d64313ee6955064u, 0x18b51206c5fbb78cu }, { 0x4ab68dcbebaaa6b7u, 0x13c40e6bd1962c70u },
+    { 0x1124161312aaa457u, 0x1fa01712e8f0471au }, { 0xda8344dc0eeee9dfu, 0x194cdf4253f36c14u },
+    { 0xe2029d7cd8bf2180u, 0x143d7f6843292343u }, { 0x4e687dfd7a328133u, 0x103132b9cf541c36u },
+    { 0x4a40c9959050ceb8u, 0x19e851294bb9c6bdu }, { 0x0833d477a6a70bc6u, 0x14b9da876fc7d231u },
+    { 0xa02976c61eec096bu, 0x1094aed2bfd30e8du }, { 0x004257a364acdbdfu, 0x1a877e1dffb81749u },
+    { 0xcd01dfb5ea23e319u, 0x153931b1996012a0u }, { 0x70ce4c91881cb5aeu, 0x10fa8e27ade6754du },
+    { 0x1ae3adb5a69455e2u, 0x1b2a7d0c4970bbafu }, { 0x7be957c4854377e8u, 0x15bb973d078d62f2u },
+    { 0xc987796a0435f987u, 0x1162df64060ab58eu }, { 0x75a58f1006bcc271u, 0x1bd1656cd67788e4u },
+    { 0xf7b7a5a66bca3527u, 0x16411df0ab92d3e9u }, { 0x5fc61e1ebca1c41fu, 0x11cdb18d560f0feeu },
+    { 0xffa363646102d365u, 0x1c7c4f4889b1b316u }, { 0x32e91c504d9bdc51u, 0x16c9d906d48e28dfu },
+    { 0x8f20e37371497d0eu, 0x123b140576d820b2u }, { 0x7e9b0585820f2e7cu, 0x1d2b533bf159cdeau },
+    { 0xcbaf379e01a5becau, 0x1755dc2ff447d7eeu }, { 0x0958f94b348498a1u, 0x12ab168cc36cacbfu }
+};
+
+// d_string_internal_pow5
+//   constant: the leading 125 bits of 5^i for i = 0..325, as { low, high }
+// 64-bit halves. Scales binary exponents < 0 in d_string_internal_shortest.
+static const uint64_t d_string_internal_pow5[326][2] =
+{
+    { 0x0000000000000000u, 0x1000000000000000u }, { 0x0000000000000000u, 0x1400000000000000u },
+    { 0x0000000000000000u, 0x1900000000000000u }, { 0x0000000000000000u, 0x1f40000000000000u },
+    { 0x0000000000000000u, 0x1388000000000000u }, { 0x0000000000000000u, 0x186a000000000000u },
+    { 0x0000000000000000u, 0x1e84800000000000u }, { 0x0000000000000000u, 0x1312d00000000000u },
+    { 0x0000000000000000u, 0x17d7840000000000u }, { 0x0000000000000000u, 0x1dcd650000000000u },
+    { 0x0000000000000000u, 0x12a05f2000000000u }, { 0x0000000000000000u, 0x174876e800000000u },
+    { 0x0000000000000000u, 0x1d1a94a200000000u }, { 0x0000000000000000u, 0x12309ce540000000u },
+    { 0x0000000000000000u, 0x16bcc41e90000000u }, { 0x0000000000000000u, 0x1c6bf52634000000u },
+    { 0x0000000000000000u, 0x11c37937e0800000u }, { 0x0000000000000000u, 0x16345785d8a00000u },
+    { 0x0000000000000000u, 0x1bc16d674ec80000u }, { 0x0000000000000000u, 0x1158e460913d0000u },
+    { 0x0000000000000000u, 0x15af1d78b58c4000u }, { 0x0000000000000000u, 0x1b1ae4d6e2ef5000u },
+    { 0x0000000000000000u, 0x10f0cf064dd59200u }, { 0x0000000000000000u, 0x152d02c7e14af680u },
+    { 0x0000000000000000u, 0x1a784379d99db420u }, { 0x0000000000000000u, 0x108b2a2c28029094u },
+    { 0x0000000000000000u, 0x14adf4b7320334b9u }, { 0x4000000000000000u, 0x19d971e4fe8401e7u },
+    { 0x8800000000000000u, 0x1027e72f1f128130u }, { 0xaa00000000000000u, 0x1431e0fae6d7217cu },
+    { 0xd480000000000000u, 0x193e5939a08ce9dbu }, { 0xc9a0000000000000u, 0x1f8def8808b02452u },
+    { 0xbe04000000000000u, 0x13b8b5b5056e16b3u }, { 0xad85000000000000u, 0x18a6e32246c99c60u },
+    { 0xd8e6400000000000u, 0x1ed09bead87c0378u }, { 0x878fe80000000000u, 0x13426172c74d822bu },
+    { 0x6973e20000000000u, 0x1812f9cf7920e2b6u }, { 0x03d0da8000000000u, 0x1e17b84357691b64u },
+    { 0x8262889000000000u, 0x12ced32a16a1b11eu }, { 0x22fb2ab400000000u, 0x178287f49c4a1d66u },
+    { 0xabb9f56100000000u, 0x1d6329f1c35ca4bfu }, { 0xcb54395ca0000000u, 0x125dfa371a19e6f7u },
+    { 0xbe2947b3c8000000u, 0x16f578c4e0a060b5u }, { 0x2db399a0ba000000u, 0x1cb2d6f618c878e3u },
+    { 0xfc90400474400000u, 0x11efc659cf7d4b8du }, { 0x7bb4500591500000u, 0x166bb7f0435c9e71u },
+    { 0xdaa16406f5a40000u, 0x1c06a5ec5433c60du }, { 0xa8a4de8459868000u, 0x118427b3b4a05bc8u },
+    { 0xd2ce16256fe82000u, 0x15e531a0a1c872bau }, { 0x87819baecbe22800u, 0x1b5e7e08ca3a8f69u },
+    { 0xf4b1014d3f6d5900u, 0x111b0ec57e6499a1u }, { 0x71dd41a08f48af40u, 0x1561d276ddfdc00au },
+    { 0x0e549208b31adb10u, 0x1aba4714957d300du }, { 0x28f4db456ff0c8eau, 0x10b46c6cdd6e3e08u },
+    { 0x33321216cbecfb24u, 0x14e1878814c9cd8au }, { 0xbffe969c7ee839edu, 0x1a19e96a19fc40ecu },
+    { 0xf7ff1e21cf512434u, 0x105031e2503da893u }, { 0xf5fee5aa43256d41u, 0x14643e5ae44d12b8u },
+    { 0x337e9f14d3eec892u, 0x197d4df19d605767u }, { 0x005e46da08ea7ab6u, 0x1fdca16e04b86d41u },
+    { 0xa03aec4845928cb2u, 0x13e9e4e4c2f34448u }, { 0xc849a75a56f72fdeu, 0x18e45e1df3b0155au },
+    { 0x7a5c1130ecb4fbd6u, 0x1f1d75a5709c1ab1u }, { 0xec798abe93f11d65u, 0x13726987666190aeu },
+    { 0xa797ed6e38ed64bfu, 0x184f03e93ff9f4dau }, { 0x517de8c9c728bdefu, 0x1e62c4e38ff87211u },
+    { 0xd2eeb17e1c7976b5u, 0x12fdbb0e39fb474au }, { 0x87aa5ddda397d462u, 0x17bd29d1c87a191du },
+    { 0xe994f5550c7dc97bu, 0x1dac74463a989f64u }, { 0x11fd195527ce9dedu, 0x128bc8abe49f639fu },
+    { 0xd67c5faa71c24568u, 0x172ebad6ddc73c86u }, { 0x8c1b77950e32d6c2u, 0x1cfa698c95390ba8u },
+    { 0x57912abd28dfc639u, 0x121c81f7dd43a749u }, { 0xad75756c7317b7c8u, 0x16a3a275d494911bu },
+    { 0x98d2d2c78fdda5bau, 0x1c4c8b1349b9b562u }, { 0x9f83c3bcb9ea8794u, 0x11afd6ec0e14115du },
+    { 0x0764b4abe8652979u, 0x161bcca7119915b5u }, { 0x493de1d6e27e73d7u, 0x1ba2bfd0d5ff5b22u },
+    { 0x6dc6ad264d8f0866u, 0x1145b7e285bf98f5u }, { 0xc938586fe0f2ca80u, 0x159725db272f7f32u },
+    { 0x7b866e8bd92f7d20u, 0x1afcef51f0fb5effu }, { 0xad34051767bdae34u, 0x10de1593369d1b5fu },
+    { 0x9881065d41ad19c1u, 0x15159af804446237u }, { 0x7ea147f492186032u, 0x1a5b01b605557ac5u },
+    { 0x6f24ccf8db4f3c1fu, 0x1078e111c3556cbbu }, { 0x4aee003712230b27u, 0x14971956342ac7eau },
+    { 0xdda98044d6abcdf0u, 0x19bcdfabc13579e4u }, { 0x0a89f02b062b60b6u, 0x10160bcb58c16c2fu },
+    { 0xcd2c6c35c7b638e4u, 0x141b8ebe2ef1c73au }, { 0x8077874339a3c71du, 0x1922726dbaae3909u },
+    { 0xe0956914080cb8e4u, 0x1f6b0f092959c74bu }, { 0x6c5d61ac8507f38eu, 0x13a2e965b9d81c8fu },
+    { 0x4774ba17a649f072u, 0x188ba3bf284e23b3u }, { 0x1951e89d8fdc6c8fu, 0x1eae8caef261aca0u },
+    { 0x0fd3316279e9c3d9u, 0x132d17ed577d0be4u }, { 0x13c7fdbb186434cfu, 0x17f85de8ad5c4eddu },
+    { 0x58b9fd29de7d4203u, 0x1df67562d8b36294u }, { 0xb7743e3a2b0e4942u, 0x12ba095dc7701d9cu },
+    { 0xe5514dc8b5d1db92u, 0x17688bb5394c2503u }, { 0xdea5a13ae3465277u, 0x1d42aea2879f2e44u },
+    { 0x0b2784c4ce0bf38au, 0x1249ad2594c37cebu }, { 0xcdf165f6018ef06du, 0x16dc186ef9f45c25u },
+    { 0x416dbf7381f2ac88u, 0x1c931e8ab871732fu }, { 0x88e497a83137abd5u, 0x11dbf316b346e7fdu },
+    { 0xeb1dbd923d8596cau, 0x1652efdc6018a1fcu }, { 0x25e52cf6cce6fc7du, 0x1be7abd3781eca7cu },
+    { 0x97af3c1a40105dceu, 0x1170cb642b133e8du }, { 0xfd9b0b20d0147542u, 0x15ccfe3d35d80e30u },
+    { 0x3d01cde904199292u, 0x1b403dcc834e11bdu }, { 0x462120b1a28ffb9bu, 0x1108269fd210cb16u },
+    { 0xd7a968de0b33fa82u, 0x154a3047c694fddbu }, { 0xcd93c3158e00f923u, 0x1a9cbc59b83a3d52u },
+    { 0xc07c59ed78c09bb6u, 0x10a1f5b813246653u }, { 0xb09b7068d6f0c2a3u, 0x14ca732617ed7fe8u },
+    { 0xdcc24c830cacf34cu, 0x19fd0fef9de8dfe2u }, { 0xc9f96fd1e7ec180fu, 0x103e29f5c2b18bedu },
+    { 0x3c77cbc661e71e13u, 0x144db473335deee9u }, { 0x8b95beb7fa60e598u, 0x1961219000356aa3u },
+    { 0x6e7b2e65f8f91efeu, 0x1fb969f40042c54cu }, { 0xc50cfcffbb9bb35fu, 0x13d3e2388029bb4fu },
+    { 0xb6503c3faa82a037u, 0x18c8dac6a0342a23u }, { 0xa3e44b4f95234844u, 0x1efb1178484134acu },
+    { 0xe66eaf11bd360d2bu, 0x135ceaeb2d28c0ebu }, { 0xe00a5ad62c839075u, 0x183425a5f872f126u },
+    { 0x980cf18bb7a47493u, 0x1e412f0f768fad70u }, { 0x5f0816f752c6c8dcu, 0x12e8bd69aa19cc66u },
+    { 0xf6ca1cb527787b13u, 0x17a2ecc414a03f7fu }, { 0xf47ca3e2715699d7u, 0x1d8ba7f519c84f5fu },
+    { 0xf8cde66d86d62026u, 0x127748f9301d319bu }, { 0xf7016008e88ba830u, 0x17151b377c247e02u },
+    { 0xb4c1b80b22ae923cu, 0x1cda62055b2d9d83u }, { 0x50f91306f5ad1b65u, 0x12087d4358fc8272u },
+    { 0xe53757c8b318623fu, 0x168a9c942f3ba30eu }, { 0x9e852dbadfde7acfu, 0x1c2d43b93b0a8bd2u },
+    { 0xa3133c94cbeb0cc1u, 0x119c4a53c4e69763u }, { 0x8bd80bb9fee5cff1u, 0x16035ce8b6203d3cu },
+    { 0xaece0ea87e9f43eeu, 0x1b843422e3a84c8bu }, { 0x4d40c9294f238a75u, 0x1132a095ce492fd7u },
+    { 0x2090fb73a2ec6d12u, 0x157f48bb41db7bcdu }, { 0x68b53a508ba78856u, 0x1adf1aea12525ac0u },
+    { 0x417144725748b536u, 0x10cb70d24b7378b8u }, { 0x51cd958eed1ae283u, 0x14fe4d06de5056e6u },
+    { 0xe640faf2a8619b24u, 0x1a3de04895e46c9fu }, { 0xefe89cd7a93d00f7u, 0x1066ac2d5daec3e3u },
+    { 0xebe2c40d938c4134u, 0x14805738b51a74dcu }, { 0x26db7510f86f5181u, 0x19a06d06e2611214u },
+    { 0x9849292a9b4592f1u, 0x100444244d7cab4cu }, { 0xbe5b73754216f7adu, 0x1405552d60dbd61fu },
+    { 0xadf25052929cb598u, 0x1906aa78b912cba7u }, { 0x996ee4673743e2ffu, 0x1f485516e7577e91u },
+    { 0xffe54ec0828a6ddfu, 0x138d352e5096af1au }, { 0xbfdea270a32d0957u, 0x18708279e4bc5ae1u },
+    { 0x2fd64b0ccbf84badu, 0x1e8ca3185deb719au }, { 0x5de5eee7ff7b2f4cu, 0x1317e5ef3ab32700u },
+    { 0x755f6aa1ff59fb1fu, 0x17dddf6b095ff0c0u }, { 0x92b7454a7f3079e7u, 0x1dd55745cbb7ecf0u },
+    { 0x5bb28b4e8f7e4c30u, 0x12a5568b9f52f416u }, { 0xf29f2e22335ddf3cu, 0x174eac2e8727b11bu },
+    { 0xef46f9aac035570bu, 0x1d22573a28f19d62u }, { 0xd58c5c0ab8215667u, 0x123576845997025du },
+    { 0x4aef730d6629ac01u, 0x16c2d4256ffcc2f5u }, { 0x9dab4fd0bfb41701u, 0x1c73892ecbfbf3b2u },
+    { 0xa28b11e277d08e60u, 0x11c835bd3f7d784fu }, { 0x8b2dd65b15c4b1f9u, 0x163a432c8f5cd663u },
+    { 0x6df94bf1db35de77u, 0x1bc8d3f7b3340bfcu }, { 0xc4bbcf772901ab0au, 0x115d847ad000877du },
+    { 0x35eac354f34215cdu, 0x15b4e5998400a95du }, { 0x8365742a30129b40u, 0x1b221effe500d3b4u },
+    { 0xd21f689a5e0ba108u, 0x10f5535fef208450u }, { 0x06a742c0f58e894au, 0x1532a837eae8a565u },
+    { 0x4851137132f22b9du, 0x1a7f5245e5a2cebeu }, { 0xed32ac26bfd75b42u, 0x108f936baf85c136u },
+    { 0xa87f57306fcd3212u, 0x14b378469b673184u }, { 0xd29f2cfc8bc07e97u, 0x19e056584240fde5u },
+    { 0xa3a37c1dd7584f1eu, 0x102c35f729689eafu }, { 0x8c8c5b254d2e62e6u, 0x14374374f3c2c65bu },
+    { 0x6faf71eea079fb9fu, 0x1945145230b377f2u }, { 0x0b9b4e6a48987a87u, 0x1f965966bce055efu },
+    { 0x674111026d5f4c94u, 0x13bdf7e0360c35b5u }, { 0xc111554308b71fbau, 0x18ad75d8438f4322u },
+    { 0x7155aa93cae4e7a8u, 0x1ed8d34e547313ebu }, { 0x26d58a9c5ecf10c9u, 0x13478410f4c7ec73u },
+    { 0xf08aed437682d4fbu, 0x1819651531f9e78fu }, { 0xecada89454238a3au, 0x1e1fbe5a7e786173u },
+    { 0x73ec895cb4963664u, 0x12d3d6f88f0b3ce8u }, { 0x90e7abb3e1bbc3fdu, 0x1788ccb6b2ce0c22u },
+    { 0x352196a0da2ab4fdu, 0x1d6affe45f818f2bu }, { 0x0134fe24885ab11eu, 0x1262dfeebbb0f97bu },
+    { 0xc1823dadaa715d65u, 0x16fb97ea6a9d37d9u }, { 0x31e2cd19150db4bfu, 0x1cba7de5054485d0u },
+    { 0x1f2dc02fad2890f7u, 0x11f48eaf234ad3a2u }, { 0xa6f9303b9872b535u, 0x1671b25aec1d888au },
+    { 0x50b77c4a7e8f6282u, 0x1c0e1ef1a724eaadu }, { 0x5272adae8f199d91u, 0x1188d357087712acu },
+    { 0x670f591a32e004f6u, 0x15eb082cca94d757u }, { 0x40d32f60bf980633u, 0x1b65ca37fd3a0d2du },
+    { 0x4883fd9c77bf03e0u, 0x111f9e62fe44483cu }, { 0x5aa4fd0395aec4d8u, 0x156785fbbdd55a4bu },
+    { 0x314e3c447b1a760eu, 0x1ac1677aad4ab0deu }, { 0xded0e5aaccf089c9u, 0x10b8e0acac4eae8au },
+    { 0x96851f15802cac3bu, 0x14e718d7d7625a2du }, { 0xfc2666dae037d74au, 0x1a20df0dcd3af0b8u },
+    { 0x9d980048cc22e68eu, 0x10548b68a044d673u }, { 0x84fe005aff2ba032u, 0x1469ae42c8560c10u },
+    { 0xa63d8071bef6883eu, 0x198419d37a6b8f14u }, { 0xcfcce08e2eb42a4eu, 0x1fe52048590672d9u },
+    { 0x21e00c58dd309a70u, 0x13ef342d37a407c8u }, { 0x2a580f6f147cc10du, 0x18eb0138858d09bau },
+    { 0xb4ee134ad99bf150u, 0x1f25c186a6f04c28u }, { 0x7114cc0ec80176d2u, 0x137798f428562f99u },
+    { 0xcd59ff127a01d486u, 0x18557f31326bbb7fu }, { 0xc0b07ed7188249a8u, 0x1e6adefd7f06aa5fu },
+    { 0xd86e4f466f516e09u, 0x1302cb5e6f642a7bu }, { 0xce89e3180b25c98bu, 0x17c37e360b3d351au },
+    { 0x822c5bde0def3beeu, 0x1db45dc38e0c8261u }, { 0xf15bb96ac8b58575u, 0x1290ba9a38c7d17cu },
+    { 0x2db2a7c57ae2e6d2u, 0x1734e940c6f9c5dcu }, { 0x391f51b6d99ba086u, 0x1d022390f8b83753u },
+    { 0x03b3931248014454u, 0x1221563a9b732294u }, { 0x04a077d6da019569u, 0x16a9abc9424feb39u },
+    { 0x45c895cc9081fac3u, 0x1c5416bb92e3e607u }, { 0x8b9d5d9fda513cbau, 0x11b48e353bce6fc4u },
+    { 0xae84b507d0e58be8u, 0x1621b1c28ac20bb5u }, { 0x1a25e249c51eeee3u, 0x1baa1e332d728ea3u },
+    { 0xf057ad6e1b33554du, 0x114a52dffc679925u }, { 0x6c6d98c9a2002aa1u, 0x159ce797fb817f6fu },
+    { 0x4788fefc0a803549u, 0x1b04217dfa61df4bu }, { 0x0cb59f5d8690214eu, 0x10e294eebc7d2b8fu },
+    { 0xcfe30734e83429a1u, 0x151b3a2a6b9c7672u }, { 0x83dbc9022241340au, 0x1a6208b50683940fu },
+    { 0xb2695da15568c086u, 0x107d457124123c89u }, { 0x1f03b509aac2f0a7u, 0x149c96cd6d16cbacu },
+    { 0x26c4a24c1573acd1u, 0x19c3bc80c85c7e97u }, { 0x783ae56f8d684c03u, 0x101a55d07d39cf1eu },
+    { 0x16499ecb70c25f03u, 0x1420eb449c8842e6u }, { 0x9bdc067e4cf2f6c4u, 0x19292615c3aa539fu },
+    { 0x82d3081de02fb476u, 0x1f736f9b3494e887u }, { 0xb1c3e512ac1dd0c9u, 0x13a825c100dd1154u },
+    { 0xde34de57572544fcu, 0x18922f31411455a9u }, { 0x55c215ed2cee963bu, 0x1eb6bafd91596b14u },
+    { 0xb5994db43c151de5u, 0x133234de7ad7e2ecu }, { 0xe2ffa1214b1a655eu, 0x17fec216198ddba7u },
+    { 0xdbbf89699de0feb6u, 0x1dfe729b9ff15291u }, { 0x2957b5e202ac9f31u, 0x12bf07a143f6d39bu },
+    { 0xf3ada35a8357c6feu, 0x176ec98994f48881u }, { 0x70990c31242db8bdu, 0x1d4a7bebfa31aaa2u },
+    { 0x865fa79eb69c9376u, 0x124e8d737c5f0aa5u }, { 0xe7f791866443b854u, 0x16e230d05b76cd4eu },
+    { 0xa1f575e7fd54a669u, 0x1c9abd04725480a2u }, { 0xa53969b0fe54e801u, 0x11e0b622c774d065u },
+    { 0x0e87c41d3dea2202u, 0x1658e3ab7952047fu }, { 0xd229b5248d64aa82u, 0x1bef1c9657a6859eu },
+    { 0x435a1136d85eea91u, 0x117571ddf6c81383u }, { 0x143095848e76a536u, 0x15d2ce55747a1864u },
+    { 0x193cbae5b2144e83u, 0x1b4781ead1989e7du }, { 0x2fc5f4cf8f4cb112u, 0x110cb132c2ff630eu },
+    { 0xbbb77203731fdd56u, 0x154fdd7f73bf3bd1u }, { 0x2aa54e844fe7d4acu, 0x1aa3d4df50af0ac6u },
+    { 0xdaa75112b1f0e4ebu, 0x10a6650b926d66bbu }, { 0xd15125575e6d1e26u, 0x14cffe4e7708c06au },
+    { 0x85a56ead360865b0u, 0x1a03fde214caf085u }, { 0x7387652c41c53f8eu, 0x10427ead4cfed653u },
+    { 0x50693e7752368f71u, 0x14531e58a03e8be8u }, { 0x64838e1526c4334eu, 0x1967e5eec84e2ee2u },
+    { 0xfda4719a70754022u, 0x1fc1df6a7a61ba9au }, { 0xde86c70086494815u, 0x13d92ba28c7d14a0u },
+    { 0x162878c0a7db9a1au, 0x18cf768b2f9c59c9u }, { 0x5bb296f0d1d280a1u, 0x1f03542dfb83703bu },
+    { 0x194f9e5683239064u, 0x1362149cbd322625u }, { 0x5fa385ec23ec747eu, 0x183a99c3ec7eafaeu },
+    { 0xf78c67672ce7919du, 0x1e494034e79e5b99u }, { 0x3ab7c0a07c10bb02u, 0x12edc82110c2f940u },
+    { 0x4965b0c89b14e9c3u, 0x17a93a2954f3b790u }, { 0x5bbf1cfac1da2433u, 0x1d9388b3aa30a574u },
+    { 0xb957721cb92856a0u, 0x127c35704a5e6768u }, { 0xe7ad4ea3e7726c48u, 0x171b42cc5cf60142u },
+    { 0xa198a24ce14f075au, 0x1ce2137f74338193u }, { 0x44ff65700cd16498u, 0x120d4c2fa8a030fcu },
+    { 0x563f3ecc1005bdbeu, 0x16909f3b92c83d3bu }, { 0x2bcf0e7f14072d2eu, 0x1c34c70a777a4c8au },
+    { 0x5b61690f6c847c3du, 0x11a0fc668aac6fd6u }, { 0xf239c35347a59b4cu, 0x16093b802d578bcbu },
+    { 0xeec83428198f021fu, 0x1b8b8a6038ad6ebeu }, { 0x553d20990ff96153u, 0x1137367c236c6537u },
+    { 0x2a8c68bf53f7b9a8u, 0x1585041b2c477e85u }, { 0x752f82ef28f5a812u, 0x1ae64521f7595e26u },
+    { 0x093db1d57999890bu, 0x10cfeb353a97dad8u }, { 0x0b8d1e4ad7ffeb4eu, 0x1503e602893dd18eu },
+    { 0x8e7065dd8dffe622u, 0x1a44df832b8d45f1u }, { 0xf9063faa78bfefd5u, 0x106b0bb1fb384bb6u },
+    { 0xb747cf9516efebcau, 0x1485ce9e7a065ea4u }, { 0xe519c37a5cabe6bdu, 0x19a742461887f64du },
+    { 0xaf301a2c79eb7036u, 0x1008896bcf54f9f0u }, { 0xdafc20b798664c43u, 0x140aabc6c32a386cu },
+    { 0x11bb28e57e7fdf54u, 0x190d56b873f4c688u }, { 0x1629f31ede1fd72au, 0x1f50ac6690f1f82au },
+    { 0x4dda37f34ad3e67au, 0x13926bc01a973b1au }, { 0xe150c5f01d88e019u, 0x187706b0213d09e0u },
+    { 0x19a4f76c24eb181fu, 0x1e94c85c298c4c59u }, { 0xb0071aa39712ef13u, 0x131cfd3999f7afb7u },
+    { 0x9c08e14c7cd7aad8u, 0x17e43c8800759ba5u }, { 0x030b199f9c0d958eu, 0x1ddd4baa0093028fu },
+    { 0x61e6f003c1887d79u, 0x12aa4f4a405be199u }, { 0xba60ac04b1ea9cd7u, 0x1754e31cd072d9ffu },
+    { 0xa8f8d705de65440du, 0x1d2a1be4048f907fu }, { 0xc99b8663aaff4a88u, 0x123a516e82d9ba4fu },
+    { 0xbc0267fc95bf1d2au, 0x16c8e5ca239028e3u }, { 0xab0301fbbb2ee474u, 0x1c7b1f3cac74331cu },
+    { 0xeae1e13d54fd4ec9u, 0x11ccf385ebc89ff1u }, { 0x659a598caa3ca27bu, 0x1640306766bac7eeu },
+    { 0xff00efefd4cbcb1au, 0x1bd03c81406979e9u }, { 0x3f6095f5e4ff5ef0u, 0x116225d0c841ec32u },
+    { 0xcf38bb735e3f36acu, 0x15baaf44fa52673eu }, { 0x8306ea5035cf0457u, 0x1b295b1638e7010eu },
+    { 0x11e4527221a162b6u, 0x10f9d8ede39060a9u }, { 0x565d670eaa09bb64u, 0x15384f295c7478d3u },
+    { 0x2bf4c0d2548c2a3du, 0x1a8662f3b3919708u }, { 0x1b78f88374d79a66u, 0x1093fdd8503afe65u },
+    { 0x625736a4520d8100u, 0x14b8fd4e6449bdfeu }, { 0xfaed044d6690e140u, 0x19e73ca1fd5c2d7du },
+    { 0xbcd422b0601a8cc8u, 0x103085e53e599c6eu }, { 0x6c092b5c78212ffau, 0x143ca75e8df0038au },
+    { 0x070b763396297bf8u, 0x194bd136316c046du }, { 0x48ce53c07bb3daf6u, 0x1f9ec583bdc70588u },
+    { 0x2d80f4584d5068dau, 0x13c33b72569c6375u }, { 0x78e1316e60a48310u, 0x18b40a4eec437c52u }
+};
+
+/*
+d_string_internal_is_eight_digits
+  Returns true if all eight bytes of a little-endian word are ASCII digits.
+*/
+static D_INLINE bool
+d_string_internal_is_eight_digits
+(
+    uint64_t _word
+)
+{
+    return ( ( ((_word + 0x4646464646464646ULL) |
+                (_word - 0x3030303030303030ULL)) &
+               0x8080808080808080ULL ) == 0 );
+}
+
+/*
+d_string_internal_eight_digits
+  Returns the value of eight ASCII digits loaded as a little-endian word,
+combining them pairwise with three multiplications.
+*/
+static D_INLINE uint32_t
+d_string_internal_eight_digits
+(
+    uint64_t _word
+)
+{
+    _word -= 0x3030303030303030ULL;
+    _word  = (_word * 10) + (_word >> 8);
+    _word  = ( ((_word & 0x000000FF000000FFULL) * 0x000F424000000064ULL) +
+               (((_word >> 16) & 0x000000FF000000FFULL) *
+                0x0000271000000001ULL) ) >> 32;
+
+    return (uint32_t)_word;
+}
+
+/*
+d_string_internal_scan_digits
+  Accumulates the leading run of up to `_max` ASCII digits at `_p` into
+`*_value` and returns how many were consumed. Callers keep `_max` small
+enough (19 for an initially zero value) that the result cannot overflow.
+*/
+static size_t
+d_string_internal_scan_digits
+(
+    const char* _p,
+    size_t      _max,
+    uint64_t*   _value
+)
+{
+    uint64_t value;
+    size_t   i;
+    unsigned digit;
+
+    value = *_value;
+    i     = 0;
+
+#if D_ENV_ARCH_IS_LITTLE_ENDIAN
+    {
+        uint64_t word;
+
+        while ((_max - i) >= 8)
+        {
+            memcpy(&word, _p + i, sizeof(word));
+
+            if (!d_string_internal_is_eight_digits(word))
+            {
+                break;
+            }
+
+            value = (value * 100000000u) +
+                    d_string_internal_eight_digits(word);
+            i    += 8;
+        }
+    }
+#endif
+
+    while (i < _max)
+    {
+        digit = (unsigned)(unsigned char)_p[i] - '0';
+
+        if (digit > 9)
+        {
+            break;
+        }
+
+        value = (value * 10) + digit;
+        i++;
+    }
+
+    *_value = value;
+
+    return i;
+}
+
+/*
+d_string_internal_parse_uint
+  Parses the whole of `_p[0.._n)` as an unsigned decimal integer (digits
+only, leading zeros allowed). Returns 0, EINVAL if the text is empty or
+holds a non-digit, or ERANGE if the value exceeds UINT64_MAX.
+*/
+static int
+d_string_internal_parse_uint
+(
+    const char* _p,
+    size_t      _n,
+    uint64_t*   _value
+)
+{
+    uint64_t value;
+    size_t   start;
+    size_t   count;
+    unsigned digit;
+
+    if (_n == 0)
+    {
+        return EINVAL;
+    }
+
+    // leading zeros do not count towards the 20 digits UINT64_MAX has
+    start = 0;
+
+    while ( (start < _n) &&
+            (_p[start] == '0') )
+    {
+        start++;
+    }
+
+    value = 0;
+    count = d_string_internal_scan_digits(_p + start,
+                                          ((_n - start) < 19) ? (_n - start)
+                                                              : 19,
+                                          &value);
+
+    if (start + count == _n)
+    {
+        *_value = value;
+
+        return 0;
+    }
+
+    // a 20th digit fits only if it keeps the value within UINT64_MAX
+    digit = (unsigned)(unsigned char)_p[start + count] - '0';
+
+    if ( (count < 19) ||
+         (digit > 9) )
+    {
+        return EINVAL;
+    }
+
+    for (count = start + 20; count < _n; count++)
+    {
+        if ((unsigned)(unsigned char)_p[count] - '0' > 9)
+        {
+            return EINVAL;
+        }
+    }
+
+    if ( (start + 20 < _n)                   ||
+         (value > (UINT64_MAX - digit) / 10) )
+    {
+        return ERANGE;
+    }
+
+    *_value = (value * 10) + digit;
+
+    return 0;
+}
+
+/*
+d_string_internal_mul_shift
+  Returns the 64x128-bit product `_m` * `_mul` shifted right by `_shift`
+bits, where 64 < `_shift` < 128.
+*/
+static D_INLINE uint64_t
+d_string_internal_mul_shift
+(
+    uint64_t        _m,
+    const uint64_t* _mul,
+    unsigned        _shift
+)
+{
+    uint64_t low_lo;
+    uint64_t low_hi;
+    uint64_t high_lo;
+    uint64_t high_hi;
+    uint64_t sum;
+
+    low_lo  = _m;
+    low_hi  = _mul[0];
+    d_string_internal_mum(&low_lo, &low_hi);
+
+    high_lo = _m;
+    high_hi = _mul[1];
+    d_string_internal_mum(&high_lo, &high_hi);
+
+    sum      = high_lo + low_hi;
+    high_hi += (sum < high_lo);
+    _shift  -= 64;
+
+    return (high_hi << (64 - _shift)) | (sum >> _shift);
+}
+
+/*
+d_string_internal_pow5_factor
+  Returns the number of times 5 divides `_value` (which must be nonzero).
+*/
+static unsigned
+d_string_internal_pow5_factor
+(
+    uint64_t _value
+)
+{
+    unsigned count;
+
+    count = 0;
+
+    while ((_value % 5) == 0)
+    {
+        _value /= 5;
+        count++;
+    }
+
+    return count;
+}
+
+// D_STRING_INTERNAL_POW5_BITS
+//   macro: ceil(log2(5^e)) for 0 <= e <= 3528 (1 for e == 0).
+#define D_STRING_INTERNAL_POW5_BITS(e)                                     \
+    ((int32_t)((((uint32_t)(e) * 1217359u) >> 19) + 1))
+
+// D_STRING_INTERNAL_LOG10_POW2
+//   macro: floor(log10(2^e)) for 0 <= e <= 1650.
+#define D_STRING_INTERNAL_LOG10_POW2(e)                                    \
+    ((int32_t)(((uint32_t)(e) * 78913u) >> 18))
+
+// D_STRING_INTERNAL_LOG10_POW5
+//   macro: floor(log10(5^e)) for 0 <= e <= 2620.
+#define D_STRING_INTERNAL_LOG10_POW5(e)                                    \
+    ((int32_t)(((uint32_t)(e) * 732923u) >> 20))
+
+/*
+d_string_internal_shortest
+  Finds the shortest decimal `*_digits` x 10^`*_exponent` that reads back as
+the finite, positive double with the given IEEE mantissa and exponent
+fields, choosing the one closest to the exact value when several qualify
+(Ryu, Adams 2018).
+*/
+static void
+d_string_internal_shortest
+(
+    uint64_t  _mantissa,
+    uint32_t  _exponent,
+    uint64_t* _digits,
+    int32_t*  _exponent10
+)
+{
+    int32_t  e2;
+    uint64_t m2;
+    uint64_t mv;
+    uint64_t vr;
+    uint64_t vp;
+    uint64_t vm;
+    uint64_t output;
+    int32_t  e10;
+    int32_t  q;
+    int32_t  i;
+    int32_t  j;
+    int32_t  removed;
+    unsigned mm_shift;
+    unsigned last_removed;
+    bool     accept_bounds;
+    bool     vm_trailing_zeros;
+    bool     vr_trailing_zeros;
+    bool     round_up;
+
+    if (_exponent == 0)
+    {
+        e2 = 1 - 1023 - 52 - 2;
+        m2 = _mantissa;
+    }
+    else
+    {
+        e2 = (int32_t)_exponent - 1023 - 52 - 2;
+        m2 = (1ULL << 52) | _mantissa;
+    }
+
+    // the interval of doubles that round to this one is [vm, vp] around vr,
+    // all scaled by 4 so the half-way points are integers; it is closed when
+    // the mantissa is even (round-half-even reads its bounds back)
+    accept_bounds     = ((m2 & 1) == 0);
+    mv                = 4 * m2;
+    mm_shift          = ( (_mantissa != 0) || (_exponent <= 1) );
+    vm_trailing_zeros = false;
+    vr_trailing_zeros = false;
+
+    if (e2 >= 0)
+    {
+        q   = D_STRING_INTERNAL_LOG10_POW2(e2) - (e2 > 3);
+        e10 = q;
+        j   = -e2 + q + 125 + D_STRING_INTERNAL_POW5_BITS(q) - 1;
+        vr  = d_string_internal_mul_shift(4 * m2,
+                                          d_string_internal_pow5_inv[q],
+                                          (unsigned)j);
+        vp  = d_string_internal_mul_shift(4 * m2 + 2,
+                                          d_string_internal_pow5_inv[q],
+                                          (unsigned)j);
+        vm  = d_string_internal_mul_shift(4 * m2 - 1 - mm_shift,
+                                          d_string_internal_pow5_inv[q],
+                                          (unsigned)j);
+
+        // only small q can leave an exact (trailing-zero) quotient
+        if (q <= 21)
+        {
+            if ((mv % 5) == 0)
+            {
+                vr_trailing_zeros =
+                    (d_string_internal_pow5_factor(mv) >= (unsigned)q);
+            }
+            else if (accept_bounds)
+            {
+                vm_trailing_zeros =
+                    (d_string_internal_pow5_factor(mv - 1 - mm_shift) >=
+                     (unsigned)q);
+            }
+            else
+            {
+                vp -= (d_string_internal_pow5_factor(mv + 2) >= (unsigned)q);
+            }
+        }
+    }
+    else
+    {
+        q   = D_STRING_INTERNAL_LOG10_POW5(-e2) - (-e2 > 1);
+        e10 = q + e2;
+        i   = -e2 - q;
+        j   = q - (D_STRING_INTERNAL_POW5_BITS(i) - 125);
+        vr  = d_string_internal_mul_shift(4 * m2,
+                                          d_string_internal_pow5[i],
+                                          (unsigned)j);
+        vp  = d_string_internal_mul_shift(4 * m2 + 2,
+                                          d_string_internal_pow5[i],
+                                          (unsigned)j);
+        vm  = d_string_internal_mul_shift(4 * m2 - 1 - mm_shift,
+                                          d_string_internal_pow5[i],
+                                          (unsigned)j);
+
+        if (q <= 1)
+        {
+            // mv has at least q trailing zero bits, so vr is exact
+            vr_trailing_zeros = true;
+
+            if (accept_bounds)
+            {
+                vm_trailing_zeros = (mm_shift == 1);
+            }
+            else
+            {
+                vp--;
+            }
+        }
+        else if (q < 63)
+        {
+            vr_trailing_zeros = ((mv & ((1ULL << q) - 1)) == 0);
+        }
+    }
+
+    // drop digits while the interval still holds a shorter number
+    removed      = 0;
+    last_removed = 0;
+
+    if ( (vm_trailing_zeros) ||
+         (vr_trailing_zeros) )
+    {
+        // rare: exact bounds or ties need the digits removed tracked
+        while ((vp / 10) > (vm / 10))
+        {
+            vm_trailing_zeros &= ((vm % 10) == 0);
+            vr_trailing_zeros &= (last_removed == 0);
+            last_removed       = (unsigned)(vr % 10);
+            vr                /= 10;
+            vp                /= 10;
+            vm                /= 10;
+            removed++;
+        }
+
+        if (vm_trailing_zeros)
+        {
+            while ((vm % 10) == 0)
+            {
+                vr_trailing_zeros &= (last_removed == 0);
+                last_removed       = (unsigned)(vr % 10);
+                vr                /= 10;
+                vp                /= 10;
+                vm                /= 10;
+                removed++;
+            }
+        }
+
+        // an exact tie rounds to even
+        if ( (vr_trailing_zeros)  &&
+             (last_removed == 5)  &&
+             ((vr % 2) == 0) )
+        {
+            last_removed = 4;
+        }
+
+        output = vr + ( ( (vr == vm) &&
+                          ( (!accept_bounds) || (!vm_trailing_zeros) ) ) ||
+                        (last_removed >= 5) );
+    }
+    else
+    {
+        round_up = false;
+
+        if ((vp / 100) > (vm / 100))
+        {
+            round_up = ((vr % 100) >= 50);
+            vr      /= 100;
+            vp      /= 100;
+            vm      /= 100;
+            removed += 2;
+        }
+
+        while ((vp / 10) > (vm / 10))
+        {
+            round_up = ((vr % 10) >= 5);
+            vr      /= 10;
+            vp      /= 10;
+            vm      /= 10;
+            removed++;
+        }
+
+        output = vr + ( (vr == vm) || round_up );
+    }
+
+    *_digits     = output;
+    *_exponent10 = e10 + removed;
+
+    return;
+}
+
+/*
+d_string_internal_dtoa
+  Writes the shortest text that reads back as `_value` into `_buf` (at least
+D_STRING_INTERNAL_DTOA_MAX bytes, not terminated) and returns its length.
+Finite values are laid out like ECMAScript's Number::toString: plain
+notation for decimal exponents from -6 to 20 ("0.000001", "123.5", "1e+21").
+Non-finite values are written "nan", "inf" and "-inf".
+*/
+static size_t
+d_string_internal_dtoa
+(
+    double _value,
+    char*  _buf
+)
+{
+    uint64_t bits;
+    uint64_t mantissa;
+    uint32_t exponent;
+    uint64_t digits;
+    int32_t  exponent10;
+    int32_t  point;
+    char     tmp[20];
+    char*    first;
+    size_t   count;
+    size_t   len;
+    int32_t  e;
+
+    memcpy(&bits, &_value, sizeof(bits));
+
+    mantissa = bits & ((1ULL << 52) - 1);
+    exponent = (uint32_t)((bits >> 52) & 0x7FF);
+    len      = 0;
+
+    if ( (exponent == 0x7FF) &&
+         (mantissa != 0) )
+    {
+        memcpy(_buf, "nan", 3);
+
+        return 3;
+    }
+
+    if (bits >> 63)
+    {
+        _buf[len++] = '-';
+    }
+
+    if (exponent == 0x7FF)
+    {
+        memcpy(_buf + len, "inf", 3);
+
+        return len + 3;
+    }
+
+    if ( (exponent == 0) &&
+         (mantissa == 0) )
+    {
+        _buf[len++] = '0';
+
+        return len;
+    }
+
+    d_string_internal_shortest(mantissa, exponent, &digits, &exponent10);
+
+    first = d_string_internal_utoa(digits, tmp + sizeof(tmp), 10, false);
+    count = (size_t)(tmp + sizeof(tmp) - first);
+
+    // `point` is where the decimal point falls relative to the digits
+    point = exponent10 + (int32_t)count;
+
+    if ( ((int32_t)count <= point) &&
+         (point <= 21) )
+    {
+        // integer: digits then zeros
+        memcpy(_buf + len, first, count);
+        len += count;
+        memset(_buf + len, '0', (size_t)point - count);
+        len += (size_t)point - count;
+    }
+    else if ( (0 < point) &&
+              (point <= 21) )
+    {
+        memcpy(_buf + len, first, (size_t)point);
+        len        += (size_t)point;
+        _buf[len++] = '.';
+        memcpy(_buf + len, first + point, count - (size_t)point);
+        len        += count - (size_t)point;
+    }
+    else if ( (-6 < point) &&
+              (point <= 0) )
+    {
+        _buf[len++] = '0';
+        _buf[len++] = '.';
+        memset(_buf + len, '0', (size_t)-point);
+        len += (size_t)-point;
+        memcpy(_buf + len, first, count);
+        len += count;
+    }
+    else
+    {
+        _buf[len++] = first[0];
+
+        if (count > 1)
+        {
+            _buf[len++] = '.';
+            memcpy(_buf + len, first + 1, count - 1);
+            len += count - 1;
+        }
+
+        e           = point - 1;
+        _buf[len++] = 'e';
+        _buf[len++] = (e < 0) ? '-' : '+';
+        e           = (e < 0) ? -e : e;
+        first       = d_string_internal_utoa((uintmax_t)e,
+                                             tmp + sizeof(tmp),
+                                             10,
+                                             false);
+        count       = (size_t)(tmp + sizeof(tmp) - first);
+        memcpy(_buf + len, first, count);
+        len += count;
+    }
+
+    return len;
+}
+
+/*
+d_string_internal_decimal_trim
+  Drops trailing zero digits from a decimal.
+*/
+static void
+d_string_internal_decimal_trim
+(
+    struct d_string_internal_decimal* _dec
+)
+{
+    while ( (_dec->nd > 0) &&
+            (_dec->d[_dec->nd - 1] == 0) )
+    {
+        _dec->nd--;
+    }
+
+    if (_dec->nd == 0)
+    {
+        _dec->dp = 0;
+    }
+
+    return;
+}
+
+/*
+d_string_internal_decimal_rshift
+  Divides a decimal by 2^`_k` (`_k` <= D_STRING_INTERNAL_DEC_SHIFT) in place.
+*/
+static void
+d_string_internal_decimal_rshift
+(
+    struct d_string_internal_decimal* _dec,
+    unsigned                          _k
+)
+{
+    uint64_t n;
+    uint64_t mask;
+    int      r;
+    int      w;
+
+    n    = 0;
+    r    = 0;
+    w    = 0;
+    mask = (1ULL << _k) - 1;
+
+    // pick up enough leading digits to produce the first output digit
+    while ((n >> _k) == 0)
+    {
+        if (r >= _dec->nd)
+        {
+            if (n == 0)
+            {
+                _dec->nd = 0;
+
+                return;
+            }
+
+            while ((n >> _k) == 0)
+            {
+                n *= 10;
+                r++;
+            }
+
+            break;
+        }
+
+        n = (n * 10) + _dec->d[r++];
+    }
+
+    _dec->dp -= r - 1;
+
+    while (r < _dec->nd)
+    {
+        _dec->d[w++] = (uint8_t)(n >> _k);
+        n            = ((n & mask) * 10) + _dec->d[r++];
+    }
+
+    while (n > 0)
+    {
+        if (w < D_STRING_INTERNAL_DEC_DIGITS)
+        {
+            _dec->d[w++] = (uint8_t)(n >> _k);
+        }
+        else if ((n >> _k) > 0)
+        {
+            _dec->trunc = true;
+        }
+
+        n = (n & mask) * 10;
+    }
+
+    _dec->nd = w;
+    d_string_internal_decimal_trim(_dec);
+
+    return;
+}
+
+/*
+d_string_internal_decimal_lshift
+  Multiplies a decimal by 2^`_k` (`_k` <= D_STRING_INTERNAL_DEC_SHIFT) in
+place. The product is built right to left in scratch space, since it may
+have up to 19 more digits than the input.
+*/
+static void
+d_string_internal_decimal_lshift
+(
+    struct d_string_internal_decimal* _dec,
+    unsigned                          _k
+)
+{
+    uint8_t  out[D_STRING_INTERNAL_DEC_DIGITS + 20];
+    uint64_t n;
+    uint64_t quo;
+    int      r;
+    int      w;
+    int      count;
+    int      i;
+
+    n = 0;
+    w = _dec->nd + 19;
+
+    for (r = _dec->nd - 1; r >= 0; r--)
+    {
+        n       += (uint64_t)_dec->d[r] << _k;
+        quo      = n / 10;
+        out[w--] = (uint8_t)(n - (10 * quo));
+        n        = quo;
+    }
+
+    while (n > 0)
+    {
+        quo      = n / 10;
+        out[w--] = (uint8_t)(n - (10 * quo));
+        n        = quo;
+    }
+
+    count     = _dec->nd + 19 - w;
+    _dec->dp += count - _dec->nd;
+
+    if (count > D_STRING_INTERNAL_DEC_DIGITS)
+    {
+        for (i = w + 1 + D_STRING_INTERNAL_DEC_DIGITS; i <= _dec->nd + 19; i++)
+        {
+            if (out[i] != 0)
+            {
+                _dec->trunc = true;
+            }
+        }
+
+        count = D_STRING_INTERNAL_DEC_DIGITS;
+    }
+
+    memcpy(_dec->d, out + w + 1, (size_t)count);
+    _dec->nd = count;
+    d_string_internal_decimal_trim(_dec);
+
+    return;
+}
+
+/*
+d_string_internal_decimal_shift
+  Multiplies (`_k` > 0) or divides (`_k` < 0) a decimal by 2^|`_k`|.
+*/
+static void
+d_string_internal_decimal_shift
+(
+    struct d_string_internal_decimal* _dec,
+    int                               _k
+)
+{
+    if (_dec->nd == 0)
+    {
+        return;
+    }
+
+    while (_k > D_STRING_INTERNAL_DEC_SHIFT)
+    {
+        d_string_internal_decimal_lshift(_dec, D_STRING_INTERNAL_DEC_SHIFT);
+        _k -= D_STRING_INTERNAL_DEC_SHIFT;
+    }
+
+    while (_k < -D_STRING_INTERNAL_DEC_SHIFT)
+    {
+        d_string_internal_decimal_rshift(_dec, D_STRING_INTERNAL_DEC_SHIFT);
+        _k += D_STRING_INTERNAL_DEC_SHIFT;
+    }
+
+    if (_k > 0)
+    {
+        d_string_internal_decimal_lshift(_dec, (unsigned)_k);
+    }
+    else if (_k < 0)
+    {
+        d_string_internal_decimal_rshift(_dec, (unsigned)-_k);
+    }
+
+    return;
+}
+
+/*
+d_string_internal_decimal_round
+  Returns the decimal rounded to the nearest integer, ties to even. Values
+of 2^64 or more are not expected.
+*/
+static uint64_t
+d_string_internal_decimal_round
+(
+    const struct d_string_internal_decimal* _dec
+)
+{
+    uint64_t n;
+    int      i;
+    bool     up;
+
+    if (_dec->dp > 20)
+    {
+        return UINT64_MAX;
+    }
+
+    n = 0;
+
+    for (i = 0; (i < _dec->dp) && (i < _dec->nd); i++)
+    {
+        n = (n * 10) + _dec->d[i];
+    }
+
+    for (; i < _dec->dp; i++)
+    {
+        n *= 10;
+    }
+
+    up = false;
+
+    if ( (_dec->dp >= 0) &&
+         (_dec->dp < _dec->nd) )
+    {
+        if ( (_dec->d[_dec->dp] == 5) &&
+             (_dec->dp + 1 == _dec->nd) )
+        {
+            // exactly half unless digits were dropped: round to even
+            up = ( (_dec->trunc) ||
+                   ( (_dec->dp > 0) &&
+                     (_dec->d[_dec->dp - 1] & 1) ) );
+        }
+        else
+        {
+            up = (_dec->d[_dec->dp] >= 5);
+        }
+    }
+
+    return n + up;
+}
+
+/*
+d_string_internal_decimal_to_double
+  Rounds a decimal to the nearest double, ties to even, by scaling it with
+exact binary shifts until its integer part is the 53-bit mantissa. Returns
+0, or ERANGE if the value overflows to infinity or underflows to zero.
+*/
+static int
+d_string_internal_decimal_to_double
+(
+    struct d_string_internal_decimal* _dec,
+    bool                              _negative,
+    double*                           _value
+)
+{
+    // binary shifts that bring 10^i below 1 for i < 9
+    static const int shifts[9] = { 1, 3, 6, 9, 13, 16, 19, 23, 26 };
+
+    uint64_t bits;
+    uint64_t mantissa;
+    int      exponent;
+    int      n;
+    int      result;
+
+    result   = 0;
+    exponent = 0;
+    mantissa = 0;
+
+    if (_dec->nd == 0)
+    {
+        exponent = -1023;
+    }
+    else if (_dec->dp > 310)
+    {
+        result = ERANGE;
+    }
+    else if (_dec->dp < -330)
+    {
+        exponent = -1023;
+        result   = ERANGE;
+    }
+    else
+    {
+        // scale into [0.5, 1)
+        while (_dec->dp > 0)
+        {
+            n = (_dec->dp >= 9) ? 27 : shifts[_dec->dp];
+            d_string_internal_decimal_shift(_dec, -n);
+            exponent += n;
+        }
+
+        while ( (_dec->dp < 0) ||
+                ( (_dec->dp == 0) && (_dec->d[0] < 5) ) )
+        {
+            n = (-_dec->dp >= 9) ? 27 : shifts[-_dec->dp];
+            d_string_internal_decimal_shift(_dec, n);
+            exponent -= n;
+        }
+
+        // the value is now in [1, 2) x 2^exponent
+        exponent--;
+
+        // subnormals keep fewer mantissa bits
+        if (exponent < -1022)
+        {
+            n = -1022 - exponent;
+            d_string_internal_decimal_shift(_dec, -n);
+            exponent += n;
+        }
+
+        if (exponent + 1023 >= 0x7FF)
+        {
+            result = ERANGE;
+        }
+        else
+        {
+            d_string_internal_decimal_shift(_dec, 53);
+            mantissa = d_string_internal_decimal_round(_dec);
+
+            // rounding carried into a new bit
+            if (mantissa == (2ULL << 52))
+            {
+                mantissa >>= 1;
+                exponent++;
+
+                if (exponent + 1023 >= 0x7FF)
+                {
+                    result = ERANGE;
+                }
+            }
+
+            if ((mantissa & (1ULL << 52)) == 0)
+            {
+                exponent = -1023;
+
+                if (mantissa == 0)
+                {
+                    result = ERANGE;
+                }
+            }
+        }
+    }
+
+    if ( (result == ERANGE) &&
+         (exponent != -1023) )
+    {
+        mantissa = 0;
+        exponent = 0x7FF - 1023;
+    }
+
+    bits = (mantissa & ((1ULL << 52) - 1)) |
+           ((uint64_t)(exponent + 1023) << 52) |
+           ((uint64_t)_negative << 63);
+    memcpy(_value, &bits, sizeof(bits));
+
+    return result;
+}
+
+/*
+d_string_internal_match_word
+  Returns true if `_p[0.._n)` equals the lowercase word `_word`, ignoring
+ASCII case.
+*/
+static bool
+d_string_internal_match_word
+(
+    const char* _p,
+    size_t      _n,
+    const char* _word
+)
+{
+    size_t i;
+
+    for (i = 0; i < _n; i++)
+    {
+        if ( (_word[i] == '\0') ||
+             ((_p[i] | 0x20) != _word[i]) )
+        {
+            return false;
+        }
+    }
+
+    return (_word[_n] == '\0');
+}
+
+/*
+d_string_internal_fast_double
+  Converts `_mantissa` x 10^`_exponent` to a double when both are exactly
+representable, so a single rounded multiplication or division gives the
+correctly rounded result (Clinger 1990). Returns false if the fast path
+does not apply.
+*/
+static bool
+d_string_internal_fast_double
+(
+    uint64_t _mantissa,
+    size_t   _significant,
+    int64_t  _exponent,
+    double*  _value
+)
+{
+#if ( defined(FLT_EVAL_METHOD) && (FLT_EVAL_METHOD == 0) )
+    double value;
+
+    if ( (_significant > 19)           ||
+         (_mantissa > (1ULL << 53))    ||
+         (_exponent < -22)             ||
+         (_exponent > 22 + 15) )
+    {
+        return false;
+    }
+
+    value = (double)_mantissa;
+
+    if (_exponent < 0)
+    {
+        value /= d_string_internal_pow10[-_exponent];
+    }
+    else if (_exponent <= 22)
+    {
+        value *= d_string_internal_pow10[_exponent];
+    }
+    else
+    {
+        // move the excess power into the mantissa while it stays exact
+        if ( _mantissa >
+             ( (1ULL << 53) /
+               (uint64_t)d_string_internal_pow10[_exponent - 22] ) )
+        {
+            return false;
+        }
+
+        value *= d_string_internal_pow10[_exponent - 22];
+        value *= d_string_internal_pow10[22];
+    }
+
+    *_value = value;
+
+    return true;
+#else
+    // excess precision in intermediates would round twice
+    (void)_mantissa;
+    (void)_significant;
+    (void)_exponent;
+    (void)_value;
+
+    return false;
+#endif
+}
+
+/*
+d_string_internal_log2_64
+  Returns floor(log2(`_x`)) for a non-zero 64-bit value.
+*/
+static D_INLINE int32_t
+d_string_internal_log2_64
+(
+    uint64_t _x
+)
+{
+#if defined(__GNUC__) || defined(__clang__)
+    return 63 - __builtin_clzll(_x);
+#elif defined(_MSC_VER) && (defined(_M_X64) || defined(_M_ARM64))
+    unsigned long index;
+
+    _BitScanReverse64(&index, _x);
+
+    return (int32_t)index;
+#else
+    int32_t log;
+
+    log = 0;
+
+    while (_x >>= 1)
+    {
+        log++;
+    }
+
+    return log;
+#endif
+}
+
+/*
+d_string_internal_scaled_double
+  Converts `_mantissa` x 10^`_exponent`, where `_mantissa` is a non-zero
+integer of `_digits` <= 17 decimal digits, to the nearest double using the
+same power-of-five tables as d_string_internal_shortest (Ryu). Handles the
+inputs the exact fast path cannot, such as the 17-digit output of "%.17g",
+without resorting to the decimal. Returns 0, or ERANGE if the value
+overflows to infinity or underflows to zero.
+*/
+static int
+d_string_internal_scaled_double
+(
+    uint64_t _mantissa,
+    int32_t  _digits,
+    int32_t  _exponent,
+    bool     _negative,
+    double*  _value
+)
+{
+    uint64_t bits;
+    uint64_t m2;
+    uint64_t ieee_m2;
+    int32_t  e2;
+    int32_t  j;
+    int32_t  ieee_e2;
+    int32_t  shift;
+    bool     trailing_zeros;
+    bool     round_up;
+    int      result;
+
+    result = 0;
+
+    if (_digits + _exponent <= -324)
+    {
+        ieee_e2 = 0;
+        ieee_m2 = 0;
+        result  = ERANGE;
+    }
+    else if (_digits + _exponent >= 310)
+    {
+        ieee_e2 = 0x7FF;
+        ieee_m2 = 0;
+        result  = ERANGE;
+    }
+    else
+    {
+        // take the top 54 bits of the product, noting whether it was exact
+        if (_exponent >= 0)
+        {
+            e2 = d_string_internal_log2_64(_mantissa) + _exponent +
+                 (D_STRING_INTERNAL_POW5_BITS(_exponent) - 1) - 53;
+            j  = e2 - _exponent - D_STRING_INTERNAL_POW5_BITS(_exponent) + 125;
+            m2 = d_string_internal_mul_shift(_mantissa,
+                                             d_string_internal_pow5[_exponent],
+                                             (unsigned)j);
+            trailing_zeros = ( (e2 < _exponent) ||
+                               ( (e2 - _exponent < 64) &&
+                                 ( (_mantissa &
+                                    ((1ULL << (e2 - _exponent)) - 1)) == 0 ) ) );
+        }
+        else
+        {
+            e2 = d_string_internal_log2_64(_mantissa) + _exponent -
+                 D_STRING_INTERNAL_POW5_BITS(-_exponent) - 53;
+            j  = e2 - _exponent + D_STRING_INTERNAL_POW5_BITS(-_exponent) - 1 +
+                 125;
+            m2 = d_string_internal_mul_shift(_mantissa,
+                                             d_string_internal_pow5_inv[-_exponent],
+                                             (unsigned)j);
+            trailing_zeros = (d_string_internal_pow5_factor(_mantissa) >=
+                              (unsigned)-_exponent);
+        }
+
+        ieee_e2 = e2 + 1023 + d_string_internal_log2_64(m2);
+        ieee_e2 = (ieee_e2 < 0) ? 0 : ieee_e2;
+
+        if (ieee_e2 > 0x7FE)
+        {
+            ieee_e2 = 0x7FF;
+            ieee_m2 = 0;
+            result  = ERANGE;
+        }
+        else
+        {
+            // round the bits below the mantissa half to even
+            shift          = ((ieee_e2 == 0) ? 1 : ieee_e2) - e2 - 1023 - 52;
+            trailing_zeros = ( (trailing_zeros) &&
+                               ((m2 & ((1ULL << (shift - 1)) - 1)) == 0) );
+            round_up       = ( (((m2 >> (shift - 1)) & 1) != 0) &&
+                               ( (!trailing_zeros) ||
+                                 (((m2 >> shift) & 1) != 0) ) );
+            ieee_m2        = ((m2 >> shift) + round_up) & ((1ULL << 52) - 1);
+
+            // a carry out of the mantissa moves into the exponent
+            if ( (ieee_m2 == 0) &&
+                 (round_up) )
+            {
+                ieee_e2++;
+            }
+
+            if ( (ieee_e2 == 0) &&
+                 (ieee_m2 == 0) )
+            {
+                result = ERANGE;
+            }
+
+            if (ieee_e2 == 0x7FF)
+            {
+                result = ERANGE;
+            }
+        }
+    }
+
+    bits = ieee_m2 |
+           ((uint64_t)ieee_e2 << 52) |
+           ((uint64_t)_negative << 63);
+    memcpy(_value, &bits, sizeof(bits));
+
+    return result;
+}
+
+/*
+d_string_internal_parse_double
+  Parses the whole of `_p[0.._n)` as a decimal floating-point number,
+correctly rounded and independent of the locale. Accepts an optional sign,
+digits with an optional '.', an optional exponent, and the words "inf",
+"infinity" and "nan" in any case. Short inputs with a small exponent take
+one exact multiplication or division, other inputs of up to 17 significant
+digits are scaled with the Ryu tables, and only longer ones are rounded
+through a decimal. Returns 0, EINVAL for malformed text, or ERANGE if the
+value overflows or underflows.
+*/
+static int
+d_string_internal_parse_double
+(
+    const char* _p,
+    size_t      _n,
+    double*     _value
+)
+{
+    struct d_string_internal_decimal dec;
+    const char*                      p;
+    const char*                      end;
+    const char*                      digits;
+    const char*                      digits_end;
+    const char*                      digits_exp;
+    uint64_t                         mantissa;
+    int64_t                          exponent;
+    int64_t                          exp_part;
+    int64_t                          point;
+    size_t                           count;
+    size_t                           significant;
+    bool                             negative;
+    bool                             exp_negative;
+    bool                             saw_dot;
+    bool                             saw_digit;
+    double                           value;
+
+    p        = _p;
+    end      = _p + _n;
+    negative = false;
+
+    if ( (p < end) &&
+         ( (*p == '+') || (*p == '-') ) )
+    {
+        negative = (*p == '-');
+        p++;
+    }
+
+    if ( (p < end) &&
+         ((unsigned)(unsigned char)*p - '0' > 9) &&
+         (*p != '.') )
+    {
+        if ( d_string_internal_match_word(p, (size_t)(end - p), "inf") ||
+             d_string_internal_match_word(p, (size_t)(end - p), "infinity") )
+        {
+            *_value = negative ? -HUGE_VAL : HUGE_VAL;
+
+            return 0;
+        }
+
+        if (d_string_internal_match_word(p, (size_t)(end - p), "nan"))
+        {
+            *_value = negative ? -NAN : NAN;
+
+            return 0;
+        }
+
+        return EINVAL;
+    }
+
+    // mantissa: up to 19 significant digits accumulate exactly; `exponent`
+    // tracks the power of ten they are scaled by
+    digits      = p;
+    mantissa    = 0;
+    exponent    = 0;
+    significant = 0;
+    saw_dot     = false;
+    saw_digit   = false;
+
+    while (p < end)
+    {
+        if (*p == '.')
+        {
+            if (saw_dot)
+            {
+                return EINVAL;
+            }
+
+            saw_dot = true;
+            p++;
+
+            continue;
+        }
+
+        if ((unsigned)(unsigned char)*p - '0' > 9)
+        {
+            break;
+        }
+
+        saw_digit = true;
+
+        if ( (significant == 0) &&
+             (*p == '0') )
+        {
+            exponent -= saw_dot;
+            p++;
+
+            continue;
+        }
+
+        if (significant < 19)
+        {
+            count        = (size_t)(end - p);
+            count        = d_string_internal_scan_digits(
+                               p,
+                               (count < 19 - significant) ? count
+                                                          : 19 - significant,
+                               &mantissa);
+            significant += count;
+            exponent    -= saw_dot ? (int64_t)count : 0;
+            p           += count;
+
+            continue;
+        }
+
+        // digits past the 19th only move the decimal point
+        significant++;
+        exponent += !saw_dot;
+        p++;
+    }
+
+    if (!saw_digit)
+    {
+        return EINVAL;
+    }
+
+    digits_end = p;
+    exp_part   = 0;
+
+    // exponent part; values past any double's range saturate
+    if ( (p < end) &&
+         ( (*p == 'e') || (*p == 'E') ) )
+    {
+        p++;
+        exp_negative = false;
+
+        if ( (p < end) &&
+             ( (*p == '+') || (*p == '-') ) )
+        {
+            exp_negative = (*p == '-');
+            p++;
+        }
+
+        digits_exp = p;
+
+        while ( (p < end) &&
+                ((unsigned)(unsigned char)*p - '0' <= 9) )
+        {
+            if (exp_part < 100000)
+            {
+                exp_part = (exp_part * 10) + (*p - '0');
+            }
+
+            p++;
+        }
+
+        if (p == digits_exp)
+        {
+            return EINVAL;
+        }
+
+        exp_part = exp_negative ? -exp_part : exp_part;
+    }
+
+    if (p != end)
+    {
+        return EINVAL;
+    }
+
+    if (mantissa == 0)
+    {
+        *_value = negative ? -0.0 : 0.0;
+
+        return 0;
+    }
+
+    if (d_string_internal_fast_double(mantissa,
+                                      significant,
+                                      exponent + exp_part,
+                                      &value))
+    {
+        *_value = negative ? -value : value;
+
+        return 0;
+    }
+
+    if (significant <= 17)
+    {
+        return d_string_internal_scaled_double(mantissa,
+                                               (int32_t)significant,
+                                               (int32_t)(exponent + exp_part),
+                                               negative,
+                                               _value);
+    }
+
+    // exact path: rebuild the digits as a decimal and round it
+    dec.nd    = 0;
+    dec.trunc = false;
+    point     = 0;
+    saw_dot   = false;
+
+    for (p = digits; p < digits_end; p++)
+    {
+        if (*p == '.')
+        {
+            saw_dot = true;
+
+            continue;
+        }
+
+        if ( (*p == '0') &&
+             (dec.nd == 0) )
+        {
+            point -= saw_dot;
+
+            continue;
+        }
+
+        point += !saw_dot;
+
+        if (dec.nd < D_STRING_INTERNAL_DEC_DIGITS)
+        {
+            dec.d[dec.nd++] = (uint8_t)(*p - '0');
+        }
+        else if (*p != '0')
+        {
+            dec.trunc = true;
+        }
+    }
+
+    // anything this far out is already past a double's range
+    point += exp_part;
+    dec.dp = (point >  100000) ?  100000
+           : (point < -100000) ? -100000
+           : (int)point;
+
+    return d_string_internal_decimal_to_double(&dec, negative, _value);
 }
 
+
+/******************************************************************************
+* Numeric Conversion Functions
+******************************************************************************/
+
 /*
-d_string_assign_cstr
-  Assign content from C string.
+d_string_view_to_int64
+  Parses a view as a signed decimal integer. The whole view must be an
+optional '+' or '-' followed by one or more digits; whitespace is not
+skipped (see d_string_view_trimmed). The view need not be null-terminated,
+and the result does not depend on the current locale.
 
 Parameter(s):
-  _str:  d_string to modify.
-  _cstr: source C string.
+  _view:  view to parse.
+  _value: receives the parsed value; left unchanged on error.
 Return:
-  true if successful, false otherwise.
+  An integer value corresponding to either:
+  - 0, if the view was parsed successfully,
+  - EINVAL, if _value was NULL or the view is not a decimal integer, or
+  - ERANGE, if the value does not fit in an int64_t.
 */
-bool
-d_string_assign_cstr
+int
+d_string_view_to_int64
 (
-    struct d_string* _str,
-    const char*      _cstr
+    struct d_string_view _view,
+    int64_t*             _value
 )
 {
-    if ( (_str == NULL) || 
-         (_cstr == NULL) )
+    uint64_t magnitude;
+    bool     negative;
+    int      result;
+
+    if ( (_value == NULL) ||
+         (_view.text == NULL) ||
+         (_view.size == 0) )
     {
-        return false;
+        return EINVAL;
     }
 
-    return (d_string_copy_cstr_s(_str, _cstr) == 0);
-}
+    negative = (_view.text[0] == '-');
 
-/*
-d_string_assign_buffer
-  Assign content from buffer.
+    if ( (negative) ||
+         (_view.text[0] == '+') )
+    {
+        _view.text++;
+        _view.size--;
+    }
 
-Parameter(s):
-  _str:    d_string to modify.
-  _buffer: source buffer.
-  _length: number of bytes to copy.
-Return:
-  true if successful, false otherwise.
-*/
-bool
-d_string_assign_buffer
-(
-    struct d_string* _str,
-    const char*      _buffer,
-    size_t           _length
-)
-{
-    if ( (_str == NULL) || 
-         (_buffer == NULL) )
+    result = d_string_internal_parse_uint(_view.text, _view.size, &magnitude);
+
+    if (result != 0)
     {
-        return false;
+        return result;
     }
 
-    if (!d_string_internal_grow(_str, _length + 1))
+    if (magnitude > ((uint64_t)INT64_MAX + negative))
     {
-        return false;
+        return ERANGE;
     }
 
-    d_memcpy(_str->text, _buffer, _length);
-    _str->text[_length] = '\0';
-    _str->size          = _length;
+    // negate in unsigned arithmetic so INT64_MIN does not overflow
+    *_value = negative ? (int64_t)(0 - magnitude) : (int64_t)magnitude;
 
-    return true;
+    return 0;
 }
 
 /*
-d_string_assign_char
-  Assign repeated character.
+d_string_view_to_uint64
+  Parses a view as an unsigned decimal integer. The whole view must be an
+optional '+' followed by one or more digits; whitespace is not skipped and
+a '-' sign is rejected. The view need not be null-terminated.
 
 Parameter(s):
-  _str:   d_string to modify.
-  _count: number of times to repeat.
-  _c:     character to assign.
+  _view:  view to parse.
+  _value: receives the parsed value; left unchanged on error.
 Return:
-  true if successful, false otherwise.
+  An integer value corresponding to either:
+  - 0, if the view was parsed successfully,
+  - EINVAL, if _value was NULL or the view is not a decimal integer, or
+  - ERANGE, if the value does not fit in a uint64_t.
 */
-bool
-d_string_assign_char
+int
+d_string_view_to_uint64
 (
-    struct d_string* _str,
-    size_t           _count,
-    char             _c
+    struct d_string_view _view,
+    uint64_t*            _value
 )
 {
-    if (_str == NULL)
+    if ( (_value == NULL) ||
+         (_view.text == NULL) ||
+         (_view.size == 0) )
     {
-        return false;
+        return EINVAL;
     }
 
-    if (!d_string_internal_grow(_str, _count + 1))
+    if (_view.text[0] == '+')
     {
-        return false;
+        _view.text++;
+        _view.size--;
     }
 
-    d_memset(_str->text, _c, _count);
-    _str->text[_count] = '\0';
-    _str->size         = _count;
-
-    return true;
+    return d_string_internal_parse_uint(_view.text, _view.size, _value);
 }
 
-
-/******************************************************************************
-* Modification Functions - Append
-******************************************************************************/
-
 /*
-d_string_append
-  Append another d_string.
+d_string_view_to_double
+  Parses a view as a decimal floating-point number, correctly rounded to
+the nearest double. The whole view must be an optional sign, digits with at
+most one '.', and an optional exponent ("-12.5e-3"), or one of "inf",
+"infinity" and "nan" in any case. Hexadecimal floats and whitespace are not
+accepted. '.' is the decimal point whatever the current locale.
 
 Parameter(s):
-  _str:   d_string to modify.
-  _other: d_string to append.
+  _view:  view to parse.
+  _value: receives the parsed value; left unchanged on error.
 Return:
-  true if successful, false otherwise.
+  An integer value corresponding to either:
+  - 0, if the view was parsed successfully,
+  - EINVAL, if _value was NULL or the view is not a number, or
+  - ERANGE, if the value overflows to infinity or underflows to zero; the
+    infinity or zero is stored in `_value`.
 */
-bool
-d_string_append
+int
+d_string_view_to_double
 (
-    struct d_string*       _str,
-    const struct d_string* _other
+    struct d_string_view _view,
+    double*              _value
 )
 {
-    if ( (_str == NULL) || 
-         (_other == NULL) )
+    if ( (_value == NULL) ||
+         (_view.text == NULL) ||
+         (_view.size == 0) )
     {
-        return false;
+        return EINVAL;
     }
 
-    return (d_string_cat_s(_str, _other) == 0);
+    return d_string_internal_parse_double(_view.text, _view.size, _value);
 }
 
 /*
-d_string_append_cstr
-  Append C string.
+d_string_to_int64
+  Parses a d_string as a signed decimal integer (see
+d_string_view_to_int64).
 
 Parameter(s):
-  _str:  d_string to modify.
-  _cstr: C string to append.
+  _str:   d_string to parse.
+  _value: receives the parsed value; left unchanged on error.
 Return:
-  true if successful, false otherwise.
+  0 on success, EINVAL if a parameter was NULL or the text is not a decimal
+integer, or ERANGE if the value does not fit in an int64_t.
 */
-bool
-d_string_append_cstr
+int
+d_string_to_int64
 (
-    struct d_string* _str,
-    const char*      _cstr
+    const struct d_string* _str,
+    int64_t*               _value
 )
 {
-    if ( (_str == NULL) || 
-         (_cstr == NULL) )
-    {
-        return false;
-    }
-
-    return (d_string_cat_cstr_s(_str, _cstr) == 0);
+    return d_string_view_to_int64(d_string_view_of(_str), _value);
 }
 
 /*
-d_string_append_buffer
-  Append buffer of specified length.
+d_string_to_uint64
+  Parses a d_string as an unsigned decimal integer (see
+d_string_view_to_uint64).
 
 Parameter(s):
-  _str:    d_string to modify.
-  _buffer: buffer to append.
-  _length: number of bytes to append.
+  _str:   d_string to parse.
+  _value: receives the parsed value; left unchanged on error.
 Return:
-  true if successful, false otherwise.
+  0 on success, EINVAL if a parameter was NULL or the text is not a decimal
+integer, or ERANGE if the value does not fit in a uint64_t.
 */
-bool
-d_string_append_buffer
+int
+d_string_to_uint64
 (
-    struct d_string* _str,
-    const char*      _buffer,
-    size_t           _length
+    const struct d_string* _str,
+    uint64_t*              _value
 )
 {
-    size_t new_size;
-
-    if ( (_str == NULL) || 
-         (_buffer == NULL) )
-    {
-        return false;
-    }
-
-    new_size = _str->size + _length;
-
-    if (!d_string_internal_grow(_str, new_size + 1))
-    {
-        return false;
-    }
-
-    d_memcpy(_str->text + _str->size, _buffer, _length);
-    _str->text[new_size] = '\0';
-    _str->size           = new_size;
-
-    return true;
+    return d_string_view_to_uint64(d_string_view_of(_str), _value);
 }
 
 /*
-d_string_append_char
-  Append single character.
+d_string_to_double
+  Parses a d_string as a decimal floating-point number (see
+d_string_view_to_double).
 
 Parameter(s):
-  _str: d_string to modify.
-  _c:   character to append.
+  _str:   d_string to parse.
+  _value: receives the parsed value.
 Return:
-  true if successful, false otherwise.
+  0 on success, EINVAL if a parameter was NULL or the text is not a number,
+or ERANGE if the value overflows or underflows.
 */
-bool
-d_string_append_char
+int
+d_string_to_double
 (
-    struct d_string* _str,
-    char             _c
+    const struct d_string* _str,
+    double*                _value
 )
 {
-    size_t new_size;
-
-    if (_str == NULL)
-    {
-        return false;
-    }
-
-    new_size = _str->size + 1;
-
-    if (!d_string_internal_grow(_str, new_size + 1))
-    {
-        return false;
-    }
-
-    _str->text[_str->size] = _c;
-    _str->text[new_size]   = '\0';
-    _str->size             = new_size;
-
-    return true;
+    return d_string_view_to_double(d_string_view_of(_str), _value);
 }
 
 /*
-d_string_append_formatted
-  Append printf-style formatted text.
+d_string_append_int
+  Appends the decimal representation of a signed integer.
 
 Parameter(s):
-  _str:    d_string to modify.
-  _format: format string.
-  ...:     format arguments.
+  _str:   d_string to modify.
+  _value: value to append.
 Return:
-  true if successful, false otherwise.
+  true if successful, false if _str was NULL or memory allocation failed.
 */
 bool
-d_string_append_formatted
+d_string_append_int
 (
     struct d_string* _str,
-    const char*      _format,
-    ...
+    int64_t          _value
 )
 {
-    va_list args;
-    va_list args_copy;
-    int     len;
-    size_t  new_size;
-
-    if ( (_str == NULL) || 
-         (_format == NULL) )
-    {
-        return false;
-    }
-
-    va_start(args, _format);
-    va_copy(args_copy, args);
-
-    len = vsnprintf(NULL, 0, _format, args);
-    va_end(args);
-
-    if (len < 0)
-    {
-        va_end(args_copy);
-
-        return false;
-    }
+    char  digits[21];
+    char* p;
 
-    new_size = _str->size + (size_t)len;
+    // negate in unsigned arithmetic so INT64_MIN does not overflow
+    p = d_string_internal_utoa( (_value < 0) ? (0 - (uint64_t)_value)
+                                             : (uint64_t)_value,
+                                digits + sizeof(digits),
+                                10,
+                                false );
 
-    if (!d_string_internal_grow(_str, new_size + 1))
+    if (_value < 0)
     {
-        va_end(args_copy);
-
-        return false;
+        *--p = '-';
     }
 
-    vsnprintf(_str->text + _str->size, (size_t)len + 1, _format, args_copy);
-    va_end(args_copy);
-
-    _str->size = new_size;
-
-    return true;
+    return d_string_append_buffer(_str,
+                                  p,
+                                  (size_t)(digits + sizeof(digits) - p));
 }
 
-
-/******************************************************************************
-* Modification Functions - Prepend
-******************************************************************************/
-
 /*
-d_string_prepend
-  Prepend another d_string.
+d_string_append_uint
+  Appends the decimal representation of an unsigned integer.
 
 Parameter(s):
   _str:   d_string to modify.
-  _other: d_string to prepend.
+  _value: value to append.
 Return:
-  true if successful, false otherwise.
+  true if successful, false if _str was NULL or memory allocation failed.
 */
 bool
-d_string_prepend
+d_string_append_uint
 (
-    struct d_string*       _str,
-    const struct d_string* _other
-)
-{
-    size_t new_size;
-
-    if ( (_str == NULL) || 
-         (_other == NULL) )
-    {
-        return false;
-    }
-
-    new_size = _str->size + _other->size;
-
-    if (!d_string_internal_grow(_str, new_size + 1))
-    {
-        return false;
-    }
-
-    // shift existing content
-    memmove(_str->text + _other->size, _str->text, _str->size + 1);
+    struct d_string* _str,
+    uint64_t         _value
+)
+{
+    char  digits[20];
+    char* p;
 
-    // copy prepend content
-    d_memcpy(_str->text, _other->text, _other->size);
-    _str->size = new_size;
+    p = d_string_internal_utoa(_value, digits + sizeof(digits), 10, false);
 
-    return true;
+    return d_string_append_buffer(_str,
+                                  p,
+                                  (size_t)(digits + sizeof(digits) - p));
 }
 
 /*
-d_string_prepend_cstr
-  Prepend C string.
+d_string_append_double
+  Appends the shortest decimal text that d_string_to_double (or strtod)
+reads back as exactly `_value`. Numbers with a decimal exponent from -6 to
+20 use plain notation ("0.1", "1234.5", "100"); others use exponent
+notation ("1e+21", "2.5e-7"). Non-finite values append "nan", "inf" or
+"-inf". The output does not depend on the current locale.
 
 Parameter(s):
-  _str:  d_string to modify.
-  _cstr: C string to prepend.
+  _str:   d_string to modify.
+  _value: value to append.
 Return:
-  true if successful, false otherwise.
+  true if successful, false if _str was NULL or memory allocation failed.
 */
 bool
-d_string_prepend_cstr
+d_string_append_double
 (
     struct d_string* _str,
-    const char*      _cstr
+    double           _value
 )
 {
-    size_t cstr_len;
-    size_t new_size;
+    char buf[D_STRING_INTERNAL_DTOA_MAX];
 
-    if ( (_str == NULL) || 
-         (_cstr == NULL) )
-    {
-        return false;
-    }
+    return d_string_append_buffer(_str,
+                                  buf,
+                                  d_string_internal_dtoa(_value, buf));
+}
 
-    cstr_len = strlen(_cstr);
-    new_size = _str->size + cstr_len;
 
-    if (!d_string_internal_grow(_str, new_size + 1))
+/******************************************************************************
+* Error String Functions
+******************************************************************************/
+
+/*
+d_string_error
+  Get error description as d_string.
+
+Parameter(s):
+  _errnum: error number.
+Return:
+  New d_string with error description, or NULL on allocation failure.
+*/
+struct d_string*
+d_string_error
+(
+    int _errnum
+)
+{
+    char buf[256];
+
+    if (d_strerror_r(_errnum, buf, sizeof(buf)) != 0)
     {
-        return false;
+        return d_string_new_from_cstr("Unknown error");
     }
 
-    memmove(_str->text + cstr_len, _str->text, _str->size + 1);
-    d_memcpy(_str->text, _cstr, cstr_len);
-    _str->size = new_size;
-
-    return true;
+    return d_string_new_from_cstr(buf);
 }
 
 /*
-d_string_prepend_char
-  Prepend single character.
+d_string_error_r
+  Thread-safe error string into provided d_string.
 
 Parameter(s):
-  _str: d_string to modify.
-  _c:   character to prepend.
+  _errnum: error number.
+  _str:    d_string to store error description.
 Return:
-  true if successful, false otherwise.
+  0 on success, error code otherwise.
 */
-bool
-d_string_prepend_char
+int
+d_string_error_r
 (
-    struct d_string* _str,
-    char             _c
+    int              _errnum,
+    struct d_string* _str
 )
 {
-    size_t new_size;
+    char buf[256];
+    int  result;
 
     if (_str == NULL)
     {
-        return false;
+        return EINVAL;
     }
 
-    new_size = _str->size + 1;
+    result = d_strerror_r(_errnum, buf, sizeof(buf));
 
-    if (!d_string_internal_grow(_str, new_size + 1))
+    if (result != 0)
     {
-        return false;
+        return result;
     }
 
-    memmove(_str->text + 1, _str->text, _str->size + 1);
-    _str->text[0] = _c;
-    _str->size    = new_size;
+    if (!d_string_assign_cstr(_str, buf))
+    {
+        return EINVAL;
+    }
 
-    return true;
+    return 0;
 }
 
 
 /******************************************************************************
-* Modification Functions - Insert
+* Formatted String Functions
 ******************************************************************************/
 
 /*
-d_string_insert
-  Insert d_string at index.
+d_string_printf
+  Create formatted d_string.
 
 Parameter(s):
-  _str:   d_string to modify.
-  _index: insertion point.
-  _other: d_string to insert.
+  _format: printf-style format string.
+  ...:     format arguments.
 Return:
-  true if successful, false otherwise.
+  New formatted d_string, or NULL on error.
 */
-bool
-d_string_insert
+struct d_string*
+d_string_printf
 (
-    struct d_string*       _str,
-    d_index                _index,
-    const struct d_string* _other
+    const char* _format, 
+    ...
 )
 {
-    size_t pos;
-    size_t new_size;
-
-    if ( (_str == NULL) || 
-         (_other == NULL) )
-    {
-        return false;
-    }
-
-    // special case: insert at end
-    if (_index == (d_index)_str->size)
-    {
-        return d_string_append(_str, _other);
-    }
-
-    if (!d_index_convert_safe(_index, _str->size, &pos))
-    {
-        return false;
-    }
-
-    new_size = _str->size + _other->size;
-
-    if (!d_string_internal_grow(_str, new_size + 1))
-    {
-        return false;
-    }
-
-    // shift content after insertion point
-    memmove(_str->text + pos + _other->size,
-            _str->text + pos,
-            _str->size - pos + 1);
+    va_list          args;
+    struct d_string* result;
 
-    // insert new content
-    d_memcpy(_str->text + pos, _other->text, _other->size);
-    _str->size = new_size;
+    va_start(args, _format);
+    result = d_string_vprintf(_format, args);
+    va_end(args);
 
-    return true;
+    return result;
 }
 
 /*
-d_string_insert_cstr
-  Insert C string at index.
+d_string_vprintf
+  Create formatted d_string with va_list.
 
 Parameter(s):
-  _str:   d_string to modify.
-  _index: insertion point.
-  _cstr:  C string to insert.
+  _format: printf-style format string.
+  _args:   va_list of arguments.
 Return:
-  true if successful, false otherwise.
+  New formatted d_string, or NULL on error.
 */
-bool
-d_string_insert_cstr
+struct d_string*
+d_string_vprintf
 (
-    struct d_string* _str,
-    d_index          _index,
-    const char*      _cstr
+    const char* _format,
+    va_list     _args
 )
 {
-    size_t pos;
-    size_t cstr_len;
-    size_t new_size;
+    struct d_string* result;
 
-    if ( (_str == NULL) || 
-         (_cstr == NULL) )
+    if (_format == NULL)
     {
-        return false;
+        return NULL;
     }
 
-    // special case: insert at end
-    if (_index == (d_index)_str->size)
-    {
-        return d_string_append_cstr(_str, _cstr);
-    }
+    result = d_string_new();
 
-    if (!d_index_convert_safe(_index, _str->size, &pos))
+    if (result == NULL)
     {
-        return false;
+        return NULL;
     }
 
-    cstr_len = strlen(_cstr);
-    new_size = _str->size + cstr_len;
-
-    if (!d_string_internal_grow(_str, new_size + 1))
+    if (d_string_internal_vformat(result, _format, _args) < 0)
     {
-        return false;
-    }
-
-    memmove(_str->text + pos + cstr_len,
-            _str->text + pos,
-            _str->size - pos + 1);
+        d_string_free(result);
 
-    d_memcpy(_str->text + pos, _cstr, cstr_len);
-    _str->size = new_size;
+        return NULL;
+    }
 
-    return true;
+    return result;
 }
 
 /*
-d_string_insert_char
-  Insert character at index.
+d_string_sprintf
+  Format into existing d_string.
 
 Parameter(s):
-  _str:   d_string to modify.
-  _index: insertion point.
-  _c:     character to insert.
+  _str:    d_string to format into (replaces content).
+  _format: printf-style format string.
+  ...:     format arguments.
 Return:
-  true if successful, false otherwise.
+  Number of characters written, or -1 on error. If `_str` or `_format` is
+  NULL, `_str` is left untouched; if formatting fails, `_str` is left empty.
 */
-bool
-d_string_insert_char
+int
+d_string_sprintf
 (
     struct d_string* _str,
-    d_index          _index,
-    char             _c
+    const char*      _format,
+    ...
 )
 {
-    size_t pos;
-    size_t new_size;
-
-    if (_str == NULL)
-    {
-        return false;
-    }
-
-    // special case: insert at end
-    if (_index == (d_index)_str->size)
-    {
-        return d_string_append_char(_str, _c);
-    }
+    va_list args;
+    int     len;
 
-    if (!d_index_convert_safe(_index, _str->size, &pos))
+    if ( (_str == NULL) || 
+         (_format == NULL) )
     {
-        return false;
+        return -1;
     }
 
-    new_size = _str->size + 1;
-
-    if (!d_string_internal_grow(_str, new_size + 1))
+    if (!d_string_internal_modified(_str, D_STRING_INTERNAL_SITE))
     {
-        return false;
+        return -1;
     }
 
-    memmove(_str->text + pos + 1,
-            _str->text + pos,
-            _str->size - pos + 1);
+    // reuse the existing buffer; the old contents are simply overwritten
+    _str->size = 0;
 
-    _str->text[pos] = _c;
-    _str->size      = new_size;
+    va_start(args, _format);
+    len = d_string_internal_vformat(_str, _format, args);
+    va_end(args);
 
-    return true;
+    return len;
 }
 
 
 /******************************************************************************
-* Modification Functions - Erase and Clear
+* String Builder Functions
 ******************************************************************************/
 
 /*
-d_string_erase
-  Erase characters from string.
-
-Parameter(s):
-  _str:   d_string to modify.
-  _index: starting index.
-  _count: number of characters to erase.
-Return:
-  true if successful, false otherwise.
+d_string_builder_internal_next
+  Makes the builder's tail a chunk with at least `_min` free bytes, reusing
+the chunk after the current tail if it is empty and large enough, and
+otherwise linking a new chunk of max(`_min`, chunk_size) bytes after the tail.
+Returns false if allocation fails; the builder is left unchanged.
 */
-bool
-d_string_erase
+static bool
+d_string_builder_internal_next
 (
-    struct d_string* _str,
-    d_index          _index,
-    size_t           _count
+    struct d_string_builder* _sb,
+    size_t                   _min
 )
 {
-    size_t pos;
-    size_t actual_count;
+    struct d_string_builder_chunk* chunk;
+    size_t                         capacity;
 
-    if (_str == NULL)
+    chunk = _sb->tail->next;
+
+    // chunks retained by d_string_builder_clear are reused in order
+    if ( (chunk != NULL) &&
+         (chunk->capacity >= _min) )
     {
-        return false;
+        _sb->tail = chunk;
+
+        return true;
     }
 
-    if (!d_index_convert_safe(_index, _str->size, &pos))
+    capacity = (_min > _sb->chunk_size) ? _min : _sb->chunk_size;
+
+    if (capacity > (SIZE_MAX - sizeof(struct d_string_builder_chunk)))
     {
         return false;
     }
 
-    // clamp count to available characters
-    actual_count = _count;
+    chunk = (struct d_string_builder_chunk*)D_MEMORY_ALLOC(
+                D_MEMORY_MODULE_STRING,
+                sizeof(struct d_string_builder_chunk) + capacity);
 
-    if (pos + actual_count > _str->size)
+    if (chunk == NULL)
     {
-        actual_count = _str->size - pos;
+        return false;
     }
 
-    // shift remaining content
-    memmove(_str->text + pos,
-            _str->text + pos + actual_count,
-            _str->size - pos - actual_count + 1);
+    chunk->data     = (char*)(chunk + 1);
+    chunk->size     = 0;
+    chunk->capacity = capacity;
+    chunk->next     = _sb->tail->next;
 
-    _str->size -= actual_count;
+    _sb->tail->next = chunk;
+    _sb->tail       = chunk;
 
     return true;
 }
 
 /*
-d_string_erase_char
-  Erase single character at index.
+d_string_builder_new
+  Creates an empty heap-allocated string builder.
 
 Parameter(s):
-  _str:   d_string to modify.
-  _index: index of character to erase.
+  _chunk_size: payload size of each chunk, in bytes, or 0 to use
+               D_STRING_BUILDER_CHUNK_SIZE.
 Return:
-  true if successful, false otherwise.
+  A pointer value corresponding to either:
+  - newly allocated d_string_builder, if successful, or
+  - NULL, if memory allocation failed.
 */
-bool
-d_string_erase_char
+struct d_string_builder*
+d_string_builder_new
 (
-    struct d_string* _str,
-    d_index          _index
+    size_t _chunk_size
 )
 {
-    return d_string_erase(_str, _index, 1);
-}
-
-/*
-d_string_clear
-  Clear string contents (set to empty).
+    struct d_string_builder* sb;
 
-Parameter(s):
-  _str: d_string to clear.
-Return:
-  (none)
-*/
-void
-d_string_clear
-(
-    struct d_string* _str
-)
-{
-    if (_str == NULL)
-    {
-        return;
-    }
+    sb = (struct d_string_builder*)D_MEMORY_ALLOC(D_MEMORY_MODULE_STRING,
+                                                  sizeof(struct d_string_builder));
 
-    if (_str->text != NULL)
+    if (sb == NULL)
     {
-        _str->text[0] = '\0';
+        return NULL;
     }
 
-    _str->size = 0;
+    d_string_builder_init(sb, _chunk_size, NULL, 0);
 
-    return;
+    return sb;
 }
 
-
-/******************************************************************************
-* Modification Functions - Replace
-******************************************************************************/
-
 /*
-d_string_replace
-  Replace portion of string with d_string.
+d_string_builder_init
+  Initializes a caller-owned string builder, optionally over caller-supplied
+storage. The storage is filled before any chunk is allocated and must outlive
+the builder; it is never freed by the builder.
 
 Parameter(s):
-  _str:         d_string to modify.
-  _index:       starting index of replacement.
-  _count:       number of characters to replace.
-  _replacement: d_string to insert.
+  _sb:          builder to initialize.
+  _chunk_size:  payload size of each allocated chunk, in bytes, or 0 to use
+                D_STRING_BUILDER_CHUNK_SIZE.
+  _buffer:      initial storage, or NULL.
+  _buffer_size: size of _buffer, in bytes.
 Return:
-  true if successful, false otherwise.
+  A boolean value corresponding to either:
+  - true, if the builder was initialized, or
+  - false, if _sb was NULL.
 */
 bool
-d_string_replace
+d_string_builder_init
 (
-    struct d_string*       _str,
-    d_index                _index,
-    size_t                 _count,
-    const struct d_string* _replacement
+    struct d_string_builder* _sb,
+    size_t                   _chunk_size,
+    void*                    _buffer,
+    size_t                   _buffer_size
 )
 {
-    size_t pos;
-    size_t actual_count;
-    size_t new_size;
-
-    if ( (_str == NULL) || 
-         (_replacement == NULL) )
-    {
-        return false;
-    }
-
-    if (!d_index_convert_safe(_index, _str->size, &pos))
+    if (_sb == NULL)
     {
         return false;
     }
 
-    // clamp count
-    actual_count = _count;
-
-    if (pos + actual_count > _str->size)
-    {
-        actual_count = _str->size - pos;
-    }
-
-    new_size = _str->size - actual_count + _replacement->size;
-
-    if (!d_string_internal_grow(_str, new_size + 1))
+    if (_buffer == NULL)
     {
-        return false;
+        _buffer_size = 0;
     }
 
-    // shift content after replacement region
-    memmove(_str->text + pos + _replacement->size,
-            _str->text + pos + actual_count,
-            _str->size - pos - actual_count + 1);
-
-    // copy replacement
-    d_memcpy(_str->text + pos, _replacement->text, _replacement->size);
-    _str->size = new_size;
+    _sb->first.next     = NULL;
+    _sb->first.data     = (char*)_buffer;
+    _sb->first.size     = 0;
+    _sb->first.capacity = _buffer_size;
+    _sb->tail           = &_sb->first;
+    _sb->size           = 0;
+    _sb->chunk_size     = (_chunk_size != 0) ? _chunk_size
+                                             : D_STRING_BUILDER_CHUNK_SIZE;
 
     return true;
 }
 
 /*
-d_string_replace_cstr
-  Replace portion of string with C string.
+d_string_builder_clear
+  Discards the builder's contents but keeps its chunks for reuse, so a
+builder that is cleared and refilled stops allocating once warmed up.
 
 Parameter(s):
-  _str:         d_string to modify.
-  _index:       starting index of replacement.
-  _count:       number of characters to replace.
-  _replacement: C string to insert.
+  _sb: builder to clear.
 Return:
-  true if successful, false otherwise.
+  (none)
 */
-bool
-d_string_replace_cstr
+void
+d_string_builder_clear
 (
-    struct d_string* _str,
-    d_index          _index,
-    size_t           _count,
-    const char*      _replacement
+    struct d_string_builder* _sb
 )
 {
-    size_t pos;
-    size_t actual_count;
-    size_t rep_len;
-    size_t new_size;
+    struct d_string_builder_chunk* chunk;
 
-    if ( (_str == NULL) || 
-         (_replacement == NULL) )
+    if (_sb == NULL)
     {
-        return false;
+        return;
     }
 
-    if (!d_index_convert_safe(_index, _str->size, &pos))
+    for (chunk = &_sb->first; chunk != NULL; chunk = chunk->next)
     {
-        return false;
+        chunk->size = 0;
     }
 
-    actual_count = _count;
+    _sb->tail = &_sb->first;
+    _sb->size = 0;
 
-    if (pos + actual_count > _str->size)
-    {
-        actual_count = _str->size - pos;
-    }
+    return;
+}
 
-    rep_len  = strlen(_replacement);
-    new_size = _str->size - actual_count + rep_len;
+/*
+d_string_builder_free
+  Frees a heap-allocated string builder and all of its chunks.
 
-    if (!d_string_internal_grow(_str, new_size + 1))
+Parameter(s):
+  _sb: builder to free.
+Return:
+  (none)
+*/
+void
+d_string_builder_free
+(
+    struct d_string_builder* _sb
+)
+{
+    if (_sb == NULL)
     {
-        return false;
+        return;
     }
 
-    memmove(_str->text + pos + rep_len,
-            _str->text + pos + actual_count,
-            _str->size - pos - actual_count + 1);
-
-    d_memcpy(_str->text + pos, _replacement, rep_len);
-    _str->size = new_size;
+    d_string_builder_free_contents(_sb);
+    D_MEMORY_FREE(_sb);
 
-    return true;
+    return;
 }
 
 /*
-d_string_replace_all
-  Replace all occurrences of substring.
+d_string_builder_free_contents
+  Frees the chunks of a string builder but not the builder itself, leaving it
+empty and ready for reuse. Caller-supplied storage is not freed.
 
 Parameter(s):
-  _str: d_string to modify.
-  _old: d_string to find and replace.
-  _new: d_string replacement.
+  _sb: builder whose chunks to free.
 Return:
-  true if successful, false otherwise.
+  (none)
 */
-bool
-d_string_replace_all
+void
+d_string_builder_free_contents
 (
-    struct d_string*       _str,
-    const struct d_string* _old,
-    const struct d_string* _new
+    struct d_string_builder* _sb
 )
 {
-    if ( (_str == NULL) || 
-         (_old == NULL) || 
-         (_new == NULL) ||
-         (_old->size == 0) )
+    struct d_string_builder_chunk* chunk;
+    struct d_string_builder_chunk* next;
+
+    if (_sb == NULL)
     {
-        return false;
+        return;
+    }
+
+    for (chunk = _sb->first.next; chunk != NULL; chunk = next)
+    {
+        next = chunk->next;
+        D_MEMORY_FREE(chunk);
     }
 
-    return d_string_replace_all_cstr(_str, _old->text, _new->text);
+    _sb->first.next = NULL;
+    _sb->first.size = 0;
+    _sb->tail       = &_sb->first;
+    _sb->size       = 0;
+
+    return;
 }
 
 /*
-d_string_replace_all_cstr
-  Replace all occurrences of C string.
+d_string_builder_append_buffer
+  Appends bytes to a string builder. Bytes are copied exactly once; when the
+current chunk fills, the remainder continues in the next chunk.
 
 Parameter(s):
-  _str: d_string to modify.
-  _old: C string to find and replace.
-  _new: C string replacement.
+  _sb:     builder to append to.
+  _buffer: bytes to append; may contain null bytes.
+  _length: number of bytes to append.
 Return:
-  true if successful, false otherwise.
+  A boolean value corresponding to either:
+  - true, if the bytes were appended, or
+  - false, if a parameter was NULL or memory allocation failed. Bytes that
+    fit before the failure remain appended.
 */
 bool
-d_string_replace_all_cstr
+d_string_builder_append_buffer
 (
-    struct d_string* _str,
-    const char*      _old,
-    const char*      _new
+    struct d_string_builder* _sb,
+    const char*              _buffer,
+    size_t                   _length
 )
 {
-    size_t           old_len;
-    size_t           new_len;
-    size_t           count;
-    size_t           new_size;
-    char*            search;
-    char*            found;
-    char*            write_ptr;
-    char*            read_ptr;
-    struct d_string* result;
+    struct d_string_builder_chunk* tail;
+    size_t                         n;
 
-    if ( (_str == NULL) || 
-         (_old == NULL) || 
-         (_new == NULL) )
+    if ( (_sb == NULL) ||
+         ( (_buffer == NULL) &&
+           (_length != 0) ) )
     {
         return false;
     }
 
-    old_len = strlen(_old);
-
-    if (old_len == 0)
+    while (_length != 0)
     {
-        return false;
-    }
+        tail = _sb->tail;
 
-    new_len = strlen(_new);
+        if (tail->size == tail->capacity)
+        {
+            if (!d_string_builder_internal_next(_sb, 1))
+            {
+                return false;
+            }
 
-    // count occurrences
-    count  = 0;
-    search = _str->text;
+            tail = _sb->tail;
+        }
 
-    while ((found = strstr(search, _old)) != NULL)
-    {
-        count++;
-        search = found + old_len;
+        n = tail->capacity - tail->size;
+
+        if (n > _length)
+        {
+            n = _length;
+        }
+
+        d_memcpy(tail->data + tail->size, _buffer, n);
+
+        tail->size += n;
+        _sb->size  += n;
+        _buffer    += n;
+        _length    -= n;
     }
 
-    // if no occurrences, nothing to do
-    if (count == 0)
+    return true;
+}
+
+/*
+d_string_builder_append_cstr
+  Appends a null-terminated C string to a string builder.
+
+Parameter(s):
+  _sb:   builder to append to.
+  _cstr: null-terminated string to append.
+Return:
+  A boolean value corresponding to either:
+  - true, if the string was appended, or
+  - false, if a parameter was NULL or memory allocation failed.
+*/
+bool
+d_string_builder_append_cstr
+(
+    struct d_string_builder* _sb,
+    const char*              _cstr
+)
+{
+    if (_cstr == NULL)
     {
-        return true;
+        return false;
     }
 
-    // calculate new size
-    new_size = _str->size + (count * new_len) - (count * old_len);
+    return d_string_builder_append_buffer(_sb, _cstr, strlen(_cstr));
+}
 
-    // create temporary result
-    result = d_string_new_with_capacity(new_size + 1);
+/*
+d_string_builder_append_char
+  Appends a single character to a string builder.
 
-    if (result == NULL)
+Parameter(s):
+  _sb: builder to append to.
+  _c:  character to append.
+Return:
+  A boolean value corresponding to either:
+  - true, if the character was appended, or
+  - false, if _sb was NULL or memory allocation failed.
+*/
+bool
+d_string_builder_append_char
+(
+    struct d_string_builder* _sb,
+    char                     _c
+)
+{
+    struct d_string_builder_chunk* tail;
+
+    if (_sb == NULL)
     {
         return false;
     }
 
-    // build result
-    read_ptr  = _str->text;
-    write_ptr = result->text;
+    tail = _sb->tail;
 
-    while ((found = strstr(read_ptr, _old)) != NULL)
+    // fast path: room in the current chunk
+    if (tail->size < tail->capacity)
     {
-        // copy text before match
-        size_t before_len = (size_t)(found - read_ptr);
-
-        d_memcpy(write_ptr, read_ptr, before_len);
-        write_ptr += before_len;
-
-        // copy replacement
-        d_memcpy(write_ptr, _new, new_len);
-        write_ptr += new_len;
+        tail->data[tail->size++] = _c;
+        _sb->size++;
 
-        read_ptr = found + old_len;
+        return true;
     }
 
-    // copy remaining text
-    strcpy(write_ptr, read_ptr);
-
-    // swap contents
-    free(_str->text);
-    _str->text = result->text;
-    _str->size = new_size;
-
-    _str->capacity = result->capacity;
-#endif
-
-    // free result struct (but not its text, which we've taken)
-    free(result);
-
-    return true;
+    return d_string_builder_append_buffer(_sb, &_c, 1);
 }
 
 /*
-d_string_replace_char
-  Replace all occurrences of a character.
+d_string_builder_append_string
+  Appends the contents of a d_string to a string builder.
 
 Parameter(s):
-  _str:      d_string to modify.
-  _old_char: character to replace.
-  _new_char: replacement character.
+  _sb:  builder to append to.
+  _str: d_string to append.
 Return:
-  true if successful, false otherwise.
+  A boolean value corresponding to either:
+  - true, if the string was appended, or
+  - false, if a parameter was NULL or memory allocation failed.
 */
 bool
-d_string_replace_char
+d_string_builder_append_string
 (
-    struct d_string* _str,
-    char             _old_char,
-    char             _new_char
+    struct d_string_builder* _sb,
+    const struct d_string*   _str
 )
 {
-    size_t i;
-
     if (_str == NULL)
     {
         return false;
     }
 
-    for (i = 0; i < _str->size; i++)
-    {
-        if (_str->text[i] == _old_char)
-        {
-            _str->text[i] = _new_char;
-        }
-    }
-
-    return true;
+    return d_string_builder_append_buffer(_sb, _str->text, _str->size);
 }
 
+/*
+d_string_builder_append_view
+  Appends the characters of a string view to a string builder.
 
+Parameter(s):
+  _sb:   builder to append to.
+  _view: view to append.
+Return:
+  A boolean value corresponding to either:
+  - true, if the view was appended, or
+  - false, if _sb was NULL or memory allocation failed.
+*/
+bool
+d_string_builder_append_view
+(
+    struct d_string_builder* _sb,
+    struct d_string_view     _view
+)
+{
+    return d_string_builder_append_buffer(_sb, _view.text, _view.size);
+}
 
-  true if successful, false if _str is NULL.
+/*
+d_string_builder_append_uint
+  Appends the decimal representation of an unsigned integer to a string
+builder.
+
+Parameter(s):
+  _sb:    builder to append to.
+  _value: value to append.
+Return:
+  A boolean value corresponding to either:
+  - true, if the value was appended, or
+  - false, if _sb was NULL or memory allocation failed.
 */
 bool
-d_string_to_lower
+d_string_builder_append_uint
 (
-    struct d_string* _str
+    struct d_string_builder* _sb,
+    uint64_t                 _value
 )
 {
-    if ( (_str == NULL) || 
-         (_str->text == NULL) )
-    {
-        return false;
-    }
+    char  digits[20];
+    char* p;
 
-    d_strlwr(_str->text);
+    p = d_string_internal_utoa(_value, digits + sizeof(digits), 10, false);
 
-    return true;
+    return d_string_builder_append_buffer(_sb,
+                                          p,
+                                          (size_t)(digits + sizeof(digits) - p));
 }
 
 /*
-d_string_to_upper
-  Convert string to uppercase in-place.
+d_string_builder_append_int
+  Appends the decimal representation of a signed integer to a string
+builder.
 
 Parameter(s):
-  _str: d_string to convert.
+  _sb:    builder to append to.
+  _value: value to append.
 Return:
-  true if successful, false if _str is NULL.
+  A boolean value corresponding to either:
+  - true, if the value was appended, or
+  - false, if _sb was NULL or memory allocation failed.
 */
 bool
-d_string_to_upper
+d_string_builder_append_int
 (
-    struct d_string* _str
+    struct d_string_builder* _sb,
+    int64_t                  _value
 )
 {
-    if ( (_str == NULL) || 
-         (_str->text == NULL) )
+    uint64_t magnitude;
+
+    if (_value >= 0)
     {
-        return false;
+        return d_string_builder_append_uint(_sb, (uint64_t)_value);
     }
 
-    d_strupr(_str->text);
+    // negate in unsigned arithmetic so INT64_MIN does not overflow
+    magnitude = (uint64_t)0 - (uint64_t)_value;
 
-    return true;
+    return ( d_string_builder_append_char(_sb, '-') &&
+             d_string_builder_append_uint(_sb, magnitude) );
 }
 
 /*
-d_string_lower
-  Return new lowercase copy of string.
+d_string_builder_append_double
+  Appends the shortest decimal text that reads back as exactly `_value` to a
+string builder (see d_string_append_double).
 
 Parameter(s):
-  _str: d_string to copy and convert.
+  _sb:    builder to append to.
+  _value: value to append.
 Return:
-  New lowercase d_string, or NULL if _str is NULL or allocation fails.
+  A boolean value corresponding to either:
+  - true, if the value was appended, or
+  - false, if _sb was NULL or memory allocation failed.
 */
-struct d_string*
-d_string_lower
+bool
+d_string_builder_append_double
 (
-    const struct d_string* _str
+    struct d_string_builder* _sb,
+    double                   _value
 )
 {
-    struct d_string* result;
+    char buf[D_STRING_INTERNAL_DTOA_MAX];
 
-    if (_str == NULL)
-    {
-        return NULL;
-    }
+    return d_string_builder_append_buffer(_sb,
+                                          buf,
+                                          d_string_internal_dtoa(_value, buf));
+}
 
-    result = d_string_new_copy(_str);
+/*
+d_string_builder_append_formatted
+  Appends printf-style formatted text to a string builder.
 
-    if (result == NULL)
-    {
-        return NULL;
-    }
+Parameter(s):
+  _sb:     builder to append to.
+  _format: printf-style format string.
+  ...:     format arguments.
+Return:
+  A boolean value corresponding to either:
+  - true, if the text was appended, or
+  - false, if a parameter was NULL, formatting failed, or memory allocation
+    failed.
+*/
+bool
+d_string_builder_append_formatted
+(
+    struct d_string_builder* _sb,
+    const char*              _format,
+    ...
+)
+{
+    va_list args;
+    bool    result;
 
-    d_string_to_lower(result);
+    va_start(args, _format);
+    result = d_string_builder_append_vformatted(_sb, _format, args);
+    va_end(args);
 
     return result;
 }
 
 /*
-d_string_upper
-  Return new uppercase copy of string.
+d_string_builder_append_vformatted
+  Appends printf-style formatted text to a string builder, with a va_list.
+Text is formatted directly into the current chunk when it fits; otherwise it
+is formatted once more into a chunk large enough to hold it whole.
 
 Parameter(s):
-  _str: d_string to copy and convert.
+  _sb:     builder to append to.
+  _format: printf-style format string.
+  _args:   va_list of arguments.
 Return:
-  New uppercase d_string, or NULL if _str is NULL or allocation fails.
+  A boolean value corresponding to either:
+  - true, if the text was appended, or
+  - false, if a parameter was NULL, formatting failed, or memory allocation
+    failed.
 */
-struct d_string*
-d_string_upper
+bool
+d_string_builder_append_vformatted
 (
-    const struct d_string* _str
+    struct d_string_builder* _sb,
+    const char*              _format,
+    va_list                  _args
 )
 {
-    struct d_string* result;
+    struct d_string_builder_chunk* tail;
+    va_list                        args_copy;
+    size_t                         avail;
+    int                            len;
 
-    if (_str == NULL)
+    if ( (_sb == NULL) ||
+         (_format == NULL) )
     {
-        return NULL;
+        return false;
     }
 
-    result = d_string_new_copy(_str);
+    tail  = _sb->tail;
+    avail = tail->capacity - tail->size;
 
-    if (result == NULL)
+    va_copy(args_copy, _args);
+
+    // vsnprintf needs room for a terminator it writes past the text
+    len = vsnprintf((avail != 0) ? (tail->data + tail->size) : NULL,
+                    avail,
+                    _format,
+                    _args);
+
+    if (len < 0)
     {
-        return NULL;
+        va_end(args_copy);
+
+        return false;
     }
 
-    d_string_to_upper(result);
+    if ((size_t)len >= avail)
+    {
+        if (!d_string_builder_internal_next(_sb, (size_t)len + 1))
+        {
+            va_end(args_copy);
 
-    return result;
-}
+            return false;
+        }
 
+        tail = _sb->tail;
+        vsnprintf(tail->data + tail->size, (size_t)len + 1, _format, args_copy);
+    }
 
-/******************************************************************************
-* Reversal Functions
-******************************************************************************/
+    va_end(args_copy);
+
+    tail->size += (size_t)len;
+    _sb->size  += (size_t)len;
+
+    return true;
+}
 
 /*
-d_string_reverse
-  Reverse string in-place.
+d_string_builder_size
+  Returns the number of bytes appended to a string builder.
 
 Parameter(s):
-  _str: d_string to reverse.
+  _sb: builder to query.
 Return:
-  true if successful, false if _str is NULL.
+  Total bytes appended, or 0 if _sb is NULL.
 */
-bool
-d_string_reverse
+size_t
+d_string_builder_size
 (
-    struct d_string* _str
+    const struct d_string_builder* _sb
 )
 {
-    if ( (_str == NULL) || 
-         (_str->text == NULL) )
-    {
-        return false;
-    }
+    return (_sb != NULL) ? _sb->size : 0;
+}
 
-    d_strrev(_str->text);
+/*
+d_string_builder_build
+  Materializes a string builder's contents into a new d_string whose capacity
+is exactly the content size plus its terminator. The builder is unchanged and
+may be appended to or built again.
 
-    return true;
+Parameter(s):
+  _sb: builder to materialize.
+Return:
+  A pointer value corresponding to either:
+  - newly allocated d_string, if successful, or
+  - NULL, if _sb was NULL or memory allocation failed.
+*/
+struct d_string*
+d_string_builder_build
+(
+    const struct d_string_builder* _sb
+)
+{
+    return d_string_builder_build_ex(NULL, _sb);
 }
 
 /*
-d_string_reversed
-  Return new reversed copy of string.
+d_string_builder_build_ex
+  Materializes a string builder's contents into a new d_string allocated from
+`_allocator` (see d_string_new_ex), with capacity for exactly the contents and
+their terminator. Large outputs can be placed in mapped, huge-page-backed
+memory by passing d_allocator_large.
 
 Parameter(s):
-  _str: d_string to copy and reverse.
+  _allocator: the allocator, or NULL for d_allocator_default.
+  _sb:        builder to materialize.
 Return:
-  New reversed d_string, or NULL if _str is NULL or allocation fails.
+  A pointer value corresponding to either:
+  - newly allocated d_string, if successful, or
+  - NULL, if _sb was NULL or memory allocation failed.
 */
 struct d_string*
-d_string_reversed
+d_string_builder_build_ex
 (
-    const struct d_string* _str
+    const struct d_allocator*      _allocator,
+    const struct d_string_builder* _sb
 )
 {
-    struct d_string* result;
+    const struct d_string_builder_chunk* chunk;
+    struct d_string*                     result;
+    char*                                out;
 
-    if (_str == NULL)
+    if ( (_sb == NULL) ||
+         (_sb->size == SIZE_MAX) )
     {
         return NULL;
     }
 
-    result = d_string_new_copy(_str);
+    result = d_string_new_ex(_allocator, _sb->size + 1);
 
     if (result == NULL)
     {
         return NULL;
     }
 
-    d_string_reverse(result);
+    out = result->text;
+
+    for (chunk = &_sb->first; chunk != NULL; chunk = chunk->next)
+    {
+        if (chunk->size != 0)
+        {
+            d_memcpy(out, chunk->data, chunk->size);
+            out += chunk->size;
+        }
+    }
+
+    *out         = '\0';
+    result->size = _sb->size;
 
     return result;
 }
 
+/*
+d_string_builder_write
+  Writes a string builder's contents to a file descriptor chunk by chunk,
+without materializing them. Short writes are resumed and writes interrupted
+by a signal are retried.
+
+Parameter(s):
+  _sb: builder to write.
+  _fd: file descriptor to write to.
+Return:
+  Number of bytes written, or -1 on error (with errno set by d_write).
+*/
+ssize_t
+d_string_builder_write
+(
+    const struct d_string_builder* _sb,
+    int                            _fd
+)
+{
+    const struct d_string_builder_chunk* chunk;
+    const char*                          p;
+    size_t                               remaining;
+    size_t                               total;
+    ssize_t                              written;
+
+    if (_sb == NULL)
+    {
+        errno = EINVAL;
+
+        return -1;
+    }
+
+    total = 0;
+
+    for (chunk = &_sb->first; chunk != NULL; chunk = chunk->next)
+    {
+        p         = chunk->data;
+        remaining = chunk->size;
+
+        while (remaining != 0)
+        {
+            written = d_write(_fd, p, remaining);
+
+            if (written < 0)
+            {
+                if (errno == EINTR)
+                {
+                    continue;
+                }
+
+                return -1;
+            }
+
+            p         += written;
+            remaining -= (size_t)written;
+            total     += (size_t)written;
+        }
+    }
+
+    return (ssize_t)total;
+}
+
 
 /******************************************************************************
-* Trimming Functions
+* String Interning Functions
 ******************************************************************************/
 
+// D_STRING_INTERN_ALIGN
+//   constant: alignment, in bytes, of every allocation carved from an intern
+// table's arena blocks.
+#define D_STRING_INTERN_ALIGN 16
+
+// D_STRING_INTERN_MIN_SLOTS
+//   constant: number of slots in a shard's index when it is first created.
+#define D_STRING_INTERN_MIN_SLOTS 16
+
+// d_string_intern_block
+//   struct: header of an arena block; interned strings follow it.
+struct d_string_intern_block
+{
+    struct d_string_intern_block* next;
+};
+
+// d_string_intern_slots
+//   struct: open-addressed index of a shard. Slots hold pointers to interned
+// d_strings and are only ever filled, never cleared, so readers may probe an
+// index without locking. A grown index replaces this one but is kept alive,
+// via `retired`, until the table is freed.
+struct d_string_intern_slots
+{
+    struct d_string_intern_slots* retired;  // previous, smaller index
+    size_t                        mask;     // slot count minus one
+    d_atomic_ptr                  slot[];
+};
+
+// d_string_intern_shard
+//   struct: one independently locked part of an intern table. Lookups read
+// `index` without the lock; inserts, growth and arena use take it.
+struct d_string_intern_shard
+{
+    d_atomic_ptr                  index;            // current slots
+    d_atomic_ullong               lookups;
+    d_atomic_ullong               bytes_saved;
+    d_mutex_t                     lock;
+    size_t                        count;
+    size_t                        bytes_interned;
+    size_t                        bytes_reserved;
+    struct d_string_intern_block* blocks;
+    char*                         cursor;           // next free arena byte
+    size_t                        remaining;        // bytes left at cursor
+    char                          pad[64];          // keeps shards apart
+};
+
+// d_string_intern_table
+//   struct: the shards of an intern table.
+struct d_string_intern_table
+{
+    struct d_string_intern_shard shards[D_STRING_INTERN_SHARDS];
+};
+
+/*
+d_string_intern_internal_match
+  Returns true if interned string `_entry` has hash `_hash` and content
+`_buffer` of length `_length`.
+*/
+static D_INLINE bool
+d_string_intern_internal_match
+(
+    const struct d_string* _entry,
+    uint64_t               _hash,
+    const char*            _buffer,
+    size_t                 _length
+)
+{
+    return ( (_entry->hash == (size_t)_hash) &&
+             (_entry->size == _length) &&
+             (memcmp(_entry->text, _buffer, _length) == 0) );
+}
+
 /*
-d_string_trim
-  Trim whitespace from both ends of string in-place.
-
-Parameter(s):
-  _str: d_string to trim.
-Return:
-  true if successful, false if _str is NULL.
+d_string_intern_internal_probe
+  Searches a shard index for content with the given hash. Safe without the
+shard lock: a concurrent insert is either seen whole or not at all.
 */
-bool
-d_string_trim
+static const struct d_string*
+d_string_intern_internal_probe
 (
-    struct d_string* _str
+    const struct d_string_intern_slots* _slots,
+    uint64_t                            _hash,
+    const char*                         _buffer,
+    size_t                              _length
 )
 {
-    size_t start;
-    size_t end;
-    size_t new_size;
-
-    if (_str == NULL)
-    {
-        return false;
-    }
-
-    if (_str->size == 0)
-    {
-        return true;
-    }
-
-    // find first non-whitespace
-    start = 0;
-
-    while ( (start < _str->size) && 
-            (isspace((unsigned char)_str->text[start])) )
-    {
-        start++;
-    }
+    const struct d_string* entry;
+    size_t                 i;
 
-    // all whitespace
-    if (start == _str->size)
+    if (_slots == NULL)
     {
-        _str->text[0] = '\0';
-        _str->size    = 0;
-
-        return true;
+        return NULL;
     }
 
-    // find last non-whitespace
-    end = _str->size - 1;
-
-    while ( (end > start) && 
-            (isspace((unsigned char)_str->text[end])) )
+    for (i = (size_t)_hash & _slots->mask; ; i = (i + 1) & _slots->mask)
     {
-        end--;
-    }
+        entry = (const struct d_string*)d_atomic_load_ptr_explicit(
+                    &_slots->slot[i], D_MEMORY_ORDER_ACQUIRE);
 
-    new_size = end - start + 1;
+        if (entry == NULL)
+        {
+            return NULL;
+        }
 
-    // shift content if needed
-    if (start > 0)
-    {
-        memmove(_str->text, _str->text + start, new_size);
+        if (d_string_intern_internal_match(entry, _hash, _buffer, _length))
+        {
+            return entry;
+        }
     }
+}
 
-    _str->text[new_size] = '\0';
-    _str->size           = new_size;
+/*
+d_string_intern_internal_saved
+  Records a hit on existing content of length `_length`: the memory a
+separate d_string would have cost, its struct plus any heap buffer.
+*/
+static D_INLINE void
+d_string_intern_internal_saved
+(
+    struct d_string_intern_shard* _shard,
+    size_t                        _length
+)
+{
+    d_atomic_fetch_add_ullong_explicit(
+        &_shard->bytes_saved,
+        sizeof(struct d_string) +
+            ((_length < D_STRING_SSO_CAPACITY) ? 0 : (_length + 1)),
+        D_MEMORY_ORDER_RELAXED);
 
-    return true;
+    return;
 }
 
 /*
-d_string_trim_left
-  Trim whitespace from left side of string in-place.
-
-Parameter(s):
-  _str: d_string to trim.
-Return:
-  true if successful, false if _str is NULL.
+d_string_intern_internal_alloc
+  Carves `_size` bytes from a shard's arena, starting a new block when the
+current one is exhausted. Must be called with the shard lock held.
 */
-bool
-d_string_trim_left
+static void*
+d_string_intern_internal_alloc
 (
-    struct d_string* _str
+    struct d_string_intern_shard* _shard,
+    size_t                        _size
 )
 {
-    size_t start;
-    size_t new_size;
+    struct d_string_intern_block* block;
+    size_t                        header;
+    size_t                        block_size;
+    void*                         result;
 
-    if (_str == NULL)
-    {
-        return false;
-    }
+    _size = (_size + (D_STRING_INTERN_ALIGN - 1)) &
+            ~(size_t)(D_STRING_INTERN_ALIGN - 1);
 
-    if (_str->size == 0)
+    if (_size > _shard->remaining)
     {
-        return true;
-    }
+        header = (sizeof(struct d_string_intern_block) +
+                  (D_STRING_INTERN_ALIGN - 1)) &
+                 ~(size_t)(D_STRING_INTERN_ALIGN - 1);
 
-    start = 0;
+        if (_size > (SIZE_MAX - header))
+        {
+            return NULL;
+        }
 
-    while ( (start < _str->size) && 
-            (isspace((unsigned char)_str->text[start])) )
-    {
-        start++;
-    }
+        block_size = header + _size;
 
-    if (start == _str->size)
-    {
-        _str->text[0] = '\0';
-        _str->size    = 0;
+        if (block_size < D_STRING_INTERN_BLOCK_SIZE)
+        {
+            block_size = D_STRING_INTERN_BLOCK_SIZE;
+        }
 
-        return true;
-    }
+        block = (struct d_string_intern_block*)D_MEMORY_ALLOC(D_MEMORY_MODULE_STRING,
+                                                              block_size);
 
-    if (start > 0)
-    {
-        new_size = _str->size - start;
-        memmove(_str->text, _str->text + start, new_size + 1);
-        _str->size = new_size;
+        if (block == NULL)
+        {
+            return NULL;
+        }
+
+        block->next     = _shard->blocks;
+        _shard->blocks  = block;
+        _shard->bytes_reserved += block_size;
+
+        // an oversized string fills its own block; keep the current one
+        if ((block_size - header) > _size)
+        {
+            _shard->cursor    = (char*)block + header;
+            _shard->remaining = block_size - header;
+        }
+        else
+        {
+            return (char*)block + header;
+        }
     }
 
-    return true;
+    result             = _shard->cursor;
+    _shard->cursor    += _size;
+    _shard->remaining -= _size;
+
+    return result;
 }
 
 /*
-d_string_trim_right
-  Trim whitespace from right side of string in-place.
-
-Parameter(s):
-  _str: d_string to trim.
-Return:
-  true if successful, false if _str is NULL.
+d_string_intern_internal_reserve
+  Ensures a shard's index can take one more string at a load factor of at
+most one half, publishing a grown index if needed. Must be called with the
+shard lock held.
 */
-bool
-d_string_trim_right
+static struct d_string_intern_slots*
+d_string_intern_internal_reserve
 (
-    struct d_string* _str
+    struct d_string_intern_shard* _shard
 )
 {
-    size_t end;
+    struct d_string_intern_slots* old_slots;
+    struct d_string_intern_slots* new_slots;
+    const struct d_string*        entry;
+    size_t                        count;
+    size_t                        i;
+    size_t                        j;
 
-    if (_str == NULL)
+    old_slots = (struct d_string_intern_slots*)d_atomic_load_ptr_explicit(
+                    &_shard->index, D_MEMORY_ORDER_RELAXED);
+
+    if ( (old_slots != NULL) &&
+         (((_shard->count + 1) * 2) <= (old_slots->mask + 1)) )
     {
-        return false;
+        return old_slots;
     }
 
-    if (_str->size == 0)
+    count = (old_slots != NULL) ? ((old_slots->mask + 1) * 2)
+                                : D_STRING_INTERN_MIN_SLOTS;
+
+    new_slots = (struct d_string_intern_slots*)D_MEMORY_CALLOC(D_MEMORY_MODULE_STRING,
+                    1,
+                    sizeof(struct d_string_intern_slots) +
+                    (count * sizeof(d_atomic_ptr)));
+
+    if (new_slots == NULL)
     {
-        return true;
+        return NULL;
     }
 
-    end = _str->size;
+    new_slots->retired = old_slots;
+    new_slots->mask    = count - 1;
 
-    while ( (end > 0) && 
-            (isspace((unsigned char)_str->text[end - 1])) )
+    // the new index is private until published, so plain stores suffice
+    if (old_slots != NULL)
     {
-        end--;
+        for (i = 0; i <= old_slots->mask; i++)
+        {
+            entry = (const struct d_string*)d_atomic_load_ptr_explicit(
+                        &old_slots->slot[i], D_MEMORY_ORDER_RELAXED);
+
+            if (entry == NULL)
+            {
+                continue;
+            }
+
+            j = entry->hash & new_slots->mask;
+
+            while (d_atomic_load_ptr_explicit(&new_slots->slot[j],
+                                              D_MEMORY_ORDER_RELAXED) != NULL)
+            {
+                j = (j + 1) & new_slots->mask;
+            }
+
+            d_atomic_store_ptr_explicit(&new_slots->slot[j],
+                                        (void*)entry,
+                                        D_MEMORY_ORDER_RELAXED);
+        }
     }
 
-    _str->text[end] = '\0';
-    _str->size      = end;
+    _shard->bytes_reserved += sizeof(struct d_string_intern_slots) +
+                              (count * sizeof(d_atomic_ptr));
 
-    return true;
+    d_atomic_store_ptr_explicit(&_shard->index,
+                                new_slots,
+                                D_MEMORY_ORDER_RELEASE);
+
+    return new_slots;
 }
 
 /*
-d_string_trim_chars
-  Trim specified characters from both ends.
-
-Parameter(s):
-  _str:   d_string to trim.
-  _chars: characters to trim.
-Return:
-  true if successful, false if parameters are NULL.
+d_string_intern_internal_insert
+  Slow path of interning: under the shard lock, finds the content or copies
+it into the arena and publishes it.
 */
-bool
-d_string_trim_chars
+static const struct d_string*
+d_string_intern_internal_insert
 (
-    struct d_string* _str,
-    const char*      _chars
+    struct d_string_intern_shard* _shard,
+    uint64_t                      _hash,
+    const char*                   _buffer,
+    size_t                        _length
 )
 {
-    size_t start;
-    size_t end;
-    size_t new_size;
+    struct d_string_intern_slots* slots;
+    struct d_string*              entry;
+    size_t                        i;
 
-    if ( (_str == NULL) || 
-         (_chars == NULL) )
+    if (d_mutex_lock(&_shard->lock) != D_MUTEX_SUCCESS)
     {
-        return false;
+        return NULL;
     }
 
-    if (_str->size == 0)
+    // another thread may have inserted it since the unlocked probe
+    entry = (struct d_string*)d_string_intern_internal_probe(
+                (const struct d_string_intern_slots*)
+                    d_atomic_load_ptr_explicit(&_shard->index,
+                                               D_MEMORY_ORDER_RELAXED),
+                _hash,
+                _buffer,
+                _length);
+
+    if (entry != NULL)
     {
-        return true;
+        d_mutex_unlock(&_shard->lock);
+        d_string_intern_internal_saved(_shard, _length);
+
+        return entry;
     }
 
-    // find first character not in _chars
-    start = 0;
+    slots = d_string_intern_internal_reserve(_shard);
+    entry = NULL;
 
-    while ( (start < _str->size) && 
-            (strchr(_chars, _str->text[start]) != NULL) )
+    if ( (slots != NULL) &&
+         (_length < (SIZE_MAX - sizeof(struct d_string))) )
     {
-        start++;
+        entry = (struct d_string*)d_string_intern_internal_alloc(
+                    _shard,
+                    sizeof(struct d_string) +
+                    ((_length < D_STRING_SSO_CAPACITY) ? 0 : (_length + 1)));
     }
 
-    if (start == _str->size)
+    if (entry != NULL)
     {
-        _str->text[0] = '\0';
-        _str->size    = 0;
+        d_string_internal_init(entry);
 
-        return true;
-    }
+        if (_length >= D_STRING_SSO_CAPACITY)
+        {
+            entry->text     = (char*)(entry + 1);
+            entry->capacity = _length + 1;
+        }
 
-    // find last character not in _chars
-    end = _str->size - 1;
+        if (_length != 0)
+        {
+            d_memcpy(entry->text, _buffer, _length);
+        }
 
-    while ( (end > start) && 
-            (strchr(_chars, _str->text[end]) != NULL) )
-    {
-        end--;
-    }
+        entry->text[_length] = '\0';
+        entry->size          = _length;
+        entry->growth        = D_STRING_GROWTH_EXACT;
+        entry->hash          = (size_t)_hash;
+        entry->flags         = D_STRING_FLAG_HASHED;
 
-    new_size = end - start + 1;
+        for (i = (size_t)_hash & slots->mask;
+             d_atomic_load_ptr_explicit(&slots->slot[i],
+                                        D_MEMORY_ORDER_RELAXED) != NULL;
+             i = (i + 1) & slots->mask)
+        {
+        }
 
-    if (start > 0)
-    {
-        memmove(_str->text, _str->text + start, new_size);
+        // release: readers that see the pointer see the finished string
+        d_atomic_store_ptr_explicit(&slots->slot[i],
+                                    entry,
+                                    D_MEMORY_ORDER_RELEASE);
+
+        _shard->count++;
+        _shard->bytes_interned += _length;
     }
 
-    _str->text[new_size] = '\0';
-    _str->size           = new_size;
+    d_mutex_unlock(&_shard->lock);
 
-    return true;
+    return entry;
 }
 
 /*
-d_string_trimmed
-  Return new trimmed copy of string.
+d_string_intern_internal_shard
+  Selects the shard responsible for a hash. Uses the high half of the hash so
+that shard choice and slot choice are independent.
+*/
+static D_INLINE struct d_string_intern_shard*
+d_string_intern_internal_shard
+(
+    struct d_string_intern_table* _table,
+    uint64_t                      _hash
+)
+{
+    return &_table->shards[(size_t)(_hash >> 32) &
+                           (D_STRING_INTERN_SHARDS - 1)];
+}
+
+/*
+d_string_intern_table_new
+  Creates an empty string intern table.
 
 Parameter(s):
-  _str: d_string to copy and trim.
+  (none)
 Return:
-  New trimmed d_string, or NULL if _str is NULL or allocation fails.
+  A pointer value corresponding to either:
+  - newly allocated intern table, if successful, or
+  - NULL, if memory allocation or lock initialization failed.
 */
-struct d_string*
-d_string_trimmed
+struct d_string_intern_table*
+d_string_intern_table_new
 (
-    const struct d_string* _str
+    void
 )
 {
-    struct d_string* result;
+    struct d_string_intern_table* table;
+    size_t                        i;
 
-    if (_str == NULL)
+    table = (struct d_string_intern_table*)D_MEMORY_CALLOC(D_MEMORY_MODULE_STRING,
+                1,
+                sizeof(struct d_string_intern_table));
+
+    if (table == NULL)
     {
         return NULL;
     }
 
-    result = d_string_new_copy(_str);
-
-    if (result == NULL)
+    for (i = 0; i < D_STRING_INTERN_SHARDS; i++)
     {
-        return NULL;
-    }
+        d_atomic_init_ptr(&table->shards[i].index, NULL);
+        d_atomic_init_ullong(&table->shards[i].lookups, 0);
+        d_atomic_init_ullong(&table->shards[i].bytes_saved, 0);
 
-    d_string_trim(result);
+        if (d_mutex_init(&table->shards[i].lock) != D_MUTEX_SUCCESS)
+        {
+            while (i-- > 0)
+            {
+                d_mutex_destroy(&table->shards[i].lock);
+            }
 
-    return result;
+            D_MEMORY_FREE(table);
+
+            return NULL;
+        }
+    }
+
+    return table;
 }
 
 /*
-d_string_trimmed_left
-  Return new left-trimmed copy of string.
+d_string_intern_table_free
+  Frees an intern table and every string interned in it. No other thread may
+use the table, or any handle it returned, concurrently or afterwards.
 
 Parameter(s):
-  _str: d_string to copy and trim.
+  _table: intern table to free.
 Return:
-  New trimmed d_string, or NULL if _str is NULL or allocation fails.
+  (none)
 */
-struct d_string*
-d_string_trimmed_left
+void
+d_string_intern_table_free
 (
-    const struct d_string* _str
+    struct d_string_intern_table* _table
 )
 {
-    struct d_string* result;
+    struct d_string_intern_shard* shard;
+    struct d_string_intern_block* block;
+    struct d_string_intern_slots* slots;
+    void*                         next;
+    size_t                        i;
 
-    if (_str == NULL)
+    if (_table == NULL)
     {
-        return NULL;
+        return;
     }
 
-    result = d_string_new_copy(_str);
+    for (i = 0; i < D_STRING_INTERN_SHARDS; i++)
+    {
+        shard = &_table->shards[i];
+
+        for (block = shard->blocks; block != NULL; block = next)
+        {
+            next = block->next;
+            D_MEMORY_FREE(block);
+        }
+
+        slots = (struct d_string_intern_slots*)d_atomic_load_ptr_explicit(
+                    &shard->index, D_MEMORY_ORDER_RELAXED);
+
+        for (; slots != NULL; slots = next)
+        {
+            next = slots->retired;
+            D_MEMORY_FREE(slots);
+        }
 
-    if (result == NULL)
-    {
-        return NULL;
+        d_mutex_destroy(&shard->lock);
     }
 
-    d_string_trim_left(result);
+    D_MEMORY_FREE(_table);
 
-    return result;
+    return;
 }
 
 /*
-d_string_trimmed_right
-  Return new right-trimmed copy of string.
+d_string_intern_buffer
+  Returns the canonical interned d_string with the given content, interning
+a copy of it first if the table does not hold it yet. Lookups of content
+that is already interned take no lock. Thread-safe.
 
 Parameter(s):
-  _str: d_string to copy and trim.
+  _table:  intern table to use.
+  _buffer: content to intern; may contain null bytes.
+  _length: length of _buffer, in bytes.
 Return:
-  New trimmed d_string, or NULL if _str is NULL or allocation fails.
+  A pointer value corresponding to either:
+  - the canonical d_string for the content, valid until the table is freed,
+    or
+  - NULL, if a parameter was NULL or memory allocation failed.
 */
-struct d_string*
-d_string_trimmed_right
+const struct d_string*
+d_string_intern_buffer
 (
-    const struct d_string* _str
+    struct d_string_intern_table* _table,
+    const char*                   _buffer,
+    size_t                        _length
 )
 {
-    struct d_string* result;
+    struct d_string_intern_shard* shard;
+    const struct d_string*        entry;
+    uint64_t                      hash;
 
-    if (_str == NULL)
+    if ( (_table == NULL) ||
+         ( (_buffer == NULL) &&
+           (_length != 0) ) )
     {
         return NULL;
     }
 
-    result = d_string_new_copy(_str);
-
-    if (result == NULL)
+    if (_buffer == NULL)
     {
-        return NULL;
+        _buffer = "";
     }
 
-    d_string_trim_right(result);
+    hash  = d_string_hash_bytes(_buffer, _length);
+    shard = d_string_intern_internal_shard(_table, hash);
 
-    return result;
-}
+    d_atomic_fetch_add_ullong_explicit(&shard->lookups,
+                                       1,
+                                       D_MEMORY_ORDER_RELAXED);
 
+    entry = d_string_intern_internal_probe(
+                (const struct d_string_intern_slots*)
+                    d_atomic_load_ptr_explicit(&shard->index,
+                                               D_MEMORY_ORDER_ACQUIRE),
+                hash,
+                _buffer,
+                _length);
 
-/******************************************************************************
-* Tokenization Functions
-******************************************************************************/
+    if (entry != NULL)
+    {
+        d_string_intern_internal_saved(shard, _length);
+
+        return entry;
+    }
+
+    return d_string_intern_internal_insert(shard, hash, _buffer, _length);
+}
 
 /*
-d_string_tokenize
-  Thread-safe string tokenization.
+d_string_intern_cstr
+  Interns a null-terminated C string. See d_string_intern_buffer.
 
 Parameter(s):
-  _str:     d_string to tokenize (NULL to continue).
-  _delim:   delimiter characters.
-  _saveptr: save state pointer.
+  _table: intern table to use.
+  _cstr:  null-terminated string to intern.
 Return:
-  Pointer to next token, or NULL if no more tokens.
+  The canonical d_string for the content, or NULL on error.
 */
-char*
-d_string_tokenize
+const struct d_string*
+d_string_intern_cstr
 (
-    struct d_string* _str,
-    const char*      _delim,
-    char**           _saveptr
+    struct d_string_intern_table* _table,
+    const char*                   _cstr
 )
 {
-    char* start;
-
-    if ( (_delim == NULL) || 
-         (_saveptr == NULL) )
+    if (_cstr == NULL)
     {
         return NULL;
     }
 
-    if (_str != NULL)
-    {
-        start = _str->text;
-    }
-    else
-    {
-        start = NULL;
-    }
-
-    return d_strtok_r(start, _delim, _saveptr);
+    return d_string_intern_buffer(_table, _cstr, strlen(_cstr));
 }
 
 /*
-d_string_split
-  Split string into array of d_strings.
+d_string_intern_string
+  Interns the contents of a d_string. See d_string_intern_buffer.
 
 Parameter(s):
-  _str:    d_string to split.
-  _delim:  delimiter characters.
-  _tokens: output array of d_strings (caller must free with d_string_split_free).
+  _table: intern table to use.
+  _str:   d_string whose contents to intern.
 Return:
-  Number of tokens, or 0 on error.
+  The canonical d_string for the content, or NULL on error.
 */
-size_t
-d_string_split
+const struct d_string*
+d_string_intern_string
 (
-    const struct d_string*  _str,
-    const char*             _delim,
-    struct d_string***      _tokens
+    struct d_string_intern_table* _table,
+    const struct d_string*        _str
 )
 {
-    char*             copy;
-    char*             saveptr;
-    char*             token;
-    size_t            count;
-    size_t            capacity;
-    struct d_string** result;
-    struct d_string** new_result;
-
-    if ( (_str == NULL) || 
-         (_delim == NULL) || 
-         (_tokens == NULL) )
+    if (_str == NULL)
     {
-        return 0;
+        return NULL;
     }
 
-    *_tokens = NULL;
+    return d_string_intern_buffer(_table, _str->text, _str->size);
+}
 
-    // make copy for tokenization
-    copy = d_strdup(_str->text);
+/*
+d_string_intern_view
+  Interns the characters of a string view. See d_string_intern_buffer.
 
-    if (copy == NULL)
-    {
-        return 0;
-    }
+Parameter(s):
+  _table: intern table to use.
+  _view:  view whose characters to intern.
+Return:
+  The canonical d_string for the content, or NULL on error.
+*/
+const struct d_string*
+d_string_intern_view
+(
+    struct d_string_intern_table* _table,
+    struct d_string_view          _view
+)
+{
+    return d_string_intern_buffer(_table, _view.text, _view.size);
+}
 
-    // initial allocation
-    capacity = 8;
-    result   = (struct d_string**)malloc(capacity * sizeof(struct d_string*));
+/*
+d_string_intern_find
+  Returns the canonical interned d_string with the given content without
+interning it. Takes no lock. Thread-safe.
 
-    if (result == NULL)
-    {
-        free(copy);
+Parameter(s):
+  _table:  intern table to search.
+  _buffer: content to look up; may contain null bytes.
+  _length: length of _buffer, in bytes.
+Return:
+  The canonical d_string for the content, or NULL if it is not interned or a
+  parameter was NULL.
+*/
+const struct d_string*
+d_string_intern_find
+(
+    struct d_string_intern_table* _table,
+    const char*                   _buffer,
+    size_t                        _length
+)
+{
+    struct d_string_intern_shard* shard;
+    uint64_t                      hash;
 
-        return 0;
+    if ( (_table == NULL) ||
+         ( (_buffer == NULL) &&
+           (_length != 0) ) )
+    {
+        return NULL;
     }
 
-    count   = 0;
-    saveptr = NULL;
-    token   = d_strtok_r(copy, _delim, &saveptr);
-
-    while (token != NULL)
+    if (_buffer == NULL)
     {
-        // grow array if needed
-        if (count >= capacity)
-        {
-            capacity  *= 2;
-            new_result = (struct d_string**)realloc(result,
-                                                    capacity * sizeof(struct d_string*));
-
-            if (new_result == NULL)
-            {
-                // cleanup on failure
-                for (size_t i = 0; i < count; i++)
-                {
-                    d_string_free(result[i]);
-                }
-
-                free(result);
-                free(copy);
-
-                return 0;
-            }
-
-            result = new_result;
-        }
-
-        // create d_string for token
-        result[count] = d_string_new_from_cstr(token);
-
-        if (result[count] == NULL)
-        {
-            for (size_t i = 0; i < count; i++)
-            {
-                d_string_free(result[i]);
-            }
-
-            free(result);
-            free(copy);
-
-            return 0;
-        }
-
-        count++;
-        token = d_strtok_r(NULL, _delim, &saveptr);
+        _buffer = "";
     }
 
-    free(copy);
-
-    *_tokens = result;
+    hash  = d_string_hash_bytes(_buffer, _length);
+    shard = d_string_intern_internal_shard(_table, hash);
 
-    return count;
+    return d_string_intern_internal_probe(
+               (const struct d_string_intern_slots*)
+                   d_atomic_load_ptr_explicit(&shard->index,
+                                              D_MEMORY_ORDER_ACQUIRE),
+               hash,
+               _buffer,
+               _length);
 }
 
 /*
-d_string_split_free
-  Free array of d_strings from d_string_split.
+d_string_intern_count
+  Returns the number of distinct strings interned in a table.
 
 Parameter(s):
-  _tokens: array of d_strings.
-  _count:  number of tokens in array.
+  _table: intern table to query.
 Return:
-  (none)
+  Number of distinct strings, or 0 if _table is NULL.
 */
-void
-d_string_split_free
+size_t
+d_string_intern_count
 (
-    struct d_string** _tokens,
-    size_t            _count
+    struct d_string_intern_table* _table
 )
 {
-    size_t i;
-
-    if (_tokens == NULL)
-    {
-        return;
-    }
+    struct d_string_intern_stats stats;
 
-    for (i = 0; i < _count; i++)
+    if (!d_string_intern_stats(_table, &stats))
     {
-        d_string_free(_tokens[i]);
+        return 0;
     }
 
-    free(_tokens);
-
-    return;
+    return stats.strings;
 }
 
-
-/******************************************************************************
-* Join Functions
-******************************************************************************/
-
 /*
-d_string_join
-  Join array of d_strings with delimiter.
+d_string_intern_stats
+  Collects an intern table's counters. Each shard is read consistently, but
+the table as a whole is not frozen, so totals taken while other threads
+intern are approximate.
 
 Parameter(s):
-  _strings:   array of d_string pointers.
-  _count:     number of strings in array.
-  _delimiter: delimiter to insert between strings.
+  _table: intern table to query.
+  _stats: receives the counters.
 Return:
-  New d_string with joined content, or NULL on error.
+  A boolean value corresponding to either:
+  - true, if the counters were collected, or
+  - false, if a parameter was NULL.
 */
-struct d_string*
-d_string_join
+bool
+d_string_intern_stats
 (
-    const struct d_string* const* _strings,
-    size_t                        _count,
-    const char*                   _delimiter
+    struct d_string_intern_table* _table,
+    struct d_string_intern_stats* _stats
 )
 {
-    size_t           total_len;
-    size_t           delim_len;
-    size_t           i;
-    struct d_string* result;
+    struct d_string_intern_shard* shard;
+    size_t                        i;
 
-    if ( (_strings == NULL) || 
-         (_count == 0) )
+    if ( (_table == NULL) ||
+         (_stats == NULL) )
     {
-        return d_string_new();
+        return false;
     }
 
-    delim_len = (_delimiter != NULL) ? strlen(_delimiter) : 0;
-
-    // calculate total length
-    total_len = 0;
+    d_memset(_stats, 0, sizeof(*_stats));
 
-    for (i = 0; i < _count; i++)
+    for (i = 0; i < D_STRING_INTERN_SHARDS; i++)
     {
-        if (_strings[i] != NULL)
-        {
-            total_len += _strings[i]->size;
-        }
+        shard = &_table->shards[i];
 
-        if (i < _count - 1)
-        {
-            total_len += delim_len;
-        }
-    }
+        d_mutex_lock(&shard->lock);
 
-    result = d_string_new_with_capacity(total_len + 1);
+        _stats->strings        += shard->count;
+        _stats->bytes_interned += shard->bytes_interned;
+        _stats->bytes_reserved += shard->bytes_reserved;
+        _stats->lookups        += (size_t)d_atomic_load_ullong_explicit(
+                                      &shard->lookups,
+                                      D_MEMORY_ORDER_RELAXED);
+        _stats->bytes_saved    += (size_t)d_atomic_load_ullong_explicit(
+                                      &shard->bytes_saved,
+                                      D_MEMORY_ORDER_RELAXED);
 
-    if (result == NULL)
-    {
-        return NULL;
+        d_mutex_unlock(&shard->lock);
     }
 
-    // build result
-    for (i = 0; i < _count; i++)
-    {
-        if (_strings[i] != NULL)
-        {
-            d_string_append(result, _strings[i]);
-        }
-
-        if ( (i < _count - 1) && 
-             (delim_len > 0) )
-        {
-            d_string_append_cstr(result, _delimiter);
-        }
-    }
+    // every other lookup added one string (or failed to allocate)
+    _stats->hits = (_stats->lookups > _stats->strings)
+                       ? (_stats->lookups - _stats->strings)
+                       : 0;
 
-    return result;
+    return true;
 }
 
-/*
-d_string_join_cstr
-  Join array of C strings with delimiter.
-
-Parameter(s):
-  _strings:   array of C string pointers.
-  _count:     number of strings in array.
-  _delimiter: delimiter to insert between strings.
-Return:
-  New d_string with joined content, or NULL on error.
-*/
-struct d_string*
-d_string_join_cstr
-(
-    const char* const* _strings,
-    size_t             _count,
-    const char*        _delimiter
-)
-{
-    size_t           total_len;
-    size_t           delim_len;
-    size_t           i;
-    struct d_string* result;
 
-    if ( (_strings == NULL) || 
-         (_count == 0) )
-    {
-        return d_string_new();
-    }
+/******************************************************************************
+* Multi-Pattern Matching Functions
+******************************************************************************/
 
-    delim_len = (_delimiter != NULL) ? strlen(_delimiter) : 0;
+// D_STRING_MATCHER_NONE
+//   constant: marks a state that spells no pattern, or has no output.
+#define D_STRING_MATCHER_NONE UINT32_MAX
+
+// D_STRING_MATCHER_HIT
+//   flag: set in a compiled transition whose target state has an output, so
+// the scan loop needs no second lookup per byte.
+#define D_STRING_MATCHER_HIT  0x80000000u
+
+// d_string_matcher
+//   struct: an Aho-Corasick automaton compiled to a dense DFA. Input bytes
+// are first mapped to classes, one per distinct (case-folded) byte occurring
+// in the patterns plus class 0 for all others, keeping the transition table
+// at `state_count * class_count` entries. Each transition holds its target's
+// row offset (state * class_count), plus D_STRING_MATCHER_HIT if a pattern
+// ends there. A matcher is never modified after it is built.
+struct d_string_matcher
+{
+    uint32_t*     next;           // transitions, indexed [row offset + class]
+    uint32_t*     out;            // longest pattern ending at each state
+    uint32_t*     term;           // pattern each state spells, if any
+    uint32_t*     dict;           // nearest proper suffix state with a term
+    uint32_t*     depth;          // length of the string each state spells
+    size_t*       lengths;        // length of each pattern
+    size_t        pattern_count;
+    size_t        state_count;
+    size_t        class_count;
+    unsigned      flags;
+    unsigned char classes[256];   // byte -> input class
+};
 
-    // calculate total length
-    total_len = 0;
+/*
+d_string_matcher_internal_build
+  Compiles a matcher from pattern views: a trie, then failure links by
+breadth-first search, folded into a complete transition table.
+*/
+static struct d_string_matcher*
+d_string_matcher_internal_build
+(
+    const struct d_string_view* _patterns,
+    size_t                      _count,
+    unsigned                    _flags
+)
+{
+    struct d_string_matcher* matcher;
+    uint32_t*                fail;
+    uint32_t*                queue;
+    uint32_t*                row;
+    size_t                   total;
+    size_t                   max_states;
+    size_t                   classes;
+    size_t                   head;
+    size_t                   tail;
+    size_t                   i;
+    size_t                   j;
+    size_t                   c;
+    uint32_t                 q;
+    uint32_t                 u;
+    uint32_t                 v;
+    unsigned char            b;
+
+    total = 0;
 
     for (i = 0; i < _count; i++)
     {
-        if (_strings[i] != NULL)
+        if ( (_patterns[i].size == 0) ||
+             (_patterns[i].text == NULL) ||
+             (_patterns[i].size > (UINT32_MAX - 2 - total)) )
         {
-            total_len += strlen(_strings[i]);
+            return NULL;
         }
 
-        if (i < _count - 1)
-        {
-            total_len += delim_len;
-        }
+        total += _patterns[i].size;
     }
 
-    result = d_string_new_with_capacity(total_len + 1);
+    matcher = (struct d_string_matcher*)D_MEMORY_CALLOC(D_MEMORY_MODULE_STRING,
+                                                        1,
+                                                        sizeof(struct d_string_matcher));
 
-    if (result == NULL)
+    if (matcher == NULL)
     {
         return NULL;
     }
 
+    matcher->flags         = _flags;
+    matcher->pattern_count = _count;
+
+    // assign an input class to every byte that occurs in a pattern
+    classes = 1;
+
     for (i = 0; i < _count; i++)
     {
-        if (_strings[i] != NULL)
+        for (j = 0; j < _patterns[i].size; j++)
         {
-            d_string_append_cstr(result, _strings[i]);
+            b = (unsigned char)_patterns[i].text[j];
+
+            if ( (_flags & D_STRING_MATCHER_IGNORE_CASE) &&
+                 (b >= 'A') &&
+                 (b <= 'Z') )
+            {
+                b |= 0x20;
+            }
+
+            if (matcher->classes[b] == 0)
+            {
+                matcher->classes[b] = (unsigned char)classes++;
+            }
         }
+    }
 
-        if ( (i < _count - 1) && 
-             (delim_len > 0) )
+    if (_flags & D_STRING_MATCHER_IGNORE_CASE)
+    {
+        for (b = 'A'; b <= 'Z'; b++)
         {
-            d_string_append_cstr(result, _delimiter);
+            matcher->classes[b] = matcher->classes[b | 0x20];
         }
     }
 
-    return result;
-}
+    matcher->class_count = classes;
+    max_states           = total + 1;
 
-/*
-d_string_concat
-  Concatenate multiple d_strings into one.
+    // row offsets must leave the hit bit free
+    if (max_states > ((size_t)D_STRING_MATCHER_HIT / classes))
+    {
+        D_MEMORY_FREE(matcher);
 
-Parameter(s):
-  _count: number of d_strings to concatenate.
-  ...:    d_string pointers to concatenate.
-Return:
-  New d_string with concatenated content, or NULL on error.
-*/
-struct d_string*
-d_string_concat
-(
-    size_t _count, 
-    ...
-)
-{
-    va_list                args;
-    size_t                 total_len;
-    size_t                 i;
-    const struct d_string* str;
-    struct d_string*       result;
+        return NULL;
+    }
 
-    if (_count == 0)
-    {
-        return d_string_new();
+    matcher->next    = (uint32_t*)D_MEMORY_CALLOC(D_MEMORY_MODULE_STRING,
+                                                  max_states * classes,
+                                                  sizeof(uint32_t));
+    matcher->out     = (uint32_t*)D_MEMORY_ALLOC(D_MEMORY_MODULE_STRING,
+                                                 max_states * sizeof(uint32_t));
+    matcher->term    = (uint32_t*)D_MEMORY_ALLOC(D_MEMORY_MODULE_STRING,
+                                                 max_states * sizeof(uint32_t));
+    matcher->dict    = (uint32_t*)D_MEMORY_CALLOC(D_MEMORY_MODULE_STRING,
+                                                  max_states,
+                                                  sizeof(uint32_t));
+    matcher->depth   = (uint32_t*)D_MEMORY_CALLOC(D_MEMORY_MODULE_STRING,
+                                                  max_states,
+                                                  sizeof(uint32_t));
+    matcher->lengths = (size_t*)D_MEMORY_ALLOC(D_MEMORY_MODULE_STRING,
+                                               (_count ? _count : 1) * sizeof(size_t));
+    fail             = (uint32_t*)D_MEMORY_CALLOC(D_MEMORY_MODULE_STRING,
+                                                  max_states,
+                                                  sizeof(uint32_t));
+    queue            = (uint32_t*)D_MEMORY_ALLOC(D_MEMORY_MODULE_STRING,
+                                                 max_states * sizeof(uint32_t));
+
+    if ( (matcher->next == NULL)    ||
+         (matcher->out == NULL)     ||
+         (matcher->term == NULL)    ||
+         (matcher->dict == NULL)    ||
+         (matcher->depth == NULL)   ||
+         (matcher->lengths == NULL) ||
+         (fail == NULL)             ||
+         (queue == NULL) )
+    {
+        D_MEMORY_FREE(fail);
+        D_MEMORY_FREE(queue);
+        d_string_matcher_free(matcher);
+
+        return NULL;
     }
 
-    // first pass: calculate total length
-    va_start(args, _count);
-    total_len = 0;
+    d_memset(matcher->term, 0xFF, max_states * sizeof(uint32_t));
+
+    // trie: a zero transition means "no child" until the links are built,
+    // which is unambiguous because no edge leads back to the root
+    matcher->state_count = 1;
 
     for (i = 0; i < _count; i++)
     {
-        str = va_arg(args, const struct d_string*);
+        q = 0;
 
-        if (str != NULL)
+        for (j = 0; j < _patterns[i].size; j++)
         {
-            total_len += str->size;
-        }
-    }
+            row = &matcher->next[(size_t)q * classes];
+            c   = matcher->classes[(unsigned char)_patterns[i].text[j]];
 
-    va_end(args);
+            if (row[c] == 0)
+            {
+                row[c] = (uint32_t)matcher->state_count;
+                matcher->depth[matcher->state_count] = matcher->depth[q] + 1;
+                matcher->state_count++;
+            }
 
-    result = d_string_new_with_capacity(total_len + 1);
+            q = row[c];
+        }
 
-    if (result == NULL)
-    {
-        return NULL;
+        // duplicate patterns report the first occurrence
+        if (matcher->term[q] == D_STRING_MATCHER_NONE)
+        {
+            matcher->term[q] = (uint32_t)i;
+        }
+
+        matcher->lengths[i] = _patterns[i].size;
     }
 
-    // second pass: concatenate
-    va_start(args, _count);
+    // failure links, breadth first; a state's row is completed when it is
+    // dequeued, by which time the rows of all shallower states are complete
+    head = 0;
+    tail = 0;
 
-    for (i = 0; i < _count; i++)
+    for (c = 0; c < classes; c++)
     {
-        str = va_arg(args, const struct d_string*);
+        v = matcher->next[c];
 
-        if (str != NULL)
+        if (v != 0)
         {
-            d_string_append(result, str);
+            queue[tail++] = v;
         }
     }
 
-    va_end(args);
-
-    return result;
-}
+    matcher->out[0] = D_STRING_MATCHER_NONE;
 
+    while (head < tail)
+    {
+        u   = queue[head++];
+        row = &matcher->next[(size_t)u * classes];
 
-/******************************************************************************
-* Validation Functions
-******************************************************************************/
+        for (c = 0; c < classes; c++)
+        {
+            v = row[c];
 
-/*
-d_string_is_valid
-  Check if d_string structure is valid.
+            if (v != 0)
+            {
+                fail[v]       = matcher->next[(size_t)fail[u] * classes + c];
+                queue[tail++] = v;
+            }
+            else
+            {
+                row[c] = matcher->next[(size_t)fail[u] * classes + c];
+            }
+        }
 
-Parameter(s):
-  _str: d_string to check.
-Return:
-  true if valid, false otherwise.
-*/
-bool
-d_string_is_valid
-(
-    const struct d_string* _str
-)
-{
-    if (_str == NULL)
-    {
-        return false;
+        matcher->dict[u] = (matcher->term[fail[u]] != D_STRING_MATCHER_NONE)
+                               ? fail[u]
+                               : matcher->dict[fail[u]];
+        matcher->out[u]  = (matcher->term[u] != D_STRING_MATCHER_NONE)
+                               ? matcher->term[u]
+                               : matcher->term[matcher->dict[u]];
     }
 
-    if (_str->text == NULL)
+    // compile transitions to row offsets tagged with the hit bit
+    for (i = 0; i < (matcher->state_count * classes); i++)
     {
-        return false;
+        v                = matcher->next[i];
+        matcher->next[i] = (uint32_t)(v * classes) |
+                           ( (matcher->out[v] != D_STRING_MATCHER_NONE)
+                                 ? D_STRING_MATCHER_HIT
+                                 : 0 );
     }
 
-    // verify null termination at reported size
-    if (_str->text[_str->size] != '\0')
-    {
-        return false;
-    }
+    D_MEMORY_FREE(fail);
+    D_MEMORY_FREE(queue);
 
-    return true;
+    return matcher;
 }
 
 /*
-d_string_is_ascii
-  Check if string contains only ASCII characters.
-
-Parameter(s):
-  _str: d_string to check.
-Return:
-  true if all ASCII, false otherwise.
+d_string_matcher_internal_leftmost
+  Finds the leftmost match starting at or after `_from`, preferring the
+longest pattern among those starting at the same position. After the first
+candidate is seen, scanning continues only while the automaton's current
+path still began at or before it, which is at most the longest pattern's
+length further.
 */
-bool
-d_string_is_ascii
+static bool
+d_string_matcher_internal_leftmost
 (
-    const struct d_string* _str
+    const struct d_string_matcher* _matcher,
+    const unsigned char*           _text,
+    size_t                         _size,
+    size_t                         _from,
+    struct d_string_match*         _match
 )
 {
-    size_t i;
+    const uint32_t* next;
+    size_t          classes;
+    size_t          best_start;
+    size_t          start;
+    size_t          i;
+    uint32_t        row;
+    uint32_t        q;
+    uint32_t        best;
+
+    next       = _matcher->next;
+    classes    = _matcher->class_count;
+    best       = D_STRING_MATCHER_NONE;
+    best_start = SIZE_MAX;
+    row        = 0;
+
+    for (i = _from; i < _size; i++)
+    {
+        row = next[row + _matcher->classes[_text[i]]];
+
+        if ( (best == D_STRING_MATCHER_NONE) &&
+             (!(row & D_STRING_MATCHER_HIT)) )
+        {
+            continue;
+        }
 
-    if ( (_str == NULL) || 
-         (_str->text == NULL) )
-    {
-        return false;
-    }
+        row &= ~D_STRING_MATCHER_HIT;
+        q    = (uint32_t)(row / classes);
 
-    for (i = 0; i < _str->size; i++)
-    {
-        if ((unsigned char)_str->text[i] > 127)
+        if (best != D_STRING_MATCHER_NONE)
         {
-            return false;
+            // every match still to come starts after the one found
+            if ((i + 1 - _matcher->depth[q]) > best_start)
+            {
+                break;
+            }
         }
+
+        if (_matcher->out[q] != D_STRING_MATCHER_NONE)
+        {
+            start = i + 1 - _matcher->lengths[_matcher->out[q]];
+
+            if (start <= best_start)
+            {
+                best       = _matcher->out[q];
+                best_start = start;
+            }
+        }
+    }
+
+    if (best == D_STRING_MATCHER_NONE)
+    {
+        return false;
     }
 
+    _match->position = best_start;
+    _match->length   = _matcher->lengths[best];
+    _match->pattern  = best;
+
     return true;
 }
 
 /*
-d_string_is_numeric
-  Check if string contains only numeric characters.
+d_string_matcher_new
+  Compiles a matcher for a set of null-terminated patterns.
 
 Parameter(s):
-  _str: d_string to check.
+  _patterns: array of `_count` patterns; none may be NULL or empty.
+  _count:    number of patterns.
+  _flags:    D_STRING_MATCHER_* options, e.g. D_STRING_MATCHER_IGNORE_CASE.
 Return:
-  true if all numeric, false otherwise.
+  A pointer value corresponding to either:
+  - a new matcher, to be released with d_string_matcher_free, or
+  - NULL, if a pattern was NULL or empty or memory allocation failed.
 */
-bool
-d_string_is_numeric
+struct d_string_matcher*
+d_string_matcher_new
 (
-    const struct d_string* _str
+    const char* const* _patterns,
+    size_t             _count,
+    unsigned           _flags
 )
 {
-    size_t i;
+    struct d_string_view*    views;
+    struct d_string_matcher* matcher;
+    size_t                   i;
 
-    if ( (_str == NULL) || 
-         (_str->text == NULL) || 
-         (_str->size == 0) )
+    if ( (_patterns == NULL) &&
+         (_count != 0) )
     {
-        return false;
+        return NULL;
+    }
+
+    views = (struct d_string_view*)D_MEMORY_ALLOC(D_MEMORY_MODULE_STRING,
+                                                  (_count ? _count : 1) *
+                                                      sizeof(struct d_string_view));
+
+    if (views == NULL)
+    {
+        return NULL;
     }
 
-    for (i = 0; i < _str->size; i++)
+    for (i = 0; i < _count; i++)
     {
-        if (!isdigit((unsigned char)_str->text[i]))
+        if (_patterns[i] == NULL)
         {
-            return false;
+            D_MEMORY_FREE(views);
+
+            return NULL;
         }
+
+        views[i] = d_string_view_from_cstr(_patterns[i]);
     }
 
-    return true;
+    matcher = d_string_matcher_internal_build(views, _count, _flags);
+    D_MEMORY_FREE(views);
+
+    return matcher;
 }
 
 /*
-d_string_is_alpha
-  Check if string contains only alphabetic characters.
+d_string_matcher_new_views
+  Compiles a matcher for a set of patterns given as views, which may contain
+embedded null bytes. The patterns need not outlive the matcher.
 
 Parameter(s):
-  _str: d_string to check.
+  _patterns: array of `_count` non-empty patterns.
+  _count:    number of patterns.
+  _flags:    D_STRING_MATCHER_* options.
 Return:
-  true if all alphabetic, false otherwise.
+  A pointer value corresponding to either:
+  - a new matcher, to be released with d_string_matcher_free, or
+  - NULL, if a pattern was empty or memory allocation failed.
 */
-bool
-d_string_is_alpha
+struct d_string_matcher*
+d_string_matcher_new_views
 (
-    const struct d_string* _str
+    const struct d_string_view* _patterns,
+    size_t                      _count,
+    unsigned                    _flags
 )
 {
-    size_t i;
-
-    if ( (_str == NULL) || 
-         (_str->text == NULL) || 
-         (_str->size == 0) )
-    {
-        return false;
-    }
-
-    for (i = 0; i < _str->size; i++)
+    if ( (_patterns == NULL) &&
+         (_count != 0) )
     {
-        if (!isalpha((unsigned char)_str->text[i]))
-        {
-            return false;
-        }
+        return NULL;
     }
 
-    return true;
+    return d_string_matcher_internal_build(_patterns, _count, _flags);
 }
 
 /*
-d_string_is_alnum
-  Check if string contains only alphanumeric characters.
+d_string_matcher_free
+  Frees a matcher.
 
 Parameter(s):
-  _str: d_string to check.
+  _matcher: matcher to free; may be NULL.
 Return:
-  true if all alphanumeric, false otherwise.
+  (none)
 */
-bool
-d_string_is_alnum
+void
+d_string_matcher_free
 (
-    const struct d_string* _str
+    struct d_string_matcher* _matcher
 )
 {
-    size_t i;
-
-    if ( (_str == NULL) || 
-         (_str->text == NULL) || 
-         (_str->size == 0) )
+    if (_matcher == NULL)
     {
-        return false;
+        return;
     }
 
-    for (i = 0; i < _str->size; i++)
-    {
-        if (!isalnum((unsigned char)_str->text[i]))
-        {
-            return false;
-        }
-    }
+    D_MEMORY_FREE(_matcher->next);
+    D_MEMORY_FREE(_matcher->out);
+    D_MEMORY_FREE(_matcher->term);
+    D_MEMORY_FREE(_matcher->dict);
+    D_MEMORY_FREE(_matcher->depth);
+    D_MEMORY_FREE(_matcher->lengths);
+    D_MEMORY_FREE(_matcher);
 
-    return true;
+    return;
 }
 
 /*
-d_string_is_whitespace
-  Check if string contains only whitespace characters.
+d_string_matcher_pattern_count
+  Returns the number of patterns a matcher was built from.
 
 Parameter(s):
-  _str: d_string to check.
+  _matcher: matcher to query.
 Return:
-  true if all whitespace, false otherwise.
+  Number of patterns, or 0 if _matcher is NULL.
 */
-bool
-d_string_is_whitespace
+size_t
+d_string_matcher_pattern_count
 (
-    const struct d_string* _str
+    const struct d_string_matcher* _matcher
 )
 {
-    size_t i;
-
-    if ( (_str == NULL) || 
-         (_str->text == NULL) || 
-         (_str->size == 0) )
-    {
-        return false;
-    }
-
-    for (i = 0; i < _str->size; i++)
-    {
-        if (!isspace((unsigned char)_str->text[i]))
-        {
-            return false;
-        }
-    }
-
-    return true;
-}
-
-
-/******************************************************************************
-* Counting Functions
-******************************************************************************/
+    return (_matcher != NULL) ? _matcher->pattern_count : 0;
+}
 
 /*
-d_string_count_char
-  Count occurrences of character in string.
+d_string_matcher_contains
+  Tests whether any pattern occurs in the text, stopping at the first match.
 
 Parameter(s):
-  _str: d_string to search.
-  _c:   character to count.
+  _matcher: matcher to use.
+  _text:    text to scan.
 Return:
-  Number of occurrences.
+  true if some pattern occurs in `_text`, false otherwise or if _matcher is
+  NULL.
 */
-size_t
-d_string_count_char
+bool
+d_string_matcher_contains
 (
-    const struct d_string* _str,
-    char                   _c
+    const struct d_string_matcher* _matcher,
+    struct d_string_view           _text
 )
 {
-    size_t count;
-    size_t i;
+    const unsigned char* text;
+    const uint32_t*      next;
+    size_t               i;
+    uint32_t             row;
 
-    if ( (_str == NULL) || 
-         (_str->text == NULL) )
+    if ( (_matcher == NULL) ||
+         (_text.text == NULL) )
     {
-        return 0;
+        return false;
     }
 
-    count = 0;
+    text = (const unsigned char*)_text.text;
+    next = _matcher->next;
+    row  = 0;
 
-    for (i = 0; i < _str->size; i++)
+    for (i = 0; i < _text.size; i++)
     {
-        if (_str->text[i] == _c)
+        row = next[row + _matcher->classes[text[i]]];
+
+        if (row & D_STRING_MATCHER_HIT)
         {
-            count++;
+            return true;
         }
     }
 
-    return count;
+    return false;
 }
 
 /*
-d_string_count_substr
-  Count occurrences of substring in string.
+d_string_matcher_find_first
+  Finds the leftmost occurrence of any pattern; of several patterns starting
+there, the longest is reported.
 
 Parameter(s):
-  _str:    d_string to search.
-  _substr: substring to count.
+  _matcher: matcher to use.
+  _text:    text to scan.
+  _match:   receives the match, if one is found.
 Return:
-  Number of occurrences.
+  true if a match was found, false otherwise or if a parameter was NULL.
 */
-size_t
-d_string_count_substr
+bool
+d_string_matcher_find_first
 (
-    const struct d_string* _str,
-    const char*            _substr
+    const struct d_string_matcher* _matcher,
+    struct d_string_view           _text,
+    struct d_string_match*         _match
 )
 {
-    size_t      count;
-    size_t      substr_len;
-    const char* search;
-    const char* found;
-
-    if ( (_str == NULL) || 
-         (_substr == NULL) )
-    {
-        return 0;
-    }
-
-    substr_len = strlen(_substr);
-
-    if (substr_len == 0)
-    {
-        return 0;
-    }
-
-    count  = 0;
-    search = _str->text;
-
-    while ((found = strstr(search, _substr)) != NULL)
+    if ( (_matcher == NULL) ||
+         (_match == NULL) ||
+         (_text.text == NULL) )
     {
-        count++;
-        search = found + substr_len;
+        return false;
     }
 
-    return count;
+    return d_string_matcher_internal_leftmost(_matcher,
+                                              (const unsigned char*)_text.text,
+                                              _text.size,
+                                              0,
+                                              _match);
 }
 
-
-/******************************************************************************
-* Hash Function
-******************************************************************************/
-
 /*
-d_string_hash
-  Calculate hash value for string (djb2 algorithm).
+d_string_matcher_find_all
+  Finds every occurrence of every pattern in one pass over the text,
+including overlapping and nested ones. Matches are ordered by end position
+and, among those ending together, longest first.
 
 Parameter(s):
-  _str: d_string to hash.
+  _matcher: matcher to use.
+  _text:    text to scan.
+  _matches: output array of matches (caller must release with free).
 Return:
-  Hash value.
+  Number of matches, or 0 on error or if there are none (in which case
+*_matches is NULL).
 */
 size_t
-d_string_hash
+d_string_matcher_find_all
 (
-    const struct d_string* _str
+    const struct d_string_matcher* _matcher,
+    struct d_string_view           _text,
+    struct d_string_match**        _matches
 )
 {
-    size_t hash;
-    size_t i;
+    const unsigned char*   text;
+    struct d_string_match* result;
+    struct d_string_match* grown;
+    size_t                 count;
+    size_t                 capacity;
+    size_t                 i;
+    uint32_t               row;
+    uint32_t               q;
+    uint32_t               t;
 
-    if ( (_str == NULL) || 
-         (_str->text == NULL) )
+    if (_matches == NULL)
     {
         return 0;
     }
 
-    hash = 5381;
+    *_matches = NULL;
 
-    for (i = 0; i < _str->size; i++)
+    if ( (_matcher == NULL) ||
+         (_text.text == NULL) )
     {
-        hash = ((hash << 5) + hash) + (unsigned char)_str->text[i];
+        return 0;
     }
 
-    return hash;
-}
+    text     = (const unsigned char*)_text.text;
+    result   = NULL;
+    count    = 0;
+    capacity = 0;
+    row      = 0;
 
+    for (i = 0; i < _text.size; i++)
+    {
+        row = _matcher->next[row + _matcher->classes[text[i]]];
 
-/******************************************************************************
-* Error String Functions
-******************************************************************************/
+        if (!(row & D_STRING_MATCHER_HIT))
+        {
+            continue;
+        }
 
-/*
-d_string_error
-  Get error description as d_string.
+        row &= ~D_STRING_MATCHER_HIT;
+        q    = (uint32_t)(row / _matcher->class_count);
 
-Parameter(s):
-  _errnum: error number.
-Return:
-  New d_string with error description, or NULL on allocation failure.
-*/
-struct d_string*
-d_string_error
-(
-    int _errnum
-)
-{
-    char buf[256];
+        // the state's own pattern, then shorter ones along the suffix chain
+        t = (_matcher->term[q] != D_STRING_MATCHER_NONE) ? q : _matcher->dict[q];
 
-    if (d_strerror_r(_errnum, buf, sizeof(buf)) != 0)
+        while (t != 0)
+        {
+            if (count == capacity)
+            {
+                capacity = (capacity != 0) ? (capacity * 2) : 16;
+                grown    = (struct d_string_match*)realloc(
+                               result,
+                               capacity * sizeof(struct d_string_match));
+
+                if (grown == NULL)
+                {
+                    free(result);
+
+                    return 0;
+                }
+
+                result = grown;
+            }
+
+            result[count].pattern  = _matcher->term[t];
+            result[count].length   = _matcher->lengths[_matcher->term[t]];
+            result[count].position = i + 1 - result[count].length;
+            count++;
+
+            t = _matcher->dict[t];
+        }
+    }
+
+    if (result != NULL)
     {
-        return d_string_new_from_cstr("Unknown error");
+        D_MEMORY_HANDOFF(D_MEMORY_MODULE_STRING,
+                         capacity * sizeof(struct d_string_match));
     }
 
-    return d_string_new_from_cstr(buf);
+    *_matches = result;
+
+    return count;
 }
 
 /*
-d_string_error_r
-  Thread-safe error string into provided d_string.
+d_string_matcher_replace
+  Replaces, in one pass, every leftmost-longest non-overlapping occurrence
+of the matcher's patterns with the corresponding replacement.
 
 Parameter(s):
-  _errnum: error number.
-  _str:    d_string to store error description.
+  _matcher:      matcher to use.
+  _str:          d_string to modify.
+  _replacements: array with one replacement per pattern, indexed as the
+                 patterns the matcher was built from.
 Return:
-  0 on success, error code otherwise.
+  true if successful, false otherwise (in which case `_str` is unchanged).
 */
-int
-d_string_error_r
+bool
+d_string_matcher_replace
 (
-    int              _errnum,
-    struct d_string* _str
+    const struct d_string_matcher* _matcher,
+    struct d_string*               _str,
+    const struct d_string_view*    _replacements
 )
 {
-    char buf[256];
-    int  result;
-
-    if (_str == NULL)
+    struct d_string_match*      matches;
+    struct d_string_match*      grown;
+    struct d_string_match       match;
+    struct d_string*            result;
+    const struct d_string_view* replacement;
+    size_t                      count;
+    size_t                      capacity;
+    size_t                      new_size;
+    size_t                      pos;
+    size_t                      i;
+    char*                       write_ptr;
+
+    if (!d_string_internal_modified(_str, D_STRING_INTERNAL_SITE))
     {
-        return EINVAL;
+        return false;
     }
 
-    result = d_strerror_r(_errnum, buf, sizeof(buf));
-
-    if (result != 0)
+    if ( (_matcher == NULL) ||
+         (_str == NULL) ||
+         ( (_replacements == NULL) &&
+           (_matcher->pattern_count != 0) ) )
     {
-        return result;
+        return false;
     }
 
-    if (!d_string_assign_cstr(_str, buf))
+    if (_str->text == NULL)
     {
-        return EINVAL;
+        return true;
     }
 
-    return 0;
-}
+    // collect matches and the resulting size
+    matches  = NULL;
+    count    = 0;
+    capacity = 0;
+    new_size = _str->size;
+    pos      = 0;
 
+    while (d_string_matcher_internal_leftmost(_matcher,
+                                              (const unsigned char*)_str->text,
+                                              _str->size,
+                                              pos,
+                                              &match))
+    {
+        if (count == capacity)
+        {
+            capacity = (capacity != 0) ? (capacity * 2) : 16;
+            grown    = (struct d_string_match*)D_MEMORY_REALLOC(
+                           D_MEMORY_MODULE_STRING,
+                           matches,
+                           capacity * sizeof(struct d_string_match));
 
-/******************************************************************************
-* Formatted String Functions
-******************************************************************************/
+            if (grown == NULL)
+            {
+                D_MEMORY_FREE(matches);
 
-/*
-d_string_printf
-  Create formatted d_string.
+                return false;
+            }
 
-Parameter(s):
-  _format: printf-style format string.
-  ...:     format arguments.
-Return:
-  New formatted d_string, or NULL on error.
-*/
-struct d_string*
-d_string_printf
-(
-    const char* _format, 
-    ...
-)
-{
-    va_list          args;
-    struct d_string* result;
+            matches = grown;
+        }
 
-    va_start(args, _format);
-    result = d_string_vprintf(_format, args);
-    va_end(args);
+        replacement = &_replacements[match.pattern];
 
-    return result;
-}
+        if (replacement->size > (SIZE_MAX - new_size - 1))
+        {
+            D_MEMORY_FREE(matches);
 
-/*
-d_string_vprintf
-  Create formatted d_string with va_list.
+            return false;
+        }
 
-Parameter(s):
-  _format: printf-style format string.
-  _args:   va_list of arguments.
-Return:
-  New formatted d_string, or NULL on error.
-*/
-struct d_string*
-d_string_vprintf
-(
-    const char* _format,
-    va_list     _args
-)
-{
-    va_list          args_copy;
-    int              len;
-    struct d_string* result;
+        new_size         = new_size - match.length + replacement->size;
+        matches[count++] = match;
+        pos              = match.position + match.length;
+    }
 
-    if (_format == NULL)
+    if (count == 0)
     {
-        return NULL;
+        return true;
     }
 
-    va_copy(args_copy, _args);
-    len = vsnprintf(NULL, 0, _format, _args);
+    result = d_string_new_with_capacity(new_size + 1);
 
-    if (len < 0)
+    if (result == NULL)
     {
-        va_end(args_copy);
+        D_MEMORY_FREE(matches);
 
-        return NULL;
+        return false;
     }
 
-    result = d_string_new_with_capacity((size_t)len + 1);
+    // build result
+    pos       = 0;
+    write_ptr = result->text;
 
-    if (result == NULL)
+    for (i = 0; i < count; i++)
     {
-        va_end(args_copy);
+        replacement = &_replacements[matches[i].pattern];
 
-        return NULL;
+        d_memcpy(write_ptr, _str->text + pos, matches[i].position - pos);
+        write_ptr += matches[i].position - pos;
+
+        if (replacement->size != 0)
+        {
+            d_memcpy(write_ptr, replacement->text, replacement->size);
+            write_ptr += replacement->size;
+        }
+
+        pos = matches[i].position + matches[i].length;
     }
 
-    vsnprintf(result->text, (size_t)len + 1, _format, args_copy);
-    va_end(args_copy);
+    // copy remaining text, including the null terminator
+    d_memcpy(write_ptr, _str->text + pos, _str->size - pos + 1);
+    result->size = new_size;
 
-    result->size = (size_t)len;
+    D_MEMORY_FREE(matches);
 
-    return result;
+    // swap contents (frees the result struct, but not its text)
+    return d_string_internal_take(_str, result, D_STRING_INTERNAL_SITE);
 }
 
 /*
-d_string_sprintf
-  Format into existing d_string.
+d_string_replace_all_map
+  Replaces many substrings at once: every leftmost-longest non-overlapping
+occurrence of `_old[i]` becomes `_new[i]`, in a single pass over the string.
+Replacement text is never rescanned. To apply the same map repeatedly,
+compile it once with d_string_matcher_new and use d_string_matcher_replace.
 
 Parameter(s):
-  _str:    d_string to format into (replaces content).
-  _format: printf-style format string.
-  ...:     format arguments.
+  _str:   d_string to modify.
+  _old:   array of `_count` non-empty substrings to find.
+  _new:   array of `_count` replacements.
+  _count: number of substitutions.
 Return:
-  Number of characters written, or -1 on error.
+  true if successful, false otherwise (in which case `_str` is unchanged).
 */
-int
-d_string_sprintf
+bool
+d_string_replace_all_map
 (
-    struct d_string* _str,
-    const char*      _format,
-    ...
+    struct d_string*   _str,
+    const char* const* _old,
+    const char* const* _new,
+    size_t             _count
 )
 {
-    va_list args;
-    va_list args_copy;
-    int     len;
+    struct d_string_matcher* matcher;
+    struct d_string_view*    replacements;
+    size_t                   i;
+    bool                     result;
 
-    if ( (_str == NULL) || 
-         (_format == NULL) )
+    if (!d_string_internal_modified(_str, D_STRING_INTERNAL_SITE))
     {
-        return -1;
+        return false;
     }
 
-    va_start(args, _format);
-    va_copy(args_copy, args);
+    if ( (_str == NULL) ||
+         (_old == NULL) ||
+         (_new == NULL) )
+    {
+        return false;
+    }
 
-    len = vsnprintf(NULL, 0, _format, args);
-    va_end(args);
+    replacements = (struct d_string_view*)D_MEMORY_ALLOC(D_MEMORY_MODULE_STRING,
+                                                         (_count ? _count : 1) *
+                                                             sizeof(struct d_string_view));
 
-    if (len < 0)
+    if (replacements == NULL)
     {
-        va_end(args_copy);
-
-        return -1;
+        return false;
     }
 
-    if (!d_string_internal_grow(_str, (size_t)len + 1))
+    for (i = 0; i < _count; i++)
     {
-        va_end(args_copy);
+        if (_new[i] == NULL)
+        {
+            D_MEMORY_FREE(replacements);
 
-        return -1;
+            return false;
+        }
+
+        replacements[i] = d_string_view_from_cstr(_new[i]);
     }
 
-    vsnprintf(_str->text, (size_t)len + 1, _format, args_copy);
-    va_end(args_copy);
+    matcher = d_string_matcher_new(_old, _count, 0);
+    result  = ( (matcher != NULL) &&
+                d_string_matcher_replace(matcher, _str, replacements) );
 
-    _str->size = (size_t)len;
+    d_string_matcher_free(matcher);
+    D_MEMORY_FREE(replacements);
 
-    return len;
-}
\ No newline at end of file
+    return result;
+}
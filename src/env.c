@@ -1,4 +1,27 @@
 #include "..\inc\env.h"
+#include <stdlib.h>
+
+#if ( defined(__x86_64__) || defined(__i386__) ||                   \
+      defined(_M_X64)     || defined(_M_IX86) )
+    #define D_ENV_INTERNAL_CPU_X86 1
+
+    #if defined(_MSC_VER)
+        #include <intrin.h>
+    #else
+        #include <cpuid.h>
+    #endif
+#elif ( defined(__linux__) &&                                       \
+        (defined(__aarch64__) || defined(__arm__)) )
+    #define D_ENV_INTERNAL_CPU_AUXV 1
+
+    #include <sys/auxv.h>
+#endif
+
+#if defined(__APPLE__)
+    #include <sys/sysctl.h>
+#elif ( defined(__linux__) && !defined(D_ENV_INTERNAL_CPU_X86) )
+    #include <stdio.h>
+#endif
 
 
 #ifdef D_DEBUG_
@@ -87,4 +110,641 @@
     #else
         #define D_ENV_COMPILER_STATIC_ASSERT(condition, message) typedef char static_assertion_##__LINE__[(condition) ? 1 : -1]
     #endif  // __cplusplus
-#endif  // D_DEBUG_
\ No newline at end of file
+#endif  // D_DEBUG_
+
+
+// =============================================================================
+// X.   RUNTIME CPU FEATURES
+// =============================================================================
+
+// D_ENV_INTERNAL_CPU_PROBED
+//   flag: set in a cached feature word once the probe has run, so a single
+// 32-bit load tells whether the cache is valid.
+#define D_ENV_INTERNAL_CPU_PROBED   0x80000000u
+
+// D_ENV_INTERNAL_CPU_*_BITS
+//   constant: x86 feature groups used to build the tier table.
+#define D_ENV_INTERNAL_CPU_SSE42_BITS                                      \
+    ( D_ENV_CPU_FEATURE_SSE2  | D_ENV_CPU_FEATURE_SSE3  |                  \
+      D_ENV_CPU_FEATURE_SSSE3 | D_ENV_CPU_FEATURE_SSE41 |                  \
+      D_ENV_CPU_FEATURE_SSE42 | D_ENV_CPU_FEATURE_POPCNT )
+#define D_ENV_INTERNAL_CPU_AVX2_BITS                                       \
+    ( D_ENV_INTERNAL_CPU_SSE42_BITS |                                      \
+      D_ENV_CPU_FEATURE_AVX  | D_ENV_CPU_FEATURE_AVX2 |                    \
+      D_ENV_CPU_FEATURE_BMI1 | D_ENV_CPU_FEATURE_BMI2 |                    \
+      D_ENV_CPU_FEATURE_FMA )
+#define D_ENV_INTERNAL_CPU_AVX512_BITS                                     \
+    ( D_ENV_INTERNAL_CPU_AVX2_BITS |                                       \
+      D_ENV_CPU_FEATURE_AVX512F  | D_ENV_CPU_FEATURE_AVX512BW |            \
+      D_ENV_CPU_FEATURE_AVX512VL )
+
+// d_env_internal_cpu_tier
+//   struct: one kernel tier. `features` is everything the tier may use and
+// caps the reported features when the tier is selected by override;
+// `required` is what the CPU must have for the tier to count as supported.
+struct d_env_internal_cpu_tier
+{
+    const char* name;
+    uint32_t    features;
+    uint32_t    required;
+};
+
+static const struct d_env_internal_cpu_tier
+d_env_internal_cpu_tiers[D_ENV_CPU_TIER_COUNT] =
+{
+    { "scalar", 0u,
+                0u },
+    { "sse2",   D_ENV_CPU_FEATURE_SSE2,
+                D_ENV_CPU_FEATURE_SSE2 },
+    { "sse4.2", D_ENV_INTERNAL_CPU_SSE42_BITS,
+                D_ENV_CPU_FEATURE_SSE42 },
+    { "avx2",   D_ENV_INTERNAL_CPU_AVX2_BITS,
+                (D_ENV_CPU_FEATURE_AVX | D_ENV_CPU_FEATURE_AVX2) },
+    { "avx512", D_ENV_INTERNAL_CPU_AVX512_BITS,
+                ( D_ENV_CPU_FEATURE_AVX512F  |
+                  D_ENV_CPU_FEATURE_AVX512BW |
+                  D_ENV_CPU_FEATURE_AVX512VL ) },
+    { "neon",   (D_ENV_CPU_FEATURE_NEON | D_ENV_CPU_FEATURE_CRC32),
+                D_ENV_CPU_FEATURE_NEON },
+    { "sve",    ( D_ENV_CPU_FEATURE_NEON | D_ENV_CPU_FEATURE_CRC32 |
+                  D_ENV_CPU_FEATURE_SVE  | D_ENV_CPU_FEATURE_SVE2 ),
+                D_ENV_CPU_FEATURE_SVE }
+};
+
+// cached probe results, with D_ENV_INTERNAL_CPU_PROBED set once valid;
+// concurrent first calls store identical values
+static volatile uint32_t d_env_internal_cpu_detected = 0;
+static volatile uint32_t d_env_internal_cpu_features = 0;
+
+// cached last-level cache size; SIZE_MAX until probed
+static volatile size_t   d_env_internal_cpu_cache   = SIZE_MAX;
+
+
+#if defined(D_ENV_INTERNAL_CPU_X86)
+
+/*
+d_env_internal_cpuid
+  Runs cpuid for leaf `_leaf`, subleaf `_sub`, storing eax, ebx, ecx and edx
+in `_regs`.
+*/
+static void
+d_env_internal_cpuid
+(
+    unsigned int _leaf,
+    unsigned int _sub,
+    unsigned int _regs[4]
+)
+{
+#if defined(_MSC_VER)
+    int regs[4];
+
+    __cpuidex(regs, (int)_leaf, (int)_sub);
+
+    _regs[0] = (unsigned int)regs[0];
+    _regs[1] = (unsigned int)regs[1];
+    _regs[2] = (unsigned int)regs[2];
+    _regs[3] = (unsigned int)regs[3];
+#else
+    __cpuid_count(_leaf, _sub, _regs[0], _regs[1], _regs[2], _regs[3]);
+#endif
+
+    return;
+}
+
+/*
+d_env_internal_xgetbv
+  Returns the XCR0 register: the register states the operating system saves
+on context switches.
+*/
+static uint64_t
+d_env_internal_xgetbv
+(
+    void
+)
+{
+#if defined(_MSC_VER)
+    return (uint64_t)_xgetbv(0);
+#else
+    uint32_t lo;
+    uint32_t hi;
+
+    __asm__ __volatile__ ("xgetbv" : "=a"(lo), "=d"(hi) : "c"(0));
+
+    return ((uint64_t)hi << 32) | lo;
+#endif
+}
+
+/*
+d_env_internal_cpu_probe
+  Returns the D_ENV_CPU_FEATURE_* flags of the running x86 CPU. AVX and
+AVX-512 are only reported if XCR0 shows the OS saves their registers.
+*/
+static uint32_t
+d_env_internal_cpu_probe
+(
+    void
+)
+{
+    unsigned int regs[4];
+    unsigned int max_leaf;
+    uint64_t     xcr0;
+    uint32_t     features;
+    int          avx_os;
+    int          avx512_os;
+
+    d_env_internal_cpuid(0, 0, regs);
+    max_leaf = regs[0];
+    features = 0;
+
+    if (max_leaf < 1)
+    {
+        return 0;
+    }
+
+    d_env_internal_cpuid(1, 0, regs);
+
+    features |= (regs[3] & (1u << 26)) ? D_ENV_CPU_FEATURE_SSE2   : 0;
+    features |= (regs[2] & (1u << 0))  ? D_ENV_CPU_FEATURE_SSE3   : 0;
+    features |= (regs[2] & (1u << 9))  ? D_ENV_CPU_FEATURE_SSSE3  : 0;
+    features |= (regs[2] & (1u << 19)) ? D_ENV_CPU_FEATURE_SSE41  : 0;
+    features |= (regs[2] & (1u << 20)) ? D_ENV_CPU_FEATURE_SSE42  : 0;
+    features |= (regs[2] & (1u << 23)) ? D_ENV_CPU_FEATURE_POPCNT : 0;
+
+    // OSXSAVE: XCR0 is readable; bits 1-2 are SSE/AVX, 5-7 AVX-512 state
+    avx_os    = 0;
+    avx512_os = 0;
+
+    if (regs[2] & (1u << 27))
+    {
+        xcr0      = d_env_internal_xgetbv();
+        avx_os    = ((xcr0 & 0x06u) == 0x06u);
+        avx512_os = ((xcr0 & 0xE6u) == 0xE6u);
+    }
+
+    if (avx_os)
+    {
+        features |= (regs[2] & (1u << 28)) ? D_ENV_CPU_FEATURE_AVX : 0;
+        features |= (regs[2] & (1u << 12)) ? D_ENV_CPU_FEATURE_FMA : 0;
+    }
+
+    if (max_leaf < 7)
+    {
+        return features;
+    }
+
+    d_env_internal_cpuid(7, 0, regs);
+
+    features |= (regs[1] & (1u << 3)) ? D_ENV_CPU_FEATURE_BMI1 : 0;
+    features |= (regs[1] & (1u << 8)) ? D_ENV_CPU_FEATURE_BMI2 : 0;
+
+    if (features & D_ENV_CPU_FEATURE_AVX)
+    {
+        features |= (regs[1] & (1u << 5)) ? D_ENV_CPU_FEATURE_AVX2 : 0;
+    }
+
+    if (avx512_os)
+    {
+        features |= (regs[1] & (1u << 16)) ? D_ENV_CPU_FEATURE_AVX512F  : 0;
+        features |= (regs[1] & (1u << 30)) ? D_ENV_CPU_FEATURE_AVX512BW : 0;
+        features |= (regs[1] & (1u << 31)) ? D_ENV_CPU_FEATURE_AVX512VL : 0;
+    }
+
+    return features;
+}
+
+/*
+d_env_internal_cpu_cache_probe
+  Returns the size of the highest-level data or unified cache, from the
+deterministic cache parameters leaf: 4 on Intel, 0x8000001D on AMD (which
+reports nothing in leaf 4). Returns 0 if neither leaf is available.
+*/
+static size_t
+d_env_internal_cpu_cache_probe
+(
+    void
+)
+{
+    static const unsigned int leaves[2] = { 4u, 0x8000001Du };
+    unsigned int regs[4];
+    unsigned int max_leaf;
+    unsigned int level;
+    unsigned int best_level;
+    unsigned int sub;
+    size_t       size;
+    size_t       best;
+    int          i;
+
+    best       = 0;
+    best_level = 0;
+
+    for (i = 0; (i < 2) && (best == 0); i++)
+    {
+        d_env_internal_cpuid(leaves[i] & 0x80000000u, 0, regs);
+        max_leaf = regs[0];
+
+        if (max_leaf < leaves[i])
+        {
+            continue;
+        }
+
+        // one subleaf per cache until type 0; eax[4:0] type (1 data,
+        // 3 unified), eax[7:5] level, ebx ways/partitions/line, ecx sets
+        for (sub = 0; sub < 16; sub++)
+        {
+            d_env_internal_cpuid(leaves[i], sub, regs);
+
+            if ((regs[0] & 0x1Fu) == 0)
+            {
+                break;
+            }
+
+            if ((regs[0] & 0x1Fu) == 2)
+            {
+                continue;
+            }
+
+            level = (regs[0] >> 5) & 0x7u;
+            size  = (size_t)(((regs[1] >> 22) & 0x3FFu) + 1) *
+                    (size_t)(((regs[1] >> 12) & 0x3FFu) + 1) *
+                    (size_t)((regs[1] & 0xFFFu) + 1)         *
+                    (size_t)(regs[2] + 1);
+
+            if (level >= best_level)
+            {
+                best_level = level;
+                best       = size;
+            }
+        }
+    }
+
+    return best;
+}
+
+#else
+
+/*
+d_env_internal_cpu_probe
+  Returns the D_ENV_CPU_FEATURE_* flags of the running ARM CPU: from the
+kernel's hardware capability words on Linux, otherwise what the compiler
+target guarantees. NEON is architectural on AArch64.
+*/
+static uint32_t
+d_env_internal_cpu_probe
+(
+    void
+)
+{
+    uint32_t features;
+
+    features = 0;
+
+#if ( defined(__aarch64__) || defined(_M_ARM64) ||                   \
+      defined(__ARM_NEON)  || defined(__ARM_NEON__) )
+    features |= D_ENV_CPU_FEATURE_NEON;
+#endif
+
+#if defined(__ARM_FEATURE_CRC32)
+    features |= D_ENV_CPU_FEATURE_CRC32;
+#endif
+
+#if defined(__ARM_FEATURE_SVE)
+    features |= D_ENV_CPU_FEATURE_SVE;
+#endif
+
+#if defined(D_ENV_INTERNAL_CPU_AUXV)
+    #if defined(__aarch64__)
+        // HWCAP_CRC32, HWCAP_SVE and HWCAP2_SVE2 from <asm/hwcap.h>
+        features |= (getauxval(AT_HWCAP)  & (1ul << 7))
+                    ? D_ENV_CPU_FEATURE_CRC32 : 0;
+        features |= (getauxval(AT_HWCAP)  & (1ul << 22))
+                    ? D_ENV_CPU_FEATURE_SVE   : 0;
+        features |= (getauxval(AT_HWCAP2) & (1ul << 1))
+                    ? D_ENV_CPU_FEATURE_SVE2  : 0;
+    #else
+        // HWCAP_NEON from <asm/hwcap.h>
+        features |= (getauxval(AT_HWCAP)  & (1ul << 12))
+                    ? D_ENV_CPU_FEATURE_NEON  : 0;
+    #endif
+#endif
+
+    return features;
+}
+
+/*
+d_env_internal_cpu_cache_probe
+  Returns the size of the highest-level cache the operating system reports:
+from sysfs on Linux, sysctl on Apple platforms, otherwise 0.
+*/
+static size_t
+d_env_internal_cpu_cache_probe
+(
+    void
+)
+{
+    size_t best;
+
+#if defined(__APPLE__)
+    uint64_t value;
+    size_t   length;
+
+    best   = 0;
+    value  = 0;
+    length = sizeof(value);
+
+    if ( (sysctlbyname("hw.l3cachesize", &value, &length, NULL, 0) != 0) ||
+         (value == 0) )
+    {
+        value  = 0;
+        length = sizeof(value);
+
+        if (sysctlbyname("hw.l2cachesize", &value, &length, NULL, 0) != 0)
+        {
+            value = 0;
+        }
+    }
+
+    best = (size_t)value;
+#elif defined(__linux__)
+    char          path[64];
+    FILE*         file;
+    unsigned long size;
+    char          unit;
+    int           level;
+    int           best_level;
+    int           index;
+
+    best       = 0;
+    best_level = 0;
+
+    for (index = 0; index < 16; index++)
+    {
+        // each indexN directory is one cache: "level" is 1-4, "size" is e.g.
+        // "48K" or "32M"
+        snprintf(path, sizeof(path),
+                 "/sys/devices/system/cpu/cpu0/cache/index%d/level", index);
+        file = fopen(path, "r");
+
+        if (file == NULL)
+        {
+            break;
+        }
+
+        level = (fscanf(file, "%d", &level) == 1) ? level : 0;
+        fclose(file);
+
+        snprintf(path, sizeof(path),
+                 "/sys/devices/system/cpu/cpu0/cache/index%d/size", index);
+        file = fopen(path, "r");
+
+        if (file == NULL)
+        {
+            continue;
+        }
+
+        unit = 0;
+
+        if ( (fscanf(file, "%lu%c", &size, &unit) >= 1) &&
+             (level >= best_level) )
+        {
+            best_level = level;
+            best       = (size_t)size *
+                         ( (unit == 'K') ? 1024u :
+                           (unit == 'M') ? (1024u * 1024u) :
+                           (unit == 'G') ? (1024u * 1024u * 1024u) : 1u );
+        }
+
+        fclose(file);
+    }
+#else
+    best = 0;
+#endif
+
+    return best;
+}
+
+#endif  // D_ENV_INTERNAL_CPU_X86
+
+
+/*
+d_env_internal_cpu_tier_find
+  Returns the tier named `_name` (ASCII case-insensitive), or -1 if there is
+none.
+*/
+static int
+d_env_internal_cpu_tier_find
+(
+    const char* _name
+)
+{
+    const char* a;
+    const char* b;
+    int         tier;
+
+    for (tier = 0; tier < D_ENV_CPU_TIER_COUNT; tier++)
+    {
+        a = _name;
+        b = d_env_internal_cpu_tiers[tier].name;
+
+        while ( (*a != '\0') &&
+                ( (*a == *b) ||
+                  ( (*a >= 'A') && (*a <= 'Z') && ((*a - 'A' + 'a') == *b) ) ) )
+        {
+            a++;
+            b++;
+        }
+
+        if ( (*a == '\0') &&
+             (*b == '\0') )
+        {
+            return tier;
+        }
+    }
+
+    return -1;
+}
+
+/*
+d_env_cpu_features_detected
+  Returns the instruction set extensions of the running CPU, ignoring
+D_ENV_CPU_OVERRIDE_VAR. The CPU is probed on the first call and the result
+cached.
+
+Parameter(s):
+  none
+Return:
+  A combination of D_ENV_CPU_FEATURE_* flags; 0 on architectures without a
+probe.
+*/
+uint32_t
+d_env_cpu_features_detected
+(
+    void
+)
+{
+    uint32_t detected;
+
+    detected = d_env_internal_cpu_detected;
+
+    if (!(detected & D_ENV_INTERNAL_CPU_PROBED))
+    {
+        detected = ( d_env_internal_cpu_probe() |
+                     D_ENV_INTERNAL_CPU_PROBED );
+        d_env_internal_cpu_detected = detected;
+    }
+
+    return (detected & ~D_ENV_INTERNAL_CPU_PROBED);
+}
+
+/*
+d_env_cpu_features
+  Returns the instruction set extensions kernels may use: those of the
+running CPU, limited to the features of the tier named by the
+D_ENV_CPU_OVERRIDE_VAR environment variable if it is set (an unknown name is
+ignored). The result is computed on the first call and cached, so the
+variable must be set before the program starts.
+
+Parameter(s):
+  none
+Return:
+  A combination of D_ENV_CPU_FEATURE_* flags.
+*/
+uint32_t
+d_env_cpu_features
+(
+    void
+)
+{
+    const char* name;
+    uint32_t    features;
+    int         tier;
+
+    features = d_env_internal_cpu_features;
+
+    if (!(features & D_ENV_INTERNAL_CPU_PROBED))
+    {
+        features = d_env_cpu_features_detected();
+        name     = getenv(D_ENV_CPU_OVERRIDE_VAR);
+        tier     = (name) ? d_env_internal_cpu_tier_find(name) : -1;
+
+        if (tier >= 0)
+        {
+            features &= d_env_internal_cpu_tiers[tier].features;
+        }
+
+        features |= D_ENV_INTERNAL_CPU_PROBED;
+        d_env_internal_cpu_features = features;
+    }
+
+    return (features & ~D_ENV_INTERNAL_CPU_PROBED);
+}
+
+/*
+d_env_cpu_cache_size
+  Returns the size of the running CPU's last-level cache: the highest-level
+data or unified cache, usually the L3 shared by all cores. Modules use it to
+size blocking and cache-bypass thresholds. The cache is probed on the first
+call and the result cached.
+
+Parameter(s):
+  none
+Return:
+  The cache size in bytes, or 0 if it could not be determined.
+*/
+size_t
+d_env_cpu_cache_size
+(
+    void
+)
+{
+    size_t size;
+
+    size = d_env_internal_cpu_cache;
+
+    if (size == SIZE_MAX)
+    {
+        size                      = d_env_internal_cpu_cache_probe();
+        d_env_internal_cpu_cache = size;
+    }
+
+    return size;
+}
+
+/*
+d_env_cpu_tier
+  Returns the most capable tier supported by d_env_cpu_features.
+
+Parameter(s):
+  none
+Return:
+  One of the D_ENV_CPU_TIER_* constants.
+*/
+int
+d_env_cpu_tier
+(
+    void
+)
+{
+    uint32_t features;
+    int      tier;
+
+    features = d_env_cpu_features();
+
+    for (tier = D_ENV_CPU_TIER_COUNT - 1; tier > D_ENV_CPU_TIER_SCALAR; tier--)
+    {
+        if ( (features & d_env_internal_cpu_tiers[tier].required) ==
+             d_env_internal_cpu_tiers[tier].required )
+        {
+            return tier;
+        }
+    }
+
+    return D_ENV_CPU_TIER_SCALAR;
+}
+
+/*
+d_env_cpu_tier_features
+  Returns the features a tier may use.
+
+Parameter(s):
+  _tier: one of the D_ENV_CPU_TIER_* constants.
+Return:
+  A combination of D_ENV_CPU_FEATURE_* flags, or 0 for an invalid tier.
+*/
+uint32_t
+d_env_cpu_tier_features
+(
+    int _tier
+)
+{
+    if ( (_tier < 0) ||
+         (_tier >= D_ENV_CPU_TIER_COUNT) )
+    {
+        return 0;
+    }
+
+    return d_env_internal_cpu_tiers[_tier].features;
+}
+
+/*
+d_env_cpu_tier_name
+  Returns the name of a tier, as accepted by D_ENV_CPU_OVERRIDE_VAR.
+
+Parameter(s):
+  _tier: one of the D_ENV_CPU_TIER_* constants.
+Return:
+  The tier name, or NULL for an invalid tier.
+*/
+const char*
+d_env_cpu_tier_name
+(
+    int _tier
+)
+{
+    if ( (_tier < 0) ||
+         (_tier >= D_ENV_CPU_TIER_COUNT) )
+    {
+        return NULL;
+    }
+
+    return d_env_internal_cpu_tiers[_tier].name;
+}
@@ -1,4 +1,25 @@
 #include "..\inc\string_fn.h"
+#include <ctype.h>
+
+#if defined(__AVX2__)
+    #include <immintrin.h>
+#elif ( defined(__SSE2__) || defined(_M_X64) ||                   \
+        (defined(_M_IX86_FP) && (_M_IX86_FP >= 2)) )
+    #include <emmintrin.h>
+#elif ( defined(__ARM_NEON) || defined(__ARM_NEON__) )
+    #include <arm_neon.h>
+#endif
+
+#if ( !defined(__AVX2__)                          &&             \
+      (defined(__x86_64__) || defined(__i386__))   &&             \
+      (defined(__GNUC__) || defined(__clang__)) )
+    // AVX2 kernels built for run-time dispatch
+    #include <immintrin.h>
+#endif
+
+#if defined(_MSC_VER)
+    #include <intrin.h>
+#endif
 
 
 /*
@@ -229,6 +250,7 @@ d_strdup
     
     if (copy != NULL)
     {
+        D_MEMORY_HANDOFF(D_MEMORY_MODULE_STRING, len);
         d_memcpy(copy, _str, len);
     }
     
@@ -264,6 +286,7 @@ d_strndup
     
     if (copy != NULL)
     {
+        D_MEMORY_HANDOFF(D_MEMORY_MODULE_STRING, len + 1);
         d_memcpy(copy, _str, len);
         copy[len] = '\0';
     }
@@ -479,9 +502,811 @@ d_strnlen
     return len;
 }
 
+/******************************************************************************
+* Internal Case-Insensitive Search Engine
+******************************************************************************/
+
+// D_STRING_FN_CASE_*
+//   constant: compile-time selection of the vectorized first-and-last-byte
+// candidate filter. None is defined when no vector unit is available at
+// compile time, in which case only the scalar filter is used.
+// D_STRING_FN_CASE_AVX2_DISPATCH is set for GCC/Clang x86 builds that do not
+// target AVX2 themselves; the AVX2 filter is then compiled alongside the SSE2
+// one and chosen at run time when the CPU supports it.
+#if defined(__AVX2__)
+    #define D_STRING_FN_CASE_AVX2          1
+#elif ( defined(__SSE2__) || defined(_M_X64) ||                   \
+        (defined(_M_IX86_FP) && (_M_IX86_FP >= 2)) )
+    #define D_STRING_FN_CASE_SSE2          1
+#elif ( defined(__ARM_NEON) || defined(__ARM_NEON__) )
+    #define D_STRING_FN_CASE_NEON          1
+#endif
+
+#if ( defined(D_STRING_FN_CASE_SSE2) &&                           \
+      D_ENV_CPU_DISPATCH_X86 )
+    #define D_STRING_FN_CASE_AVX2_DISPATCH 1
+    #define D_STRING_FN_CASE_AVX2_FN       D_ENV_CPU_TARGET_AVX2
+#else
+    #define D_STRING_FN_CASE_AVX2_FN
+#endif
+
+// D_STRING_FN_CASE_VERIFY_SLACK
+//   constant: number of bytes the candidate filter may spend verifying false
+// positives, beyond one byte per haystack byte scanned, before the search
+// falls back to the Two-Way algorithm.
+#define D_STRING_FN_CASE_VERIFY_SLACK 1024
+
+// D_STRING_FN_FOLD
+//   macro: folds an ASCII uppercase letter to lowercase, leaving every other
+// byte unchanged. Branch-free; `c` must be an unsigned char value.
+#define D_STRING_FN_FOLD(c)  \
+    ((unsigned char)((c) | ((((unsigned)(c) - 'A') < 26u) << 5)))
+
+// D_STRING_FN_CASE_BIT
+//   macro: the bit that must be OR'd into a haystack byte before comparing it
+// with the folded needle byte `c`: 0x20 if `c` is a letter, else 0. For a
+// letter, `(h | 0x20) == c` holds exactly for its two cases.
+#define D_STRING_FN_CASE_BIT(c)  \
+    ((unsigned char)((((unsigned)(c) - 'a') < 26u) << 5))
+
+// d_string_fn_internal_twoway
+//   struct: preprocessed state for a case-folded Two-Way (Crochemore-Perrin)
+// search. Tables are indexed by folded bytes.
+struct d_string_fn_internal_twoway
+{
+    size_t        ms;           // end of the left half of the factorization
+    size_t        period;       // shift after a right-half match
+    size_t        mem0;         // prefix known to match after that shift
+    size_t        shift[256];   // last position (+1) of each folded byte
+    unsigned char byteset[32];  // bitset of folded bytes present in needle
+};
+
+/*
+d_string_fn_internal_ctz64
+  Returns the number of trailing zero bits in a non-zero 64-bit value.
+*/
+static D_INLINE unsigned
+d_string_fn_internal_ctz64
+(
+    uint64_t _x
+)
+{
+#if defined(__GNUC__) || defined(__clang__)
+    return (unsigned)__builtin_ctzll(_x);
+#elif defined(_MSC_VER) && (defined(_M_X64) || defined(_M_ARM64))
+    unsigned long index;
+
+    _BitScanForward64(&index, _x);
+
+    return (unsigned)index;
+#else
+    unsigned count;
+
+    count = 0;
+
+    while ((_x & 1) == 0)
+    {
+        _x >>= 1;
+        count++;
+    }
+
+    return count;
+#endif
+}
+
+/*
+d_string_fn_internal_caseeq
+  Returns true if the first `_n` bytes of `_a` and `_b` are equal under ASCII
+case folding.
+*/
+static D_INLINE bool
+d_string_fn_internal_caseeq
+(
+    const unsigned char* _a,
+    const unsigned char* _b,
+    size_t               _n
+)
+{
+    size_t i;
+
+    for (i = 0; i < _n; i++)
+    {
+        if (D_STRING_FN_FOLD(_a[i]) != D_STRING_FN_FOLD(_b[i]))
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+/*
+d_string_fn_internal_max_suffix
+  Computes the maximal suffix of the folded needle under the byte ordering
+selected by `_greater`, returning its start position minus one (SIZE_MAX for
+the whole needle) and storing its period in `_period`.
+*/
+static size_t
+d_string_fn_internal_max_suffix
+(
+    const unsigned char* _n,
+    size_t               _nn,
+    bool                 _greater,
+    size_t*              _period
+)
+{
+    size_t        ip;
+    size_t        jp;
+    size_t        k;
+    size_t        p;
+    unsigned char a;
+    unsigned char b;
+
+    ip = SIZE_MAX;
+    jp = 0;
+    k  = 1;
+    p  = 1;
+
+    while ((jp + k) < _nn)
+    {
+        a = D_STRING_FN_FOLD(_n[ip + k]);
+        b = D_STRING_FN_FOLD(_n[jp + k]);
+
+        if (a == b)
+        {
+            if (k == p)
+            {
+                jp += p;
+                k   = 1;
+            }
+            else
+            {
+                k++;
+            }
+        }
+        else if ((a > b) == _greater)
+        {
+            jp += k;
+            k   = 1;
+            p   = jp - ip;
+        }
+        else
+        {
+            ip = jp++;
+            k  = 1;
+            p  = 1;
+        }
+    }
+
+    *_period = p;
+
+    return ip;
+}
+
+/*
+d_string_fn_internal_twoway_prepare
+  Computes the critical factorization, period and skip table of the folded
+needle.
+*/
+static void
+d_string_fn_internal_twoway_prepare
+(
+    const unsigned char*                _n,
+    size_t                              _nn,
+    struct d_string_fn_internal_twoway* _tw
+)
+{
+    size_t        i;
+    size_t        ms;
+    size_t        ms_alt;
+    size_t        p;
+    size_t        p_alt;
+    unsigned char c;
+
+    d_memset(_tw->byteset, 0, sizeof(_tw->byteset));
+
+    for (i = 0; i < _nn; i++)
+    {
+        c = D_STRING_FN_FOLD(_n[i]);
+
+        _tw->byteset[c >> 3] |= (unsigned char)(1u << (c & 7));
+        _tw->shift[c]         = i + 1;
+    }
+
+    // the critical factorization is the later of the two maximal suffixes
+    ms     = d_string_fn_internal_max_suffix(_n, _nn, true, &p);
+    ms_alt = d_string_fn_internal_max_suffix(_n, _nn, false, &p_alt);
+
+    if ((ms_alt + 1) > (ms + 1))
+    {
+        ms = ms_alt;
+        p  = p_alt;
+    }
+
+    // a needle is periodic if its left half repeats at distance p
+    for (i = 0; i < (ms + 1); i++)
+    {
+        if (D_STRING_FN_FOLD(_n[i]) != D_STRING_FN_FOLD(_n[i + p]))
+        {
+            break;
+        }
+    }
+
+    _tw->ms = ms;
+
+    if (i < (ms + 1))
+    {
+        _tw->mem0   = 0;
+        _tw->period = ( (ms > (_nn - ms - 1)) ? ms : (_nn - ms - 1) ) + 1;
+    }
+    else
+    {
+        _tw->mem0   = _nn - p;
+        _tw->period = p;
+    }
+
+    return;
+}
+
+/*
+d_string_fn_internal_twoway_find
+  Case-folded forward Two-Way search over a haystack of known length. Runs in
+O(n + m) time regardless of input and never reads past `_h + _hn`.
+*/
+static const char*
+d_string_fn_internal_twoway_find
+(
+    const unsigned char*                      _h,
+    size_t                                    _hn,
+    const unsigned char*                      _n,
+    size_t                                    _nn,
+    const struct d_string_fn_internal_twoway* _tw
+)
+{
+    const unsigned char* w;
+    size_t               pos;
+    size_t               mem;
+    size_t               k;
+    unsigned char        c;
+
+    pos = 0;
+    mem = 0;
+
+    while ((_hn - pos) >= _nn)
+    {
+        w = _h + pos;
+        c = D_STRING_FN_FOLD(w[_nn - 1]);
+
+        // skip on the window's last byte
+        if (_tw->byteset[c >> 3] & (1u << (c & 7)))
+        {
+            k = _nn - _tw->shift[c];
+
+            if (k)
+            {
+                pos += (k < mem) ? mem : k;
+                mem  = 0;
+
+                continue;
+            }
+        }
+        else
+        {
+            pos += _nn;
+            mem  = 0;
+
+            continue;
+        }
+
+        // compare the right half
+        k = ((_tw->ms + 1) > mem) ? (_tw->ms + 1) : mem;
+
+        while ( (k < _nn) &&
+                (D_STRING_FN_FOLD(_n[k]) == D_STRING_FN_FOLD(w[k])) )
+        {
+            k++;
+        }
+
+        if (k < _nn)
+        {
+            pos += k - _tw->ms;
+            mem  = 0;
+
+            continue;
+        }
+
+        // compare the left half
+        k = _tw->ms + 1;
+
+        while ( (k > mem) &&
+                (D_STRING_FN_FOLD(_n[k - 1]) == D_STRING_FN_FOLD(w[k - 1])) )
+        {
+            k--;
+        }
+
+        if (k <= mem)
+        {
+            return (const char*)w;
+        }
+
+        pos += _tw->period;
+        mem  = _tw->mem0;
+    }
+
+    return NULL;
+}
+
+/*
+d_string_fn_internal_case_verify
+  Verifies the candidates in `_mask` (one bit per position, `_shift` bits
+per position, starting at `_p`) with a folded compare. Returns the first
+match, or NULL after adding the verification work to `*_work`.
+*/
+static D_INLINE const char*
+d_string_fn_internal_case_verify
+(
+    const unsigned char* _p,
+    const unsigned char* _n,
+    size_t               _nn,
+    uint64_t             _mask,
+    unsigned             _shift,
+    size_t*              _work
+)
+{
+    unsigned offset;
+
+    while (_mask != 0)
+    {
+        offset = d_string_fn_internal_ctz64(_mask) >> _shift;
+
+        if (d_string_fn_internal_caseeq(_p + offset + 1, _n + 1, _nn - 1))
+        {
+            return (const char*)(_p + offset);
+        }
+
+        *_work += _nn;
+        _mask  &= (_mask - 1);
+    }
+
+    return NULL;
+}
+
+/*
+d_string_fn_internal_case_scan_none
+  Candidate scan for CPUs without a usable vector unit: examines nothing and
+leaves the whole range to the scalar filter.
+*/
+static const char*
+d_string_fn_internal_case_scan_none
+(
+    const unsigned char* _h,
+    const unsigned char* _n,
+    size_t               _nn,
+    size_t               _limit,
+    size_t*              _i,
+    size_t*              _work
+)
+{
+    (void)_h;
+    (void)_n;
+    (void)_nn;
+    (void)_limit;
+    (void)_i;
+    (void)_work;
+
+    return NULL;
+}
+
+#if ( defined(D_STRING_FN_CASE_AVX2) ||                           \
+      defined(D_STRING_FN_CASE_AVX2_DISPATCH) )
+
+/*
+d_string_fn_internal_case_scan_avx2
+  AVX2 candidate scan: tests 32 start positions per step for a matching
+first and last byte, verifying candidates as they are found. Stops with
+`*_i` at the first unexamined position once fewer than 32 remain before
+`_limit`, or once verification work exceeds the linear budget.
+*/
+D_STRING_FN_CASE_AVX2_FN static const char*
+d_string_fn_internal_case_scan_avx2
+(
+    const unsigned char* _h,
+    const unsigned char* _n,
+    size_t               _nn,
+    size_t               _limit,
+    size_t*              _i,
+    size_t*              _work
+)
+{
+    const char*   found;
+    unsigned char f;
+    unsigned char l;
+    size_t        i;
+    uint64_t      mask;
+    __m256i       first;
+    __m256i       first_bit;
+    __m256i       last;
+    __m256i       last_bit;
+
+    f         = D_STRING_FN_FOLD(_n[0]);
+    l         = D_STRING_FN_FOLD(_n[_nn - 1]);
+    first     = _mm256_set1_epi8((char)f);
+    first_bit = _mm256_set1_epi8((char)D_STRING_FN_CASE_BIT(f));
+    last      = _mm256_set1_epi8((char)l);
+    last_bit  = _mm256_set1_epi8((char)D_STRING_FN_CASE_BIT(l));
+
+    for (i = *_i; (i + 32) <= _limit; i += 32)
+    {
+        mask = (uint32_t)_mm256_movemask_epi8(_mm256_and_si256(
+            _mm256_cmpeq_epi8(first, _mm256_or_si256(first_bit,
+                _mm256_loadu_si256((const __m256i*)(_h + i)))),
+            _mm256_cmpeq_epi8(last, _mm256_or_si256(last_bit,
+                _mm256_loadu_si256((const __m256i*)(_h + i + _nn - 1))))));
+
+        found = d_string_fn_internal_case_verify(_h + i, _n, _nn, mask, 0, _work);
+
+        if (found != NULL)
+        {
+            return found;
+        }
+
+        // too many false positives; let Two-Way take over
+        if (*_work > (i + 32 + D_STRING_FN_CASE_VERIFY_SLACK))
+        {
+            i += 32;
+
+            break;
+        }
+    }
+
+    *_i = i;
+
+    return NULL;
+}
+
+#endif  // D_STRING_FN_CASE_AVX2 || D_STRING_FN_CASE_AVX2_DISPATCH
+
+#if defined(D_STRING_FN_CASE_SSE2)
+
+/*
+d_string_fn_internal_case_scan_sse2
+  SSE2 candidate scan; as `d_string_fn_internal_case_scan_avx2`, 16 start
+positions per step.
+*/
+static const char*
+d_string_fn_internal_case_scan_sse2
+(
+    const unsigned char* _h,
+    const unsigned char* _n,
+    size_t               _nn,
+    size_t               _limit,
+    size_t*              _i,
+    size_t*              _work
+)
+{
+    const char*   found;
+    unsigned char f;
+    unsigned char l;
+    size_t        i;
+    uint64_t      mask;
+    __m128i       first;
+    __m128i       first_bit;
+    __m128i       last;
+    __m128i       last_bit;
+
+    f         = D_STRING_FN_FOLD(_n[0]);
+    l         = D_STRING_FN_FOLD(_n[_nn - 1]);
+    first     = _mm_set1_epi8((char)f);
+    first_bit = _mm_set1_epi8((char)D_STRING_FN_CASE_BIT(f));
+    last      = _mm_set1_epi8((char)l);
+    last_bit  = _mm_set1_epi8((char)D_STRING_FN_CASE_BIT(l));
+
+    for (i = *_i; (i + 16) <= _limit; i += 16)
+    {
+        mask = (uint32_t)_mm_movemask_epi8(_mm_and_si128(
+            _mm_cmpeq_epi8(first, _mm_or_si128(first_bit,
+                _mm_loadu_si128((const __m128i*)(_h + i)))),
+            _mm_cmpeq_epi8(last, _mm_or_si128(last_bit,
+                _mm_loadu_si128((const __m128i*)(_h + i + _nn - 1))))));
+
+        found = d_string_fn_internal_case_verify(_h + i, _n, _nn, mask, 0, _work);
+
+        if (found != NULL)
+        {
+            return found;
+        }
+
+        // too many false positives; let Two-Way take over
+        if (*_work > (i + 16 + D_STRING_FN_CASE_VERIFY_SLACK))
+        {
+            i += 16;
+
+            break;
+        }
+    }
+
+    *_i = i;
+
+    return NULL;
+}
+
+#elif defined(D_STRING_FN_CASE_NEON)
+
+/*
+d_string_fn_internal_case_scan_neon
+  NEON candidate scan; as `d_string_fn_internal_case_scan_avx2`, 16 start
+positions per step. Each 0x00/0xFF lane is narrowed to a nibble, so a
+position spans four mask bits.
+*/
+static const char*
+d_string_fn_internal_case_scan_neon
+(
+    const unsigned char* _h,
+    const unsigned char* _n,
+    size_t               _nn,
+    size_t               _limit,
+    size_t*              _i,
+    size_t*              _work
+)
+{
+    const char*   found;
+    unsigned char f;
+    unsigned char l;
+    size_t        i;
+    uint64_t      mask;
+    uint8x16_t    first;
+    uint8x16_t    first_bit;
+    uint8x16_t    last;
+    uint8x16_t    last_bit;
+
+    f         = D_STRING_FN_FOLD(_n[0]);
+    l         = D_STRING_FN_FOLD(_n[_nn - 1]);
+    first     = vdupq_n_u8(f);
+    first_bit = vdupq_n_u8(D_STRING_FN_CASE_BIT(f));
+    last      = vdupq_n_u8(l);
+    last_bit  = vdupq_n_u8(D_STRING_FN_CASE_BIT(l));
+
+    for (i = *_i; (i + 16) <= _limit; i += 16)
+    {
+        mask = vget_lane_u64(vreinterpret_u64_u8(vshrn_n_u16(
+            vreinterpretq_u16_u8(vandq_u8(
+                vceqq_u8(first, vorrq_u8(first_bit, vld1q_u8(_h + i))),
+                vceqq_u8(last, vorrq_u8(last_bit,
+                                        vld1q_u8(_h + i + _nn - 1))))),
+            4)), 0);
+        mask &= 0x8888888888888888ULL;
+
+        found = d_string_fn_internal_case_verify(_h + i, _n, _nn, mask, 2, _work);
+
+        if (found != NULL)
+        {
+            return found;
+        }
+
+        // too many false positives; let Two-Way take over
+        if (*_work > (i + 16 + D_STRING_FN_CASE_VERIFY_SLACK))
+        {
+            i += 16;
+
+            break;
+        }
+    }
+
+    *_i = i;
+
+    return NULL;
+}
+
+#endif  // D_STRING_FN_CASE_SSE2 / D_STRING_FN_CASE_NEON
+
+// the candidate scan resolved for the running CPU (see d_env_cpu_features);
+// concurrent first calls store the same pointer
+static const char* (*volatile d_string_fn_internal_case_scan_active)(
+    const unsigned char*, const unsigned char*, size_t, size_t, size_t*,
+    size_t*) = NULL;
+
+/*
+d_string_fn_internal_case_scan
+  Runs the widest candidate scan the CPU supports, resolving it on first use.
+*/
+static const char*
+d_string_fn_internal_case_scan
+(
+    const unsigned char* _h,
+    const unsigned char* _n,
+    size_t               _nn,
+    size_t               _limit,
+    size_t*              _i,
+    size_t*              _work
+)
+{
+    const char* (*scan)(const unsigned char*, const unsigned char*, size_t,
+                        size_t, size_t*, size_t*);
+    uint32_t    features;
+
+    scan = d_string_fn_internal_case_scan_active;
+
+    if (scan == NULL)
+    {
+        features = d_env_cpu_features();
+        scan     = d_string_fn_internal_case_scan_none;
+
+    #if defined(D_STRING_FN_CASE_SSE2)
+        if (features & D_ENV_CPU_FEATURE_SSE2)
+        {
+            scan = d_string_fn_internal_case_scan_sse2;
+        }
+    #elif defined(D_STRING_FN_CASE_NEON)
+        if (features & D_ENV_CPU_FEATURE_NEON)
+        {
+            scan = d_string_fn_internal_case_scan_neon;
+        }
+    #endif
+
+    #if ( defined(D_STRING_FN_CASE_AVX2) ||                       \
+          defined(D_STRING_FN_CASE_AVX2_DISPATCH) )
+        if (features & D_ENV_CPU_FEATURE_AVX2)
+        {
+            scan = d_string_fn_internal_case_scan_avx2;
+        }
+    #endif
+
+        (void)features;
+        d_string_fn_internal_case_scan_active = scan;
+    }
+
+    return scan(_h, _n, _nn, _limit, _i, _work);
+}
+
+/*
+d_string_fn_internal_case_filter
+  Scans for candidate positions whose first and last bytes both match the
+folded needle, verifying each with a folded compare. Stops with `*_pos` set to
+the first unexamined position once the remaining candidates no longer fill a
+block, or once verification work exceeds the linear budget.
+*/
+static const char*
+d_string_fn_internal_case_filter
+(
+    const unsigned char* _h,
+    size_t               _hn,
+    const unsigned char* _n,
+    size_t               _nn,
+    size_t*              _pos
+)
+{
+    const char*   found;
+    unsigned char f;
+    unsigned char l;
+    size_t        i;
+    size_t        limit;
+    size_t        work;
+
+    f     = D_STRING_FN_FOLD(_n[0]);
+    l     = D_STRING_FN_FOLD(_n[_nn - 1]);
+    i     = 0;
+    work  = 0;
+    limit = _hn - _nn + 1;  // number of candidate start positions
+
+    // vector blocks first
+    found = d_string_fn_internal_case_scan(_h, _n, _nn, limit, &i, &work);
+
+    if (found != NULL)
+    {
+        return found;
+    }
+
+    if (work > (i + D_STRING_FN_CASE_VERIFY_SLACK))
+    {
+        *_pos = i;
+
+        return NULL;
+    }
+
+    // scalar tail (or the whole scan, without a vector unit)
+    while (i < limit)
+    {
+        if ( (D_STRING_FN_FOLD(_h[i]) == f) &&
+             (D_STRING_FN_FOLD(_h[i + _nn - 1]) == l) )
+        {
+            if (d_string_fn_internal_caseeq(_h + i + 1, _n + 1, _nn - 1))
+            {
+                return (const char*)(_h + i);
+            }
+
+            work += _nn;
+        }
+
+        i++;
+
+        if (work > (i + D_STRING_FN_CASE_VERIFY_SLACK))
+        {
+            break;
+        }
+    }
+
+    *_pos = i;
+
+    return NULL;
+}
+
+/*
+d_memcasemem
+  Find first occurrence of a byte sequence within a buffer, ignoring ASCII
+case. Both lengths are explicit, so embedded null bytes are ordinary data and
+nothing past either buffer is read. Runs in worst-case linear time: candidates
+are filtered on their first and last bytes (vectorized where available) and
+the search falls back to a case-folded Two-Way scan if too many of them fail.
+
+Parameter(s):
+  _haystack:     buffer to search within
+  _haystack_len: length of _haystack, in bytes
+  _needle:       byte sequence to search for
+  _needle_len:   length of _needle, in bytes
+Return:
+  Pointer to first occurrence of _needle in _haystack, or NULL if:
+  - _needle is not found, or
+  - either pointer is NULL (an empty _needle matches at _haystack)
+*/
+void*
+d_memcasemem
+(
+    const void* _haystack,
+    size_t      _haystack_len,
+    const void* _needle,
+    size_t      _needle_len
+)
+{
+    struct d_string_fn_internal_twoway tw;
+    const unsigned char*               h;
+    const unsigned char*               n;
+    const char*                        found;
+    size_t                             pos;
+
+    if ( (_haystack == NULL) ||
+         (_needle == NULL) )
+    {
+        return NULL;
+    }
+
+    if (_needle_len == 0)
+    {
+        return (void*)_haystack;
+    }
+
+    if (_needle_len > _haystack_len)
+    {
+        return NULL;
+    }
+
+    h     = (const unsigned char*)_haystack;
+    n     = (const unsigned char*)_needle;
+    pos   = 0;
+    found = d_string_fn_internal_case_filter(h,
+                                             _haystack_len,
+                                             n,
+                                             _needle_len,
+                                             &pos);
+
+    if ( (found != NULL) ||
+         ((_haystack_len - pos) < _needle_len) )
+    {
+        return (void*)found;
+    }
+
+    d_string_fn_internal_twoway_prepare(n, _needle_len, &tw);
+
+    return (void*)d_string_fn_internal_twoway_find(h + pos,
+                                                   _haystack_len - pos,
+                                                   n,
+                                                   _needle_len,
+                                                   &tw);
+}
+
 /*
 d_strcasestr
-  Find first occurrence of substring in string, ignoring case.
+  Find first occurrence of substring in string, ignoring ASCII case. Worst-
+case linear time; see d_memcasemem.
 
 Parameter(s):
   _haystack: null-terminated string to search within
@@ -508,18 +1333,93 @@ d_strcasestr
         return (char*)_haystack;
     }
     
-    size_t needle_len = strlen(_needle);
-    
-    while (*_haystack != '\0')
+    return (char*)d_memcasemem(_haystack,
+                               strlen(_haystack),
+                               _needle,
+                               strlen(_needle));
+}
+
+/******************************************************************************
+* Internal Case Mapping and Reversal Helpers
+******************************************************************************/
+
+/*
+d_string_fn_internal_case_map
+  Maps `_p[0.._n)` to lowercase, or to uppercase if `_upper` is true, eight
+bytes per step. Words of pure ASCII are mapped with bit arithmetic; a word
+holding any byte >= 0x80 goes through `tolower`/`toupper` byte by byte so
+that locale-specific mappings of those bytes are kept.
+*/
+static void
+d_string_fn_internal_case_map
+(
+    unsigned char* _p,
+    size_t         _n,
+    bool           _upper
+)
+{
+    const uint64_t ones  = 0x0101010101010101ULL;
+    const uint64_t first = _upper ? 'a' : 'A';
+    uint64_t       word;
+    uint64_t       low;
+    uint64_t       letters;
+    size_t         i;
+    size_t         k;
+
+    for (i = 0; (i + 8) <= _n; i += 8)
     {
-        if (d_strncasecmp(_haystack, _needle, needle_len) == 0)
+        memcpy(&word, _p + i, sizeof(word));
+
+        if ((word & (0x80 * ones)) == 0)
+        {
+            // high bit of each byte: at or above `first` and not past 'z'/'Z'
+            low     = word;
+            letters = (low + ((0x80 - first) * ones)) &
+                      ~(low + ((0x7F - (first + 25)) * ones)) &
+                      (0x80 * ones);
+            word   ^= letters >> 2;
+            memcpy(_p + i, &word, sizeof(word));
+        }
+        else
         {
-            return (char*)_haystack;
+            for (k = i; k < (i + 8); k++)
+            {
+                _p[k] = (unsigned char)(_upper ? toupper(_p[k])
+                                               : tolower(_p[k]));
+            }
         }
-        _haystack++;
     }
-    
-    return NULL;
+
+    for (; i < _n; i++)
+    {
+        _p[i] = (unsigned char)(_upper ? toupper(_p[i]) : tolower(_p[i]));
+    }
+
+    return;
+}
+
+/*
+d_string_fn_internal_bswap64
+  Reverses the byte order of `_x`.
+*/
+static D_INLINE uint64_t
+d_string_fn_internal_bswap64
+(
+    uint64_t _x
+)
+{
+#if defined(__GNUC__) || defined(__clang__)
+    return __builtin_bswap64(_x);
+#elif defined(_MSC_VER)
+    return _byteswap_uint64(_x);
+#else
+    _x = ((_x & 0x00FF00FF00FF00FFULL) << 8)  |
+         ((_x >> 8)  & 0x00FF00FF00FF00FFULL);
+    _x = ((_x & 0x0000FFFF0000FFFFULL) << 16) |
+         ((_x >> 16) & 0x0000FFFF0000FFFFULL);
+
+    return (_x << 32) | (_x >> 32);
+#endif
 }
 
 /*
@@ -541,16 +1441,10 @@ d_strlwr
     {
         return NULL;
     }
-    
-    char* original = _str;
-    
-    while (*_str != '\0')
-    {
-        *_str = (char)tolower((unsigned char)*_str);
-        _str++;
-    }
-    
-    return original;
+
+    d_string_fn_internal_case_map((unsigned char*)_str, strlen(_str), false);
+
+    return _str;
 }
 
 /*
@@ -572,16 +1466,10 @@ d_strupr
     {
         return NULL;
     }
-    
-    char* original = _str;
-    
-    while (*_str != '\0')
-    {
-        *_str = (char)toupper((unsigned char)*_str);
-        _str++;
-    }
-    
-    return original;
+
+    d_string_fn_internal_case_map((unsigned char*)_str, strlen(_str), true);
+
+    return _str;
 }
 
 /*
@@ -604,25 +1492,39 @@ d_strrev
         return NULL;
     }
     
-    size_t len = strlen(_str);
-    
-    if (len <= 1)
+    size_t   len;
+    size_t   i;
+    size_t   j;
+    uint64_t head;
+    uint64_t tail;
+    char     temp;
+
+    len = strlen(_str);
+    i   = 0;
+    j   = len;
+
+    // swap byte-reversed words from both ends while two or more remain
+    while ((j - i) >= 16)
     {
-        return _str;
+        memcpy(&head, _str + i, sizeof(head));
+        memcpy(&tail, _str + j - 8, sizeof(tail));
+        head = d_string_fn_internal_bswap64(head);
+        tail = d_string_fn_internal_bswap64(tail);
+        memcpy(_str + i, &tail, sizeof(tail));
+        memcpy(_str + j - 8, &head, sizeof(head));
+        i += 8;
+        j -= 8;
     }
-    
-    char* start = _str;
-    char* end = _str + len - 1;
-    
-    while (start < end)
+
+    while ((j - i) >= 2)
     {
-        char temp = *start;
-        *start = *end;
-        *end = temp;
-        start++;
-        end--;
+        j--;
+        temp    = _str[i];
+        _str[i] = _str[j];
+        _str[j] = temp;
+        i++;
     }
-    
+
     return _str;
 }
 
@@ -4,7 +4,7 @@
 *   Unit tests for the dfile module (cross-platform file I/O).
 *   Tests cover secure file opening, large file support, file descriptors,
 * synchronization, locking, temporary files, metadata, directories, path
-* utilities, symbolic links, pipes, and binary I/O helpers.
+* utilities, symbolic links, pipes, binary I/O helpers, and glob patterns.
 *
 *
 * path:      \inc\test\dfile_tests_sa.h
@@ -130,6 +130,7 @@ struct d_test_object* d_tests_dfile_mkdir(void);
 struct d_test_object* d_tests_dfile_mkdir_p(void);
 struct d_test_object* d_tests_dfile_rmdir(void);
 struct d_test_object* d_tests_dfile_opendir_readdir_closedir(void);
+struct d_test_object* d_tests_dfile_opendir_ex(void);
 struct d_test_object* d_tests_dfile_rewinddir(void);
 struct d_test_object* d_tests_dfile_directory_operations_all(void);
 
@@ -166,10 +167,18 @@ struct d_test_object* d_tests_dfile_pipe_operations_all(void);
 
 // XV. binary I/O helpers tests
 struct d_test_object* d_tests_dfile_fread_all(void);
+struct d_test_object* d_tests_dfile_fread_all_ex(void);
 struct d_test_object* d_tests_dfile_fwrite_all(void);
 struct d_test_object* d_tests_dfile_fappend_all(void);
 struct d_test_object* d_tests_dfile_binary_io_all(void);
 
+// XVI. glob pattern tests
+struct d_test_object* d_tests_dfile_glob_match(void);
+struct d_test_object* d_tests_dfile_glob_globstar_runs(void);
+struct d_test_object* d_tests_dfile_glob_set(void);
+struct d_test_object* d_tests_dfile_readdir_glob(void);
+struct d_test_object* d_tests_dfile_glob_patterns_all(void);
+
 // null parameter tests
 struct d_test_object* d_tests_dfile_null_params_all(void);
 
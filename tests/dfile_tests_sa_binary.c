@@ -94,6 +94,94 @@ d_tests_dfile_fread_all
 }
 
 
+/*
+d_tests_dfile_fread_all_ex
+  Tests d_fread_all_ex for reading entire files into a caller's allocator.
+  Tests the following:
+  - reads entire file content into an arena
+  - a NULL allocator reads through the default allocator
+  - d_allocator_large reads into an aligned buffer
+  - returns NULL for nonexistent file and NULL path
+*/
+struct d_test_object*
+d_tests_dfile_fread_all_ex
+(
+    void
+)
+{
+    struct d_test_object* group;
+    struct d_arena*       arena;
+    char                  path_buf[D_INTERNAL_TEST_PATH_BUF_SIZE];
+    void*                 content;
+    size_t                size;
+    bool                  test_arena;
+    bool                  test_default;
+    bool                  test_large;
+    bool                  test_invalid;
+    size_t                idx;
+
+    // setup
+    d_tests_dfile_get_test_path(path_buf,
+                               sizeof(path_buf),
+                               D_TEST_DFILE_TEST_FILENAME);
+    arena = d_arena_new(0);
+
+    // test 1: read into an arena
+    content    = d_fread_all_ex(d_arena_allocator(arena), path_buf, &size);
+    test_arena = (content != NULL) &&
+                 (size == strlen(D_TEST_DFILE_TEST_CONTENT)) &&
+                 (strcmp((char*)content, D_TEST_DFILE_TEST_CONTENT) == 0) &&
+                 (d_arena_used(arena) >= size + 1);
+
+    // test 2: NULL allocator
+    content      = d_fread_all_ex(NULL, path_buf, &size);
+    test_default = (content != NULL) &&
+                   (strcmp((char*)content, D_TEST_DFILE_TEST_CONTENT) == 0);
+    d_allocator_free(NULL, content, size + 1);
+
+    // test 3: large buffer allocator
+    content    = d_fread_all_ex(d_allocator_large(), path_buf, &size);
+    test_large = (content != NULL) &&
+                 (strcmp((char*)content, D_TEST_DFILE_TEST_CONTENT) == 0) &&
+                 (((uintptr_t)content % D_MEMORY_CACHE_LINE_SIZE) == 0);
+    d_allocator_free(d_allocator_large(), content, size + 1);
+
+    // test 4: nonexistent file and NULL path
+    test_invalid = (d_fread_all_ex(d_arena_allocator(arena),
+                                   "nonexistent_fread_test.txt",
+                                   &size) == NULL) &&
+                   (d_fread_all_ex(d_arena_allocator(arena),
+                                   NULL,
+                                   &size) == NULL);
+
+    d_arena_free(arena);
+
+    // build result tree
+    group = d_test_object_new_interior("d_fread_all_ex", 4);
+
+    if (!group)
+    {
+        return NULL;
+    }
+
+    idx = 0;
+    group->elements[idx++] = D_ASSERT_TRUE("arena",
+                                           test_arena,
+                                           "d_fread_all_ex reads into the allocator");
+    group->elements[idx++] = D_ASSERT_TRUE("default",
+                                           test_default,
+                                           "d_fread_all_ex uses the default for NULL");
+    group->elements[idx++] = D_ASSERT_TRUE("large",
+                                           test_large,
+                                           "d_fread_all_ex reads into large buffers");
+    group->elements[idx++] = D_ASSERT_TRUE("invalid",
+                                           test_invalid,
+                                           "d_fread_all_ex returns NULL on failure");
+
+    return group;
+}
+
+
 /*
 d_tests_dfile_fwrite_all
   Tests d_fwrite_all for writing entire files.
@@ -260,6 +348,7 @@ d_tests_dfile_binary_io_all
   Runs all binary I/O helper tests.
   Tests the following:
   - d_fread_all
+  - d_fread_all_ex
   - d_fwrite_all
   - d_fappend_all
 */
@@ -272,7 +361,7 @@ d_tests_dfile_binary_io_all
     struct d_test_object* group;
     size_t                idx;
 
-    group = d_test_object_new_interior("XV. Binary I/O Helpers", 3);
+    group = d_test_object_new_interior("XV. Binary I/O Helpers", 4);
 
     if (!group)
     {
@@ -281,6 +370,7 @@ d_tests_dfile_binary_io_all
 
     idx = 0;
     group->elements[idx++] = d_tests_dfile_fread_all();
+    group->elements[idx++] = d_tests_dfile_fread_all_ex();
     group->elements[idx++] = d_tests_dfile_fwrite_all();
     group->elements[idx++] = d_tests_dfile_fappend_all();
 
@@ -370,6 +370,93 @@ d_tests_dfile_rewinddir
 }
 
 
+/*
+d_tests_dfile_opendir_ex
+  Tests d_opendir_ex, which allocates the directory handle from a caller's
+  allocator.
+  Tests the following:
+  - opens directory with the handle taken from an arena
+  - reads directory entries
+  - d_closedir closes it, leaving the handle to the arena
+  - returns NULL for nonexistent directory
+*/
+struct d_test_object*
+d_tests_dfile_opendir_ex
+(
+    void
+)
+{
+    struct d_test_object* group;
+    struct d_arena*       arena;
+    struct d_dir_t*       dir;
+    size_t                used;
+    size_t                entry_count;
+    bool                  test_open;
+    bool                  test_read;
+    bool                  test_close;
+    bool                  test_nonexistent;
+    size_t                idx;
+
+    arena       = d_arena_new(0);
+    test_read   = false;
+    test_close  = false;
+    entry_count = 0;
+
+    // test 1: open test directory from the arena
+    dir       = d_opendir_ex(d_arena_allocator(arena), D_TEST_DFILE_TEMP_DIR);
+    used      = d_arena_used(arena);
+    test_open = (arena != NULL) &&
+                (dir != NULL) &&
+                (used > 0);
+
+    if (dir)
+    {
+        // test 2: read entries
+        while (d_readdir(dir) != NULL)
+        {
+            entry_count++;
+        }
+
+        test_read = (entry_count >= 1);
+
+        // test 3: close directory; the arena keeps the memory
+        test_close = (d_closedir(dir) == 0) &&
+                     (d_arena_used(arena) == used);
+    }
+
+    // test 4: nonexistent directory
+    dir              = d_opendir_ex(d_arena_allocator(arena),
+                                    "nonexistent_opendir_test");
+    test_nonexistent = (dir == NULL);
+
+    d_arena_free(arena);
+
+    // build result tree
+    group = d_test_object_new_interior("d_opendir_ex", 4);
+
+    if (!group)
+    {
+        return NULL;
+    }
+
+    idx = 0;
+    group->elements[idx++] = D_ASSERT_TRUE("open",
+                                           test_open,
+                                           "d_opendir_ex allocates from the allocator");
+    group->elements[idx++] = D_ASSERT_TRUE("read",
+                                           test_read,
+                                           "d_readdir reads entries");
+    group->elements[idx++] = D_ASSERT_TRUE("close",
+                                           test_close,
+                                           "d_closedir releases through the allocator");
+    group->elements[idx++] = D_ASSERT_TRUE("nonexistent",
+                                           test_nonexistent,
+                                           "d_opendir_ex returns NULL for nonexistent");
+
+    return group;
+}
+
+
 /*
 d_tests_dfile_directory_operations_all
   Runs all directory operation tests.
@@ -378,6 +465,7 @@ d_tests_dfile_directory_operations_all
   - d_mkdir_p
   - d_rmdir
   - d_opendir/d_readdir/d_closedir
+  - d_opendir_ex
   - d_rewinddir
 */
 struct d_test_object*
@@ -389,7 +477,7 @@ d_tests_dfile_directory_operations_all
     struct d_test_object* group;
     size_t                idx;
 
-    group = d_test_object_new_interior("X. Directory Operations", 5);
+    group = d_test_object_new_interior("X. Directory Operations", 6);
 
     if (!group)
     {
@@ -401,6 +489,7 @@ d_tests_dfile_directory_operations_all
     group->elements[idx++] = d_tests_dfile_mkdir_p();
     group->elements[idx++] = d_tests_dfile_rmdir();
     group->elements[idx++] = d_tests_dfile_opendir_readdir_closedir();
+    group->elements[idx++] = d_tests_dfile_opendir_ex();
     group->elements[idx++] = d_tests_dfile_rewinddir();
 
     return group;
@@ -0,0 +1,646 @@
+/******************************************************************************
+* djinterp [test]                                         dfile_tests_sa_glob.c
+*
+*   Tests for glob patterns (d_glob_compile, d_glob_match, d_glob_set_*,
+* d_readdir_glob).
+*
+*
+* path:      \src\test\dfile_tests_sa_glob.c
+* link:      TBA
+* author(s): Samuel 'teer' Neal-Blim                          date: 2025.12.25
+******************************************************************************/
+#include "dfile_tests_sa.h"
+
+
+/******************************************************************************
+ * XVI. GLOB PATTERN TESTS
+ *****************************************************************************/
+
+/*
+d_tests_dfile_glob_match
+  Tests d_glob_compile and d_glob_match for single patterns.
+  Tests the following:
+  - literal patterns and `*`, `?` wildcards
+  - `*` and `?` do not match a separator
+  - bracket expressions, ranges and negation
+  - `**` matches any number of path components, including none
+  - D_GLOB_NOCASE and D_GLOB_PERIOD flags
+  - many stars do not cause backtracking blowup
+  - d_glob_match_n matches a length-limited slice
+  - returns NULL for NULL pattern
+*/
+struct d_test_object*
+d_tests_dfile_glob_match
+(
+    void
+)
+{
+    struct d_test_object*  group;
+    struct d_glob_pattern* glob;
+    char                   long_path[257];
+    bool                   test_literal;
+    bool                   test_wildcards;
+    bool                   test_separator;
+    bool                   test_bracket;
+    bool                   test_globstar;
+    bool                   test_nocase;
+    bool                   test_period;
+    bool                   test_stars;
+    bool                   test_match_n;
+    bool                   test_null;
+    size_t                 idx;
+
+    // test 1: literal pattern
+    glob         = d_glob_compile("src/dfile.c", 0);
+    test_literal = (glob != NULL) &&
+                   (d_glob_match(glob, "src/dfile.c") == 1) &&
+                   (d_glob_match(glob, "src/dfile.h") == 0) &&
+                   (d_glob_match(glob, "src/dfile.cc") == 0);
+    d_glob_free(glob);
+
+    // test 2: `*` and `?` wildcards
+    glob           = d_glob_compile("d*_tests_?a.c", 0);
+    test_wildcards = (glob != NULL) &&
+                     (d_glob_match(glob, "dfile_tests_sa.c") == 1) &&
+                     (d_glob_match(glob, "d_tests_xa.c") == 1) &&
+                     (d_glob_match(glob, "dfile_tests_a.c") == 0);
+    d_glob_free(glob);
+
+    // test 3: wildcards stay within one path component
+    glob           = d_glob_compile("src/*.c", 0);
+    test_separator = (glob != NULL) &&
+                     (d_glob_match(glob, "src/dfile.c") == 1) &&
+                     (d_glob_match(glob, "src/sub/dfile.c") == 0);
+    d_glob_free(glob);
+
+    glob           = d_glob_compile("a?b", 0);
+    test_separator = test_separator &&
+                     (glob != NULL) &&
+                     (d_glob_match(glob, "a/b") == 0);
+    d_glob_free(glob);
+
+    // test 4: bracket expressions
+    glob         = d_glob_compile("file[0-9][!a-c].txt", 0);
+    test_bracket = (glob != NULL) &&
+                   (d_glob_match(glob, "file7d.txt") == 1) &&
+                   (d_glob_match(glob, "file7b.txt") == 0) &&
+                   (d_glob_match(glob, "filex7.txt") == 0);
+    d_glob_free(glob);
+
+    // test 5: `**` spans components, including none
+    glob          = d_glob_compile("src/**/test_*.c", 0);
+    test_globstar = (glob != NULL) &&
+                    (d_glob_match(glob, "src/test_glob.c") == 1) &&
+                    (d_glob_match(glob, "src/a/b/test_glob.c") == 1) &&
+                    (d_glob_match(glob, "src/a/b/glob.c") == 0) &&
+                    (d_glob_match(glob, "inc/a/test_glob.c") == 0);
+    d_glob_free(glob);
+
+    // test 6: case-insensitive matching
+    glob        = d_glob_compile("*.TXT", D_GLOB_NOCASE);
+    test_nocase = (glob != NULL) &&
+                  (d_glob_match(glob, "readme.txt") == 1) &&
+                  (d_glob_match(glob, "README.Txt") == 1) &&
+                  (d_glob_match(glob, "readme.md") == 0);
+    d_glob_free(glob);
+
+    // test 7: leading periods need an explicit '.'
+    glob        = d_glob_compile("*", D_GLOB_PERIOD);
+    test_period = (glob != NULL) &&
+                  (d_glob_match(glob, "visible") == 1) &&
+                  (d_glob_match(glob, ".hidden") == 0);
+    d_glob_free(glob);
+
+    glob        = d_glob_compile(".*", D_GLOB_PERIOD);
+    test_period = test_period &&
+                  (glob != NULL) &&
+                  (d_glob_match(glob, ".hidden") == 1);
+    d_glob_free(glob);
+
+    // test 8: pathological star patterns stay linear
+    memset(long_path, 'a', sizeof(long_path) - 1);
+    long_path[sizeof(long_path) - 1] = '\0';
+
+    glob       = d_glob_compile("*a*a*a*a*a*a*a*a*a*a*a*a*b", 0);
+    test_stars = (glob != NULL) &&
+                 (d_glob_match(glob, long_path) == 0);
+    d_glob_free(glob);
+
+    // test 9: length-limited match
+    glob         = d_glob_compile("*.c", 0);
+    test_match_n = (glob != NULL) &&
+                   (d_glob_match_n(glob, "dfile.c.bak", 7) == 1) &&
+                   (d_glob_match_n(glob, "dfile.c.bak", 11) == 0);
+    d_glob_free(glob);
+
+    // test 10: NULL pattern
+    test_null = (d_glob_compile(NULL, 0) == NULL) &&
+                (d_glob_match(NULL, "x") == -1);
+
+    // build result tree
+    group = d_test_object_new_interior("d_glob_match", 10);
+
+    if (!group)
+    {
+        return NULL;
+    }
+
+    idx = 0;
+    group->elements[idx++] = D_ASSERT_TRUE("literal",
+                                           test_literal,
+                                           "d_glob_match matches literal patterns");
+    group->elements[idx++] = D_ASSERT_TRUE("wildcards",
+                                           test_wildcards,
+                                           "d_glob_match handles * and ?");
+    group->elements[idx++] = D_ASSERT_TRUE("separator",
+                                           test_separator,
+                                           "* and ? do not match a separator");
+    group->elements[idx++] = D_ASSERT_TRUE("bracket",
+                                           test_bracket,
+                                           "d_glob_match handles bracket expressions");
+    group->elements[idx++] = D_ASSERT_TRUE("globstar",
+                                           test_globstar,
+                                           "** matches any number of components");
+    group->elements[idx++] = D_ASSERT_TRUE("nocase",
+                                           test_nocase,
+                                           "D_GLOB_NOCASE ignores ASCII case");
+    group->elements[idx++] = D_ASSERT_TRUE("period",
+                                           test_period,
+                                           "D_GLOB_PERIOD hides leading periods");
+    group->elements[idx++] = D_ASSERT_TRUE("stars",
+                                           test_stars,
+                                           "many stars do not backtrack");
+    group->elements[idx++] = D_ASSERT_TRUE("match_n",
+                                           test_match_n,
+                                           "d_glob_match_n matches a slice");
+    group->elements[idx++] = D_ASSERT_TRUE("null",
+                                           test_null,
+                                           "NULL pattern is rejected");
+
+    return group;
+}
+
+
+/*
+d_tests_dfile_glob_reference_name
+  Reference matcher for one path component: `*`, `?` and literal characters,
+by plain backtracking.
+*/
+static bool
+d_tests_dfile_glob_reference_name
+(
+    const char* _pattern,
+    size_t      _pattern_length,
+    const char* _name,
+    size_t      _name_length
+)
+{
+    size_t i;
+
+    if (_pattern_length == 0)
+    {
+        return (_name_length == 0);
+    }
+
+    if (_pattern[0] == '*')
+    {
+        for (i = 0; i <= _name_length; i++)
+        {
+            if (d_tests_dfile_glob_reference_name(_pattern + 1,
+                                                  _pattern_length - 1,
+                                                  _name + i,
+                                                  _name_length - i))
+            {
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+    return (_name_length > 0) &&
+           ( (_pattern[0] == '?') ||
+             (_pattern[0] == _name[0]) ) &&
+           d_tests_dfile_glob_reference_name(_pattern + 1,
+                                             _pattern_length - 1,
+                                             _name + 1,
+                                             _name_length - 1);
+}
+
+/*
+d_tests_dfile_glob_reference
+  Reference matcher that walks a pattern and a path one '/'-separated
+component at a time: a `**` component matches any number of components,
+including none; any other component matches exactly one.
+*/
+static bool
+d_tests_dfile_glob_reference
+(
+    const char* _pattern,
+    const char* _path
+)
+{
+    const char* pattern_end;
+    const char* path_end;
+
+    pattern_end = strchr(_pattern, '/');
+    pattern_end = (pattern_end != NULL) ? pattern_end
+                                        : (_pattern + strlen(_pattern));
+
+    if ( (pattern_end - _pattern == 2) &&
+         (strncmp(_pattern, "**", 2) == 0) )
+    {
+        // `**` is the last component: it takes the rest of the path
+        if (*pattern_end == '\0')
+        {
+            return true;
+        }
+
+        // match no component here, or give `**` one more component
+        if (d_tests_dfile_glob_reference(pattern_end + 1, _path))
+        {
+            return true;
+        }
+
+        path_end = strchr(_path, '/');
+
+        return (path_end != NULL) &&
+               d_tests_dfile_glob_reference(_pattern, path_end + 1);
+    }
+
+    path_end = strchr(_path, '/');
+    path_end = (path_end != NULL) ? path_end : (_path + strlen(_path));
+
+    if (!d_tests_dfile_glob_reference_name(_pattern,
+                                           (size_t)(pattern_end - _pattern),
+                                           _path,
+                                           (size_t)(path_end - _path)))
+    {
+        return false;
+    }
+
+    if ( (*pattern_end == '\0') ||
+         (*path_end == '\0') )
+    {
+        return (*pattern_end == '\0') && (*path_end == '\0');
+    }
+
+    return d_tests_dfile_glob_reference(pattern_end + 1, path_end + 1);
+}
+
+/*
+d_tests_dfile_glob_globstar_runs
+  Tests d_glob_match on patterns with consecutive `**` components, against a
+component-wise reference matcher.
+  Tests the following:
+  - a trailing `**` after another `**` still matches whole components
+  - leading, inner and trailing `**` runs agree with the reference on every
+    sample path
+*/
+struct d_test_object*
+d_tests_dfile_glob_globstar_runs
+(
+    void
+)
+{
+    static const char* patterns[] =
+    {
+        "**", "**/**", "**/**/**", "a/**/**", "src/**/**", "**/a/**",
+        "**/**/a", "a/**/**/b", "**/a/**/**", "*/**/**", "a/**/b/**/**"
+    };
+    static const char* paths[] =
+    {
+        "a", "b", "a/b", "b/a", "a/b/c", "a/a", "x/a/y", "a/b/b",
+        "a/x/b/y", "src/x.c", "src/a/b/x.c", "b/b/a"
+    };
+    struct d_test_object*  group;
+    struct d_glob_pattern* glob;
+    size_t                 i;
+    size_t                 j;
+    size_t                 idx;
+    bool                   test_trailing;
+    bool                   test_reference;
+
+    // test 1: the cases that once matched only paths ending in '/'
+    glob          = d_glob_compile("**/**", 0);
+    test_trailing = (glob != NULL) &&
+                    (d_glob_match(glob, "a/b") == 1) &&
+                    (d_glob_match(glob, "a") == 1);
+    d_glob_free(glob);
+
+    glob          = d_glob_compile("a/**/**", 0);
+    test_trailing = test_trailing &&
+                    (glob != NULL) &&
+                    (d_glob_match(glob, "a/b") == 1) &&
+                    (d_glob_match(glob, "b/a") == 0);
+    d_glob_free(glob);
+
+    glob          = d_glob_compile("src/**/**", 0);
+    test_trailing = test_trailing &&
+                    (glob != NULL) &&
+                    (d_glob_match(glob, "src/x.c") == 1);
+    d_glob_free(glob);
+
+    // test 2: every pattern agrees with the reference on every path
+    test_reference = true;
+
+    for (i = 0; i < sizeof(patterns) / sizeof(patterns[0]); i++)
+    {
+        glob = d_glob_compile(patterns[i], 0);
+
+        if (!glob)
+        {
+            test_reference = false;
+
+            continue;
+        }
+
+        for (j = 0; j < sizeof(paths) / sizeof(paths[0]); j++)
+        {
+            if ( (d_glob_match(glob, paths[j]) == 1) !=
+                 d_tests_dfile_glob_reference(patterns[i], paths[j]) )
+            {
+                test_reference = false;
+            }
+        }
+
+        d_glob_free(glob);
+    }
+
+    // build result tree
+    group = d_test_object_new_interior("d_glob_match ** runs", 2);
+
+    if (!group)
+    {
+        return NULL;
+    }
+
+    idx = 0;
+    group->elements[idx++] = D_ASSERT_TRUE("trailing",
+                                           test_trailing,
+                                           "a trailing ** after ** matches components");
+    group->elements[idx++] = D_ASSERT_TRUE("reference",
+                                           test_reference,
+                                           "** runs agree with a component-wise matcher");
+
+    return group;
+}
+
+
+/*
+d_tests_dfile_glob_set
+  Tests d_glob_set_new and d_glob_set_match.
+  Tests the following:
+  - returns the index of the matching pattern
+  - returns the first pattern when several match
+  - returns -1 when no pattern matches
+  - sets larger than one state word match correctly
+  - returns NULL for NULL pattern entries
+*/
+struct d_test_object*
+d_tests_dfile_glob_set
+(
+    void
+)
+{
+    static const char* patterns[] =
+    {
+        "*.c",
+        "*.h",
+        "src/**",
+        "build/**/*.o"
+    };
+
+    struct d_test_object* group;
+    struct d_glob_set*    set;
+    const char*           many[40];
+    const char*           bad[2];
+    bool                  test_index;
+    bool                  test_first;
+    bool                  test_none;
+    bool                  test_large;
+    bool                  test_null;
+    size_t                i;
+    size_t                idx;
+
+    set = d_glob_set_new(patterns, 4, 0);
+
+    // test 1: index of the matching pattern
+    test_index = (set != NULL) &&
+                 (d_glob_set_match(set, "dfile.h") == 1) &&
+                 (d_glob_set_match(set, "build/x/y/z.o") == 3);
+
+    // test 2: first match wins
+    test_first = (set != NULL) &&
+                 (d_glob_set_match(set, "dfile.c") == 0) &&
+                 (d_glob_set_match(set, "src/readme") == 2);
+
+    // test 3: no match
+    test_none = (set != NULL) &&
+                (d_glob_set_match(set, "inc/dfile.txt") == -1);
+
+    d_glob_set_free(set);
+
+    // test 4: many patterns spanning several state words
+    for (i = 0; i < 40; i++)
+    {
+        many[i] = "long_pattern_*_never";
+    }
+
+    many[39] = "*_match_*.txt";
+    set      = d_glob_set_new(many, 40, 0);
+
+    test_large = (set != NULL) &&
+                 (d_glob_set_match(set, "a_match_b.txt") == 39) &&
+                 (d_glob_set_match(set, "long_pattern_x_never") == 0) &&
+                 (d_glob_set_match(set, "other") == -1);
+
+    d_glob_set_free(set);
+
+    // test 5: NULL entries
+    bad[0]    = "*.c";
+    bad[1]    = NULL;
+    test_null = (d_glob_set_new(bad, 2, 0) == NULL) &&
+                (d_glob_set_new(NULL, 1, 0) == NULL);
+
+    // build result tree
+    group = d_test_object_new_interior("d_glob_set", 5);
+
+    if (!group)
+    {
+        return NULL;
+    }
+
+    idx = 0;
+    group->elements[idx++] = D_ASSERT_TRUE("index",
+                                           test_index,
+                                           "d_glob_set_match returns pattern index");
+    group->elements[idx++] = D_ASSERT_TRUE("first",
+                                           test_first,
+                                           "d_glob_set_match returns first match");
+    group->elements[idx++] = D_ASSERT_TRUE("none",
+                                           test_none,
+                                           "d_glob_set_match returns -1 on no match");
+    group->elements[idx++] = D_ASSERT_TRUE("large",
+                                           test_large,
+                                           "large sets match correctly");
+    group->elements[idx++] = D_ASSERT_TRUE("null",
+                                           test_null,
+                                           "NULL patterns are rejected");
+
+    return group;
+}
+
+
+/*
+d_tests_dfile_readdir_glob
+  Tests d_readdir_glob and d_readdir_glob_set for filtered directory reads.
+  Tests the following:
+  - returns only entries matching a pattern
+  - returns only entries matching a pattern set, with the pattern index
+  - returns NULL for NULL parameters
+*/
+struct d_test_object*
+d_tests_dfile_readdir_glob
+(
+    void
+)
+{
+    static const char* patterns[] =
+    {
+        "*.txt",
+        "glob_*.c"
+    };
+
+    struct d_test_object*  group;
+    struct d_glob_pattern* glob;
+    struct d_glob_set*     set;
+    struct d_dir_t*        dir;
+    struct d_dirent_t*     entry;
+    char                   path_buf[D_INTERNAL_TEST_PATH_BUF_SIZE];
+    size_t                 index;
+    size_t                 count;
+    bool                   test_filter;
+    bool                   test_set;
+    bool                   test_null;
+    size_t                 idx;
+
+    // setup
+    d_tests_dfile_get_test_path(path_buf, sizeof(path_buf), "glob_a.c");
+    d_fwrite_all(path_buf, "a", 1);
+    d_tests_dfile_get_test_path(path_buf, sizeof(path_buf), "glob_b.h");
+    d_fwrite_all(path_buf, "b", 1);
+
+    // test 1: single pattern
+    glob        = d_glob_compile("glob_*", 0);
+    dir         = d_opendir(D_TEST_DFILE_TEMP_DIR);
+    test_filter = (glob != NULL) && (dir != NULL);
+    count       = 0;
+
+    while ( (test_filter) &&
+            ((entry = d_readdir_glob(dir, glob)) != NULL) )
+    {
+        test_filter = (strncmp(entry->d_name, "glob_", 5) == 0);
+        count++;
+    }
+
+    test_filter = test_filter && (count == 2);
+
+    if (dir)
+    {
+        d_closedir(dir);
+    }
+
+    d_glob_free(glob);
+
+    // test 2: pattern set
+    set      = d_glob_set_new(patterns, 2, 0);
+    dir      = d_opendir(D_TEST_DFILE_TEMP_DIR);
+    test_set = (set != NULL) && (dir != NULL);
+    count    = 0;
+
+    while ( (test_set) &&
+            ((entry = d_readdir_glob_set(dir, set, &index)) != NULL) )
+    {
+        if (strcmp(entry->d_name, "glob_a.c") == 0)
+        {
+            test_set = (index == 1);
+        }
+        else
+        {
+            test_set = (index == 0);
+        }
+
+        count++;
+    }
+
+    // the standard test file plus glob_a.c
+    test_set = test_set && (count >= 2);
+
+    // test 3: NULL parameters
+    test_null = (d_readdir_glob(NULL, NULL) == NULL) &&
+                (d_readdir_glob_set(dir, NULL, NULL) == NULL);
+
+    if (dir)
+    {
+        d_closedir(dir);
+    }
+
+    d_glob_set_free(set);
+
+    // build result tree
+    group = d_test_object_new_interior("d_readdir_glob", 3);
+
+    if (!group)
+    {
+        return NULL;
+    }
+
+    idx = 0;
+    group->elements[idx++] = D_ASSERT_TRUE("filter",
+                                           test_filter,
+                                           "d_readdir_glob returns matching entries");
+    group->elements[idx++] = D_ASSERT_TRUE("set",
+                                           test_set,
+                                           "d_readdir_glob_set returns matching entries");
+    group->elements[idx++] = D_ASSERT_TRUE("null",
+                                           test_null,
+                                           "d_readdir_glob rejects NULL");
+
+    return group;
+}
+
+
+/*
+d_tests_dfile_glob_patterns_all
+  Runs all glob pattern tests.
+  Tests the following:
+  - d_glob_compile / d_glob_match
+  - consecutive `**` components
+  - d_glob_set_new / d_glob_set_match
+  - d_readdir_glob / d_readdir_glob_set
+*/
+struct d_test_object*
+d_tests_dfile_glob_patterns_all
+(
+    void
+)
+{
+    struct d_test_object* group;
+    size_t                idx;
+
+    group = d_test_object_new_interior("XVI. Glob Patterns", 4);
+
+    if (!group)
+    {
+        return NULL;
+    }
+
+    idx = 0;
+    group->elements[idx++] = d_tests_dfile_glob_match();
+    group->elements[idx++] = d_tests_dfile_glob_globstar_runs();
+    group->elements[idx++] = d_tests_dfile_glob_set();
+    group->elements[idx++] = d_tests_dfile_readdir_glob();
+
+    return group;
+}
@@ -0,0 +1,998 @@
+/******************************************************************************
+* djinterp [test]                                               dmemory_bench.c
+*
+*   Throughput benchmark for the dmemory fill and copy functions. Not part of
+* the test suite: it is built by the `dmemory-bench` target, which is excluded
+* from the default build, and prints tables instead of asserting anything.
+*
+*   usage: dmemory-bench [memset|copy|interference|all] [max_bytes]
+*
+*   memset, copy: sizes double up to max_bytes (64 MiB by default). Each cell
+* is the best of D_BENCH_TRIALS runs, in GB/s. The `stream` column forces
+* non-temporal stores at every size and the `no stream` (fill) or `d_memcpy`
+* (copy) column never uses them, so the size from which `stream` wins is
+* the crossover that d_memory_stream_threshold should sit near on this
+* machine. The copy table adds d_memcpy_parallel at 2, 4, ... threads, up to
+* the hardware concurrency.
+*   interference: a victim thread chases pointers through a table half the
+* size of the last-level cache, first alone, then while the main thread
+* copies a buffer twice the size of that cache with each copy function. The
+* victim's ns/access shows how much of its working set each copy evicts; it
+* needs at least two hardware threads to mean anything.
+*
+*
+* path:      \tests\dmemory_bench.c
+* link:      TBA
+* author(s): Samuel 'teer' Neal-Blim                          date: 2026.10.16
+******************************************************************************/
+
+#include "..\inc\datomic.h"
+#include "..\inc\dmemory.h"
+#include "..\inc\dmutex.h"
+#include "..\inc\dtime.h"
+#include "..\inc\env.h"
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+
+/******************************************************************************
+ * BENCHMARK CONFIGURATION
+ *****************************************************************************/
+
+// D_BENCH_TRIALS
+//   constant: number of timed runs per cell; the fastest one is reported.
+#define D_BENCH_TRIALS          5
+
+// D_BENCH_BYTES_PER_TRIAL
+//   constant: bytes written per timed run, so small sizes repeat enough to be
+// measurable.
+#define D_BENCH_BYTES_PER_TRIAL ((size_t)256 * 1024 * 1024)
+
+// D_BENCH_DEFAULT_MAX
+//   constant: largest size measured unless one is given on the command line.
+#define D_BENCH_DEFAULT_MAX     ((size_t)64 * 1024 * 1024)
+
+// D_BENCH_FILL_COLUMNS
+//   constant: number of columns in the fill table.
+#define D_BENCH_FILL_COLUMNS    5
+
+// D_BENCH_THRESHOLD_DEFAULT, D_BENCH_THRESHOLD_NEVER, D_BENCH_THRESHOLD_ALWAYS
+//   constant: values passed to d_memory_set_stream_threshold for a column.
+#define D_BENCH_THRESHOLD_DEFAULT ((size_t)0)
+#define D_BENCH_THRESHOLD_NEVER   SIZE_MAX
+#define D_BENCH_THRESHOLD_ALWAYS  ((size_t)1)
+
+// D_BENCH_COPY_MIN
+//   constant: smallest size in the copy table.
+#define D_BENCH_COPY_MIN        ((size_t)4096)
+
+// D_BENCH_COPY_COLUMNS
+//   constant: most columns in the copy table: three single-threaded copies and
+// d_memcpy_parallel at up to 2^10 threads.
+#define D_BENCH_COPY_COLUMNS    13
+
+// D_BENCH_INTERFERENCE_MS
+//   constant: how long each interference row runs, in milliseconds.
+#define D_BENCH_INTERFERENCE_MS 1000
+
+// D_BENCH_VICTIM_STEPS
+//   constant: pointer-chase steps between checks of the stop flag.
+#define D_BENCH_VICTIM_STEPS    4096
+
+
+// d_bench_fill_fn
+//   function pointer: fills `_size` bytes at `_buffer`.
+typedef void (*d_bench_fill_fn)(void* _buffer, size_t _size);
+
+// d_bench_fill_column
+//   struct: one column of the fill table.
+struct d_bench_fill_column
+{
+    const char*     name;
+    size_t          threshold;
+    d_bench_fill_fn fill;
+};
+
+// d_bench_copy_fn
+//   function pointer: copies `_size` bytes, using up to `_threads` threads
+// where the function supports it.
+typedef void (*d_bench_copy_fn)(void*       _destination,
+                                const void* _source,
+                                size_t      _size,
+                                size_t      _threads);
+
+// d_bench_copy_column
+//   struct: one column of the copy table, or one interference row.
+struct d_bench_copy_column
+{
+    char            name[16];
+    size_t          threads;
+    size_t          threshold;
+    d_bench_copy_fn copy;
+};
+
+// d_bench_victim
+//   struct: state shared with the interference victim thread. `state` is 0
+// while the victim warms its table, 1 once it is measuring and 2 when the
+// main thread asks it to stop.
+struct d_bench_victim
+{
+    size_t*      table;
+    size_t       lines;
+    d_atomic_int state;
+    size_t       accesses;
+    int64_t      elapsed;
+};
+
+// d_bench_sink
+//   global: read after each run so the fills cannot be discarded.
+static volatile unsigned char d_bench_sink;
+
+
+/******************************************************************************
+ * FILL KERNELS
+ *****************************************************************************/
+
+static void
+d_bench_fill_libc
+(
+    void*  _buffer,
+    size_t _size
+)
+{
+    memset(_buffer, 0x5A, _size);
+
+    return;
+}
+
+static void
+d_bench_fill_d_memset
+(
+    void*  _buffer,
+    size_t _size
+)
+{
+    d_memset(_buffer, 0x5A, _size);
+
+    return;
+}
+
+static void
+d_bench_fill_d_memset_s
+(
+    void*  _buffer,
+    size_t _size
+)
+{
+    d_memset_s(_buffer, _size, 0x5A, _size);
+
+    return;
+}
+
+static const struct d_bench_fill_column d_bench_fill_columns[D_BENCH_FILL_COLUMNS] =
+{
+    { "memset",    D_BENCH_THRESHOLD_DEFAULT, d_bench_fill_libc       },
+    { "no stream", D_BENCH_THRESHOLD_NEVER,   d_bench_fill_d_memset   },
+    { "stream",    D_BENCH_THRESHOLD_ALWAYS,  d_bench_fill_d_memset   },
+    { "d_memset",  D_BENCH_THRESHOLD_DEFAULT, d_bench_fill_d_memset   },
+    { "memset_s",  D_BENCH_THRESHOLD_DEFAULT, d_bench_fill_d_memset_s }
+};
+
+
+/******************************************************************************
+ * COPY KERNELS
+ *****************************************************************************/
+
+static void
+d_bench_copy_libc
+(
+    void*       _destination,
+    const void* _source,
+    size_t      _size,
+    size_t      _threads
+)
+{
+    (void)_threads;
+
+    memcpy(_destination, _source, _size);
+
+    return;
+}
+
+static void
+d_bench_copy_d_memcpy
+(
+    void*       _destination,
+    const void* _source,
+    size_t      _size,
+    size_t      _threads
+)
+{
+    (void)_threads;
+
+    d_memcpy(_destination, _source, _size);
+
+    return;
+}
+
+static void
+d_bench_copy_stream
+(
+    void*       _destination,
+    const void* _source,
+    size_t      _size,
+    size_t      _threads
+)
+{
+    (void)_threads;
+
+    d_memcpy_stream(_destination, _source, _size);
+
+    return;
+}
+
+static void
+d_bench_copy_parallel
+(
+    void*       _destination,
+    const void* _source,
+    size_t      _size,
+    size_t      _threads
+)
+{
+    d_memcpy_parallel(_destination, _source, _size, _threads);
+
+    return;
+}
+
+
+/******************************************************************************
+ * HELPERS
+ *****************************************************************************/
+
+/*
+d_bench_format_size
+  Writes `_size` to `_out` as bytes, KiB or MiB.
+*/
+static void
+d_bench_format_size
+(
+    char*  _out,
+    size_t _capacity,
+    size_t _size
+)
+{
+    if (_size >= ((size_t)1024 * 1024))
+    {
+        snprintf(_out, _capacity, "%zu MiB", _size / ((size_t)1024 * 1024));
+    }
+    else if (_size >= 1024)
+    {
+        snprintf(_out, _capacity, "%zu KiB", _size / 1024);
+    }
+    else
+    {
+        snprintf(_out, _capacity, "%zu B", _size);
+    }
+
+    return;
+}
+
+/*
+d_bench_repeats
+  Returns how many times a `_size`-byte operation runs per timed run.
+*/
+static size_t
+d_bench_repeats
+(
+    size_t _size
+)
+{
+    return (_size >= D_BENCH_BYTES_PER_TRIAL)
+        ? 1
+        : (D_BENCH_BYTES_PER_TRIAL / _size);
+}
+
+/*
+d_bench_rate
+  Converts `_bytes` moved in `_ns` nanoseconds to GB/s.
+*/
+static double
+d_bench_rate
+(
+    size_t  _bytes,
+    int64_t _ns
+)
+{
+    if (_ns <= 0)
+    {
+        return 0.0;
+    }
+
+    return (double)_bytes / (double)_ns;
+}
+
+/*
+d_bench_cache_size
+  Returns the last-level cache size, or twice D_MEMORY_STREAM_THRESHOLD if it
+is unknown.
+*/
+static size_t
+d_bench_cache_size
+(
+    void
+)
+{
+    size_t cache;
+
+    cache = d_env_cpu_cache_size();
+
+    return (cache != 0) ? cache : (2 * D_MEMORY_STREAM_THRESHOLD);
+}
+
+/*
+d_bench_copy_columns
+  Fills `_columns` with memcpy, d_memcpy, d_memcpy_stream and
+d_memcpy_parallel at 2, 4, ... threads up to the hardware concurrency, and
+returns how many columns were written.
+*/
+static size_t
+d_bench_copy_columns
+(
+    struct d_bench_copy_column* _columns
+)
+{
+    static const struct d_bench_copy_column single[3] =
+    {
+        { "memcpy",   1, D_BENCH_THRESHOLD_DEFAULT, d_bench_copy_libc     },
+        { "d_memcpy", 1, D_BENCH_THRESHOLD_DEFAULT, d_bench_copy_d_memcpy },
+        { "stream",   1, D_BENCH_THRESHOLD_ALWAYS,  d_bench_copy_stream   }
+    };
+    size_t count;
+    size_t threads;
+    size_t limit;
+
+    limit = (size_t)d_thread_hardware_concurrency();
+
+    if (limit < 2)
+    {
+        limit = 2;
+    }
+
+    for (count = 0; count < 3; count++)
+    {
+        _columns[count] = single[count];
+    }
+
+    for (threads = 2;
+         (threads <= limit) && (count < D_BENCH_COPY_COLUMNS);
+         threads *= 2)
+    {
+        snprintf(_columns[count].name,
+                 sizeof(_columns[count].name),
+                 "par(%zu)",
+                 threads);
+        _columns[count].threads   = threads;
+        _columns[count].threshold = D_BENCH_THRESHOLD_DEFAULT;
+        _columns[count].copy      = d_bench_copy_parallel;
+        count++;
+    }
+
+    return count;
+}
+
+
+/******************************************************************************
+ * FILL BENCHMARK
+ *****************************************************************************/
+
+/*
+d_bench_fill_measure
+  Returns the best rate, in GB/s, of `_column` filling `_size` bytes.
+*/
+static double
+d_bench_fill_measure
+(
+    const struct d_bench_fill_column* _column,
+    unsigned char*                    _buffer,
+    size_t                            _size
+)
+{
+    size_t  repeats;
+    size_t  trial;
+    size_t  i;
+    int64_t start;
+    int64_t elapsed;
+    int64_t best;
+
+    repeats = d_bench_repeats(_size);
+    best    = INT64_MAX;
+
+    d_memory_set_stream_threshold(_column->threshold);
+
+    // warm-up run: faults the pages in and settles the CPU clock
+    _column->fill(_buffer, _size);
+
+    for (trial = 0; trial < D_BENCH_TRIALS; trial++)
+    {
+        start = d_monotonic_time_ns();
+
+        for (i = 0; i < repeats; i++)
+        {
+            _column->fill(_buffer, _size);
+        }
+
+        elapsed = d_monotonic_time_ns() - start;
+
+        if (elapsed < best)
+        {
+            best = elapsed;
+        }
+
+        d_bench_sink = _buffer[_size - 1];
+    }
+
+    d_memory_set_stream_threshold(D_BENCH_THRESHOLD_DEFAULT);
+
+    return d_bench_rate(_size * repeats, best);
+}
+
+/*
+d_bench_fill
+  Prints the fill table for sizes from 8 bytes up to `_max`, followed by the
+measured crossover between plain and streaming fills.
+*/
+static int
+d_bench_fill
+(
+    size_t _max
+)
+{
+    unsigned char* buffer;
+    char           label[32];
+    double         rates[D_BENCH_FILL_COLUMNS];
+    size_t         size;
+    size_t         crossover;
+    size_t         column;
+
+    buffer = d_aligned_alloc(_max, D_MEMORY_CACHE_LINE_SIZE);
+
+    if (!buffer)
+    {
+        fprintf(stderr, "dmemory-bench: cannot allocate %zu bytes\n", _max);
+
+        return 1;
+    }
+
+    d_bench_format_size(label, sizeof(label), d_memory_stream_threshold());
+    printf("fill, GB/s (stream threshold %s, LLC %zu KiB)\n",
+           label,
+           d_env_cpu_cache_size() / 1024);
+    printf("%10s", "size");
+
+    for (column = 0; column < D_BENCH_FILL_COLUMNS; column++)
+    {
+        printf(" %10s", d_bench_fill_columns[column].name);
+    }
+
+    printf("\n");
+
+    crossover = 0;
+
+    for (size = 8; size <= _max; size *= 2)
+    {
+        for (column = 0; column < D_BENCH_FILL_COLUMNS; column++)
+        {
+            rates[column] = d_bench_fill_measure(&d_bench_fill_columns[column],
+                                                 buffer,
+                                                 size);
+        }
+
+        d_bench_format_size(label, sizeof(label), size);
+        printf("%10s", label);
+
+        for (column = 0; column < D_BENCH_FILL_COLUMNS; column++)
+        {
+            printf(" %10.1f", rates[column]);
+        }
+
+        printf("\n");
+
+        // the crossover is the smallest size from which streaming keeps
+        // winning
+        if (rates[2] > rates[1])
+        {
+            if (crossover == 0)
+            {
+                crossover = size;
+            }
+        }
+        else
+        {
+            crossover = 0;
+        }
+    }
+
+    if (crossover != 0)
+    {
+        d_bench_format_size(label, sizeof(label), crossover);
+        printf("streaming wins from %s\n\n", label);
+    }
+    else
+    {
+        printf("streaming does not win up to the largest size\n\n");
+    }
+
+    d_aligned_free(buffer);
+
+    return 0;
+}
+
+
+/******************************************************************************
+ * COPY BENCHMARK
+ *****************************************************************************/
+
+/*
+d_bench_copy_measure
+  Returns the best rate, in GB/s, of `_column` copying `_size` bytes.
+*/
+static double
+d_bench_copy_measure
+(
+    const struct d_bench_copy_column* _column,
+    unsigned char*                    _destination,
+    const unsigned char*              _source,
+    size_t                            _size
+)
+{
+    size_t  repeats;
+    size_t  trial;
+    size_t  i;
+    int64_t start;
+    int64_t elapsed;
+    int64_t best;
+
+    repeats = d_bench_repeats(_size);
+    best    = INT64_MAX;
+
+    d_memory_set_stream_threshold(_column->threshold);
+
+    _column->copy(_destination, _source, _size, _column->threads);
+
+    for (trial = 0; trial < D_BENCH_TRIALS; trial++)
+    {
+        start = d_monotonic_time_ns();
+
+        for (i = 0; i < repeats; i++)
+        {
+            _column->copy(_destination, _source, _size, _column->threads);
+        }
+
+        elapsed = d_monotonic_time_ns() - start;
+
+        if (elapsed < best)
+        {
+            best = elapsed;
+        }
+
+        d_bench_sink = _destination[_size - 1];
+    }
+
+    d_memory_set_stream_threshold(D_BENCH_THRESHOLD_DEFAULT);
+
+    return d_bench_rate(_size * repeats, best);
+}
+
+/*
+d_bench_copy
+  Prints the copy table for sizes from D_BENCH_COPY_MIN up to `_max`.
+*/
+static int
+d_bench_copy
+(
+    size_t _max
+)
+{
+    struct d_bench_copy_column columns[D_BENCH_COPY_COLUMNS];
+    unsigned char*             source;
+    unsigned char*             destination;
+    char                       label[32];
+    size_t                     count;
+    size_t                     size;
+    size_t                     column;
+
+    source      = d_aligned_alloc(_max, D_MEMORY_CACHE_LINE_SIZE);
+    destination = d_aligned_alloc(_max, D_MEMORY_CACHE_LINE_SIZE);
+
+    if ( (!source) ||
+         (!destination) )
+    {
+        fprintf(stderr, "dmemory-bench: cannot allocate 2 x %zu bytes\n", _max);
+        d_aligned_free(source);
+        d_aligned_free(destination);
+
+        return 1;
+    }
+
+    memset(source, 0x5A, _max);
+
+    count = d_bench_copy_columns(columns);
+
+    d_bench_format_size(label, sizeof(label), d_memory_stream_threshold());
+    printf("copy, GB/s (stream threshold %s, %d hardware threads)\n",
+           label,
+           d_thread_hardware_concurrency());
+    printf("%10s", "size");
+
+    for (column = 0; column < count; column++)
+    {
+        printf(" %10s", columns[column].name);
+    }
+
+    printf("\n");
+
+    for (size = D_BENCH_COPY_MIN; size <= _max; size *= 2)
+    {
+        d_bench_format_size(label, sizeof(label), size);
+        printf("%10s", label);
+
+        for (column = 0; column < count; column++)
+        {
+            printf(" %10.1f",
+                   d_bench_copy_measure(&columns[column],
+                                        destination,
+                                        source,
+                                        size));
+        }
+
+        printf("\n");
+    }
+
+    printf("\n");
+
+    d_aligned_free(source);
+    d_aligned_free(destination);
+
+    return 0;
+}
+
+
+/******************************************************************************
+ * INTERFERENCE BENCHMARK
+ *****************************************************************************/
+
+/*
+d_bench_victim_build
+  Links the cache lines of `_victim`'s table into one random cycle, so each
+step of the chase depends on the previous load and cannot be prefetched. The
+table is on huge pages where possible, so the chase measures the cache rather
+than TLB misses.
+*/
+static void
+d_bench_victim_build
+(
+    struct d_bench_victim* _victim,
+    size_t*                _order
+)
+{
+    size_t   stride;
+    size_t   i;
+    size_t   j;
+    size_t   swap;
+    uint64_t seed;
+
+    stride = D_MEMORY_CACHE_LINE_SIZE / sizeof(size_t);
+    seed   = 0x9E3779B97F4A7C15ull;
+
+    for (i = 0; i < _victim->lines; i++)
+    {
+        _order[i] = i;
+    }
+
+    // Fisher-Yates shuffle with xorshift64
+    for (i = _victim->lines - 1; i > 0; i--)
+    {
+        seed ^= seed << 13;
+        seed ^= seed >> 7;
+        seed ^= seed << 17;
+
+        j         = (size_t)(seed % (uint64_t)(i + 1));
+        swap      = _order[i];
+        _order[i] = _order[j];
+        _order[j] = swap;
+    }
+
+    for (i = 0; i < _victim->lines; i++)
+    {
+        _victim->table[_order[i] * stride] =
+            _order[(i + 1) % _victim->lines] * stride;
+    }
+
+    return;
+}
+
+/*
+d_bench_victim_run
+  Thread body of the interference victim. Walks its table once to load it
+into the cache, then counts pointer-chase steps until told to stop.
+*/
+static d_thread_result_t
+d_bench_victim_run
+(
+    void* _arg
+)
+{
+    struct d_bench_victim* victim;
+    size_t                 position;
+    size_t                 accesses;
+    size_t                 i;
+    int64_t                start;
+
+    victim   = (struct d_bench_victim*)_arg;
+    position = 0;
+    accesses = 0;
+
+    for (i = 0; i < victim->lines; i++)
+    {
+        position = victim->table[position];
+    }
+
+    d_atomic_store_int(&victim->state, 1);
+    start = d_monotonic_time_ns();
+
+    while (d_atomic_load_int(&victim->state) == 1)
+    {
+        for (i = 0; i < D_BENCH_VICTIM_STEPS; i++)
+        {
+            position = victim->table[position];
+        }
+
+        accesses += D_BENCH_VICTIM_STEPS;
+    }
+
+    victim->elapsed  = d_monotonic_time_ns() - start;
+    victim->accesses = accesses;
+    d_bench_sink     = (unsigned char)position;
+
+    return D_THREAD_SUCCESS;
+}
+
+/*
+d_bench_interference_row
+  Runs the victim alongside `_column` (or alone if `_column` is NULL) for
+D_BENCH_INTERFERENCE_MS and prints the victim's ns/access and the copy rate.
+*/
+static int
+d_bench_interference_row
+(
+    struct d_bench_victim*            _victim,
+    const struct d_bench_copy_column* _column,
+    unsigned char*                    _destination,
+    const unsigned char*              _source,
+    size_t                            _size
+)
+{
+    d_thread_t thread;
+    size_t     copies;
+    int64_t    start;
+    int64_t    elapsed;
+    int64_t    limit;
+
+    d_atomic_store_int(&_victim->state, 0);
+
+    if (d_thread_create(&thread, d_bench_victim_run, _victim) != D_MUTEX_SUCCESS)
+    {
+        fprintf(stderr, "dmemory-bench: cannot start the victim thread\n");
+
+        return 1;
+    }
+
+    while (d_atomic_load_int(&_victim->state) == 0)
+    {
+        d_sleep_ms(1);
+    }
+
+    copies  = 0;
+    limit   = (int64_t)D_BENCH_INTERFERENCE_MS * 1000000;
+    start   = d_monotonic_time_ns();
+    elapsed = 0;
+
+    if (!_column)
+    {
+        d_sleep_ms(D_BENCH_INTERFERENCE_MS);
+    }
+    else
+    {
+        d_memory_set_stream_threshold(_column->threshold);
+
+        while (elapsed < limit)
+        {
+            _column->copy(_destination, _source, _size, _column->threads);
+            copies++;
+            elapsed = d_monotonic_time_ns() - start;
+        }
+
+        d_memory_set_stream_threshold(D_BENCH_THRESHOLD_DEFAULT);
+    }
+
+    d_atomic_store_int(&_victim->state, 2);
+    d_thread_join(thread, NULL);
+
+    printf("%-16s %12.2f",
+           (_column != NULL) ? _column->name : "idle",
+           (_victim->accesses != 0)
+               ? ((double)_victim->elapsed / (double)_victim->accesses)
+               : 0.0);
+
+    if (_column != NULL)
+    {
+        printf(" %10.1f", d_bench_rate(_size * copies, elapsed));
+    }
+
+    printf("\n");
+
+    return 0;
+}
+
+/*
+d_bench_interference
+  Prints the victim's ns/access alone and next to each copy function.
+*/
+static int
+d_bench_interference
+(
+    void
+)
+{
+    struct d_bench_copy_column columns[D_BENCH_COPY_COLUMNS];
+    struct d_bench_victim      victim;
+    unsigned char*             source;
+    unsigned char*             destination;
+    size_t*                    order;
+    char                       label[32];
+    size_t                     cache;
+    size_t                     size;
+    size_t                     count;
+    size_t                     column;
+    int                        result;
+
+    cache        = d_bench_cache_size();
+    size         = 2 * cache;
+    victim.lines = (cache / 2) / D_MEMORY_CACHE_LINE_SIZE;
+    victim.table = d_large_alloc(victim.lines * D_MEMORY_CACHE_LINE_SIZE,
+                                 D_MEMORY_LARGE_HUGE_PAGES);
+    order        = malloc(victim.lines * sizeof(size_t));
+    source       = d_aligned_alloc(size, D_MEMORY_CACHE_LINE_SIZE);
+    destination  = d_aligned_alloc(size, D_MEMORY_CACHE_LINE_SIZE);
+    result       = 1;
+
+    d_atomic_init_int(&victim.state, 0);
+    victim.accesses = 0;
+    victim.elapsed  = 0;
+
+    if ( (victim.table) &&
+         (order)        &&
+         (source)       &&
+         (destination) )
+    {
+        d_bench_victim_build(&victim, order);
+        memset(source, 0x5A, size);
+        memset(destination, 0, size);
+
+        count = d_bench_copy_columns(columns);
+
+        d_bench_format_size(label, sizeof(label), cache / 2);
+        printf("interference: victim table %s, ", label);
+        d_bench_format_size(label, sizeof(label), size);
+        printf("copies of %s\n", label);
+
+        if (d_thread_hardware_concurrency() < 2)
+        {
+            printf("(one hardware thread: the victim and the copier share "
+                   "it, so these rows measure scheduling, not the cache)\n");
+        }
+
+        printf("%-16s %12s %10s\n", "copier", "victim ns", "copy GB/s");
+
+        result = d_bench_interference_row(&victim, NULL, destination, source, size);
+
+        for (column = 0; (column < count) && (result == 0); column++)
+        {
+            result = d_bench_interference_row(&victim,
+                                              &columns[column],
+                                              destination,
+                                              source,
+                                              size);
+        }
+
+        printf("\n");
+    }
+    else
+    {
+        fprintf(stderr, "dmemory-bench: cannot allocate the interference buffers\n");
+    }
+
+    d_large_free(victim.table, victim.lines * D_MEMORY_CACHE_LINE_SIZE);
+    free(order);
+    d_aligned_free(source);
+    d_aligned_free(destination);
+
+    return result;
+}
+
+
+/******************************************************************************
+ * MAIN ENTRY POINT
+ *****************************************************************************/
+
+/*
+main
+  Runs the benchmark named by the first argument, or all of them.
+
+Parameter(s):
+  _argc: argument count.
+  _argv: argument vector: an optional benchmark name and an optional largest
+         size in bytes.
+Return:
+  0 on success, 1 if a buffer could not be allocated or the arguments were
+not understood.
+*/
+int
+main
+(
+    int    _argc,
+    char** _argv
+)
+{
+    const char* mode;
+    size_t      max;
+    int         result;
+    bool        all;
+
+    mode = (_argc > 1) ? _argv[1] : "all";
+    max  = (_argc > 2) ? (size_t)strtoull(_argv[2], NULL, 0) : D_BENCH_DEFAULT_MAX;
+
+    if (max < 8)
+    {
+        fprintf(stderr, "dmemory-bench: max_bytes must be at least 8\n");
+
+        return 1;
+    }
+
+    all    = (strcmp(mode, "all") == 0);
+    result = -1;
+
+    if ( (all) ||
+         (strcmp(mode, "memset") == 0) )
+    {
+        result = d_bench_fill(max);
+    }
+
+    if ( (result <= 0) &&
+         ( (all) ||
+           (strcmp(mode, "copy") == 0) ) )
+    {
+        result = d_bench_copy(max);
+    }
+
+    if ( (result <= 0) &&
+         ( (all) ||
+           (strcmp(mode, "interference") == 0) ) )
+    {
+        result = d_bench_interference();
+    }
+
+    if (result < 0)
+    {
+        fprintf(stderr,
+                "usage: %s [memset|copy|interference|all] [max_bytes]\n",
+                _argv[0]);
+
+        return 1;
+    }
+
+    return result;
+}
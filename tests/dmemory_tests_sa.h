@@ -94,6 +94,8 @@ bool d_tests_dmemory_compare_buffers(const void* _buf1,
 
 struct d_test_object* d_tests_dmemory_memcpy(void);
 struct d_test_object* d_tests_dmemory_memcpy_s(void);
+struct d_test_object* d_tests_dmemory_memcpy_stream(void);
+struct d_test_object* d_tests_dmemory_memcpy_parallel(void);
 struct d_test_object* d_tests_dmemory_copy_all(void);
 
 
@@ -111,9 +113,58 @@ struct d_test_object* d_tests_dmemory_duplication_all(void);
 
 struct d_test_object* d_tests_dmemory_memset(void);
 struct d_test_object* d_tests_dmemory_memset_s(void);
+struct d_test_object* d_tests_dmemory_memset_large(void);
 struct d_test_object* d_tests_dmemory_set_all(void);
 
 
+/******************************************************************************
+ * ARENA ALLOCATOR TESTS
+ *****************************************************************************/
+
+struct d_test_object* d_tests_dmemory_arena_alloc(void);
+struct d_test_object* d_tests_dmemory_arena_resize(void);
+struct d_test_object* d_tests_dmemory_arena_mark(void);
+struct d_test_object* d_tests_dmemory_arena_all(void);
+
+
+/******************************************************************************
+ * OBJECT POOL TESTS
+ *****************************************************************************/
+
+struct d_test_object* d_tests_dmemory_pool_alloc(void);
+struct d_test_object* d_tests_dmemory_pool_stats(void);
+struct d_test_object* d_tests_dmemory_pool_threads(void);
+struct d_test_object* d_tests_dmemory_pool_all(void);
+
+
+/******************************************************************************
+ * PLUGGABLE ALLOCATOR TESTS
+ *****************************************************************************/
+
+struct d_test_object* d_tests_dmemory_allocator_system(void);
+struct d_test_object* d_tests_dmemory_allocator_adapters(void);
+struct d_test_object* d_tests_dmemory_allocator_all(void);
+
+
+/******************************************************************************
+ * ALLOCATION ACCOUNTING TESTS
+ *****************************************************************************/
+
+struct d_test_object* d_tests_dmemory_stats_snapshot(void);
+struct d_test_object* d_tests_dmemory_stats_sites(void);
+struct d_test_object* d_tests_dmemory_stats_all(void);
+
+
+/******************************************************************************
+ * ALIGNED AND LARGE BUFFER TESTS
+ *****************************************************************************/
+
+struct d_test_object* d_tests_dmemory_aligned_alloc(void);
+struct d_test_object* d_tests_dmemory_large_alloc(void);
+struct d_test_object* d_tests_dmemory_large_allocator(void);
+struct d_test_object* d_tests_dmemory_large_all(void);
+
+
 /******************************************************************************
  * SPECIAL CONDITION TESTS
  *****************************************************************************/
@@ -0,0 +1,373 @@
+#include ".\dmemory_tests_sa.h"
+
+
+/******************************************************************************
+ * ALLOCATOR TESTS - helpers
+ *****************************************************************************/
+
+/*
+d_tests_dmemory_allocator_allocate
+  The `allocate` function of a minimal test allocator with neither
+`reallocate` nor `try_expand`, so d_allocator_realloc must move memory
+itself. The context counts live allocations.
+*/
+static void*
+d_tests_dmemory_allocator_allocate
+(
+    void*  _context,
+    size_t _size,
+    size_t _alignment
+)
+{
+    void* memory;
+
+    (void)_alignment;
+
+    memory = malloc(_size);
+
+    if (memory != NULL)
+    {
+        (*(size_t*)_context)++;
+    }
+
+    return memory;
+}
+
+/*
+d_tests_dmemory_allocator_deallocate
+  The `deallocate` function of the minimal test allocator.
+*/
+static void
+d_tests_dmemory_allocator_deallocate
+(
+    void*  _context,
+    void*  _ptr,
+    size_t _size
+)
+{
+    (void)_size;
+
+    (*(size_t*)_context)--;
+    free(_ptr);
+
+    return;
+}
+
+
+/******************************************************************************
+ * ALLOCATOR TESTS - d_allocator_*
+ *****************************************************************************/
+
+/*
+d_tests_dmemory_allocator_system
+  Tests d_allocator_system, d_allocator_default, d_allocator_set_default and
+  the d_allocator_* functions.
+  Tests the following:
+  - the default allocator starts out as the system allocator
+  - NULL allocators, zero sizes and bad alignments are handled
+  - default and explicit alignments are honored
+  - d_allocator_realloc keeps contents and allocates from NULL
+  - an allocator without `reallocate` moves memory and frees the old block
+  - d_allocator_set_default routes NULL allocators and can be undone
+  - d_memdup_s_ex copies through the given allocator
+*/
+struct d_test_object*
+d_tests_dmemory_allocator_system
+(
+    void
+)
+{
+    struct d_test_object* group;
+    struct d_allocator    minimal;
+    size_t                live;
+    unsigned char*        a;
+    unsigned char*        b;
+    size_t                i;
+    size_t                idx;
+    bool                  test_default;
+    bool                  test_invalid;
+    bool                  test_alignment;
+    bool                  test_realloc;
+    bool                  test_move;
+    bool                  test_set_default;
+    bool                  test_memdup;
+
+    live               = 0;
+    minimal.allocate   = d_tests_dmemory_allocator_allocate;
+    minimal.reallocate = NULL;
+    minimal.try_expand = NULL;
+    minimal.deallocate = d_tests_dmemory_allocator_deallocate;
+    minimal.context    = &live;
+
+    // test 1: the system allocator is the default
+    test_default = (d_allocator_system() != NULL) &&
+                   (d_allocator_default() == d_allocator_system());
+
+    // test 2: invalid parameters
+    test_invalid = (d_allocator_alloc(NULL, 0) == NULL) &&
+                   (d_allocator_alloc_aligned(NULL, 16, 0) == NULL) &&
+                   (d_allocator_alloc_aligned(NULL, 16, 24) == NULL) &&
+                   (d_allocator_realloc(NULL, NULL, 0, 0) == NULL);
+    d_allocator_free(NULL, NULL, 16);
+
+    // test 3: alignment
+    a              = d_allocator_alloc(NULL, 3);
+    test_alignment = (a != NULL) &&
+                     (((uintptr_t)a % D_ALLOCATOR_DEFAULT_ALIGNMENT) == 0);
+    d_allocator_free(NULL, a, 3);
+
+#if D_ENV_C_HAS_POSIX_MEMALIGN
+    for (i = 1; i <= 4096; i *= 2)
+    {
+        a = d_allocator_alloc_aligned(d_allocator_system(), 7, i);
+
+        if ( (!a) ||
+             (((uintptr_t)a % i) != 0) )
+        {
+            test_alignment = false;
+        }
+
+        d_allocator_free(d_allocator_system(), a, 7);
+    }
+#endif
+
+    // test 4: realloc
+    a = d_allocator_realloc(NULL, NULL, 0, D_TESTS_MEMORY_SMALL_SIZE);
+
+    if (a)
+    {
+        for (i = 0; i < D_TESTS_MEMORY_SMALL_SIZE; i++)
+        {
+            a[i] = (unsigned char)i;
+        }
+    }
+
+    b            = d_allocator_realloc(NULL,
+                                       a,
+                                       D_TESTS_MEMORY_SMALL_SIZE,
+                                       D_TESTS_MEMORY_LARGE_SIZE);
+    test_realloc = (a != NULL) &&
+                   (b != NULL) &&
+                   (b[D_TESTS_MEMORY_SMALL_SIZE - 1] ==
+                        (unsigned char)(D_TESTS_MEMORY_SMALL_SIZE - 1));
+    d_allocator_free(NULL, (b != NULL) ? b : a, D_TESTS_MEMORY_LARGE_SIZE);
+
+    // test 5: an allocator without `reallocate` moves the memory
+    a = d_allocator_alloc(&minimal, D_TESTS_MEMORY_SMALL_SIZE);
+
+    if (a)
+    {
+        memset(a, 0x5A, D_TESTS_MEMORY_SMALL_SIZE);
+    }
+
+    b         = d_allocator_realloc(&minimal,
+                                    a,
+                                    D_TESTS_MEMORY_SMALL_SIZE,
+                                    D_TESTS_MEMORY_MEDIUM_SIZE);
+    test_move = (a != NULL) &&
+                (b != NULL) &&
+                (b[0] == 0x5A) &&
+                (b[D_TESTS_MEMORY_SMALL_SIZE - 1] == 0x5A) &&
+                (live == 1);
+    d_allocator_free(&minimal, b, D_TESTS_MEMORY_MEDIUM_SIZE);
+    test_move = test_move && (live == 0);
+
+    // test 6: replacing the default
+    d_allocator_set_default(&minimal);
+    a                = d_allocator_alloc(NULL, D_TESTS_MEMORY_SMALL_SIZE);
+    test_set_default = (d_allocator_default() == &minimal) &&
+                       (a != NULL) &&
+                       (live == 1);
+    d_allocator_free(NULL, a, D_TESTS_MEMORY_SMALL_SIZE);
+    d_allocator_set_default(NULL);
+    test_set_default = test_set_default &&
+                       (live == 0) &&
+                       (d_allocator_default() == d_allocator_system());
+
+    // test 7: d_memdup_s_ex
+    a           = d_memdup_s_ex(&minimal, "allocator", 10);
+    test_memdup = (a != NULL) &&
+                  (memcmp(a, "allocator", 10) == 0) &&
+                  (live == 1) &&
+                  (d_memdup_s_ex(&minimal, NULL, 10) == NULL) &&
+                  (d_memdup_s_ex(&minimal, "x", 0) == NULL);
+    d_allocator_free(&minimal, a, 10);
+
+    group = d_test_object_new_interior("d_allocator", 7);
+
+    if (!group)
+    {
+        return NULL;
+    }
+
+    idx = 0;
+    group->elements[idx++] = D_ASSERT_TRUE("default",
+                                           test_default,
+                                           "starts with the system allocator");
+    group->elements[idx++] = D_ASSERT_TRUE("invalid",
+                                           test_invalid,
+                                           "rejects invalid parameters");
+    group->elements[idx++] = D_ASSERT_TRUE("alignment",
+                                           test_alignment,
+                                           "honors default and explicit alignments");
+    group->elements[idx++] = D_ASSERT_TRUE("realloc",
+                                           test_realloc,
+                                           "resizes keeping contents");
+    group->elements[idx++] = D_ASSERT_TRUE("move",
+                                           test_move,
+                                           "moves memory without reallocate");
+    group->elements[idx++] = D_ASSERT_TRUE("set_default",
+                                           test_set_default,
+                                           "replaces and restores the default");
+    group->elements[idx++] = D_ASSERT_TRUE("memdup",
+                                           test_memdup,
+                                           "duplicates through an allocator");
+
+    return group;
+}
+
+
+/******************************************************************************
+ * ALLOCATOR TESTS - d_arena_allocator, d_pool_allocator
+ *****************************************************************************/
+
+/*
+d_tests_dmemory_allocator_adapters
+  Tests d_arena_allocator and d_pool_allocator.
+  Tests the following:
+  - NULL arenas and pools have no allocator
+  - the arena allocator allocates from the arena, at the requested alignment
+  - the arena allocator extends the most recent allocation in place and
+    ignores frees
+  - the pool allocator serves requests that fit an object and rejects others
+  - pool objects return to the pool when freed
+*/
+struct d_test_object*
+d_tests_dmemory_allocator_adapters
+(
+    void
+)
+{
+    struct d_test_object*     group;
+    struct d_arena*           arena;
+    struct d_pool*            pool;
+    struct d_pool_stats       stats;
+    const struct d_allocator* allocator;
+    unsigned char*            a;
+    unsigned char*            b;
+    size_t                    used;
+    size_t                    idx;
+    bool                      test_null;
+    bool                      test_arena_alloc;
+    bool                      test_arena_resize;
+    bool                      test_pool_alloc;
+    bool                      test_pool_free;
+
+    arena = d_arena_new(D_TESTS_MEMORY_LARGE_SIZE);
+    pool  = d_pool_new(D_TESTS_MEMORY_MEDIUM_SIZE, 0);
+
+    // test 1: NULL owners
+    test_null = (d_arena_allocator(NULL) == NULL) &&
+                (d_pool_allocator(NULL) == NULL);
+
+    // test 2: the arena allocator allocates from the arena
+    allocator        = d_arena_allocator(arena);
+    a                = d_allocator_alloc_aligned(allocator, 5, 64);
+    used             = d_arena_used(arena);
+    test_arena_alloc = (allocator != NULL) &&
+                       (a != NULL) &&
+                       (((uintptr_t)a % 64) == 0) &&
+                       (used >= 5) &&
+                       (used < 5 + 64);
+
+    // test 3: the most recent allocation grows in place; frees are ignored
+    b                 = d_allocator_realloc(allocator, a, 5, 50);
+    test_arena_resize = (b != NULL) &&
+                        (b == a) &&
+                        (d_arena_used(arena) == used + 45);
+    d_allocator_free(allocator, b, 50);
+    test_arena_resize = test_arena_resize &&
+                        (d_arena_used(arena) == used + 45);
+
+    // test 4: the pool allocator serves requests that fit an object
+    allocator       = d_pool_allocator(pool);
+    a               = d_allocator_alloc(allocator, D_TESTS_MEMORY_SMALL_SIZE);
+    b               = d_allocator_realloc(allocator,
+                                          a,
+                                          D_TESTS_MEMORY_SMALL_SIZE,
+                                          D_TESTS_MEMORY_MEDIUM_SIZE);
+    test_pool_alloc = (allocator != NULL) &&
+                      (a != NULL) &&
+                      (b == a) &&
+                      (d_allocator_alloc(allocator,
+                                         D_TESTS_MEMORY_LARGE_SIZE) == NULL) &&
+                      (d_allocator_realloc(allocator,
+                                           a,
+                                           D_TESTS_MEMORY_MEDIUM_SIZE,
+                                           D_TESTS_MEMORY_LARGE_SIZE) == NULL);
+
+    // test 5: freed objects return to the pool
+    d_allocator_free(allocator, a, D_TESTS_MEMORY_MEDIUM_SIZE);
+    test_pool_free = d_pool_get_stats(pool, &stats) &&
+                     (stats.live == 0);
+
+    d_arena_free(arena);
+    d_pool_free(pool);
+
+    group = d_test_object_new_interior("d_arena_allocator/d_pool_allocator", 5);
+
+    if (!group)
+    {
+        return NULL;
+    }
+
+    idx = 0;
+    group->elements[idx++] = D_ASSERT_TRUE("null",
+                                           test_null,
+                                           "NULL owners have no allocator");
+    group->elements[idx++] = D_ASSERT_TRUE("arena_alloc",
+                                           test_arena_alloc,
+                                           "allocates from the arena");
+    group->elements[idx++] = D_ASSERT_TRUE("arena_resize",
+                                           test_arena_resize,
+                                           "grows in place and ignores frees");
+    group->elements[idx++] = D_ASSERT_TRUE("pool_alloc",
+                                           test_pool_alloc,
+                                           "serves only requests that fit");
+    group->elements[idx++] = D_ASSERT_TRUE("pool_free",
+                                           test_pool_free,
+                                           "returns objects to the pool");
+
+    return group;
+}
+
+
+/*
+d_tests_dmemory_allocator_all
+  Runs all pluggable allocator tests.
+  Tests the following:
+  - d_allocator_*
+  - d_arena_allocator and d_pool_allocator
+*/
+struct d_test_object*
+d_tests_dmemory_allocator_all
+(
+    void
+)
+{
+    struct d_test_object* group;
+    size_t                idx;
+
+    group = d_test_object_new_interior("Pluggable Allocators", 2);
+
+    if (!group)
+    {
+        return NULL;
+    }
+
+    idx = 0;
+    group->elements[idx++] = d_tests_dmemory_allocator_system();
+    group->elements[idx++] = d_tests_dmemory_allocator_adapters();
+
+    return group;
+}
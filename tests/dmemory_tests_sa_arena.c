@@ -0,0 +1,468 @@
+#include ".\dmemory_tests_sa.h"
+
+
+/******************************************************************************
+ * ARENA TESTS - d_arena_alloc
+ *****************************************************************************/
+
+/*
+d_tests_dmemory_arena_alloc
+  Tests d_arena_new, d_arena_alloc, d_arena_alloc_aligned and d_arena_calloc.
+  Tests the following:
+  - returns NULL for NULL arenas, zero sizes and bad alignments
+  - default allocations are aligned to D_ARENA_DEFAULT_ALIGNMENT
+  - explicit alignments are honored
+  - consecutive allocations do not overlap
+  - allocations beyond the first block chain new blocks
+  - an allocation larger than a block gets a block of its own
+  - d_arena_calloc zeroes its memory and rejects overflowing sizes
+*/
+struct d_test_object*
+d_tests_dmemory_arena_alloc
+(
+    void
+)
+{
+    struct d_test_object* group;
+    struct d_arena*       arena;
+    unsigned char*        a;
+    unsigned char*        b;
+    unsigned char*        big;
+    unsigned char*        zeroed;
+    size_t                i;
+    size_t                idx;
+    bool                  test_invalid;
+    bool                  test_default_alignment;
+    bool                  test_alignment;
+    bool                  test_disjoint;
+    bool                  test_chain;
+    bool                  test_oversize;
+    bool                  test_calloc;
+
+    arena = d_arena_new(D_TESTS_MEMORY_LARGE_SIZE);
+
+    if (!arena)
+    {
+        return NULL;
+    }
+
+    // test 1: invalid parameters
+    test_invalid = (d_arena_alloc(NULL, 16) == NULL) &&
+                   (d_arena_alloc(arena, 0) == NULL) &&
+                   (d_arena_alloc_aligned(arena, 16, 0) == NULL) &&
+                   (d_arena_alloc_aligned(arena, 16, 24) == NULL);
+
+    // test 2: default alignment
+    a = d_arena_alloc(arena, 3);
+    b = d_arena_alloc(arena, 5);
+    test_default_alignment = (a != NULL) &&
+                             (b != NULL) &&
+                             (((uintptr_t)a % D_ARENA_DEFAULT_ALIGNMENT) == 0) &&
+                             (((uintptr_t)b % D_ARENA_DEFAULT_ALIGNMENT) == 0);
+
+    // test 3: explicit alignment
+    test_alignment = true;
+
+    for (i = 1; i <= 256; i *= 2)
+    {
+        d_arena_alloc_aligned(arena, 1, 1);
+        a = d_arena_alloc_aligned(arena, 7, i);
+
+        if ( (!a) ||
+             (((uintptr_t)a % i) != 0) )
+        {
+            test_alignment = false;
+        }
+    }
+
+    // test 4: allocations are disjoint
+    a = d_arena_alloc(arena, D_TESTS_MEMORY_MEDIUM_SIZE);
+    b = d_arena_alloc(arena, D_TESTS_MEMORY_MEDIUM_SIZE);
+    test_disjoint = (a != NULL) && (b != NULL);
+
+    if (test_disjoint)
+    {
+        memset(a, D_TESTS_MEMORY_PATTERN_A, D_TESTS_MEMORY_MEDIUM_SIZE);
+        memset(b, D_TESTS_MEMORY_PATTERN_B, D_TESTS_MEMORY_MEDIUM_SIZE);
+        test_disjoint = d_tests_dmemory_verify_pattern(a,
+                                                       D_TESTS_MEMORY_MEDIUM_SIZE,
+                                                       D_TESTS_MEMORY_PATTERN_A);
+    }
+
+    // test 5: filling several blocks
+    test_chain = true;
+
+    for (i = 0; i < 64; i++)
+    {
+        a = d_arena_alloc(arena, D_TESTS_MEMORY_MEDIUM_SIZE);
+
+        if (!a)
+        {
+            test_chain = false;
+
+            break;
+        }
+
+        memset(a, (int)i, D_TESTS_MEMORY_MEDIUM_SIZE);
+    }
+
+    test_chain = test_chain &&
+                 (d_arena_used(arena) >= 64 * D_TESTS_MEMORY_MEDIUM_SIZE);
+
+    // test 6: oversized allocation
+    big = d_arena_alloc(arena, D_TESTS_MEMORY_LARGE_SIZE * 4);
+    test_oversize = (big != NULL);
+
+    if (test_oversize)
+    {
+        memset(big, D_TESTS_MEMORY_PATTERN_FF, D_TESTS_MEMORY_LARGE_SIZE * 4);
+        a = d_arena_alloc(arena, 16);
+        test_oversize = (a != NULL) &&
+                        d_tests_dmemory_verify_pattern(big,
+                                                       D_TESTS_MEMORY_LARGE_SIZE * 4,
+                                                       D_TESTS_MEMORY_PATTERN_FF);
+    }
+
+    // test 7: calloc
+    zeroed      = d_arena_calloc(arena, 10, D_TESTS_MEMORY_SMALL_SIZE);
+    test_calloc = (zeroed != NULL) &&
+                  d_tests_dmemory_verify_pattern(zeroed,
+                                                 10 * D_TESTS_MEMORY_SMALL_SIZE,
+                                                 D_TESTS_MEMORY_PATTERN_ZERO) &&
+                  (d_arena_calloc(arena, SIZE_MAX, 2) == NULL);
+
+    d_arena_free(arena);
+
+    // build result tree
+    group = d_test_object_new_interior("d_arena_alloc", 7);
+
+    if (!group)
+    {
+        return NULL;
+    }
+
+    idx = 0;
+    group->elements[idx++] = D_ASSERT_TRUE("invalid",
+                                           test_invalid,
+                                           "rejects invalid parameters");
+    group->elements[idx++] = D_ASSERT_TRUE("default_alignment",
+                                           test_default_alignment,
+                                           "aligns to the default alignment");
+    group->elements[idx++] = D_ASSERT_TRUE("alignment",
+                                           test_alignment,
+                                           "honors explicit alignments");
+    group->elements[idx++] = D_ASSERT_TRUE("disjoint",
+                                           test_disjoint,
+                                           "allocations do not overlap");
+    group->elements[idx++] = D_ASSERT_TRUE("chain",
+                                           test_chain,
+                                           "chains new blocks when full");
+    group->elements[idx++] = D_ASSERT_TRUE("oversize",
+                                           test_oversize,
+                                           "serves allocations above the block size");
+    group->elements[idx++] = D_ASSERT_TRUE("calloc",
+                                           test_calloc,
+                                           "zeroes memory and checks overflow");
+
+    return group;
+}
+
+
+/******************************************************************************
+ * ARENA TESTS - d_arena_resize, d_arena_memdup
+ *****************************************************************************/
+
+/*
+d_tests_dmemory_arena_resize
+  Tests d_arena_resize and d_arena_memdup.
+  Tests the following:
+  - the most recent allocation grows in place
+  - the most recent allocation shrinks in place and returns its space
+  - an older allocation moves when grown, keeping its contents
+  - a NULL pointer allocates
+  - d_arena_memdup copies its source and rejects NULL or empty sources
+*/
+struct d_test_object*
+d_tests_dmemory_arena_resize
+(
+    void
+)
+{
+    struct d_test_object* group;
+    struct d_arena*       arena;
+    unsigned char         src[D_TESTS_MEMORY_SMALL_SIZE];
+    unsigned char*        a;
+    unsigned char*        b;
+    unsigned char*        moved;
+    size_t                used;
+    size_t                idx;
+    bool                  test_grow;
+    bool                  test_shrink;
+    bool                  test_move;
+    bool                  test_null;
+    bool                  test_memdup;
+
+    arena = d_arena_new(D_TESTS_MEMORY_LARGE_SIZE);
+
+    if (!arena)
+    {
+        return NULL;
+    }
+
+    // test 1: grow the top allocation in place
+    a = d_arena_alloc(arena, D_TESTS_MEMORY_SMALL_SIZE);
+    test_grow = (a != NULL);
+
+    if (test_grow)
+    {
+        memset(a, D_TESTS_MEMORY_PATTERN_A, D_TESTS_MEMORY_SMALL_SIZE);
+        test_grow = (d_arena_resize(arena,
+                                    a,
+                                    D_TESTS_MEMORY_SMALL_SIZE,
+                                    D_TESTS_MEMORY_MEDIUM_SIZE) == a) &&
+                    d_tests_dmemory_verify_pattern(a,
+                                                   D_TESTS_MEMORY_SMALL_SIZE,
+                                                   D_TESTS_MEMORY_PATTERN_A);
+    }
+
+    // test 2: shrink the top allocation in place
+    used        = d_arena_used(arena);
+    test_shrink = test_grow &&
+                  (d_arena_resize(arena,
+                                  a,
+                                  D_TESTS_MEMORY_MEDIUM_SIZE,
+                                  D_TESTS_MEMORY_SMALL_SIZE) == a) &&
+                  (d_arena_used(arena) ==
+                       used - (D_TESTS_MEMORY_MEDIUM_SIZE - D_TESTS_MEMORY_SMALL_SIZE));
+
+    // test 3: an older allocation moves
+    b         = d_arena_alloc(arena, D_TESTS_MEMORY_SMALL_SIZE);
+    moved     = test_shrink ? d_arena_resize(arena,
+                                             a,
+                                             D_TESTS_MEMORY_SMALL_SIZE,
+                                             D_TESTS_MEMORY_MEDIUM_SIZE)
+                            : NULL;
+    test_move = (b != NULL) &&
+                (moved != NULL) &&
+                (moved != a) &&
+                d_tests_dmemory_verify_pattern(moved,
+                                               D_TESTS_MEMORY_SMALL_SIZE,
+                                               D_TESTS_MEMORY_PATTERN_A) &&
+                (d_arena_resize(arena, b, D_TESTS_MEMORY_SMALL_SIZE, 4) == b);
+
+    // test 4: NULL pointer
+    test_null = (d_arena_resize(arena, NULL, 0, 32) != NULL) &&
+                (d_arena_resize(NULL, a, 16, 32) == NULL) &&
+                (d_arena_resize(arena, a, 16, 0) == NULL);
+
+    // test 5: memdup
+    memset(src, D_TESTS_MEMORY_PATTERN_B, sizeof(src));
+    a           = d_arena_memdup(arena, src, sizeof(src));
+    test_memdup = (a != NULL) &&
+                  (a != src) &&
+                  d_tests_dmemory_compare_buffers(a, src, sizeof(src)) &&
+                  (d_arena_memdup(arena, NULL, sizeof(src)) == NULL) &&
+                  (d_arena_memdup(arena, src, 0) == NULL) &&
+                  (d_arena_memdup(NULL, src, sizeof(src)) == NULL);
+
+    d_arena_free(arena);
+
+    // build result tree
+    group = d_test_object_new_interior("d_arena_resize", 5);
+
+    if (!group)
+    {
+        return NULL;
+    }
+
+    idx = 0;
+    group->elements[idx++] = D_ASSERT_TRUE("grow",
+                                           test_grow,
+                                           "grows the top allocation in place");
+    group->elements[idx++] = D_ASSERT_TRUE("shrink",
+                                           test_shrink,
+                                           "shrinks the top allocation in place");
+    group->elements[idx++] = D_ASSERT_TRUE("move",
+                                           test_move,
+                                           "moves an older allocation");
+    group->elements[idx++] = D_ASSERT_TRUE("null",
+                                           test_null,
+                                           "handles NULL and zero sizes");
+    group->elements[idx++] = D_ASSERT_TRUE("memdup",
+                                           test_memdup,
+                                           "d_arena_memdup copies its source");
+
+    return group;
+}
+
+
+/******************************************************************************
+ * ARENA TESTS - d_arena_mark, d_arena_rollback, d_arena_reset
+ *****************************************************************************/
+
+/*
+d_tests_dmemory_arena_mark
+  Tests d_arena_mark, d_arena_rollback and d_arena_reset.
+  Tests the following:
+  - rolling back restores the usage recorded by the marker
+  - memory allocated after a marker is reused after rolling back to it
+  - memory before the marker is preserved
+  - rolling back across chained blocks reuses the first block
+  - reset returns usage to 0 and reuses memory from the start
+  - NULL arenas and markers are ignored
+*/
+struct d_test_object*
+d_tests_dmemory_arena_mark
+(
+    void
+)
+{
+    struct d_test_object* group;
+    struct d_arena*       arena;
+    struct d_arena_marker marker;
+    unsigned char*        first;
+    unsigned char*        kept;
+    unsigned char*        after;
+    unsigned char*        again;
+    size_t                used;
+    size_t                i;
+    size_t                idx;
+    bool                  test_usage;
+    bool                  test_reuse;
+    bool                  test_preserved;
+    bool                  test_blocks;
+    bool                  test_reset;
+    bool                  test_null;
+
+    arena = d_arena_new(D_TESTS_MEMORY_LARGE_SIZE);
+
+    if (!arena)
+    {
+        return NULL;
+    }
+
+    first = d_arena_alloc(arena, D_TESTS_MEMORY_SMALL_SIZE);
+    kept  = d_arena_alloc(arena, D_TESTS_MEMORY_SMALL_SIZE);
+
+    if (kept)
+    {
+        memset(kept, D_TESTS_MEMORY_PATTERN_A, D_TESTS_MEMORY_SMALL_SIZE);
+    }
+
+    used   = d_arena_used(arena);
+    marker = d_arena_mark(arena);
+
+    // test 1 and 2: roll back a single allocation
+    after = d_arena_alloc(arena, D_TESTS_MEMORY_MEDIUM_SIZE);
+
+    if (after)
+    {
+        memset(after, D_TESTS_MEMORY_PATTERN_B, D_TESTS_MEMORY_MEDIUM_SIZE);
+    }
+
+    d_arena_rollback(arena, marker);
+    test_usage = (after != NULL) &&
+                 (d_arena_used(arena) == used);
+
+    again      = d_arena_alloc(arena, D_TESTS_MEMORY_MEDIUM_SIZE);
+    test_reuse = (again == after);
+
+    // test 3: earlier allocations are untouched
+    test_preserved = (kept != NULL) &&
+                     d_tests_dmemory_verify_pattern(kept,
+                                                    D_TESTS_MEMORY_SMALL_SIZE,
+                                                    D_TESTS_MEMORY_PATTERN_A);
+
+    // test 4: roll back across several blocks
+    d_arena_rollback(arena, marker);
+
+    for (i = 0; i < 64; i++)
+    {
+        d_arena_alloc(arena, D_TESTS_MEMORY_MEDIUM_SIZE);
+    }
+
+    d_arena_rollback(arena, marker);
+    test_blocks = (d_arena_used(arena) == used) &&
+                  (d_arena_alloc(arena, D_TESTS_MEMORY_MEDIUM_SIZE) == after);
+
+    // test 5: reset
+    d_arena_reset(arena);
+    test_reset = (d_arena_used(arena) == 0) &&
+                 (d_arena_alloc(arena, D_TESTS_MEMORY_SMALL_SIZE) == first);
+
+    // test 6: NULL parameters
+    d_arena_reset(NULL);
+    d_arena_rollback(NULL, marker);
+    marker = d_arena_mark(NULL);
+    used   = d_arena_used(arena);
+    d_arena_rollback(arena, marker);
+    test_null = (marker.block == NULL) &&
+                (d_arena_used(arena) == used) &&
+                (d_arena_used(NULL) == 0);
+
+    d_arena_free(arena);
+    d_arena_free(NULL);
+
+    // build result tree
+    group = d_test_object_new_interior("d_arena_mark", 6);
+
+    if (!group)
+    {
+        return NULL;
+    }
+
+    idx = 0;
+    group->elements[idx++] = D_ASSERT_TRUE("usage",
+                                           test_usage,
+                                           "rollback restores the usage");
+    group->elements[idx++] = D_ASSERT_TRUE("reuse",
+                                           test_reuse,
+                                           "rollback reuses released memory");
+    group->elements[idx++] = D_ASSERT_TRUE("preserved",
+                                           test_preserved,
+                                           "rollback keeps earlier memory");
+    group->elements[idx++] = D_ASSERT_TRUE("blocks",
+                                           test_blocks,
+                                           "rollback crosses chained blocks");
+    group->elements[idx++] = D_ASSERT_TRUE("reset",
+                                           test_reset,
+                                           "reset releases everything");
+    group->elements[idx++] = D_ASSERT_TRUE("null",
+                                           test_null,
+                                           "ignores NULL arenas and markers");
+
+    return group;
+}
+
+
+/*
+d_tests_dmemory_arena_all
+  Runs all arena allocator tests.
+  Tests the following:
+  - d_arena_alloc
+  - d_arena_resize
+  - d_arena_mark
+*/
+struct d_test_object*
+d_tests_dmemory_arena_all
+(
+    void
+)
+{
+    struct d_test_object* group;
+    size_t                idx;
+
+    group = d_test_object_new_interior("Arena Allocator", 3);
+
+    if (!group)
+    {
+        return NULL;
+    }
+
+    idx = 0;
+    group->elements[idx++] = d_tests_dmemory_arena_alloc();
+    group->elements[idx++] = d_tests_dmemory_arena_resize();
+    group->elements[idx++] = d_tests_dmemory_arena_mark();
+
+    return group;
+}
@@ -278,12 +278,231 @@ d_tests_dmemory_memcpy_s
 }
 
 
+/******************************************************************************
+ * MEMORY COPY TESTS - d_memcpy_stream / d_memcpy_parallel
+ *****************************************************************************/
+
+/*
+d_tests_dmemory_memcpy_stream
+  Tests d_memcpy_stream and the stream threshold. The threshold is lowered for
+the test so the non-temporal path runs on a small buffer.
+  Tests the following:
+  - copies below the threshold correctly
+  - copies above the threshold correctly from unaligned addresses
+  - preserves the bytes after the destination
+  - returns NULL for NULL parameters
+  - threshold can be set and restored
+*/
+struct d_test_object*
+d_tests_dmemory_memcpy_stream
+(
+    void
+)
+{
+    struct d_test_object* group;
+    unsigned char*        src;
+    unsigned char*        dest;
+    size_t                size;
+    size_t                saved;
+    size_t                i;
+    size_t                idx;
+    bool                  test_small;
+    bool                  test_large;
+    bool                  test_guard;
+    bool                  test_null;
+    bool                  test_threshold;
+
+    size = (1u << 20) + 37;
+    src  = malloc(size + 64);
+    dest = malloc(size + 64);
+
+    if ( (!src) ||
+         (!dest) )
+    {
+        free(src);
+        free(dest);
+
+        return NULL;
+    }
+
+    for (i = 0; i < size + 64; i++)
+    {
+        src[i] = (unsigned char)((i * 131) ^ (i >> 8));
+    }
+
+    saved = d_memory_stream_threshold();
+
+    // test 1: below the threshold
+    memset(dest, 0, size + 64);
+    test_small = (d_memcpy_stream(dest, src, D_TESTS_MEMORY_MEDIUM_SIZE) == dest) &&
+                 d_tests_dmemory_compare_buffers(dest, src,
+                                                 D_TESTS_MEMORY_MEDIUM_SIZE);
+
+    // test 2: above the threshold, source and destination misaligned
+    d_memory_set_stream_threshold(D_TESTS_MEMORY_LARGE_SIZE);
+    memset(dest, 0xBB, size + 64);
+    test_large = (d_memcpy_stream(dest + 5, src + 11, size) == dest + 5) &&
+                 d_tests_dmemory_compare_buffers(dest + 5, src + 11, size);
+
+    // test 3: guard bytes
+    test_guard = (dest[4] == 0xBB) &&
+                 (dest[size + 5] == 0xBB);
+
+    // test 4: NULL parameters
+    test_null = (d_memcpy_stream(NULL, src, 16) == NULL) &&
+                (d_memcpy_stream(dest, NULL, 16) == NULL);
+
+    // test 5: threshold round trip
+    test_threshold = (d_memory_stream_threshold() == D_TESTS_MEMORY_LARGE_SIZE);
+    d_memory_set_stream_threshold(0);
+    test_threshold = test_threshold &&
+                     (d_memory_stream_threshold() == saved) &&
+                     (saved > 0);
+
+    free(src);
+    free(dest);
+
+    // build result tree
+    group = d_test_object_new_interior("d_memcpy_stream", 5);
+
+    if (!group)
+    {
+        return NULL;
+    }
+
+    idx = 0;
+    group->elements[idx++] = D_ASSERT_TRUE("small",
+                                           test_small,
+                                           "copies below the threshold");
+    group->elements[idx++] = D_ASSERT_TRUE("large",
+                                           test_large,
+                                           "streams an unaligned copy");
+    group->elements[idx++] = D_ASSERT_TRUE("guard",
+                                           test_guard,
+                                           "preserves surrounding memory");
+    group->elements[idx++] = D_ASSERT_TRUE("null",
+                                           test_null,
+                                           "returns NULL for NULL parameters");
+    group->elements[idx++] = D_ASSERT_TRUE("threshold",
+                                           test_threshold,
+                                           "threshold can be set and restored");
+
+    return group;
+}
+
+/*
+d_tests_dmemory_memcpy_parallel
+  Tests d_memcpy_parallel.
+  Tests the following:
+  - copies a multi-slice region across threads
+  - copies a ragged length whose last slice is short
+  - runs a short copy on the calling thread
+  - 0 threads uses the hardware concurrency
+  - returns NULL for NULL parameters
+*/
+struct d_test_object*
+d_tests_dmemory_memcpy_parallel
+(
+    void
+)
+{
+    struct d_test_object* group;
+    unsigned char*        src;
+    unsigned char*        dest;
+    size_t                size;
+    size_t                i;
+    size_t                idx;
+    bool                  test_threads;
+    bool                  test_ragged;
+    bool                  test_short;
+    bool                  test_default;
+    bool                  test_null;
+
+    size = (3 * D_MEMORY_PARALLEL_SLICE_MIN) + 4099;
+    src  = malloc(size);
+    dest = malloc(size);
+
+    if ( (!src) ||
+         (!dest) )
+    {
+        free(src);
+        free(dest);
+
+        return NULL;
+    }
+
+    for (i = 0; i < size; i++)
+    {
+        src[i] = (unsigned char)((i * 167) ^ (i >> 12));
+    }
+
+    // test 1: four threads, one slice each
+    memset(dest, 0, size);
+    test_threads = (d_memcpy_parallel(dest, src, size, 4) == dest) &&
+                   d_tests_dmemory_compare_buffers(dest, src, size);
+
+    // test 2: more threads than slices, unaligned start
+    memset(dest, 0, size);
+    test_ragged = (d_memcpy_parallel(dest + 1, src + 3, size - 3, 64) == dest + 1) &&
+                  d_tests_dmemory_compare_buffers(dest + 1, src + 3, size - 3) &&
+                  (dest[0] == 0) &&
+                  (dest[size - 2] == 0);
+
+    // test 3: below two slices
+    memset(dest, 0, size);
+    test_short = (d_memcpy_parallel(dest, src, D_TESTS_MEMORY_LARGE_SIZE, 8) == dest) &&
+                 d_tests_dmemory_compare_buffers(dest, src, D_TESTS_MEMORY_LARGE_SIZE) &&
+                 (dest[D_TESTS_MEMORY_LARGE_SIZE] == 0);
+
+    // test 4: hardware concurrency
+    memset(dest, 0, size);
+    test_default = (d_memcpy_parallel(dest, src, size, 0) == dest) &&
+                   d_tests_dmemory_compare_buffers(dest, src, size);
+
+    // test 5: NULL parameters
+    test_null = (d_memcpy_parallel(NULL, src, 16, 2) == NULL) &&
+                (d_memcpy_parallel(dest, NULL, 16, 2) == NULL);
+
+    free(src);
+    free(dest);
+
+    // build result tree
+    group = d_test_object_new_interior("d_memcpy_parallel", 5);
+
+    if (!group)
+    {
+        return NULL;
+    }
+
+    idx = 0;
+    group->elements[idx++] = D_ASSERT_TRUE("threads",
+                                           test_threads,
+                                           "copies across threads");
+    group->elements[idx++] = D_ASSERT_TRUE("ragged",
+                                           test_ragged,
+                                           "copies a ragged length");
+    group->elements[idx++] = D_ASSERT_TRUE("short",
+                                           test_short,
+                                           "copies a short region in place");
+    group->elements[idx++] = D_ASSERT_TRUE("default_threads",
+                                           test_default,
+                                           "0 uses the hardware concurrency");
+    group->elements[idx++] = D_ASSERT_TRUE("null",
+                                           test_null,
+                                           "returns NULL for NULL parameters");
+
+    return group;
+}
+
+
 /*
 d_tests_dmemory_copy_all
   Runs all memory copy tests.
   Tests the following:
   - d_memcpy
   - d_memcpy_s
+  - d_memcpy_stream
+  - d_memcpy_parallel
 */
 struct d_test_object*
 d_tests_dmemory_copy_all
@@ -294,7 +513,7 @@ d_tests_dmemory_copy_all
     struct d_test_object* group;
     size_t                idx;
 
-    group = d_test_object_new_interior("Memory Copy Operations", 2);
+    group = d_test_object_new_interior("Memory Copy Operations", 4);
 
     if (!group)
     {
@@ -304,6 +523,8 @@ d_tests_dmemory_copy_all
     idx = 0;
     group->elements[idx++] = d_tests_dmemory_memcpy();
     group->elements[idx++] = d_tests_dmemory_memcpy_s();
+    group->elements[idx++] = d_tests_dmemory_memcpy_stream();
+    group->elements[idx++] = d_tests_dmemory_memcpy_parallel();
 
     return group;
 }
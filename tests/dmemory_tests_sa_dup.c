@@ -522,12 +522,100 @@ d_tests_dmemory_memset_s
 }
 
 
+/*
+d_tests_dmemory_memset_large
+  Tests d_memset and d_memset_s on regions of at least
+d_memory_stream_threshold() bytes, which take the non-temporal store path.
+The threshold is lowered for the test so the buffers stay small.
+  Tests the following:
+  - fills an unaligned large region completely
+  - preserves the bytes on either side of the region
+  - handles a length that is not a multiple of the store width
+  - d_memset_s clears a large region
+*/
+struct d_test_object*
+d_tests_dmemory_memset_large
+(
+    void
+)
+{
+    struct d_test_object* group;
+    unsigned char*        buffer;
+    size_t                size;
+    size_t                idx;
+    bool                  test_fill;
+    bool                  test_guards;
+    bool                  test_odd_length;
+    bool                  test_secure;
+
+    // region starts 3 bytes past the allocation and ends 64 + 5 bytes early
+    size   = (1u << 20) + 61;
+    buffer = malloc(size + 72);
+
+    if (!buffer)
+    {
+        return NULL;
+    }
+
+    d_memory_set_stream_threshold(D_TESTS_MEMORY_LARGE_SIZE);
+
+    // test 1: unaligned fill
+    memset(buffer, 0xBB, size + 72);
+    d_memset(buffer + 3, 0xAA, size);
+    test_fill = d_tests_dmemory_verify_pattern(buffer + 3, size, 0xAA);
+
+    // test 2: surrounding bytes
+    test_guards = (buffer[2] == 0xBB) &&
+                  (buffer[size + 3] == 0xBB);
+
+    // test 3: length not a multiple of 16 or 64, at a different offset
+    d_memset(buffer + 8, 0x5C, size - 7);
+    test_odd_length = (buffer[7] == 0xAA) &&
+                      d_tests_dmemory_verify_pattern(buffer + 8,
+                                                     size - 7,
+                                                     0x5C) &&
+                      (buffer[size + 1] == 0xAA);
+
+    // test 4: secure clear
+    test_secure = (d_memset_s(buffer, size + 72, 0, size + 72) == 0) &&
+                  d_tests_dmemory_verify_pattern(buffer, size + 72, 0x00);
+
+    d_memory_set_stream_threshold(0);
+    free(buffer);
+
+    // build result tree
+    group = d_test_object_new_interior("d_memset (large)", 4);
+
+    if (!group)
+    {
+        return NULL;
+    }
+
+    idx = 0;
+    group->elements[idx++] = D_ASSERT_TRUE("fill",
+                                           test_fill,
+                                           "fills an unaligned large region");
+    group->elements[idx++] = D_ASSERT_TRUE("guards",
+                                           test_guards,
+                                           "preserves surrounding memory");
+    group->elements[idx++] = D_ASSERT_TRUE("odd_length",
+                                           test_odd_length,
+                                           "handles a ragged tail");
+    group->elements[idx++] = D_ASSERT_TRUE("secure",
+                                           test_secure,
+                                           "d_memset_s clears a large region");
+
+    return group;
+}
+
+
 /*
 d_tests_dmemory_set_all
   Runs all memory set tests.
   Tests the following:
   - d_memset
   - d_memset_s
+  - d_memset / d_memset_s on large regions
 */
 struct d_test_object*
 d_tests_dmemory_set_all
@@ -538,7 +626,7 @@ d_tests_dmemory_set_all
     struct d_test_object* group;
     size_t                idx;
 
-    group = d_test_object_new_interior("Memory Set Operations", 2);
+    group = d_test_object_new_interior("Memory Set Operations", 3);
 
     if (!group)
     {
@@ -548,6 +636,7 @@ d_tests_dmemory_set_all
     idx = 0;
     group->elements[idx++] = d_tests_dmemory_memset();
     group->elements[idx++] = d_tests_dmemory_memset_s();
+    group->elements[idx++] = d_tests_dmemory_memset_large();
 
     return group;
 }
\ No newline at end of file
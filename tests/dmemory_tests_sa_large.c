@@ -0,0 +1,392 @@
+#include ".\dmemory_tests_sa.h"
+
+
+/******************************************************************************
+ * LARGE BUFFER TESTS - helpers
+ *****************************************************************************/
+
+/*
+d_tests_dmemory_large_fill
+  Writes a position-dependent pattern over `_size` bytes.
+*/
+static void
+d_tests_dmemory_large_fill
+(
+    unsigned char* _buffer,
+    size_t         _size
+)
+{
+    size_t i;
+
+    for (i = 0; i < _size; i++)
+    {
+        _buffer[i] = (unsigned char)(i % 251);
+    }
+
+    return;
+}
+
+/*
+d_tests_dmemory_large_check
+  Returns true if `_size` bytes still hold d_tests_dmemory_large_fill's
+pattern.
+*/
+static bool
+d_tests_dmemory_large_check
+(
+    const unsigned char* _buffer,
+    size_t               _size
+)
+{
+    size_t i;
+
+    if (!_buffer)
+    {
+        return false;
+    }
+
+    for (i = 0; i < _size; i++)
+    {
+        if (_buffer[i] != (unsigned char)(i % 251))
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+
+/******************************************************************************
+ * LARGE BUFFER TESTS - d_aligned_alloc, d_large_alloc, d_allocator_large
+ *****************************************************************************/
+
+/*
+d_tests_dmemory_aligned_alloc
+  Tests d_aligned_alloc and d_aligned_free.
+  Tests the following:
+  - every power-of-two alignment up to a page is honored
+  - sizes need not be multiples of the alignment
+  - zero sizes and alignments that are not powers of two are rejected
+*/
+struct d_test_object*
+d_tests_dmemory_aligned_alloc
+(
+    void
+)
+{
+    struct d_test_object* group;
+    unsigned char*        memory;
+    size_t                alignment;
+    size_t                idx;
+    bool                  test_alignment;
+    bool                  test_odd_size;
+    bool                  test_invalid;
+
+    // test 1: alignments
+    test_alignment = true;
+
+    for (alignment = 1; alignment <= 4096; alignment *= 2)
+    {
+        memory = d_aligned_alloc(D_TESTS_MEMORY_MEDIUM_SIZE, alignment);
+
+        if ( (!memory) ||
+             (((uintptr_t)memory % alignment) != 0) )
+        {
+            test_alignment = false;
+        }
+        else
+        {
+            memset(memory, 0xA5, D_TESTS_MEMORY_MEDIUM_SIZE);
+        }
+
+        d_aligned_free(memory);
+    }
+
+    // test 2: a size that is not a multiple of the alignment
+    memory        = d_aligned_alloc(3, 64);
+    test_odd_size = (memory != NULL) &&
+                    (((uintptr_t)memory % 64) == 0);
+
+    if (memory)
+    {
+        memcpy(memory, "ok", 3);
+        test_odd_size = test_odd_size && (strcmp((char*)memory, "ok") == 0);
+    }
+
+    d_aligned_free(memory);
+    d_aligned_free(NULL);
+
+    // test 3: invalid parameters
+    test_invalid = (d_aligned_alloc(0, 64) == NULL) &&
+                   (d_aligned_alloc(16, 0) == NULL) &&
+                   (d_aligned_alloc(16, 24) == NULL);
+
+    group = d_test_object_new_interior("d_aligned_alloc", 3);
+
+    if (!group)
+    {
+        return NULL;
+    }
+
+    idx = 0;
+    group->elements[idx++] = D_ASSERT_TRUE("alignment",
+                                           test_alignment,
+                                           "honors power-of-two alignments");
+    group->elements[idx++] = D_ASSERT_TRUE("odd_size",
+                                           test_odd_size,
+                                           "accepts sizes that are not multiples");
+    group->elements[idx++] = D_ASSERT_TRUE("invalid",
+                                           test_invalid,
+                                           "rejects invalid parameters");
+
+    return group;
+}
+
+/*
+d_tests_dmemory_large_alloc
+  Tests d_large_alloc, d_large_realloc and d_large_free.
+  Tests the following:
+  - buffers below D_MEMORY_LARGE_THRESHOLD are cache-line aligned
+  - mapped buffers are page-aligned, zero-filled and writable, with or
+    without D_MEMORY_LARGE_HUGE_PAGES and D_MEMORY_LARGE_POPULATE
+  - resizing keeps contents across the threshold, in both directions, and
+    between mapped sizes
+  - NULL buffers, zero sizes and NULL frees are handled
+*/
+struct d_test_object*
+d_tests_dmemory_large_alloc
+(
+    void
+)
+{
+    struct d_test_object* group;
+    unsigned char*        memory;
+    unsigned char*        moved;
+    size_t                large;
+    size_t                idx;
+    bool                  test_small;
+    bool                  test_mapped;
+    bool                  test_flags;
+    bool                  test_realloc;
+    bool                  test_edges;
+
+    large = D_MEMORY_LARGE_THRESHOLD + 12345;
+
+    // test 1: heap buffers
+    memory     = d_large_alloc(D_TESTS_MEMORY_LARGE_SIZE, 0);
+    test_small = (memory != NULL) &&
+                 (((uintptr_t)memory % D_MEMORY_CACHE_LINE_SIZE) == 0);
+    d_large_free(memory, D_TESTS_MEMORY_LARGE_SIZE);
+
+    // test 2: mapped buffers
+    memory      = d_large_alloc(large, 0);
+    test_mapped = (memory != NULL) &&
+                  (((uintptr_t)memory % 4096) == 0) &&
+                  (memory[0] == 0) &&
+                  (memory[large - 1] == 0);
+
+    if (memory)
+    {
+        d_tests_dmemory_large_fill(memory, large);
+        test_mapped = test_mapped && d_tests_dmemory_large_check(memory, large);
+    }
+
+    d_large_free(memory, large);
+
+    // test 3: huge pages and population
+    memory     = d_large_alloc(2 * D_MEMORY_HUGE_PAGE_SIZE + 1,
+                               D_MEMORY_LARGE_HUGE_PAGES | D_MEMORY_LARGE_POPULATE);
+    test_flags = (memory != NULL) &&
+                 (((uintptr_t)memory % 4096) == 0) &&
+                 (memory[D_MEMORY_HUGE_PAGE_SIZE] == 0);
+
+    if (memory)
+    {
+        d_tests_dmemory_large_fill(memory, 2 * D_MEMORY_HUGE_PAGE_SIZE + 1);
+        test_flags = test_flags &&
+                     d_tests_dmemory_large_check(memory,
+                                                 2 * D_MEMORY_HUGE_PAGE_SIZE + 1);
+    }
+
+    d_large_free(memory, 2 * D_MEMORY_HUGE_PAGE_SIZE + 1);
+
+    // test 4: resizing across the threshold and between mapped sizes
+    memory = d_large_alloc(D_TESTS_MEMORY_LARGE_SIZE, 0);
+
+    if (memory)
+    {
+        d_tests_dmemory_large_fill(memory, D_TESTS_MEMORY_LARGE_SIZE);
+    }
+
+    moved        = d_large_realloc(memory, D_TESTS_MEMORY_LARGE_SIZE, large, 0);
+    test_realloc = d_tests_dmemory_large_check(moved, D_TESTS_MEMORY_LARGE_SIZE);
+
+    if (moved)
+    {
+        d_tests_dmemory_large_fill(moved, large);
+        memory       = moved;
+        moved        = d_large_realloc(memory, large, 3 * large, 0);
+        test_realloc = test_realloc &&
+                       d_tests_dmemory_large_check(moved, large);
+    }
+
+    if (moved)
+    {
+        memory       = moved;
+        moved        = d_large_realloc(memory, 3 * large, large + 1, 0);
+        test_realloc = test_realloc &&
+                       d_tests_dmemory_large_check(moved, large);
+    }
+
+    if (moved)
+    {
+        memory       = moved;
+        moved        = d_large_realloc(memory, large + 1, 100, 0);
+        test_realloc = test_realloc &&
+                       d_tests_dmemory_large_check(moved, 100);
+    }
+
+    d_large_free(moved, 100);
+
+    // test 5: edge cases
+    memory     = d_large_realloc(NULL, 0, D_TESTS_MEMORY_SMALL_SIZE, 0);
+    test_edges = (memory != NULL) &&
+                 (d_large_realloc(memory, D_TESTS_MEMORY_SMALL_SIZE, 0, 0) == NULL) &&
+                 (d_large_alloc(0, 0) == NULL);
+    d_large_free(NULL, large);
+
+    group = d_test_object_new_interior("d_large_alloc", 5);
+
+    if (!group)
+    {
+        return NULL;
+    }
+
+    idx = 0;
+    group->elements[idx++] = D_ASSERT_TRUE("small",
+                                           test_small,
+                                           "aligns heap buffers to cache lines");
+    group->elements[idx++] = D_ASSERT_TRUE("mapped",
+                                           test_mapped,
+                                           "maps page-aligned, zeroed buffers");
+    group->elements[idx++] = D_ASSERT_TRUE("flags",
+                                           test_flags,
+                                           "maps with huge pages and population");
+    group->elements[idx++] = D_ASSERT_TRUE("realloc",
+                                           test_realloc,
+                                           "resizes keeping contents");
+    group->elements[idx++] = D_ASSERT_TRUE("edges",
+                                           test_edges,
+                                           "handles NULL buffers and zero sizes");
+
+    return group;
+}
+
+/*
+d_tests_dmemory_large_allocator
+  Tests d_allocator_large.
+  Tests the following:
+  - allocations through it are cache-line aligned or mapped
+  - alignments stricter than a cache line are rejected
+  - d_allocator_realloc keeps contents across the threshold
+*/
+struct d_test_object*
+d_tests_dmemory_large_allocator
+(
+    void
+)
+{
+    struct d_test_object*     group;
+    const struct d_allocator* allocator;
+    unsigned char*            memory;
+    unsigned char*            moved;
+    size_t                    large;
+    size_t                    idx;
+    bool                      test_alloc;
+    bool                      test_alignment;
+    bool                      test_realloc;
+
+    allocator = d_allocator_large();
+    large     = D_MEMORY_LARGE_THRESHOLD * 2;
+
+    // test 1: allocation
+    memory     = d_allocator_alloc(allocator, D_TESTS_MEMORY_SMALL_SIZE);
+    test_alloc = (allocator != NULL) &&
+                 (memory != NULL) &&
+                 (((uintptr_t)memory % D_MEMORY_CACHE_LINE_SIZE) == 0);
+
+    // test 2: alignment
+    test_alignment = (d_allocator_alloc_aligned(allocator,
+                                                D_TESTS_MEMORY_SMALL_SIZE,
+                                                2 * D_MEMORY_CACHE_LINE_SIZE) == NULL);
+
+    // test 3: reallocation
+    if (memory)
+    {
+        d_tests_dmemory_large_fill(memory, D_TESTS_MEMORY_SMALL_SIZE);
+    }
+
+    moved        = d_allocator_realloc(allocator,
+                                       memory,
+                                       D_TESTS_MEMORY_SMALL_SIZE,
+                                       large);
+    test_realloc = d_tests_dmemory_large_check(moved, D_TESTS_MEMORY_SMALL_SIZE) &&
+                   (((uintptr_t)moved % 4096) == 0);
+    d_allocator_free(allocator,
+                     (moved != NULL) ? moved : memory,
+                     (moved != NULL) ? large : D_TESTS_MEMORY_SMALL_SIZE);
+
+    group = d_test_object_new_interior("d_allocator_large", 3);
+
+    if (!group)
+    {
+        return NULL;
+    }
+
+    idx = 0;
+    group->elements[idx++] = D_ASSERT_TRUE("alloc",
+                                           test_alloc,
+                                           "allocates aligned buffers");
+    group->elements[idx++] = D_ASSERT_TRUE("alignment",
+                                           test_alignment,
+                                           "rejects alignments past a cache line");
+    group->elements[idx++] = D_ASSERT_TRUE("realloc",
+                                           test_realloc,
+                                           "resizes keeping contents");
+
+    return group;
+}
+
+
+/*
+d_tests_dmemory_large_all
+  Runs all aligned and large buffer tests.
+  Tests the following:
+  - d_aligned_alloc and d_aligned_free
+  - d_large_alloc, d_large_realloc and d_large_free
+  - d_allocator_large
+*/
+struct d_test_object*
+d_tests_dmemory_large_all
+(
+    void
+)
+{
+    struct d_test_object* group;
+    size_t                idx;
+
+    group = d_test_object_new_interior("Aligned and Large Buffers", 3);
+
+    if (!group)
+    {
+        return NULL;
+    }
+
+    idx = 0;
+    group->elements[idx++] = d_tests_dmemory_aligned_alloc();
+    group->elements[idx++] = d_tests_dmemory_large_alloc();
+    group->elements[idx++] = d_tests_dmemory_large_allocator();
+
+    return group;
+}
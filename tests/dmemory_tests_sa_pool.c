@@ -0,0 +1,491 @@
+#include ".\dmemory_tests_sa.h"
+#include "..\inc\dmutex.h"
+
+
+/******************************************************************************
+ * POOL TESTS - d_pool_alloc, d_pool_release
+ *****************************************************************************/
+
+// D_TESTS_MEMORY_POOL_OBJECTS
+//   constant: number of objects the pool tests keep live at once; several
+// magazines' worth, so that the depot is exercised.
+#define D_TESTS_MEMORY_POOL_OBJECTS     (D_POOL_MAGAZINE_SIZE * 5 + 3)
+
+// D_TESTS_MEMORY_POOL_THREADS
+//   constant: number of threads in the cross-thread pool test.
+#define D_TESTS_MEMORY_POOL_THREADS     4
+
+// d_tests_dmemory_pool_handoff
+//   struct: objects allocated by one thread for another to verify and
+// release.
+struct d_tests_dmemory_pool_handoff
+{
+    struct d_pool*  pool;
+    unsigned char** objects;
+    size_t          count;
+    size_t          object_size;
+    bool            ok;
+};
+
+/*
+d_tests_dmemory_pool_release_worker
+  Thread body of the cross-thread test: checks the stamp of each object
+handed over and releases it, then allocates and releases a few magazines'
+worth of its own.
+*/
+static d_thread_result_t
+d_tests_dmemory_pool_release_worker
+(
+    void* _arg
+)
+{
+    struct d_tests_dmemory_pool_handoff* handoff;
+    unsigned char*                       own[D_POOL_MAGAZINE_SIZE * 2];
+    size_t                               i;
+
+    handoff = (struct d_tests_dmemory_pool_handoff*)_arg;
+
+    for (i = 0; i < handoff->count; i++)
+    {
+        if (!d_tests_dmemory_verify_pattern(handoff->objects[i],
+                                            handoff->object_size,
+                                            (unsigned char)i))
+        {
+            handoff->ok = false;
+        }
+
+        d_pool_release(handoff->pool, handoff->objects[i]);
+    }
+
+    for (i = 0; i < (D_POOL_MAGAZINE_SIZE * 2); i++)
+    {
+        own[i] = d_pool_alloc(handoff->pool);
+
+        if (!own[i])
+        {
+            handoff->ok = false;
+
+            return (d_thread_result_t)0;
+        }
+
+        memset(own[i], D_TESTS_MEMORY_PATTERN_B, handoff->object_size);
+    }
+
+    for (i = 0; i < (D_POOL_MAGAZINE_SIZE * 2); i++)
+    {
+        d_pool_release(handoff->pool, own[i]);
+    }
+
+    return (d_thread_result_t)0;
+}
+
+/*
+d_tests_dmemory_pool_alloc
+  Tests d_pool_new, d_pool_alloc and d_pool_release on one thread.
+  Tests the following:
+  - d_pool_new rejects a zero size and a bad alignment
+  - objects are aligned, disjoint and writable across several magazines
+  - released objects are handed out again
+  - NULL pools and objects are ignored
+*/
+struct d_test_object*
+d_tests_dmemory_pool_alloc
+(
+    void
+)
+{
+    struct d_test_object* group;
+    struct d_pool*        pool;
+    unsigned char*        objects[D_TESTS_MEMORY_POOL_OBJECTS];
+    unsigned char*        again;
+    size_t                i;
+    size_t                idx;
+    bool                  test_invalid;
+    bool                  test_distinct;
+    bool                  test_reuse;
+    bool                  test_null;
+
+    // test 1: invalid parameters
+    test_invalid = (d_pool_new(0, 0) == NULL) &&
+                   (d_pool_new(24, 12) == NULL);
+
+    pool = d_pool_new(24, 32);
+
+    if (!pool)
+    {
+        return NULL;
+    }
+
+    // test 2: aligned, disjoint objects
+    test_distinct = true;
+
+    for (i = 0; i < D_TESTS_MEMORY_POOL_OBJECTS; i++)
+    {
+        objects[i] = d_pool_alloc(pool);
+
+        if ( (!objects[i]) ||
+             (((uintptr_t)objects[i] % 32) != 0) )
+        {
+            test_distinct = false;
+
+            break;
+        }
+
+        memset(objects[i], (int)(i & 0xFF), 24);
+    }
+
+    for (i = 0; test_distinct && (i < D_TESTS_MEMORY_POOL_OBJECTS); i++)
+    {
+        test_distinct = d_tests_dmemory_verify_pattern(objects[i],
+                                                       24,
+                                                       (unsigned char)(i & 0xFF));
+    }
+
+    // test 3: reuse
+    test_reuse = test_distinct;
+
+    if (test_distinct)
+    {
+        d_pool_release(pool, objects[7]);
+        again      = d_pool_alloc(pool);
+        test_reuse = (again == objects[7]);
+
+        for (i = 0; i < D_TESTS_MEMORY_POOL_OBJECTS; i++)
+        {
+            d_pool_release(pool, objects[i]);
+        }
+    }
+
+    // test 4: NULL parameters
+    d_pool_release(NULL, objects[0]);
+    d_pool_release(pool, NULL);
+    d_pool_flush(NULL);
+    test_null = (d_pool_alloc(NULL) == NULL);
+
+    d_pool_free(pool);
+    d_pool_free(NULL);
+
+    // build result tree
+    group = d_test_object_new_interior("d_pool_alloc", 4);
+
+    if (!group)
+    {
+        return NULL;
+    }
+
+    idx = 0;
+    group->elements[idx++] = D_ASSERT_TRUE("invalid",
+                                           test_invalid,
+                                           "rejects invalid sizes and alignments");
+    group->elements[idx++] = D_ASSERT_TRUE("distinct",
+                                           test_distinct,
+                                           "objects are aligned and disjoint");
+    group->elements[idx++] = D_ASSERT_TRUE("reuse",
+                                           test_reuse,
+                                           "released objects are reused");
+    group->elements[idx++] = D_ASSERT_TRUE("null",
+                                           test_null,
+                                           "ignores NULL pools and objects");
+
+    return group;
+}
+
+
+/******************************************************************************
+ * POOL TESTS - d_pool_get_stats, d_pool_flush
+ *****************************************************************************/
+
+/*
+d_tests_dmemory_pool_stats
+  Tests d_pool_get_stats and d_pool_flush.
+  Tests the following:
+  - a new pool reports nothing live or cached
+  - the object size is rounded up to the alignment
+  - live objects are counted, and live + cached equals total
+  - the high-water mark survives releasing every object
+  - flushing keeps the counts and the objects are reused afterwards
+  - NULL parameters are rejected
+*/
+struct d_test_object*
+d_tests_dmemory_pool_stats
+(
+    void
+)
+{
+    struct d_test_object* group;
+    struct d_pool*        pool;
+    struct d_pool_stats   stats;
+    void*                 objects[D_TESTS_MEMORY_POOL_OBJECTS];
+    size_t                total;
+    size_t                i;
+    size_t                idx;
+    bool                  test_empty;
+    bool                  test_size;
+    bool                  test_live;
+    bool                  test_high_water;
+    bool                  test_flush;
+    bool                  test_null;
+
+    pool = d_pool_new(10, 8);
+
+    if (!pool)
+    {
+        return NULL;
+    }
+
+    // test 1 and 2: new pool
+    test_empty = d_pool_get_stats(pool, &stats) &&
+                 (stats.live == 0) &&
+                 (stats.cached == 0) &&
+                 (stats.total == 0);
+    test_size  = (stats.object_size == 16);
+
+    // test 3: live count
+    for (i = 0; i < D_TESTS_MEMORY_POOL_OBJECTS; i++)
+    {
+        objects[i] = d_pool_alloc(pool);
+    }
+
+    test_live = d_pool_get_stats(pool, &stats) &&
+                (stats.live == D_TESTS_MEMORY_POOL_OBJECTS) &&
+                (stats.live + stats.cached == stats.total);
+
+    // test 4: high-water mark
+    for (i = 0; i < D_TESTS_MEMORY_POOL_OBJECTS; i++)
+    {
+        d_pool_release(pool, objects[i]);
+    }
+
+    test_high_water = d_pool_get_stats(pool, &stats) &&
+                      (stats.live == 0) &&
+                      (stats.cached == stats.total) &&
+                      (stats.high_water >= D_TESTS_MEMORY_POOL_OBJECTS -
+                                           (2 * D_POOL_MAGAZINE_SIZE)) &&
+                      (stats.high_water <= stats.total);
+
+    // test 5: flush, then reuse without carving
+    total = stats.total;
+    d_pool_flush(pool);
+
+    for (i = 0; i < D_TESTS_MEMORY_POOL_OBJECTS; i++)
+    {
+        objects[i] = d_pool_alloc(pool);
+    }
+
+    test_flush = d_pool_get_stats(pool, &stats) &&
+                 (stats.live == D_TESTS_MEMORY_POOL_OBJECTS) &&
+                 (stats.total == total);
+
+    for (i = 0; i < D_TESTS_MEMORY_POOL_OBJECTS; i++)
+    {
+        d_pool_release(pool, objects[i]);
+    }
+
+    // test 6: NULL parameters
+    test_null = (!d_pool_get_stats(NULL, &stats)) &&
+                (!d_pool_get_stats(pool, NULL));
+
+    d_pool_free(pool);
+
+    // build result tree
+    group = d_test_object_new_interior("d_pool_get_stats", 6);
+
+    if (!group)
+    {
+        return NULL;
+    }
+
+    idx = 0;
+    group->elements[idx++] = D_ASSERT_TRUE("empty",
+                                           test_empty,
+                                           "a new pool is empty");
+    group->elements[idx++] = D_ASSERT_TRUE("object_size",
+                                           test_size,
+                                           "rounds the size to the alignment");
+    group->elements[idx++] = D_ASSERT_TRUE("live",
+                                           test_live,
+                                           "counts live objects");
+    group->elements[idx++] = D_ASSERT_TRUE("high_water",
+                                           test_high_water,
+                                           "keeps the high-water mark");
+    group->elements[idx++] = D_ASSERT_TRUE("flush",
+                                           test_flush,
+                                           "reuses flushed objects");
+    group->elements[idx++] = D_ASSERT_TRUE("null",
+                                           test_null,
+                                           "rejects NULL parameters");
+
+    return group;
+}
+
+
+/******************************************************************************
+ * POOL TESTS - cross-thread release
+ *****************************************************************************/
+
+/*
+d_tests_dmemory_pool_threads
+  Tests releasing objects on threads other than the one that allocated them.
+  Tests the following:
+  - each thread sees the contents written by the allocating thread
+  - every object is accounted for once all threads have exited
+  - objects released by exited threads are reused without carving
+*/
+struct d_test_object*
+d_tests_dmemory_pool_threads
+(
+    void
+)
+{
+    struct d_test_object*               group;
+    struct d_pool*                      pool;
+    struct d_pool_stats                 stats;
+    struct d_tests_dmemory_pool_handoff handoffs[D_TESTS_MEMORY_POOL_THREADS];
+    unsigned char*                      objects[D_TESTS_MEMORY_POOL_THREADS]
+                                               [D_TESTS_MEMORY_POOL_OBJECTS];
+    void*                               reused[D_TESTS_MEMORY_POOL_OBJECTS];
+    d_thread_t                          threads[D_TESTS_MEMORY_POOL_THREADS];
+    bool                                started[D_TESTS_MEMORY_POOL_THREADS];
+    size_t                              total;
+    size_t                              t;
+    size_t                              i;
+    size_t                              idx;
+    bool                                test_contents;
+    bool                                test_counts;
+    bool                                test_reuse;
+
+    pool = d_pool_new(D_TESTS_MEMORY_SMALL_SIZE * 3, 0);
+
+    if (!pool)
+    {
+        return NULL;
+    }
+
+    test_contents = true;
+
+    for (t = 0; t < D_TESTS_MEMORY_POOL_THREADS; t++)
+    {
+        for (i = 0; i < D_TESTS_MEMORY_POOL_OBJECTS; i++)
+        {
+            objects[t][i] = d_pool_alloc(pool);
+
+            if (!objects[t][i])
+            {
+                test_contents = false;
+
+                break;
+            }
+
+            memset(objects[t][i], (int)(i & 0xFF), D_TESTS_MEMORY_SMALL_SIZE * 3);
+        }
+
+        handoffs[t].pool        = pool;
+        handoffs[t].objects     = objects[t];
+        handoffs[t].count       = i;
+        handoffs[t].object_size = D_TESTS_MEMORY_SMALL_SIZE * 3;
+        handoffs[t].ok          = true;
+    }
+
+    // test 1: release on other threads
+    for (t = 0; t < D_TESTS_MEMORY_POOL_THREADS; t++)
+    {
+        started[t] = (d_thread_create(&threads[t],
+                                      d_tests_dmemory_pool_release_worker,
+                                      &handoffs[t]) == D_MUTEX_SUCCESS);
+
+        if (!started[t])
+        {
+            // run the handoff here so every object is still released
+            d_tests_dmemory_pool_release_worker(&handoffs[t]);
+        }
+    }
+
+    for (t = 0; t < D_TESTS_MEMORY_POOL_THREADS; t++)
+    {
+        if (started[t])
+        {
+            d_thread_join(threads[t], NULL);
+        }
+
+        test_contents = test_contents && handoffs[t].ok;
+    }
+
+    // test 2: counts after every thread has exited
+    test_counts = d_pool_get_stats(pool, &stats) &&
+                  (stats.live == 0) &&
+                  (stats.cached == stats.total) &&
+                  (stats.high_water >= D_TESTS_MEMORY_POOL_OBJECTS);
+
+    // test 3: exited threads' objects are reused
+    total = stats.total;
+
+    for (i = 0; i < D_TESTS_MEMORY_POOL_OBJECTS; i++)
+    {
+        reused[i] = d_pool_alloc(pool);
+    }
+
+    test_reuse = d_pool_get_stats(pool, &stats) &&
+                 (stats.total == total) &&
+                 (stats.live == D_TESTS_MEMORY_POOL_OBJECTS);
+
+    for (i = 0; i < D_TESTS_MEMORY_POOL_OBJECTS; i++)
+    {
+        d_pool_release(pool, reused[i]);
+    }
+
+    d_pool_free(pool);
+
+    // build result tree
+    group = d_test_object_new_interior("d_pool threads", 3);
+
+    if (!group)
+    {
+        return NULL;
+    }
+
+    idx = 0;
+    group->elements[idx++] = D_ASSERT_TRUE("contents",
+                                           test_contents,
+                                           "objects keep their contents across threads");
+    group->elements[idx++] = D_ASSERT_TRUE("counts",
+                                           test_counts,
+                                           "accounts for every object");
+    group->elements[idx++] = D_ASSERT_TRUE("reuse",
+                                           test_reuse,
+                                           "reuses objects released by exited threads");
+
+    return group;
+}
+
+
+/*
+d_tests_dmemory_pool_all
+  Runs all object pool tests.
+  Tests the following:
+  - d_pool_alloc
+  - d_pool_get_stats
+  - cross-thread release
+*/
+struct d_test_object*
+d_tests_dmemory_pool_all
+(
+    void
+)
+{
+    struct d_test_object* group;
+    size_t                idx;
+
+    group = d_test_object_new_interior("Object Pool", 3);
+
+    if (!group)
+    {
+        return NULL;
+    }
+
+    idx = 0;
+    group->elements[idx++] = d_tests_dmemory_pool_alloc();
+    group->elements[idx++] = d_tests_dmemory_pool_stats();
+    group->elements[idx++] = d_tests_dmemory_pool_threads();
+
+    return group;
+}
@@ -166,6 +166,11 @@ d_tests_dmemory_run_all
   - Memory copy operations
   - Memory duplication
   - Memory set operations
+  - Arena allocator
+  - Object pool
+  - Pluggable allocators
+  - Allocation accounting
+  - Aligned and large buffers
   - NULL parameter handling
   - Boundary conditions
   - Alignment tests
@@ -192,7 +197,7 @@ d_tests_dmemory_run_all
     }
 
     // create master group
-    group = d_test_object_new_interior("dmemory Module Tests", 8);
+    group = d_test_object_new_interior("dmemory Module Tests", 13);
 
     if (!group)
     {
@@ -205,6 +210,11 @@ d_tests_dmemory_run_all
     group->elements[idx++] = d_tests_dmemory_copy_all();
     group->elements[idx++] = d_tests_dmemory_duplication_all();
     group->elements[idx++] = d_tests_dmemory_set_all();
+    group->elements[idx++] = d_tests_dmemory_arena_all();
+    group->elements[idx++] = d_tests_dmemory_pool_all();
+    group->elements[idx++] = d_tests_dmemory_allocator_all();
+    group->elements[idx++] = d_tests_dmemory_stats_all();
+    group->elements[idx++] = d_tests_dmemory_large_all();
     group->elements[idx++] = d_tests_dmemory_null_params_all();
     group->elements[idx++] = d_tests_dmemory_boundary_conditions_all();
     group->elements[idx++] = d_tests_dmemory_alignment_all();
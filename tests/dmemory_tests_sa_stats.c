@@ -0,0 +1,474 @@
+#include ".\dmemory_tests_sa.h"
+#include "..\inc\dmutex.h"
+
+
+/******************************************************************************
+ * ACCOUNTING TESTS - helpers
+ *****************************************************************************/
+
+/*
+d_tests_dmemory_stats_sorted
+  Returns true if a snapshot's sites are in non-increasing order of the
+counts `_order` ranks on first.
+*/
+static bool
+d_tests_dmemory_stats_sorted
+(
+    const struct d_memory_stats* _stats,
+    enum d_memory_stats_order    _order
+)
+{
+    size_t i;
+    size_t a;
+    size_t b;
+
+    for (i = 1; i < _stats->site_count; i++)
+    {
+        switch (_order)
+        {
+            case D_MEMORY_STATS_BY_BYTES:
+                a = _stats->sites[i - 1].bytes;
+                b = _stats->sites[i].bytes;
+                break;
+
+            case D_MEMORY_STATS_BY_ALLOCATIONS:
+                a = _stats->sites[i - 1].allocations;
+                b = _stats->sites[i].allocations;
+                break;
+
+            case D_MEMORY_STATS_BY_LIVE:
+            default:
+                a = _stats->sites[i - 1].live;
+                b = _stats->sites[i].live;
+                break;
+        }
+
+        if (a < b)
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+#if D_MEMORY_STATS
+
+/*
+d_tests_dmemory_stats_site
+  Copies the counts of the call site at this file's `_line` out of a
+snapshot into `_entry`, or zeroes it if the site has not allocated.
+*/
+static void
+d_tests_dmemory_stats_site
+(
+    const struct d_memory_stats* _stats,
+    int                          _line,
+    struct d_memory_stats_entry* _entry
+)
+{
+    size_t i;
+
+    memset(_entry, 0, sizeof(struct d_memory_stats_entry));
+
+    if (!_stats)
+    {
+        return;
+    }
+
+    for (i = 0; i < _stats->site_count; i++)
+    {
+        if ( (_stats->sites[i].line == _line) &&
+             (strcmp(_stats->sites[i].file, __FILE__) == 0) )
+        {
+            *_entry = _stats->sites[i];
+
+            return;
+        }
+    }
+
+    return;
+}
+
+/*
+d_tests_dmemory_stats_free_worker
+  Thread body of the cross-thread test: frees the block it is handed.
+*/
+static d_thread_result_t
+d_tests_dmemory_stats_free_worker
+(
+    void* _arg
+)
+{
+    D_MEMORY_FREE(_arg);
+
+    return (d_thread_result_t)0;
+}
+
+#endif  // D_MEMORY_STATS
+
+
+/******************************************************************************
+ * ACCOUNTING TESTS - d_memory_stats_*
+ *****************************************************************************/
+
+/*
+d_tests_dmemory_stats_snapshot
+  Tests d_memory_stats_snapshot, d_memory_stats_sort, d_memory_stats_report
+and the D_MEMORY_* allocation macros, with or without D_MEMORY_STATS.
+  Tests the following:
+  - a snapshot is taken, and says whether accounting is on
+  - D_MEMORY_ALLOC, D_MEMORY_REALLOC and D_MEMORY_FREE behave as malloc,
+    realloc and free
+  - every order sorts the sites largest first
+  - the report is written, and NULL arguments are rejected
+*/
+struct d_test_object*
+d_tests_dmemory_stats_snapshot
+(
+    void
+)
+{
+    struct d_test_object*  group;
+    struct d_memory_stats* stats;
+    unsigned char*         block;
+    unsigned char*         moved;
+    FILE*                  stream;
+    size_t                 i;
+    size_t                 idx;
+    bool                   test_snapshot;
+    bool                   test_macros;
+    bool                   test_sort;
+    bool                   test_report;
+
+    // test 1: the snapshot
+    stats         = d_memory_stats_snapshot();
+    test_snapshot = (stats != NULL) &&
+                    (stats->enabled == (D_MEMORY_STATS != 0)) &&
+                    ( (stats->site_count == 0) ||
+                      (stats->sites != NULL) );
+
+    for (i = 0; stats && (i < D_MEMORY_MODULE_COUNT); i++)
+    {
+        test_snapshot = test_snapshot &&
+                        (stats->modules[i].module == (enum d_memory_module)i);
+    }
+
+    d_memory_stats_free_snapshot(stats);
+    d_memory_stats_free_snapshot(NULL);
+
+    // test 2: the allocation macros
+    block = (unsigned char*)D_MEMORY_ALLOC(D_MEMORY_MODULE_MEMORY,
+                                          D_TESTS_MEMORY_SMALL_SIZE);
+
+    if (block)
+    {
+        memset(block, 0x3C, D_TESTS_MEMORY_SMALL_SIZE);
+    }
+
+    moved       = (unsigned char*)D_MEMORY_REALLOC(D_MEMORY_MODULE_MEMORY,
+                                                   block,
+                                                   D_TESTS_MEMORY_LARGE_SIZE);
+    test_macros = (block != NULL) &&
+                  (moved != NULL) &&
+                  (moved[0] == 0x3C) &&
+                  (moved[D_TESTS_MEMORY_SMALL_SIZE - 1] == 0x3C);
+    D_MEMORY_FREE((moved != NULL) ? moved : block);
+
+    block       = (unsigned char*)D_MEMORY_CALLOC(D_MEMORY_MODULE_MEMORY,
+                                                  4,
+                                                  D_TESTS_MEMORY_SMALL_SIZE);
+    test_macros = test_macros &&
+                  (block != NULL) &&
+                  (block[0] == 0) &&
+                  (block[(4 * D_TESTS_MEMORY_SMALL_SIZE) - 1] == 0);
+    D_MEMORY_FREE(block);
+    D_MEMORY_FREE(NULL);
+
+    // test 3: sorting
+    stats     = d_memory_stats_snapshot();
+    test_sort = (stats != NULL) &&
+                d_tests_dmemory_stats_sorted(stats, D_MEMORY_STATS_BY_LIVE);
+
+    d_memory_stats_sort(stats, D_MEMORY_STATS_BY_BYTES);
+    test_sort = test_sort &&
+                d_tests_dmemory_stats_sorted(stats, D_MEMORY_STATS_BY_BYTES);
+    d_memory_stats_sort(stats, D_MEMORY_STATS_BY_ALLOCATIONS);
+    test_sort = test_sort &&
+                d_tests_dmemory_stats_sorted(stats, D_MEMORY_STATS_BY_ALLOCATIONS);
+    d_memory_stats_sort(NULL, D_MEMORY_STATS_BY_LIVE);
+
+    // test 4: the report
+    stream      = tmpfile();
+    test_report = (stream != NULL) &&
+                  (d_memory_stats_report(stats, stream, 5) == 0) &&
+                  (ftell(stream) > 0) &&
+                  (d_memory_stats_report(NULL, stream, 0) == -1) &&
+                  (d_memory_stats_report(stats, NULL, 0) == -1);
+
+    if (stream)
+    {
+        fclose(stream);
+    }
+
+    d_memory_stats_free_snapshot(stats);
+
+    group = d_test_object_new_interior("d_memory_stats", 4);
+
+    if (!group)
+    {
+        return NULL;
+    }
+
+    idx = 0;
+    group->elements[idx++] = D_ASSERT_TRUE("snapshot",
+                                           test_snapshot,
+                                           "takes a snapshot");
+    group->elements[idx++] = D_ASSERT_TRUE("macros",
+                                           test_macros,
+                                           "allocation macros behave as malloc");
+    group->elements[idx++] = D_ASSERT_TRUE("sort",
+                                           test_sort,
+                                           "sorts sites largest first");
+    group->elements[idx++] = D_ASSERT_TRUE("report",
+                                           test_report,
+                                           "writes a report");
+
+    return group;
+}
+
+/*
+d_tests_dmemory_stats_sites
+  Tests the counts D_MEMORY_STATS keeps per call site and module. Without
+D_MEMORY_STATS, tests that nothing is counted.
+  Tests the following:
+  - allocations and frees are counted at the allocating site
+  - a reallocation moves the block's bytes to the reallocating site
+  - handed-off memory counts as allocated but not live
+  - a block freed by another thread is counted as freed
+  - peaks are sampled once a thread's live bytes grow far enough
+  - module and library totals add up, and library sites are counted
+*/
+struct d_test_object*
+d_tests_dmemory_stats_sites
+(
+    void
+)
+{
+    struct d_test_object*       group;
+    struct d_memory_stats*      stats;
+#if D_MEMORY_STATS
+    struct d_memory_stats*      before;
+    struct d_memory_stats_entry site;
+    struct d_memory_stats_entry old_site;
+    struct d_memory_stats_entry sum;
+    struct d_arena*             arena;
+    void*                       blocks[4];
+    void*                       block;
+    d_thread_t                  thread;
+    int                         line;
+    int                         realloc_line;
+    size_t                      i;
+    size_t                      idx;
+    bool                        test_alloc;
+    bool                        test_realloc;
+    bool                        test_handoff;
+    bool                        test_thread;
+    bool                        test_peak;
+    bool                        test_totals;
+
+    // test 1: allocations and frees
+    line  = __LINE__; block = D_MEMORY_ALLOC(D_MEMORY_MODULE_MEMORY, 100);
+    stats = d_memory_stats_snapshot();
+    d_tests_dmemory_stats_site(stats, line, &site);
+    test_alloc = (block != NULL) &&
+                 (site.allocations == 1) &&
+                 (site.frees == 0) &&
+                 (site.bytes == 100) &&
+                 (site.live == 100) &&
+                 (site.module == D_MEMORY_MODULE_MEMORY);
+    d_memory_stats_free_snapshot(stats);
+
+    // test 2: a reallocation moves the bytes to the new site
+    realloc_line = __LINE__; block = D_MEMORY_REALLOC(D_MEMORY_MODULE_STRING, block, 300);
+    stats        = d_memory_stats_snapshot();
+    d_tests_dmemory_stats_site(stats, line, &old_site);
+    d_tests_dmemory_stats_site(stats, realloc_line, &site);
+    test_realloc = (block != NULL) &&
+                   (old_site.frees == 1) &&
+                   (old_site.live == 0) &&
+                   (site.allocations == 1) &&
+                   (site.live == 300) &&
+                   (site.module == D_MEMORY_MODULE_STRING);
+    d_memory_stats_free_snapshot(stats);
+
+    D_MEMORY_FREE(block);
+    stats = d_memory_stats_snapshot();
+    d_tests_dmemory_stats_site(stats, realloc_line, &site);
+    test_alloc = test_alloc &&
+                 (site.frees == 1) &&
+                 (site.live == 0);
+    d_memory_stats_free_snapshot(stats);
+
+    // test 3: handed-off memory
+    line  = __LINE__; D_MEMORY_HANDOFF(D_MEMORY_MODULE_MEMORY, 50);
+    stats = d_memory_stats_snapshot();
+    d_tests_dmemory_stats_site(stats, line, &site);
+    test_handoff = (site.allocations == 1) &&
+                   (site.bytes == 50) &&
+                   (site.live == 0);
+    d_memory_stats_free_snapshot(stats);
+
+    // test 4: a block freed by another thread
+    line  = __LINE__; block = D_MEMORY_ALLOC(D_MEMORY_MODULE_MEMORY, 64);
+    test_thread = (block != NULL);
+
+    if (d_thread_create(&thread,
+                        d_tests_dmemory_stats_free_worker,
+                        block) == D_MUTEX_SUCCESS)
+    {
+        d_thread_join(thread, NULL);
+    }
+    else
+    {
+        d_tests_dmemory_stats_free_worker(block);
+    }
+
+    stats = d_memory_stats_snapshot();
+    d_tests_dmemory_stats_site(stats, line, &site);
+    test_thread = test_thread &&
+                  (site.allocations == 1) &&
+                  (site.frees == 1) &&
+                  (site.live == 0);
+    d_memory_stats_free_snapshot(stats);
+
+    // test 5: each block is big enough to be published at once
+    for (i = 0; i < 4; i++)
+    {
+        line = __LINE__; blocks[i] = D_MEMORY_ALLOC(D_MEMORY_MODULE_MEMORY, 2 * D_MEMORY_STATS_SYNC_BYTES);
+    }
+
+    for (i = 0; i < 4; i++)
+    {
+        D_MEMORY_FREE(blocks[i]);
+    }
+
+    stats = d_memory_stats_snapshot();
+    d_tests_dmemory_stats_site(stats, line, &site);
+    test_peak = (blocks[0] != NULL) &&
+                (blocks[3] != NULL) &&
+                (site.live == 0) &&
+                (site.peak >= 8 * D_MEMORY_STATS_SYNC_BYTES) &&
+                (stats->modules[D_MEMORY_MODULE_MEMORY].peak >= site.peak) &&
+                (stats->total.peak >= site.peak);
+    d_memory_stats_free_snapshot(stats);
+
+    // test 6: totals add up, and library sites are counted
+    before = d_memory_stats_snapshot();
+    arena  = d_arena_new(0);
+    stats  = d_memory_stats_snapshot();
+    memset(&sum, 0, sizeof(sum));
+
+    for (i = 0; stats && (i < D_MEMORY_MODULE_COUNT); i++)
+    {
+        sum.allocations += stats->modules[i].allocations;
+        sum.bytes       += stats->modules[i].bytes;
+        sum.live        += stats->modules[i].live;
+    }
+
+    test_totals = (before != NULL) &&
+                  (stats != NULL) &&
+                  (arena != NULL) &&
+                  (sum.allocations == stats->total.allocations) &&
+                  (sum.bytes == stats->total.bytes) &&
+                  (sum.live == stats->total.live) &&
+                  (stats->modules[D_MEMORY_MODULE_MEMORY].live >=
+                       before->modules[D_MEMORY_MODULE_MEMORY].live +
+                       D_ARENA_DEFAULT_BLOCK_SIZE);
+
+    d_arena_free(arena);
+    d_memory_stats_free_snapshot(before);
+    d_memory_stats_free_snapshot(stats);
+
+    group = d_test_object_new_interior("D_MEMORY_STATS sites", 6);
+
+    if (!group)
+    {
+        return NULL;
+    }
+
+    idx = 0;
+    group->elements[idx++] = D_ASSERT_TRUE("alloc",
+                                           test_alloc,
+                                           "counts allocations and frees");
+    group->elements[idx++] = D_ASSERT_TRUE("realloc",
+                                           test_realloc,
+                                           "moves reallocated bytes to the new site");
+    group->elements[idx++] = D_ASSERT_TRUE("handoff",
+                                           test_handoff,
+                                           "counts handed-off memory as not live");
+    group->elements[idx++] = D_ASSERT_TRUE("thread",
+                                           test_thread,
+                                           "counts frees made by other threads");
+    group->elements[idx++] = D_ASSERT_TRUE("peak",
+                                           test_peak,
+                                           "samples peaks");
+    group->elements[idx++] = D_ASSERT_TRUE("totals",
+                                           test_totals,
+                                           "module and library totals add up");
+#else
+    bool test_disabled;
+
+    // test 1: nothing is counted
+    stats         = d_memory_stats_snapshot();
+    test_disabled = (stats != NULL) &&
+                    (!stats->enabled) &&
+                    (stats->site_count == 0) &&
+                    (stats->total.allocations == 0);
+    d_memory_stats_free_snapshot(stats);
+
+    group = d_test_object_new_interior("D_MEMORY_STATS sites", 1);
+
+    if (!group)
+    {
+        return NULL;
+    }
+
+    group->elements[0] = D_ASSERT_TRUE("disabled",
+                                       test_disabled,
+                                       "counts nothing without D_MEMORY_STATS");
+#endif  // D_MEMORY_STATS
+
+    return group;
+}
+
+
+/*
+d_tests_dmemory_stats_all
+  Runs all allocation accounting tests.
+  Tests the following:
+  - d_memory_stats_snapshot, d_memory_stats_sort, d_memory_stats_report
+  - per-site and per-module counts
+*/
+struct d_test_object*
+d_tests_dmemory_stats_all
+(
+    void
+)
+{
+    struct d_test_object* group;
+    size_t                idx;
+
+    group = d_test_object_new_interior("Allocation Accounting", 2);
+
+    if (!group)
+    {
+        return NULL;
+    }
+
+    idx = 0;
+    group->elements[idx++] = d_tests_dmemory_stats_snapshot();
+    group->elements[idx++] = d_tests_dmemory_stats_sites();
+
+    return group;
+}
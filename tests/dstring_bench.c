@@ -0,0 +1,682 @@
+/******************************************************************************
+* djinterp [test]                                               dstring_bench.c
+*
+*   Benchmarks for the dstring short-string storage and substring search.
+* Not part of the test suite: it is built by the `dstring-bench` target,
+* which is excluded from the default build, and prints tables instead of
+* asserting anything.
+*
+*   usage: dstring-bench [sso|search|all] [operations]
+*
+*   sso: creates, appends to and frees `operations` strings (1000000 by
+* default) per timed run, for text that stays within D_STRING_SSO_CAPACITY
+* and for text that does not. Each row is the best of D_BENCH_TRIALS runs,
+* in ns per string, with the library allocations made per string. Counting
+* allocations needs a build with D_MEMORY_STATS; without it that column
+* reads "n/a".
+*   search: finds a needle placed at the very end of a 4 MiB haystack, with
+* d_string_find and with strstr, for an 8-byte and a 256-byte needle cut
+* from the haystack's own text (with one middle byte changed, so near-misses
+* are frequent) and for a pathological "aa...ab" needle in "aa...a". Each
+* cell is the best of D_BENCH_TRIALS runs, in GB/s of haystack scanned; the
+* last column is d_string_find's speed relative to strstr.
+*
+*
+* path:      \tests\dstring_bench.c
+* link:      TBA
+* author(s): Samuel 'teer' Neal-Blim                          date: 2026.10.16
+******************************************************************************/
+
+#include "..\inc\dmemory.h"
+#include "..\inc\dstring.h"
+#include "..\inc\dtime.h"
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+
+/******************************************************************************
+ * BENCHMARK CONFIGURATION
+ *****************************************************************************/
+
+// D_BENCH_TRIALS
+//   constant: number of timed runs per row; the fastest one is reported.
+#define D_BENCH_TRIALS          5
+
+// D_BENCH_DEFAULT_OPERATIONS
+//   constant: strings created per timed run unless a count is given on the
+// command line.
+#define D_BENCH_DEFAULT_OPERATIONS ((size_t)1000000)
+
+// D_BENCH_SSO_ROWS
+//   constant: number of rows in the sso table.
+#define D_BENCH_SSO_ROWS        4
+
+// D_BENCH_SEARCH_BYTES
+//   constant: size of the search haystack.
+#define D_BENCH_SEARCH_BYTES    ((size_t)4 * 1024 * 1024)
+
+// D_BENCH_SEARCH_REPEATS
+//   constant: searches per timed run.
+#define D_BENCH_SEARCH_REPEATS  16
+
+// D_BENCH_SEARCH_ROWS
+//   constant: number of rows in the search table.
+#define D_BENCH_SEARCH_ROWS     3
+
+
+// d_bench_sso_fn
+//   function pointer: creates, appends to and frees one string, and returns
+// its final length (or 0 on failure).
+typedef size_t (*d_bench_sso_fn)(void);
+
+// d_bench_sso_row
+//   struct: one row of the sso table.
+struct d_bench_sso_row
+{
+    const char*    name;
+    d_bench_sso_fn run;
+};
+
+// d_bench_search_row
+//   struct: one row of the search table. The haystack is text when `text`
+// is true and all 'a' otherwise; the needle is `length` bytes.
+struct d_bench_search_row
+{
+    const char* name;
+    size_t      length;
+    bool        text;
+};
+
+// d_bench_sink
+//   global: accumulates each run's results so the work cannot be discarded.
+static volatile size_t d_bench_sink;
+
+
+/******************************************************************************
+ * SSO KERNELS
+ *****************************************************************************/
+
+// short text: every string stays within the inline buffer
+static size_t
+d_bench_sso_short_new
+(
+    void
+)
+{
+    struct d_string* str;
+    size_t           length;
+
+    str = d_string_new_from_cstr("user_0042");
+
+    if (!str)
+    {
+        return 0;
+    }
+
+    length = d_string_length(str);
+    d_string_free(str);
+
+    return length;
+}
+
+static size_t
+d_bench_sso_short_append
+(
+    void
+)
+{
+    struct d_string* str;
+    size_t           length;
+
+    str = d_string_new();
+
+    if (!str)
+    {
+        return 0;
+    }
+
+    d_string_append_cstr(str, "key");
+    d_string_append_char(str, '=');
+    d_string_append_cstr(str, "value_0042");
+
+    length = d_string_length(str);
+    d_string_free(str);
+
+    return length;
+}
+
+// long text: every string needs a separate buffer
+static size_t
+d_bench_sso_long_new
+(
+    void
+)
+{
+    struct d_string* str;
+    size_t           length;
+
+    str = d_string_new_from_cstr("/usr/local/share/djinterp/config.d/00-base");
+
+    if (!str)
+    {
+        return 0;
+    }
+
+    length = d_string_length(str);
+    d_string_free(str);
+
+    return length;
+}
+
+static size_t
+d_bench_sso_long_append
+(
+    void
+)
+{
+    struct d_string* str;
+    size_t           length;
+
+    str = d_string_new();
+
+    if (!str)
+    {
+        return 0;
+    }
+
+    d_string_append_cstr(str, "/usr/local/share/djinterp");
+    d_string_append_char(str, '/');
+    d_string_append_cstr(str, "config.d/00-base.conf");
+
+    length = d_string_length(str);
+    d_string_free(str);
+
+    return length;
+}
+
+static const struct d_bench_sso_row d_bench_sso_rows[D_BENCH_SSO_ROWS] =
+{
+    { "short new",    d_bench_sso_short_new    },
+    { "short append", d_bench_sso_short_append },
+    { "long new",     d_bench_sso_long_new     },
+    { "long append",  d_bench_sso_long_append  }
+};
+
+static const struct d_bench_search_row d_bench_search_rows[D_BENCH_SEARCH_ROWS] =
+{
+    { "short (8)",    8,   true  },
+    { "long (256)",   256, true  },
+    { "pathological", 256, false }
+};
+
+
+/******************************************************************************
+ * HELPERS
+ *****************************************************************************/
+
+/*
+d_bench_allocations
+  Returns the number of allocations the library has made so far, or
+SIZE_MAX if it was built without D_MEMORY_STATS.
+*/
+static size_t
+d_bench_allocations
+(
+    void
+)
+{
+    struct d_memory_stats* stats;
+    size_t                 allocations;
+
+    stats = d_memory_stats_snapshot();
+
+    if (!stats)
+    {
+        return SIZE_MAX;
+    }
+
+    allocations = (stats->enabled) ? stats->total.allocations : SIZE_MAX;
+    d_memory_stats_free_snapshot(stats);
+
+    return allocations;
+}
+
+/*
+d_bench_fill_text
+  Fills `_buffer[0.._size)` with words of lowercase letters separated by
+spaces, from a fixed-seed generator so every run sees the same text.
+*/
+static void
+d_bench_fill_text
+(
+    char*  _buffer,
+    size_t _size
+)
+{
+    static const char* words[8] =
+    {
+        "the ", "string ", "of ", "search ", "and ", "needle ", "a ", "in "
+    };
+    uint32_t state;
+    size_t   i;
+    size_t   length;
+
+    state = 0x9E3779B9u;
+    i     = 0;
+
+    while (i < _size)
+    {
+        state  = (state * 1664525u) + 1013904223u;
+        length = strlen(words[state >> 29]);
+
+        if (length > (_size - i))
+        {
+            length = _size - i;
+        }
+
+        memcpy(_buffer + i, words[state >> 29], length);
+        i += length;
+    }
+
+    return;
+}
+
+/*
+d_bench_search_time
+  Returns the best time, in ns, of D_BENCH_SEARCH_REPEATS searches for the
+needle at the end of the haystack, with d_string_find if `_haystack` is
+non-NULL and with strstr on `_text` otherwise. Returns -1 if a search
+misses the needle.
+*/
+static int64_t
+d_bench_search_time
+(
+    const struct d_string* _haystack,
+    const struct d_string* _needle,
+    const char*            _text,
+    const char*            _cneedle,
+    size_t                 _expected
+)
+{
+    size_t  trial;
+    size_t  i;
+    size_t  found;
+    int64_t start;
+    int64_t elapsed;
+    int64_t best;
+
+    best = INT64_MAX;
+
+    for (trial = 0; trial < D_BENCH_TRIALS; trial++)
+    {
+        start = d_monotonic_time_ns();
+
+        for (i = 0; i < D_BENCH_SEARCH_REPEATS; i++)
+        {
+            if (_haystack)
+            {
+                found = (size_t)d_string_find(_haystack, _needle);
+            }
+            else
+            {
+                found = (size_t)(strstr(_text, _cneedle) - _text);
+            }
+
+            if (found != _expected)
+            {
+                return -1;
+            }
+
+            d_bench_sink += found;
+        }
+
+        elapsed = d_monotonic_time_ns() - start;
+
+        if (elapsed < best)
+        {
+            best = elapsed;
+        }
+    }
+
+    return best;
+}
+
+
+/******************************************************************************
+ * SSO BENCHMARK
+ *****************************************************************************/
+
+/*
+d_bench_sso_measure
+  Runs `_row` `_operations` times per trial and stores the best time per
+string, in ns, in `_ns` and the allocations per string in `_allocations`
+(negative if they are not counted). Returns the final length of the last
+string, or 0 if any string could not be built.
+*/
+static size_t
+d_bench_sso_measure
+(
+    const struct d_bench_sso_row* _row,
+    size_t                        _operations,
+    double*                       _ns,
+    double*                       _allocations
+)
+{
+    size_t  trial;
+    size_t  i;
+    size_t  length;
+    size_t  before;
+    size_t  after;
+    int64_t start;
+    int64_t elapsed;
+    int64_t best;
+
+    best   = INT64_MAX;
+    length = 0;
+
+    // warm-up run, also the one whose allocations are counted
+    before = d_bench_allocations();
+
+    for (i = 0; i < _operations; i++)
+    {
+        length = _row->run();
+
+        if (length == 0)
+        {
+            return 0;
+        }
+    }
+
+    after = d_bench_allocations();
+
+    *_allocations = ( (before == SIZE_MAX) ||
+                      (after == SIZE_MAX) )
+        ? -1.0
+        : ((double)(after - before) / (double)_operations);
+
+    for (trial = 0; trial < D_BENCH_TRIALS; trial++)
+    {
+        start = d_monotonic_time_ns();
+
+        for (i = 0; i < _operations; i++)
+        {
+            d_bench_sink += _row->run();
+        }
+
+        elapsed = d_monotonic_time_ns() - start;
+
+        if (elapsed < best)
+        {
+            best = elapsed;
+        }
+    }
+
+    *_ns = (double)best / (double)_operations;
+
+    return length;
+}
+
+/*
+d_bench_sso
+  Prints the sso table for `_operations` strings per timed run.
+*/
+static int
+d_bench_sso
+(
+    size_t _operations
+)
+{
+    double ns;
+    double allocations;
+    size_t row;
+    size_t length;
+
+    printf("create/append/free, best of %d runs of %zu strings "
+           "(D_STRING_SSO_CAPACITY %d)\n",
+           D_BENCH_TRIALS,
+           _operations,
+           (int)D_STRING_SSO_CAPACITY);
+    printf("%14s %8s %10s %10s\n", "string", "length", "ns/op", "allocs/op");
+
+    for (row = 0; row < D_BENCH_SSO_ROWS; row++)
+    {
+        length = d_bench_sso_measure(&d_bench_sso_rows[row],
+                                     _operations,
+                                     &ns,
+                                     &allocations);
+
+        if (length == 0)
+        {
+            fprintf(stderr, "dstring-bench: cannot allocate a string\n");
+
+            return 1;
+        }
+
+        if (allocations < 0.0)
+        {
+            printf("%14s %8zu %10.1f %10s\n",
+                   d_bench_sso_rows[row].name,
+                   length,
+                   ns,
+                   "n/a");
+        }
+        else
+        {
+            printf("%14s %8zu %10.1f %10.2f\n",
+                   d_bench_sso_rows[row].name,
+                   length,
+                   ns,
+                   allocations);
+        }
+    }
+
+    printf("\n");
+
+    return 0;
+}
+
+
+/******************************************************************************
+ * SEARCH BENCHMARK
+ *****************************************************************************/
+
+/*
+d_bench_search_row
+  Builds the haystack and needle for `_row` in `_text` and `_cneedle`, and
+prints the row. Returns 0 on success and 1 if a string could not be
+allocated or a search returned the wrong position.
+*/
+static int
+d_bench_search_row
+(
+    const struct d_bench_search_row* _row,
+    char*                            _text,
+    char*                            _cneedle
+)
+{
+    struct d_string* haystack;
+    struct d_string* needle;
+    size_t           expected;
+    int64_t          ours;
+    int64_t          libc;
+    double           bytes;
+
+    expected = D_BENCH_SEARCH_BYTES - _row->length;
+
+    if (_row->text)
+    {
+        d_bench_fill_text(_text, D_BENCH_SEARCH_BYTES);
+
+        // a near-miss taken from the middle of the text: one byte is
+        // swapped for another common one, so the needle splits a word or
+        // joins two and occurs nowhere else
+        memcpy(_cneedle, _text + (D_BENCH_SEARCH_BYTES / 2), _row->length);
+        _cneedle[_row->length / 2] =
+            (_cneedle[_row->length / 2] == ' ') ? 'e' : ' ';
+    }
+    else
+    {
+        memset(_text, 'a', D_BENCH_SEARCH_BYTES);
+        memset(_cneedle, 'a', _row->length - 1);
+        _cneedle[_row->length - 1] = 'b';
+    }
+
+    _cneedle[_row->length] = '\0';
+    memcpy(_text + expected, _cneedle, _row->length);
+    _text[D_BENCH_SEARCH_BYTES] = '\0';
+
+    haystack = d_string_new_from_buffer(_text, D_BENCH_SEARCH_BYTES);
+    needle   = d_string_new_from_buffer(_cneedle, _row->length);
+
+    if ( (!haystack) ||
+         (!needle) )
+    {
+        d_string_free(haystack);
+        d_string_free(needle);
+        fprintf(stderr, "dstring-bench: cannot allocate a string\n");
+
+        return 1;
+    }
+
+    ours = d_bench_search_time(haystack, needle, NULL, NULL, expected);
+    libc = d_bench_search_time(NULL, NULL, _text, _cneedle, expected);
+
+    d_string_free(haystack);
+    d_string_free(needle);
+
+    if ( (ours <= 0) ||
+         (libc <= 0) )
+    {
+        fprintf(stderr, "dstring-bench: %s search failed\n", _row->name);
+
+        return 1;
+    }
+
+    bytes = (double)D_BENCH_SEARCH_BYTES * D_BENCH_SEARCH_REPEATS;
+    printf("%14s %12.2f %14.2f %9.2fx\n",
+           _row->name,
+           bytes / (double)libc,
+           bytes / (double)ours,
+           (double)libc / (double)ours);
+
+    return 0;
+}
+
+/*
+d_bench_search
+  Prints the search table.
+*/
+static int
+d_bench_search
+(
+    void
+)
+{
+    char*  text;
+    char   needle[257];
+    size_t row;
+    int    result;
+
+    text = malloc(D_BENCH_SEARCH_BYTES + 1);
+
+    if (!text)
+    {
+        fprintf(stderr,
+                "dstring-bench: cannot allocate %zu bytes\n",
+                D_BENCH_SEARCH_BYTES + 1);
+
+        return 1;
+    }
+
+    printf("find in a 4 MiB haystack, GB/s, best of %d runs of %d searches\n",
+           D_BENCH_TRIALS,
+           D_BENCH_SEARCH_REPEATS);
+    printf("%14s %12s %14s %10s\n",
+           "needle",
+           "strstr",
+           "d_string_find",
+           "speedup");
+
+    result = 0;
+
+    for (row = 0; (row < D_BENCH_SEARCH_ROWS) && (result == 0); row++)
+    {
+        result = d_bench_search_row(&d_bench_search_rows[row], text, needle);
+    }
+
+    printf("\n");
+    free(text);
+
+    return result;
+}
+
+
+/******************************************************************************
+ * MAIN ENTRY POINT
+ *****************************************************************************/
+
+/*
+main
+  Runs the benchmark named by the first argument, or all of them.
+
+Parameter(s):
+  _argc: argument count.
+  _argv: argument vector: an optional benchmark name and an optional number
+         of strings per timed run for `sso`.
+Return:
+  0 on success, 1 if a string could not be allocated or the arguments were
+not understood.
+*/
+int
+main
+(
+    int    _argc,
+    char** _argv
+)
+{
+    const char* mode;
+    size_t      operations;
+    int         result;
+    bool        all;
+
+    mode       = (_argc > 1) ? _argv[1] : "all";
+    operations = (_argc > 2)
+        ? (size_t)strtoull(_argv[2], NULL, 0)
+        : D_BENCH_DEFAULT_OPERATIONS;
+
+    if (operations == 0)
+    {
+        fprintf(stderr, "dstring-bench: operations must be at least 1\n");
+
+        return 1;
+    }
+
+    all    = (strcmp(mode, "all") == 0);
+    result = -1;
+
+    if ( (all) ||
+         (strcmp(mode, "sso") == 0) )
+    {
+        result = d_bench_sso(operations);
+    }
+
+    if ( (result <= 0) &&
+         ( (all) ||
+           (strcmp(mode, "search") == 0) ) )
+    {
+        result = d_bench_search();
+    }
+
+    if (result < 0)
+    {
+        fprintf(stderr,
+                "usage: %s [sso|search|all] [operations]\n",
+                _argv[0]);
+
+        return 1;
+    }
+
+    return result;
+}
@@ -27,6 +27,13 @@
    - Utility
    - Formatted Strings
    - Error Functions
+   - String Views
+   - String Builder
+   - String Interning
+   - Multi-Pattern Matching
+   - Numeric Conversion
+   - Sorting and Deduplication
+   - Edit Distance
 
  Parameter(s):
    (none)
@@ -44,7 +51,7 @@ struct d_test_object*
     size_t                child_idx;
 
     // create master group with all implemented test categories
-    group = d_test_object_new_interior("d_string Module Tests", 16);
+    group = d_test_object_new_interior("d_string Module Tests", 23);
     child_idx = 0;
 
     if (!group)
@@ -100,5 +107,26 @@ struct d_test_object*
     // XVI. ERROR STRING TESTS
     group->elements[child_idx++] = d_tests_sa_dstring_error_all();
 
+    // XVII. STRING VIEW TESTS
+    group->elements[child_idx++] = d_tests_sa_dstring_view_all();
+
+    // XVIII. STRING BUILDER TESTS
+    group->elements[child_idx++] = d_tests_sa_dstring_builder_all();
+
+    // XIX. STRING INTERNING TESTS
+    group->elements[child_idx++] = d_tests_sa_dstring_intern_all();
+
+    // XX. MULTI-PATTERN MATCHING TESTS
+    group->elements[child_idx++] = d_tests_sa_dstring_matcher_all();
+
+    // XXI. NUMERIC CONVERSION TESTS
+    group->elements[child_idx++] = d_tests_sa_dstring_numeric_all();
+
+    // XXII. SORTING TESTS
+    group->elements[child_idx++] = d_tests_sa_dstring_sort_all();
+
+    // XXIII. EDIT DISTANCE TESTS
+    group->elements[child_idx++] = d_tests_sa_dstring_distance_all();
+
     return group;
 }
\ No newline at end of file
@@ -31,6 +31,13 @@ XIV.  JOIN TESTS                       (dstring_tests_join.c)
 XV.   UTILITY TESTS                    (dstring_tests_util.c)
 XVI.  ERROR STRING TESTS               (dstring_tests_error.c)
 XVII. FORMATTED STRING TESTS           (dstring_tests_format.c)
+XVIII.STRING VIEW TESTS                (dstring_tests_view.c)
+XIX.  STRING BUILDER TESTS             (dstring_tests_builder.c)
+XX.   STRING INTERNING TESTS           (dstring_tests_intern.c)
+XXI.  MULTI-PATTERN MATCHING TESTS     (dstring_tests_matcher.c)
+XXII. NUMERIC CONVERSION TESTS         (dstring_tests_numeric.c)
+XXIII.SORTING TESTS                    (dstring_tests_sort.c)
+XXIV. EDIT DISTANCE TESTS              (dstring_tests_distance.c)
 */
 
 
@@ -38,6 +45,9 @@ XVII. FORMATTED STRING TESTS           (dstring_tests_format.c)
 #define DJINTERP_DSTRING_TESTS_STANDALONE_ 1
 
 #include <errno.h>
+#include <float.h>
+#include <limits.h>
+#include <math.h>
 #include <stddef.h>
 #include <stdio.h>
 #include <string.h>
@@ -156,6 +166,16 @@ struct d_test_object* d_tests_sa_dstring_free(void);
 // the structure itself.
 struct d_test_object* d_tests_sa_dstring_free_contents(void);
 
+// d_tests_sa_dstring_arena_new
+//   function: tests d_string_arena_new() and the other arena-backed
+// constructors - strings allocated from, and growing within, a d_arena.
+struct d_test_object* d_tests_sa_dstring_arena_new(void);
+
+// d_tests_sa_dstring_new_ex
+//   function: tests d_string_new_ex() and the other allocator-taking
+// constructors, and strings made under a replaced default allocator.
+struct d_test_object* d_tests_sa_dstring_new_ex(void);
+
 // d_tests_sa_dstring_creation_all
 //   function: runs all creation and destruction tests, returns aggregate
 // test object containing all results.
@@ -170,6 +190,9 @@ struct d_test_object* d_tests_sa_dstring_reserve(void);
 struct d_test_object* d_tests_sa_dstring_shrink_to_fit(void);
 struct d_test_object* d_tests_sa_dstring_capacity(void);
 struct d_test_object* d_tests_sa_dstring_resize(void);
+struct d_test_object* d_tests_sa_dstring_inline_storage(void);
+struct d_test_object* d_tests_sa_dstring_growth_policy(void);
+struct d_test_object* d_tests_sa_dstring_alloc_sites(void);
 struct d_test_object* d_tests_sa_dstring_capacity_all(void);
 
 
@@ -219,6 +242,7 @@ struct d_test_object* d_tests_sa_dstring_concat_all(void);
 struct d_test_object* d_tests_sa_dstring_dup(void);
 struct d_test_object* d_tests_sa_dstring_ndup(void);
 struct d_test_object* d_tests_sa_dstring_substr(void);
+struct d_test_object* d_tests_sa_dstring_dup_shared(void);
 struct d_test_object* d_tests_sa_dstring_dup_all(void);
 
 
@@ -258,9 +282,11 @@ struct d_test_object* d_tests_sa_dstring_find_cstr_from(void);
 struct d_test_object* d_tests_sa_dstring_rfind(void);
 struct d_test_object* d_tests_sa_dstring_rfind_cstr(void);
 struct d_test_object* d_tests_sa_dstring_str(void);
+struct d_test_object* d_tests_sa_dstring_find_binary(void);
 struct d_test_object* d_tests_sa_dstring_casefind(void);
 struct d_test_object* d_tests_sa_dstring_casefind_cstr(void);
 struct d_test_object* d_tests_sa_dstring_casestr(void);
+struct d_test_object* d_tests_sa_dstring_casefind_linear(void);
 struct d_test_object* d_tests_sa_dstring_contains(void);
 struct d_test_object* d_tests_sa_dstring_contains_cstr(void);
 struct d_test_object* d_tests_sa_dstring_contains_char(void);
@@ -312,6 +338,7 @@ struct d_test_object* d_tests_sa_dstring_to_lower(void);
 struct d_test_object* d_tests_sa_dstring_to_upper(void);
 struct d_test_object* d_tests_sa_dstring_lower(void);
 struct d_test_object* d_tests_sa_dstring_upper(void);
+struct d_test_object* d_tests_sa_dstring_case_long(void);
 struct d_test_object* d_tests_sa_dstring_case_all(void);
 
 
@@ -321,6 +348,7 @@ struct d_test_object* d_tests_sa_dstring_case_all(void);
 
 struct d_test_object* d_tests_sa_dstring_reverse(void);
 struct d_test_object* d_tests_sa_dstring_reversed(void);
+struct d_test_object* d_tests_sa_dstring_reverse_long(void);
 struct d_test_object* d_tests_sa_dstring_reversal_all(void);
 
 
@@ -335,6 +363,7 @@ struct d_test_object* d_tests_sa_dstring_trim_chars(void);
 struct d_test_object* d_tests_sa_dstring_trimmed(void);
 struct d_test_object* d_tests_sa_dstring_trimmed_left(void);
 struct d_test_object* d_tests_sa_dstring_trimmed_right(void);
+struct d_test_object* d_tests_sa_dstring_normalize(void);
 struct d_test_object* d_tests_sa_dstring_trim_all(void);
 
 
@@ -370,7 +399,10 @@ struct d_test_object* d_tests_sa_dstring_is_alnum(void);
 struct d_test_object* d_tests_sa_dstring_is_whitespace(void);
 struct d_test_object* d_tests_sa_dstring_count_char(void);
 struct d_test_object* d_tests_sa_dstring_count_substr(void);
+struct d_test_object* d_tests_sa_dstring_classify_long(void);
+struct d_test_object* d_tests_sa_dstring_utf8(void);
 struct d_test_object* d_tests_sa_dstring_hash(void);
+struct d_test_object* d_tests_sa_dstring_hash_cached(void);
 struct d_test_object* d_tests_sa_dstring_util_all(void);
 
 
@@ -390,9 +422,84 @@ struct d_test_object* d_tests_sa_dstring_error_all(void);
 struct d_test_object* d_tests_sa_dstring_printf(void);
 struct d_test_object* d_tests_sa_dstring_vprintf(void);
 struct d_test_object* d_tests_sa_dstring_sprintf(void);
+struct d_test_object* d_tests_sa_dstring_format_engine(void);
 struct d_test_object* d_tests_sa_dstring_format_all(void);
 
 
+/******************************************************************************
+* XVIII. STRING VIEW TESTS
+******************************************************************************/
+
+struct d_test_object* d_tests_sa_dstring_view_construction(void);
+struct d_test_object* d_tests_sa_dstring_view_slicing(void);
+struct d_test_object* d_tests_sa_dstring_view_search(void);
+struct d_test_object* d_tests_sa_dstring_view_compare(void);
+struct d_test_object* d_tests_sa_dstring_split_iter(void);
+struct d_test_object* d_tests_sa_dstring_view_all(void);
+
+
+/******************************************************************************
+* XIX. STRING BUILDER TESTS
+******************************************************************************/
+
+struct d_test_object* d_tests_sa_dstring_builder_append(void);
+struct d_test_object* d_tests_sa_dstring_builder_chunks(void);
+struct d_test_object* d_tests_sa_dstring_builder_build_ex(void);
+struct d_test_object* d_tests_sa_dstring_builder_write(void);
+struct d_test_object* d_tests_sa_dstring_builder_null(void);
+struct d_test_object* d_tests_sa_dstring_builder_all(void);
+
+
+/******************************************************************************
+* XX. STRING INTERNING TESTS
+******************************************************************************/
+
+struct d_test_object* d_tests_sa_dstring_intern_basic(void);
+struct d_test_object* d_tests_sa_dstring_intern_bulk(void);
+struct d_test_object* d_tests_sa_dstring_intern_threads(void);
+struct d_test_object* d_tests_sa_dstring_intern_all(void);
+
+
+/******************************************************************************
+* XXI. MULTI-PATTERN MATCHING TESTS
+******************************************************************************/
+
+struct d_test_object* d_tests_sa_dstring_matcher_find(void);
+struct d_test_object* d_tests_sa_dstring_matcher_find_all(void);
+struct d_test_object* d_tests_sa_dstring_replace_all_map(void);
+struct d_test_object* d_tests_sa_dstring_matcher_all(void);
+
+
+/******************************************************************************
+* XXII. NUMERIC CONVERSION TESTS
+******************************************************************************/
+
+struct d_test_object* d_tests_sa_dstring_to_integer(void);
+struct d_test_object* d_tests_sa_dstring_to_double(void);
+struct d_test_object* d_tests_sa_dstring_append_number(void);
+struct d_test_object* d_tests_sa_dstring_numeric_all(void);
+
+
+/******************************************************************************
+* XXIII. SORTING TESTS
+******************************************************************************/
+
+struct d_test_object* d_tests_sa_dstring_sort(void);
+struct d_test_object* d_tests_sa_dstring_sort_parallel(void);
+struct d_test_object* d_tests_sa_dstring_unique(void);
+struct d_test_object* d_tests_sa_dstring_sort_all(void);
+
+
+/******************************************************************************
+* XXIV. EDIT DISTANCE TESTS
+******************************************************************************/
+
+struct d_test_object* d_tests_sa_dstring_distance(void);
+struct d_test_object* d_tests_sa_dstring_distance_bounded(void);
+struct d_test_object* d_tests_sa_dstring_distance_batch(void);
+struct d_test_object* d_tests_sa_dstring_distance_all(void);
+
+
 /******************************************************************************
 * MASTER TEST RUNNER
 ******************************************************************************/
@@ -0,0 +1,516 @@
+#include ".\dstring_tests_sa.h"
+#include "..\inc\dfile.h"
+
+
+/******************************************************************************
+ * SECTION 19: STRING BUILDER FUNCTIONS
+ *****************************************************************************/
+
+/*
+d_tests_sa_dstring_builder_append
+  Tests the d_string_builder append functions and d_string_builder_build.
+  Tests the following:
+  - cstr, char and view appends are concatenated in order
+  - buffer append keeps embedded null bytes
+  - int append handles zero, negatives and INT64_MIN
+  - uint append handles UINT64_MAX
+  - formatted append matches printf output
+  - build sizes the result exactly
+*/
+struct d_test_object*
+d_tests_sa_dstring_builder_append
+(
+    void
+)
+{
+    struct d_test_object*    group;
+    struct d_string_builder* sb;
+    struct d_string*         str;
+    size_t                   idx;
+
+    group = d_test_object_new_interior("d_string_builder append", 6);
+
+    if (!group)
+    {
+        return NULL;
+    }
+
+    idx = 0;
+    sb  = d_string_builder_new(0);
+
+    if (!sb)
+    {
+        while (idx < 6)
+        {
+            group->elements[idx++] = D_ASSERT_TRUE(
+                "builder_alloc", false,
+                "failed to allocate test builder");
+        }
+
+        return group;
+    }
+
+    // test: cstr, char and view appends are concatenated in order
+    d_string_builder_append_cstr(sb, "Hello");
+    d_string_builder_append_char(sb, ',');
+    d_string_builder_append_view(sb, d_string_view_from_cstr(" World"));
+    str = d_string_builder_build(sb);
+
+    group->elements[idx++] = D_ASSERT_TRUE(
+        "append_in_order",
+        str && (str->size == 12) && (strcmp(str->text, "Hello, World") == 0),
+        "appends should produce 'Hello, World'");
+
+    d_string_free(str);
+
+    // test: buffer append keeps embedded null bytes
+    d_string_builder_clear(sb);
+    d_string_builder_append_buffer(sb, "a\0b", 3);
+    str = d_string_builder_build(sb);
+
+    group->elements[idx++] = D_ASSERT_TRUE(
+        "append_buffer_null",
+        str && (str->size == 3) && (memcmp(str->text, "a\0b\0", 4) == 0),
+        "buffer append should keep the embedded null byte");
+
+    d_string_free(str);
+
+    // test: int append handles zero, negatives and INT64_MIN
+    d_string_builder_clear(sb);
+    d_string_builder_append_int(sb, 0);
+    d_string_builder_append_char(sb, ' ');
+    d_string_builder_append_int(sb, -42);
+    d_string_builder_append_char(sb, ' ');
+    d_string_builder_append_int(sb, INT64_MIN);
+    str = d_string_builder_build(sb);
+
+    group->elements[idx++] = D_ASSERT_TRUE(
+        "append_int",
+        str && (strcmp(str->text, "0 -42 -9223372036854775808") == 0),
+        "int append should format 0, -42 and INT64_MIN");
+
+    d_string_free(str);
+
+    // test: uint append handles UINT64_MAX
+    d_string_builder_clear(sb);
+    d_string_builder_append_uint(sb, UINT64_MAX);
+    str = d_string_builder_build(sb);
+
+    group->elements[idx++] = D_ASSERT_TRUE(
+        "append_uint",
+        str && (strcmp(str->text, "18446744073709551615") == 0),
+        "uint append should format UINT64_MAX");
+
+    d_string_free(str);
+
+    // test: formatted append matches printf output
+    d_string_builder_clear(sb);
+    d_string_builder_append_cstr(sb, "[");
+    d_string_builder_append_formatted(sb, "%s=%d;%04x", "key", 7, 0xbeef);
+    d_string_builder_append_cstr(sb, "]");
+    str = d_string_builder_build(sb);
+
+    group->elements[idx++] = D_ASSERT_TRUE(
+        "append_formatted",
+        str && (strcmp(str->text, "[key=7;beef]") == 0),
+        "formatted append should produce '[key=7;beef]'");
+
+    // test: build sizes the result exactly
+    group->elements[idx++] = D_ASSERT_TRUE(
+        "build_exact_size",
+        str && (str->size == d_string_builder_size(sb)) &&
+        ( D_STRING_IS_INLINE(str) ||
+          (str->capacity == (str->size + 1)) ),
+        "built string should hold exactly the builder's contents");
+
+    d_string_free(str);
+    d_string_builder_free(sb);
+
+    return group;
+}
+
+/*
+d_tests_sa_dstring_builder_chunks
+  Tests d_string_builder chunking, caller-supplied storage and reuse.
+  Tests the following:
+  - caller-supplied storage is filled before any chunk is allocated
+  - appends larger than a chunk are split across chunks intact
+  - formatted text larger than a chunk is appended whole
+  - clear retains chunks, and refilling allocates none
+  - free_contents leaves an empty, reusable builder
+*/
+struct d_test_object*
+d_tests_sa_dstring_builder_chunks
+(
+    void
+)
+{
+    struct d_test_object*          group;
+    struct d_string_builder        sb;
+    struct d_string_builder_chunk* second;
+    struct d_string*               str;
+    char                           storage[16];
+    char                           expected[128];
+    size_t                         i;
+    size_t                         idx;
+
+    group = d_test_object_new_interior("d_string_builder chunks", 5);
+
+    if (!group)
+    {
+        return NULL;
+    }
+
+    idx = 0;
+
+    d_string_builder_init(&sb, 8, storage, sizeof(storage));
+
+    // test: caller-supplied storage is filled before any chunk is allocated
+    d_string_builder_append_cstr(&sb, "0123456789abcdef");
+
+    group->elements[idx++] = D_ASSERT_TRUE(
+        "caller_storage_first",
+        (sb.first.next == NULL) && (sb.first.size == 16) &&
+        (memcmp(storage, "0123456789abcdef", 16) == 0),
+        "16 bytes should fit in the caller's 16-byte buffer");
+
+    // test: appends larger than a chunk are split across chunks intact
+    for (i = 0; i < 100; i++)
+    {
+        expected[i] = (char)('a' + (i % 26));
+    }
+
+    d_string_builder_append_buffer(&sb, expected, 100);
+    str = d_string_builder_build(&sb);
+
+    group->elements[idx++] = D_ASSERT_TRUE(
+        "split_across_chunks",
+        str && (str->size == 116) &&
+        (memcmp(str->text, "0123456789abcdef", 16) == 0) &&
+        (memcmp(str->text + 16, expected, 100) == 0),
+        "a 100-byte append should survive 8-byte chunks intact");
+
+    d_string_free(str);
+
+    // test: formatted text larger than a chunk is appended whole
+    d_string_builder_append_formatted(&sb, "<%s>", "formatted-longer-than-8");
+    str = d_string_builder_build(&sb);
+
+    group->elements[idx++] = D_ASSERT_TRUE(
+        "formatted_over_chunk",
+        str && (str->size == 141) &&
+        (strcmp(str->text + 116, "<formatted-longer-than-8>") == 0),
+        "formatted text should be appended after the existing contents");
+
+    d_string_free(str);
+
+    // test: clear retains chunks, and refilling allocates none
+    second = sb.first.next;
+    d_string_builder_clear(&sb);
+    d_string_builder_append_buffer(&sb, expected, 24);
+    str = d_string_builder_build(&sb);
+
+    group->elements[idx++] = D_ASSERT_TRUE(
+        "clear_reuses_chunks",
+        (second != NULL) && (sb.first.next == second) &&
+        str && (str->size == 24) &&
+        (memcmp(str->text, expected, 24) == 0),
+        "refill after clear should reuse the retained chunks");
+
+    d_string_free(str);
+
+    // test: free_contents leaves an empty, reusable builder
+    d_string_builder_free_contents(&sb);
+    d_string_builder_append_cstr(&sb, "again");
+    str = d_string_builder_build(&sb);
+
+    group->elements[idx++] = D_ASSERT_TRUE(
+        "free_contents_reusable",
+        str && (strcmp(str->text, "again") == 0) &&
+        (sb.first.next == NULL),
+        "builder should be usable again after free_contents");
+
+    d_string_free(str);
+    d_string_builder_free_contents(&sb);
+
+    return group;
+}
+
+/*
+d_tests_sa_dstring_builder_build_ex
+  Tests d_string_builder_build_ex with the large buffer allocator.
+  Tests the following:
+  - a NULL allocator builds from the default allocator
+  - output over D_MEMORY_LARGE_THRESHOLD is built intact into a mapped,
+    page-aligned buffer
+  - the built string keeps growing through the same allocator
+*/
+struct d_test_object*
+d_tests_sa_dstring_builder_build_ex
+(
+    void
+)
+{
+    struct d_test_object*    group;
+    struct d_string_builder* sb;
+    struct d_string*         str;
+    char                     line[64];
+    size_t                   expected;
+    size_t                   idx;
+    bool                     intact;
+
+    group = d_test_object_new_interior("d_string_builder_build_ex", 3);
+
+    if (!group)
+    {
+        return NULL;
+    }
+
+    idx = 0;
+    sb  = d_string_builder_new(0);
+
+    // test: a NULL allocator builds from the default allocator
+    d_string_builder_append_cstr(sb, "small");
+    str = d_string_builder_build_ex(NULL, sb);
+
+    group->elements[idx++] = D_ASSERT_TRUE(
+        "null_allocator",
+        str && (strcmp(str->text, "small") == 0) &&
+        ((str->flags & D_STRING_FLAG_ALLOCATOR) == 0),
+        "a NULL allocator should build an ordinary heap string");
+
+    d_string_free(str);
+
+    // test: large output lands in a mapped, page-aligned buffer
+    memset(line, 'x', sizeof(line) - 1);
+    line[sizeof(line) - 1] = '\n';
+
+    for (expected = 5; expected <= D_MEMORY_LARGE_THRESHOLD; expected += sizeof(line))
+    {
+        d_string_builder_append_buffer(sb, line, sizeof(line));
+    }
+
+    str    = d_string_builder_build_ex(d_allocator_large(), sb);
+    intact = (str != NULL) &&
+             (str->size == expected) &&
+             (str->text[expected] == '\0') &&
+             (memcmp(str->text, "small", 5) == 0) &&
+             (memcmp(str->text + expected - sizeof(line), line, sizeof(line)) == 0);
+
+    group->elements[idx++] = D_ASSERT_TRUE(
+        "large_mapped",
+        intact &&
+        (str->flags & D_STRING_FLAG_ALLOCATOR) &&
+        (((uintptr_t)str->text % 4096) == 0),
+        "large output should be built intact into a page-aligned buffer");
+
+    // test: the string grows through the same allocator
+    group->elements[idx++] = D_ASSERT_TRUE(
+        "large_grows",
+        intact &&
+        d_string_append_buffer(str, line, sizeof(line)) &&
+        (str->size == expected + sizeof(line)) &&
+        (memcmp(str->text, "small", 5) == 0) &&
+        (memcmp(str->text + expected, line, sizeof(line)) == 0),
+        "appending should grow the large string in place or by remapping");
+
+    d_string_free(str);
+    d_string_builder_free(sb);
+
+    return group;
+}
+
+/*
+d_tests_sa_dstring_builder_write
+  Tests d_string_builder_write.
+  Tests the following:
+  - an empty builder writes zero bytes
+  - every chunk is written, in order, without materializing
+  - an invalid descriptor reports an error
+*/
+struct d_test_object*
+d_tests_sa_dstring_builder_write
+(
+    void
+)
+{
+    struct d_test_object*    group;
+    struct d_string_builder* sb;
+    FILE*                    file;
+    char                     buffer[64];
+    ssize_t                  written;
+    size_t                   read_count;
+    size_t                   idx;
+
+    group = d_test_object_new_interior("d_string_builder_write", 3);
+
+    if (!group)
+    {
+        return NULL;
+    }
+
+    idx  = 0;
+    sb   = d_string_builder_new(4);
+    file = tmpfile();
+
+    if ( (!sb) ||
+         (!file) )
+    {
+        group->elements[idx++] = D_ASSERT_TRUE(
+            "write_empty", false, "failed to allocate test resources");
+        group->elements[idx++] = D_ASSERT_TRUE(
+            "write_chunks", false, "failed to allocate test resources");
+        group->elements[idx++] = D_ASSERT_TRUE(
+            "write_bad_fd", false, "failed to allocate test resources");
+
+        d_string_builder_free(sb);
+
+        if (file)
+        {
+            fclose(file);
+        }
+
+        return group;
+    }
+
+    // test: an empty builder writes zero bytes
+    group->elements[idx++] = D_ASSERT_EQUAL(
+        "write_empty",
+        d_string_builder_write(sb, d_fileno(file)), 0,
+        "empty builder should write nothing");
+
+    // test: every chunk is written, in order, without materializing
+    d_string_builder_append_cstr(sb, "streamed ");
+    d_string_builder_append_int(sb, 12345);
+    d_string_builder_append_cstr(sb, " bytes");
+
+    written = d_string_builder_write(sb, d_fileno(file));
+    rewind(file);
+    read_count = fread(buffer, 1, sizeof(buffer), file);
+
+    group->elements[idx++] = D_ASSERT_TRUE(
+        "write_chunks",
+        (written == 20) && (read_count == 20) &&
+        (memcmp(buffer, "streamed 12345 bytes", 20) == 0),
+        "file should contain the builder's contents");
+
+    // test: an invalid descriptor reports an error
+    group->elements[idx++] = D_ASSERT_EQUAL(
+        "write_bad_fd",
+        d_string_builder_write(sb, -1), -1,
+        "writing to fd -1 should fail");
+
+    fclose(file);
+    d_string_builder_free(sb);
+
+    return group;
+}
+
+/*
+d_tests_sa_dstring_builder_null
+  Tests d_string_builder functions with NULL parameters.
+  Tests the following:
+  - appends to a NULL builder fail
+  - appending NULL text fails
+  - build and size of a NULL builder
+  - init, clear and free accept NULL
+*/
+struct d_test_object*
+d_tests_sa_dstring_builder_null
+(
+    void
+)
+{
+    struct d_test_object*    group;
+    struct d_string_builder* sb;
+    size_t                   idx;
+
+    group = d_test_object_new_interior("d_string_builder NULL handling", 4);
+
+    if (!group)
+    {
+        return NULL;
+    }
+
+    idx = 0;
+
+    // test: appends to a NULL builder fail
+    group->elements[idx++] = D_ASSERT_TRUE(
+        "append_null_builder",
+        !d_string_builder_append_cstr(NULL, "x") &&
+        !d_string_builder_append_char(NULL, 'x') &&
+        !d_string_builder_append_int(NULL, 1) &&
+        !d_string_builder_append_formatted(NULL, "%d", 1),
+        "appends to a NULL builder should return false");
+
+    // test: appending NULL text fails
+    sb = d_string_builder_new(0);
+
+    group->elements[idx++] = D_ASSERT_TRUE(
+        "append_null_text",
+        sb &&
+        !d_string_builder_append_cstr(sb, NULL) &&
+        !d_string_builder_append_buffer(sb, NULL, 1) &&
+        !d_string_builder_append_string(sb, NULL) &&
+        !d_string_builder_append_formatted(sb, NULL) &&
+        (d_string_builder_size(sb) == 0),
+        "NULL text should be rejected without side effects");
+
+    d_string_builder_free(sb);
+
+    // test: build and size of a NULL builder
+    group->elements[idx++] = D_ASSERT_TRUE(
+        "build_null",
+        (d_string_builder_build(NULL) == NULL) &&
+        (d_string_builder_size(NULL) == 0),
+        "NULL builder should build NULL and have size 0");
+
+    // test: init, clear and free accept NULL
+    d_string_builder_clear(NULL);
+    d_string_builder_free(NULL);
+    d_string_builder_free_contents(NULL);
+
+    group->elements[idx++] = D_ASSERT_TRUE(
+        "lifetime_null",
+        !d_string_builder_init(NULL, 0, NULL, 0),
+        "lifetime functions should accept NULL");
+
+    return group;
+}
+
+/*
+d_tests_sa_dstring_builder_all
+  Runs all string builder tests for dstring module.
+  Tests the following:
+  - appending (cstr, char, view, buffer, int, uint, formatted) and build
+  - chunking, caller-supplied storage, clear and free_contents
+  - building into a caller-chosen allocator
+  - streaming to a file descriptor
+  - NULL parameter handling
+*/
+struct d_test_object*
+d_tests_sa_dstring_builder_all
+(
+    void
+)
+{
+    struct d_test_object* group;
+    size_t                idx;
+
+    group = d_test_object_new_interior("String Builder Functions", 5);
+
+    if (!group)
+    {
+        return NULL;
+    }
+
+    idx = 0;
+
+    group->elements[idx++] = d_tests_sa_dstring_builder_append();
+    group->elements[idx++] = d_tests_sa_dstring_builder_chunks();
+    group->elements[idx++] = d_tests_sa_dstring_builder_build_ex();
+    group->elements[idx++] = d_tests_sa_dstring_builder_write();
+    group->elements[idx++] = d_tests_sa_dstring_builder_null();
+
+    return group;
+}
@@ -902,6 +902,531 @@ d_tests_sa_dstring_resize
 }
 
 
+/******************************************************************************
+* d_tests_sa_dstring_inline_storage
+******************************************************************************/
+
+/*
+d_tests_sa_dstring_inline_storage
+  Tests the small-string (inline) representation of d_string, verifying that
+  short strings live inside the struct and that every transition between the
+  inline and heap representations preserves content.
+
+Test cases:
+  1. Short string is stored inline
+  2. Longest inline string is stored inline
+  3. Append past inline capacity moves to heap, content preserved
+  4. Shrink of short heap string returns to inline storage
+  5. Free contents, then append re-enters inline storage
+  6. Replace-all result on inline string
+  7. Large capacity request is heap-allocated
+
+Parameter(s):
+  (none)
+Return:
+  Test object containing all assertion results.
+*/
+struct d_test_object*
+d_tests_sa_dstring_inline_storage
+(
+    void
+)
+{
+    struct d_test_object* group;
+    struct d_string*      str;
+    char                  max_inline[D_STRING_SSO_CAPACITY];
+    size_t                child_idx;
+    bool                  result;
+
+    group     = d_test_object_new_interior("d_string inline storage", 12);
+    child_idx = 0;
+
+    if (!group)
+    {
+        return NULL;
+    }
+
+    // test 1: short string is stored inline
+    str = d_string_new_from_cstr("key");
+
+    if (str)
+    {
+        group->elements[child_idx++] = D_ASSERT_TRUE(
+            "short_string_inline",
+            D_STRING_IS_INLINE(str),
+            "short string should use inline storage"
+        );
+
+        group->elements[child_idx++] = D_ASSERT_EQUAL(
+            "short_string_capacity",
+            str->capacity, D_STRING_SSO_CAPACITY,
+            "inline capacity should equal D_STRING_SSO_CAPACITY"
+        );
+
+        d_string_free(str);
+    }
+    else
+    {
+        group->elements[child_idx++] = D_ASSERT_TRUE(
+            "short_inline_skipped", false, "skipped"
+        );
+        group->elements[child_idx++] = D_ASSERT_TRUE(
+            "short_capacity_skipped", false, "skipped"
+        );
+    }
+
+    // test 2: longest inline string is stored inline
+    d_memset(max_inline, 'x', D_STRING_SSO_CAPACITY - 1);
+    max_inline[D_STRING_SSO_CAPACITY - 1] = '\0';
+    str = d_string_new_from_cstr(max_inline);
+
+    if (str)
+    {
+        group->elements[child_idx++] = D_ASSERT_TRUE(
+            "max_inline_string_inline",
+            D_STRING_IS_INLINE(str) &&
+            (str->size == D_STRING_SSO_CAPACITY - 1),
+            "string of D_STRING_SSO_CAPACITY - 1 chars should be inline"
+        );
+
+        d_string_free(str);
+    }
+    else
+    {
+        group->elements[child_idx++] = D_ASSERT_TRUE(
+            "max_inline_skipped", false, "skipped"
+        );
+    }
+
+    // test 3: append past inline capacity moves to heap
+    str = d_string_new_from_cstr("short");
+
+    if (str)
+    {
+        result = d_string_append_cstr(str,
+                                      " and now long enough to spill over");
+
+        group->elements[child_idx++] = D_ASSERT_TRUE(
+            "spill_to_heap_succeeds",
+            result && !D_STRING_IS_INLINE(str),
+            "append past inline capacity should move text to the heap"
+        );
+
+        group->elements[child_idx++] = D_ASSERT_STR_EQUAL(
+            "spill_to_heap_content",
+            str->text, "short and now long enough to spill over",
+            "content should be preserved when moving to the heap"
+        );
+
+        // test 4: shrink of short heap string returns to inline storage
+        d_string_resize(str, 5);
+        result = d_string_shrink_to_fit(str);
+
+        group->elements[child_idx++] = D_ASSERT_TRUE(
+            "shrink_returns_inline",
+            result && D_STRING_IS_INLINE(str),
+            "shrink_to_fit should move short contents back inline"
+        );
+
+        group->elements[child_idx++] = D_ASSERT_STR_EQUAL(
+            "shrink_returns_inline_content",
+            str->text, "short",
+            "content should be preserved when returning inline"
+        );
+
+        d_string_free(str);
+    }
+    else
+    {
+        group->elements[child_idx++] = D_ASSERT_TRUE(
+            "spill_skipped", false, "skipped"
+        );
+        group->elements[child_idx++] = D_ASSERT_TRUE(
+            "spill_content_skipped", false, "skipped"
+        );
+        group->elements[child_idx++] = D_ASSERT_TRUE(
+            "shrink_inline_skipped", false, "skipped"
+        );
+        group->elements[child_idx++] = D_ASSERT_TRUE(
+            "shrink_inline_content_skipped", false, "skipped"
+        );
+    }
+
+    // test 5: free contents, then append re-enters inline storage
+    str = d_string_new_from_cstr("temporary");
+
+    if (str)
+    {
+        d_string_free_contents(str);
+        result = d_string_append_cstr(str, "again");
+
+        group->elements[child_idx++] = D_ASSERT_TRUE(
+            "reuse_after_free_contents_inline",
+            result && D_STRING_IS_INLINE(str),
+            "append after free_contents should use inline storage"
+        );
+
+        group->elements[child_idx++] = D_ASSERT_STR_EQUAL(
+            "reuse_after_free_contents_content",
+            str->text, "again",
+            "content should be correct after reuse"
+        );
+
+        d_string_free(str);
+    }
+    else
+    {
+        group->elements[child_idx++] = D_ASSERT_TRUE(
+            "reuse_skipped", false, "skipped"
+        );
+        group->elements[child_idx++] = D_ASSERT_TRUE(
+            "reuse_content_skipped", false, "skipped"
+        );
+    }
+
+    // test 6: replace-all result on inline string
+    str = d_string_new_from_cstr("a-b-c");
+
+    if (str)
+    {
+        result = d_string_replace_all_cstr(str, "-", "+");
+
+        group->elements[child_idx++] = D_ASSERT_STR_EQUAL(
+            "replace_all_inline_content",
+            str->text, "a+b+c",
+            "replace_all should work on inline strings"
+        );
+
+        group->elements[child_idx++] = D_ASSERT_TRUE(
+            "replace_all_inline_storage",
+            result && D_STRING_IS_INLINE(str) && (str->size == 5),
+            "short replace_all result should remain inline"
+        );
+
+        d_string_free(str);
+    }
+    else
+    {
+        group->elements[child_idx++] = D_ASSERT_TRUE(
+            "replace_all_skipped", false, "skipped"
+        );
+        group->elements[child_idx++] = D_ASSERT_TRUE(
+            "replace_all_storage_skipped", false, "skipped"
+        );
+    }
+
+    // test 7: large capacity request is heap-allocated
+    str = d_string_new_with_capacity(256);
+
+    if (str)
+    {
+        group->elements[child_idx++] = D_ASSERT_TRUE(
+            "large_capacity_heap",
+            !D_STRING_IS_INLINE(str) && (str->capacity >= 256),
+            "capacity above inline size should use a heap buffer"
+        );
+
+        d_string_free(str);
+    }
+    else
+    {
+        group->elements[child_idx++] = D_ASSERT_TRUE(
+            "large_capacity_skipped", false, "skipped"
+        );
+    }
+
+    return group;
+}
+
+
+/******************************************************************************
+* d_tests_sa_dstring_growth_policy
+******************************************************************************/
+
+/*
+d_tests_sa_dstring_growth_policy
+  Tests d_string_set_growth_policy, d_string_get_growth_policy and the effect
+of each policy on capacity growth.
+
+Test cases:
+  1. NULL string is rejected
+  2. New string uses the default policy
+  3. Invalid policy is rejected
+  4. Exact policy grows to exactly the required capacity
+  5. 1.5x policy grows by half the current capacity
+  6. Doubling policy grows geometrically and preserves content
+  7. Page policy rounds capacity to whole pages
+  8. Reserve allocates exactly the requested capacity
+
+Parameter(s):
+  (none)
+Return:
+  Test object containing all assertion results.
+*/
+struct d_test_object*
+d_tests_sa_dstring_growth_policy
+(
+    void
+)
+{
+    struct d_test_object* group;
+    struct d_string*      str;
+    size_t                child_idx;
+    size_t                i;
+    bool                  result;
+
+    group     = d_test_object_new_interior("d_string growth policy", 9);
+    child_idx = 0;
+
+    if (!group)
+    {
+        return NULL;
+    }
+
+    // test 1: NULL string is rejected
+    group->elements[child_idx++] = D_ASSERT_FALSE(
+        "set_policy_null",
+        d_string_set_growth_policy(NULL, D_STRING_GROWTH_EXACT),
+        "setting a policy on NULL should return false"
+    );
+
+    str = d_string_new();
+
+    if (str)
+    {
+        // test 2: new string uses the default policy
+        group->elements[child_idx++] = D_ASSERT_TRUE(
+            "default_policy",
+            d_string_get_growth_policy(str) == D_STRING_DEFAULT_GROWTH,
+            "new string should use D_STRING_DEFAULT_GROWTH"
+        );
+
+        // test 3: invalid policy is rejected
+        result = d_string_set_growth_policy(
+                     str,
+                     (enum d_string_growth_policy)42);
+
+        group->elements[child_idx++] = D_ASSERT_TRUE(
+            "invalid_policy_rejected",
+            !result &&
+            (d_string_get_growth_policy(str) == D_STRING_DEFAULT_GROWTH),
+            "invalid policy should be rejected and leave policy unchanged"
+        );
+
+        // test 4: exact policy grows to exactly the required capacity
+        d_string_set_growth_policy(str, D_STRING_GROWTH_EXACT);
+        d_string_resize(str, 99);
+
+        group->elements[child_idx++] = D_ASSERT_EQUAL(
+            "exact_policy_capacity",
+            str->capacity, 100,
+            "exact policy should allocate size + 1 bytes"
+        );
+
+        // test 5: 1.5x policy grows by half the current capacity
+        d_string_set_growth_policy(str, D_STRING_GROWTH_HALF);
+        d_string_append_char(str, 'x');
+
+        group->elements[child_idx++] = D_ASSERT_EQUAL(
+            "half_policy_capacity",
+            str->capacity, 150,
+            "1.5x policy should grow 100 to 150"
+        );
+
+        d_string_free(str);
+    }
+    else
+    {
+        group->elements[child_idx++] = D_ASSERT_TRUE(
+            "default_policy_skipped", false, "skipped"
+        );
+        group->elements[child_idx++] = D_ASSERT_TRUE(
+            "invalid_policy_skipped", false, "skipped"
+        );
+        group->elements[child_idx++] = D_ASSERT_TRUE(
+            "exact_policy_skipped", false, "skipped"
+        );
+        group->elements[child_idx++] = D_ASSERT_TRUE(
+            "half_policy_skipped", false, "skipped"
+        );
+    }
+
+    // test 6: doubling policy grows geometrically and preserves content
+    str = d_string_new();
+
+    if (str)
+    {
+        d_string_set_growth_policy(str, D_STRING_GROWTH_DOUBLE);
+        result = true;
+
+        for (i = 0; i < 1000; i++)
+        {
+            result = result && d_string_append_char(str, (char)('a' + (i % 26)));
+        }
+
+        group->elements[child_idx++] = D_ASSERT_TRUE(
+            "double_policy_appends",
+            result && (str->size == 1000) && (str->capacity >= 1001),
+            "repeated appends should succeed with sufficient capacity"
+        );
+
+        group->elements[child_idx++] = D_ASSERT_TRUE(
+            "double_policy_content",
+            (str->text[0] == 'a') && (str->text[999] == 'a' + (999 % 26)) &&
+            (str->text[1000] == '\0'),
+            "content should be preserved across reallocations"
+        );
+
+        d_string_free(str);
+    }
+    else
+    {
+        group->elements[child_idx++] = D_ASSERT_TRUE(
+            "double_policy_skipped", false, "skipped"
+        );
+        group->elements[child_idx++] = D_ASSERT_TRUE(
+            "double_content_skipped", false, "skipped"
+        );
+    }
+
+    // test 7: page policy rounds capacity to whole pages
+    str = d_string_new();
+
+    if (str)
+    {
+        d_string_set_growth_policy(str, D_STRING_GROWTH_PAGE);
+        result = d_string_resize(str, 100);
+
+        group->elements[child_idx++] = D_ASSERT_TRUE(
+            "page_policy_capacity",
+            result && ((str->capacity % D_STRING_PAGE_SIZE) == 0),
+            "page policy should round capacity to D_STRING_PAGE_SIZE"
+        );
+
+        // test 8: reserve allocates exactly the requested capacity
+        result = d_string_reserve(str, (D_STRING_PAGE_SIZE * 2) + 1);
+
+        group->elements[child_idx++] = D_ASSERT_EQUAL(
+            "reserve_exact_capacity",
+            str->capacity, (D_STRING_PAGE_SIZE * 2) + 1,
+            "reserve should allocate exactly the requested capacity"
+        );
+
+        d_string_free(str);
+    }
+    else
+    {
+        group->elements[child_idx++] = D_ASSERT_TRUE(
+            "page_policy_skipped", false, "skipped"
+        );
+        group->elements[child_idx++] = D_ASSERT_TRUE(
+            "reserve_exact_skipped", false, "skipped"
+        );
+    }
+
+    return group;
+}
+
+/*
+d_tests_sa_dstring_alloc_sites
+  Tests that D_MEMORY_STATS charges string buffers to the public function
+that needed them rather than to the internal buffer helper.
+
+Test cases:
+  1. Buffers from d_string_new_with_capacity and d_string_reserve are held
+     by different call sites (only checked when built with D_MEMORY_STATS)
+
+Parameter(s):
+  (none)
+Return:
+  Test object containing all assertion results.
+*/
+struct d_test_object*
+d_tests_sa_dstring_alloc_sites
+(
+    void
+)
+{
+    struct d_test_object*  group;
+    struct d_memory_stats* before;
+    struct d_memory_stats* after;
+    struct d_string*       created;
+    struct d_string*       reserved;
+    size_t                 child_idx;
+    size_t                 sites;
+    size_t                 live;
+    size_t                 i;
+    size_t                 j;
+
+    group     = d_test_object_new_interior("d_string allocation sites", 1);
+    child_idx = 0;
+
+    if (!group)
+    {
+        return NULL;
+    }
+
+    before   = d_memory_stats_snapshot();
+    created  = d_string_new_with_capacity(4096);
+    reserved = d_string_new();
+
+    if (reserved)
+    {
+        d_string_reserve(reserved, 4096);
+    }
+
+    after = d_memory_stats_snapshot();
+    sites = 0;
+
+    // count the string sites whose live bytes grew by at least one buffer
+    if ( (before) &&
+         (after)  &&
+         (after->enabled) )
+    {
+        for (i = 0; i < after->site_count; i++)
+        {
+            if (after->sites[i].module != D_MEMORY_MODULE_STRING)
+            {
+                continue;
+            }
+
+            live = 0;
+
+            for (j = 0; j < before->site_count; j++)
+            {
+                if ( (before->sites[j].line == after->sites[i].line) &&
+                     (strcmp(before->sites[j].file, after->sites[i].file) == 0) )
+                {
+                    live = before->sites[j].live;
+                }
+            }
+
+            if (after->sites[i].live >= (live + 4096))
+            {
+                sites++;
+            }
+        }
+    }
+
+    // test 1: the two buffers are charged to their own call sites
+    group->elements[child_idx++] = D_ASSERT_TRUE(
+        "distinct_sites",
+        (created != NULL) &&
+        (reserved != NULL) &&
+        (after != NULL) &&
+        ( (!after->enabled) || (sites >= 2) ),
+        "each public function should be its own allocation site"
+    );
+
+    d_memory_stats_free_snapshot(before);
+    d_memory_stats_free_snapshot(after);
+    d_string_free(created);
+    d_string_free(reserved);
+
+    return group;
+}
+
+
 /******************************************************************************
 * d_tests_sa_dstring_capacity_all
 ******************************************************************************/
@@ -925,7 +1450,7 @@ d_tests_sa_dstring_capacity_all
     struct d_test_object* group;
     size_t                child_idx;
 
-    group     = d_test_object_new_interior("d_string Capacity Management", 4);
+    group     = d_test_object_new_interior("d_string Capacity Management", 7);
     child_idx = 0;
 
     if (!group)
@@ -938,6 +1463,9 @@ d_tests_sa_dstring_capacity_all
     group->elements[child_idx++] = d_tests_sa_dstring_shrink_to_fit();
     group->elements[child_idx++] = d_tests_sa_dstring_capacity();
     group->elements[child_idx++] = d_tests_sa_dstring_resize();
+    group->elements[child_idx++] = d_tests_sa_dstring_inline_storage();
+    group->elements[child_idx++] = d_tests_sa_dstring_growth_policy();
+    group->elements[child_idx++] = d_tests_sa_dstring_alloc_sites();
 
     return group;
 }
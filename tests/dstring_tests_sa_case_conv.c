@@ -599,6 +599,144 @@ d_tests_sa_dstring_upper
     return group;
 }
 
+/*
+d_tests_sa_dstring_case_long
+  Tests d_string_to_lower, d_string_to_upper and d_string_replace_char on
+strings long enough to exercise the vectorized kernels.
+  Tests the following:
+  - every length up to several vector blocks is fully converted to lowercase
+  - every length up to several vector blocks is fully converted to uppercase
+  - bytes outside 'A'-'Z'/'a'-'z', including non-ASCII bytes, are unchanged
+  - conversion covers bytes after an embedded '\0'
+  - replace_char replaces every occurrence across block boundaries
+*/
+struct d_test_object*
+d_tests_sa_dstring_case_long
+(
+    void
+)
+{
+    struct d_test_object* group;
+    struct d_string*      str;
+    char                  text[160];
+    size_t                len;
+    size_t                i;
+    bool                  lower_ok;
+    bool                  upper_ok;
+    bool                  replace_ok;
+    bool                  result;
+    size_t                idx;
+
+    group = d_test_object_new_interior("d_string_case_long", 5);
+
+    if (!group)
+    {
+        return NULL;
+    }
+
+    idx        = 0;
+    lower_ok   = true;
+    upper_ok   = true;
+    replace_ok = true;
+
+    // every length from 0 to 159 of a repeating mixed-case alphabet
+    for (len = 0; len < sizeof(text); len++)
+    {
+        for (i = 0; i < len; i++)
+        {
+            text[i] = (char)(((i % 3) ? 'a' : 'A') + (i % 26));
+        }
+
+        str = d_string_new_from_buffer(text, len);
+
+        if (!str)
+        {
+            lower_ok = upper_ok = replace_ok = false;
+
+            break;
+        }
+
+        d_string_to_lower(str);
+
+        for (i = 0; i < len; i++)
+        {
+            lower_ok = lower_ok && (str->text[i] == (char)('a' + (i % 26)));
+        }
+
+        d_string_to_upper(str);
+
+        for (i = 0; i < len; i++)
+        {
+            upper_ok = upper_ok && (str->text[i] == (char)('A' + (i % 26)));
+        }
+
+        d_string_replace_char(str, 'Q', '-');
+
+        for (i = 0; i < len; i++)
+        {
+            replace_ok = replace_ok &&
+                         (str->text[i] == (((i % 26) == ('Q' - 'A'))
+                                               ? '-'
+                                               : (char)('A' + (i % 26))));
+        }
+
+        d_string_free(str);
+    }
+
+    // test: every length is fully converted to lowercase
+    group->elements[idx++] = D_ASSERT_TRUE(
+        "case_long_lower",
+        lower_ok,
+        "to_lower should convert strings of every length");
+
+    // test: every length is fully converted to uppercase
+    group->elements[idx++] = D_ASSERT_TRUE(
+        "case_long_upper",
+        upper_ok,
+        "to_upper should convert strings of every length");
+
+    // test: bytes outside the ASCII letters are unchanged
+    for (i = 0; i < 64; i++)
+    {
+        text[i] = (char)(0x80 + i * 2);
+    }
+
+    d_memcpy(text + 10, "@[`{Zz", 6);
+    str    = d_string_new_from_buffer(text, 64);
+    result = (str != NULL) && d_string_to_lower(str);
+
+    for (i = 0; result && (i < 64); i++)
+    {
+        result = (str->text[i] == ((i == 14) ? 'z' : text[i]));
+    }
+
+    group->elements[idx++] = D_ASSERT_TRUE(
+        "case_long_non_letters",
+        result,
+        "only 'A'-'Z' should change when lowering");
+
+    d_string_free(str);
+
+    // test: conversion covers bytes after an embedded '\0'
+    str    = d_string_new_from_buffer("ABC\0DEF", 7);
+    result = (str != NULL) && d_string_to_lower(str) &&
+             (memcmp(str->text, "abc\0def", 7) == 0);
+    group->elements[idx++] = D_ASSERT_TRUE(
+        "case_long_embedded_nul",
+        result,
+        "to_lower should convert the full length of the string");
+
+    d_string_free(str);
+
+    // test: replace_char replaces every occurrence across block boundaries
+    group->elements[idx++] = D_ASSERT_TRUE(
+        "case_long_replace_char",
+        replace_ok,
+        "replace_char should replace every occurrence at every length");
+
+    return group;
+}
+
 
 /******************************************************************************
  * CASE CONVERSION ALL - AGGREGATE RUNNER
@@ -610,6 +748,7 @@ d_tests_sa_dstring_case_all
   Tests the following:
   - in-place conversion functions (to_lower, to_upper)
   - non-modifying functions (lower, upper)
+  - long strings handled by the vectorized kernels
 */
 struct d_test_object*
 d_tests_sa_dstring_case_all
@@ -620,7 +759,7 @@ d_tests_sa_dstring_case_all
     struct d_test_object* group;
     size_t                idx;
 
-    group = d_test_object_new_interior("Case Conversion Functions", 4);
+    group = d_test_object_new_interior("Case Conversion Functions", 5);
 
     if (!group)
     {
@@ -637,5 +776,8 @@ d_tests_sa_dstring_case_all
     group->elements[idx++] = d_tests_sa_dstring_lower();
     group->elements[idx++] = d_tests_sa_dstring_upper();
 
+    // long-string conversion tests
+    group->elements[idx++] = d_tests_sa_dstring_case_long();
+
     return group;
 }
@@ -1503,8 +1503,8 @@ d_tests_sa_dstring_free_contents
             "capacity should be 0 after free_contents"
         );
 
-        // now free the structure itself
-        free(str);
+        // now free the structure itself; its text is already gone
+        d_string_free(str);
     }
     else
     {
@@ -1526,6 +1526,419 @@ d_tests_sa_dstring_free_contents
 }
 
 
+/******************************************************************************
+* d_tests_sa_dstring_arena_new
+******************************************************************************/
+
+/*
+d_tests_sa_dstring_arena_new
+  Tests d_string_arena_new() and its siblings, which allocate a d_string and
+  its text from a d_arena.
+
+Test cases:
+  1. NULL arena or source returns NULL
+  2. Short string is inline and marked as arena-backed
+  3. Long string takes its buffer from the arena, not the heap
+  4. Appending grows the buffer within the arena
+  5. Assigning a long heap string copies rather than shares it
+  6. In-place replacement keeps the result in the arena
+  7. d_string_arena_new_copy copies the contents
+  8. d_string_free is a no-op and d_arena_reset releases everything
+
+Parameter(s):
+  (none)
+Return:
+  Test object containing all assertion results.
+*/
+struct d_test_object*
+d_tests_sa_dstring_arena_new
+(
+    void
+)
+{
+    struct d_test_object* group;
+    struct d_arena*       arena;
+    struct d_string*      short_str;
+    struct d_string*      long_str;
+    struct d_string*      heap_str;
+    struct d_string*      copy;
+    char                  buffer[300];
+    size_t                used;
+    size_t                i;
+    size_t                child_idx;
+    bool                  ok;
+
+    group     = d_test_object_new_interior("d_string_arena_new", 8);
+    child_idx = 0;
+
+    if (!group)
+    {
+        return NULL;
+    }
+
+    arena = d_arena_new(0);
+
+    // test 1: NULL arena or source
+    group->elements[child_idx++] = D_ASSERT_TRUE(
+        "null_params",
+        (d_string_arena_new(NULL, 0) == NULL) &&
+        (d_string_arena_new_from_cstr(arena, NULL) == NULL) &&
+        (d_string_arena_new_copy(arena, NULL) == NULL),
+        "NULL arena or source should return NULL"
+    );
+
+    // test 2: short string stays inline
+    short_str = d_string_arena_new_from_cstr(arena, "short");
+    group->elements[child_idx++] = D_ASSERT_TRUE(
+        "short_inline",
+        (short_str != NULL) &&
+        (strcmp(short_str->text, "short") == 0) &&
+        D_STRING_IS_INLINE(short_str) &&
+        ((short_str->flags & D_STRING_FLAG_ALLOCATOR) != 0),
+        "short arena string should be inline and flagged"
+    );
+
+    // test 3: long string buffer comes from the arena
+    memset(buffer, 'a', sizeof(buffer));
+    used     = d_arena_used(arena);
+    long_str = d_string_arena_new_from_buffer(arena, buffer, sizeof(buffer));
+    group->elements[child_idx++] = D_ASSERT_TRUE(
+        "long_in_arena",
+        (long_str != NULL) &&
+        (long_str->size == sizeof(buffer)) &&
+        (long_str->text[sizeof(buffer)] == '\0') &&
+        (!D_STRING_IS_INLINE(long_str)) &&
+        ((long_str->flags & D_STRING_FLAG_COUNTED) == 0) &&
+        (d_arena_used(arena) > used + sizeof(buffer)),
+        "long arena string should allocate its text from the arena"
+    );
+
+    // test 4: appending grows within the arena
+    ok = (long_str != NULL);
+
+    for (i = 0; ok && (i < 100); i++)
+    {
+        ok = d_string_append_cstr(long_str, "bcdefgh");
+    }
+
+    group->elements[child_idx++] = D_ASSERT_TRUE(
+        "append_grows_in_arena",
+        ok &&
+        (long_str->size == sizeof(buffer) + 700) &&
+        (long_str->text[sizeof(buffer)] == 'b') &&
+        (long_str->text[long_str->size - 1] == 'h') &&
+        ((long_str->flags & D_STRING_FLAG_COUNTED) == 0) &&
+        (d_arena_used(arena) >= long_str->capacity),
+        "appending should grow the buffer within the arena"
+    );
+
+    // test 5: assigning a shareable heap string copies it
+    heap_str = d_string_new_fill(D_STRING_SHARE_THRESHOLD * 2, 'x');
+    ok       = (heap_str != NULL) &&
+               (short_str != NULL) &&
+               d_string_assign(short_str, heap_str);
+    group->elements[child_idx++] = D_ASSERT_TRUE(
+        "assign_copies",
+        ok &&
+        (short_str->size == heap_str->size) &&
+        (short_str->text != heap_str->text) &&
+        (!d_string_is_shared(heap_str)) &&
+        ((short_str->flags & D_STRING_FLAG_COUNTED) == 0),
+        "arena string should copy rather than share a heap buffer"
+    );
+
+    // test 6: in-place replacement stays in the arena
+    ok = ok && d_string_replace_all_cstr(short_str, "x", "yz");
+    group->elements[child_idx++] = D_ASSERT_TRUE(
+        "replace_stays_in_arena",
+        ok &&
+        (short_str->size == D_STRING_SHARE_THRESHOLD * 4) &&
+        (short_str->text[0] == 'y') &&
+        (short_str->text[short_str->size - 1] == 'z') &&
+        ((short_str->flags & D_STRING_FLAG_ALLOCATOR) != 0) &&
+        ((short_str->flags & D_STRING_FLAG_COUNTED) == 0),
+        "replacement result should be copied into the arena"
+    );
+
+    // test 7: arena copy
+    copy = d_string_arena_new_copy(arena, heap_str);
+    group->elements[child_idx++] = D_ASSERT_TRUE(
+        "arena_copy",
+        (copy != NULL) &&
+        (heap_str != NULL) &&
+        (d_string_equals(copy, heap_str)) &&
+        ((copy->flags & D_STRING_FLAG_ALLOCATOR) != 0),
+        "d_string_arena_new_copy should copy the contents"
+    );
+
+    // test 8: free is a no-op; reset releases everything
+    d_string_free(copy);
+    d_string_free(long_str);
+    d_arena_reset(arena);
+    group->elements[child_idx++] = D_ASSERT_TRUE(
+        "reset_releases",
+        (arena != NULL) &&
+        (d_arena_used(arena) == 0),
+        "d_arena_reset should release every arena string"
+    );
+
+    d_string_free(heap_str);
+    d_arena_free(arena);
+
+    return group;
+}
+
+
+/******************************************************************************
+* d_tests_sa_dstring_new_ex
+******************************************************************************/
+
+// d_tests_sa_dstring_counter
+//   struct: context of the counting allocator used by d_tests_sa_dstring_new_ex.
+struct d_tests_sa_dstring_counter
+{
+    size_t live;   // bytes allocated and not yet freed
+    size_t calls;  // allocate and reallocate calls
+};
+
+/*
+d_tests_sa_dstring_counter_allocate
+  The `allocate` function of the counting allocator: malloc, counted.
+*/
+static void*
+d_tests_sa_dstring_counter_allocate
+(
+    void*  _context,
+    size_t _size,
+    size_t _alignment
+)
+{
+    struct d_tests_sa_dstring_counter* counter;
+    void*                              memory;
+
+    (void)_alignment;
+
+    counter = (struct d_tests_sa_dstring_counter*)_context;
+    memory  = malloc(_size);
+
+    if (memory != NULL)
+    {
+        counter->live += _size;
+        counter->calls++;
+    }
+
+    return memory;
+}
+
+/*
+d_tests_sa_dstring_counter_reallocate
+  The `reallocate` function of the counting allocator: realloc, counted.
+*/
+static void*
+d_tests_sa_dstring_counter_reallocate
+(
+    void*  _context,
+    void*  _ptr,
+    size_t _old_size,
+    size_t _new_size
+)
+{
+    struct d_tests_sa_dstring_counter* counter;
+    void*                              memory;
+
+    counter = (struct d_tests_sa_dstring_counter*)_context;
+    memory  = realloc(_ptr, _new_size);
+
+    if (memory != NULL)
+    {
+        counter->live = counter->live - _old_size + _new_size;
+        counter->calls++;
+    }
+
+    return memory;
+}
+
+/*
+d_tests_sa_dstring_counter_deallocate
+  The `deallocate` function of the counting allocator: free, counted.
+*/
+static void
+d_tests_sa_dstring_counter_deallocate
+(
+    void*  _context,
+    void*  _ptr,
+    size_t _size
+)
+{
+    ((struct d_tests_sa_dstring_counter*)_context)->live -= _size;
+    free(_ptr);
+
+    return;
+}
+
+/*
+d_tests_sa_dstring_new_ex
+  Tests d_string_new_ex() and its siblings, which allocate a d_string and its
+  text from a caller-supplied d_allocator, and the default allocator.
+
+Test cases:
+  1. NULL allocator with the system default makes an ordinary heap string
+  2. Short string takes only its struct from the allocator
+  3. Long string takes its buffer from the allocator and grows through it
+  4. d_string_new_copy_ex never shares the original's buffer
+  5. d_string_free returns every byte to the allocator
+  6. A replaced default allocator serves d_string_new_from_cstr and
+     d_string_new_copy
+  7. A heap string edited under the replaced default stays a heap string
+  8. Every byte is returned once the default is restored
+
+Parameter(s):
+  (none)
+Return:
+  Test object containing all assertion results.
+*/
+struct d_test_object*
+d_tests_sa_dstring_new_ex
+(
+    void
+)
+{
+    struct d_test_object*             group;
+    struct d_tests_sa_dstring_counter counter;
+    struct d_allocator                allocator;
+    struct d_string*                  short_str;
+    struct d_string*                  long_str;
+    struct d_string*                  heap_str;
+    struct d_string*                  copy;
+    char                              buffer[300];
+    size_t                            i;
+    size_t                            child_idx;
+    bool                              ok;
+
+    group     = d_test_object_new_interior("d_string_new_ex", 8);
+    child_idx = 0;
+
+    if (!group)
+    {
+        return NULL;
+    }
+
+    counter.live          = 0;
+    counter.calls         = 0;
+    allocator.allocate    = d_tests_sa_dstring_counter_allocate;
+    allocator.reallocate  = d_tests_sa_dstring_counter_reallocate;
+    allocator.try_expand  = NULL;
+    allocator.deallocate  = d_tests_sa_dstring_counter_deallocate;
+    allocator.context     = &counter;
+
+    // test 1: NULL allocator with the system default
+    heap_str = d_string_new_from_cstr_ex(NULL, "heap");
+    group->elements[child_idx++] = D_ASSERT_TRUE(
+        "null_is_heap",
+        (heap_str != NULL) &&
+        (strcmp(heap_str->text, "heap") == 0) &&
+        ((heap_str->flags & D_STRING_FLAG_ALLOCATOR) == 0) &&
+        (counter.calls == 0),
+        "NULL allocator should make an ordinary heap string"
+    );
+
+    // test 2: short string takes only its struct from the allocator
+    short_str = d_string_new_from_cstr_ex(&allocator, "short");
+    group->elements[child_idx++] = D_ASSERT_TRUE(
+        "short_struct_only",
+        (short_str != NULL) &&
+        (strcmp(short_str->text, "short") == 0) &&
+        D_STRING_IS_INLINE(short_str) &&
+        ((short_str->flags & D_STRING_FLAG_ALLOCATOR) != 0) &&
+        (counter.calls == 1),
+        "short string should allocate only its struct"
+    );
+
+    // test 3: long string buffer comes from and grows through the allocator
+    memset(buffer, 'a', sizeof(buffer));
+    long_str = d_string_new_from_buffer_ex(&allocator, buffer, sizeof(buffer));
+    ok       = (long_str != NULL);
+
+    for (i = 0; ok && (i < 100); i++)
+    {
+        ok = d_string_append_cstr(long_str, "bcdefgh");
+    }
+
+    group->elements[child_idx++] = D_ASSERT_TRUE(
+        "long_grows",
+        ok &&
+        (long_str->size == sizeof(buffer) + 700) &&
+        (long_str->text[long_str->size - 1] == 'h') &&
+        ((long_str->flags & D_STRING_FLAG_COUNTED) == 0) &&
+        (counter.live > long_str->capacity) &&
+        (counter.calls > 3),
+        "long string should grow through its allocator"
+    );
+
+    // test 4: copies never share
+    copy = d_string_new_copy_ex(&allocator, long_str);
+    group->elements[child_idx++] = D_ASSERT_TRUE(
+        "copy_unshared",
+        (copy != NULL) &&
+        (long_str != NULL) &&
+        d_string_equals(copy, long_str) &&
+        (copy->text != long_str->text) &&
+        (!d_string_is_shared(long_str)),
+        "d_string_new_copy_ex should copy rather than share"
+    );
+
+    // test 5: free returns everything
+    d_string_free(copy);
+    d_string_free(long_str);
+    d_string_free(short_str);
+    group->elements[child_idx++] = D_ASSERT_TRUE(
+        "free_returns_all",
+        (counter.live == 0),
+        "d_string_free should return every byte to the allocator"
+    );
+
+    // test 6: the replaced default serves ordinary constructors
+    d_allocator_set_default(&allocator);
+    long_str = d_string_new_fill(D_STRING_SHARE_THRESHOLD * 2, 'x');
+    copy     = d_string_new_copy(long_str);
+    group->elements[child_idx++] = D_ASSERT_TRUE(
+        "default_serves_new",
+        (long_str != NULL) &&
+        (copy != NULL) &&
+        ((long_str->flags & D_STRING_FLAG_ALLOCATOR) != 0) &&
+        ((copy->flags & D_STRING_FLAG_ALLOCATOR) != 0) &&
+        (copy->text != long_str->text),
+        "the default allocator should serve d_string_new_* functions"
+    );
+
+    // test 7: a heap string edited under the default stays on the heap
+    ok = (heap_str != NULL) &&
+         d_string_append_cstr(heap_str, " heap heap heap heap heap heap heap") &&
+         d_string_replace_all_cstr(heap_str, "heap", "pile");
+    group->elements[child_idx++] = D_ASSERT_TRUE(
+        "heap_stays_heap",
+        ok &&
+        (strncmp(heap_str->text, "pile pile", 9) == 0) &&
+        ((heap_str->flags & D_STRING_FLAG_ALLOCATOR) == 0),
+        "a heap string should copy results made from the default allocator"
+    );
+
+    // test 8: restoring the default
+    d_string_free(copy);
+    d_string_free(long_str);
+    d_allocator_set_default(NULL);
+    group->elements[child_idx++] = D_ASSERT_TRUE(
+        "default_restored",
+        (counter.live == 0) &&
+        (d_allocator_default() == d_allocator_system()),
+        "every byte should be returned and the system default restored"
+    );
+
+    d_string_free(heap_str);
+
+    return group;
+}
+
 /******************************************************************************
 * d_tests_sa_dstring_creation_all
 ******************************************************************************/
@@ -1549,7 +1962,7 @@ d_tests_sa_dstring_creation_all
     struct d_test_object* group;
     size_t                child_idx;
 
-    group     = d_test_object_new_interior("d_string Creation & Destruction", 10);
+    group     = d_test_object_new_interior("d_string Creation & Destruction", 12);
     child_idx = 0;
 
     if (!group)
@@ -1568,6 +1981,8 @@ d_tests_sa_dstring_creation_all
     group->elements[child_idx++] = d_tests_sa_dstring_new_formatted();
     group->elements[child_idx++] = d_tests_sa_dstring_free();
     group->elements[child_idx++] = d_tests_sa_dstring_free_contents();
+    group->elements[child_idx++] = d_tests_sa_dstring_arena_new();
+    group->elements[child_idx++] = d_tests_sa_dstring_new_ex();
 
     return group;
 }
@@ -0,0 +1,330 @@
+#include ".\dstring_tests_sa.h"
+
+
+/******************************************************************************
+ * SECTION 24: EDIT DISTANCE FUNCTIONS
+ *****************************************************************************/
+
+/*
+d_tests_sa_dstring_distance
+  Tests d_string_distance and d_string_view_distance.
+  Tests the following:
+  - classic examples ("kitten"/"sitting", "flaw"/"lawn")
+  - identical strings have distance 0; an empty string, the other's length
+  - the distance is symmetric
+  - NULL d_strings are treated as empty
+  - embedded null bytes are ordinary characters
+  - strings longer than 64 bytes (multi-word path) are handled
+*/
+struct d_test_object*
+d_tests_sa_dstring_distance
+(
+    void
+)
+{
+    struct d_test_object* group;
+    struct d_string*      kitten;
+    struct d_string*      sitting;
+    struct d_string*      long_a;
+    struct d_string*      long_b;
+    char                  buffer[200];
+    size_t                idx;
+
+    group = d_test_object_new_interior("d_string_distance", 6);
+
+    if (!group)
+    {
+        return NULL;
+    }
+
+    idx     = 0;
+    kitten  = d_string_new_from_cstr("kitten");
+    sitting = d_string_new_from_cstr("sitting");
+
+    // test: classic examples
+    group->elements[idx++] = D_ASSERT_TRUE(
+        "distance_classic",
+        (d_string_distance(kitten, sitting) == 3) &&
+        (d_string_view_distance(d_string_view_from_cstr("flaw"),
+                                d_string_view_from_cstr("lawn"),
+                                SIZE_MAX) == 2),
+        "kitten/sitting should be 3 edits apart, flaw/lawn 2");
+
+    // test: identical and empty strings
+    group->elements[idx++] = D_ASSERT_TRUE(
+        "distance_identity",
+        (d_string_distance(kitten, kitten) == 0) &&
+        (d_string_view_distance(d_string_view_from_cstr(""),
+                                d_string_view_from_cstr("abc"),
+                                SIZE_MAX) == 3),
+        "equal strings should be 0 apart, empty strings their length");
+
+    // test: symmetry
+    group->elements[idx++] = D_ASSERT_TRUE(
+        "distance_symmetric",
+        d_string_distance(sitting, kitten) == 3,
+        "distance should not depend on argument order");
+
+    // test: NULL as empty
+    group->elements[idx++] = D_ASSERT_TRUE(
+        "distance_null",
+        (d_string_distance(NULL, sitting) == 7) &&
+        (d_string_distance(NULL, NULL) == 0),
+        "NULL should be treated as an empty string");
+
+    // test: embedded null bytes
+    group->elements[idx++] = D_ASSERT_TRUE(
+        "distance_binary",
+        d_string_view_distance(d_string_view_make("a\0b", 3),
+                               d_string_view_make("a\0c", 3),
+                               SIZE_MAX) == 1,
+        "null bytes should compare as characters");
+
+    // test: strings longer than one machine word
+    // (two substitutions, then two more bytes to insert)
+    memset(buffer, 'x', sizeof(buffer));
+    long_a = d_string_new_from_buffer(buffer, 150);
+    buffer[10]  = 'y';
+    buffer[100] = 'z';
+    buffer[150] = 'y';
+    buffer[151] = 'z';
+    long_b = d_string_new_from_buffer(buffer, 152);
+
+    group->elements[idx++] = D_ASSERT_TRUE(
+        "distance_long",
+        d_string_distance(long_a, long_b) == 4,
+        "strings over 64 bytes should use the multi-word path");
+
+    d_string_free(long_a);
+    d_string_free(long_b);
+    d_string_free(kitten);
+    d_string_free(sitting);
+
+    return group;
+}
+
+/*
+d_tests_sa_dstring_distance_bounded
+  Tests d_string_distance_bounded.
+  Tests the following:
+  - distances within the bound are exact
+  - distances beyond the bound return `_max + 1`
+  - a length difference beyond the bound is rejected
+  - a bound of 0 is an equality test
+*/
+struct d_test_object*
+d_tests_sa_dstring_distance_bounded
+(
+    void
+)
+{
+    struct d_test_object* group;
+    struct d_string*      kitten;
+    struct d_string*      sitting;
+    struct d_string*      other;
+    size_t                idx;
+
+    group = d_test_object_new_interior("d_string_distance_bounded", 4);
+
+    if (!group)
+    {
+        return NULL;
+    }
+
+    idx     = 0;
+    kitten  = d_string_new_from_cstr("kitten");
+    sitting = d_string_new_from_cstr("sitting");
+    other   = d_string_new_from_cstr("a much longer unrelated string");
+
+    // test: within the bound
+    group->elements[idx++] = D_ASSERT_TRUE(
+        "bounded_within",
+        (d_string_distance_bounded(kitten, sitting, 3) == 3) &&
+        (d_string_distance_bounded(kitten, sitting, 10) == 3),
+        "distances within the bound should be exact");
+
+    // test: beyond the bound
+    group->elements[idx++] = D_ASSERT_TRUE(
+        "bounded_exceeded",
+        d_string_distance_bounded(kitten, sitting, 2) == 3,
+        "distances beyond the bound should return max + 1");
+
+    // test: length difference
+    group->elements[idx++] = D_ASSERT_TRUE(
+        "bounded_length",
+        d_string_distance_bounded(kitten, other, 5) == 6,
+        "a length gap beyond the bound should be rejected");
+
+    // test: zero bound
+    group->elements[idx++] = D_ASSERT_TRUE(
+        "bounded_zero",
+        (d_string_distance_bounded(kitten, kitten, 0) == 0) &&
+        (d_string_distance_bounded(kitten, sitting, 0) == 1),
+        "a bound of 0 should test equality");
+
+    d_string_free(kitten);
+    d_string_free(sitting);
+    d_string_free(other);
+
+    return group;
+}
+
+/*
+d_tests_sa_dstring_distance_batch
+  Tests d_string_distance_batch.
+  Tests the following:
+  - every candidate gets the same distance as d_string_distance
+  - candidates beyond the bound get `_max + 1` and are not counted
+  - NULL candidates are treated as empty
+  - queries longer than 64 bytes are supported
+  - a NULL candidate array is rejected unless the count is 0
+*/
+struct d_test_object*
+d_tests_sa_dstring_distance_batch
+(
+    void
+)
+{
+    static const char* words[] =
+    {
+        "receive", "recieve", "deceive", "relieve", "retrieve",
+        "perceive", "reception", "", "receiving"
+    };
+    struct d_test_object*  group;
+    struct d_string*       query;
+    struct d_string*       candidates[10];
+    struct d_string*       long_query;
+    size_t                 distances[10];
+    size_t                 matched;
+    size_t                 idx;
+    size_t                 i;
+    bool                   same;
+    char                   buffer[100];
+
+    group = d_test_object_new_interior("d_string_distance_batch", 5);
+
+    if (!group)
+    {
+        return NULL;
+    }
+
+    idx   = 0;
+    query = d_string_new_from_cstr("recieve");
+
+    for (i = 0; i < 9; i++)
+    {
+        candidates[i] = d_string_new_from_cstr(words[i]);
+    }
+
+    candidates[9] = NULL;
+
+    matched = d_string_distance_batch(query,
+                                      (const struct d_string* const*)candidates,
+                                      10,
+                                      SIZE_MAX,
+                                      distances);
+    same    = (matched == 10);
+
+    for (i = 0; i < 10; i++)
+    {
+        same = same &&
+               (distances[i] == d_string_distance(query, candidates[i]));
+    }
+
+    // test: unbounded batch matches pairwise distances
+    group->elements[idx++] = D_ASSERT_TRUE(
+        "batch_unbounded",
+        same,
+        "batch distances should match d_string_distance");
+
+    // test: NULL candidate
+    group->elements[idx++] = D_ASSERT_TRUE(
+        "batch_null_candidate",
+        distances[9] == 7,
+        "NULL candidates should be treated as empty");
+
+    matched = d_string_distance_batch(query,
+                                      (const struct d_string* const*)candidates,
+                                      10,
+                                      2,
+                                      distances);
+
+    // test: bounded batch ("recieve" is 2 edits from "receive", "deceive"
+    // and "relieve", and 0 from itself)
+    group->elements[idx++] = D_ASSERT_TRUE(
+        "batch_bounded",
+        (matched == 4)       &&
+        (distances[0] == 2)  &&
+        (distances[1] == 0)  &&
+        (distances[6] == 3)  &&
+        (distances[7] == 3),
+        "candidates beyond the bound should get max + 1");
+
+    // test: long query
+    memset(buffer, 'q', sizeof(buffer));
+    long_query = d_string_new_from_buffer(buffer, 80);
+
+    matched = d_string_distance_batch(long_query,
+                                      (const struct d_string* const*)candidates,
+                                      2,
+                                      SIZE_MAX,
+                                      distances);
+
+    group->elements[idx++] = D_ASSERT_TRUE(
+        "batch_long_query",
+        (matched == 2)                                         &&
+        (distances[0] == d_string_distance(long_query,
+                                           candidates[0]))     &&
+        (distances[1] == 80),
+        "queries over 64 bytes should be scored one by one");
+
+    // test: parameter validation
+    group->elements[idx++] = D_ASSERT_TRUE(
+        "batch_null_array",
+        (d_string_distance_batch(query, NULL, 3, 2, distances) == SIZE_MAX) &&
+        (d_string_distance_batch(query, NULL, 0, 2, NULL) == 0),
+        "a NULL array should only be accepted with a count of 0");
+
+    for (i = 0; i < 10; i++)
+    {
+        d_string_free(candidates[i]);
+    }
+
+    d_string_free(long_query);
+    d_string_free(query);
+
+    return group;
+}
+
+/*
+d_tests_sa_dstring_distance_all
+  Runs all edit distance tests for dstring module.
+  Tests the following:
+  - pairwise distance
+  - bounded distance
+  - batch scoring
+*/
+struct d_test_object*
+d_tests_sa_dstring_distance_all
+(
+    void
+)
+{
+    struct d_test_object* group;
+    size_t                idx;
+
+    group = d_test_object_new_interior("Edit Distance Functions", 3);
+
+    if (!group)
+    {
+        return NULL;
+    }
+
+    idx = 0;
+
+    group->elements[idx++] = d_tests_sa_dstring_distance();
+    group->elements[idx++] = d_tests_sa_dstring_distance_bounded();
+    group->elements[idx++] = d_tests_sa_dstring_distance_batch();
+
+    return group;
+}
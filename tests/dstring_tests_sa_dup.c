@@ -786,6 +786,167 @@ d_tests_sa_dstring_substr
 }
 
 
+/******************************************************************************
+* d_tests_sa_dstring_dup_shared
+******************************************************************************/
+
+/*
+d_tests_sa_dstring_dup_shared
+  Tests that copies of long strings share one buffer until written.
+  Tests the following:
+  - d_string_dup of a long string shares the original's buffer
+  - short strings are copied rather than shared
+  - modifying a copy gives it a private buffer and leaves the original intact
+  - the original can be freed before its copy
+  - d_string_assign and d_string_copy_s share long sources
+  - d_string_data unshares before returning a writable pointer
+  - d_string_clear drops a shared buffer without touching the other owner
+  - d_string_reserve on a shared string moves it to a buffer of its own
+*/
+struct d_test_object*
+d_tests_sa_dstring_dup_shared
+(
+    void
+)
+{
+    struct d_test_object* group;
+    struct d_string*      original;
+    struct d_string*      copy;
+    struct d_string*      other;
+    char                  text[D_STRING_SHARE_THRESHOLD + 64];
+    size_t                len;
+    bool                  result;
+    size_t                idx;
+
+    group = d_test_object_new_interior("d_string_dup_shared", 9);
+
+    if (!group)
+    {
+        return NULL;
+    }
+
+    idx = 0;
+    len = sizeof(text) - 1;
+    memset(text, 'x', len);
+    text[len] = '\0';
+
+    // test: d_string_dup of a long string shares the buffer
+    original = d_string_new_from_cstr(text);
+    copy     = d_string_dup(original);
+    result   = (copy != NULL)                  &&
+               (copy->text == original->text)  &&
+               d_string_is_shared(original)    &&
+               d_string_is_shared(copy)        &&
+               d_string_equals(copy, original);
+    group->elements[idx++] = D_ASSERT_TRUE(
+        "dup_shared_long",
+        result,
+        "long copies should share the original's buffer");
+
+    // test: short strings are copied rather than shared
+    other  = d_string_new_from_cstr("short");
+    d_string_free(copy);
+    copy   = d_string_dup(other);
+    result = (copy != NULL)              &&
+             (copy->text != other->text) &&
+             (!d_string_is_shared(other));
+    group->elements[idx++] = D_ASSERT_TRUE(
+        "dup_shared_short_copied",
+        result,
+        "short strings should be copied");
+    d_string_free(copy);
+    d_string_free(other);
+
+    // test: modifying a copy unshares it and leaves the original intact
+    copy   = d_string_dup(original);
+    result = d_string_append_char(copy, 'y')        &&
+             (copy->text != original->text)         &&
+             (!d_string_is_shared(original))        &&
+             (original->size == len)                &&
+             (strcmp(original->text, text) == 0)    &&
+             (copy->size == len + 1)                &&
+             (copy->text[len] == 'y');
+    group->elements[idx++] = D_ASSERT_TRUE(
+        "dup_shared_write_unshares",
+        result,
+        "writing a copy should not affect the original");
+    d_string_free(copy);
+
+    // test: the original can be freed before its copy
+    copy = d_string_dup(original);
+    d_string_free(original);
+    result = (copy != NULL)                  &&
+             (!d_string_is_shared(copy))     &&
+             (strcmp(copy->text, text) == 0);
+    group->elements[idx++] = D_ASSERT_TRUE(
+        "dup_shared_free_original_first",
+        result,
+        "a copy should outlive its original");
+    original = copy;
+
+    // test: d_string_assign shares long sources
+    other  = d_string_new_from_cstr("previous contents");
+    result = d_string_assign(other, original) &&
+             (other->text == original->text)  &&
+             d_string_equals(other, original);
+    group->elements[idx++] = D_ASSERT_TRUE(
+        "dup_shared_assign",
+        result,
+        "assigning a long string should share its buffer");
+    d_string_free(other);
+
+    // test: d_string_copy_s shares long sources
+    other  = d_string_new_with_capacity(1024);
+    result = (d_string_copy_s(other, original) == 0) &&
+             (other->text == original->text);
+    group->elements[idx++] = D_ASSERT_TRUE(
+        "dup_shared_copy_s",
+        result,
+        "d_string_copy_s of a long string should share its buffer");
+
+    // test: d_string_data unshares before returning a writable pointer
+    result = (d_string_data(other) != original->text) &&
+             (!d_string_is_shared(original));
+    if (result)
+    {
+        d_string_data(other)[0] = 'z';
+        result = (original->text[0] == 'x');
+    }
+    group->elements[idx++] = D_ASSERT_TRUE(
+        "dup_shared_data_unshares",
+        result,
+        "d_string_data should return a private buffer");
+    d_string_free(other);
+
+    // test: d_string_clear drops a shared buffer
+    copy = d_string_dup(original);
+    d_string_clear(copy);
+    result = (copy->size == 0)                 &&
+             (!d_string_is_shared(original))   &&
+             (strcmp(original->text, text) == 0);
+    group->elements[idx++] = D_ASSERT_TRUE(
+        "dup_shared_clear",
+        result,
+        "clearing a copy should leave the original intact");
+    d_string_free(copy);
+
+    // test: d_string_reserve moves a shared string to its own buffer
+    copy   = d_string_dup(original);
+    result = d_string_reserve(copy, len * 4)       &&
+             (copy->text != original->text)        &&
+             (copy->capacity >= len * 4)           &&
+             (!d_string_is_shared(original))       &&
+             d_string_equals(copy, original);
+    group->elements[idx++] = D_ASSERT_TRUE(
+        "dup_shared_reserve",
+        result,
+        "growing a copy should give it its own buffer");
+    d_string_free(copy);
+    d_string_free(original);
+
+    return group;
+}
+
 /******************************************************************************
 * d_tests_sa_dstring_dup_all
 ******************************************************************************/
@@ -809,7 +970,7 @@ d_tests_sa_dstring_dup_all
     struct d_test_object* group;
     size_t                child_idx;
 
-    group     = d_test_object_new_interior("d_string Duplication Functions", 3);
+    group     = d_test_object_new_interior("d_string Duplication Functions", 4);
     child_idx = 0;
 
     if (!group)
@@ -821,6 +982,7 @@ d_tests_sa_dstring_dup_all
     group->elements[child_idx++] = d_tests_sa_dstring_dup();
     group->elements[child_idx++] = d_tests_sa_dstring_ndup();
     group->elements[child_idx++] = d_tests_sa_dstring_substr();
+    group->elements[child_idx++] = d_tests_sa_dstring_dup_shared();
 
     return group;
 }
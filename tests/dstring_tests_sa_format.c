@@ -160,6 +160,7 @@ d_tests_sa_dstring_sprintf
   - formatting with multiple specifiers
   - NULL destination handling
   - NULL format string handling
+  - a rejected call leaves a shared buffer and its cached hash alone
 */
 struct d_test_object*
 d_tests_sa_dstring_sprintf
@@ -169,10 +170,12 @@ d_tests_sa_dstring_sprintf
 {
     struct d_test_object* group;
     struct d_string*      dest;
+    struct d_string*      original;
+    char                  text[D_STRING_SHARE_THRESHOLD + 64];
     bool                  result;
     size_t                idx;
 
-    group = d_test_object_new_interior("d_string_sprintf", 7);
+    group = d_test_object_new_interior("d_string_sprintf", 8);
 
     if (!group)
     {
@@ -303,6 +306,208 @@ d_tests_sa_dstring_sprintf
 
     d_string_free(dest);
 
+    // test: a rejected call leaves a shared buffer and its cached hash alone
+    memset(text, 'x', sizeof(text) - 1);
+    text[sizeof(text) - 1] = '\0';
+    original = d_string_new_from_cstr(text);
+
+    if (original)
+    {
+        d_string_hash_cached(original);
+    }
+
+    dest = d_string_dup(original);
+    group->elements[idx++] = D_ASSERT_TRUE(
+        "sprintf_rejected_untouched",
+        (dest != NULL) &&
+        (d_string_sprintf(dest, NULL) == -1) &&
+        (dest->text == original->text) &&
+        d_string_is_shared(dest) &&
+        (dest->flags & D_STRING_FLAG_HASHED),
+        "a NULL format should neither unshare nor drop the hash");
+
+    d_string_free(dest);
+    d_string_free(original);
+
+    return group;
+}
+
+
+/*
+d_tests_sa_dstring_format_matches
+  Helper: formats with both d_string_vprintf and vsnprintf, returning true
+if the results are identical.
+*/
+static bool
+d_tests_sa_dstring_format_matches
+(
+    const char* _format,
+    ...
+)
+{
+    va_list          args;
+    va_list          args_copy;
+    struct d_string* result;
+    char             expected[2048];
+    int              len;
+    bool             matches;
+
+    va_start(args, _format);
+    va_copy(args_copy, args);
+
+    len    = vsnprintf(expected, sizeof(expected), _format, args);
+    result = d_string_vprintf(_format, args_copy);
+
+    va_end(args_copy);
+    va_end(args);
+
+    matches = ( (result != NULL) &&
+                (len >= 0)       &&
+                (result->size == (size_t)len) &&
+                (strcmp(result->text, expected) == 0) );
+
+    d_string_free(result);
+
+    return matches;
+}
+
+/*
+d_tests_sa_dstring_format_engine
+  Tests the single-pass formatting engine behind the d_string formatting
+functions against the C library's vsnprintf.
+  Tests the following:
+  - integer fast paths, including extremes, widths and length modifiers
+  - hexadecimal and octal, including alternate forms
+  - string and character fast paths, with precision and justification
+  - conversions delegated to libc (floating point, pointers, signs)
+  - %% and %n
+  - positional arguments
+  - output that overflows spare capacity mid-format
+  - appending to an existing string
+*/
+struct d_test_object*
+d_tests_sa_dstring_format_engine
+(
+    void
+)
+{
+    struct d_test_object* group;
+    struct d_string*      dest;
+    char                  big[300];
+    int                   count;
+    bool                  result;
+    size_t                idx;
+
+    group = d_test_object_new_interior("d_string_format_engine", 8);
+
+    if (!group)
+    {
+        return NULL;
+    }
+
+    idx = 0;
+
+    // test: integer fast paths
+    result = d_tests_sa_dstring_format_matches("%d|%i|%u|%d|%d",
+                                               0, -7, 4000000000u,
+                                               INT_MIN, INT_MAX);
+    result = result && d_tests_sa_dstring_format_matches(
+        "%lld|%llu|%zu|%ld|%hd|%hhu|%jd",
+        LLONG_MIN, ULLONG_MAX, (size_t)SIZE_MAX, -123456789L,
+        (int)-32768, 300, (intmax_t)-1);
+    result = result && d_tests_sa_dstring_format_matches(
+        "[%5d][%-5d][%05d][%05d][%*d][%-*d][%1d]",
+        42, 42, 42, -42, 6, -3, -6, 9, 12345);
+    group->elements[idx++] = D_ASSERT_TRUE(
+        "engine_integers",
+        result,
+        "integer conversions should match vsnprintf");
+
+    // test: hexadecimal and octal
+    result = d_tests_sa_dstring_format_matches(
+        "%x|%X|%08x|%-6X|%o|%llx|%zx|%#x|%#o|%.4x",
+        0xdeadbeefu, 0xabcu, 0x1fu, 0xffu, 8u,
+        0x0123456789abcdefULL, (size_t)255, 255u, 8u, 0x1u);
+    group->elements[idx++] = D_ASSERT_TRUE(
+        "engine_hex_octal",
+        result,
+        "hex and octal conversions should match vsnprintf");
+
+    // test: strings and characters
+    result = d_tests_sa_dstring_format_matches(
+        "%s|%.3s|%5s|%-5s|%.*s|%c|%3c|%-3c|%s",
+        "hello", "hello", "ab", "ab", 2, "xyz", 'q', 'r', 's', "");
+    group->elements[idx++] = D_ASSERT_TRUE(
+        "engine_strings",
+        result,
+        "string and character conversions should match vsnprintf");
+
+    // test: delegated conversions
+    result = d_tests_sa_dstring_format_matches(
+        "%f|%.2f|%e|%g|%10.3f|%p|%+d|% d|%.5d|%Lf",
+        3.14159, 2.5, 12345.678, 0.0001, -1.5, (void*)&idx,
+        5, 5, 42, (long double)1.25);
+    group->elements[idx++] = D_ASSERT_TRUE(
+        "engine_delegated",
+        result,
+        "libc-delegated conversions should match vsnprintf");
+
+    // test: %% and %n
+    count  = -1;
+    dest   = d_string_printf("100%% done%n!", &count);
+    result = ( (dest != NULL) &&
+               d_string_equals_cstr(dest, "100% done!") &&
+               (count == 9) );
+    group->elements[idx++] = D_ASSERT_TRUE(
+        "engine_percent_n",
+        result,
+        "percent escapes and count stores should behave like printf");
+
+    d_string_free(dest);
+
+    // test: positional arguments
+    result = d_tests_sa_dstring_format_matches("%2$s-%1$d", 7, "seven");
+    group->elements[idx++] = D_ASSERT_TRUE(
+        "engine_positional",
+        result,
+        "positional arguments should match vsnprintf");
+
+    // test: output overflowing spare capacity
+    d_memset(big, 'z', sizeof(big) - 1);
+    big[sizeof(big) - 1] = '\0';
+
+    result = d_tests_sa_dstring_format_matches(
+        "%s|%d|%s|%300d|%-300s|%f",
+        big, 1, big, 2, "x", 1e100);
+    group->elements[idx++] = D_ASSERT_TRUE(
+        "engine_growth",
+        result,
+        "output larger than spare capacity should be grown into");
+
+    // test: appending keeps the existing contents
+    dest = d_string_new_from_cstr("key");
+
+    if (dest)
+    {
+        result = ( d_string_append_formatted(dest, "=%d;", 1) &&
+                   d_string_append_formatted(dest, "%s=%zu", "n", (size_t)2) &&
+                   d_string_equals_cstr(dest, "key=1;n=2") &&
+                   (dest->size == 9) );
+        group->elements[idx++] = D_ASSERT_TRUE(
+            "engine_append",
+            result,
+            "formatted appends should extend the existing text");
+
+        d_string_free(dest);
+    }
+    else
+    {
+        group->elements[idx++] = D_ASSERT_TRUE(
+            "engine_append",
+            false,
+            "failed to allocate test string");
+    }
+
     return group;
 }
 
@@ -318,6 +523,7 @@ d_tests_sa_dstring_format_all
   - printf function (creates new formatted d_string)
   - vprintf function (creates new d_string from va_list)
   - sprintf function (writes formatted string to existing d_string)
+  - the single-pass formatting engine, against vsnprintf
 */
 struct d_test_object*
 d_tests_sa_dstring_format_all
@@ -328,7 +534,7 @@ d_tests_sa_dstring_format_all
     struct d_test_object* group;
     size_t                idx;
 
-    group = d_test_object_new_interior("Formatted String Functions", 3);
+    group = d_test_object_new_interior("Formatted String Functions", 4);
 
     if (!group)
     {
@@ -340,6 +546,7 @@ d_tests_sa_dstring_format_all
     group->elements[idx++] = d_tests_sa_dstring_printf();
     group->elements[idx++] = d_tests_sa_dstring_vprintf();
     group->elements[idx++] = d_tests_sa_dstring_sprintf();
+    group->elements[idx++] = d_tests_sa_dstring_format_engine();
 
     return group;
 }
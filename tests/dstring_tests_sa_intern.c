@@ -0,0 +1,423 @@
+#include ".\dstring_tests_sa.h"
+#include "..\inc\dmutex.h"
+
+
+/******************************************************************************
+ * SECTION 20: STRING INTERNING FUNCTIONS
+ *****************************************************************************/
+
+// D_TEST_DSTRING_INTERN_KEYS
+//   constant: number of distinct keys used by the bulk interning tests.
+#define D_TEST_DSTRING_INTERN_KEYS    2000
+
+// D_TEST_DSTRING_INTERN_THREADS
+//   constant: number of threads used by the concurrent interning test.
+#define D_TEST_DSTRING_INTERN_THREADS 4
+
+// d_tests_sa_dstring_intern_thread_data
+//   struct: per-thread state for the concurrent interning test.
+struct d_tests_sa_dstring_intern_thread_data
+{
+    struct d_string_intern_table* table;
+    const struct d_string*        handles[D_TEST_DSTRING_INTERN_KEYS];
+    unsigned                      offset;
+};
+
+/*
+d_tests_sa_dstring_intern_thread_func
+  Interns every test key, starting at a per-thread offset so threads race to
+insert different keys first.
+*/
+static d_thread_result_t
+d_tests_sa_dstring_intern_thread_func
+(
+    void* _arg
+)
+{
+    struct d_tests_sa_dstring_intern_thread_data* data;
+    char                                          key[32];
+    unsigned                                      i;
+    unsigned                                      k;
+
+    data = (struct d_tests_sa_dstring_intern_thread_data*)_arg;
+
+    for (i = 0; i < D_TEST_DSTRING_INTERN_KEYS; i++)
+    {
+        k = (i + data->offset) % D_TEST_DSTRING_INTERN_KEYS;
+        snprintf(key, sizeof(key), "identifier_%u", k);
+        data->handles[k] = d_string_intern_cstr(data->table, key);
+    }
+
+#if D_MUTEX_HAS_C11_THREADS
+    return 0;
+#else
+    return NULL;
+#endif
+}
+
+/*
+d_tests_sa_dstring_intern_basic
+  Tests d_string_intern_buffer, d_string_intern_cstr, d_string_intern_string,
+d_string_intern_view and d_string_intern_find.
+  Tests the following:
+  - equal content yields the same handle
+  - different content yields different handles
+  - handle holds a null-terminated copy of the content
+  - long and binary content are interned intact
+  - string and view interning share handles with cstr interning
+  - find returns existing handles and never interns
+*/
+struct d_test_object*
+d_tests_sa_dstring_intern_basic
+(
+    void
+)
+{
+    struct d_test_object*         group;
+    struct d_string_intern_table* table;
+    struct d_string*              str;
+    const struct d_string*        a;
+    const struct d_string*        b;
+    const struct d_string*        c;
+    char                          scratch[8];
+    char                          long_text[100];
+    size_t                        idx;
+
+    group = d_test_object_new_interior("d_string_intern basics", 6);
+
+    if (!group)
+    {
+        return NULL;
+    }
+
+    idx   = 0;
+    table = d_string_intern_table_new();
+    str   = d_string_new_from_cstr("shared");
+
+    if ( (!table) ||
+         (!str) )
+    {
+        while (idx < 6)
+        {
+            group->elements[idx++] = D_ASSERT_TRUE(
+                "intern_alloc", false,
+                "failed to allocate test table");
+        }
+
+        d_string_intern_table_free(table);
+        d_string_free(str);
+
+        return group;
+    }
+
+    // test: equal content yields the same handle
+    d_memcpy(scratch, "shared", 7);
+    a = d_string_intern_cstr(table, "shared");
+    b = d_string_intern_cstr(table, scratch);
+
+    group->elements[idx++] = D_ASSERT_TRUE(
+        "same_content_same_handle",
+        a && (a == b),
+        "interning equal content twice should return one handle");
+
+    // test: different content yields different handles
+    c = d_string_intern_cstr(table, "Shared");
+
+    group->elements[idx++] = D_ASSERT_TRUE(
+        "different_content",
+        c && (c != a),
+        "content differing in case should get its own handle");
+
+    // test: handle holds a null-terminated copy of the content
+    group->elements[idx++] = D_ASSERT_TRUE(
+        "handle_content",
+        a && (a->size == 6) && (strcmp(a->text, "shared") == 0) &&
+        (a->text != scratch),
+        "handle should own a null-terminated copy of 'shared'");
+
+    // test: long and binary content are interned intact
+    d_memset(long_text, 'x', sizeof(long_text));
+    a = d_string_intern_buffer(table, long_text, sizeof(long_text));
+    b = d_string_intern_buffer(table, "a\0b", 3);
+
+    group->elements[idx++] = D_ASSERT_TRUE(
+        "long_and_binary",
+        a && (a->size == sizeof(long_text)) &&
+        (memcmp(a->text, long_text, sizeof(long_text)) == 0) &&
+        (a->text[sizeof(long_text)] == '\0') &&
+        b && (b->size == 3) && (memcmp(b->text, "a\0b", 4) == 0) &&
+        (b != d_string_intern_cstr(table, "a")),
+        "long and embedded-null content should be stored exactly");
+
+    // test: string and view interning share handles with cstr interning
+    a = d_string_intern_cstr(table, "shared");
+
+    group->elements[idx++] = D_ASSERT_TRUE(
+        "string_and_view",
+        (d_string_intern_string(table, str) == a) &&
+        (d_string_intern_view(table,
+                              d_string_view_make("unshared", 6)) != a) &&
+        (d_string_intern_view(table,
+                              d_string_view_make("sharedness", 6)) == a),
+        "d_string and view interning should canonicalize identically");
+
+    // test: find returns existing handles and never interns
+    group->elements[idx++] = D_ASSERT_TRUE(
+        "find",
+        (d_string_intern_find(table, "shared", 6) == a) &&
+        (d_string_intern_find(table, "absent", 6) == NULL) &&
+        (d_string_intern_find(table, "absent", 6) == NULL),
+        "find should return the handle, or NULL without interning");
+
+    d_string_free(str);
+    d_string_intern_table_free(table);
+
+    return group;
+}
+
+/*
+d_tests_sa_dstring_intern_bulk
+  Tests interning many distinct strings and d_string_intern_stats.
+  Tests the following:
+  - handles stay stable while the index grows
+  - count reports the distinct strings
+  - stats count lookups and hits
+  - stats report the memory saved by hits
+  - NULL parameters are rejected
+*/
+struct d_test_object*
+d_tests_sa_dstring_intern_bulk
+(
+    void
+)
+{
+    struct d_test_object*         group;
+    struct d_string_intern_table* table;
+    struct d_string_intern_stats  stats;
+    const struct d_string**       handles;
+    char                          key[32];
+    bool                          stable;
+    size_t                        i;
+    size_t                        idx;
+
+    group = d_test_object_new_interior("d_string_intern bulk and stats", 5);
+
+    if (!group)
+    {
+        return NULL;
+    }
+
+    idx     = 0;
+    table   = d_string_intern_table_new();
+    handles = malloc(D_TEST_DSTRING_INTERN_KEYS * sizeof(*handles));
+
+    if ( (!table) ||
+         (!handles) )
+    {
+        while (idx < 5)
+        {
+            group->elements[idx++] = D_ASSERT_TRUE(
+                "intern_alloc", false,
+                "failed to allocate test table");
+        }
+
+        d_string_intern_table_free(table);
+        free(handles);
+
+        return group;
+    }
+
+    for (i = 0; i < D_TEST_DSTRING_INTERN_KEYS; i++)
+    {
+        snprintf(key, sizeof(key), "key_%zu", i);
+        handles[i] = d_string_intern_cstr(table, key);
+    }
+
+    // test: handles stay stable while the index grows
+    stable = true;
+
+    for (i = 0; i < D_TEST_DSTRING_INTERN_KEYS; i++)
+    {
+        snprintf(key, sizeof(key), "key_%zu", i);
+
+        if ( (handles[i] == NULL) ||
+             (d_string_intern_cstr(table, key) != handles[i]) ||
+             (strcmp(handles[i]->text, key) != 0) )
+        {
+            stable = false;
+        }
+    }
+
+    group->elements[idx++] = D_ASSERT_TRUE(
+        "handles_stable",
+        stable,
+        "every key should map to its original handle after growth");
+
+    // test: count reports the distinct strings
+    group->elements[idx++] = D_ASSERT_EQUAL(
+        "count",
+        d_string_intern_count(table), D_TEST_DSTRING_INTERN_KEYS,
+        "count should equal the number of distinct keys");
+
+    // test: stats count lookups and hits
+    group->elements[idx++] = D_ASSERT_TRUE(
+        "stats_lookups",
+        d_string_intern_stats(table, &stats) &&
+        (stats.strings == D_TEST_DSTRING_INTERN_KEYS) &&
+        (stats.lookups == (2 * D_TEST_DSTRING_INTERN_KEYS)) &&
+        (stats.hits == D_TEST_DSTRING_INTERN_KEYS),
+        "each key was looked up twice and hit once");
+
+    // test: stats report the memory saved by hits
+    group->elements[idx++] = D_ASSERT_TRUE(
+        "stats_saved",
+        (stats.bytes_saved >=
+            (D_TEST_DSTRING_INTERN_KEYS * sizeof(struct d_string))) &&
+        (stats.bytes_interned > 0) &&
+        (stats.bytes_reserved >= stats.bytes_interned),
+        "each hit should save at least one d_string struct");
+
+    // test: NULL parameters are rejected
+    group->elements[idx++] = D_ASSERT_TRUE(
+        "null_params",
+        (d_string_intern_cstr(NULL, "x") == NULL) &&
+        (d_string_intern_cstr(table, NULL) == NULL) &&
+        (d_string_intern_buffer(table, NULL, 1) == NULL) &&
+        (d_string_intern_string(table, NULL) == NULL) &&
+        !d_string_intern_stats(table, NULL) &&
+        (d_string_intern_count(NULL) == 0),
+        "NULL table or content should be rejected");
+
+    free(handles);
+    d_string_intern_table_free(table);
+    d_string_intern_table_free(NULL);
+
+    return group;
+}
+
+/*
+d_tests_sa_dstring_intern_threads
+  Tests concurrent interning from several threads.
+  Tests the following:
+  - every thread receives the same handle for each key
+  - each key is interned exactly once
+*/
+struct d_test_object*
+d_tests_sa_dstring_intern_threads
+(
+    void
+)
+{
+    struct d_test_object*                         group;
+    struct d_string_intern_table*                 table;
+    struct d_tests_sa_dstring_intern_thread_data* data;
+    d_thread_t                                    threads[D_TEST_DSTRING_INTERN_THREADS];
+    bool                                          agree;
+    size_t                                        i;
+    size_t                                        k;
+    size_t                                        idx;
+
+    group = d_test_object_new_interior("d_string_intern concurrency", 2);
+
+    if (!group)
+    {
+        return NULL;
+    }
+
+    idx   = 0;
+    table = d_string_intern_table_new();
+    data  = calloc(D_TEST_DSTRING_INTERN_THREADS, sizeof(*data));
+
+    if ( (!table) ||
+         (!data) )
+    {
+        group->elements[idx++] = D_ASSERT_TRUE(
+            "threads_agree", false, "failed to allocate test table");
+        group->elements[idx++] = D_ASSERT_TRUE(
+            "threads_count", false, "failed to allocate test table");
+
+        d_string_intern_table_free(table);
+        free(data);
+
+        return group;
+    }
+
+    for (i = 0; i < D_TEST_DSTRING_INTERN_THREADS; i++)
+    {
+        data[i].table  = table;
+        data[i].offset = (unsigned)(i * (D_TEST_DSTRING_INTERN_KEYS /
+                                         D_TEST_DSTRING_INTERN_THREADS));
+        d_thread_create(&threads[i],
+                        d_tests_sa_dstring_intern_thread_func,
+                        &data[i]);
+    }
+
+    for (i = 0; i < D_TEST_DSTRING_INTERN_THREADS; i++)
+    {
+        d_thread_join(threads[i], NULL);
+    }
+
+    // test: every thread receives the same handle for each key
+    agree = true;
+
+    for (k = 0; k < D_TEST_DSTRING_INTERN_KEYS; k++)
+    {
+        for (i = 0; i < D_TEST_DSTRING_INTERN_THREADS; i++)
+        {
+            if ( (data[i].handles[k] == NULL) ||
+                 (data[i].handles[k] != data[0].handles[k]) )
+            {
+                agree = false;
+            }
+        }
+    }
+
+    group->elements[idx++] = D_ASSERT_TRUE(
+        "threads_agree",
+        agree,
+        "all threads should receive identical handles");
+
+    // test: each key is interned exactly once
+    group->elements[idx++] = D_ASSERT_EQUAL(
+        "threads_count",
+        d_string_intern_count(table), D_TEST_DSTRING_INTERN_KEYS,
+        "racing inserts should not create duplicates");
+
+    free(data);
+    d_string_intern_table_free(table);
+
+    return group;
+}
+
+/*
+d_tests_sa_dstring_intern_all
+  Runs all string interning tests for dstring module.
+  Tests the following:
+  - handle identity, content, and find
+  - bulk interning, growth and statistics
+  - concurrent interning
+*/
+struct d_test_object*
+d_tests_sa_dstring_intern_all
+(
+    void
+)
+{
+    struct d_test_object* group;
+    size_t                idx;
+
+    group = d_test_object_new_interior("String Interning Functions", 3);
+
+    if (!group)
+    {
+        return NULL;
+    }
+
+    idx = 0;
+
+    group->elements[idx++] = d_tests_sa_dstring_intern_basic();
+    group->elements[idx++] = d_tests_sa_dstring_intern_bulk();
+    group->elements[idx++] = d_tests_sa_dstring_intern_threads();
+
+    return group;
+}
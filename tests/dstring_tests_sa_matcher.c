@@ -0,0 +1,367 @@
+#include ".\dstring_tests_sa.h"
+
+
+/******************************************************************************
+ * SECTION 21: MULTI-PATTERN MATCHING FUNCTIONS
+ *****************************************************************************/
+
+/*
+d_tests_sa_dstring_matcher_find
+  Tests d_string_matcher_new, d_string_matcher_contains and
+d_string_matcher_find_first.
+  Tests the following:
+  - building a matcher records its pattern count
+  - contains detects a pattern anywhere and rejects text without one
+  - find_first reports the leftmost match
+  - find_first prefers the longest pattern at the leftmost position
+  - a longer pattern starting earlier beats a shorter one ending earlier
+  - case-insensitive matchers ignore ASCII case
+  - empty and NULL patterns are rejected
+*/
+struct d_test_object*
+d_tests_sa_dstring_matcher_find
+(
+    void
+)
+{
+    static const char* const patterns[] = { "he", "she", "his", "hers" };
+    static const char* const nested[]   = { "bc", "abcd" };
+    static const char* const empty[]    = { "ok", "" };
+    struct d_test_object*    group;
+    struct d_string_matcher* matcher;
+    struct d_string_match    match;
+    bool                     result;
+    size_t                   idx;
+
+    group = d_test_object_new_interior("d_string_matcher_find", 7);
+
+    if (!group)
+    {
+        return NULL;
+    }
+
+    idx     = 0;
+    matcher = d_string_matcher_new(patterns, 4, 0);
+
+    // test: building a matcher records its pattern count
+    group->elements[idx++] = D_ASSERT_TRUE(
+        "matcher_new",
+        (matcher != NULL) && (d_string_matcher_pattern_count(matcher) == 4),
+        "matcher should be built from all patterns");
+
+    // test: contains detects a pattern anywhere and rejects text without one
+    group->elements[idx++] = D_ASSERT_TRUE(
+        "matcher_contains",
+        d_string_matcher_contains(matcher,
+                                  d_string_view_from_cstr("xx ushers xx")) &&
+        !d_string_matcher_contains(matcher,
+                                   d_string_view_from_cstr("plain text")),
+        "contains should report whether any pattern occurs");
+
+    // test: find_first reports the leftmost match
+    result = d_string_matcher_find_first(matcher,
+                                         d_string_view_from_cstr("this is his"),
+                                         &match);
+    group->elements[idx++] = D_ASSERT_TRUE(
+        "matcher_first_leftmost",
+        result && (match.position == 1) && (match.pattern == 2),
+        "find_first should report the leftmost match");
+
+    // test: find_first prefers the longest pattern at the leftmost position
+    result = d_string_matcher_find_first(matcher,
+                                         d_string_view_from_cstr("ushers"),
+                                         &match);
+    group->elements[idx++] = D_ASSERT_TRUE(
+        "matcher_first_longest",
+        result && (match.position == 1) && (match.length == 3) &&
+        (match.pattern == 1),
+        "find_first should report the longest match at the leftmost start");
+
+    d_string_matcher_free(matcher);
+
+    // test: a longer pattern starting earlier beats a shorter one ending
+    // earlier
+    matcher = d_string_matcher_new(nested, 2, 0);
+    result  = d_string_matcher_find_first(matcher,
+                                          d_string_view_from_cstr("xabcdx"),
+                                          &match);
+    group->elements[idx++] = D_ASSERT_TRUE(
+        "matcher_first_nested",
+        result && (match.position == 1) && (match.pattern == 1),
+        "an earlier-starting match should win over an earlier-ending one");
+
+    d_string_matcher_free(matcher);
+
+    // test: case-insensitive matchers ignore ASCII case
+    matcher = d_string_matcher_new(patterns, 4, D_STRING_MATCHER_IGNORE_CASE);
+    result  = d_string_matcher_find_first(matcher,
+                                          d_string_view_from_cstr("USHERS"),
+                                          &match);
+    group->elements[idx++] = D_ASSERT_TRUE(
+        "matcher_ignore_case",
+        result && (match.position == 1) && (match.pattern == 1),
+        "case-insensitive matcher should match regardless of case");
+
+    d_string_matcher_free(matcher);
+
+    // test: empty and NULL patterns are rejected
+    group->elements[idx++] = D_ASSERT_TRUE(
+        "matcher_invalid_patterns",
+        (d_string_matcher_new(empty, 2, 0) == NULL) &&
+        (d_string_matcher_new(NULL, 1, 0) == NULL),
+        "empty or NULL patterns should be rejected");
+
+    return group;
+}
+
+/*
+d_tests_sa_dstring_matcher_find_all
+  Tests d_string_matcher_find_all.
+  Tests the following:
+  - overlapping and nested matches are all reported
+  - matches are ordered by end position, longest first
+  - text without matches yields no array
+  - many patterns are found in one pass
+*/
+struct d_test_object*
+d_tests_sa_dstring_matcher_find_all
+(
+    void
+)
+{
+    static const char* const patterns[] = { "he", "she", "his", "hers" };
+    struct d_test_object*    group;
+    struct d_string_matcher* matcher;
+    struct d_string_match*   matches;
+    struct d_string*         text;
+    const char*              keys[100];
+    char                     storage[100][8];
+    size_t                   count;
+    size_t                   i;
+    bool                     result;
+    size_t                   idx;
+
+    group = d_test_object_new_interior("d_string_matcher_find_all", 4);
+
+    if (!group)
+    {
+        return NULL;
+    }
+
+    idx     = 0;
+    matcher = d_string_matcher_new(patterns, 4, 0);
+
+    // test: overlapping and nested matches are all reported
+    count = d_string_matcher_find_all(matcher,
+                                      d_string_view_from_cstr("ushers"),
+                                      &matches);
+    group->elements[idx++] = D_ASSERT_TRUE(
+        "find_all_overlapping",
+        (count == 3) && (matches != NULL),
+        "she, he and hers should all be found in 'ushers'");
+
+    // test: matches are ordered by end position, longest first
+    result = (count == 3) && (matches != NULL) &&
+             (matches[0].pattern == 1) && (matches[0].position == 1) &&
+             (matches[1].pattern == 0) && (matches[1].position == 2) &&
+             (matches[2].pattern == 3) && (matches[2].position == 2);
+    group->elements[idx++] = D_ASSERT_TRUE(
+        "find_all_order",
+        result,
+        "matches should be ordered by end position, longest first");
+
+    free(matches);
+
+    // test: text without matches yields no array
+    count = d_string_matcher_find_all(matcher,
+                                      d_string_view_from_cstr("xyz"),
+                                      &matches);
+    group->elements[idx++] = D_ASSERT_TRUE(
+        "find_all_none",
+        (count == 0) && (matches == NULL),
+        "no matches should give a count of 0 and a NULL array");
+
+    d_string_matcher_free(matcher);
+
+    // test: many patterns are found in one pass
+    for (i = 0; i < 100; i++)
+    {
+        snprintf(storage[i], sizeof(storage[i]), "k%03zu;", i);
+        keys[i] = storage[i];
+    }
+
+    matcher = d_string_matcher_new(keys, 100, 0);
+    text    = d_string_new();
+    result  = (matcher != NULL) && (text != NULL);
+
+    for (i = 0; result && (i < 100); i += 3)
+    {
+        result = d_string_append_cstr(text, "..") &&
+                 d_string_append_cstr(text, keys[99 - i]);
+    }
+
+    count  = result ? d_string_matcher_find_all(matcher,
+                                                d_string_view_of(text),
+                                                &matches)
+                    : 0;
+    result = result && (count == 34) && (matches[0].pattern == 99) &&
+             (matches[33].pattern == 0);
+    group->elements[idx++] = D_ASSERT_TRUE(
+        "find_all_many_patterns",
+        result,
+        "every occurrence of every pattern should be found");
+
+    free(matches);
+    d_string_free(text);
+    d_string_matcher_free(matcher);
+
+    return group;
+}
+
+/*
+d_tests_sa_dstring_replace_all_map
+  Tests d_string_replace_all_map and d_string_matcher_replace.
+  Tests the following:
+  - several patterns are replaced in one pass
+  - the longest pattern wins at a position
+  - replacement text is not rescanned
+  - strings without matches are unchanged
+  - a compiled matcher can be reused for replacement
+  - NULL and invalid arguments are rejected
+*/
+struct d_test_object*
+d_tests_sa_dstring_replace_all_map
+(
+    void
+)
+{
+    static const char* const old_words[] = { "cat", "dog", "catalog" };
+    static const char* const new_words[] = { "dog", "cat", "index" };
+    static const char* const swap_old[]  = { "a", "b" };
+    static const char* const swap_new[]  = { "b", "a" };
+    struct d_test_object*    group;
+    struct d_string_matcher* matcher;
+    struct d_string_view     replacements[2];
+    struct d_string*         str;
+    bool                     result;
+    size_t                   idx;
+
+    group = d_test_object_new_interior("d_string_replace_all_map", 6);
+
+    if (!group)
+    {
+        return NULL;
+    }
+
+    idx = 0;
+
+    // test: several patterns are replaced in one pass
+    str    = d_string_new_from_cstr("cat and dog");
+    result = str && d_string_replace_all_map(str, old_words, new_words, 3);
+    group->elements[idx++] = D_ASSERT_TRUE(
+        "map_replace_many",
+        result && d_string_equals_cstr(str, "dog and cat"),
+        "each pattern should be replaced by its own replacement");
+
+    d_string_free(str);
+
+    // test: the longest pattern wins at a position
+    str    = d_string_new_from_cstr("a catalog of cats");
+    result = str && d_string_replace_all_map(str, old_words, new_words, 3);
+    group->elements[idx++] = D_ASSERT_TRUE(
+        "map_replace_longest",
+        result && d_string_equals_cstr(str, "a index of dogs"),
+        "the longest pattern at a position should be replaced");
+
+    d_string_free(str);
+
+    // test: replacement text is not rescanned
+    str    = d_string_new_from_cstr("abba");
+    result = str && d_string_replace_all_map(str, swap_old, swap_new, 2);
+    group->elements[idx++] = D_ASSERT_TRUE(
+        "map_replace_no_rescan",
+        result && d_string_equals_cstr(str, "baab"),
+        "replacements should be applied simultaneously");
+
+    d_string_free(str);
+
+    // test: strings without matches are unchanged
+    str    = d_string_new_from_cstr("no animals");
+    result = str && d_string_replace_all_map(str, old_words, new_words, 3);
+    group->elements[idx++] = D_ASSERT_TRUE(
+        "map_replace_no_match",
+        result && d_string_equals_cstr(str, "no animals"),
+        "text without matches should be unchanged");
+
+    d_string_free(str);
+
+    // test: a compiled matcher can be reused for replacement
+    matcher         = d_string_matcher_new(swap_old, 2, D_STRING_MATCHER_IGNORE_CASE);
+    replacements[0] = d_string_view_from_cstr("<1>");
+    replacements[1] = d_string_view_from_cstr("");
+    str             = d_string_new_from_cstr("AbcaB");
+    result          = matcher && str &&
+                      d_string_matcher_replace(matcher, str, replacements) &&
+                      d_string_equals_cstr(str, "<1>c<1>");
+
+    d_string_assign_cstr(str, "bbb");
+    result = result &&
+             d_string_matcher_replace(matcher, str, replacements) &&
+             (str->size == 0);
+    group->elements[idx++] = D_ASSERT_TRUE(
+        "matcher_replace_reuse",
+        result,
+        "one matcher should serve repeated replacements");
+
+    d_string_free(str);
+    d_string_matcher_free(matcher);
+
+    // test: NULL and invalid arguments are rejected
+    str    = d_string_new_from_cstr("text");
+    result = !d_string_replace_all_map(NULL, old_words, new_words, 3) &&
+             !d_string_replace_all_map(str, NULL, new_words, 3) &&
+             !d_string_replace_all_map(str, old_words, NULL, 3) &&
+             !d_string_matcher_replace(NULL, str, replacements) &&
+             d_string_equals_cstr(str, "text");
+    group->elements[idx++] = D_ASSERT_TRUE(
+        "map_replace_null",
+        result,
+        "NULL arguments should be rejected without modifying the string");
+
+    d_string_free(str);
+
+    return group;
+}
+
+/*
+d_tests_sa_dstring_matcher_all
+  Runs all multi-pattern matching tests for dstring module.
+  Tests the following:
+  - matcher construction, contains and leftmost-longest search
+  - finding all matches in one pass
+  - one-pass multi-pattern replacement
+*/
+struct d_test_object*
+d_tests_sa_dstring_matcher_all
+(
+    void
+)
+{
+    struct d_test_object* group;
+    size_t                idx;
+
+    group = d_test_object_new_interior("Multi-Pattern Matching Functions", 3);
+
+    if (!group)
+    {
+        return NULL;
+    }
+
+    idx = 0;
+
+    group->elements[idx++] = d_tests_sa_dstring_matcher_find();
+    group->elements[idx++] = d_tests_sa_dstring_matcher_find_all();
+    group->elements[idx++] = d_tests_sa_dstring_replace_all_map();
+
+    return group;
+}
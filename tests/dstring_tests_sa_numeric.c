@@ -0,0 +1,502 @@
+#include ".\dstring_tests_sa.h"
+
+
+/******************************************************************************
+ * SECTION 22: NUMERIC CONVERSION FUNCTIONS
+ *****************************************************************************/
+
+/*
+d_tests_sa_dstring_to_integer
+  Tests d_string_to_int64, d_string_to_uint64 and their view variants.
+  Tests the following:
+  - signed values parse with an optional sign
+  - INT64_MIN and INT64_MAX parse; one past either is ERANGE
+  - UINT64_MAX parses; one past it is ERANGE
+  - leading zeros do not count towards the digit limit
+  - malformed text (empty, sign only, whitespace, trailing junk) is EINVAL
+  - a '-' sign is rejected for unsigned values
+  - views are parsed without needing a terminator
+  - the output is left unchanged on error
+*/
+struct d_test_object*
+d_tests_sa_dstring_to_integer
+(
+    void
+)
+{
+    struct d_test_object* group;
+    struct d_string*      str;
+    int64_t               i64;
+    uint64_t              u64;
+    bool                  result;
+    size_t                idx;
+
+    group = d_test_object_new_interior("d_string_to_integer", 8);
+
+    if (!group)
+    {
+        return NULL;
+    }
+
+    idx = 0;
+
+    // test: signed values parse with an optional sign
+    str    = d_string_new_from_cstr("-12345");
+    result = (d_string_to_int64(str, &i64) == 0) && (i64 == -12345);
+    d_string_assign_cstr(str, "+42");
+    result = result && (d_string_to_int64(str, &i64) == 0) && (i64 == 42);
+    group->elements[idx++] = D_ASSERT_TRUE(
+        "to_int64_signed",
+        result,
+        "signed decimal integers should parse");
+
+    // test: INT64_MIN and INT64_MAX parse; one past either is ERANGE
+    result = (d_string_view_to_int64(
+                  d_string_view_from_cstr("-9223372036854775808"),
+                  &i64) == 0) &&
+             (i64 == INT64_MIN) &&
+             (d_string_view_to_int64(
+                  d_string_view_from_cstr("9223372036854775807"),
+                  &i64) == 0) &&
+             (i64 == INT64_MAX) &&
+             (d_string_view_to_int64(
+                  d_string_view_from_cstr("9223372036854775808"),
+                  &i64) == ERANGE) &&
+             (d_string_view_to_int64(
+                  d_string_view_from_cstr("-9223372036854775809"),
+                  &i64) == ERANGE);
+    group->elements[idx++] = D_ASSERT_TRUE(
+        "to_int64_limits",
+        result,
+        "int64 limits should parse and values past them be ERANGE");
+
+    // test: UINT64_MAX parses; one past it is ERANGE
+    result = (d_string_view_to_uint64(
+                  d_string_view_from_cstr("18446744073709551615"),
+                  &u64) == 0) &&
+             (u64 == UINT64_MAX) &&
+             (d_string_view_to_uint64(
+                  d_string_view_from_cstr("18446744073709551616"),
+                  &u64) == ERANGE) &&
+             (d_string_view_to_uint64(
+                  d_string_view_from_cstr("123456789012345678901"),
+                  &u64) == ERANGE);
+    group->elements[idx++] = D_ASSERT_TRUE(
+        "to_uint64_limits",
+        result,
+        "UINT64_MAX should parse and larger values be ERANGE");
+
+    // test: leading zeros do not count towards the digit limit
+    result = (d_string_view_to_uint64(
+                  d_string_view_from_cstr("000000000000000000000000042"),
+                  &u64) == 0) &&
+             (u64 == 42);
+    group->elements[idx++] = D_ASSERT_TRUE(
+        "to_uint64_leading_zeros",
+        result,
+        "leading zeros should be accepted");
+
+    // test: malformed text is EINVAL
+    result = (d_string_view_to_int64(d_string_view_from_cstr(""),
+                                     &i64) == EINVAL) &&
+             (d_string_view_to_int64(d_string_view_from_cstr("-"),
+                                     &i64) == EINVAL) &&
+             (d_string_view_to_int64(d_string_view_from_cstr(" 1"),
+                                     &i64) == EINVAL) &&
+             (d_string_view_to_int64(d_string_view_from_cstr("12a"),
+                                     &i64) == EINVAL) &&
+             (d_string_view_to_int64(d_string_view_from_cstr("1.0"),
+                                     &i64) == EINVAL) &&
+             (d_string_to_int64(NULL, &i64) == EINVAL) &&
+             (d_string_to_int64(str, NULL) == EINVAL);
+    group->elements[idx++] = D_ASSERT_TRUE(
+        "to_int64_malformed",
+        result,
+        "malformed text and NULL parameters should be EINVAL");
+
+    // test: a '-' sign is rejected for unsigned values
+    result = (d_string_view_to_uint64(d_string_view_from_cstr("-1"),
+                                      &u64) == EINVAL) &&
+             (d_string_view_to_uint64(d_string_view_from_cstr("+7"),
+                                      &u64) == 0) &&
+             (u64 == 7);
+    group->elements[idx++] = D_ASSERT_TRUE(
+        "to_uint64_sign",
+        result,
+        "unsigned parsing should accept '+' and reject '-'");
+
+    // test: views are parsed without needing a terminator
+    d_string_assign_cstr(str, "id=1234567890123,next");
+    result = (d_string_view_to_int64(d_string_substr_view(str, 3, 13),
+                                     &i64) == 0) &&
+             (i64 == 1234567890123LL);
+    group->elements[idx++] = D_ASSERT_TRUE(
+        "to_int64_view",
+        result,
+        "a substring view should parse on its own");
+
+    // test: the output is left unchanged on error
+    i64 = 99;
+    d_string_view_to_int64(d_string_view_from_cstr("x"), &i64);
+    group->elements[idx++] = D_ASSERT_TRUE(
+        "to_int64_unchanged_on_error",
+        (i64 == 99),
+        "the output should not be written on error");
+
+    d_string_free(str);
+
+    return group;
+}
+
+/*
+d_tests_sa_dstring_to_double
+  Tests d_string_to_double and d_string_view_to_double.
+  Tests the following:
+  - plain, fractional and exponent forms parse exactly
+  - 17-digit round-trip output parses back to the same double
+  - ties round to even
+  - subnormal, largest and smallest values are correctly rounded
+  - overflow and underflow report ERANGE with infinity or zero
+  - infinities and NaN are recognized in any case
+  - malformed text is EINVAL
+  - views are parsed without needing a terminator
+  - very long inputs are rounded exactly
+*/
+struct d_test_object*
+d_tests_sa_dstring_to_double
+(
+    void
+)
+{
+    struct d_test_object* group;
+    struct d_string*      str;
+    double                value;
+    bool                  result;
+    size_t                i;
+    size_t                idx;
+
+    group = d_test_object_new_interior("d_string_to_double", 9);
+
+    if (!group)
+    {
+        return NULL;
+    }
+
+    idx = 0;
+
+    // test: plain, fractional and exponent forms parse exactly
+    str    = d_string_new_from_cstr("-12.5e-1");
+    result = (d_string_to_double(str, &value) == 0) && (value == -1.25);
+    result = result &&
+             (d_string_view_to_double(d_string_view_from_cstr("0.1"),
+                                      &value) == 0) &&
+             (value == 0.1) &&
+             (d_string_view_to_double(d_string_view_from_cstr(".5"),
+                                      &value) == 0) &&
+             (value == 0.5) &&
+             (d_string_view_to_double(d_string_view_from_cstr("3."),
+                                      &value) == 0) &&
+             (value == 3.0) &&
+             (d_string_view_to_double(d_string_view_from_cstr("1E+3"),
+                                      &value) == 0) &&
+             (value == 1000.0);
+    group->elements[idx++] = D_ASSERT_TRUE(
+        "to_double_forms",
+        result,
+        "plain, fractional and exponent forms should parse");
+
+    // test: 17-digit round-trip output parses back to the same double
+    result = (d_string_view_to_double(
+                  d_string_view_from_cstr("0.30000000000000004"),
+                  &value) == 0) &&
+             (value == 0.1 + 0.2) &&
+             (d_string_view_to_double(
+                  d_string_view_from_cstr("2.2250738585072014e-308"),
+                  &value) == 0) &&
+             (value == DBL_MIN);
+    group->elements[idx++] = D_ASSERT_TRUE(
+        "to_double_roundtrip_digits",
+        result,
+        "17-digit output should read back exactly");
+
+    // test: ties round to even (2^53 + 1 lies between two doubles)
+    result = (d_string_view_to_double(
+                  d_string_view_from_cstr("9007199254740993"),
+                  &value) == 0) &&
+             (value == 9007199254740992.0) &&
+             (d_string_view_to_double(
+                  d_string_view_from_cstr("9007199254740995"),
+                  &value) == 0) &&
+             (value == 9007199254740996.0);
+    group->elements[idx++] = D_ASSERT_TRUE(
+        "to_double_ties_even",
+        result,
+        "exact ties should round to even");
+
+    // test: subnormal, largest and smallest values are correctly rounded
+    result = (d_string_view_to_double(d_string_view_from_cstr("5e-324"),
+                                      &value) == 0) &&
+             (value == 4.9406564584124654e-324) &&
+             (d_string_view_to_double(
+                  d_string_view_from_cstr("1.7976931348623157e308"),
+                  &value) == 0) &&
+             (value == DBL_MAX);
+    group->elements[idx++] = D_ASSERT_TRUE(
+        "to_double_extremes",
+        result,
+        "the smallest subnormal and DBL_MAX should parse");
+
+    // test: overflow and underflow report ERANGE with infinity or zero
+    result = (d_string_view_to_double(d_string_view_from_cstr("1e400"),
+                                      &value) == ERANGE) &&
+             (value == HUGE_VAL) &&
+             (d_string_view_to_double(d_string_view_from_cstr("-1e-400"),
+                                      &value) == ERANGE) &&
+             (value == 0.0);
+    group->elements[idx++] = D_ASSERT_TRUE(
+        "to_double_range",
+        result,
+        "overflow and underflow should be ERANGE");
+
+    // test: infinities and NaN are recognized in any case
+    result = (d_string_view_to_double(d_string_view_from_cstr("-Infinity"),
+                                      &value) == 0) &&
+             (value == -HUGE_VAL) &&
+             (d_string_view_to_double(d_string_view_from_cstr("NaN"),
+                                      &value) == 0) &&
+             (value != value);
+    group->elements[idx++] = D_ASSERT_TRUE(
+        "to_double_special",
+        result,
+        "inf, infinity and nan should parse");
+
+    // test: malformed text is EINVAL
+    result = (d_string_view_to_double(d_string_view_from_cstr("."),
+                                      &value) == EINVAL) &&
+             (d_string_view_to_double(d_string_view_from_cstr("1e"),
+                                      &value) == EINVAL) &&
+             (d_string_view_to_double(d_string_view_from_cstr("1.2.3"),
+                                      &value) == EINVAL) &&
+             (d_string_view_to_double(d_string_view_from_cstr("0x10"),
+                                      &value) == EINVAL) &&
+             (d_string_view_to_double(d_string_view_from_cstr(" 1"),
+                                      &value) == EINVAL) &&
+             (d_string_to_double(NULL, &value) == EINVAL);
+    group->elements[idx++] = D_ASSERT_TRUE(
+        "to_double_malformed",
+        result,
+        "malformed text should be EINVAL");
+
+    // test: views are parsed without needing a terminator
+    d_string_assign_cstr(str, "1.5,2.25");
+    result = (d_string_view_to_double(d_string_substr_view(str, 4, 4),
+                                      &value) == 0) &&
+             (value == 2.25) &&
+             (d_string_view_to_double(d_string_substr_view(str, 0, 3),
+                                      &value) == 0) &&
+             (value == 1.5);
+    group->elements[idx++] = D_ASSERT_TRUE(
+        "to_double_view",
+        result,
+        "a substring view should parse on its own");
+
+    // test: very long inputs are rounded exactly ("0.1" padded to 400
+    // digits rounds like 0.1)
+    d_string_assign_cstr(str, "0.1");
+
+    for (i = 0; i < 400; i++)
+    {
+        d_string_append_char(str, '0');
+    }
+
+    d_string_append_cstr(str, "1");
+    result = (d_string_to_double(str, &value) == 0) && (value == 0.1);
+    group->elements[idx++] = D_ASSERT_TRUE(
+        "to_double_long_input",
+        result,
+        "inputs with hundreds of digits should round exactly");
+
+    d_string_free(str);
+
+    return group;
+}
+
+/*
+d_tests_sa_dstring_append_number
+  Tests d_string_append_int, d_string_append_uint, d_string_append_double
+and d_string_builder_append_double.
+  Tests the following:
+  - integers are appended in decimal, including INT64_MIN and UINT64_MAX
+  - doubles are appended in their shortest round-trip form
+  - the plain/exponent notation switch follows the documented range
+  - zero, negative zero and non-finite values have fixed spellings
+  - appended doubles parse back to the same value
+  - builders format doubles the same way
+  - NULL strings are rejected
+*/
+struct d_test_object*
+d_tests_sa_dstring_append_number
+(
+    void
+)
+{
+    static const double samples[] =
+    {
+        0.1, 1.0 / 3.0, 123456.789, 1e-300, 6.02214076e23, 5e-324,
+        1.7976931348623157e308, 9007199254740993.0, -2.5e-7
+    };
+    struct d_test_object*    group;
+    struct d_string*         str;
+    struct d_string_builder* sb;
+    struct d_string*         built;
+    double                   value;
+    bool                     result;
+    size_t                   i;
+    size_t                   idx;
+
+    group = d_test_object_new_interior("d_string_append_number", 7);
+
+    if (!group)
+    {
+        return NULL;
+    }
+
+    idx = 0;
+
+    // test: integers are appended in decimal
+    str    = d_string_new_from_cstr("n=");
+    result = d_string_append_int(str, INT64_MIN)  &&
+             d_string_append_char(str, ',')       &&
+             d_string_append_uint(str, UINT64_MAX) &&
+             d_string_append_char(str, ',')       &&
+             d_string_append_int(str, 0);
+    group->elements[idx++] = D_ASSERT_TRUE(
+        "append_integers",
+        result &&
+        (strcmp(str->text,
+                "n=-9223372036854775808,18446744073709551615,0") == 0),
+        "integers should be appended in decimal");
+
+    // test: doubles are appended in their shortest round-trip form
+    d_string_clear(str);
+    d_string_append_double(str, 0.1);
+    d_string_append_char(str, ' ');
+    d_string_append_double(str, 0.1 + 0.2);
+    d_string_append_char(str, ' ');
+    d_string_append_double(str, 123.456);
+    group->elements[idx++] = D_ASSERT_TRUE(
+        "append_double_shortest",
+        (strcmp(str->text, "0.1 0.30000000000000004 123.456") == 0),
+        "doubles should use the shortest round-trip digits");
+
+    // test: the plain/exponent notation switch
+    d_string_clear(str);
+    d_string_append_double(str, 1e20);
+    d_string_append_char(str, ' ');
+    d_string_append_double(str, 1e21);
+    d_string_append_char(str, ' ');
+    d_string_append_double(str, 1e-6);
+    d_string_append_char(str, ' ');
+    d_string_append_double(str, 1.5e-7);
+    group->elements[idx++] = D_ASSERT_TRUE(
+        "append_double_notation",
+        (strcmp(str->text,
+                "100000000000000000000 1e+21 0.000001 1.5e-7") == 0),
+        "exponent notation should start at 1e21 and below 1e-6");
+
+    // test: zero, negative zero and non-finite values
+    d_string_clear(str);
+    d_string_append_double(str, 0.0);
+    d_string_append_char(str, ' ');
+    d_string_append_double(str, -0.0);
+    d_string_append_char(str, ' ');
+    d_string_append_double(str, -HUGE_VAL);
+    d_string_append_char(str, ' ');
+    d_string_append_double(str, NAN);
+    group->elements[idx++] = D_ASSERT_TRUE(
+        "append_double_special",
+        (strcmp(str->text, "0 -0 -inf nan") == 0),
+        "special values should have fixed spellings");
+
+    // test: appended doubles parse back to the same value
+    result = true;
+
+    for (i = 0; i < sizeof(samples) / sizeof(samples[0]); i++)
+    {
+        d_string_clear(str);
+        result = result &&
+                 d_string_append_double(str, samples[i]) &&
+                 (d_string_to_double(str, &value) == 0) &&
+                 (value == samples[i]);
+    }
+
+    group->elements[idx++] = D_ASSERT_TRUE(
+        "append_double_roundtrip",
+        result,
+        "appended doubles should parse back exactly");
+
+    // test: builders format doubles the same way
+    sb    = d_string_builder_new(0);
+    built = NULL;
+
+    if (sb)
+    {
+        d_string_builder_append_double(sb, 2.5);
+        d_string_builder_append_char(sb, ';');
+        d_string_builder_append_uint(sb, 1234567890123ULL);
+        built = d_string_builder_build(sb);
+    }
+
+    group->elements[idx++] = D_ASSERT_TRUE(
+        "builder_append_double",
+        (built != NULL) && (strcmp(built->text, "2.5;1234567890123") == 0),
+        "builders should format numbers like d_string");
+
+    d_string_free(built);
+    d_string_builder_free(sb);
+
+    // test: NULL strings are rejected
+    group->elements[idx++] = D_ASSERT_TRUE(
+        "append_number_null",
+        (!d_string_append_int(NULL, 1))    &&
+        (!d_string_append_uint(NULL, 1))   &&
+        (!d_string_append_double(NULL, 1.0)),
+        "appending to NULL should fail");
+
+    d_string_free(str);
+
+    return group;
+}
+
+/*
+d_tests_sa_dstring_numeric_all
+  Runs all numeric conversion tests for dstring module.
+  Tests the following:
+  - integer parsing
+  - floating-point parsing
+  - number formatting
+*/
+struct d_test_object*
+d_tests_sa_dstring_numeric_all
+(
+    void
+)
+{
+    struct d_test_object* group;
+    size_t                idx;
+
+    group = d_test_object_new_interior("Numeric Conversion Functions", 3);
+
+    if (!group)
+    {
+        return NULL;
+    }
+
+    idx = 0;
+
+    group->elements[idx++] = d_tests_sa_dstring_to_integer();
+    group->elements[idx++] = d_tests_sa_dstring_to_double();
+    group->elements[idx++] = d_tests_sa_dstring_append_number();
+
+    return group;
+}
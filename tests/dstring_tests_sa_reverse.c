@@ -714,6 +714,100 @@ d_tests_sa_dstring_reversed
     return group;
 }
 
+/*
+d_tests_sa_dstring_reverse_long
+  Tests d_string_reverse on strings long enough to exercise the vectorized
+kernel.
+  Tests the following:
+  - every length up to several vector blocks is fully reversed
+  - reversing twice restores the original string
+  - bytes after an embedded '\0' are reversed as well
+*/
+struct d_test_object*
+d_tests_sa_dstring_reverse_long
+(
+    void
+)
+{
+    struct d_test_object* group;
+    struct d_string*      str;
+    char                  text[200];
+    size_t                len;
+    size_t                i;
+    bool                  reversed_ok;
+    bool                  restored_ok;
+    bool                  result;
+    size_t                idx;
+
+    group = d_test_object_new_interior("d_string_reverse_long", 3);
+
+    if (!group)
+    {
+        return NULL;
+    }
+
+    idx         = 0;
+    reversed_ok = true;
+    restored_ok = true;
+
+    for (i = 0; i < sizeof(text); i++)
+    {
+        text[i] = (char)(1 + (i * 7) % 251);
+    }
+
+    // every length from 0 to 199
+    for (len = 0; len < sizeof(text); len++)
+    {
+        str = d_string_new_from_buffer(text, len);
+
+        if (!str)
+        {
+            reversed_ok = restored_ok = false;
+
+            break;
+        }
+
+        d_string_reverse(str);
+
+        for (i = 0; i < len; i++)
+        {
+            reversed_ok = reversed_ok && (str->text[i] == text[len - 1 - i]);
+        }
+
+        reversed_ok = reversed_ok && (str->text[len] == '\0');
+
+        d_string_reverse(str);
+        restored_ok = restored_ok && (memcmp(str->text, text, len) == 0);
+
+        d_string_free(str);
+    }
+
+    // test: every length is fully reversed
+    group->elements[idx++] = D_ASSERT_TRUE(
+        "reverse_long_lengths",
+        reversed_ok,
+        "strings of every length should be reversed");
+
+    // test: reversing twice restores the original string
+    group->elements[idx++] = D_ASSERT_TRUE(
+        "reverse_long_roundtrip",
+        restored_ok,
+        "reversing twice should restore the original");
+
+    // test: bytes after an embedded '\0' are reversed as well
+    str    = d_string_new_from_buffer("ab\0cd", 5);
+    result = (str != NULL) && d_string_reverse(str) &&
+             (memcmp(str->text, "dc\0ba", 5) == 0);
+    group->elements[idx++] = D_ASSERT_TRUE(
+        "reverse_long_embedded_nul",
+        result,
+        "reverse should cover the full length of the string");
+
+    d_string_free(str);
+
+    return group;
+}
+
 
 /******************************************************************************
 * d_tests_sa_dstring_reversal_all
@@ -738,7 +832,7 @@ d_tests_sa_dstring_reversal_all
     struct d_test_object* group;
     size_t                child_idx;
 
-    group     = d_test_object_new_interior("`dstring` reversal", 2);
+    group     = d_test_object_new_interior("`dstring` reversal", 3);
     child_idx = 0;
 
     if (!group)
@@ -749,6 +843,7 @@ d_tests_sa_dstring_reversal_all
     // run all reversal tests
     group->elements[child_idx++] = d_tests_sa_dstring_reverse();
     group->elements[child_idx++] = d_tests_sa_dstring_reversed();
+    group->elements[child_idx++] = d_tests_sa_dstring_reverse_long();
 
     return group;
 }
\ No newline at end of file
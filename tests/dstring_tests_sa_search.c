@@ -1598,6 +1598,171 @@ d_tests_sa_dstring_str
  * III. CASE-INSENSITIVE SEARCH TESTS
  *****************************************************************************/
 
+/*
+d_tests_sa_dstring_find_binary
+  Tests that substring search is length-aware and binary-safe across the
+find, rfind, count and replace functions.
+  Tests the following:
+  - match located after an embedded null byte
+  - needle containing an embedded null byte
+  - reverse search with an embedded null byte
+  - count across embedded null bytes
+  - replace_all of an embedded null byte
+  - match deep in a long haystack
+  - pathological periodic needle with no match
+  - pathological periodic needle matching at the end
+  - reverse search returns the last of several matches
+*/
+struct d_test_object*
+d_tests_sa_dstring_find_binary
+(
+    void
+)
+{
+    struct d_test_object* group;
+    struct d_string*      str;
+    struct d_string*      needle;
+    struct d_string*      old;
+    char                  pattern[64];
+    size_t                idx;
+
+    group = d_test_object_new_interior("d_string binary-safe search", 9);
+
+    if (!group)
+    {
+        return NULL;
+    }
+
+    idx = 0;
+
+    // test: match located after an embedded null byte
+    str    = d_string_new_from_buffer("ab\0cd\0cd", 8);
+    needle = d_string_new_from_buffer("b\0c", 3);
+    old    = d_string_new_from_buffer("\0", 1);
+
+    if (str && needle && old)
+    {
+        group->elements[idx++] = D_ASSERT_EQUAL(
+            "find_after_embedded_null",
+            d_string_find_cstr(str, "cd"), 3,
+            "should find 'cd' past the embedded null at index 3");
+
+        // test: needle containing an embedded null byte
+        group->elements[idx++] = D_ASSERT_EQUAL(
+            "find_needle_with_null",
+            d_string_find(str, needle), 1,
+            "should find 3-byte needle 'b\\0c' at index 1");
+
+        // test: reverse search with an embedded null byte
+        group->elements[idx++] = D_ASSERT_EQUAL(
+            "rfind_after_embedded_null",
+            d_string_rfind_cstr(str, "cd"), 6,
+            "should find last 'cd' at index 6");
+
+        // test: count across embedded null bytes
+        group->elements[idx++] = D_ASSERT_EQUAL(
+            "count_across_null",
+            d_string_count_substr(str, "cd"), 2,
+            "should count both occurrences of 'cd'");
+
+        // test: replace_all of an embedded null byte
+        group->elements[idx++] = D_ASSERT_TRUE(
+            "replace_all_embedded_null",
+            d_string_replace_all(str, old, old) &&
+            (str->size == 8) &&
+            (memcmp(str->text, "ab\0cd\0cd", 9) == 0),
+            "replacing the null byte with itself should preserve content");
+    }
+    else
+    {
+        group->elements[idx++] = D_ASSERT_TRUE(
+            "find_after_embedded_null", false,
+            "failed to allocate test string");
+        group->elements[idx++] = D_ASSERT_TRUE(
+            "find_needle_with_null", false,
+            "failed to allocate test string");
+        group->elements[idx++] = D_ASSERT_TRUE(
+            "rfind_after_embedded_null", false,
+            "failed to allocate test string");
+        group->elements[idx++] = D_ASSERT_TRUE(
+            "count_across_null", false,
+            "failed to allocate test string");
+        group->elements[idx++] = D_ASSERT_TRUE(
+            "replace_all_embedded_null", false,
+            "failed to allocate test string");
+    }
+
+    d_string_free(str);
+    d_string_free(needle);
+    d_string_free(old);
+
+    // test: match deep in a long haystack
+    str = d_string_new_fill(4096, 'a');
+
+    if (str)
+    {
+        d_memcpy(str->text + 3000, "needle", 6);
+        group->elements[idx++] = D_ASSERT_EQUAL(
+            "find_long_haystack",
+            d_string_find_cstr(str, "needle"), 3000,
+            "should find 'needle' at index 3000");
+
+        // test: pathological periodic needle with no match
+        d_memset(str->text + 3000, 'a', 6);
+        d_memset(pattern, 'a', sizeof(pattern) - 1);
+        pattern[sizeof(pattern) - 2] = 'b';
+        pattern[sizeof(pattern) - 1] = '\0';
+
+        group->elements[idx++] = D_ASSERT_EQUAL(
+            "find_pathological_none",
+            d_string_find_cstr(str, pattern), -1,
+            "should not find 'a...ab' in 'a...a'");
+
+        // test: pathological periodic needle matching at the end
+        d_string_append_char(str, 'b');
+        group->elements[idx++] = D_ASSERT_EQUAL(
+            "find_pathological_end",
+            d_string_find_cstr(str, pattern),
+            (ssize_t)(4097 - (sizeof(pattern) - 1)),
+            "should find 'a...ab' at the end of the haystack");
+
+        d_string_free(str);
+    }
+    else
+    {
+        group->elements[idx++] = D_ASSERT_TRUE(
+            "find_long_haystack", false,
+            "failed to allocate test string");
+        group->elements[idx++] = D_ASSERT_TRUE(
+            "find_pathological_none", false,
+            "failed to allocate test string");
+        group->elements[idx++] = D_ASSERT_TRUE(
+            "find_pathological_end", false,
+            "failed to allocate test string");
+    }
+
+    // test: reverse search returns the last of several matches
+    str = d_string_new_from_cstr("abcabcabcab");
+
+    if (str)
+    {
+        group->elements[idx++] = D_ASSERT_EQUAL(
+            "rfind_last_of_many",
+            d_string_rfind_cstr(str, "abc"), 6,
+            "should find last 'abc' at index 6");
+
+        d_string_free(str);
+    }
+    else
+    {
+        group->elements[idx++] = D_ASSERT_TRUE(
+            "rfind_last_of_many", false,
+            "failed to allocate test string");
+    }
+
+    return group;
+}
+
 /*
 d_tests_sa_dstring_casefind
   Tests d_string_casefind function.
@@ -1917,6 +2082,127 @@ d_tests_sa_dstring_casestr
 }
 
 
+/*
+d_tests_sa_dstring_casefind_linear
+  Tests that case-insensitive search is length-aware, exact about which bytes
+fold, and linear on adversarial needles.
+  Tests the following:
+  - mixed-case match deep in a long haystack
+  - punctuation adjacent to letters does not fold
+  - needle containing an embedded null byte
+  - pathological periodic needle with no match
+  - pathological periodic needle matching at the end
+  - casestr returns a pointer into the haystack
+*/
+struct d_test_object*
+d_tests_sa_dstring_casefind_linear
+(
+    void
+)
+{
+    struct d_test_object* group;
+    struct d_string*      str;
+    struct d_string*      needle;
+    char                  pattern[64];
+    size_t                idx;
+
+    group = d_test_object_new_interior("d_string linear casefind", 6);
+
+    if (!group)
+    {
+        return NULL;
+    }
+
+    idx = 0;
+
+    // test: mixed-case match deep in a long haystack
+    str = d_string_new_fill(4096, 'A');
+
+    if (str)
+    {
+        d_memcpy(str->text + 3000, "NeEdLe", 6);
+        group->elements[idx++] = D_ASSERT_EQUAL(
+            "casefind_long_haystack",
+            d_string_casefind_cstr(str, "nEeDlE"), 3000,
+            "should find 'nEeDlE' at index 3000");
+
+        // test: pathological periodic needle with no match
+        d_memset(str->text + 3000, 'A', 6);
+        d_memset(pattern, 'a', sizeof(pattern) - 1);
+        pattern[sizeof(pattern) - 2] = 'b';
+        pattern[sizeof(pattern) - 1] = '\0';
+
+        group->elements[idx++] = D_ASSERT_EQUAL(
+            "casefind_pathological_none",
+            d_string_casefind_cstr(str, pattern), -1,
+            "should not find 'a...ab' in 'A...A'");
+
+        // test: pathological periodic needle matching at the end
+        d_string_append_char(str, 'B');
+        group->elements[idx++] = D_ASSERT_EQUAL(
+            "casefind_pathological_end",
+            d_string_casefind_cstr(str, pattern),
+            (ssize_t)(4097 - (sizeof(pattern) - 1)),
+            "should find 'a...ab' at the end of the haystack");
+
+        d_string_free(str);
+    }
+    else
+    {
+        group->elements[idx++] = D_ASSERT_TRUE(
+            "casefind_long_haystack", false,
+            "failed to allocate test string");
+        group->elements[idx++] = D_ASSERT_TRUE(
+            "casefind_pathological_none", false,
+            "failed to allocate test string");
+        group->elements[idx++] = D_ASSERT_TRUE(
+            "casefind_pathological_end", false,
+            "failed to allocate test string");
+    }
+
+    // test: punctuation adjacent to letters does not fold
+    str    = d_string_new_from_buffer("x@[y\0CD", 7);
+    needle = d_string_new_from_buffer("Y\0c", 3);
+
+    if (str && needle)
+    {
+        group->elements[idx++] = D_ASSERT_EQUAL(
+            "casefind_no_punct_fold",
+            d_string_casefind_cstr(str, "`{"), -1,
+            "'@[' must not match '`{' (they differ only in bit 0x20)");
+
+        // test: needle containing an embedded null byte
+        group->elements[idx++] = D_ASSERT_EQUAL(
+            "casefind_needle_with_null",
+            d_string_casefind(str, needle), 3,
+            "should find 3-byte needle 'Y\\0c' at index 3");
+
+        // test: casestr returns a pointer into the haystack
+        group->elements[idx++] = D_ASSERT_TRUE(
+            "casestr_pointer",
+            d_string_casestr(str, "X@[") == str->text,
+            "should return a pointer to the start of the haystack");
+    }
+    else
+    {
+        group->elements[idx++] = D_ASSERT_TRUE(
+            "casefind_no_punct_fold", false,
+            "failed to allocate test string");
+        group->elements[idx++] = D_ASSERT_TRUE(
+            "casefind_needle_with_null", false,
+            "failed to allocate test string");
+        group->elements[idx++] = D_ASSERT_TRUE(
+            "casestr_pointer", false,
+            "failed to allocate test string");
+    }
+
+    d_string_free(str);
+    d_string_free(needle);
+
+    return group;
+}
+
+
 /******************************************************************************
  * IV. CONTAINMENT CHECK TESTS
  *****************************************************************************/
@@ -2948,8 +3234,9 @@ d_tests_sa_dstring_search_all
   - character search functions (find_char, find_char_from, rfind_char, 
     chr, rchr, chrnul)
   - substring search functions (find, find_cstr, find_from, find_cstr_from,
-    rfind, rfind_cstr, str)
-  - case-insensitive search functions (casefind, casefind_cstr, casestr)
+    rfind, rfind_cstr, str, binary-safe search)
+  - case-insensitive search functions (casefind, casefind_cstr, casestr,
+    linear-time casefind)
   - containment check functions (contains, contains_cstr, contains_char,
     starts_with, starts_with_cstr, ends_with, ends_with_cstr)
   - span functions (spn, cspn, pbrk)
@@ -2963,7 +3250,7 @@ d_tests_sa_dstring_search_all
     struct d_test_object* group;
     size_t                idx;
 
-    group = d_test_object_new_interior("Search Functions", 26);
+    group = d_test_object_new_interior("Search Functions", 28);
 
     if (!group)
     {
@@ -2988,11 +3275,13 @@ d_tests_sa_dstring_search_all
     group->elements[idx++] = d_tests_sa_dstring_rfind();
     group->elements[idx++] = d_tests_sa_dstring_rfind_cstr();
     group->elements[idx++] = d_tests_sa_dstring_str();
+    group->elements[idx++] = d_tests_sa_dstring_find_binary();
 
     // III. case-insensitive search tests
     group->elements[idx++] = d_tests_sa_dstring_casefind();
     group->elements[idx++] = d_tests_sa_dstring_casefind_cstr();
     group->elements[idx++] = d_tests_sa_dstring_casestr();
+    group->elements[idx++] = d_tests_sa_dstring_casefind_linear();
 
     // IV. containment check tests
     group->elements[idx++] = d_tests_sa_dstring_contains();
@@ -0,0 +1,416 @@
+#include ".\dstring_tests_sa.h"
+
+
+/******************************************************************************
+ * SECTION 23: SORTING FUNCTIONS
+ *****************************************************************************/
+
+// D_TEST_DSTRING_SORT_LARGE
+//   constant: number of strings in the large sorting tests; above the
+// parallel threshold so d_string_sort_parallel starts its threads.
+#define D_TEST_DSTRING_SORT_LARGE (D_STRING_SORT_PARALLEL_THRESHOLD + 1000)
+
+/*
+d_tests_sa_dstring_sort_is_ordered
+  Returns true if `_strings[0.._count)` is in non-decreasing d_string_cmp
+order.
+*/
+static bool
+d_tests_sa_dstring_sort_is_ordered
+(
+    struct d_string** _strings,
+    size_t            _count
+)
+{
+    size_t i;
+
+    for (i = 1; i < _count; i++)
+    {
+        if (d_string_cmp(_strings[i - 1], _strings[i]) > 0)
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+/*
+d_tests_sa_dstring_sort_fill
+  Fills `_strings` with `_count` pseudo-random strings that share long
+prefixes, so sorting must compare well past the first cached key.
+*/
+static void
+d_tests_sa_dstring_sort_fill
+(
+    struct d_string** _strings,
+    size_t            _count
+)
+{
+    char     buffer[64];
+    uint32_t seed;
+    size_t   i;
+    int      length;
+
+    seed = 12345;
+
+    for (i = 0; i < _count; i++)
+    {
+        seed   = (seed * 1103515245u) + 12345u;
+        length = snprintf(buffer,
+                          sizeof(buffer),
+                          "https://example.com/item/%u",
+                          (unsigned)((seed >> 8) % 50000));
+        _strings[i] = d_string_new_from_buffer(buffer, (size_t)length);
+    }
+}
+
+/*
+d_tests_sa_dstring_sort
+  Tests d_string_sort.
+  Tests the following:
+  - strings are sorted into d_string_cmp order
+  - a prefix sorts before the longer string
+  - embedded null bytes are ordered by value, not as terminators
+  - bytes above 0x7F sort after ASCII (unsigned comparison)
+  - NULL entries sort first
+  - empty and single-entry arrays succeed
+  - a NULL array is rejected unless the count is 0
+  - strings sharing a long prefix are sorted
+*/
+struct d_test_object*
+d_tests_sa_dstring_sort
+(
+    void
+)
+{
+    struct d_test_object* group;
+    struct d_string*      strings[7];
+    struct d_string**     large;
+    size_t                idx;
+    size_t                i;
+    bool                  ok;
+
+    group = d_test_object_new_interior("d_string_sort", 7);
+
+    if (!group)
+    {
+        return NULL;
+    }
+
+    idx = 0;
+
+    strings[0] = d_string_new_from_cstr("banana");
+    strings[1] = d_string_new_from_cstr("apple");
+    strings[2] = d_string_new_from_cstr("applesauce");
+    strings[3] = d_string_new_from_buffer("apple\0pie", 9);
+    strings[4] = d_string_new_from_cstr("\xC3\xA9clair");
+    strings[5] = NULL;
+    strings[6] = d_string_new_from_cstr("");
+
+    ok = d_string_sort(strings, 7);
+
+    // test: strings are in d_string_cmp order
+    group->elements[idx++] = D_ASSERT_TRUE(
+        "sort_ordered",
+        ok && d_tests_sa_dstring_sort_is_ordered(strings, 7),
+        "sorted array should be in d_string_cmp order");
+
+    // test: NULL first, then the empty string, then prefixes first
+    group->elements[idx++] = D_ASSERT_TRUE(
+        "sort_prefix_order",
+        (strings[0] == NULL)                           &&
+        (d_string_equals_cstr(strings[1], ""))         &&
+        (d_string_equals_cstr(strings[2], "apple"))    &&
+        (d_string_size(strings[3]) == 9)               &&
+        (d_string_equals_cstr(strings[4], "applesauce")) &&
+        (d_string_equals_cstr(strings[5], "banana")),
+        "NULL, empty and prefix strings should sort first");
+
+    // test: bytes above 0x7F compare as unsigned
+    group->elements[idx++] = D_ASSERT_TRUE(
+        "sort_high_bytes",
+        d_string_equals_cstr(strings[6], "\xC3\xA9clair"),
+        "non-ASCII bytes should sort after ASCII");
+
+    for (i = 0; i < 7; i++)
+    {
+        d_string_free(strings[i]);
+    }
+
+    // test: trivial arrays succeed
+    strings[0] = d_string_new_from_cstr("only");
+
+    group->elements[idx++] = D_ASSERT_TRUE(
+        "sort_trivial",
+        (d_string_sort(strings, 0)) &&
+        (d_string_sort(strings, 1)) &&
+        (d_string_equals_cstr(strings[0], "only")),
+        "empty and single-entry arrays should sort");
+
+    d_string_free(strings[0]);
+
+    // test: NULL array
+    group->elements[idx++] = D_ASSERT_TRUE(
+        "sort_null_array",
+        (!d_string_sort(NULL, 3)) &&
+        (d_string_sort(NULL, 0)),
+        "a NULL array should only be accepted with a count of 0");
+
+    // test: many strings sharing a long prefix
+    large = malloc(D_TEST_DSTRING_SORT_LARGE * sizeof(*large));
+
+    if (large != NULL)
+    {
+        d_tests_sa_dstring_sort_fill(large, D_TEST_DSTRING_SORT_LARGE);
+        ok = d_string_sort(large, D_TEST_DSTRING_SORT_LARGE);
+    }
+    else
+    {
+        ok = false;
+    }
+
+    group->elements[idx++] = D_ASSERT_TRUE(
+        "sort_shared_prefix",
+        ok,
+        "sorting a large array should succeed");
+
+    group->elements[idx++] = D_ASSERT_TRUE(
+        "sort_shared_prefix_ordered",
+        ok && d_tests_sa_dstring_sort_is_ordered(large,
+                                                 D_TEST_DSTRING_SORT_LARGE),
+        "strings sharing a prefix should be sorted past it");
+
+    if (large != NULL)
+    {
+        for (i = 0; i < D_TEST_DSTRING_SORT_LARGE; i++)
+        {
+            d_string_free(large[i]);
+        }
+
+        free(large);
+    }
+
+    return group;
+}
+
+/*
+d_tests_sa_dstring_sort_parallel
+  Tests d_string_sort_parallel.
+  Tests the following:
+  - a large array is sorted with several threads
+  - the result matches d_string_sort
+  - 0 threads (hardware concurrency) and small arrays work
+*/
+struct d_test_object*
+d_tests_sa_dstring_sort_parallel
+(
+    void
+)
+{
+    struct d_test_object* group;
+    struct d_string**     large;
+    struct d_string**     copy;
+    struct d_string*      small[3];
+    size_t                idx;
+    size_t                i;
+    bool                  ok;
+    bool                  same;
+
+    group = d_test_object_new_interior("d_string_sort_parallel", 3);
+
+    if (!group)
+    {
+        return NULL;
+    }
+
+    idx   = 0;
+    large = malloc(D_TEST_DSTRING_SORT_LARGE * sizeof(*large));
+    copy  = malloc(D_TEST_DSTRING_SORT_LARGE * sizeof(*copy));
+    ok    = false;
+    same  = false;
+
+    if ( (large != NULL) &&
+         (copy != NULL) )
+    {
+        d_tests_sa_dstring_sort_fill(large, D_TEST_DSTRING_SORT_LARGE);
+        memcpy(copy, large, D_TEST_DSTRING_SORT_LARGE * sizeof(*copy));
+
+        ok = d_string_sort_parallel(large, D_TEST_DSTRING_SORT_LARGE, 4) &&
+             d_string_sort(copy, D_TEST_DSTRING_SORT_LARGE);
+
+        same = ok;
+
+        for (i = 0; (same) && (i < D_TEST_DSTRING_SORT_LARGE); i++)
+        {
+            same = (d_string_cmp(large[i], copy[i]) == 0);
+        }
+    }
+
+    // test: large array sorted with threads
+    group->elements[idx++] = D_ASSERT_TRUE(
+        "sort_parallel_ordered",
+        ok && d_tests_sa_dstring_sort_is_ordered(large,
+                                                 D_TEST_DSTRING_SORT_LARGE),
+        "parallel sort should produce d_string_cmp order");
+
+    // test: matches the sequential sort
+    group->elements[idx++] = D_ASSERT_TRUE(
+        "sort_parallel_matches",
+        same,
+        "parallel and sequential sorts should agree");
+
+    if (large != NULL)
+    {
+        for (i = 0; i < D_TEST_DSTRING_SORT_LARGE; i++)
+        {
+            d_string_free(large[i]);
+        }
+    }
+
+    free(large);
+    free(copy);
+
+    // test: hardware concurrency on a small array
+    small[0] = d_string_new_from_cstr("c");
+    small[1] = d_string_new_from_cstr("a");
+    small[2] = d_string_new_from_cstr("b");
+
+    group->elements[idx++] = D_ASSERT_TRUE(
+        "sort_parallel_small",
+        (d_string_sort_parallel(small, 3, 0))     &&
+        (d_string_equals_cstr(small[0], "a"))     &&
+        (d_string_equals_cstr(small[1], "b"))     &&
+        (d_string_equals_cstr(small[2], "c")),
+        "small arrays should sort on the calling thread");
+
+    for (i = 0; i < 3; i++)
+    {
+        d_string_free(small[i]);
+    }
+
+    return group;
+}
+
+/*
+d_tests_sa_dstring_unique
+  Tests d_string_unique.
+  Tests the following:
+  - adjacent duplicates are removed, keeping the first of each run
+  - distinct strings keep their order
+  - duplicates are moved past the returned count, not lost
+  - NULL entries are deduplicated like equal strings
+  - NULL and empty arrays return 0
+*/
+struct d_test_object*
+d_tests_sa_dstring_unique
+(
+    void
+)
+{
+    struct d_test_object* group;
+    struct d_string*      strings[7];
+    struct d_string*      first_a;
+    size_t                idx;
+    size_t                kept;
+    size_t                i;
+    size_t                found;
+
+    group = d_test_object_new_interior("d_string_unique", 4);
+
+    if (!group)
+    {
+        return NULL;
+    }
+
+    idx = 0;
+
+    strings[0] = NULL;
+    strings[1] = NULL;
+    strings[2] = d_string_new_from_cstr("a");
+    strings[3] = d_string_new_from_cstr("a");
+    strings[4] = d_string_new_from_cstr("b");
+    strings[5] = d_string_new_from_cstr("c");
+    strings[6] = d_string_new_from_cstr("c");
+    first_a    = strings[2];
+
+    kept = d_string_unique(strings, 7);
+
+    // test: one entry per run, in order
+    group->elements[idx++] = D_ASSERT_TRUE(
+        "unique_count",
+        (kept == 4)                             &&
+        (strings[0] == NULL)                    &&
+        (d_string_equals_cstr(strings[1], "a")) &&
+        (d_string_equals_cstr(strings[2], "b")) &&
+        (d_string_equals_cstr(strings[3], "c")),
+        "unique should keep one of each run in order");
+
+    // test: the first of each run is kept
+    group->elements[idx++] = D_ASSERT_TRUE(
+        "unique_keeps_first",
+        strings[1] == first_a,
+        "unique should keep the first string of a run");
+
+    // test: duplicates remain in the array past the count
+    found = 0;
+
+    for (i = kept; i < 7; i++)
+    {
+        found += (strings[i] == NULL) ||
+                 (d_string_equals_cstr(strings[i], "a")) ||
+                 (d_string_equals_cstr(strings[i], "c"));
+    }
+
+    group->elements[idx++] = D_ASSERT_TRUE(
+        "unique_moves_duplicates",
+        found == 3,
+        "duplicates should be moved past the returned count");
+
+    for (i = 0; i < 7; i++)
+    {
+        d_string_free(strings[i]);
+    }
+
+    // test: NULL and empty arrays
+    group->elements[idx++] = D_ASSERT_TRUE(
+        "unique_empty",
+        (d_string_unique(NULL, 5) == 0) &&
+        (d_string_unique(strings, 0) == 0),
+        "NULL and empty arrays should return 0");
+
+    return group;
+}
+
+/*
+d_tests_sa_dstring_sort_all
+  Runs all sorting tests for dstring module.
+  Tests the following:
+  - sequential sort
+  - parallel sort
+  - deduplication
+*/
+struct d_test_object*
+d_tests_sa_dstring_sort_all
+(
+    void
+)
+{
+    struct d_test_object* group;
+    size_t                idx;
+
+    group = d_test_object_new_interior("Sorting Functions", 3);
+
+    if (!group)
+    {
+        return NULL;
+    }
+
+    idx = 0;
+
+    group->elements[idx++] = d_tests_sa_dstring_sort();
+    group->elements[idx++] = d_tests_sa_dstring_sort_parallel();
+    group->elements[idx++] = d_tests_sa_dstring_unique();
+
+    return group;
+}
@@ -1106,6 +1106,174 @@ d_tests_sa_dstring_trimmed_right
     return group;
 }
 
+/*
+d_tests_sa_dstring_normalize
+  Tests d_string_normalize and whitespace trimming of long strings.
+  Tests the following:
+  - trim, lowercase and collapse in one call
+  - collapse without trim keeps one space at each end
+  - uppercase mapping without changing whitespace
+  - long whitespace runs are trimmed across vector blocks
+  - long text with single spaces is only case-mapped
+  - conflicting case flags are rejected
+  - a rejected call leaves a shared buffer and its cached hash alone
+  - NULL and empty string handling
+*/
+struct d_test_object*
+d_tests_sa_dstring_normalize
+(
+    void
+)
+{
+    struct d_test_object* group;
+    struct d_string*      str;
+    struct d_string*      original;
+    char                  text[256];
+    char                  shared[D_STRING_SHARE_THRESHOLD + 64];
+    size_t                i;
+    bool                  result;
+    size_t                idx;
+
+    group = d_test_object_new_interior("d_string_normalize", 8);
+
+    if (!group)
+    {
+        return NULL;
+    }
+
+    idx = 0;
+
+    // test: trim, lowercase and collapse in one call
+    str    = d_string_new_from_cstr("  \t Hello   World\n\n FOO\tbar \r\n");
+    result = (str != NULL) &&
+             d_string_normalize(str, D_STRING_NORMALIZE_TRIM  |
+                                     D_STRING_NORMALIZE_LOWER |
+                                     D_STRING_NORMALIZE_COLLAPSE);
+    group->elements[idx++] = D_ASSERT_TRUE(
+        "normalize_all",
+        result && d_string_equals_cstr(str, "hello world foo bar"),
+        "should trim, lowercase and collapse whitespace");
+
+    d_string_free(str);
+
+    // test: collapse without trim keeps one space at each end
+    str    = d_string_new_from_cstr("\t\t a \n b  ");
+    result = (str != NULL) &&
+             d_string_normalize(str, D_STRING_NORMALIZE_COLLAPSE);
+    group->elements[idx++] = D_ASSERT_TRUE(
+        "normalize_collapse_only",
+        result && d_string_equals_cstr(str, " a b "),
+        "should collapse each whitespace run to one space");
+
+    d_string_free(str);
+
+    // test: uppercase mapping without changing whitespace
+    str    = d_string_new_from_cstr(" mixed\tCase 123 ");
+    result = (str != NULL) &&
+             d_string_normalize(str, D_STRING_NORMALIZE_UPPER);
+    group->elements[idx++] = D_ASSERT_TRUE(
+        "normalize_upper_only",
+        result && d_string_equals_cstr(str, " MIXED\tCASE 123 "),
+        "should only uppercase letters");
+
+    d_string_free(str);
+
+    // test: long whitespace runs are trimmed across vector blocks
+    memset(text, ' ', sizeof(text));
+    text[0]   = '\t';
+    text[100] = 'x';
+    text[150] = 'y';
+    str    = d_string_new_from_buffer(text, sizeof(text));
+    result = (str != NULL) && d_string_trim(str) && (str->size == 51) &&
+             (str->text[0] == 'x') && (str->text[50] == 'y');
+    group->elements[idx++] = D_ASSERT_TRUE(
+        "normalize_trim_long",
+        result,
+        "trim should skip whitespace runs longer than a vector block");
+
+    d_string_free(str);
+
+    // test: long text with single spaces is only case-mapped
+    for (i = 0; i < sizeof(text); i++)
+    {
+        text[i] = ((i % 5) == 4) ? ' ' : (char)('A' + (i % 26));
+    }
+
+    text[sizeof(text) - 1] = 'Z';
+    str    = d_string_new_from_buffer(text, sizeof(text));
+    result = (str != NULL) &&
+             d_string_normalize(str, D_STRING_NORMALIZE_TRIM  |
+                                     D_STRING_NORMALIZE_LOWER |
+                                     D_STRING_NORMALIZE_COLLAPSE) &&
+             (str->size == sizeof(text));
+
+    for (i = 0; result && (i < sizeof(text)); i++)
+    {
+        result = (str->text[i] == ((text[i] == ' ') ? ' ' : (text[i] | 0x20)));
+    }
+
+    group->elements[idx++] = D_ASSERT_TRUE(
+        "normalize_long_text",
+        result,
+        "clean long text should keep its length and be lowercased");
+
+    d_string_free(str);
+
+    // test: conflicting case flags are rejected
+    str    = d_string_new_from_cstr(" Text ");
+    result = (str != NULL) &&
+             !d_string_normalize(str, D_STRING_NORMALIZE_LOWER |
+                                      D_STRING_NORMALIZE_UPPER) &&
+             d_string_equals_cstr(str, " Text ");
+    group->elements[idx++] = D_ASSERT_TRUE(
+        "normalize_conflicting_flags",
+        result,
+        "LOWER together with UPPER should be rejected");
+
+    d_string_free(str);
+
+    // test: a rejected call leaves a shared buffer and its cached hash alone
+    memset(shared, 'x', sizeof(shared) - 1);
+    shared[sizeof(shared) - 1] = '\0';
+    original = d_string_new_from_cstr(shared);
+
+    if (original)
+    {
+        d_string_hash_cached(original);
+    }
+
+    str    = d_string_dup(original);
+    result = (str != NULL) &&
+             !d_string_normalize(str, D_STRING_NORMALIZE_LOWER |
+                                      D_STRING_NORMALIZE_UPPER) &&
+             (str->text == original->text) &&
+             d_string_is_shared(str) &&
+             (str->flags & D_STRING_FLAG_HASHED);
+    group->elements[idx++] = D_ASSERT_TRUE(
+        "normalize_rejected_untouched",
+        result,
+        "rejected flags should neither unshare nor drop the hash");
+
+    d_string_free(str);
+    d_string_free(original);
+
+    // test: NULL and empty string handling
+    str    = d_string_new();
+    result = !d_string_normalize(NULL, D_STRING_NORMALIZE_TRIM) &&
+             (str != NULL) &&
+             d_string_normalize(str, D_STRING_NORMALIZE_TRIM |
+                                     D_STRING_NORMALIZE_COLLAPSE) &&
+             (str->size == 0);
+    group->elements[idx++] = D_ASSERT_TRUE(
+        "normalize_null_empty",
+        result,
+        "NULL should be rejected and empty strings left empty");
+
+    d_string_free(str);
+
+    return group;
+}
+
 
 /******************************************************************************
  * TRIM ALL - AGGREGATE RUNNER
@@ -1117,6 +1285,7 @@ d_tests_sa_dstring_trim_all
   Tests the following:
   - in-place trimming functions (trim, trim_left, trim_right, trim_chars)
   - non-modifying trimming functions (trimmed, trimmed_left, trimmed_right)
+  - fused normalization (normalize)
 */
 struct d_test_object*
 d_tests_sa_dstring_trim_all
@@ -1127,7 +1296,7 @@ d_tests_sa_dstring_trim_all
     struct d_test_object* group;
     size_t                idx;
 
-    group = d_test_object_new_interior("Trimming Functions", 7);
+    group = d_test_object_new_interior("Trimming Functions", 8);
 
     if (!group)
     {
@@ -1147,5 +1316,8 @@ d_tests_sa_dstring_trim_all
     group->elements[idx++] = d_tests_sa_dstring_trimmed_left();
     group->elements[idx++] = d_tests_sa_dstring_trimmed_right();
 
+    // fused normalization tests
+    group->elements[idx++] = d_tests_sa_dstring_normalize();
+
     return group;
 }
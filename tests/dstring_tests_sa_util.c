@@ -1040,6 +1040,287 @@ d_tests_sa_dstring_count_substr
 }
 
 
+/*
+d_tests_sa_dstring_classify_long
+  Tests the character-class predicates and d_string_count_char on inputs
+long enough to exercise their vectorized kernels.
+  Tests the following:
+  - long strings of a single class are accepted
+  - a single offending byte is found at every position
+  - bytes >= 0x80 belong to no class
+  - count_char counts across block boundaries and large inputs
+*/
+struct d_test_object*
+d_tests_sa_dstring_classify_long
+(
+    void
+)
+{
+    struct d_test_object* group;
+    struct d_string*      str;
+    size_t                i;
+    size_t                expected;
+    bool                  result;
+    size_t                idx;
+
+    group = d_test_object_new_interior("d_string_classify_long", 4);
+
+    if (!group)
+    {
+        return NULL;
+    }
+
+    idx = 0;
+    str = d_string_new_with_capacity(1025);
+
+    if (!str)
+    {
+        group->elements[idx++] = D_ASSERT_TRUE(
+            "classify_long_alloc", false, "failed to allocate test string");
+
+        return group;
+    }
+
+    // test: long strings of a single class are accepted
+    for (i = 0; i < 1000; i++)
+    {
+        str->text[i] = "0123456789"[i % 10];
+    }
+
+    str->text[1000] = '\0';
+    str->size       = 1000;
+
+    result = d_string_is_numeric(str) &&
+             d_string_is_alnum(str)   &&
+             !d_string_is_alpha(str)  &&
+             d_string_is_ascii(str);
+
+    for (i = 0; i < 1000; i++)
+    {
+        str->text[i] = " \t\n\v\f\r"[i % 6];
+    }
+
+    result = result && d_string_is_whitespace(str);
+    group->elements[idx++] = D_ASSERT_TRUE(
+        "classify_long_accept",
+        result,
+        "long single-class strings should be accepted");
+
+    // test: a single offending byte is found at every position
+    result = true;
+
+    for (i = 0; i < 1000; i++)
+    {
+        str->text[i] = "aZbYcX"[i % 6];
+    }
+
+    for (i = 0; (i < 1000) && result; i++)
+    {
+        str->text[i] = '@';
+        result       = !d_string_is_alpha(str);
+        str->text[i] = 'q';
+    }
+
+    group->elements[idx++] = D_ASSERT_TRUE(
+        "classify_long_reject_any_position",
+        result && d_string_is_alpha(str),
+        "one non-class byte anywhere should be rejected");
+
+    // test: bytes >= 0x80 belong to no class
+    str->text[999] = (char)0xC9;
+    group->elements[idx++] = D_ASSERT_TRUE(
+        "classify_long_high_bytes",
+        !d_string_is_alpha(str) && !d_string_is_ascii(str),
+        "bytes >= 0x80 should be neither ASCII nor alphabetic");
+
+    // test: count_char counts across block boundaries and large inputs
+    expected = 0;
+
+    for (i = 0; i < 1000; i++)
+    {
+        str->text[i] = (char)('a' + (i * 7) % 26);
+        expected    += (str->text[i] == 'k');
+    }
+
+    result = (d_string_count_char(str, 'k') == expected);
+
+    d_string_free(str);
+    str = d_string_new_fill(100000, 'k');
+
+    result = result && str && (d_string_count_char(str, 'k') == 100000);
+    group->elements[idx++] = D_ASSERT_TRUE(
+        "classify_long_count_char",
+        result,
+        "count_char should count every occurrence");
+
+    d_string_free(str);
+
+    return group;
+}
+
+/*
+d_tests_sa_dstring_utf8
+  Tests d_string_is_valid_utf8 and d_string_utf8_length.
+  Tests the following:
+  - ASCII and well-formed multi-byte text is valid
+  - overlong encodings are rejected
+  - surrogates and code points above U+10FFFF are rejected
+  - stray continuation and truncated sequences are rejected
+  - sequences straddling vector block boundaries are validated
+  - utf8_length counts code points and reports invalid input
+  - NULL handling
+*/
+struct d_test_object*
+d_tests_sa_dstring_utf8
+(
+    void
+)
+{
+    struct d_test_object* group;
+    struct d_string*      str;
+    char                  pad[64];
+    size_t                i;
+    bool                  result;
+    size_t                idx;
+
+    group = d_test_object_new_interior("d_string_utf8", 7);
+
+    if (!group)
+    {
+        return NULL;
+    }
+
+    idx = 0;
+    d_memset(pad, 'z', sizeof(pad));
+
+    // test: ASCII and well-formed multi-byte text is valid
+    str    = d_string_new_from_cstr("plain ascii");
+    result = str && d_string_is_valid_utf8(str);
+    d_string_free(str);
+
+    str    = d_string_new_from_cstr("caf\xC3\xA9 \xE2\x82\xAC \xF0\x9F\x98\x80 "
+                                    "\xED\x9F\xBF \xF4\x8F\xBF\xBF");
+    result = result && str && d_string_is_valid_utf8(str);
+    d_string_free(str);
+
+    str    = d_string_new();
+    result = result && str && d_string_is_valid_utf8(str);
+    d_string_free(str);
+
+    group->elements[idx++] = D_ASSERT_TRUE(
+        "utf8_valid",
+        result,
+        "well-formed UTF-8 should be valid");
+
+    // test: overlong encodings are rejected
+    str    = d_string_new_from_cstr("\xC0\xAF");
+    result = str && !d_string_is_valid_utf8(str);
+    d_string_free(str);
+
+    str    = d_string_new_from_cstr("\xE0\x80\xAF");
+    result = result && str && !d_string_is_valid_utf8(str);
+    d_string_free(str);
+
+    str    = d_string_new_from_cstr("\xF0\x8F\xBF\xBF");
+    result = result && str && !d_string_is_valid_utf8(str);
+    d_string_free(str);
+
+    group->elements[idx++] = D_ASSERT_TRUE(
+        "utf8_overlong",
+        result,
+        "overlong encodings should be rejected");
+
+    // test: surrogates and code points above U+10FFFF are rejected
+    str    = d_string_new_from_cstr("\xED\xA0\x80");
+    result = str && !d_string_is_valid_utf8(str);
+    d_string_free(str);
+
+    str    = d_string_new_from_cstr("\xF4\x90\x80\x80");
+    result = result && str && !d_string_is_valid_utf8(str);
+    d_string_free(str);
+
+    str    = d_string_new_from_cstr("\xF5\x80\x80\x80");
+    result = result && str && !d_string_is_valid_utf8(str);
+    d_string_free(str);
+
+    group->elements[idx++] = D_ASSERT_TRUE(
+        "utf8_out_of_range",
+        result,
+        "surrogates and code points above U+10FFFF should be rejected");
+
+    // test: stray continuation and truncated sequences are rejected
+    str    = d_string_new_from_cstr("a\x80z");
+    result = str && !d_string_is_valid_utf8(str);
+    d_string_free(str);
+
+    str    = d_string_new_from_cstr("end \xE2\x82");
+    result = result && str && !d_string_is_valid_utf8(str);
+    d_string_free(str);
+
+    str    = d_string_new_from_cstr("\xC3(");
+    result = result && str && !d_string_is_valid_utf8(str);
+    d_string_free(str);
+
+    group->elements[idx++] = D_ASSERT_TRUE(
+        "utf8_malformed",
+        result,
+        "stray continuations and truncated sequences should be rejected");
+
+    // test: sequences straddling vector block boundaries are validated
+    result = true;
+
+    for (i = 0; (i < 70) && result; i++)
+    {
+        str = d_string_new_fill(i, 'x');
+
+        if (!str)
+        {
+            result = false;
+
+            break;
+        }
+
+        d_string_append_cstr(str, "\xF0\x9F\x98\x80");
+        d_string_append_char(str, 'y');
+        d_string_append_buffer(str, pad, sizeof(pad));
+        result = d_string_is_valid_utf8(str);
+
+        // truncate the sequence so it ends early at the same offset
+        str->text[i + 3] = 'y';
+        result = result && !d_string_is_valid_utf8(str);
+
+        d_string_free(str);
+    }
+
+    group->elements[idx++] = D_ASSERT_TRUE(
+        "utf8_block_boundaries",
+        result,
+        "sequences at every block offset should be validated");
+
+    // test: utf8_length counts code points and reports invalid input
+    str    = d_string_new_from_cstr("\xC3\xA9t\xC3\xA9 \xE2\x82\xAC\xF0\x9F\x98\x80");
+    result = str && (d_string_utf8_length(str) == 6);
+    d_string_free(str);
+
+    str    = d_string_new_from_cstr("bad \xFF");
+    result = result && str && (d_string_utf8_length(str) == -1);
+    d_string_free(str);
+
+    group->elements[idx++] = D_ASSERT_TRUE(
+        "utf8_length",
+        result,
+        "utf8_length should count code points, or return -1 if invalid");
+
+    // test: NULL handling
+    group->elements[idx++] = D_ASSERT_TRUE(
+        "utf8_null",
+        !d_string_is_valid_utf8(NULL) && (d_string_utf8_length(NULL) == -1),
+        "NULL should be neither valid nor measurable");
+
+    return group;
+}
+
+
 /******************************************************************************
  * III. HASHING TESTS
  *****************************************************************************/
@@ -1161,6 +1442,133 @@ d_tests_sa_dstring_hash
 }
 
 
+/*
+d_tests_sa_dstring_hash_cached
+  Tests d_string_hash_cached, d_string_hash_invalidate, d_string_hash_bytes
+and d_string_view_hash.
+  Tests the following:
+  - cached hash equals the computed hash
+  - cached hash is stored and marked valid
+  - mutation invalidates the cached hash
+  - hash after mutation matches a fresh string with the same contents
+  - explicit invalidation clears the cache
+  - hash_bytes and view_hash agree with d_string_hash
+  - keys differing only in late bytes hash differently
+  - seed cannot be replaced once hashing has begun
+*/
+struct d_test_object*
+d_tests_sa_dstring_hash_cached
+(
+    void
+)
+{
+    struct d_test_object* group;
+    struct d_string*      str1;
+    struct d_string*      str2;
+    size_t                hash1;
+    size_t                hash2;
+    size_t                idx;
+
+    group = d_test_object_new_interior("d_string_hash_cached", 8);
+
+    if (!group)
+    {
+        return NULL;
+    }
+
+    idx  = 0;
+    str1 = d_string_new_from_cstr("/usr/local/share/djinterp/key_0001");
+    str2 = d_string_new_from_cstr("/usr/local/share/djinterp/key_0001!");
+
+    if (str1 && str2)
+    {
+        // test: cached hash equals the computed hash
+        hash1 = d_string_hash(str1);
+        hash2 = d_string_hash_cached(str1);
+        group->elements[idx++] = D_ASSERT_EQUAL(
+            "hash_cached_matches",
+            hash1, hash2,
+            "cached hash should equal the computed hash");
+
+        // test: cached hash is stored and marked valid
+        group->elements[idx++] = D_ASSERT_TRUE(
+            "hash_cached_stored",
+            (str1->flags & D_STRING_FLAG_HASHED) && (str1->hash == hash1),
+            "hash should be cached in the string");
+
+        // test: mutation invalidates the cached hash
+        d_string_append_char(str1, '!');
+        group->elements[idx++] = D_ASSERT_FALSE(
+            "hash_cached_invalidated",
+            str1->flags & D_STRING_FLAG_HASHED,
+            "appending should invalidate the cached hash");
+
+        // test: hash after mutation matches a fresh string with the same
+        // contents
+        group->elements[idx++] = D_ASSERT_EQUAL(
+            "hash_after_mutation",
+            d_string_hash_cached(str1), d_string_hash(str2),
+            "rehash should match a string with identical contents");
+
+        // test: explicit invalidation clears the cache
+        d_string_hash_invalidate(str1);
+        group->elements[idx++] = D_ASSERT_FALSE(
+            "hash_explicit_invalidate",
+            str1->flags & D_STRING_FLAG_HASHED,
+            "hash_invalidate should clear the cached hash");
+
+        // test: hash_bytes and view_hash agree with d_string_hash
+        group->elements[idx++] = D_ASSERT_TRUE(
+            "hash_bytes_view_agree",
+            ((size_t)d_string_hash_bytes(str2->text, str2->size) ==
+                d_string_hash(str2)) &&
+            (d_string_view_hash(d_string_view_of(str2)) ==
+                d_string_hash(str2)),
+            "all hash entry points should agree for the same bytes");
+
+        // test: keys differing only in late bytes hash differently
+        d_string_set_char(str2, -2, '2');
+        group->elements[idx++] = D_ASSERT_TRUE(
+            "hash_late_byte_differs",
+            d_string_hash(str1) != d_string_hash(str2),
+            "structured keys differing near the end should not collide");
+    }
+    else
+    {
+        group->elements[idx++] = D_ASSERT_TRUE(
+            "hash_cached_matches", false, "failed to allocate test strings");
+        group->elements[idx++] = D_ASSERT_TRUE(
+            "hash_cached_stored", false, "failed to allocate test strings");
+        group->elements[idx++] = D_ASSERT_TRUE(
+            "hash_cached_invalidated", false,
+            "failed to allocate test strings");
+        group->elements[idx++] = D_ASSERT_TRUE(
+            "hash_after_mutation", false, "failed to allocate test strings");
+        group->elements[idx++] = D_ASSERT_TRUE(
+            "hash_explicit_invalidate", false,
+            "failed to allocate test strings");
+        group->elements[idx++] = D_ASSERT_TRUE(
+            "hash_bytes_view_agree", false,
+            "failed to allocate test strings");
+        group->elements[idx++] = D_ASSERT_TRUE(
+            "hash_late_byte_differs", false,
+            "failed to allocate test strings");
+    }
+
+    d_string_free(str1);
+    d_string_free(str2);
+
+    // test: seed cannot be replaced once hashing has begun
+    (void)d_string_hash_bytes("seed", 4);
+    group->elements[idx++] = D_ASSERT_FALSE(
+        "hash_seed_locked",
+        d_string_hash_set_seed(12345),
+        "seed should not change after the first hash");
+
+    return group;
+}
+
+
 /******************************************************************************
  * UTIL ALL - AGGREGATE RUNNER
  *****************************************************************************/
@@ -1172,6 +1580,7 @@ d_tests_sa_dstring_util_all
   - validation functions (is_valid, is_ascii, is_numeric, is_alpha, 
     is_alnum, is_whitespace)
   - counting functions (count_char, count_substr)
+  - vectorized classification and UTF-8 validation
   - hashing function (hash)
 */
 struct d_test_object*
@@ -1183,7 +1592,7 @@ d_tests_sa_dstring_util_all
     struct d_test_object* group;
     size_t                idx;
 
-    group = d_test_object_new_interior("Utility Functions", 9);
+    group = d_test_object_new_interior("Utility Functions", 12);
 
     if (!group)
     {
@@ -1203,9 +1612,12 @@ d_tests_sa_dstring_util_all
     // counting tests
     group->elements[idx++] = d_tests_sa_dstring_count_char();
     group->elements[idx++] = d_tests_sa_dstring_count_substr();
+    group->elements[idx++] = d_tests_sa_dstring_classify_long();
+    group->elements[idx++] = d_tests_sa_dstring_utf8();
 
     // hashing tests
     group->elements[idx++] = d_tests_sa_dstring_hash();
+    group->elements[idx++] = d_tests_sa_dstring_hash_cached();
 
     return group;
 }
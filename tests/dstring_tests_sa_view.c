@@ -0,0 +1,547 @@
+#include ".\dstring_tests_sa.h"
+
+
+/******************************************************************************
+ * SECTION 18: STRING VIEW FUNCTIONS
+ *****************************************************************************/
+
+/*
+d_tests_sa_dstring_view_construction
+  Tests d_string_view_make, d_string_view_from_cstr, d_string_view_of and
+d_string_new_from_view.
+  Tests the following:
+  - view_make records text and size
+  - view_make with NULL text yields an empty view
+  - view_from_cstr excludes the terminator
+  - view_of refers to the d_string's own buffer
+  - view_of NULL yields an empty view
+  - new_from_view copies only the viewed characters
+*/
+struct d_test_object*
+d_tests_sa_dstring_view_construction
+(
+    void
+)
+{
+    struct d_test_object* group;
+    struct d_string*      str;
+    struct d_string*      copy;
+    struct d_string_view  view;
+    size_t                idx;
+
+    group = d_test_object_new_interior("d_string_view construction", 6);
+
+    if (!group)
+    {
+        return NULL;
+    }
+
+    idx = 0;
+
+    // test: view_make records text and size
+    view = d_string_view_make("hello", 3);
+    group->elements[idx++] = D_ASSERT_TRUE(
+        "view_make_fields",
+        (view.size == 3) && (strncmp(view.text, "hel", 3) == 0),
+        "view should cover the first 3 characters");
+
+    // test: view_make with NULL text yields an empty view
+    view = d_string_view_make(NULL, 10);
+    group->elements[idx++] = D_ASSERT_TRUE(
+        "view_make_null",
+        (view.text == NULL) && (view.size == 0),
+        "NULL text should produce an empty view");
+
+    // test: view_from_cstr excludes the terminator
+    view = d_string_view_from_cstr("world");
+    group->elements[idx++] = D_ASSERT_EQUAL(
+        "view_from_cstr_size",
+        view.size, 5,
+        "view of 'world' should have size 5");
+
+    // test: view_of refers to the d_string's own buffer
+    str = d_string_new_from_cstr("hello world");
+
+    if (str)
+    {
+        view = d_string_view_of(str);
+        group->elements[idx++] = D_ASSERT_TRUE(
+            "view_of_shares_buffer",
+            (view.text == str->text) && (view.size == str->size),
+            "view should alias the d_string's buffer without copying");
+
+        // test: new_from_view copies only the viewed characters
+        copy = d_string_new_from_view(d_string_substr_view(str, 6, 5));
+        group->elements[idx++] = D_ASSERT_TRUE(
+            "new_from_view_copies",
+            (copy != NULL) &&
+            (copy->size == 5) &&
+            (strcmp(copy->text, "world") == 0),
+            "materialized view should be 'world'");
+
+        d_string_free(copy);
+        d_string_free(str);
+    }
+    else
+    {
+        group->elements[idx++] = D_ASSERT_TRUE(
+            "view_of_shares_buffer",
+            false,
+            "failed to allocate test string");
+        group->elements[idx++] = D_ASSERT_TRUE(
+            "new_from_view_copies",
+            false,
+            "failed to allocate test string");
+    }
+
+    // test: view_of NULL yields an empty view
+    view = d_string_view_of(NULL);
+    group->elements[idx++] = D_ASSERT_TRUE(
+        "view_of_null",
+        (view.text == NULL) && (view.size == 0),
+        "view of NULL should be empty");
+
+    return group;
+}
+
+/*
+d_tests_sa_dstring_view_slicing
+  Tests d_string_view_substr, d_string_substr_view and the trimmed view
+functions.
+  Tests the following:
+  - substr_view selects the requested range
+  - negative start counts from the end
+  - length is clamped to the end of the view
+  - invalid start yields an empty view
+  - trimmed_view removes surrounding whitespace without copying
+  - trimmed_left_view and trimmed_right_view trim one side only
+  - all-whitespace input trims to an empty view
+*/
+struct d_test_object*
+d_tests_sa_dstring_view_slicing
+(
+    void
+)
+{
+    struct d_test_object* group;
+    struct d_string*      str;
+    struct d_string_view  view;
+    size_t                idx;
+
+    group = d_test_object_new_interior("d_string_view slicing", 8);
+
+    if (!group)
+    {
+        return NULL;
+    }
+
+    idx = 0;
+
+    str = d_string_new_from_cstr("  hello world \t");
+
+    if (str)
+    {
+        // test: substr_view selects the requested range
+        view = d_string_substr_view(str, 2, 5);
+        group->elements[idx++] = D_ASSERT_TRUE(
+            "substr_view_range",
+            d_string_view_equals_cstr(view, "hello") &&
+            (view.text == str->text + 2),
+            "substr_view(2, 5) should be 'hello' within the source");
+
+        // test: negative start counts from the end
+        view = d_string_substr_view(str, -7, 5);
+        group->elements[idx++] = D_ASSERT_TRUE(
+            "substr_view_negative",
+            d_string_view_equals_cstr(view, "world"),
+            "substr_view(-7, 5) should be 'world'");
+
+        // test: length is clamped to the end of the view
+        view = d_string_view_substr(d_string_view_of(str), 8, 100);
+        group->elements[idx++] = D_ASSERT_TRUE(
+            "substr_view_clamped",
+            d_string_view_equals_cstr(view, "world \t"),
+            "length should be clamped to the end");
+
+        // test: invalid start yields an empty view
+        view = d_string_substr_view(str, 100, 1);
+        group->elements[idx++] = D_ASSERT_EQUAL(
+            "substr_view_invalid",
+            view.size, 0,
+            "out-of-range start should give an empty view");
+
+        // test: trimmed_view removes surrounding whitespace without copying
+        view = d_string_trimmed_view(str);
+        group->elements[idx++] = D_ASSERT_TRUE(
+            "trimmed_view",
+            d_string_view_equals_cstr(view, "hello world") &&
+            (view.text == str->text + 2),
+            "trimmed view should be 'hello world' within the source");
+
+        // test: trimmed_left_view and trimmed_right_view trim one side only
+        group->elements[idx++] = D_ASSERT_TRUE(
+            "trimmed_left_view",
+            d_string_view_equals_cstr(d_string_trimmed_left_view(str),
+                                      "hello world \t"),
+            "left trim should keep trailing whitespace");
+
+        group->elements[idx++] = D_ASSERT_TRUE(
+            "trimmed_right_view",
+            d_string_view_equals_cstr(d_string_trimmed_right_view(str),
+                                      "  hello world"),
+            "right trim should keep leading whitespace");
+
+        d_string_free(str);
+    }
+    else
+    {
+        group->elements[idx++] = D_ASSERT_TRUE(
+            "substr_view_range", false, "failed to allocate test string");
+        group->elements[idx++] = D_ASSERT_TRUE(
+            "substr_view_negative", false, "failed to allocate test string");
+        group->elements[idx++] = D_ASSERT_TRUE(
+            "substr_view_clamped", false, "failed to allocate test string");
+        group->elements[idx++] = D_ASSERT_TRUE(
+            "substr_view_invalid", false, "failed to allocate test string");
+        group->elements[idx++] = D_ASSERT_TRUE(
+            "trimmed_view", false, "failed to allocate test string");
+        group->elements[idx++] = D_ASSERT_TRUE(
+            "trimmed_left_view", false, "failed to allocate test string");
+        group->elements[idx++] = D_ASSERT_TRUE(
+            "trimmed_right_view", false, "failed to allocate test string");
+    }
+
+    // test: all-whitespace input trims to an empty view
+    view = d_string_view_trimmed(d_string_view_from_cstr(" \t\n "));
+    group->elements[idx++] = D_ASSERT_EQUAL(
+        "trimmed_view_all_whitespace",
+        view.size, 0,
+        "all-whitespace view should trim to empty");
+
+    return group;
+}
+
+/*
+d_tests_sa_dstring_view_search
+  Tests d_string_view_find, d_string_view_find_cstr, d_string_view_find_char
+and d_string_view_rfind.
+  Tests the following:
+  - find locates a needle within the view
+  - find does not match past the end of the view
+  - find_cstr with empty needle returns 0
+  - find_char locates a character
+  - find_char on an empty view returns -1
+  - rfind locates the last occurrence
+*/
+struct d_test_object*
+d_tests_sa_dstring_view_search
+(
+    void
+)
+{
+    struct d_test_object* group;
+    struct d_string_view  view;
+    size_t                idx;
+
+    group = d_test_object_new_interior("d_string_view search", 6);
+
+    if (!group)
+    {
+        return NULL;
+    }
+
+    idx  = 0;
+    view = d_string_view_from_cstr("one two one two");
+
+    // test: find locates a needle within the view
+    group->elements[idx++] = D_ASSERT_EQUAL(
+        "view_find",
+        d_string_view_find(view, d_string_view_from_cstr("two")), 4,
+        "should find 'two' at index 4");
+
+    // test: find does not match past the end of the view
+    group->elements[idx++] = D_ASSERT_EQUAL(
+        "view_find_bounded",
+        d_string_view_find_cstr(d_string_view_make(view.text, 6), "two"), -1,
+        "should not find 'two' in the first 6 characters");
+
+    // test: find_cstr with empty needle returns 0
+    group->elements[idx++] = D_ASSERT_EQUAL(
+        "view_find_empty_needle",
+        d_string_view_find_cstr(view, ""), 0,
+        "empty needle should match at index 0");
+
+    // test: find_char locates a character
+    group->elements[idx++] = D_ASSERT_EQUAL(
+        "view_find_char",
+        d_string_view_find_char(view, 'w'), 5,
+        "should find 'w' at index 5");
+
+    // test: find_char on an empty view returns -1
+    group->elements[idx++] = D_ASSERT_EQUAL(
+        "view_find_char_empty",
+        d_string_view_find_char(d_string_view_make(NULL, 0), 'a'), -1,
+        "empty view should not contain any character");
+
+    // test: rfind locates the last occurrence
+    group->elements[idx++] = D_ASSERT_EQUAL(
+        "view_rfind",
+        d_string_view_rfind(view, d_string_view_from_cstr("one")), 8,
+        "should find last 'one' at index 8");
+
+    return group;
+}
+
+/*
+d_tests_sa_dstring_view_compare
+  Tests d_string_view_cmp, d_string_view_cmp_cstr, d_string_view_equals,
+d_string_view_equals_cstr, d_string_view_starts_with and
+d_string_view_ends_with.
+  Tests the following:
+  - equal views compare equal
+  - prefix compares less than the longer view
+  - byte difference decides the ordering
+  - equals respects the view's length, not the terminator
+  - equals_cstr with NULL returns false
+  - starts_with and ends_with
+*/
+struct d_test_object*
+d_tests_sa_dstring_view_compare
+(
+    void
+)
+{
+    struct d_test_object* group;
+    struct d_string_view  abc;
+    struct d_string_view  abcd;
+    size_t                idx;
+
+    group = d_test_object_new_interior("d_string_view compare", 7);
+
+    if (!group)
+    {
+        return NULL;
+    }
+
+    idx  = 0;
+    abc  = d_string_view_from_cstr("abc");
+    abcd = d_string_view_from_cstr("abcd");
+
+    // test: equal views compare equal
+    group->elements[idx++] = D_ASSERT_EQUAL(
+        "view_cmp_equal",
+        d_string_view_cmp(abc, d_string_view_make("abcdef", 3)), 0,
+        "'abc' should equal the first 3 characters of 'abcdef'");
+
+    // test: prefix compares less than the longer view
+    group->elements[idx++] = D_ASSERT_TRUE(
+        "view_cmp_prefix",
+        (d_string_view_cmp(abc, abcd) < 0) &&
+        (d_string_view_cmp(abcd, abc) > 0),
+        "'abc' should order before 'abcd'");
+
+    // test: byte difference decides the ordering
+    group->elements[idx++] = D_ASSERT_TRUE(
+        "view_cmp_cstr_order",
+        d_string_view_cmp_cstr(abcd, "abd") < 0,
+        "'abcd' should order before 'abd'");
+
+    // test: equals respects the view's length, not the terminator
+    group->elements[idx++] = D_ASSERT_FALSE(
+        "view_equals_length",
+        d_string_view_equals(abc, abcd),
+        "'abc' should not equal 'abcd'");
+
+    // test: equals_cstr with NULL returns false
+    group->elements[idx++] = D_ASSERT_FALSE(
+        "view_equals_cstr_null",
+        d_string_view_equals_cstr(abc, NULL),
+        "comparison with NULL should be false");
+
+    // test: starts_with and ends_with
+    group->elements[idx++] = D_ASSERT_TRUE(
+        "view_starts_with",
+        d_string_view_starts_with(abcd, abc) &&
+        !d_string_view_starts_with(abc, abcd),
+        "'abcd' should start with 'abc', not vice versa");
+
+    group->elements[idx++] = D_ASSERT_TRUE(
+        "view_ends_with",
+        d_string_view_ends_with(abcd, d_string_view_from_cstr("cd")) &&
+        !d_string_view_ends_with(abcd, abc),
+        "'abcd' should end with 'cd' but not 'abc'");
+
+    return group;
+}
+
+/*
+d_tests_sa_dstring_split_iter
+  Tests d_string_split_iter_init, d_string_split_iter_next and
+d_string_split_view.
+  Tests the following:
+  - iterator yields each token as a view into the source
+  - consecutive and leading/trailing delimiters produce no empty tokens
+  - source is left unmodified
+  - NULL arguments are rejected
+  - split_view returns all tokens in a single array
+  - split_view on all-delimiter input returns no tokens
+*/
+struct d_test_object*
+d_tests_sa_dstring_split_iter
+(
+    void
+)
+{
+    struct d_test_object*      group;
+    struct d_string*           str;
+    struct d_string_split_iter iter;
+    struct d_string_view       token;
+    struct d_string_view*      tokens;
+    size_t                     count;
+    size_t                     idx;
+    bool                       ok;
+
+    group = d_test_object_new_interior("d_string_split_iter", 7);
+
+    if (!group)
+    {
+        return NULL;
+    }
+
+    idx = 0;
+    str = d_string_new_from_cstr(",,alpha, beta,,gamma,");
+
+    if (str)
+    {
+        // test: iterator yields each token as a view into the source
+        d_string_split_iter_init(&iter, d_string_view_of(str), ", ");
+
+        ok = d_string_split_iter_next(&iter, &token) &&
+             d_string_view_equals_cstr(token, "alpha") &&
+             (token.text == str->text + 2);
+        ok = ok &&
+             d_string_split_iter_next(&iter, &token) &&
+             d_string_view_equals_cstr(token, "beta");
+        ok = ok &&
+             d_string_split_iter_next(&iter, &token) &&
+             d_string_view_equals_cstr(token, "gamma");
+
+        group->elements[idx++] = D_ASSERT_TRUE(
+            "split_iter_tokens",
+            ok,
+            "should yield 'alpha', 'beta', 'gamma' in order");
+
+        // test: consecutive and leading/trailing delimiters produce no
+        // empty tokens
+        group->elements[idx++] = D_ASSERT_FALSE(
+            "split_iter_exhausted",
+            d_string_split_iter_next(&iter, &token),
+            "no tokens should remain after 'gamma'");
+
+        // test: source is left unmodified
+        group->elements[idx++] = D_ASSERT_STR_EQUAL(
+            "split_iter_source_intact",
+            str->text, ",,alpha, beta,,gamma,",
+            "source should not be modified");
+
+        // test: split_view returns all tokens in a single array
+        tokens = NULL;
+        count  = d_string_split_view(str, ",", &tokens);
+        group->elements[idx++] = D_ASSERT_TRUE(
+            "split_view_tokens",
+            (count == 3) &&
+            (tokens != NULL) &&
+            d_string_view_equals_cstr(tokens[1], " beta"),
+            "split_view on ',' should give 3 tokens, second ' beta'");
+
+        free(tokens);
+        d_string_free(str);
+    }
+    else
+    {
+        group->elements[idx++] = D_ASSERT_TRUE(
+            "split_iter_tokens", false, "failed to allocate test string");
+        group->elements[idx++] = D_ASSERT_TRUE(
+            "split_iter_exhausted", false, "failed to allocate test string");
+        group->elements[idx++] = D_ASSERT_TRUE(
+            "split_iter_source_intact", false,
+            "failed to allocate test string");
+        group->elements[idx++] = D_ASSERT_TRUE(
+            "split_view_tokens", false, "failed to allocate test string");
+    }
+
+    // test: NULL arguments are rejected
+    group->elements[idx++] = D_ASSERT_FALSE(
+        "split_iter_init_null_delim",
+        d_string_split_iter_init(&iter, d_string_view_from_cstr("a"), NULL),
+        "NULL delimiter set should be rejected");
+
+    group->elements[idx++] = D_ASSERT_FALSE(
+        "split_iter_next_null_token",
+        d_string_split_iter_next(&iter, NULL),
+        "NULL token output should be rejected");
+
+    // test: split_view on all-delimiter input returns no tokens
+    str = d_string_new_from_cstr(";;;");
+
+    if (str)
+    {
+        tokens = NULL;
+        count  = d_string_split_view(str, ";", &tokens);
+        group->elements[idx++] = D_ASSERT_TRUE(
+            "split_view_no_tokens",
+            (count == 0) && (tokens == NULL),
+            "all-delimiter input should yield no tokens");
+
+        d_string_free(str);
+    }
+    else
+    {
+        group->elements[idx++] = D_ASSERT_TRUE(
+            "split_view_no_tokens", false, "failed to allocate test string");
+    }
+
+    return group;
+}
+
+
+/******************************************************************************
+ * VIEW ALL - AGGREGATE RUNNER
+ *****************************************************************************/
+
+/*
+d_tests_sa_dstring_view_all
+  Runs all string view tests for dstring module.
+  Tests the following:
+  - view construction (view_make, view_from_cstr, view_of, new_from_view)
+  - slicing and trimming (view_substr, substr_view, trimmed views)
+  - search (view_find, view_find_cstr, view_find_char, view_rfind)
+  - comparison (view_cmp, view_equals, starts_with, ends_with)
+  - zero-copy splitting (split_iter_init, split_iter_next, split_view)
+*/
+struct d_test_object*
+d_tests_sa_dstring_view_all
+(
+    void
+)
+{
+    struct d_test_object* group;
+    size_t                idx;
+
+    group = d_test_object_new_interior("String View Functions", 5);
+
+    if (!group)
+    {
+        return NULL;
+    }
+
+    idx = 0;
+
+    group->elements[idx++] = d_tests_sa_dstring_view_construction();
+    group->elements[idx++] = d_tests_sa_dstring_view_slicing();
+    group->elements[idx++] = d_tests_sa_dstring_view_search();
+    group->elements[idx++] = d_tests_sa_dstring_view_compare();
+    group->elements[idx++] = d_tests_sa_dstring_split_iter();
+
+    return group;
+}
@@ -268,7 +268,23 @@ bool d_tests_sa_env_build_all(struct d_test_counter* _test_info);
 
 
 // =============================================================================
-// IX.   MASTER TEST SUITE
+// IX.  RUNTIME CPU FEATURE TEST FUNCTIONS
+// =============================================================================
+
+// feature probe tests
+bool d_tests_sa_env_cpu_features_probe(struct d_test_counter* _test_info);
+bool d_tests_sa_env_cpu_features_compile_time(struct d_test_counter* _test_info);
+
+// tier tests
+bool d_tests_sa_env_cpu_tier_table(struct d_test_counter* _test_info);
+bool d_tests_sa_env_cpu_tier_selection(struct d_test_counter* _test_info);
+
+// runtime CPU module aggregator
+bool d_tests_sa_env_cpu_all(struct d_test_counter* _test_info);
+
+
+// =============================================================================
+// X.    MASTER TEST SUITE
 // =============================================================================
 
 bool d_tests_sa_env_all(struct d_test_counter* _test_info);
@@ -0,0 +1,496 @@
+/******************************************************************************
+* djinterp [test]                                           env_tests_sa_cpu.c
+*
+* Unit tests for `env.h` runtime CPU feature section (Section X).
+* Tests the cached feature probe, the tier table, and agreement with the
+* compile-time target macros.
+* Note: this module is required to build DTest, so it uses `test_standalone.h`.
+*
+* path:      \test\env_tests_sa_cpu.c
+* link:      TBA
+* author(s): Samuel 'teer' Neal-Blim                          date: 2026.10.16
+******************************************************************************/
+
+#include "env_tests_sa.h"
+#include <string.h>
+
+
+/******************************************************************************
+* FEATURE PROBE TESTS
+******************************************************************************/
+
+/*
+d_tests_sa_env_cpu_features_probe
+  Tests d_env_cpu_features and d_env_cpu_features_detected.
+  Tests the following:
+  - repeated calls return the same (cached) value
+  - reported features are a subset of the detected features
+  - D_ENV_CPU_HAS of no features is true
+  - D_ENV_CPU_HAS agrees with d_env_cpu_features for each reported flag
+  - the last-level cache size is stable and, if known, at least 4 KiB
+*/
+bool
+d_tests_sa_env_cpu_features_probe
+(
+    struct d_test_counter* _test_info
+)
+{
+    bool     all_assertions_passed;
+    size_t   initial_tests_passed;
+    uint32_t detected;
+    uint32_t features;
+
+    if (!_test_info)
+    {
+        return false;
+    }
+
+    all_assertions_passed = true;
+    initial_tests_passed  = _test_info->tests_passed;
+
+    printf("%s--- Testing CPU Feature Probe ---\n", D_INDENT);
+
+    detected = d_env_cpu_features_detected();
+    features = d_env_cpu_features();
+
+    if (!d_assert_standalone(detected == d_env_cpu_features_detected(),
+                             "detected features are stable",
+                             "the probe result should be cached",
+                             _test_info))
+    {
+        all_assertions_passed = false;
+    }
+
+    if (!d_assert_standalone(features == d_env_cpu_features(),
+                             "reported features are stable",
+                             "the override should be applied once",
+                             _test_info))
+    {
+        all_assertions_passed = false;
+    }
+
+    if (!d_assert_standalone((features & ~detected) == 0,
+                             "features are a subset of detected",
+                             "the override cannot enable missing features",
+                             _test_info))
+    {
+        all_assertions_passed = false;
+    }
+
+    if (!d_assert_standalone(D_ENV_CPU_HAS(0),
+                             "D_ENV_CPU_HAS(0) is true",
+                             "an empty requirement is always met",
+                             _test_info))
+    {
+        all_assertions_passed = false;
+    }
+
+    if (!d_assert_standalone(D_ENV_CPU_HAS(features),
+                             "D_ENV_CPU_HAS(features) is true",
+                             "the reported features should all be present",
+                             _test_info))
+    {
+        all_assertions_passed = false;
+    }
+
+    if (!d_assert_standalone( (d_env_cpu_cache_size() == d_env_cpu_cache_size()) &&
+                              ( (d_env_cpu_cache_size() == 0) ||
+                                (d_env_cpu_cache_size() >= 4096) ),
+                             "cache size is stable and plausible",
+                             "the cache probe should be cached",
+                             _test_info))
+    {
+        all_assertions_passed = false;
+    }
+
+    printf("%s    detected: 0x%08lx\n", D_INDENT, (unsigned long)detected);
+    printf("%s    features: 0x%08lx\n", D_INDENT, (unsigned long)features);
+    printf("%s    LLC size: %lu\n", D_INDENT, (unsigned long)d_env_cpu_cache_size());
+
+    // update test counter
+    if (all_assertions_passed)
+    {
+        _test_info->tests_passed++;
+        printf("%s[PASS] CPU feature probe test passed\n", D_INDENT);
+    }
+    else
+    {
+        printf("%s[FAIL] CPU feature probe test failed\n", D_INDENT);
+    }
+    _test_info->tests_total++;
+
+    return (_test_info->tests_passed > initial_tests_passed);
+}
+
+/*
+d_tests_sa_env_cpu_features_compile_time
+  Tests that the probe agrees with the instruction sets the compiler targets;
+a program built for an extension can only be running on a CPU that has it.
+  Tests the following:
+  - SSE2 is detected on x86-64
+  - AVX2 is detected when compiled with AVX2 enabled
+  - NEON is detected on AArch64
+*/
+bool
+d_tests_sa_env_cpu_features_compile_time
+(
+    struct d_test_counter* _test_info
+)
+{
+    bool     all_assertions_passed;
+    size_t   initial_tests_passed;
+    uint32_t detected;
+
+    if (!_test_info)
+    {
+        return false;
+    }
+
+    all_assertions_passed = true;
+    initial_tests_passed  = _test_info->tests_passed;
+
+    printf("%s--- Testing CPU Features vs. Compile Target ---\n", D_INDENT);
+
+    detected = d_env_cpu_features_detected();
+
+#if ( defined(__x86_64__) || defined(_M_X64) )
+    if (!d_assert_standalone((detected & D_ENV_CPU_FEATURE_SSE2) != 0,
+                             "SSE2 detected on x86-64",
+                             "SSE2 is part of the x86-64 baseline",
+                             _test_info))
+    {
+        all_assertions_passed = false;
+    }
+#endif
+
+#if defined(__AVX2__)
+    if (!d_assert_standalone((detected & D_ENV_CPU_FEATURE_AVX2) != 0,
+                             "AVX2 detected when targeted",
+                             "an AVX2 build requires an AVX2 CPU",
+                             _test_info))
+    {
+        all_assertions_passed = false;
+    }
+#endif
+
+#if ( defined(__aarch64__) || defined(_M_ARM64) )
+    if (!d_assert_standalone((detected & D_ENV_CPU_FEATURE_NEON) != 0,
+                             "NEON detected on AArch64",
+                             "NEON is part of the AArch64 baseline",
+                             _test_info))
+    {
+        all_assertions_passed = false;
+    }
+#endif
+
+    if (!d_assert_standalone( (D_ENV_CPU_DISPATCH_X86 == 0) ||
+                              (D_ENV_CPU_DISPATCH_X86 == 1),
+                             "D_ENV_CPU_DISPATCH_X86 is 0 or 1",
+                             "dispatch flag must be boolean",
+                             _test_info))
+    {
+        all_assertions_passed = false;
+    }
+
+    (void)detected;
+
+    // update test counter
+    if (all_assertions_passed)
+    {
+        _test_info->tests_passed++;
+        printf("%s[PASS] CPU compile target test passed\n", D_INDENT);
+    }
+    else
+    {
+        printf("%s[FAIL] CPU compile target test failed\n", D_INDENT);
+    }
+    _test_info->tests_total++;
+
+    return (_test_info->tests_passed > initial_tests_passed);
+}
+
+
+/******************************************************************************
+* TIER TESTS
+******************************************************************************/
+
+/*
+d_tests_sa_env_cpu_tier_table
+  Tests d_env_cpu_tier_name and d_env_cpu_tier_features.
+  Tests the following:
+  - every tier has a distinct, non-empty name
+  - the scalar tier has no features
+  - each x86 tier includes the features of the tier below it
+  - invalid tiers yield NULL and 0
+*/
+bool
+d_tests_sa_env_cpu_tier_table
+(
+    struct d_test_counter* _test_info
+)
+{
+    bool        all_assertions_passed;
+    bool        names_valid;
+    size_t      initial_tests_passed;
+    int         i;
+    int         j;
+    const char* name;
+
+    if (!_test_info)
+    {
+        return false;
+    }
+
+    all_assertions_passed = true;
+    initial_tests_passed  = _test_info->tests_passed;
+
+    printf("%s--- Testing CPU Tier Table ---\n", D_INDENT);
+
+    names_valid = true;
+
+    for (i = 0; i < D_ENV_CPU_TIER_COUNT; i++)
+    {
+        name = d_env_cpu_tier_name(i);
+
+        if ( (name == NULL) ||
+             (name[0] == '\0') )
+        {
+            names_valid = false;
+
+            continue;
+        }
+
+        for (j = 0; j < i; j++)
+        {
+            if ( (d_env_cpu_tier_name(j) != NULL) &&
+                 (strcmp(name, d_env_cpu_tier_name(j)) == 0) )
+            {
+                names_valid = false;
+            }
+        }
+    }
+
+    if (!d_assert_standalone(names_valid,
+                             "tier names are distinct and non-empty",
+                             "each tier should be selectable by name",
+                             _test_info))
+    {
+        all_assertions_passed = false;
+    }
+
+    if (!d_assert_standalone(
+            d_env_cpu_tier_features(D_ENV_CPU_TIER_SCALAR) == 0,
+            "scalar tier has no features",
+            "the scalar tier must run everywhere",
+            _test_info))
+    {
+        all_assertions_passed = false;
+    }
+
+    if (!d_assert_standalone(
+            ( (d_env_cpu_tier_features(D_ENV_CPU_TIER_SSE2) &
+               ~d_env_cpu_tier_features(D_ENV_CPU_TIER_SSE42))  == 0 ) &&
+            ( (d_env_cpu_tier_features(D_ENV_CPU_TIER_SSE42) &
+               ~d_env_cpu_tier_features(D_ENV_CPU_TIER_AVX2))   == 0 ) &&
+            ( (d_env_cpu_tier_features(D_ENV_CPU_TIER_AVX2) &
+               ~d_env_cpu_tier_features(D_ENV_CPU_TIER_AVX512)) == 0 ),
+            "x86 tiers are cumulative",
+            "each tier should imply the ones below it",
+            _test_info))
+    {
+        all_assertions_passed = false;
+    }
+
+    if (!d_assert_standalone( (d_env_cpu_tier_name(-1) == NULL) &&
+                              (d_env_cpu_tier_name(D_ENV_CPU_TIER_COUNT) == NULL),
+                             "invalid tier names are NULL",
+                             "out-of-range tiers have no name",
+                             _test_info))
+    {
+        all_assertions_passed = false;
+    }
+
+    if (!d_assert_standalone( (d_env_cpu_tier_features(-1) == 0) &&
+                              (d_env_cpu_tier_features(D_ENV_CPU_TIER_COUNT) == 0),
+                             "invalid tier features are 0",
+                             "out-of-range tiers have no features",
+                             _test_info))
+    {
+        all_assertions_passed = false;
+    }
+
+    // update test counter
+    if (all_assertions_passed)
+    {
+        _test_info->tests_passed++;
+        printf("%s[PASS] CPU tier table test passed\n", D_INDENT);
+    }
+    else
+    {
+        printf("%s[FAIL] CPU tier table test failed\n", D_INDENT);
+    }
+    _test_info->tests_total++;
+
+    return (_test_info->tests_passed > initial_tests_passed);
+}
+
+/*
+d_tests_sa_env_cpu_tier_selection
+  Tests d_env_cpu_tier.
+  Tests the following:
+  - the selected tier is in range
+  - the selected tier is stable across calls
+  - the running CPU has every feature the scalar tier needs
+*/
+bool
+d_tests_sa_env_cpu_tier_selection
+(
+    struct d_test_counter* _test_info
+)
+{
+    bool   all_assertions_passed;
+    size_t initial_tests_passed;
+    int    tier;
+
+    if (!_test_info)
+    {
+        return false;
+    }
+
+    all_assertions_passed = true;
+    initial_tests_passed  = _test_info->tests_passed;
+
+    printf("%s--- Testing CPU Tier Selection ---\n", D_INDENT);
+
+    tier = d_env_cpu_tier();
+
+    if (!d_assert_standalone( (tier >= D_ENV_CPU_TIER_SCALAR) &&
+                              (tier < D_ENV_CPU_TIER_COUNT),
+                             "selected tier is in range",
+                             "d_env_cpu_tier must return a valid tier",
+                             _test_info))
+    {
+        all_assertions_passed = false;
+    }
+
+    if (!d_assert_standalone(tier == d_env_cpu_tier(),
+                             "selected tier is stable",
+                             "tier selection should not change between calls",
+                             _test_info))
+    {
+        all_assertions_passed = false;
+    }
+
+    if (!d_assert_standalone(
+            D_ENV_CPU_HAS(d_env_cpu_tier_features(D_ENV_CPU_TIER_SCALAR)),
+            "scalar tier is supported",
+            "the scalar tier needs no features",
+            _test_info))
+    {
+        all_assertions_passed = false;
+    }
+
+    if (d_env_cpu_tier_name(tier) != NULL)
+    {
+        printf("%s    selected tier: %s\n", D_INDENT, d_env_cpu_tier_name(tier));
+    }
+
+    // update test counter
+    if (all_assertions_passed)
+    {
+        _test_info->tests_passed++;
+        printf("%s[PASS] CPU tier selection test passed\n", D_INDENT);
+    }
+    else
+    {
+        printf("%s[FAIL] CPU tier selection test failed\n", D_INDENT);
+    }
+    _test_info->tests_total++;
+
+    return (_test_info->tests_passed > initial_tests_passed);
+}
+
+
+/******************************************************************************
+* MODULE AGGREGATOR
+******************************************************************************/
+
+/*
+d_tests_sa_env_cpu_all
+  Runs all runtime CPU feature tests.
+  Tests the following:
+  - feature probe
+  - agreement with the compile target
+  - tier table
+  - tier selection
+*/
+bool
+d_tests_sa_env_cpu_all
+(
+    struct d_test_counter* _test_info
+)
+{
+    struct d_test_counter module_counter;
+    bool probe_result;
+    bool compile_time_result;
+    bool table_result;
+    bool selection_result;
+    bool overall_result;
+
+    if (!_test_info)
+    {
+        return false;
+    }
+
+    module_counter = (struct d_test_counter){0, 0, 0, 0};
+
+    printf("\n[MODULE] Testing Runtime CPU Features\n");
+    printf("========================================="
+           "=======================================\n");
+
+    probe_result        = d_tests_sa_env_cpu_features_probe(&module_counter);
+    compile_time_result = d_tests_sa_env_cpu_features_compile_time(&module_counter);
+    table_result        = d_tests_sa_env_cpu_tier_table(&module_counter);
+    selection_result    = d_tests_sa_env_cpu_tier_selection(&module_counter);
+
+    // update totals
+    _test_info->assertions_total  += module_counter.assertions_total;
+    _test_info->assertions_passed += module_counter.assertions_passed;
+    _test_info->tests_total       += module_counter.tests_total;
+    _test_info->tests_passed      += module_counter.tests_passed;
+
+    overall_result = ( probe_result        &&
+                       compile_time_result &&
+                       table_result        &&
+                       selection_result );
+
+    printf("\n");
+
+    if (overall_result)
+    {
+        printf("[PASS] Runtime CPU Module: %zu/%zu assertions, %zu/%zu tests passed\n",
+               module_counter.assertions_passed,
+               module_counter.assertions_total,
+               module_counter.tests_passed,
+               module_counter.tests_total);
+    }
+    else
+    {
+        printf("[FAIL] Runtime CPU Module: %zu/%zu assertions, %zu/%zu tests passed\n",
+               module_counter.assertions_passed,
+               module_counter.assertions_total,
+               module_counter.tests_passed,
+               module_counter.tests_total);
+
+        printf("  - Feature Probe:         %s\n",
+               probe_result ? "PASSED" : "FAILED");
+        printf("  - Compile Target:        %s\n",
+               compile_time_result ? "PASSED" : "FAILED");
+        printf("  - Tier Table:            %s\n",
+               table_result ? "PASSED" : "FAILED");
+        printf("  - Tier Selection:        %s\n",
+               selection_result ? "PASSED" : "FAILED");
+    }
+
+    return overall_result;
+}